@@ -0,0 +1,737 @@
+/**
+ * PrimitiveBenchmark.cpp
+ *
+ * Checks and times the engine pieces in SmileyPrimitives.h without the game:
+ * Util math, collision circles, the change manager, bit streams and game data
+ * lookups. Also loads a real area into a stubbed Environment and checks and
+ * times the same collision and A* cases as -microbenchmark against it. Run it
+ * from the top of the repository so Data/ can be found.
+ *
+ *   PrimitiveBenchmark            checks, then times every case and writes
+ *                                 PrimitiveBenchmark.csv and .json
+ *   PrimitiveBenchmark -check     checks, then one quick sample of each case
+ */
+#include "SmileyEngine.h"
+#include "environment.h"
+#include "EnemyFramework.h"
+#include "ProjectileManager.h"
+#include "collisioncircle.h"
+#include "hgerect.h"
+#include <stdarg.h>
+#include <time.h>
+#include <algorithm>
+
+extern SMH *smh;
+
+#define PRIMITIVE_BENCHMARK_CSV_FILE "PrimitiveBenchmark.csv"
+#define PRIMITIVE_BENCHMARK_JSON_FILE "PrimitiveBenchmark.json"
+#define PRIMITIVE_BENCHMARK_TEMP_FILE "PrimitiveBenchmark.tmp"
+#define PRIMITIVE_BENCHMARK_SEED 1234
+#define PRIMITIVE_BENCHMARK_POINTS 1024		//Power of 2 so cases can wrap with a mask
+#define PRIMITIVE_BENCHMARK_CHANGES 200		//About what a finished save file has
+#define PRIMITIVE_BENCHMARK_AREA_SIZE 128	//Squares on each side of the made up area
+#define PRIMITIVE_BENCHMARK_AREA OLDE_TOWNE	//The real area, the same one -microbenchmark uses
+#define PRIMITIVE_BENCHMARK_PATH_SQUARES 5	//How far apart the ends of a path on the real area are
+#define ASTAR_RADIUS 10
+#define DEFAULT_PRIMITIVE_BENCHMARK_WARMUP 3
+#define DEFAULT_PRIMITIVE_BENCHMARK_SAMPLES 25
+#define CHECK_PRIMITIVE_BENCHMARK_SAMPLES 1
+
+class PrimitiveCases
+{
+public:
+	static const int Distance = 0;
+	static const int AngleBetween = 1;
+	static const int CircleTestCircle = 2;
+	static const int CircleTestBox = 3;
+	static const int IsChanged = 4;
+	static const int BitStreamWrite = 5;
+	static const int BitStreamRead = 6;
+	static const int EnemyInfo = 7;
+	static const int AbilityInfo = 8;
+	static const int GameText = 9;
+	static const int TestCollision = 10;
+	static const int ValidPath = 11;
+	static const int CollisionAt = 12;
+	static const int AStar = 13;
+};
+
+#define NUM_PRIMITIVE_CASES 14
+
+static const char *caseNames[NUM_PRIMITIVE_CASES] = {
+	"Util::distance", "Util::getAngleBetween", "CollisionCircle::testCircle", "CollisionCircle::testBox",
+	"ChangeManager::isChanged", "BitStream::writeBits", "BitStream::readBits", "GameData::getEnemyInfo",
+	"GameData::getAbilityInfo", "GameData::getGameText", "Environment::testCollision", "Environment::validPath",
+	"Environment::collisionAt", "BaseEnemy::doAStar" };
+
+//Operations timed per sample, picked so that each sample takes around a millisecond
+static const int caseOperations[NUM_PRIMITIVE_CASES] = {
+	100000, 100000, 100000, 100000,
+	10000, 10000, 10000, 100000,
+	100000, 100000, 10000, 1000,
+	100000, 50 };
+
+/**
+ * An enemy that only paths. Everything else BaseEnemy does needs the game.
+ */
+class PathEnemy : public BaseEnemy {
+
+public:
+
+	PathEnemy(int _gridX, int _gridY, const EnemyInfo &info) {
+		currentState = NULL;
+		collisionBox = futureCollisionBox = NULL;
+		for (int i = 0; i < 4; i++) {
+			graphic[i] = NULL;
+		}
+		gridX = _gridX;
+		gridY = _gridY;
+		x = gridX * 64 + 32;
+		y = gridY * 64 + 32;
+
+		//The same as BaseEnemy::initEnemy
+		canPass.setAll(false);
+		canPass.set(WALKABLE, info.land);
+		canPass.set(SLIME, info.slime);
+		canPass.set(WALK_LAVA, info.lava);
+		canPass.set(DIZZY_MUSHROOM_1, info.mushrooms);
+		canPass.set(DIZZY_MUSHROOM_2, info.mushrooms);
+		canPass.set(SHALLOW_WATER, info.shallowWater);
+		canPass.set(SHALLOW_GREEN_WATER, info.shallowWater);
+		canPass.set(DEEP_WATER, info.deepWater);
+		canPass.set(GREEN_WATER, info.deepWater);
+		canPass.set(LEFT_ARROW, true);
+		canPass.set(RIGHT_ARROW, true);
+		canPass.set(UP_ARROW, true);
+		canPass.set(DOWN_ARROW, true);
+		canPass.set(PLAYER_START, true);
+		canPass.set(PLAYER_END, true);
+		canPass.set(WHITE_CYLINDER_DOWN, true);
+		canPass.set(YELLOW_CYLINDER_DOWN, true);
+		canPass.set(GREEN_CYLINDER_DOWN, true);
+		canPass.set(BLUE_CYLINDER_DOWN, true);
+		canPass.set(BROWN_CYLINDER_DOWN, true);
+		canPass.set(SILVER_CYLINDER_DOWN, true);
+		canPass.set(HOVER_PAD, true);
+	}
+
+	void draw(float dt) { }
+	void update(float dt) { }
+
+};
+
+struct PrimitiveResult {
+	int samples;
+	double minNs, medianNs, meanNs, stdDevNs, maxNs;	//Per operation
+	int checksum;									//Keeps the work from being optimized away
+};
+
+//Random points on a made up area, in pixels
+static int pointX[PRIMITIVE_BENCHMARK_POINTS], pointY[PRIMITIVE_BENCHMARK_POINTS];
+static int pathX[PRIMITIVE_BENCHMARK_POINTS], pathY[PRIMITIVE_BENCHMARK_POINTS];
+static CollisionCircle circles[PRIMITIVE_BENCHMARK_POINTS];
+static hgeRect boxes[PRIMITIVE_BENCHMARK_POINTS];
+
+//Random points on the real area, in pixels
+static int areaPointX[PRIMITIVE_BENCHMARK_POINTS], areaPointY[PRIMITIVE_BENCHMARK_POINTS];
+static int areaPathX[PRIMITIVE_BENCHMARK_POINTS], areaPathY[PRIMITIVE_BENCHMARK_POINTS];
+static hgeRect areaBoxes[PRIMITIVE_BENCHMARK_POINTS];
+
+static GameData *gameData;
+static Environment *environment;
+static PathEnemy *enemy;					//Its canPass is used for every case on the real area
+static ChangeManager *changeManager;
+static int gameTextHandle;
+static PrimitiveResult results[NUM_PRIMITIVE_CASES];
+static int numFailures;
+static unsigned int seed;
+
+/**
+ * The same generator as HGE's Random_Int, so the inputs don't depend on the
+ * C library.
+ */
+static int randomInt(int min, int max) {
+	seed = 214013 * seed + 2531011;
+	return min + (seed ^ seed >> 15) % (max - min + 1);
+}
+
+static double now() {
+	timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (double)time.tv_sec * 1000000000.0 + (double)time.tv_nsec;
+}
+
+static void check(bool passed, const char *format, ...) {
+	if (passed) return;
+	numFailures++;
+	va_list args;
+	va_start(args, format);
+	printf("Primitive benchmark: FAILED ");
+	vprintf(format, args);
+	printf("\n");
+	va_end(args);
+}
+
+//////////// Checks ////////////////
+
+/**
+ * The round trips BitStream::test() used to log, checked instead of logged.
+ */
+static void checkBitStream() {
+
+	static const bool bits[14] = { true, false, true, true, false, false, true, false, true, false, true, true, false, true };
+
+	BitStream stream;
+	stream.open(PRIMITIVE_BENCHMARK_TEMP_FILE, FILE_WRITE);
+	for (int i = 0; i < 14; i++) {
+		stream.writeBit(bits[i]);
+	}
+	stream.close();
+	stream.open(PRIMITIVE_BENCHMARK_TEMP_FILE, FILE_READ);
+	for (int i = 0; i < 14; i++) {
+		bool bit = stream.readBit();
+		check(bit == bits[i], "BitStream bit %d read back as %d", i, bit);
+	}
+	stream.close();
+
+	stream.open(PRIMITIVE_BENCHMARK_TEMP_FILE, FILE_WRITE);
+	stream.writeBit(true);
+	stream.writeBit(false);
+	stream.writeBit(true);
+	stream.writeByte(43);
+	stream.writeBit(true);
+	stream.writeByte(82);
+	stream.writeBits(4321, 24);
+	stream.close();
+	stream.open(PRIMITIVE_BENCHMARK_TEMP_FILE, FILE_READ);
+	check(stream.readBit() == true, "BitStream first bit before a byte");
+	check(stream.readBit() == false, "BitStream second bit before a byte");
+	check(stream.readBit() == true, "BitStream third bit before a byte");
+	int byte = stream.readByte();
+	check(byte == 43, "BitStream byte after 3 bits read back as %d", byte);
+	check(stream.readBit() == true, "BitStream bit between bytes");
+	byte = stream.readByte();
+	check(byte == 82, "BitStream byte after 1 bit read back as %d", byte);
+	int number = stream.readBits(24);
+	check(number == 4321, "BitStream 24 bits read back as %d", number);
+	stream.close();
+
+	remove(PRIMITIVE_BENCHMARK_TEMP_FILE);
+
+}
+
+/**
+ * Changing a square twice puts it back.
+ */
+static void checkChangeManager() {
+	ChangeManager changes;
+	check(!changes.isChanged(3, 10, 20), "ChangeManager starts with a change");
+	changes.change(3, 10, 20);
+	check(changes.isChanged(3, 10, 20), "ChangeManager didn't record a change");
+	check(!changes.isChanged(4, 10, 20), "ChangeManager change leaked into another area");
+	changes.change(3, 10, 20);
+	check(!changes.isChanged(3, 10, 20), "ChangeManager second change didn't undo the first");
+}
+
+static void checkUtil() {
+
+	check(Util::distance(0, 0, 3, 4) == 5, "Util::distance 3-4-5 gave %d", Util::distance(0, 0, 3, 4));
+	check(Util::distance(7, 2, 7, 9) == 7, "Util::distance vertical gave %d", Util::distance(7, 2, 7, 9));
+	check(fabs(Util::getAngleBetween(0, 0, 10, 0)) < 0.0001, "Util::getAngleBetween right");
+	check(fabs(Util::getAngleBetween(0, 0, 0, 10) - PI / 2.0) < 0.0001, "Util::getAngleBetween down");
+	check(fabs(Util::getAngleBetween(0, 0, -10, 0) - PI) < 0.0001, "Util::getAngleBetween left");
+	check(Util::getGridX(130) == 2 && Util::getGridY(63) == 0, "Util::getGridX/Y");
+	check(Util::intToString(7, 3) == "007", "Util::intToString padding gave %s", Util::intToString(7, 3).c_str());
+	check(Util::getTimeString(3725) == "1:02:05", "Util::getTimeString gave %s", Util::getTimeString(3725).c_str());
+
+	TileTraits::init();
+	check(Util::isWarp(BLUE_WARP) && !Util::isWarp(WALKABLE), "Util::isWarp");
+	check(Util::isArrowPad(UP_ARROW) && !Util::isArrowPad(PIT), "Util::isArrowPad");
+
+}
+
+static void checkCollisionCircle() {
+
+	CollisionCircle a, b;
+	a.set(0, 0, 10);
+	b.set(15, 0, 10);
+	check(a.testCircle(&b), "CollisionCircle overlapping circles missed");
+	b.set(25, 0, 4);
+	check(!a.testCircle(&b), "CollisionCircle far circles hit");
+	check(a.testPoint(5, 5) && !a.testPoint(10, 10), "CollisionCircle::testPoint");
+
+	hgeRect inside(-2, -2, 2, 2), corner(8, 8, 20, 20), edge(-5, 9, 5, 20), away(20, 20, 30, 30);
+	check(a.testBox(&inside), "CollisionCircle box around the center missed");
+	check(!a.testBox(&corner), "CollisionCircle box past the diagonal hit");
+	check(a.testBox(&edge), "CollisionCircle box over the top edge missed");
+	check(!a.testBox(&away), "CollisionCircle far box hit");
+
+}
+
+/**
+ * The data files load and a few known values come back.
+ */
+static void checkGameData() {
+
+	check(gameData->getNumEnemies() > 0 && gameData->getNumEnemies() <= MAX_ENEMIES,
+		"GameData has %d enemies", gameData->getNumEnemies());
+	check(gameData->getEnemyInfo(0).hp == 50, "GameData Crazy Croc has %d hp", gameData->getEnemyInfo(0).hp);
+	check(gameData->getEnemyInfo(1).hasRangedAttack && gameData->getEnemyInfo(1).range == 400,
+		"GameData Gumdrop's ranged attack");
+
+	bool threw = false;
+	try {
+		gameData->getEnemyInfo(MAX_ENEMIES);
+	} catch (System::Exception *ex) {
+		threw = true;
+		delete ex;
+	}
+	check(threw, "GameData::getEnemyInfo past the end didn't throw");
+
+	const char *pages = gameData->getGameText(gameTextHandle);
+	check(pages && strcmp(pages, "5") == 0, "GameData Hint0Pages is %s", pages ? pages : "missing");
+	check(gameData->getGameTextHandle("Hint0Pages") == gameTextHandle, "GameData handed out a second handle");
+
+}
+
+/**
+ * Finds a square that the enemy can pass along with the 8 around it, or
+ * returns false if there isn't one.
+ */
+static bool findOpenSquare(int *gridX, int *gridY) {
+	for (int i = 1; i < environment->areaWidth - 1; i++) {
+		for (int j = 1; j < environment->areaHeight - 1; j++) {
+			bool open = true;
+			for (int ni = i - 1; ni <= i + 1; ni++) {
+				for (int nj = j - 1; nj <= j + 1; nj++) {
+					if (!enemy->canPass[environment->collision(ni, nj)]) open = false;
+				}
+			}
+			if (open) {
+				*gridX = i;
+				*gridY = j;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+/**
+ * Finds a square that the enemy can't pass, or returns false if there isn't one.
+ */
+static bool findBlockedSquare(int *gridX, int *gridY) {
+	for (int i = 0; i < environment->areaWidth; i++) {
+		for (int j = 0; j < environment->areaHeight; j++) {
+			if (!enemy->canPass[environment->collision(i, j)]) {
+				*gridX = i;
+				*gridY = j;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+/**
+ * The collision and path queries give the obvious answers on an open square,
+ * a blocked square and off the edge of the real area.
+ */
+static void checkArea() {
+
+	int openX, openY, blockedX, blockedY;
+	if (!findOpenSquare(&openX, &openY) || !findBlockedSquare(&blockedX, &blockedY)) {
+		check(false, "area %d has no open square or no blocked square", PRIMITIVE_BENCHMARK_AREA);
+		return;
+	}
+	int openCenterX = openX * 64 + 32, openCenterY = openY * 64 + 32;
+	int blockedCenterX = blockedX * 64 + 32, blockedCenterY = blockedY * 64 + 32;
+
+	check(environment->collisionAt(openCenterX, openCenterY) == environment->collision(openX, openY),
+		"Environment::collisionAt (%d,%d) gave %d", openX, openY, environment->collisionAt(openCenterX, openCenterY));
+	check(environment->collisionAt(-100, -100) == UNWALKABLE, "Environment::collisionAt above the area");
+	check(environment->collisionAt(environment->areaWidth * 64 + 10, 10) == UNWALKABLE, "Environment::collisionAt right of the area");
+
+	hgeRect box;
+	box.SetRadius(openCenterX, openCenterY, 10);
+	check(!environment->testCollision(&box, enemy->canPass), "Environment::testCollision hit on open square (%d,%d)", openX, openY);
+	box.SetRadius(blockedCenterX, blockedCenterY, 10);
+	check(environment->testCollision(&box, enemy->canPass), "Environment::testCollision missed blocked square (%d,%d)", blockedX, blockedY);
+
+	check(environment->validPath(openCenterX, openCenterY, openCenterX + 20, openCenterY + 20, 8, enemy->canPass),
+		"Environment::validPath blocked inside open square (%d,%d)", openX, openY);
+	check(!environment->validPath(blockedCenterX, blockedCenterY, blockedCenterX + 100, blockedCenterY + 100, 8, enemy->canPass),
+		"Environment::validPath clear from blocked square (%d,%d)", blockedX, blockedY);
+
+	enemy->doAStar(enemy->gridX, enemy->gridY, ASTAR_RADIUS);
+	check(enemy->mapPath[enemy->gridX][enemy->gridY] == 0, "BaseEnemy::doAStar to its own square gave %d",
+		enemy->mapPath[enemy->gridX][enemy->gridY]);
+
+	//Move the enemy onto the open square for a moment to step to its neighbors
+	int gridX = enemy->gridX, gridY = enemy->gridY;
+	enemy->gridX = openX;
+	enemy->gridY = openY;
+	enemy->doAStar(openX + 1, openY, ASTAR_RADIUS);
+	check(enemy->mapPath[openX][openY] == 1, "BaseEnemy::doAStar one square right gave %d", enemy->mapPath[openX][openY]);
+	enemy->doAStar(openX + 1, openY + 1, ASTAR_RADIUS);
+	check(enemy->mapPath[openX][openY] == 1, "BaseEnemy::doAStar one square diagonally gave %d", enemy->mapPath[openX][openY]);
+	enemy->gridX = gridX;
+	enemy->gridY = gridY;
+
+}
+
+//////////// Cases ////////////////
+
+/**
+ * Parses the real area and fills the stubbed environment's tile layers from
+ * it the same way Environment::loadArea does. The pathing enemy goes on the
+ * first enemy square, like the first enemy -microbenchmark times A* on.
+ */
+static void loadArea() {
+
+	AreaData *areaData = AreaLoader::parseArea(PRIMITIVE_BENCHMARK_AREA);
+	if (areaData->width <= 0 || areaData->height <= 0 || areaData->width > 256 || areaData->height > 256) {
+		AreaLoader::deleteAreaData(areaData);
+		throw new System::Exception(new System::String("PrimitiveBenchmark: couldn't load the area"));
+	}
+
+	smh = new SMH(NULL);
+	environment = new Environment();
+	smh->environment = environment;
+
+	environment->areaWidth = areaData->width;
+	environment->areaHeight = areaData->height;
+	for (int row = 0; row < environment->areaHeight; row++) {
+		for (int col = 0; col < environment->areaWidth; col++) {
+			environment->ids(col, row) = areaData->get(AreaLayers::Ids, col, row);
+			environment->variable(col, row) = areaData->get(AreaLayers::Variable, col, row);
+			environment->terrain(col, row) = areaData->get(AreaLayers::Terrain, col, row);
+			environment->collision(col, row) = areaData->get(AreaLayers::Collision, col, row);
+			environment->item(col, row) = areaData->get(AreaLayers::Item, col, row);
+			environment->enemyLayer(col, row) = areaData->get(AreaLayers::Enemy, col, row) - 1;
+		}
+	}
+
+	for (std::list<AreaSpawn>::iterator i = areaData->spawns.begin(); i != areaData->spawns.end() && !enemy; i++) {
+		if (i->enemy > 0 && i->enemy < gameData->getNumEnemies() && environment->ids(i->gridX, i->gridY) != ENEMYGROUP_ENEMY_POPUP) {
+			enemy = new PathEnemy(i->gridX, i->gridY, gameData->getEnemyInfo(i->enemy - 1));
+		}
+	}
+
+	AreaLoader::deleteAreaData(areaData);
+
+	if (!enemy) {
+		throw new System::Exception(new System::String("PrimitiveBenchmark: the area has no enemies"));
+	}
+
+}
+
+static void unloadArea() {
+	delete enemy;
+	enemy = NULL;
+	delete environment;
+	environment = NULL;
+	delete smh;
+	smh = NULL;
+}
+
+/**
+ * Makes up the inputs for every case from a fixed seed so that runs can be
+ * compared.
+ */
+static void setUp() {
+
+	seed = PRIMITIVE_BENCHMARK_SEED;
+
+	int size = PRIMITIVE_BENCHMARK_AREA_SIZE * 64;
+	int pathLength = 5 * 64;
+	for (int i = 0; i < PRIMITIVE_BENCHMARK_POINTS; i++) {
+		pointX[i] = randomInt(0, size - 1);
+		pointY[i] = randomInt(0, size - 1);
+		pathX[i] = std::min(size - 1, std::max(0, pointX[i] + randomInt(-pathLength, pathLength)));
+		pathY[i] = std::min(size - 1, std::max(0, pointY[i] + randomInt(-pathLength, pathLength)));
+		circles[i].set(pointX[i], pointY[i], randomInt(10, 100));
+		boxes[i].SetRadius(pathX[i], pathY[i], randomInt(10, 32));
+	}
+
+	changeManager = new ChangeManager();
+	for (int i = 0; i < PRIMITIVE_BENCHMARK_CHANGES; i++) {
+		changeManager->change(randomInt(0, NUM_AREAS - 1), randomInt(0, 255), randomInt(0, 255));
+	}
+
+	int areaWidth = environment->areaWidth * 64;
+	int areaHeight = environment->areaHeight * 64;
+	int areaPathLength = PRIMITIVE_BENCHMARK_PATH_SQUARES * 64;
+	for (int i = 0; i < PRIMITIVE_BENCHMARK_POINTS; i++) {
+		areaPointX[i] = randomInt(0, areaWidth - 1);
+		areaPointY[i] = randomInt(0, areaHeight - 1);
+		areaPathX[i] = std::min(areaWidth - 1, std::max(0, areaPointX[i] + randomInt(-areaPathLength, areaPathLength)));
+		areaPathY[i] = std::min(areaHeight - 1, std::max(0, areaPointY[i] + randomInt(-areaPathLength, areaPathLength)));
+		areaBoxes[i].SetRadius(areaPathX[i], areaPathY[i], randomInt(10, 32));
+	}
+
+	//Give the read case a file with enough bits in it
+	BitStream stream;
+	stream.open(PRIMITIVE_BENCHMARK_TEMP_FILE, FILE_WRITE);
+	for (int i = 0; i < caseOperations[PrimitiveCases::BitStreamRead]; i++) {
+		stream.writeBits(i & 0xFFFF, 16);
+	}
+	stream.close();
+
+}
+
+static void tearDown() {
+	delete changeManager;
+	changeManager = NULL;
+	remove(PRIMITIVE_BENCHMARK_TEMP_FILE);
+}
+
+/**
+ * Does one sample's worth of a case. Returns something that depends on
+ * every operation so none of them can be optimized away.
+ */
+static int runCase(int benchmarkCase, int operations) {
+
+	int checksum = 0;
+	int mask = PRIMITIVE_BENCHMARK_POINTS - 1;
+
+	switch (benchmarkCase) {
+
+		case PrimitiveCases::Distance:
+			for (int i = 0; i < operations; i++) {
+				checksum += Util::distance(pointX[i & mask], pointY[i & mask], pathX[i & mask], pathY[i & mask]);
+			}
+			break;
+
+		case PrimitiveCases::AngleBetween:
+			for (int i = 0; i < operations; i++) {
+				checksum += (int)(Util::getAngleBetween(pointX[i & mask], pointY[i & mask], pathX[i & mask], pathY[i & mask]) * 100.0);
+			}
+			break;
+
+		case PrimitiveCases::CircleTestCircle:
+			for (int i = 0; i < operations; i++) {
+				if (circles[i & mask].testCircle(&circles[(i * 7 + 1) & mask])) checksum++;
+			}
+			break;
+
+		case PrimitiveCases::CircleTestBox:
+			for (int i = 0; i < operations; i++) {
+				if (circles[i & mask].testBox(&boxes[(i * 7 + 1) & mask])) checksum++;
+			}
+			break;
+
+		case PrimitiveCases::IsChanged:
+			for (int i = 0; i < operations; i++) {
+				if (changeManager->isChanged(i % NUM_AREAS, pointX[i & mask] & 255, pointY[i & mask] & 255)) checksum++;
+			}
+			break;
+
+		case PrimitiveCases::BitStreamWrite: {
+			BitStream stream;
+			stream.open(PRIMITIVE_BENCHMARK_TEMP_FILE ".write", FILE_WRITE);
+			for (int i = 0; i < operations; i++) {
+				stream.writeBits(i & 0xFFFF, 16);
+			}
+			checksum = stream.getNumBitsWritten();
+			stream.close();
+			remove(PRIMITIVE_BENCHMARK_TEMP_FILE ".write");
+			break;
+		}
+
+		case PrimitiveCases::BitStreamRead: {
+			BitStream stream;
+			stream.open(PRIMITIVE_BENCHMARK_TEMP_FILE, FILE_READ);
+			for (int i = 0; i < operations; i++) {
+				checksum += stream.readBits(16);
+			}
+			stream.close();
+			break;
+		}
+
+		case PrimitiveCases::EnemyInfo: {
+			int numEnemies = std::min(gameData->getNumEnemies(), MAX_ENEMIES);
+			for (int i = 0; i < operations; i++) {
+				checksum += gameData->getEnemyInfo(i % numEnemies).hp;
+			}
+			break;
+		}
+
+		case PrimitiveCases::AbilityInfo:
+			for (int i = 0; i < operations; i++) {
+				checksum += gameData->getAbilityInfo(i % NUM_ABILITIES).manaCost + i;
+			}
+			break;
+
+		case PrimitiveCases::GameText:
+			for (int i = 0; i < operations; i++) {
+				if (gameData->getGameText(gameTextHandle)) checksum++;
+			}
+			break;
+
+		case PrimitiveCases::TestCollision:
+			for (int i = 0; i < operations; i++) {
+				if (environment->testCollision(&areaBoxes[i & mask], enemy->canPass)) checksum++;
+			}
+			break;
+
+		case PrimitiveCases::ValidPath:
+			for (int i = 0; i < operations; i++) {
+				if (environment->validPath(areaPointX[i & mask], areaPointY[i & mask], areaPathX[i & mask], areaPathY[i & mask], 24, enemy->canPass)) checksum++;
+			}
+			break;
+
+		case PrimitiveCases::CollisionAt:
+			for (int i = 0; i < operations; i++) {
+				checksum += environment->collisionAt(areaPointX[i & mask], areaPointY[i & mask]);
+			}
+			break;
+
+		case PrimitiveCases::AStar:
+			for (int i = 0; i < operations; i++) {
+				//Destinations within the radius around the enemy so the whole search is done every time
+				int destinationX = enemy->gridX + (i % 9) - 4;
+				int destinationY = enemy->gridY + ((i / 9) % 9) - 4;
+				enemy->doAStar(destinationX, destinationY, ASTAR_RADIUS);
+				checksum += enemy->mapPath[enemy->gridX][enemy->gridY];
+			}
+			break;
+
+	}
+
+	return checksum;
+
+}
+
+/**
+ * Warms a case up and then times it sample by sample.
+ */
+static void measure(int benchmarkCase, int warmup, int samples) {
+
+	PrimitiveResult *result = &results[benchmarkCase];
+	result->checksum = 0;
+
+	int operations = caseOperations[benchmarkCase];
+	for (int i = 0; i < warmup; i++) {
+		result->checksum += runCase(benchmarkCase, operations);
+	}
+
+	std::vector<double> times;
+	for (int i = 0; i < samples; i++) {
+		double start = now();
+		result->checksum += runCase(benchmarkCase, operations);
+		times.push_back((now() - start) / operations);
+	}
+
+	std::sort(times.begin(), times.end());
+	double total = 0.0;
+	for (int i = 0; i < samples; i++) {
+		total += times[i];
+	}
+	double variance = 0.0;
+	for (int i = 0; i < samples; i++) {
+		variance += (times[i] - total / samples) * (times[i] - total / samples);
+	}
+
+	result->samples = samples;
+	result->minNs = times[0];
+	result->maxNs = times[samples - 1];
+	result->meanNs = total / samples;
+	result->medianNs = (samples % 2) ? times[samples / 2] : (times[samples / 2 - 1] + times[samples / 2]) / 2.0;
+	result->stdDevNs = samples > 1 ? sqrt(variance / (samples - 1)) : 0.0;
+
+	printf("Primitive benchmark: %s, %d x %d operations, median %.2f ns, mean %.2f ns, std dev %.2f ns, min %.2f ns, max %.2f ns\n",
+		caseNames[benchmarkCase], samples, operations, result->medianNs, result->meanNs, result->stdDevNs, result->minNs, result->maxNs);
+
+}
+
+static void writeResults(int warmup, int samples) {
+
+	FILE *file = fopen(PRIMITIVE_BENCHMARK_CSV_FILE, "w");
+	if (file) {
+		fprintf(file, "name,operations,samples,minNs,medianNs,meanNs,stdDevNs,maxNs,checksum\n");
+		for (int i = 0; i < NUM_PRIMITIVE_CASES; i++) {
+			fprintf(file, "%s,%d,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%d\n", caseNames[i], caseOperations[i], results[i].samples,
+				results[i].minNs, results[i].medianNs, results[i].meanNs, results[i].stdDevNs, results[i].maxNs, results[i].checksum);
+		}
+		fclose(file);
+	} else {
+		printf("Primitive benchmark: couldn't write %s\n", PRIMITIVE_BENCHMARK_CSV_FILE);
+	}
+
+	file = fopen(PRIMITIVE_BENCHMARK_JSON_FILE, "w");
+	if (!file) {
+		printf("Primitive benchmark: couldn't write %s\n", PRIMITIVE_BENCHMARK_JSON_FILE);
+		return;
+	}
+
+	fprintf(file, "{\n");
+	fprintf(file, "  \"warmup\": %d,\n", warmup);
+	fprintf(file, "  \"samples\": %d,\n", samples);
+	fprintf(file, "  \"benchmarks\": [\n");
+
+	for (int i = 0; i < NUM_PRIMITIVE_CASES; i++) {
+		PrimitiveResult *result = &results[i];
+		fprintf(file, "%s    {\n", i == 0 ? "" : ",\n");
+		fprintf(file, "      \"name\": \"%s\",\n", caseNames[i]);
+		fprintf(file, "      \"operations\": %d,\n", caseOperations[i]);
+		fprintf(file, "      \"minNs\": %.3f,\n", result->minNs);
+		fprintf(file, "      \"medianNs\": %.3f,\n", result->medianNs);
+		fprintf(file, "      \"meanNs\": %.3f,\n", result->meanNs);
+		fprintf(file, "      \"stdDevNs\": %.3f,\n", result->stdDevNs);
+		fprintf(file, "      \"maxNs\": %.3f,\n", result->maxNs);
+		fprintf(file, "      \"checksum\": %d\n", result->checksum);
+		fprintf(file, "    }");
+	}
+
+	fprintf(file, "\n  ]\n");
+	fprintf(file, "}\n");
+	fclose(file);
+
+}
+
+int main(int argc, char **argv) {
+
+	bool checkOnly = argc > 1 && strcmp(argv[1], "-check") == 0;
+	int warmup = checkOnly ? 0 : DEFAULT_PRIMITIVE_BENCHMARK_WARMUP;
+	int samples = checkOnly ? CHECK_PRIMITIVE_BENCHMARK_SAMPLES : DEFAULT_PRIMITIVE_BENCHMARK_SAMPLES;
+
+	try {
+
+		//The game runs these as startup tasks
+		gameData = new GameData();
+		gameData->parseEnemyTable();
+		gameData->loadEnemyData();
+		gameData->parseGameText();
+		gameTextHandle = gameData->getGameTextHandle("Hint0Pages");
+		loadArea();
+
+		numFailures = 0;
+		checkBitStream();
+		checkChangeManager();
+		checkUtil();
+		checkCollisionCircle();
+		checkGameData();
+		checkArea();
+		printf("Primitive benchmark: checks done, %d failures\n", numFailures);
+
+		setUp();
+		for (int i = 0; i < NUM_PRIMITIVE_CASES; i++) {
+			measure(i, warmup, samples);
+		}
+		tearDown();
+
+		if (!checkOnly) writeResults(warmup, samples);
+
+		unloadArea();
+		delete gameData;
+
+	} catch (System::Exception *ex) {
+		printf("Primitive benchmark: %s\n", ex->ToString());
+		delete ex;
+		return 1;
+	}
+
+	return numFailures > 0 ? 1 : 0;
+
+}
@@ -0,0 +1,57 @@
+/**
+ * Just enough of SMH, Environment and BaseEnemy for the collision and path
+ * queries to run against a real area without the rest of the game. There
+ * are no silly pads and nothing is ever drawn.
+ */
+#include "SmileyEngine.h"
+#include "environment.h"
+#include "EnemyFramework.h"
+#include "hgerect.h"
+#include <stdlib.h>
+
+SMH *smh;
+
+SMH::SMH(HGE *_hge) {
+	hge = _hge;
+	areaArena = NULL;
+	areaLoader = NULL;
+	environment = NULL;
+	player = NULL;
+	logger = NULL;
+}
+
+SMH::~SMH() { }
+
+Environment::Environment() {
+	specialTileManager = NULL;
+	collisionBox = new hgeRect();
+	areaWidth = areaHeight = 0;
+}
+
+Environment::~Environment() {
+	delete collisionBox;
+}
+
+bool Environment::hasSillyPad(int gridX, int gridY) {
+	return false;
+}
+
+//Enemies aren't scoped to an area here, so they come straight off the heap
+void *AreaObject::operator new(size_t size) {
+	return malloc(size);
+}
+
+void AreaObject::operator delete(void *p) {
+	free(p);
+}
+
+void BaseEnemy::drawFrozen(float dt) { }
+void BaseEnemy::drawStunned(float dt, float percentage) { }
+void BaseEnemy::drawImmunities() { }
+void BaseEnemy::drawDebug() { }
+void BaseEnemy::hitWithProjectile(int projectileType) { }
+void BaseEnemy::notifyTongueHit() { }
+bool BaseEnemy::doTongueCollision(Tongue *tongue, float damage) { return false; }
+void BaseEnemy::doPlayerCollision() { }
+void BaseEnemy::notifyOfDeath() { }
+void BaseEnemy::drawAfterSmiley(float dt) { }
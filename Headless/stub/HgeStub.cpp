@@ -0,0 +1,32 @@
+/**
+ * The pieces of HGE's helper library that the engine primitives use, written
+ * against the standard library.
+ */
+#include "hgerect.h"
+#include "hgesprite.h"
+#include <math.h>
+
+//Never set, since nothing headless makes a sprite
+HGE *hgeSprite::hge = 0;
+
+void hgeRect::Encapsulate(float x, float y) {
+	if (bClean) {
+		x1 = x2 = x;
+		y1 = y2 = y;
+		bClean = false;
+	} else {
+		if (x < x1) x1 = x;
+		if (x > x2) x2 = x;
+		if (y < y1) y1 = y;
+		if (y > y2) y2 = y;
+	}
+}
+
+bool hgeRect::TestPoint(float x, float y) const {
+	return x >= x1 && x < x2 && y >= y1 && y < y2;
+}
+
+bool hgeRect::Intersect(const hgeRect *rect) const {
+	return fabs(x1 + x2 - rect->x1 - rect->x2) < (x2 - x1 + rect->x2 - rect->x1) &&
+		fabs(y1 + y2 - rect->y1 - rect->y2) < (y2 - y1 + rect->y2 - rect->y1);
+}
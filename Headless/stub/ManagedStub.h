@@ -0,0 +1,29 @@
+/**
+ * Stands in for the parts of mscorlib the engine primitives use, which is
+ * only throwing System::Exception. Force included by CMakeLists.txt since the
+ * game gets these from #using <mscorlib.dll>.
+ */
+#ifndef HEADLESS_MANAGED_STUB_H_
+#define HEADLESS_MANAGED_STUB_H_
+
+#include <string>
+
+namespace System {
+
+	class String {
+	public:
+		String(const char *text) : text(text) { }
+		std::string text;
+	};
+
+	class Exception {
+	public:
+		Exception(const char *message) : message(message) { }
+		Exception(String *message) : message(message->text) { delete message; }
+		const char *ToString() { return message.c_str(); }
+		std::string message;
+	};
+
+}
+
+#endif
@@ -0,0 +1,3 @@
+/**
+ * Empty in the headless build. windows.h has the few types that are used.
+ */
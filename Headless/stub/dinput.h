@@ -0,0 +1,3 @@
+/**
+ * Empty in the headless build. SmileyInput is declared but never built.
+ */
@@ -0,0 +1,75 @@
+/**
+ * Stands in for windows.h in the headless build. Only has what the engine
+ * primitives, hge.h and the declarations in SmileyEngine.h use. There are no
+ * threads, so CreateThread always fails and callers fall back to doing the
+ * work themselves.
+ */
+#ifndef HEADLESS_WINDOWS_H_
+#define HEADLESS_WINDOWS_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef unsigned long DWORD;
+typedef unsigned short WORD;
+typedef unsigned char BYTE;
+typedef int BOOL;
+typedef unsigned char boolean;
+typedef long LONG;
+typedef long long LONGLONG;
+typedef long HRESULT;
+typedef void VOID;
+typedef void *LPVOID;
+typedef void *HANDLE;
+typedef void *HWND;
+
+typedef union {
+	struct {
+		DWORD LowPart;
+		LONG HighPart;
+	};
+	LONGLONG QuadPart;
+} LARGE_INTEGER;
+
+typedef struct {
+	DWORD dwLowDateTime;
+	DWORD dwHighDateTime;
+} FILETIME;
+
+typedef struct {
+	void *DebugInfo;
+} CRITICAL_SECTION;
+
+#define TRUE 1
+#define FALSE 0
+#define INFINITE 0xFFFFFFFF
+#define WAIT_OBJECT_0 0
+
+#define __stdcall
+#define WINAPI
+
+typedef DWORD (WINAPI *LPTHREAD_START_ROUTINE)(LPVOID);
+
+inline HANDLE CreateThread(void *, DWORD, LPTHREAD_START_ROUTINE, LPVOID, DWORD, DWORD *) {
+	return 0;
+}
+
+inline DWORD WaitForSingleObject(HANDLE, DWORD) {
+	return WAIT_OBJECT_0;
+}
+
+inline BOOL CloseHandle(HANDLE) {
+	return TRUE;
+}
+
+/**
+ * The CRT's itoa, which Util uses for its string conversions.
+ */
+inline char *itoa(int value, char *buffer, int radix) {
+	if (radix == 16) sprintf(buffer, "%x", value);
+	else if (radix == 8) sprintf(buffer, "%o", value);
+	else sprintf(buffer, "%d", value);
+	return buffer;
+}
+
+#endif
@@ -0,0 +1,115 @@
+/** 
+ * AbilityData.cpp
+ * 
+ * The ability names, descriptions and costs. Kept out of GameData.cpp because
+ * the descriptions quote Smiley's current damage, which needs SMH.
+ */
+#include "SmileyEngine.h"
+#include "player.h"
+
+extern SMH *smh;
+
+void GameData::refreshAbilityData() 
+{
+	//Clinton's Cane
+	strcpy(abilities[CANE].name, "Cane Of Clinton");
+	strcpy(abilities[CANE].description, 
+		"Use to communicate telepathically with Bill Clinton. \n\nMana Cost: 10");
+	abilities[CANE].type = ACTIVATED;
+	abilities[CANE].manaCost = 10;
+	abilities[CANE].coolDown = 0;
+
+	//Jesus' Sandals
+    strcpy(abilities[WATER_BOOTS].name, "Jesus' Sandals");
+	strcpy(abilities[WATER_BOOTS].description, 
+		"While equipped you gain the power of Jesus Christ. (That means you can walk on water)");
+	abilities[WATER_BOOTS].type = HOLD;
+	abilities[WATER_BOOTS].manaCost = 0;
+	abilities[WATER_BOOTS].coolDown = 0;
+
+	//Boots of 14
+	strcpy(abilities[SPRINT_BOOTS].name, "Speed Boots");
+	strcpy(abilities[SPRINT_BOOTS].description, "When used, you run 75% faster.");
+	abilities[SPRINT_BOOTS].type = HOLD;
+	abilities[SPRINT_BOOTS].manaCost = 0;
+	abilities[SPRINT_BOOTS].coolDown = 10.0;
+	abilities[SPRINT_BOOTS].timeLastUsed = 0;
+
+	//Fire Breath
+	strcpy(abilities[FIRE_BREATH].name, "Fire Breath");
+	strcpy(abilities[FIRE_BREATH].description, 
+		"Allows you to breath deadly fire breath.\n\nMana Cost: 15/second\n");
+	strcat(abilities[FIRE_BREATH].description, "Damage: ");
+	strcat(abilities[FIRE_BREATH].description, Util::intToString(smh->player->getFireBreathDamage() * 100).c_str());
+	strcat(abilities[FIRE_BREATH].description, " per second.");
+	abilities[FIRE_BREATH].type = HOLD;
+	abilities[FIRE_BREATH].manaCost = 15;
+	abilities[FIRE_BREATH].coolDown = 0;
+
+	//Ice Breath
+	strcpy(abilities[ICE_BREATH].name, "Ice Breath");
+	strcpy(abilities[ICE_BREATH].description, 
+		"Unleashes an icy blast that can freeze enemies.\n\n\nMana Cost: 10");
+	abilities[ICE_BREATH].type = ACTIVATED;
+	abilities[ICE_BREATH].manaCost = 20;
+	abilities[ICE_BREATH].coolDown = 1.5;
+	abilities[ICE_BREATH].timeLastUsed = 0;
+
+	//Reflection Shield
+	strcpy(abilities[REFLECTION_SHIELD].name, "Reflection Shield");
+	strcpy(abilities[REFLECTION_SHIELD].description, 
+		"Activate to deflect certain projectiles.\n\n\nMana Cost: 35/second");
+	abilities[REFLECTION_SHIELD].type = HOLD;
+	abilities[REFLECTION_SHIELD].manaCost = 15;
+	abilities[REFLECTION_SHIELD].coolDown = 0;
+
+	//Hover
+	strcpy(abilities[HOVER].name, "Hover");
+	strcpy(abilities[HOVER].description, 
+		"Grants you the power to use hover pads.");
+	abilities[HOVER].type = HOLD;
+	abilities[HOVER].manaCost = 0;
+	abilities[HOVER].coolDown = 0;
+
+	//Lightning Orbs
+	strcpy(abilities[LIGHTNING_ORB].name, "Lightning Orbs");
+	strcpy(abilities[LIGHTNING_ORB].description, 
+		"Shoots orbs of lightning. \n\n\nMana Cost: 5\n");
+	strcat(abilities[LIGHTNING_ORB].description, "Damage: ");
+	strcat(abilities[LIGHTNING_ORB].description, Util::intToString(smh->player->getLightningOrbDamage() * 100).c_str());
+	abilities[LIGHTNING_ORB].type = ACTIVATED;
+	abilities[LIGHTNING_ORB].manaCost = 5;
+	abilities[LIGHTNING_ORB].coolDown = 0.10;
+	abilities[LIGHTNING_ORB].timeLastUsed = 0;
+
+	//Shrink
+	strcpy(abilities[SHRINK].name, "Shrink");
+	strcpy(abilities[SHRINK].description, "When activated Smiley will shrink in size and be able to fit into smaller spaces.");
+	abilities[SHRINK].type = ACTIVATED;
+	abilities[SHRINK].manaCost = 0;
+	abilities[SHRINK].coolDown = 0;
+
+	//Silly Pad
+	strcpy(abilities[SILLY_PAD].name, "Silly Pad");
+	strcpy(abilities[SILLY_PAD].description, 
+		"Places a Silly Pad. They are so silly that enemies can't even cross them!\n\nMana Cost: 5");
+	abilities[SILLY_PAD].type = ACTIVATED;
+	abilities[SILLY_PAD].manaCost = 5;
+	abilities[SILLY_PAD].coolDown = 0;
+
+	//King Tut's Mask
+	strcpy(abilities[TUTS_MASK].name, "Tut's Mask");
+	strcpy(abilities[TUTS_MASK].description, 
+		"Grants the wearer the power of invisibility.\n\n\nMana Cost: 5/second");
+	abilities[TUTS_MASK].type = HOLD;
+	abilities[TUTS_MASK].manaCost = 5;
+	abilities[TUTS_MASK].coolDown = 0;
+	
+	//Frisbee
+	strcpy(abilities[FRISBEE].name, "Frisbee!?!?! K");
+	strcpy(abilities[FRISBEE].description, "Throws a frisbee that can stun enemies.");
+	abilities[FRISBEE].type = HOLD;
+	abilities[FRISBEE].manaCost = 0;
+	abilities[FRISBEE].coolDown = 0;
+	abilities[FRISBEE].timeLastUsed = 0;
+}
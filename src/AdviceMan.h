@@ -1,7 +1,9 @@
 #ifndef _ADVICEMAN_H_
 #define _ADVICEMAN_H_
 
-class AdviceMan {
+#include "AreaArena.h"
+
+class AdviceMan : public AreaObject {
 
 public:
 
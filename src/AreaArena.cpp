@@ -0,0 +1,192 @@
+#include "SmileyEngine.h"
+
+extern SMH *smh;
+
+AreaArena::AreaArena() {
+	currentChunk = 0;
+	chunkUsed = 0;
+	numFreeLists = 0;
+	generation = 1;
+	numAllocations = numRecycled = 0;
+	bytesUsed = peakBytesUsed = 0;
+}
+
+AreaArena::~AreaArena() {
+	for (int i = 0; i < (int)chunks.size(); i++) {
+		delete[] chunks[i];
+	}
+	chunks.clear();
+	chunkSizes.clear();
+}
+
+/**
+ * Returns memory that lives until the next reset. Blocks of the same size
+ * that were released earlier in the area are reused first. Each block is
+ * preceded by an AreaArenaBlock header holding its size and generation.
+ */
+void *AreaArena::allocate(size_t size) {
+
+	size = (size + AREA_ARENA_ALIGNMENT - 1) & ~(AREA_ARENA_ALIGNMENT - 1);
+	if (size == 0) size = AREA_ARENA_ALIGNMENT;
+
+	numAllocations++;
+	bytesUsed += (int)size;
+	if (bytesUsed > peakBytesUsed) peakBytesUsed = bytesUsed;
+
+	for (int i = 0; i < numFreeLists; i++) {
+		if (freeLists[i].size == size && freeLists[i].head) {
+			void *p = freeLists[i].head;
+			freeLists[i].head = *(void**)p;
+			AreaArenaBlock *block = (AreaArenaBlock*)((char*)p - AREA_ARENA_HEADER_SIZE);
+			block->live = true;
+			numRecycled++;
+			return p;
+		}
+	}
+
+	//Move on to the next chunk that is big enough, or add one
+	size_t blockSize = AREA_ARENA_HEADER_SIZE + size;
+	if (chunks.empty() || chunkUsed + blockSize > chunkSizes[currentChunk]) {
+		int nextChunk = chunks.empty() ? 0 : currentChunk + 1;
+		while (nextChunk < (int)chunks.size() && chunkSizes[nextChunk] < blockSize) {
+			nextChunk++;
+		}
+		if (nextChunk >= (int)chunks.size()) {
+			addChunk(max((size_t)AREA_ARENA_CHUNK_SIZE, blockSize));
+			nextChunk = (int)chunks.size() - 1;
+		}
+		currentChunk = nextChunk;
+		chunkUsed = 0;
+	}
+
+	AreaArenaBlock *block = (AreaArenaBlock*)(chunks[currentChunk] + chunkUsed);
+	block->size = size;
+	block->generation = generation;
+	block->live = true;
+	chunkUsed += blockSize;
+
+	return (char*)block + AREA_ARENA_HEADER_SIZE;
+
+}
+
+/**
+ * Called when an object is deleted before its area is unloaded, for example an
+ * enemy that a spawner made. Its block goes on a free list so that spawners
+ * don't keep growing the arena. Pointers into chunks that were trimmed, blocks
+ * that were already released and blocks whose header carries an older
+ * generation are ignored. A stale pointer whose header bytes have since been
+ * overwritten by a new block can still match, so area scoped objects should
+ * be deleted before reset() all the same.
+ */
+void AreaArena::release(void *p) {
+
+	if (!p || !ownsBlock(p)) return;
+
+	AreaArenaBlock *block = (AreaArenaBlock*)((char*)p - AREA_ARENA_HEADER_SIZE);
+	if (!block->live || block->generation != generation) return;
+	block->live = false;
+	size_t size = block->size;
+
+	bytesUsed -= (int)size;
+
+	for (int i = 0; i < numFreeLists; i++) {
+		if (freeLists[i].size == size) {
+			*(void**)p = freeLists[i].head;
+			freeLists[i].head = p;
+			return;
+		}
+	}
+
+	//If every free list is taken the block just waits for the next reset
+	if (numFreeLists < AREA_ARENA_FREE_LISTS) {
+		freeLists[numFreeLists].size = size;
+		freeLists[numFreeLists].head = p;
+		*(void**)p = NULL;
+		numFreeLists++;
+	}
+
+}
+
+/**
+ * Releases everything allocated since the last reset at once. Call this once
+ * every area scoped object has been deleted.
+ */
+void AreaArena::reset() {
+
+	if (numAllocations > 0) {
+		smh->logger->write(LogLevels::Info, LogCategories::Environment,
+			"Area arena: %d allocations (%d recycled), peak %d KB, %d KB reserved in %d chunks",
+			numAllocations, numRecycled, peakBytesUsed / 1024, getBytesReserved() / 1024, chunks.size());
+	}
+
+	//Zero is skipped so that a header from zeroed memory never looks current
+	generation++;
+	if (generation == 0) generation = 1;
+	trimChunks();
+	currentChunk = 0;
+	chunkUsed = 0;
+	numFreeLists = 0;
+	numAllocations = numRecycled = 0;
+	bytesUsed = peakBytesUsed = 0;
+
+}
+
+int AreaArena::getNumAllocations() {
+	return numAllocations;
+}
+
+int AreaArena::getBytesUsed() {
+	return bytesUsed;
+}
+
+int AreaArena::getBytesReserved() {
+	size_t reserved = 0;
+	for (int i = 0; i < (int)chunkSizes.size(); i++) {
+		reserved += chunkSizes[i];
+	}
+	return (int)reserved;
+}
+
+/**
+ * Gives back the chunks past the high water mark so that one crowded area
+ * doesn't keep its memory for the rest of the session.
+ */
+void AreaArena::trimChunks() {
+	size_t kept = 0;
+	int numKept = 0;
+	while (numKept < (int)chunks.size() && kept + chunkSizes[numKept] <= AREA_ARENA_HIGH_WATER_MARK) {
+		kept += chunkSizes[numKept];
+		numKept++;
+	}
+	for (int i = numKept; i < (int)chunks.size(); i++) {
+		delete[] chunks[i];
+	}
+	chunks.resize(numKept);
+	chunkSizes.resize(numKept);
+}
+
+/**
+ * Returns whether p points just past a block header inside one of the chunks.
+ */
+bool AreaArena::ownsBlock(void *p) {
+	for (int i = 0; i < (int)chunks.size(); i++) {
+		char *start = chunks[i] + AREA_ARENA_HEADER_SIZE;
+		if ((char*)p >= start && (char*)p < chunks[i] + chunkSizes[i]) {
+			return (((char*)p - chunks[i]) & (AREA_ARENA_ALIGNMENT - 1)) == 0;
+		}
+	}
+	return false;
+}
+
+void AreaArena::addChunk(size_t size) {
+	chunks.push_back(new char[size]);
+	chunkSizes.push_back(size);
+}
+
+void *AreaObject::operator new(size_t size) {
+	return smh->areaArena->allocate(size);
+}
+
+void AreaObject::operator delete(void *p) {
+	smh->areaArena->release(p);
+}
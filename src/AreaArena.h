@@ -0,0 +1,92 @@
+#ifndef _AREAARENA_H_
+#define _AREAARENA_H_
+
+#include <stddef.h>
+#include <vector>
+
+#define AREA_ARENA_CHUNK_SIZE 4194304		//4 MB, enough for about a dozen enemies
+#define AREA_ARENA_HIGH_WATER_MARK 8388608	//Chunks past this are given back on reset
+#define AREA_ARENA_ALIGNMENT 8
+#define AREA_ARENA_FREE_LISTS 64
+#define AREA_ARENA_HEADER_SIZE ((sizeof(AreaArenaBlock) + AREA_ARENA_ALIGNMENT - 1) & ~(AREA_ARENA_ALIGNMENT - 1))
+
+/**
+ * Sits in front of every block the arena hands out. generation is the
+ * arena's generation when the block was handed out, so a block from before
+ * the last reset can be told apart from a live one.
+ */
+struct AreaArenaBlock {
+	size_t size;
+	unsigned int generation;
+	bool live;
+};
+
+/**
+ * Holds blocks of one size that were deleted before the end of the area
+ * so that they can be handed out again.
+ */
+struct AreaArenaFreeList {
+	size_t size;
+	void *head;
+};
+
+/**
+ * Memory for objects that only live as long as the current area. Allocating
+ * is a pointer bump and everything is released at once by reset() when the
+ * area is unloaded, keeping the chunks up to the high water mark around for
+ * the next area.
+ */
+class AreaArena {
+
+public:
+
+	AreaArena();
+	~AreaArena();
+
+	void *allocate(size_t size);
+	void release(void *p);
+	void reset();
+
+	int getNumAllocations();
+	int getBytesUsed();
+	int getBytesReserved();
+
+private:
+
+	void addChunk(size_t size);
+	void trimChunks();
+	bool ownsBlock(void *p);
+
+	std::vector<char*> chunks;
+	std::vector<size_t> chunkSizes;
+	int currentChunk;
+	size_t chunkUsed;
+
+	//Bumped by every reset
+	unsigned int generation;
+	AreaArenaFreeList freeLists[AREA_ARENA_FREE_LISTS];
+	int numFreeLists;
+
+	//Counters for the current area
+	int numAllocations;
+	int numRecycled;
+	int bytesUsed;
+	int peakBytesUsed;
+
+};
+
+/**
+ * Base class for things that are created while an area is loaded and are
+ * deleted when it is unloaded. Their memory comes from smh->areaArena.
+ * Destructors still run as normal when they are deleted.
+ */
+class AreaObject {
+
+public:
+
+	static void *operator new(size_t size);
+	static void operator delete(void *p);
+
+};
+
+#endif
@@ -65,6 +65,12 @@ void AreaChanger::changeArea(int _destinationX, int _destinationY, int _destinat
 	destinationY = _destinationY;
 	destinationArea = _destinationArea;
 
+	//Start parsing the new area while the circle zooms in
+	if (destinationArea != smh->saveManager->currentArea) {
+		smh->areaLoader->prefetch(destinationArea);
+		smh->frameProfiler->beginTransition();
+	}
+
 	state = STATE_IN;
 	loadingEffectScale = 3.0;
 	smh->soundManager->playSound("snd_AreaChangeUp");
@@ -151,6 +157,8 @@ void AreaChanger::update(float dt) {
 		if (loadingEffectScale > 3.0) {
 			loadingEffectScale = 3.0;
 			state = STATE_INACTIVE;	
+			smh->frameProfiler->endTransition(smh->areaLoader->wasLastAreaPrefetched() ? 
+				"area change (prefetched)" : "area change (not prefetched)");
 		}
 	}
 }
\ No newline at end of file
@@ -0,0 +1,213 @@
+#include "SmileyEngine.h"
+#include "environment.h"
+
+#include <fstream>
+#include <sstream>
+
+extern SMH *smh;
+
+#define EXIT_PREFETCH_RANGE 2
+
+AreaLoader::AreaLoader() {
+	workerThread = NULL;
+	workerArea = -1;
+	workerResult = NULL;
+	lastAreaPrefetched = false;
+	enabled = smh->hge->Ini_GetInt("Debug", "prefetchAreas", 1) != 0;
+}
+
+AreaLoader::~AreaLoader() {
+	finishWorker();
+	deleteAreaData(workerResult);
+}
+
+/**
+ * Starts parsing an area on the worker thread. Does nothing if that area is
+ * already being or has already been prefetched. If the worker is busy with a
+ * different area the request is ignored rather than stalling the game thread;
+ * takeAreaData() will just parse it synchronously if it is ever needed.
+ */
+void AreaLoader::prefetch(int area) {
+
+	if (!enabled || area < 0 || area >= NUM_AREAS) return;
+	if (area == workerArea) return;
+
+	if (workerThread) {
+		if (WaitForSingleObject(workerThread, 0) != WAIT_OBJECT_0) return;
+		finishWorker();
+	}
+
+	//Throw away the result of an old speculative prefetch
+	deleteAreaData(workerResult);
+	workerResult = NULL;
+
+	workerArea = area;
+	workerThread = CreateThread(NULL, 0, workerThreadProc, this, 0, NULL);
+	if (workerThread == NULL) {
+		workerArea = -1;
+	}
+
+}
+
+/**
+ * Prefetches the destination of any level exit near the given grid position.
+ */
+void AreaLoader::prefetchExitsNear(int gridX, int gridY) {
+	for (int i = gridX - EXIT_PREFETCH_RANGE; i <= gridX + EXIT_PREFETCH_RANGE; i++) {
+		for (int j = gridY - EXIT_PREFETCH_RANGE; j <= gridY + EXIT_PREFETCH_RANGE; j++) {
+			if (smh->environment->isInBounds(i, j) && smh->environment->collision(i, j) == PLAYER_END) {
+				prefetch(smh->environment->ids(i, j));
+				return;
+			}
+		}
+	}
+}
+
+/**
+ * Returns the parsed data for an area, waiting for the worker if it is still
+ * parsing it or parsing it right now if it was never prefetched. The caller
+ * owns the returned data and must release it with deleteAreaData().
+ */
+AreaData *AreaLoader::takeAreaData(int area) {
+
+	if (area == workerArea) {
+		finishWorker();
+		AreaData *areaData = workerResult;
+		workerResult = NULL;
+		workerArea = -1;
+		lastAreaPrefetched = true;
+		if (areaData) return areaData;
+	}
+
+	lastAreaPrefetched = false;
+	return parseArea(area);
+
+}
+
+/**
+ * Returns whether the last area handed out by takeAreaData() was prefetched.
+ */
+bool AreaLoader::wasLastAreaPrefetched() {
+	return lastAreaPrefetched;
+}
+
+void AreaLoader::deleteAreaData(AreaData *areaData) {
+	if (areaData) {
+		delete[] areaData->tiles;
+		delete areaData;
+	}
+}
+
+DWORD WINAPI AreaLoader::workerThreadProc(LPVOID param) {
+	AreaLoader *loader = (AreaLoader*)param;
+	loader->workerResult = parseArea(loader->workerArea);
+	return 0;
+}
+
+/**
+ * Waits for the worker thread to finish if one is running.
+ */
+void AreaLoader::finishWorker() {
+	if (workerThread) {
+		WaitForSingleObject(workerThread, INFINITE);
+		CloseHandle(workerThread);
+		workerThread = NULL;
+	}
+}
+
+/**
+ * Reads a 3 character field the same way atoi() does.
+ */
+static int readField(const std::string &file, int &pos) {
+
+	int value = 0;
+	int end = pos + 3;
+	bool negative = false;
+
+	while (pos < end && pos < (int)file.size() && file[pos] == ' ') pos++;
+	if (pos < end && pos < (int)file.size() && (file[pos] == '-' || file[pos] == '+')) {
+		negative = file[pos] == '-';
+		pos++;
+	}
+	while (pos < end && pos < (int)file.size() && file[pos] >= '0' && file[pos] <= '9') {
+		value = value * 10 + (file[pos] - '0');
+		pos++;
+	}
+
+	pos = end;
+	return negative ? -value : value;
+}
+
+/**
+ * Parses an area's map file. This only touches the file and the returned
+ * AreaData so it is safe to call from any thread.
+ */
+AreaData *AreaLoader::parseArea(int area) {
+
+	AreaData *areaData = new AreaData();
+	areaData->area = area;
+	areaData->width = areaData->height = 0;
+	areaData->tiles = NULL;
+
+	//Read the whole file at once. Text mode so newlines are translated like before.
+	std::ifstream areaFile(getAreaFileName(area));
+	std::ostringstream contents;
+	contents << areaFile.rdbuf();
+	std::string file = contents.str();
+
+	int pos = 2;	//id range - ignore it
+	areaData->width = readField(file, pos);
+	pos++;			//space
+	areaData->height = readField(file, pos);
+	pos++;			//newline
+
+	int width = areaData->width;
+	int height = areaData->height;
+	areaData->tiles = new int[NUM_AREA_LAYERS * width * height];
+
+	//The layers are stored one after the other, each followed by the
+	//width/height header of the next one
+	for (int layer = 0; layer < NUM_AREA_LAYERS; layer++) {
+		int *tiles = &areaData->tiles[layer * width * height];
+		for (int row = 0; row < height; row++) {
+			for (int col = 0; col < width; col++) {
+				tiles[row * width + col] = readField(file, pos);
+			}
+			pos++;	//newline
+		}
+		pos += 8;	//width, space, height, newline
+	}
+
+	//Collect the spawn list
+	for (int row = 0; row < height; row++) {
+		for (int col = 0; col < width; col++) {
+			int enemy = areaData->get(AreaLayers::Enemy, col, row);
+			if (enemy > 0) {
+				AreaSpawn spawn;
+				spawn.gridX = col;
+				spawn.gridY = row;
+				spawn.enemy = enemy;
+				areaData->spawns.push_back(spawn);
+			}
+		}
+	}
+
+	return areaData;
+}
+
+const char *AreaLoader::getAreaFileName(int area) {
+	switch (area) {
+		case FOUNTAIN_AREA: return "Data/Maps/fountain.smh";
+		case OLDE_TOWNE: return "Data/Maps/oldetowne.smh";
+		case SMOLDER_HOLLOW: return "Data/Maps/smhollow.smh";
+		case FOREST_OF_FUNGORIA: return "Data/Maps/forest.smh";
+		case SESSARIA_SNOWPLAINS: return "Data/Maps/snow.smh";
+		case TUTS_TOMB: return "Data/Maps/tutstomb.smh";
+		case WORLD_OF_DESPAIR: return "Data/Maps/despair.smh";
+		case SERPENTINE_PATH: return "Data/Maps/path.smh";
+		case CASTLE_OF_EVIL: return "Data/Maps/castle.smh";
+		case CONSERVATORY: return "Data/Maps/conserve.smh";
+		case DEBUG_AREA: return "Data/Maps/debug.smh";
+	}
+	return "";
+}
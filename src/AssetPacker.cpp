@@ -0,0 +1,248 @@
+#include "SmileyEngine.h"
+#include <stdio.h>
+#include <stdarg.h>
+
+#define ZIP_END_SIGNATURE 0x06054B50
+#define ZIP_FILE_SIGNATURE 0x02014B50
+#define ZIP_END_SIZE 22
+#define ZIP_MAX_COMMENT 65535
+
+static DWORD readWord(const BYTE *p) {
+	return p[0] | (p[1] << 8);
+}
+
+static DWORD readDword(const BYTE *p) {
+	return p[0] | (p[1] << 8) | (p[2] << 16) | (p[3] << 24);
+}
+
+static void pad(std::vector<BYTE> &data, DWORD alignment) {
+	while (data.size() % alignment) data.push_back(0);
+}
+
+AssetPacker::AssetPacker(HGE *_hge) {
+	hge = _hge;
+}
+
+/**
+ * Adds every file in a zip. HGE does the reading and inflating, so the zip only
+ * has to be opened here to list what's in it.
+ */
+bool AssetPacker::addZip(const char *zipFile) {
+
+	std::vector<std::string> names;
+	if (!readZipDirectory(zipFile, names)) return false;
+
+	if (!hge->Resource_AttachPack(zipFile)) {
+		error("HGE couldn't open %s", zipFile);
+		return false;
+	}
+
+	for (int i = 0; i < (int)names.size(); i++) {
+		DWORD size;
+		void *data = hge->Resource_Load(names[i].c_str(), &size);
+		if (!data) {
+			error("Couldn't read %s from %s", names[i].c_str(), zipFile);
+			continue;
+		}
+		add(names[i], (const BYTE*)data, size);
+		hge->Resource_Free(data);
+	}
+
+	hge->Resource_RemovePack(zipFile);
+	return true;
+}
+
+/**
+ * Reads the names of the files in a zip from its central directory.
+ */
+bool AssetPacker::readZipDirectory(const char *zipFile, std::vector<std::string> &names) {
+
+	std::ifstream zip(zipFile, std::ios::in | std::ios::binary);
+	if (!zip) {
+		error("Couldn't open %s", zipFile);
+		return false;
+	}
+
+	zip.seekg(0, std::ios::end);
+	int zipSize = (int)zip.tellg();
+	int tailSize = zipSize < ZIP_END_SIZE + ZIP_MAX_COMMENT ? zipSize : ZIP_END_SIZE + ZIP_MAX_COMMENT;
+	std::vector<BYTE> tail(tailSize > 0 ? tailSize : 1);
+	zip.seekg(zipSize - tailSize, std::ios::beg);
+	zip.read((char*)&tail[0], tailSize);
+
+	//The end record is after the central directory, followed only by a comment
+	int end = -1;
+	for (int i = tailSize - ZIP_END_SIZE; i >= 0 && end < 0; i--) {
+		if (readDword(&tail[i]) == ZIP_END_SIGNATURE) end = i;
+	}
+	if (end < 0) {
+		error("%s isn't a zip", zipFile);
+		return false;
+	}
+
+	int numFiles = readWord(&tail[end + 10]);
+	DWORD directorySize = readDword(&tail[end + 12]);
+	DWORD directoryOffset = readDword(&tail[end + 16]);
+
+	std::vector<BYTE> directory(directorySize > 0 ? directorySize : 1);
+	zip.seekg(directoryOffset, std::ios::beg);
+	zip.read((char*)&directory[0], directorySize);
+	if (!zip) {
+		error("%s has a broken directory", zipFile);
+		return false;
+	}
+
+	DWORD pos = 0;
+	for (int i = 0; i < numFiles; i++) {
+		if (pos + 46 > directorySize || readDword(&directory[pos]) != ZIP_FILE_SIGNATURE) {
+			error("%s has a broken directory", zipFile);
+			return false;
+		}
+		DWORD nameLength = readWord(&directory[pos + 28]);
+		DWORD extraLength = readWord(&directory[pos + 30]);
+		DWORD commentLength = readWord(&directory[pos + 32]);
+		std::string name((const char*)&directory[pos + 46], nameLength);
+		if (!name.empty() && name[name.size() - 1] != '/') names.push_back(name);
+		pos += 46 + nameLength + extraLength + commentLength;
+	}
+
+	return true;
+}
+
+/**
+ * Adds a file, compressed if that saves at least an eighth of it.
+ */
+void AssetPacker::add(const std::string &name, const BYTE *data, DWORD size) {
+
+	PackedAsset asset;
+	asset.name = AssetPacks::normalizeName(name.c_str());
+	asset.size = size;
+
+	for (int i = 0; i < (int)assets.size(); i++) {
+		if (assets[i].name == asset.name) {
+			error("%s is in the pack twice", name.c_str());
+			return;
+		}
+	}
+
+	Lz4::compress(data, size, asset.data);
+	if (asset.data.size() <= size - size / 8) {
+		asset.compression = PackCompression::Lz4;
+	} else {
+		asset.compression = PackCompression::None;
+		asset.data.assign(data, data + size);
+	}
+
+	assets.push_back(asset);
+}
+
+/**
+ * Writes the pack: header, entries, hash slots and names, then each asset
+ * starting on its own page.
+ */
+bool AssetPacker::save(const char *packFile) {
+
+	int numEntries = (int)assets.size();
+	int numSlots = 1;
+	while (numSlots < numEntries * 2) numSlots *= 2;
+
+	PackHeader header;
+	header.magic = ASSET_PACK_MAGIC;
+	header.version = ASSET_PACK_VERSION;
+	header.numEntries = numEntries;
+	header.numSlots = numSlots;
+	header.entriesOffset = sizeof(PackHeader);
+	header.slotsOffset = header.entriesOffset + numEntries * sizeof(PackEntry);
+	header.namesOffset = header.slotsOffset + numSlots * sizeof(int);
+
+	std::vector<BYTE> names;
+	std::vector<PackEntry> entries(numEntries);
+	std::vector<int> slots(numSlots, -1);
+	for (int i = 0; i < numEntries; i++) {
+		entries[i].name = (DWORD)names.size();
+		names.insert(names.end(), assets[i].name.begin(), assets[i].name.end());
+		names.push_back(0);
+		entries[i].hash = ResourceManifest::hashName(assets[i].name.c_str(), 0);
+		entries[i].size = assets[i].size;
+		entries[i].storedSize = (DWORD)assets[i].data.size();
+		entries[i].compression = assets[i].compression;
+
+		int slot = entries[i].hash & (numSlots - 1);
+		while (slots[slot] >= 0) slot = (slot + 1) & (numSlots - 1);
+		slots[slot] = i;
+	}
+
+	//Work out where each asset goes before anything is written
+	DWORD offset = header.namesOffset + (DWORD)names.size();
+	for (int i = 0; i < numEntries; i++) {
+		offset = (offset + ASSET_PACK_ALIGNMENT - 1) / ASSET_PACK_ALIGNMENT * ASSET_PACK_ALIGNMENT;
+		entries[i].offset = offset;
+		offset += entries[i].storedSize;
+	}
+
+	std::vector<BYTE> pack;
+	pack.insert(pack.end(), (const BYTE*)&header, (const BYTE*)&header + sizeof(PackHeader));
+	if (numEntries > 0) pack.insert(pack.end(), (const BYTE*)&entries[0], (const BYTE*)&entries[0] + numEntries * sizeof(PackEntry));
+	pack.insert(pack.end(), (const BYTE*)&slots[0], (const BYTE*)&slots[0] + numSlots * sizeof(int));
+	pack.insert(pack.end(), names.begin(), names.end());
+	for (int i = 0; i < numEntries; i++) {
+		pad(pack, ASSET_PACK_ALIGNMENT);
+		pack.insert(pack.end(), assets[i].data.begin(), assets[i].data.end());
+	}
+
+	std::ofstream file(packFile, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (file) file.write((const char*)&pack[0], (std::streamsize)pack.size());
+	if (!file) {
+		error("Couldn't write %s", packFile);
+		return false;
+	}
+	return true;
+}
+
+void AssetPacker::error(const char *format, ...) {
+	char text[512];
+	va_list args;
+	va_start(args, format);
+	_vsnprintf(text, sizeof(text) - 1, format, args);
+	va_end(args);
+	text[sizeof(text) - 1] = '\0';
+	errors.push_back(text);
+}
+
+const std::vector<std::string> &AssetPacker::getErrors() {
+	return errors;
+}
+
+int AssetPacker::getNumAssets() {
+	return (int)assets.size();
+}
+
+int AssetPacker::getNumCompressed() {
+	int numCompressed = 0;
+	for (int i = 0; i < (int)assets.size(); i++) {
+		if (assets[i].compression == PackCompression::Lz4) numCompressed++;
+	}
+	return numCompressed;
+}
+
+/**
+ * Returns the total size of the assets before compression.
+ */
+DWORD AssetPacker::getSize() {
+	DWORD size = 0;
+	for (int i = 0; i < (int)assets.size(); i++) {
+		size += assets[i].size;
+	}
+	return size;
+}
+
+/**
+ * Returns the total size of the assets as they are stored in the pack.
+ */
+DWORD AssetPacker::getStoredSize() {
+	DWORD size = 0;
+	for (int i = 0; i < (int)assets.size(); i++) {
+		size += (DWORD)assets[i].data.size();
+	}
+	return size;
+}
@@ -0,0 +1,289 @@
+#include "SmileyEngine.h"
+
+extern SMH *smh;
+
+AssetPacks::AssetPacks() {
+	cachedBytes = 0;
+	predecodePack = -1;
+	predecoded = NULL;
+}
+
+/**
+ * Any predecode workers must have finished by now.
+ */
+AssetPacks::~AssetPacks() {
+	clearCache();
+	clearPredecoded();
+	for (int i = 0; i < (int)packs.size(); i++) {
+		UnmapViewOfFile(packs[i].data);
+		CloseHandle(packs[i].mapping);
+		CloseHandle(packs[i].file);
+	}
+	packs.clear();
+}
+
+/**
+ * Maps a pack. If it hasn't been built, the zip it is built from is attached
+ * to HGE instead so that its files can still be loaded. Returns whether the
+ * pack was mapped.
+ */
+bool AssetPacks::attach(const char *packFile, const char *zipFile) {
+
+	MappedPack pack;
+	pack.fileName = packFile;
+	pack.mapping = NULL;
+	pack.data = NULL;
+
+	pack.file = CreateFile(packFile, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (pack.file != INVALID_HANDLE_VALUE) {
+		DWORD size = GetFileSize(pack.file, NULL);
+		if (size >= sizeof(PackHeader)) pack.mapping = CreateFileMapping(pack.file, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (pack.mapping) pack.data = (const BYTE*)MapViewOfFile(pack.mapping, FILE_MAP_READ, 0, 0, 0);
+		pack.header = (const PackHeader*)pack.data;
+		if (pack.data && pack.header->magic == ASSET_PACK_MAGIC && pack.header->version == ASSET_PACK_VERSION &&
+				pack.header->namesOffset <= size) {
+			pack.entries = (const PackEntry*)(pack.data + pack.header->entriesOffset);
+			pack.slots = (const int*)(pack.data + pack.header->slotsOffset);
+			pack.names = (const char*)(pack.data + pack.header->namesOffset);
+			packs.push_back(pack);
+			smh->logger->write(LogLevels::Info, LogCategories::Resources, "Mapped %s, %d assets", packFile, pack.header->numEntries);
+			return true;
+		}
+		if (pack.data) UnmapViewOfFile(pack.data);
+		if (pack.mapping) CloseHandle(pack.mapping);
+		CloseHandle(pack.file);
+	}
+
+	if (zipFile) {
+		smh->logger->write(LogLevels::Warning, LogCategories::Resources, "Couldn't map %s, attaching %s", packFile, zipFile);
+		smh->hge->Resource_AttachPack(zipFile);
+	}
+	return false;
+}
+
+/**
+ * Names are matched the way HGE matches names in zips: upper case, with
+ * backslashes.
+ */
+std::string AssetPacks::normalizeName(const char *name) {
+	std::string normalized = name;
+	for (int i = 0; i < (int)normalized.size(); i++) {
+		if (normalized[i] == '/') normalized[i] = '\\';
+		else normalized[i] = toupper(normalized[i]);
+	}
+	return normalized;
+}
+
+/**
+ * Looks a normalized name up in a pack's table of contents. Returns NULL if the
+ * pack doesn't have it.
+ */
+const PackEntry *AssetPacks::find(const MappedPack &pack, const std::string &name) {
+	if (pack.header->numEntries == 0) return NULL;
+	DWORD hash = ResourceManifest::hashName(name.c_str(), 0);
+	int mask = pack.header->numSlots - 1;
+	for (int slot = hash & mask; pack.slots[slot] >= 0; slot = (slot + 1) & mask) {
+		const PackEntry *entry = &pack.entries[pack.slots[slot]];
+		if (entry->hash == hash && name == pack.names + entry->name) return entry;
+	}
+	return NULL;
+}
+
+/**
+ * Returns the contents of a file. The pointer is only good until the next call,
+ * which might push a decompressed asset out of the cache, so whatever uses it
+ * has to copy what it needs first. Returns NULL if the file can't be found.
+ */
+const BYTE *AssetPacks::load(const char *name, DWORD *size) {
+
+	std::string normalized = normalizeName(name);
+
+	for (int i = 0; i < (int)packs.size(); i++) {
+
+		const PackEntry *entry = find(packs[i], normalized);
+		if (!entry) continue;
+
+		*size = entry->size;
+		if (entry->compression == PackCompression::None) {
+			return packs[i].data + entry->offset;
+		}
+
+		for (std::list<CachedAsset>::iterator j = cached.begin(); j != cached.end(); j++) {
+			if (j->name == normalized) {
+				cached.splice(cached.begin(), cached, j);
+				return cached.front().data;
+			}
+		}
+
+		BYTE *data = takePredecoded(i, entry);
+		if (data) return cache(normalized, data, entry->size);
+
+		data = cache(normalized, entry->size);
+		int decompressed = Lz4::decompress(packs[i].data + entry->offset, entry->storedSize, data, entry->size);
+		if (decompressed != (int)entry->size) {
+			smh->logger->write(LogLevels::Error, LogCategories::Resources, "%s in %s is corrupt", name, packs[i].fileName.c_str());
+			cachedBytes -= cached.front().size;
+			delete[] cached.front().data;
+			cached.pop_front();
+			return NULL;
+		}
+		return data;
+	}
+
+	//Not in any pack, so read it through HGE and keep a copy like a decompressed asset
+	DWORD hgeSize;
+	void *resource = smh->hge->Resource_Load(name, &hgeSize);
+	if (!resource) return NULL;
+	BYTE *data = cache(normalized, hgeSize);
+	memcpy(data, resource, hgeSize);
+	smh->hge->Resource_Free(resource);
+	*size = hgeSize;
+	return data;
+}
+
+/**
+ * Makes room for an asset at the front of the cache, throwing out the ones that
+ * were used longest ago.
+ */
+BYTE *AssetPacks::cache(const std::string &name, DWORD size) {
+	return cache(name, new BYTE[size > 0 ? size : 1], size);
+}
+
+/**
+ * Puts a buffer that has already been filled in at the front of the cache,
+ * which takes it over.
+ */
+BYTE *AssetPacks::cache(const std::string &name, BYTE *data, DWORD size) {
+
+	CachedAsset asset;
+	asset.name = name;
+	asset.data = data;
+	asset.size = size;
+	cached.push_front(asset);
+	cachedBytes += size;
+
+	while (cachedBytes > ASSET_CACHE_SIZE && cached.size() > 1) {
+		cachedBytes -= cached.back().size;
+		delete[] cached.back().data;
+		cached.pop_back();
+	}
+
+	return asset.data;
+}
+
+void AssetPacks::clearCache() {
+	for (std::list<CachedAsset>::iterator i = cached.begin(); i != cached.end(); i++) {
+		delete[] i->data;
+	}
+	cached.clear();
+	cachedBytes = 0;
+}
+
+/**
+ * Gets ready to decode every compressed asset in a mapped pack with
+ * predecode(). Returns how many there are, or 0 if the pack isn't mapped.
+ */
+int AssetPacks::beginPredecode(const char *packFile) {
+
+	clearPredecoded();
+
+	for (int i = 0; i < (int)packs.size(); i++) {
+		if (packs[i].fileName != packFile) continue;
+
+		int numCompressed = 0;
+		predecodePack = i;
+		predecoded = new PredecodedAsset[packs[i].header->numEntries];
+		for (int j = 0; j < packs[i].header->numEntries; j++) {
+			predecoded[j].data = NULL;
+			if (packs[i].entries[j].compression == PackCompression::Lz4) {
+				predecoded[j].state = PredecodeStates::Waiting;
+				numCompressed++;
+			} else {
+				predecoded[j].state = PredecodeStates::Taken;
+			}
+		}
+		return numCompressed;
+	}
+
+	return 0;
+}
+
+/**
+ * Decodes every numSlices'th asset of the pack from beginPredecode(), starting
+ * at slice. Only reads the mapping and never calls into HGE, so the slices can
+ * be run on worker threads while the main thread is loading. An asset that
+ * load() has already claimed is skipped.
+ */
+void AssetPacks::predecode(int slice, int numSlices) {
+
+	if (!predecoded) return;
+	const MappedPack &pack = packs[predecodePack];
+
+	for (int i = slice; i < pack.header->numEntries; i += numSlices) {
+
+		PredecodedAsset *asset = &predecoded[i];
+		if (InterlockedCompareExchange(&asset->state, PredecodeStates::Decoding, PredecodeStates::Waiting) != PredecodeStates::Waiting) continue;
+
+		const PackEntry *entry = &pack.entries[i];
+		BYTE *data = new BYTE[entry->size > 0 ? entry->size : 1];
+		if (Lz4::decompress(pack.data + entry->offset, entry->storedSize, data, entry->size) != (int)entry->size) {
+			//load() will decode it again and report it
+			delete[] data;
+			data = NULL;
+		}
+		asset->data = data;
+		InterlockedExchange(&asset->state, PredecodeStates::Done);
+	}
+
+}
+
+/**
+ * Returns the predecoded buffer for an entry, waiting if a worker is part way
+ * through it, and hands it over to the caller. Returns NULL if it wasn't
+ * predecoded, in which case no worker will start on it afterwards.
+ */
+BYTE *AssetPacks::takePredecoded(int pack, const PackEntry *entry) {
+
+	if (pack != predecodePack || !predecoded) return NULL;
+
+	PredecodedAsset *asset = &predecoded[entry - packs[pack].entries];
+	if (InterlockedCompareExchange(&asset->state, PredecodeStates::Taken, PredecodeStates::Waiting) == PredecodeStates::Waiting) return NULL;
+	while (asset->state == PredecodeStates::Decoding) {
+		Sleep(0);
+	}
+	if (InterlockedCompareExchange(&asset->state, PredecodeStates::Taken, PredecodeStates::Done) != PredecodeStates::Done) return NULL;
+
+	BYTE *data = asset->data;
+	asset->data = NULL;
+	return data;
+}
+
+void AssetPacks::clearPredecoded() {
+	if (predecoded) {
+		for (int i = 0; i < packs[predecodePack].header->numEntries; i++) {
+			delete[] predecoded[i].data;
+		}
+		delete[] predecoded;
+	}
+	predecoded = NULL;
+	predecodePack = -1;
+}
+
+/**
+ * Counts the assets in every mapped pack.
+ */
+int AssetPacks::getNumAssets() {
+	int numAssets = 0;
+	for (int i = 0; i < (int)packs.size(); i++) {
+		numAssets += packs[i].header->numEntries;
+	}
+	return numAssets;
+}
+
+const char *AssetPacks::getAssetName(int asset) {
+	for (int i = 0; i < (int)packs.size(); i++) {
+		if (asset < packs[i].header->numEntries) return packs[i].names + packs[i].entries[asset].name;
+		asset -= packs[i].header->numEntries;
+	}
+	return NULL;
+}
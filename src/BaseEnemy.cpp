@@ -42,6 +42,11 @@ void BaseEnemy::initEnemy(int _id, int _gridX, int _gridY, int _groupID)
 		dying = false;
 		dealsCollisionDamage = true;
 		flashing = false;
+		askedPath = false;
+		askedClearPathRadius = -1;
+		for (int i = 0; i < NUM_ENEMY_COMMANDS; i++) hasThought[i] = false;
+		effects = NULL;
+		effectIndex = 0;
 
 		//Load enemy info
 		EnemyInfo info = smh->gameData->getEnemyInfo(id);
@@ -70,28 +75,29 @@ void BaseEnemy::initEnemy(int _id, int _gridX, int _gridY, int _groupID)
 		}
 
 		//Set pathing shit
-		for (int i = 0; i < 256; i++) canPass[i] = false;
-		canPass[WALKABLE] = info.land;
-		canPass[SLIME] = info.slime;
-		canPass[WALK_LAVA] = info.lava;
-		canPass[DIZZY_MUSHROOM_1] = canPass[DIZZY_MUSHROOM_2] = info.mushrooms;
-		canPass[SHALLOW_WATER] = info.shallowWater;
-		canPass[SHALLOW_GREEN_WATER] = info.shallowWater;
-		canPass[DEEP_WATER] = info.deepWater;
-		canPass[GREEN_WATER] = info.deepWater;
-		canPass[LEFT_ARROW] = true;
-		canPass[RIGHT_ARROW] = true;
-		canPass[UP_ARROW] = true;
-		canPass[DOWN_ARROW] = true;
-		canPass[PLAYER_START] = true;
-		canPass[PLAYER_END] = true;
-		canPass[WHITE_CYLINDER_DOWN] = true;
-		canPass[YELLOW_CYLINDER_DOWN] = true;
-		canPass[GREEN_CYLINDER_DOWN] = true;
-		canPass[BLUE_CYLINDER_DOWN] = true;
-		canPass[BROWN_CYLINDER_DOWN] = true;
-		canPass[SILVER_CYLINDER_DOWN] = true;
-		canPass[HOVER_PAD] = true;
+		canPass.setAll(false);
+		canPass.set(WALKABLE, info.land);
+		canPass.set(SLIME, info.slime);
+		canPass.set(WALK_LAVA, info.lava);
+		canPass.set(DIZZY_MUSHROOM_1, info.mushrooms);
+		canPass.set(DIZZY_MUSHROOM_2, info.mushrooms);
+		canPass.set(SHALLOW_WATER, info.shallowWater);
+		canPass.set(SHALLOW_GREEN_WATER, info.shallowWater);
+		canPass.set(DEEP_WATER, info.deepWater);
+		canPass.set(GREEN_WATER, info.deepWater);
+		canPass.set(LEFT_ARROW, true);
+		canPass.set(RIGHT_ARROW, true);
+		canPass.set(UP_ARROW, true);
+		canPass.set(DOWN_ARROW, true);
+		canPass.set(PLAYER_START, true);
+		canPass.set(PLAYER_END, true);
+		canPass.set(WHITE_CYLINDER_DOWN, true);
+		canPass.set(YELLOW_CYLINDER_DOWN, true);
+		canPass.set(GREEN_CYLINDER_DOWN, true);
+		canPass.set(BLUE_CYLINDER_DOWN, true);
+		canPass.set(BROWN_CYLINDER_DOWN, true);
+		canPass.set(SILVER_CYLINDER_DOWN, true);
+		canPass.set(HOVER_PAD, true);
 
 		//Initialize stun star angles
 		for (int i = 0; i < NUM_STUN_STARS; i++) 
@@ -103,25 +109,27 @@ void BaseEnemy::initEnemy(int _id, int _gridX, int _gridY, int _groupID)
 		// for batlet caves because the graphics need to be put next to each other
 		int borderSize = (info.enemyType == ENEMY_BATLET_DIST ? 0 : 1);
 		int size = (info.enemyType == ENEMY_BATLET_DIST ? 64 : 62);
-		graphic[LEFT] = new hgeAnimation(smh->resources->GetTexture("enemies"), 
+		float atlasX = 0.0, atlasY = 0.0;
+		HTEXTURE texture = smh->resources->getTextureRegion("enemies", &atlasX, &atlasY);
+		graphic[LEFT] = new hgeAnimation(texture, 
 			info.numFrames, 3, 
-			info.gCol*64+borderSize, 
-			info.gRow*64+borderSize, size, size);
+			atlasX + info.gCol*64+borderSize, 
+			atlasY + info.gRow*64+borderSize, size, size);
 		graphic[LEFT]->Play();
-		graphic[RIGHT] = new hgeAnimation(smh->resources->GetTexture("enemies"), 
+		graphic[RIGHT] = new hgeAnimation(texture, 
 			info.numFrames, 3, 
-			info.gCol*64 + 64 * (info.hasOneGraphic ? 0 : info.numFrames)+borderSize, 
-			info.gRow*64+borderSize, size, size);
+			atlasX + info.gCol*64 + 64 * (info.hasOneGraphic ? 0 : info.numFrames)+borderSize, 
+			atlasY + info.gRow*64+borderSize, size, size);
 		graphic[RIGHT]->Play();
-		graphic[UP] = new hgeAnimation(smh->resources->GetTexture("enemies"), 
+		graphic[UP] = new hgeAnimation(texture, 
 			info.numFrames, 3, 
-			info.gCol*64 + 2 * 64 * (info.hasOneGraphic ? 0 : info.numFrames)+borderSize, 
-			info.gRow*64+borderSize, size, size);
+			atlasX + info.gCol*64 + 2 * 64 * (info.hasOneGraphic ? 0 : info.numFrames)+borderSize, 
+			atlasY + info.gRow*64+borderSize, size, size);
 		graphic[UP]->Play();
-		graphic[DOWN] = new hgeAnimation(smh->resources->GetTexture("enemies"), 
+		graphic[DOWN] = new hgeAnimation(texture, 
 			info.numFrames, 3, 
-			info.gCol*64 + 3 * 64 * (info.hasOneGraphic ? 0 : info.numFrames)+borderSize,
-			info.gRow*64+borderSize, size, size);
+			atlasX + info.gCol*64 + 3 * 64 * (info.hasOneGraphic ? 0 : info.numFrames)+borderSize,
+			atlasY + info.gRow*64+borderSize, size, size);
 		graphic[DOWN]->Play();
 
 		//Set graphic hot spots
@@ -133,11 +141,11 @@ void BaseEnemy::initEnemy(int _id, int _gridX, int _gridY, int _groupID)
 	} 
 	catch(System::Exception *ex) 
 	{
-		smh->hge->System_Log("-- Exception caught while initializing an enemy!");
-		smh->hge->System_Log("EnemyID: %d, Location: (%d,%d), GroupID: %d", _id, _gridX, _gridY, _groupID);
-		smh->hge->System_Log("Stack trace:");
-		smh->hge->System_Log("%s", ex->ToString());
-		smh->hge->System_Log("-- End Exception");
+		smh->logger->write(LogLevels::Error, LogCategories::Enemies, "-- Exception caught while initializing an enemy!");
+		smh->logger->write(LogLevels::Error, LogCategories::Enemies, "EnemyID: %d, Location: (%d,%d), GroupID: %d", _id, _gridX, _gridY, _groupID);
+		smh->logger->write(LogLevels::Error, LogCategories::Enemies, "Stack trace:");
+		smh->logger->write(LogLevels::Error, LogCategories::Enemies, "%s", ex->ToString());
+		smh->logger->write(LogLevels::Error, LogCategories::Enemies, "-- End Exception");
 		throw ex;
 	}
 }
@@ -206,7 +214,7 @@ void BaseEnemy::dealDamageAndKnockback(float damage, float knockbackDist,
  */
 bool BaseEnemy::inChaseRange(int range) {
 	return (chases && mapPath[gridX][gridY] <= range && mapPath[gridX][gridY] > 0 && !smh->player->isInvisible() &&
-		smh->environment->collision[smh->player->gridX][smh->player->gridY] != ENEMY_NO_WALK);
+		smh->environment->collision(smh->player->gridX, smh->player->gridY) != ENEMY_NO_WALK);
 }
 
 /**
@@ -214,6 +222,9 @@ bool BaseEnemy::inChaseRange(int range) {
  * at its current position.
  */
 bool BaseEnemy::canShootPlayer() {
+	if (usesThought(EnemyCommands::Shot, x, y, smh->player->x, smh->player->y, 0)) {
+		return thoughts[EnemyCommands::Shot].result;
+	}
 	return (distanceFromPlayer() <= weaponRange && smh->environment->validPath(x, y, smh->player->x, smh->player->y, smh->projectileManager->getProjectileRadius(rangedType), canPass));
 }
 
@@ -225,6 +236,18 @@ bool BaseEnemy::canShootPlayer(float fromX, float fromY, float angle) {
 	return (Util::distance(fromX,fromY,smh->player->x,smh->player->y) <= weaponRange && smh->environment->validPath(angle, fromX, fromY, smh->player->x, smh->player->y, smh->projectileManager->getProjectileRadius(rangedType), canPass, true));
 }
 
+/**
+ * Returns whether a <lineRadius> wide line from the enemy to the player is
+ * clear.
+ */
+bool BaseEnemy::hasClearPathToPlayer(int lineRadius) {
+	askedClearPathRadius = lineRadius;
+	if (usesThought(EnemyCommands::ClearPath, x, y, smh->player->x, smh->player->y, lineRadius)) {
+		return thoughts[EnemyCommands::ClearPath].result;
+	}
+	return smh->environment->validPath(x, y, smh->player->x, smh->player->y, lineRadius, canPass);
+}
+
 /**
  * Returns the length of the straight line connecting the enemy to the
  * player's position.
@@ -273,145 +296,11 @@ void BaseEnemy::move(float dt) {
  */
 void BaseEnemy::doAStar() 
 {
+	askedPath = true;
+	if (usesThought(EnemyCommands::Path, gridX, gridY, smh->player->gridX, smh->player->gridY, 10)) return;
 	doAStar(smh->player->gridX, smh->player->gridY, 10);
 }
 
-void BaseEnemy::doAStar(int destinationX, int destinationY, int updateRadius) 
-{
-	boolean found;
-	int lowValue;
-
-	//Only update map path if the enemies are within 10 tiles of destination
-	if (abs(gridX - destinationX) + abs(gridY - destinationY) > updateRadius) {
-		return;
-	}
-
-	//For performance reasons only update mapPath in a *updateRadius* (default = 10) tile radius
-	int startX = (gridX <= updateRadius) ? 0 : gridX - updateRadius;
-	int startY = (gridY <= updateRadius) ? 0 : gridY - updateRadius;
-	int endX = (gridX >= smh->environment->areaWidth - updateRadius) ? smh->environment->areaWidth : gridX + updateRadius;
-	int endY = (gridY >= smh->environment->areaHeight - updateRadius) ? smh->environment->areaHeight : gridY + updateRadius;
-
-	//Initialize mapPath array
-	for (int i = startX; i < endX; i++) 
-	{
-		for (int j = startY; j < endY; j++) 
-		{
-			//If the player is at (i,j), the distance from (i,j) is 0
-			if (i == destinationX && j == destinationY) 
-			{
-				mapPath[i][j] = 0;
-			//If (i,j) is inaccessible, set distance to 999
-			} 
-			else if (!canPass[smh->environment->collision[i][j]] || smh->environment->hasSillyPad(i, j)) 
-			{
-				mapPath[i][j] = 999;
-			//Otherwise put a -1
-			} 
-			else 
-			{
-				mapPath[i][j] = -1;
-			}
-		}
-	}
-
-	//Loop until no new positions are calculated
-	do 
-	{
-		found = false;		//no position has been calculated yet
-		
-		//First check for tiles which can be mapped. Set these to markMap == true.
-		for (int i = startX; i < endX; i++) 
-		{
-			for (int j = startY; j < endY; j++) 
-			{
-				markMap[i][j] = false;
-				//If (i,j) hasn't been calculated yet
-				if (mapPath[i][j] == -1) 
-				{
-					//Scan neighbors
-					for (int ni = i-1; ni <= i+1; ni++) 
-					{
-						for (int nj = j-1; nj <= j+1; nj++) 
-						{
-							//Verify neighbor is on map and (ni,nj) != (i,j)
-							if (ni >= 0 && nj >= 0 && ni < smh->environment->areaWidth && nj <= smh->environment->areaHeight && !(ni == i && nj == j)) 
-							{
-								//Verify square hasn't been calculated yet and is accessible to this enemy
-								if (mapPath[ni][nj] >= 0 && mapPath[ni][nj] != 999) 
-								{
-									markMap[i][j] = true;	//this cell can be calculated
-									found = true;			//a calculatable cell has been found
-								}
-							}
-						}
-					}
-				}
-			}
-		}
-
-		//Next scan all marked squares and calculate the distance.
-		for (int i = startX; i < endX; i++) 
-		{
-			for (int j = startY; j < endY; j++) 
-			{
-				if (markMap[i][j]) 
-				{
-					lowValue = 999;
-					//Loop through neighbors
-					for (int ni = i-1; ni <= i+1; ni++) 
-					{
-						for (int nj = j-1; nj <= j+1; nj++) 
-						{
-							//Verify the neighbor is on the map
-							if (ni >= 0 && nj >= 0 && ni < smh->environment->areaWidth && nj < smh->environment->areaHeight && !(ni == i && nj == j)) 
-							{
-								//Verify this square hasn't been calculated already
-								if (mapPath[ni][nj] >= 0) 
-								{	
-									//If diagonal, make sure you can actually get there
-									bool diagonalOK=verifyDiagonal(i,j,ni,nj);
-									
-									//Assign the value to lowvalue if it is lower
-									if (mapPath[ni][nj] < lowValue && diagonalOK) 
-									{
-										lowValue = mapPath[ni][nj];
-									}
-								}
-							}
-						}
-					}
-
-					//Assign the lowest neighbor value +1 to the square
-					mapPath[i][j] = lowValue+1;
-				}
-			}
-		}
-	} while (found);
-}
-
-/**
- * "Verify the diagonal"
- * This functional is used by the A* algorithm to make sure that the algorithm doesn't try to make enemies
-   run "between" 2 diagonal objects. If they did try to run through, they'd be stuck!
- */
-bool BaseEnemy::verifyDiagonal(int curX, int curY, int neighborX, int neighborY) 
-{
-	int diffX = neighborX - curX;
-	int diffY = neighborY - curY;
-
-	if (diffX == 0 || diffY == 0) return true; //Isn't diagonal, so don't worry about it.
-
-	if (diffX != 0)  //is moving left or right, so check immediately left or right and return false if it's blocked
-		if (!canPass[smh->environment->collision[neighborX][curY]] || mapPath[neighborX][curY] == 999) return false;
-
-	if (diffY != 0) //is moving up or down, so check immediately up or down and return false if it's blocked
-		if (!canPass[smh->environment->collision[curX][neighborY]] || mapPath[curX][neighborY] == 999) return false;
-
-	//Passed both conditions above, so return true
-	return true;
-}
-
 /**
  * Sets the enemy to face the player no matter how far away he is.
  */
@@ -567,6 +456,8 @@ void BaseEnemy::baseUpdate(float dt)
 	}
 
 	//Update the enemy's current state
+	askedPath = false;
+	askedClearPathRadius = -1;
 	if (currentState) 
 	{
 		currentState->update(dt);
@@ -581,7 +472,13 @@ void BaseEnemy::baseUpdate(float dt)
 	//Fire breath collision
 	if (!immuneToFire) 
 	{
-		if (smh->player->fireBreathParticle->testCollision(collisionBox)) 
+		bool inFireBreath;
+		if (usesThought(EnemyCommands::FireBreath, collisionBox->x1, collisionBox->y1, collisionBox->x2, collisionBox->y2, 0)) 
+			inFireBreath = thoughts[EnemyCommands::FireBreath].result;
+		else 
+			inFireBreath = smh->player->fireBreathParticle->testCollision(collisionBox);
+
+		if (inFireBreath) 
 		{
 			frozen = false;
 
@@ -596,6 +493,166 @@ void BaseEnemy::baseUpdate(float dt)
 			}
 		}
 	}
+
+	for (int i = 0; i < NUM_ENEMY_COMMANDS; i++) hasThought[i] = false;
+}
+
+/**
+ * Works out ahead of time what the enemy is going to ask during its update this
+ * frame, recording the answers as commands. Called on a worker thread, so it
+ * must only change the enemy itself.
+ */
+void BaseEnemy::think(const EnemySnapshot &world, int index, std::vector<EnemyCommand> &commands)
+{
+	for (int i = 0; i < NUM_ENEMY_COMMANDS; i++) hasThought[i] = false;
+	if (isSpawning) return;
+
+	//Same as baseUpdate is about to do
+	gridX = x / 64;
+	gridY = y / 64;
+
+	if (askedPath) 
+	{
+		doAStar(world.playerGridX, world.playerGridY, 10);
+		recordCommand(commands, index, EnemyCommands::Path, true, gridX, gridY, world.playerGridX, world.playerGridY, 10);
+	}
+
+	if (hasRangedAttack) 
+	{
+		bool canShoot = Util::distance(world.playerX, world.playerY, x, y) <= weaponRange && 
+			smh->environment->validPath(x, y, world.playerX, world.playerY, smh->projectileManager->getProjectileRadius(rangedType), canPass);
+		recordCommand(commands, index, EnemyCommands::Shot, canShoot, x, y, world.playerX, world.playerY, 0);
+	}
+
+	if (askedClearPathRadius >= 0) 
+	{
+		bool clear = smh->environment->validPath(x, y, world.playerX, world.playerY, askedClearPathRadius, canPass);
+		recordCommand(commands, index, EnemyCommands::ClearPath, clear, x, y, world.playerX, world.playerY, askedClearPathRadius);
+	}
+
+	if (!immuneToFire) 
+	{
+		hgeRect box;
+		box.SetRadius(x, y, radius);
+		bool inFireBreath = smh->player->fireBreathParticle->testCollision(&box);
+		recordCommand(commands, index, EnemyCommands::FireBreath, inFireBreath, box.x1, box.y1, box.x2, box.y2, 0);
+	}
+}
+
+/**
+ * Hands the enemy one of the answers worked out in the think phase.
+ */
+void BaseEnemy::applyCommand(const EnemyCommand &command)
+{
+	thoughts[command.type] = command;
+	hasThought[command.type] = true;
+}
+
+void BaseEnemy::recordCommand(std::vector<EnemyCommand> &commands, int index, int type, bool result, float a, float b, float c, float d, float e)
+{
+	EnemyCommand command;
+	command.enemy = index;
+	command.type = type;
+	command.result = result;
+	command.key[0] = a;
+	command.key[1] = b;
+	command.key[2] = c;
+	command.key[3] = d;
+	command.key[4] = e;
+	commands.push_back(command);
+}
+
+/**
+ * Sets where the enemy records its effects, and its position in the enemy list
+ * to record them under. With no buffer the effects are done straight away.
+ */
+void BaseEnemy::setEffectBuffer(std::vector<EnemyEffect> *buffer, int index)
+{
+	effects = buffer;
+	effectIndex = index;
+}
+
+/**
+ * Fires a hostile projectile that makes Smiley flash when it hits him.
+ */
+void BaseEnemy::fireProjectile(float fromX, float fromY, float speed, float angle, float projectileDamage, bool homing, int projectileId)
+{
+	EnemyEffect effect;
+	effect.type = EnemyEffects::Projectile;
+	effect.x = fromX;
+	effect.y = fromY;
+	effect.speed = speed;
+	effect.angle = angle;
+	effect.damage = projectileDamage;
+	effect.homing = homing;
+	effect.id = projectileId;
+	recordEffect(effect);
+}
+
+void BaseEnemy::playSound(const char *sound)
+{
+	EnemyEffect effect;
+	effect.type = EnemyEffects::Sound;
+	effect.sound = sound;
+	recordEffect(effect);
+}
+
+/**
+ * Damages Smiley without knocking him back.
+ */
+void BaseEnemy::damagePlayer(float amount)
+{
+	damagePlayer(amount, 0.0, 0.0, 0.0);
+}
+
+/**
+ * Damages Smiley and knocks him knockbackDist away from (fromX, fromY).
+ */
+void BaseEnemy::damagePlayer(float amount, float knockbackDist, float fromX, float fromY)
+{
+	EnemyEffect effect;
+	effect.type = EnemyEffects::Damage;
+	effect.damage = amount;
+	effect.knockbackDist = knockbackDist;
+	effect.x = fromX;
+	effect.y = fromY;
+	recordEffect(effect);
+}
+
+/**
+ * Drops loot where the enemy is.
+ */
+void BaseEnemy::dropLoot(int lootType)
+{
+	EnemyEffect effect;
+	effect.type = EnemyEffects::Loot;
+	effect.id = lootType;
+	effect.x = x;
+	effect.y = y;
+	recordEffect(effect);
+}
+
+void BaseEnemy::recordEffect(EnemyEffect &effect)
+{
+	effect.enemy = effectIndex;
+	if (effects) 
+	{
+		effects->push_back(effect);
+	} 
+	else 
+	{
+		smh->enemyManager->applyEffect(effect);
+	}
+}
+
+/**
+ * Returns whether there's an answer from the think phase to exactly this
+ * question.
+ */
+bool BaseEnemy::usesThought(int type, float a, float b, float c, float d, float e)
+{
+	const float *key = thoughts[type].key;
+	return hasThought[type] && key[0] == a && key[1] == b && key[2] == c && key[3] == d && key[4] == e;
 }
 
 /**
@@ -624,7 +681,7 @@ void BaseEnemy::baseDraw(float dt)
 {
 	if (isSpawning) 
 	{
-		graphic[0]->RenderEx(smh->getScreenX(x),smh->getScreenY(y)-spawnY,0.0,spawnSize,spawnSize);
+		smh->spriteBatch->renderEx(graphic[0], smh->getScreenX(x), smh->getScreenY(y)-spawnY, 0.0, spawnSize, spawnSize);
 		//graphic[0]->Render(100,100);
 		return;
 	}
@@ -654,12 +711,12 @@ void BaseEnemy::baseDraw(float dt)
 	if (health < maxHealth)
 	{
 		smh->resources->GetSprite("blackSquare")->SetColor(ARGB(100,255,255,255));
-		smh->resources->GetSprite("blackSquare")->RenderStretch(
+		smh->spriteBatch->renderStretch(smh->resources->GetSprite("blackSquare"),
 				screenX - 30.0f, 
 				screenY - 38.0f - projectileYOffset, 
 				screenX + 30.0f, 
 				screenY - 33.0f - projectileYOffset);
-		smh->resources->GetSprite("bossHealthBar")->RenderStretch(
+		smh->spriteBatch->renderStretch(smh->resources->GetSprite("bossHealthBar"),
 				screenX - 30.0f, 
 				screenY - 38.0f - projectileYOffset, 
 				screenX - 30.0f + 60.0f * (health / maxHealth), 
@@ -683,7 +740,7 @@ void BaseEnemy::baseDraw(float dt)
  * functionality then it should overwrite this method.
  */
 void BaseEnemy::drawFrozen(float dt) {
-	smh->resources->GetSprite("iceBlock")->Render(screenX, screenY);
+	smh->spriteBatch->render(smh->resources->GetSprite("iceBlock"), screenX, screenY);
 }
 
 /**
@@ -708,7 +765,7 @@ void BaseEnemy::drawStunned(float dt, float percentage) {
 		stunStarAngles[n] += 2.0* PI * dt;
 
 	for (n = 0; n < nToEnd; n++) {		
-		smh->resources->GetSprite("stunStar")->Render(
+		smh->spriteBatch->render(smh->resources->GetSprite("stunStar"),
 		smh->getScreenX(x + cos(stunStarAngles[n])*25), 
 		smh->getScreenY(y + sin(stunStarAngles[n])*7) - 30.0);
 	}
@@ -800,17 +857,12 @@ bool BaseEnemy::doTongueCollision(Tongue *tongue, float damage) {
 
 /**
  * Does default player collision using the collisionBox object. Enemies can
- * override this for something more specific.
+ * override this for something more specific. The damage is recorded as an
+ * effect and dealt once every enemy has been updated.
  */ 
 void BaseEnemy::doPlayerCollision() {
 	if (dealsCollisionDamage && smh->player->collisionCircle->testBox(collisionBox)) {
-		smh->player->dealDamageAndKnockback(damage, true, 115, x, y);
-		std::string debugText;
-		debugText = "baseenemy.cpp Smiley hit by enemy id " + Util::intToString(id) +
-			//" at grid (" + Util::intToString(gridX) + "," + Util::intToString(gridY) +
-			//") pos (" + Util::intToString((int)x) + "," + Util::intToString((int)y) + ")";
-			" type " + Util::intToString((int)enemyType);
-		//smh->setDebugText(debugText);
+		damagePlayer(damage, 115, x, y);
 	}
 }
 
@@ -1,13 +1,10 @@
-#include "SmileyEngine.h"
-#include "Math.h"
-
-extern SMH *smh;
+#include "SmileyPrimitives.h"
 
 BitStream::BitStream() {
 	isOpen = false;
 }
 
-BitStream::~BitStream() { 
+BitStream::~BitStream() BIT_STREAM_DESTRUCTOR_THROWS { 
 	if (isOpen) throw new System::Exception("Error: Attempting to delete the BitStream while a stream is still open.");
 }
 
@@ -163,78 +160,3 @@ int BitStream::getNumBitsWritten() {
 int BitStream::getNumBitsRead() {
 	return numRead;
 }
-
-/**
- * Static test method.
- */
-void BitStream::test() {
-
-	BitStream *b = new BitStream();
-
-	//Bits test
-	smh->hge->System_Log("---Testing bits---");
-	b->open("test.txt", FILE_WRITE);
-	b->writeBit(true);
-	b->writeBit(false);
-	b->writeBit(true);
-	b->writeBit(true);
-	b->writeBit(false);
-	b->writeBit(false);
-	b->writeBit(true);
-	b->writeBit(false);
-	//----
-	b->writeBit(true);
-	b->writeBit(false);
-	b->writeBit(true);
-	b->writeBit(true);
-	b->writeBit(false);
-	b->writeBit(true);
-	b->close();
-	b->open("test.txt", FILE_READ);
-	smh->hge->System_Log("%d", b->readBit());
-	smh->hge->System_Log("%d", b->readBit());
-	smh->hge->System_Log("%d", b->readBit());
-	smh->hge->System_Log("%d", b->readBit());
-	smh->hge->System_Log("%d", b->readBit());
-	smh->hge->System_Log("%d", b->readBit());
-	smh->hge->System_Log("%d", b->readBit());
-	smh->hge->System_Log("%d", b->readBit());
-	smh->hge->System_Log("----");
-	smh->hge->System_Log("%d", b->readBit());
-	smh->hge->System_Log("%d", b->readBit());
-	smh->hge->System_Log("%d", b->readBit());
-	smh->hge->System_Log("%d", b->readBit());
-	smh->hge->System_Log("%d", b->readBit());
-	smh->hge->System_Log("%d", b->readBit());
-	b->close();
-
-	//Bits and bytes test
-	smh->hge->System_Log("---Testing bits and bytes---");
-	b->open("test.txt", FILE_WRITE);
-	b->writeBit(true);
-	b->writeBit(false);
-	b->writeBit(true);
-	b->writeByte(43);
-	b->writeBit(true);
-	b->writeByte(82);
-	b->close();
-	b->open("test.txt", FILE_READ);
-	smh->hge->System_Log("true: %d", b->readBit());
-	smh->hge->System_Log("false: %d", b->readBit());
-	smh->hge->System_Log("true: %d", b->readBit());
-	smh->hge->System_Log("43: %d", b->readByte());
-	smh->hge->System_Log("true: %d", b->readBit());
-	smh->hge->System_Log("82: %d", b->readByte());
-	b->close();
-
-	//24 bit test
-	smh->hge->System_Log("---Testing 24 bits---");
-	b->open("test.txt", FILE_WRITE);
-	b->writeBits(4321, 24);
-	b->close();
-	b->open("test.txt", FILE_READ);
-	smh->hge->System_Log("4321: %d", b->readBits(24));
-	b->close();
-
-	delete b;
-}
@@ -0,0 +1,384 @@
+#include "SmileyEngine.h"
+#include "boss.h"
+#include "player.h"
+#include "environment.h"
+#include "EnemyFramework.h"
+#include "ProjectileManager.h"
+#include "PatternEmitter.h"
+#include "WindowFramework.h"
+#include <iterator>
+#include <new>
+
+extern SMH *smh;
+
+#define BOSS_BENCHMARK_SEED 1234
+#define BOT_START_DISTANCE 6			//Squares below the boss that the bot starts
+#define BOT_WAYPOINT_RADIUS 16.0
+#define BOT_WAYPOINT_TIME 2.0			//Give up on a waypoint it can't reach after this long
+#define BOT_DEADZONE 8.0
+#define BOT_TONGUE_FRAMES 30
+#define BOT_ABILITY_FRAMES 120
+#define BOT_ABILITY_HOLD_FRAMES 30
+#define NUM_BOT_WAYPOINTS 6
+
+static const char *bossNames[NUM_BOSSES] = { "Phyrebawz", "Cornwallis", "Portly Penguin", "Garmborn", "Mushboom",
+	"Calypso", "Phyrebawz 2", "Bartli", "Lovecraft", "King Tut", "Barvinoid", "Fenwar" };
+
+//Squares from where the boss spawns. The first one is where the bot walks up to.
+static const int botWaypoints[NUM_BOT_WAYPOINTS][2] = { { 0, 3 }, { -3, 2 }, { -3, -2 }, { 0, -3 }, { 3, -2 }, { 3, 2 } };
+
+static volatile LONG numAllocations = 0;
+
+/**
+ * Replace the global new and delete so that allocations can be counted in any
+ * build, not just with the Debug CRT's hook. They are the CRT's malloc and
+ * free plus one interlocked increment. Area objects come out of the AreaArena
+ * and aren't counted unless it has to grow.
+ */
+void *operator new(size_t size) {
+	InterlockedIncrement(&numAllocations);
+	void *p = malloc(size > 0 ? size : 1);
+	if (!p) throw std::bad_alloc();
+	return p;
+}
+
+void *operator new[](size_t size) {
+	return operator new(size);
+}
+
+void operator delete(void *p) {
+	free(p);
+}
+
+void operator delete[](void *p) {
+	free(p);
+}
+
+BossBenchmark::BossBenchmark() {
+	requested = false;
+	running = false;
+	numRegressions = 0;
+	currentFight = -1;
+	frame = 0;
+}
+
+/**
+ * Asks for the benchmark to be run instead of opening the title screen.
+ * baselineFile is an earlier BossBenchmark.json to compare with, or NULL.
+ */
+void BossBenchmark::request(const char *_baselineFile) {
+	requested = true;
+	baselineFile = _baselineFile ? _baselineFile : "";
+}
+
+bool BossBenchmark::isRequested() {
+	return requested;
+}
+
+bool BossBenchmark::isRunning() {
+	return running;
+}
+
+void BossBenchmark::start() {
+
+	framesPerFight = smh->hge->Ini_GetInt("Debug", "bossBenchmarkFrames", DEFAULT_BOSS_BENCHMARK_FRAMES);
+	if (framesPerFight < 1) framesPerFight = 1;
+	threshold = smh->hge->Ini_GetInt("Debug", "bossBenchmarkThreshold", DEFAULT_BOSS_BENCHMARK_THRESHOLD);
+
+	QueryPerformanceFrequency(&frequency);
+	findArenas();
+
+	//Frames are a fixed length so there's no point waiting for vsync
+	smh->hge->System_SetState(HGE_FPS, HGEFPS_UNLIMITED);
+	smh->input->setScripted(true);
+
+	running = true;
+	currentFight = -1;
+	startNextFight();
+
+}
+
+/**
+ * Called at the start of every frame while the benchmark is running, before
+ * input is read. Sets up the bot's input for the frame and moves on to the
+ * next fight when this one is over. Returns true when every fight is done and
+ * the game should exit.
+ */
+bool BossBenchmark::beginFrame() {
+
+	if (currentFight < NUM_BOSSES && frame >= framesPerFight) {
+		finishFight();
+		startNextFight();
+	}
+
+	if (currentFight >= NUM_BOSSES) {
+		running = false;
+		smh->input->setScripted(false);
+		writeResults();
+		compareWithBaseline();
+		return true;
+	}
+
+	//Dialogue would pause the fight
+	if (smh->windowManager->isOpenWindow()) smh->windowManager->closeWindow();
+
+	//The bot can't die, so every fight lasts the same number of frames
+	smh->player->setHealth(smh->player->getMaxHealth());
+	smh->player->setMana(smh->player->getMaxMana());
+
+	driveBot();
+
+	frame++;
+	QueryPerformanceCounter(&frameStart);
+	return false;
+}
+
+/**
+ * Called once the frame has been drawn while the benchmark is running.
+ */
+void BossBenchmark::endFrame() {
+
+	//The frame the benchmark was started in wasn't begun by beginFrame()
+	if (frame == 0) return;
+
+	LARGE_INTEGER frameEnd;
+	QueryPerformanceCounter(&frameEnd);
+	double ms = (double)(frameEnd.QuadPart - frameStart.QuadPart) * 1000.0 / (double)frequency.QuadPart;
+
+	BossBenchmarkResult *result = &results[currentFight];
+	result->frames++;
+	result->totalMs += ms;
+	if (ms > result->maxMs) result->maxMs = ms;
+
+	int numProjectiles = (int)smh->projectileManager->theProjectiles.size();
+	int numEnemies = (int)smh->enemyManager->enemyList.size();
+	if (numProjectiles > result->peakProjectiles) result->peakProjectiles = numProjectiles;
+	if (smh->patternEmitter->getNumBullets() > result->peakPatternBullets) result->peakPatternBullets = smh->patternEmitter->getNumBullets();
+	if (smh->particlePool->getNumLiveSystems() > result->peakParticleSystems) result->peakParticleSystems = smh->particlePool->getNumLiveSystems();
+	if (smh->particlePool->getNumLiveParticles() > result->peakParticles) result->peakParticles = smh->particlePool->getNumLiveParticles();
+	if (numEnemies > result->peakEnemies) result->peakEnemies = numEnemies;
+
+}
+
+/**
+ * Returns how many numbers were worse than the baseline by more than the
+ * threshold.
+ */
+int BossBenchmark::getNumRegressions() {
+	return numRegressions;
+}
+
+//~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~
+// Helper Methods
+//~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~
+
+/**
+ * Looks through every area file for where each boss spawns.
+ */
+void BossBenchmark::findArenas() {
+
+	for (int i = 0; i < NUM_BOSSES; i++) {
+		results[i].boss = FIRE_BOSS + i;
+		results[i].found = false;
+	}
+
+	for (int area = 0; area < NUM_AREAS; area++) {
+		AreaData *areaData = AreaLoader::parseArea(area);
+		for (std::list<AreaSpawn>::iterator i = areaData->spawns.begin(); i != areaData->spawns.end(); i++) {
+			int boss = i->enemy - FIRE_BOSS;
+			if (boss >= 0 && boss < NUM_BOSSES && !results[boss].found) {
+				results[boss].found = true;
+				results[boss].area = area;
+				results[boss].gridX = i->gridX;
+				results[boss].gridY = i->gridY;
+			}
+		}
+		smh->areaLoader->deleteAreaData(areaData);
+	}
+
+	for (int i = 0; i < NUM_BOSSES; i++) {
+		if (!results[i].found) {
+			smh->logger->write(LogLevels::Warning, LogCategories::Profiler, "Boss benchmark: couldn't find %s in any area", bossNames[i]);
+		}
+	}
+
+}
+
+/**
+ * Sets up the next boss that has an arena: a fresh game with every ability,
+ * the boss's area loaded and Smiley a little way from it. currentFight is
+ * NUM_BOSSES once they have all been fought.
+ */
+void BossBenchmark::startNextFight() {
+
+	do {
+		currentFight++;
+	} while (currentFight < NUM_BOSSES && !results[currentFight].found);
+	if (currentFight >= NUM_BOSSES) return;
+
+	BossBenchmarkResult *result = &results[currentFight];
+	result->frames = 0;
+	result->totalMs = result->maxMs = 0.0;
+	result->peakProjectiles = result->peakPatternBullets = 0;
+	result->peakParticleSystems = result->peakParticles = 0;
+	result->peakEnemies = 0;
+
+	smh->saveManager->resetCurrentData();
+	for (int i = 0; i < NUM_ABILITIES; i++) smh->saveManager->hasAbility[i] = true;
+	smh->player->gui->setAbilityInSlot(FRISBEE, 0);
+	smh->player->gui->setAbilityInSlot(LIGHTNING_ORB, 1);
+	smh->player->gui->setAbilityInSlot(FIRE_BREATH, 2);
+
+	smh->hge->Random_Seed(BOSS_BENCHMARK_SEED);
+	smh->environment->loadArea(result->area, result->area, false);
+	smh->player->reset();
+	smh->player->moveTo(result->gridX, result->gridY + BOT_START_DISTANCE);
+	smh->environment->update(0.0);
+	smh->enterGameState(GAME);
+
+	frame = 0;
+	waypoint = 0;
+	timeAtWaypoint = 0.0;
+	allocationsAtStart = numAllocations;
+
+}
+
+void BossBenchmark::finishFight() {
+
+	BossBenchmarkResult *result = &results[currentFight];
+	result->allocations = numAllocations - allocationsAtStart;
+
+	smh->logger->write(LogLevels::Info, LogCategories::Profiler,
+		"Boss benchmark: %s, %d frames, average %.3f ms, max %.3f ms, peak %d projectiles, %d pattern bullets, %d particle systems (%d particles), %d enemies, %d allocations",
+		bossNames[currentFight], result->frames, result->frames > 0 ? result->totalMs / result->frames : 0.0, result->maxMs,
+		result->peakProjectiles, result->peakPatternBullets, result->peakParticleSystems, result->peakParticles,
+		result->peakEnemies, result->allocations);
+
+}
+
+/**
+ * Walks Smiley to the next waypoint around the boss, flicks his tongue every
+ * half second and takes turns using each ability.
+ */
+void BossBenchmark::driveBot() {
+
+	BossBenchmarkResult *result = &results[currentFight];
+
+	float targetX = (result->gridX + botWaypoints[waypoint][0]) * 64.0 + 32.0;
+	float targetY = (result->gridY + botWaypoints[waypoint][1]) * 64.0 + 32.0;
+	timeAtWaypoint += BOSS_BENCHMARK_DT;
+	if (Util::distance(smh->player->x, smh->player->y, targetX, targetY) < BOT_WAYPOINT_RADIUS || timeAtWaypoint > BOT_WAYPOINT_TIME) {
+		waypoint = (waypoint + 1) % NUM_BOT_WAYPOINTS;
+		timeAtWaypoint = 0.0;
+	}
+
+	smh->input->setScriptedInput(INPUT_LEFT, targetX < smh->player->x - BOT_DEADZONE);
+	smh->input->setScriptedInput(INPUT_RIGHT, targetX > smh->player->x + BOT_DEADZONE);
+	smh->input->setScriptedInput(INPUT_UP, targetY < smh->player->y - BOT_DEADZONE);
+	smh->input->setScriptedInput(INPUT_DOWN, targetY > smh->player->y + BOT_DEADZONE);
+
+	smh->input->setScriptedInput(INPUT_ATTACK, frame % BOT_TONGUE_FRAMES == 0);
+
+	int ability = (frame / BOT_ABILITY_FRAMES) % 3;
+	for (int i = 0; i < 3; i++) {
+		smh->input->setScriptedInput(INPUT_ABILITY1 + i, i == ability && frame % BOT_ABILITY_FRAMES < BOT_ABILITY_HOLD_FRAMES);
+	}
+
+}
+
+void BossBenchmark::writeResults() {
+
+	FILE *file = fopen(BOSS_BENCHMARK_FILE, "w");
+	if (!file) {
+		smh->logger->write(LogLevels::Error, LogCategories::Profiler, "Boss benchmark: couldn't write %s", BOSS_BENCHMARK_FILE);
+		return;
+	}
+
+	fprintf(file, "{\n");
+	fprintf(file, "  \"framesPerFight\": %d,\n", framesPerFight);
+	fprintf(file, "  \"dt\": %f,\n", BOSS_BENCHMARK_DT);
+	fprintf(file, "  \"bosses\": [\n");
+
+	bool first = true;
+	for (int i = 0; i < NUM_BOSSES; i++) {
+		if (!results[i].found) continue;
+		BossBenchmarkResult *result = &results[i];
+		fprintf(file, "%s    {\n", first ? "" : ",\n");
+		fprintf(file, "      \"name\": \"%s\",\n", bossNames[i]);
+		fprintf(file, "      \"area\": %d,\n", result->area);
+		fprintf(file, "      \"frames\": %d,\n", result->frames);
+		fprintf(file, "      \"averageMs\": %.4f,\n", result->frames > 0 ? result->totalMs / result->frames : 0.0);
+		fprintf(file, "      \"maxMs\": %.4f,\n", result->maxMs);
+		fprintf(file, "      \"peakProjectiles\": %d,\n", result->peakProjectiles);
+		fprintf(file, "      \"peakPatternBullets\": %d,\n", result->peakPatternBullets);
+		fprintf(file, "      \"peakParticleSystems\": %d,\n", result->peakParticleSystems);
+		fprintf(file, "      \"peakParticles\": %d,\n", result->peakParticles);
+		fprintf(file, "      \"peakEnemies\": %d,\n", result->peakEnemies);
+		fprintf(file, "      \"allocations\": %d\n", result->allocations);
+		fprintf(file, "    }");
+		first = false;
+	}
+
+	fprintf(file, "\n  ]\n}\n");
+	fclose(file);
+
+	smh->logger->write(LogLevels::Info, LogCategories::Profiler, "Boss benchmark: wrote %s", BOSS_BENCHMARK_FILE);
+
+}
+
+/**
+ * Finds a number in a BossBenchmark.json written by writeResults(). Returns -1
+ * if the boss or the key isn't there.
+ */
+static double readBaselineValue(const std::string &json, const char *boss, const char *key) {
+
+	std::string name = std::string("\"name\": \"") + boss + "\"";
+	std::string::size_type bossStart = json.find(name);
+	if (bossStart == std::string::npos) return -1.0;
+	std::string::size_type bossEnd = json.find('}', bossStart);
+
+	std::string field = std::string("\"") + key + "\": ";
+	std::string::size_type value = json.find(field, bossStart);
+	if (value == std::string::npos || value > bossEnd) return -1.0;
+	value += field.size();
+	return atof(json.c_str() + value);
+}
+
+/**
+ * Logs every number that is worse than the baseline by more than the threshold.
+ * Only the average frame time and allocations are compared; the worst frame is
+ * too noisy to be worth flagging.
+ */
+void BossBenchmark::compareWithBaseline() {
+
+	static const char *keys[] = { "averageMs", "allocations" };
+
+	numRegressions = 0;
+	if (baselineFile.empty()) return;
+
+	std::ifstream file(baselineFile.c_str());
+	if (!file) {
+		smh->logger->write(LogLevels::Error, LogCategories::Profiler, "Boss benchmark: couldn't read baseline %s", baselineFile.c_str());
+		numRegressions++;
+		return;
+	}
+	std::string json((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	for (int i = 0; i < NUM_BOSSES; i++) {
+		if (!results[i].found) continue;
+		double values[2] = { results[i].frames > 0 ? results[i].totalMs / results[i].frames : 0.0, results[i].allocations };
+		for (int k = 0; k < 2; k++) {
+			double baseline = readBaselineValue(json, bossNames[i], keys[k]);
+			if (baseline < 0.0) continue;
+			if (values[k] > baseline * (1.0 + threshold / 100.0)) {
+				smh->logger->write(LogLevels::Warning, LogCategories::Profiler, "Boss benchmark: REGRESSION %s %s %.4f -> %.4f",
+					bossNames[i], keys[k], baseline, values[k]);
+				numRegressions++;
+			}
+		}
+	}
+
+	smh->logger->write(LogLevels::Info, LogCategories::Profiler, "Boss benchmark: compared with %s, %d regressions over %d%%",
+		baselineFile.c_str(), numRegressions, threshold);
+
+}
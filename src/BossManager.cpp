@@ -59,11 +59,15 @@ void BossManager::spawnBoss(int bossID, int groupID, int gridX, int gridY) {
 		newBoss.boss = new FenwarBoss(gridX, gridY, groupID);
 	} else {
 		//Unimplemented boss - exit the program
-		smh->log("FATAL ERROR: BossManager.spawnBoss() received invalid boss ID!!!");
+		smh->logger->write(LogLevels::Error, LogCategories::Bosses, "FATAL ERROR: BossManager.spawnBoss() received invalid boss ID!!!");
 		exit(1);
 	}
 
+	newBoss.resourceGroup = getResourceGroup(bossID);
 	bossList.push_back(newBoss);
+
+	//Start loading the boss's graphics now so they are ready before the fight starts
+	smh->resourceStreamer->request(newBoss.resourceGroup);
 	
 	//Register the boss in its bossID group
 	smh->enemyGroupManager->addEnemy(groupID);
@@ -80,6 +84,7 @@ void BossManager::update(float dt)
 	{
 		if (i->boss->update(dt)) 
 		{
+			smh->resourceStreamer->cancel(i->resourceGroup);
 			delete i->boss;
 			i = bossList.erase(i);
 		}
@@ -113,8 +118,30 @@ void BossManager::drawAfterSmiley(float dt) {
 void BossManager::reset() {
 	std::list<BossStruct>::iterator i;
 	for (i = bossList.begin(); i != bossList.end(); i++) {
+		smh->resourceStreamer->cancel(i->resourceGroup);
 		delete i->boss;
 		i = bossList.erase(i);
 	}
 	bossList.clear();
-}
\ No newline at end of file
+}
+
+/**
+ * Returns the resource group that holds a boss's graphics and sounds.
+ */
+int BossManager::getResourceGroup(int bossID) {
+	switch (bossID) {
+		case FIRE_BOSS: return ResourceGroups::Phyrebawz;
+		case DESERT_BOSS: return ResourceGroups::Cornwallis;
+		case SNOW_BOSS: return ResourceGroups::PortlyPenguin;
+		case FOREST_BOSS: return ResourceGroups::Garmborn;
+		case MUSHROOM_BOSS: return ResourceGroups::Mushboom;
+		case DESPAIR_BOSS: return ResourceGroups::Calypso;
+		case FIRE_BOSS2: return ResourceGroups::Phyrebawz;
+		case CANDY_BOSS: return ResourceGroups::Bartli;
+		case LOVECRAFT_BOSS: return ResourceGroups::Lovecraft;
+		case TUT_BOSS: return ResourceGroups::KingTut;
+		case CONSERVATORY_BOSS: return ResourceGroups::Barvinoid;
+		case FENWAR_BOSS: return ResourceGroups::Fenwar;
+	}
+	return -1;
+}
@@ -66,10 +66,10 @@ CandyBoss::CandyBoss(int _gridX, int _gridY, int _groupID)
 
 	initCanPass();
 
-	for (int curX = gridX; canPass[smh->environment->collision[curX][gridY]]; curX++) maxX = curX*64;
-	for (int curX = gridX; canPass[smh->environment->collision[curX][gridY]]; curX--) minX = curX*64 + 64;
-	for (int curY = gridY; canPass[smh->environment->collision[gridX][curY]]; curY++) maxY = curY*64;
-	for (int curY = gridY; canPass[smh->environment->collision[gridX][curY]]; curY--) minY = curY*64 + 64;
+	for (int curX = gridX; canPass[smh->environment->collision(curX, gridY)]; curX++) maxX = curX*64;
+	for (int curX = gridX; canPass[smh->environment->collision(curX, gridY)]; curX--) minX = curX*64 + 64;
+	for (int curY = gridY; canPass[smh->environment->collision(gridX, curY)]; curY++) maxY = curY*64;
+	for (int curY = gridY; canPass[smh->environment->collision(gridX, curY)]; curY--) minY = curY*64 + 64;
 
 	health = maxHealth = HEALTH;
 	startedIntroDialogue = false;
@@ -105,10 +105,18 @@ CandyBoss::~CandyBoss() {
 	delete collisionBox;
 	delete futureCollisionBox;
 
-	for (std::list<Bartlet>::iterator i = bartletList.begin(); i != bartletList.end(); i++) {
+	std::list<Bartlet>::iterator i = bartletList.begin();
+	while (i != bartletList.end()) {
 		delete i->collisionBox;
 		i = bartletList.erase(i);
 	}
+
+	std::list<Nova>::iterator nova = novaList.begin();
+	while (nova != novaList.end()) {
+		smh->particlePool->release(nova->particle);
+		delete nova->collisionCircle;
+		nova = novaList.erase(nova);
+	}
 }
 
 /**
@@ -653,10 +661,8 @@ void CandyBoss::setCollisionBox(hgeRect *box, float x, float y) {
 }
 
 void CandyBoss::initCanPass() {
-	for (int i = 0; i < 256; i++) {
-		canPass[i] = false;
-	}
-	canPass[WALKABLE] = true;
+	canPass.setAll(false);
+	canPass.set(WALKABLE, true);
 }
 
 //////////////////////////////// Novas /////////////////////////////
@@ -667,7 +673,7 @@ void CandyBoss::spawnNova(float _x, float _y) {
 	newNova.y = _y;
 	newNova.radius = 0.0;
 	newNova.timeSpawned = smh->getGameTime();
-	newNova.particle = new hgeParticleSystem(&smh->resources->GetParticleSystem("shockwave")->info);
+	newNova.particle = smh->particlePool->acquire("shockwave", ParticlePriorities::High);
 	newNova.particle->info.fParticleLifeMax = newNova.particle->info.fParticleLifeMin = 1.0;
 	newNova.particle->FireAt(smh->getScreenX(_x), smh->getScreenY(_y));
 	newNova.collisionCircle = new CollisionCircle();
@@ -676,7 +682,8 @@ void CandyBoss::spawnNova(float _x, float _y) {
 }
 
 void CandyBoss::updateNovas(float dt) {
-	for (std::list<Nova>::iterator i = novaList.begin(); i != novaList.end(); i++) {
+	std::list<Nova>::iterator i = novaList.begin();
+	while (i != novaList.end()) {
 
 		i->particle->MoveTo(smh->getScreenX(i->x), smh->getScreenY(i->y), true);
 		i->particle->Update(dt);
@@ -692,16 +699,18 @@ void CandyBoss::updateNovas(float dt) {
 		}
 
 		if (smh->timePassedSince(i->timeSpawned) > i->particle->info.fParticleLifeMax) {
-			delete i->particle;
+			smh->particlePool->release(i->particle);
 			delete i->collisionCircle;
 			i = novaList.erase(i);
+		} else {
+			i++;
 		}
 	}
 }
 
 void CandyBoss::drawNovas(float dt) {
 	for (std::list<Nova>::iterator i = novaList.begin(); i != novaList.end(); i++) {
-		i->particle->Render();
+		smh->particlePool->render(i->particle);
 		if (smh->isDebugOn()) i->collisionCircle->draw();
 	}
 }
@@ -61,7 +61,7 @@ private:
 	double leftArmRot,rightArmRot;
 	double leftLegY,rightLegY;
 	double angle;
-	bool canPass[256];
+	CollisionMask canPass;
 	bool jumping;
 	float jumpYOffset;
 	float jumpDistance;
@@ -1,6 +1,4 @@
-#include "SmileyEngine.h"
-
-extern SMH *smh;
+#include "SmileyPrimitives.h"
 
 using namespace std;
 
@@ -1,5 +1,10 @@
 #include "SmileyEngine.h"
 #include "Player.h"
+#include "SpecialTileManager.h"
+#include "MiniMap.h"
+#include "EnemyFramework.h"
+#include "PatternEmitter.h"
+#include "CollisionCircle.h"
 
 extern SMH *smh;
 
@@ -7,6 +12,24 @@ extern SMH *smh;
 #define NO 1
 #define NA 2
 
+#define DEFAULT_WARP_BENCHMARK_ITERATIONS 20
+#define DEFAULT_COLLISION_BENCHMARK_ITERATIONS 200
+#define DEFAULT_MESH_BENCHMARK_ITERATIONS 1000
+#define MESH_BENCHMARK_MESHES 50
+#define DEFAULT_WORM_BENCHMARK_FRAMES 100000
+#define WORM_BENCHMARK_SMILELETS 8		//As many as fit on the worm 60 pixels apart
+#define WORM_BENCHMARK_SPEED 9			//Pixels per frame sprinting at 60 fps
+#define DEFAULT_RESOURCE_BENCHMARK_ITERATIONS 20
+#define RESOURCE_BENCHMARK_LOOKUPS 1000		//Passes over every resource name
+#define ASSET_BENCHMARK_PACKS 2
+#define DEFAULT_SPRITE_BATCH_BENCHMARK_FRAMES 1000
+#define DEFAULT_THINK_BENCHMARK_ITERATIONS 200
+#define THINK_BENCHMARK_RUNS 4
+#define DEFAULT_BULLET_BENCHMARK_FRAMES 600
+#define BULLET_BENCHMARK_BULLETS 2000
+#define BULLET_BENCHMARK_RING 50
+#define BULLET_BENCHMARK_SPEED 30.0		//Slow enough that none of them get away during the benchmark
+
 Console::Console() {
 	active = false;
 	debugMovePressed = false;
@@ -42,6 +65,17 @@ void Console::draw(float dt) {
 	write("F4    10 gems             ", NA);
 	write("F5    Full Health/Mana    ", NA);
 	write("F7    Warp to next lollipop", NA);
+	write("F8    Warp benchmark (log)", NA);
+	write("S+F8  Benchmark all areas ", NA);
+	write("P     Silly pad benchmark (log)", NA);
+	write("T     Mesh wave benchmark (log)", NA);
+	write("W     Worm benchmark (log)", NA);
+	write("R     Resource startup benchmark (log)", NA);
+	write("L     Asset load benchmark (log)", NA);
+	write("B     Sprite batch counts (log)", NA);
+	write("E     Enemy think benchmark (log)", NA);
+	write("G     Bullet pattern benchmark (log)", NA);
+	write("M     Save minimap.tga    ", NA);
 	write("NUM8  Move up 1 tile      ", NA);
 	write("NUM5  Move down 1 tile    ", NA);
 	write("NUM4  Move left 1 tile    ", NA);
@@ -60,6 +94,34 @@ void Console::draw(float dt) {
 	int playerY = smh->player->y;
 	int c = smh->environment->collisionAt(playerX,playerY);
 	smh->resources->GetFont("consoleFnt")->printf(15, 150 + lineNum*25, HGETEXT_LEFT, "Smiley collision: %d", c);
+
+	drawResourceGroups();
+}
+
+/**
+ * Lists the boss resource groups down the right side with how much of each is
+ * loaded and how much texture memory it is using.
+ */
+void Console::drawResourceGroups() {
+
+	static const int groups[] = { ResourceGroups::Phyrebawz, ResourceGroups::PortlyPenguin, ResourceGroups::Garmborn,
+		ResourceGroups::Cornwallis, ResourceGroups::Mushboom, ResourceGroups::Calypso, ResourceGroups::Bartli,
+		ResourceGroups::KingTut, ResourceGroups::Lovecraft, ResourceGroups::Barvinoid, ResourceGroups::Fenwar };
+	static const char *names[] = { "Phyrebawz", "Portly Penguin", "Garmborn", "Cornwallis", "Mushboom",
+		"Calypso", "Bartli", "King Tut", "Lovecraft", "Barvinoid", "Fenwar" };
+
+	hgeFont *font = smh->resources->GetFont("consoleFnt");
+	font->printf(1000, 150, HGETEXT_RIGHT, "Boss resources");
+
+	for (int i = 0; i < (int)(sizeof(groups) / sizeof(groups[0])); i++) {
+		ResourceResidency residency = smh->resourceStreamer->getResidency(groups[i]);
+		const char *state = "";
+		if (smh->resourceStreamer->isStreaming(groups[i])) state = " (streaming)";
+		else if (residency.numLoaded == residency.numResources) state = " (resident)";
+		font->printf(1000, 175 + i*25, HGETEXT_RIGHT, "%s: %d/%d, %.1f MB%s", names[i],
+			residency.numLoaded, residency.numResources, residency.textureBytes / (1024.0 * 1024.0), state);
+	}
+
 }
 
 void Console::update(float dt) {
@@ -128,13 +190,13 @@ void Console::update(float dt) {
 				//to its left or above it
 				int absdist = (abs(curX-smh->player->gridX) + abs(curY-smh->player->gridY));
 
-				if (smh->environment->collision[curX][curY] == SAVE_SHRINE && absdist >1)
+				if (smh->environment->collision(curX, curY) == SAVE_SHRINE && absdist >1)
 				{
 					//We don't want to put Smiley right on the lollipop, though. Put him on a nearby clear square
 								
 					//Try left
 					if (curX -1 >= 0) { //make sure it's in bounds
-						if (smh->environment->collision[curX-1][curY] == WALKABLE || smh->environment->collision[curX-1][curY] == SHALLOW_WATER) {
+						if (smh->environment->collision(curX-1, curY) == WALKABLE || smh->environment->collision(curX-1, curY) == SHALLOW_WATER) {
 							smh->player->moveTo(curX-1,curY);
 							exitloop=true;
 						}
@@ -142,7 +204,7 @@ void Console::update(float dt) {
 					
 					//Try up
 					if (curY -1 >= 0) { //make sure it's in bounds
-						if (smh->environment->collision[curX][curY-1] == WALKABLE || smh->environment->collision[curX][curY-1] == SHALLOW_WATER) {
+						if (smh->environment->collision(curX, curY-1) == WALKABLE || smh->environment->collision(curX, curY-1) == SHALLOW_WATER) {
 							smh->player->moveTo(curX,curY-1);
 							exitloop=true;
 						}
@@ -150,7 +212,7 @@ void Console::update(float dt) {
 
 					//Try right
 					if (curX +1 <256) { //make sure it's in bounds
-						if (smh->environment->collision[curX+1][curY] == WALKABLE || smh->environment->collision[curX+1][curY] == SHALLOW_WATER) {
+						if (smh->environment->collision(curX+1, curY) == WALKABLE || smh->environment->collision(curX+1, curY) == SHALLOW_WATER) {
 							smh->player->moveTo(curX+1,curY);
 							exitloop=true;
 						}
@@ -158,7 +220,7 @@ void Console::update(float dt) {
 
 					//Now try down
 					if (curY +1 <256) { //make sure it's in bounds
-						if (smh->environment->collision[curX][curY+1] == WALKABLE || smh->environment->collision[curX][curY+1] == SHALLOW_WATER) {
+						if (smh->environment->collision(curX, curY+1) == WALKABLE || smh->environment->collision(curX, curY+1) == SHALLOW_WATER) {
 							smh->player->moveTo(curX,curY+1);
 							exitloop=true;
 						}
@@ -180,6 +242,55 @@ void Console::update(float dt) {
 
 		}
 
+		//Warp benchmarks. Shift cycles through every area instead of just the fountain and the castle.
+		if (smh->hge->Input_KeyDown(HGEK_F8) && !smh->areaChanger->isChangingArea()) {
+			if (smh->hge->Input_GetKeyState(HGEK_SHIFT)) {
+				int allAreas[NUM_AREAS];
+				for (int i = 0; i < NUM_AREAS; i++) allAreas[i] = i;
+				runWarpBenchmark(allAreas, NUM_AREAS);
+			} else {
+				int areas[2] = { FOUNTAIN_AREA, CASTLE_OF_EVIL };
+				runWarpBenchmark(areas, 2);
+			}
+		}
+
+		if (smh->hge->Input_KeyDown(HGEK_P)) {
+			runSillyPadBenchmark();
+		}
+
+		if (smh->hge->Input_KeyDown(HGEK_T)) {
+			runMeshWaveBenchmark();
+		}
+
+		if (smh->hge->Input_KeyDown(HGEK_W)) {
+			runWormBenchmark();
+		}
+
+		if (smh->hge->Input_KeyDown(HGEK_R)) {
+			runResourceBenchmark();
+		}
+
+		if (smh->hge->Input_KeyDown(HGEK_L)) {
+			runAssetPackBenchmark();
+		}
+
+		if (smh->hge->Input_KeyDown(HGEK_B)) {
+			runSpriteBatchBenchmark();
+		}
+
+		if (smh->hge->Input_KeyDown(HGEK_E)) {
+			runEnemyThinkBenchmark();
+		}
+
+		if (smh->hge->Input_KeyDown(HGEK_G)) {
+			runBulletPatternBenchmark();
+		}
+
+		if (smh->hge->Input_KeyDown(HGEK_M)) {
+			smh->environment->miniMap->sync();
+			smh->environment->miniMap->saveImage("minimap.tga");
+		}
+
 		//Move smiley with num pad
 		int xMove = 0;
 		int yMove = 0;
@@ -208,6 +319,512 @@ void Console::update(float dt) {
 
 }
 
+/**
+ * Loads each of the given areas in turn, over and over, logging how long the
+ * loads took and how much each area allocated from the area arena. Smiley is
+ * put back where he was afterwards.
+ */
+void Console::runWarpBenchmark(const int *areas, int numAreas) {
+
+	int iterations = smh->hge->Ini_GetInt("Debug", "warpBenchmarkIterations", DEFAULT_WARP_BENCHMARK_ITERATIONS);
+	double totalMs[NUM_AREAS], maxMs[NUM_AREAS];
+	int numAllocations[NUM_AREAS], bytesUsed[NUM_AREAS];
+	bool visited[NUM_AREAS];
+
+	int startArea = smh->saveManager->currentArea;
+	int startGridX = smh->player->gridX;
+	int startGridY = smh->player->gridY;
+	for (int a = 0; a < numAreas; a++) {
+		totalMs[a] = maxMs[a] = 0.0;
+		numAllocations[a] = bytesUsed[a] = 0;
+		visited[a] = smh->saveManager->hasVisitedArea[areas[a]];
+	}
+
+	LARGE_INTEGER frequency, start, end;
+	QueryPerformanceFrequency(&frequency);
+
+	for (int i = 0; i < iterations; i++) {
+		for (int a = 0; a < numAreas; a++) {
+			int from = areas[(a + numAreas - 1) % numAreas];
+
+			QueryPerformanceCounter(&start);
+			smh->environment->loadArea(areas[a], from, false);
+			QueryPerformanceCounter(&end);
+
+			double ms = (double)(end.QuadPart - start.QuadPart) * 1000.0 / (double)frequency.QuadPart;
+			totalMs[a] += ms;
+			if (ms > maxMs[a]) maxMs[a] = ms;
+			numAllocations[a] = smh->areaArena->getNumAllocations();
+			bytesUsed[a] = smh->areaArena->getBytesUsed();
+		}
+	}
+
+	for (int a = 0; a < numAreas; a++) {
+		smh->logger->write(LogLevels::Info, LogCategories::Profiler,
+			"Warp benchmark: %s x%d, average %.2f ms, max %.2f ms, %d arena allocations (%d KB)",
+			smh->gameData->getAreaName(areas[a]), iterations, iterations > 0 ? totalMs[a] / iterations : 0.0,
+			maxMs[a], numAllocations[a], bytesUsed[a] / 1024);
+		smh->saveManager->hasVisitedArea[areas[a]] = visited[a];
+	}
+
+	smh->environment->loadArea(startArea, startArea, false);
+	smh->player->moveTo(startGridX, startGridY);
+
+}
+
+/**
+ * Covers the walkable squares around Smiley with silly pads and times the
+ * terrain collision checks that enemies and Smiley make every frame. The
+ * silly pads are removed again afterwards.
+ */
+void Console::runSillyPadBenchmark() {
+
+	int iterations = smh->hge->Ini_GetInt("Debug", "collisionBenchmarkIterations", DEFAULT_COLLISION_BENCHMARK_ITERATIONS);
+	int minX = smh->player->gridX - 8, maxX = smh->player->gridX + 8;
+	int minY = smh->player->gridY - 6, maxY = smh->player->gridY + 6;
+
+	bool placed[17][13];
+	int numPlaced = 0;
+	for (int i = minX; i <= maxX; i++) {
+		for (int j = minY; j <= maxY; j++) {
+			placed[i-minX][j-minY] = smh->environment->isInBounds(i, j) && smh->environment->collision(i, j) == WALKABLE &&
+				!smh->environment->hasSillyPad(i, j) && (i != smh->player->gridX || j != smh->player->gridY);
+			if (placed[i-minX][j-minY]) {
+				smh->environment->specialTileManager->addSillyPad(i, j);
+				numPlaced++;
+			}
+		}
+	}
+
+	CollisionMask canPass;
+	for (int i = 0; i < 256; i++) {
+		canPass.set(i, smh->player->canPass(i));
+	}
+
+	hgeRect box;
+	int numCollisions = 0;
+	LARGE_INTEGER frequency, start, end;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&start);
+
+	for (int n = 0; n < iterations; n++) {
+		for (int i = minX; i <= maxX; i++) {
+			for (int j = minY; j <= maxY; j++) {
+				box.SetRadius(i*64.0+32.0, j*64.0+32.0, 24.0);
+				if (smh->environment->testCollision(&box, canPass)) numCollisions++;
+			}
+		}
+		for (int j = minY; j <= maxY; j++) {
+			if (smh->environment->validPath(minX*64+32, j*64+32, maxX*64+32, j*64+32, 24, canPass)) numCollisions++;
+		}
+	}
+
+	QueryPerformanceCounter(&end);
+	double ms = (double)(end.QuadPart - start.QuadPart) * 1000.0 / (double)frequency.QuadPart;
+
+	smh->logger->write(LogLevels::Info, LogCategories::Profiler,
+		"Silly pad benchmark: %d silly pads, %d iterations, %.3f ms per iteration (%d hits)",
+		numPlaced, iterations, iterations > 0 ? ms / iterations : 0.0, numCollisions);
+
+	//Only remove the silly pads that were added for the benchmark
+	for (int i = minX; i <= maxX; i++) {
+		for (int j = minY; j <= maxY; j++) {
+			if (placed[i-minX][j-minY]) smh->environment->destroySillyPad(i, j);
+		}
+	}
+
+}
+
+/**
+ * Times updating a room full of tapestry meshes the old way, with a cosf/sinf
+ * per node per mesh, against sharing one precomputed MeshWave between them.
+ */
+void Console::runMeshWaveBenchmark() {
+
+	int iterations = smh->hge->Ini_GetInt("Debug", "meshBenchmarkIterations", DEFAULT_MESH_BENCHMARK_ITERATIONS);
+	int granularity = 8;
+
+	hgeDistortionMesh *meshes[MESH_BENCHMARK_MESHES];
+	for (int i = 0; i < MESH_BENCHMARK_MESHES; i++) {
+		meshes[i] = new hgeDistortionMesh(granularity, granularity);
+	}
+
+	MeshWave *wave = new MeshWave(granularity, granularity, 2.0, 3.0);
+	for (int x = 0; x < granularity; x++) {
+		for (int y = 1; y < granularity; y++) {
+			wave->setNode(x, y, y*4.0/granularity, 0.5*y, (x+y)/2, 2.0);
+		}
+	}
+
+	LARGE_INTEGER frequency, start, end;
+	QueryPerformanceFrequency(&frequency);
+
+	QueryPerformanceCounter(&start);
+	for (int n = 0; n < iterations; n++) {
+		float time = (float)n * 0.016;
+		for (int i = 0; i < MESH_BENCHMARK_MESHES; i++) {
+			for (int x = 0; x < granularity; x++) {
+				for (int y = 1; y < granularity; y++) {
+					meshes[i]->SetDisplacement(x, y, 
+						cosf(time*2.0+y*4.0/granularity)*0.5*y, 
+						sinf(time*3.0+(x+y)/2)*2, 
+						HGEDISP_NODE);
+				}
+			}
+		}
+	}
+	QueryPerformanceCounter(&end);
+	double directMs = (double)(end.QuadPart - start.QuadPart) * 1000.0 / (double)frequency.QuadPart;
+
+	QueryPerformanceCounter(&start);
+	for (int n = 0; n < iterations; n++) {
+		float time = (float)n * 0.016;
+		for (int i = 0; i < MESH_BENCHMARK_MESHES; i++) {
+			wave->update(time);
+			wave->apply(meshes[i]);
+		}
+	}
+	QueryPerformanceCounter(&end);
+	double waveMs = (double)(end.QuadPart - start.QuadPart) * 1000.0 / (double)frequency.QuadPart;
+
+	smh->logger->write(LogLevels::Info, LogCategories::Profiler,
+		"Mesh wave benchmark: %d meshes, %d iterations, direct %.4f ms per frame, shared wave %.4f ms per frame",
+		MESH_BENCHMARK_MESHES, iterations, iterations > 0 ? directMs / iterations : 0.0, iterations > 0 ? waveMs / iterations : 0.0);
+
+	delete wave;
+	for (int i = 0; i < MESH_BENCHMARK_MESHES; i++) {
+		delete meshes[i];
+	}
+
+}
+
+/**
+ * Times what startup used to do, parsing the resource script with HGE's resource
+ * manager, against mapping the compiled manifest, then times finding every
+ * resource by name.
+ */
+void Console::runResourceBenchmark() {
+
+	int iterations = smh->hge->Ini_GetInt("Debug", "resourceBenchmarkIterations", DEFAULT_RESOURCE_BENCHMARK_ITERATIONS);
+
+	LARGE_INTEGER frequency, start, end;
+	QueryPerformanceFrequency(&frequency);
+
+	QueryPerformanceCounter(&start);
+	for (int n = 0; n < iterations; n++) {
+		hgeResourceManager *script = new hgeResourceManager(RESOURCE_SCRIPT_FILE);
+		delete script;
+	}
+	QueryPerformanceCounter(&end);
+	double scriptMs = (double)(end.QuadPart - start.QuadPart) * 1000.0 / (double)frequency.QuadPart;
+
+	QueryPerformanceCounter(&start);
+	for (int n = 0; n < iterations; n++) {
+		ResourceManifest *manifest = new ResourceManifest(RESOURCE_MANIFEST_FILE, RESOURCE_SCRIPT_FILE);
+		delete manifest;
+	}
+	QueryPerformanceCounter(&end);
+	double manifestMs = (double)(end.QuadPart - start.QuadPart) * 1000.0 / (double)frequency.QuadPart;
+
+	int numRecords = smh->resources->getNumRecords();
+	int found = 0;
+	QueryPerformanceCounter(&start);
+	for (int n = 0; n < RESOURCE_BENCHMARK_LOOKUPS; n++) {
+		for (int i = 0; i < numRecords; i++) {
+			const char *name = smh->resources->getName(i);
+			if (smh->resources->find(name) == i) found++;
+		}
+	}
+	QueryPerformanceCounter(&end);
+	double lookupMs = (double)(end.QuadPart - start.QuadPart) * 1000.0 / (double)frequency.QuadPart;
+
+	smh->logger->write(LogLevels::Info, LogCategories::Profiler,
+		"Resource benchmark: %d iterations, script %.3f ms, manifest %.3f ms, %.1f ns per lookup (%d of %d found)",
+		iterations, iterations > 0 ? scriptMs / iterations : 0.0, iterations > 0 ? manifestMs / iterations : 0.0,
+		numRecords > 0 ? lookupMs * 1000000.0 / ((double)numRecords * RESOURCE_BENCHMARK_LOOKUPS) : 0.0,
+		found, numRecords * RESOURCE_BENCHMARK_LOOKUPS);
+
+}
+
+/**
+ * Times loading every sound and font file the first time it is asked for, out
+ * of the asset packs against through HGE from the zips. Needs the packs built
+ * with -buildpacks.
+ */
+void Console::runAssetPackBenchmark() {
+
+	static const char *files[ASSET_BENCHMARK_PACKS][2] = { { "Data/Sounds.pak", "Data/Sounds.zip" },
+		{ "Data/Fonts.pak", "Data/Fonts.zip" } };
+
+	AssetPacks *packs = new AssetPacks();
+	bool attachedZips[ASSET_BENCHMARK_PACKS];
+	for (int i = 0; i < ASSET_BENCHMARK_PACKS; i++) {
+		if (!packs->attach(files[i][0], NULL)) {
+			smh->logger->write(LogLevels::Warning, LogCategories::Profiler, "Asset benchmark: %s isn't built, run with -buildpacks", files[i][0]);
+		}
+		//HGE won't attach a zip twice, so this only attaches the ones the game isn't using
+		attachedZips[i] = smh->hge->Resource_AttachPack(files[i][1]);
+	}
+
+	LARGE_INTEGER frequency, start, end;
+	QueryPerformanceFrequency(&frequency);
+
+	int numAssets = packs->getNumAssets();
+	int numFailed = 0;
+	double packMs = 0.0, zipMs = 0.0, maxPackMs = 0.0, maxZipMs = 0.0;
+	for (int i = 0; i < numAssets; i++) {
+
+		const char *name = packs->getAssetName(i);
+		DWORD size;
+
+		packs->clearCache();
+		QueryPerformanceCounter(&start);
+		const BYTE *data = packs->load(name, &size);
+		QueryPerformanceCounter(&end);
+		double ms = (double)(end.QuadPart - start.QuadPart) * 1000.0 / (double)frequency.QuadPart;
+		packMs += ms;
+		if (ms > maxPackMs) maxPackMs = ms;
+		if (!data) numFailed++;
+
+		QueryPerformanceCounter(&start);
+		void *resource = smh->hge->Resource_Load(name, &size);
+		QueryPerformanceCounter(&end);
+		ms = (double)(end.QuadPart - start.QuadPart) * 1000.0 / (double)frequency.QuadPart;
+		zipMs += ms;
+		if (ms > maxZipMs) maxZipMs = ms;
+		if (resource) smh->hge->Resource_Free(resource);
+		else numFailed++;
+	}
+
+	for (int i = 0; i < ASSET_BENCHMARK_PACKS; i++) {
+		if (attachedZips[i]) smh->hge->Resource_RemovePack(files[i][1]);
+	}
+	delete packs;
+
+	smh->logger->write(LogLevels::Info, LogCategories::Profiler,
+		"Asset benchmark: %d assets, packs %.3f ms (max %.3f ms), zips %.3f ms (max %.3f ms), %d failed",
+		numAssets, packMs, maxPackMs, zipMs, maxZipMs, numFailed);
+
+}
+
+/**
+ * Draws the environment, enemies and GUI without sending anything to the card,
+ * counting the texture switches and batches each one needs per frame in the
+ * order things are drawn against the order the sprite batch sends them. Only
+ * what goes through the sprite batch is counted.
+ */
+void Console::runSpriteBatchBenchmark() {
+
+	static const char *sections[NUM_BATCH_SECTIONS] = { "environment", "enemies", "GUI" };
+
+	int frames = smh->hge->Ini_GetInt("Debug", "spriteBatchBenchmarkFrames", DEFAULT_SPRITE_BATCH_BENCHMARK_FRAMES);
+	if (frames < 1) frames = 1;
+
+	LARGE_INTEGER frequency, start, end;
+	QueryPerformanceFrequency(&frequency);
+
+	smh->spriteBatch->setHeadless(true);
+	smh->spriteBatch->resetStats();
+
+	QueryPerformanceCounter(&start);
+	for (int n = 0; n < frames; n++) {
+		smh->spriteBatch->beginSection(BatchSections::Environment);
+		smh->environment->draw(0.0);
+		smh->spriteBatch->endSection();
+		smh->spriteBatch->beginSection(BatchSections::Enemies);
+		smh->enemyManager->draw(0.0);
+		smh->spriteBatch->endSection();
+		smh->spriteBatch->beginSection(BatchSections::GUI);
+		smh->player->drawGUI(0.0);
+		smh->spriteBatch->endSection();
+	}
+	QueryPerformanceCounter(&end);
+	double ms = (double)(end.QuadPart - start.QuadPart) * 1000.0 / (double)frequency.QuadPart;
+
+	smh->spriteBatch->setHeadless(false);
+
+	for (int i = 0; i < NUM_BATCH_SECTIONS; i++) {
+		const BatchStats &stats = smh->spriteBatch->getStats(i);
+		smh->logger->write(LogLevels::Info, LogCategories::Profiler,
+			"Sprite batch benchmark: %s, %d quads, %d switches and %d batches as drawn, %d switches and %d batches as sent",
+			sections[i], stats.quads / frames, stats.drawnSwitches / frames, stats.drawnBatches / frames,
+			stats.switches / frames, stats.batches / frames);
+	}
+	smh->logger->write(LogLevels::Info, LogCategories::Profiler, "Sprite batch benchmark: %d frames, %.3f ms per frame, %d atlas pages",
+		frames, ms / frames, smh->resources->getNumAtlasPages());
+	smh->spriteBatch->resetStats();
+
+}
+
+static void hashBytes(DWORD *hash, const void *data, int size) {
+	const BYTE *bytes = (const BYTE*)data;
+	for (int i = 0; i < size; i++) {
+		*hash = (*hash ^ bytes[i]) * 16777619;
+	}
+}
+
+/**
+ * Hashes everything the think phase produces: the commands it applied and the
+ * A* map of every enemy.
+ */
+static DWORD hashThinkResults() {
+
+	DWORD hash = 2166136261;
+
+	const std::vector<EnemyCommand> &commands = smh->enemyManager->getCommands();
+	for (int i = 0; i < (int)commands.size(); i++) {
+		hashBytes(&hash, &commands[i].enemy, sizeof(int));
+		hashBytes(&hash, &commands[i].type, sizeof(int));
+		hashBytes(&hash, &commands[i].result, sizeof(bool));
+		hashBytes(&hash, commands[i].key, sizeof(commands[i].key));
+	}
+
+	std::list<EnemyStruct>::iterator i;
+	for (i = smh->enemyManager->enemyList.begin(); i != smh->enemyManager->enemyList.end(); i++) {
+		hashBytes(&hash, i->enemy->mapPath, sizeof(i->enemy->mapPath));
+	}
+
+	return hash;
+}
+
+/**
+ * Runs the enemy think phase on 1, 2, 4 and 8 workers and logs how long it
+ * took on each. What comes out of it is checked against one worker, which is
+ * the same as doing it serially. The update after it only sees the commands,
+ * so if they match the frame plays out the same.
+ */
+void Console::runEnemyThinkBenchmark() {
+
+	static const int workerCounts[THINK_BENCHMARK_RUNS] = { 1, 2, 4, 8 };
+
+	int iterations = smh->hge->Ini_GetInt("Debug", "thinkBenchmarkIterations", DEFAULT_THINK_BENCHMARK_ITERATIONS);
+	if (iterations < 1) iterations = 1;
+
+	LARGE_INTEGER frequency, start, end;
+	QueryPerformanceFrequency(&frequency);
+
+	DWORD serialHash = 0;
+	double serialMs = 0.0;
+	for (int run = 0; run < THINK_BENCHMARK_RUNS; run++) {
+
+		int numWorkers = workerCounts[run];
+		int stolen = smh->workerPool->getNumStolen();
+
+		QueryPerformanceCounter(&start);
+		for (int n = 0; n < iterations; n++) {
+			smh->enemyManager->think(numWorkers);
+		}
+		QueryPerformanceCounter(&end);
+		double ms = (double)(end.QuadPart - start.QuadPart) * 1000.0 / (double)frequency.QuadPart / iterations;
+
+		DWORD hash = hashThinkResults();
+		if (run == 0) {
+			serialHash = hash;
+			serialMs = ms;
+		}
+
+		smh->logger->write(LogLevels::Info, LogCategories::Profiler,
+			"Enemy think benchmark: %d enemies, %d workers, %.3f ms per frame, %.2fx, %d jobs stolen, %d commands, %s",
+			(int)smh->enemyManager->enemyList.size(), numWorkers < smh->workerPool->getNumThreads() + 1 ? numWorkers : smh->workerPool->getNumThreads() + 1,
+			ms, ms > 0.0 ? serialMs / ms : 0.0, smh->workerPool->getNumStolen() - stolen, (int)smh->enemyManager->getCommands().size(),
+			hash == serialHash ? "matches serial" : "DOESN'T MATCH SERIAL");
+	}
+
+}
+
+struct ListBullet {
+	float x, y, dx, dy;
+	hgeRect *collisionBox;
+};
+
+/**
+ * Fires the same rings of bullets around Smiley into the pattern emitter and
+ * into a list of bullets with their own collision boxes, which is how bosses
+ * kept them before, and times updating each of them.
+ */
+void Console::runBulletPatternBenchmark() {
+
+	static const BulletPattern benchmarkRing = {
+		PatternShapes::Ring, BULLET_BENCHMARK_RING, 0.0, 0.0, 0.0, 0.0,
+		BULLET_BENCHMARK_SPEED, 0.0, 0.0, 0.0,
+		10.0, 0.0, 0, 2000.0, 0.0, 0.0,
+		0.0, 0.0, NULL,
+		NULL, NULL, NULL, NULL, NULL
+	};
+
+	if (smh->patternEmitter->getNumBullets() > 0) {
+		smh->logger->write(LogLevels::Warning, LogCategories::Profiler, "Bullet pattern benchmark: skipped, %d bullets are already flying",
+			smh->patternEmitter->getNumBullets());
+		return;
+	}
+
+	int frames = smh->hge->Ini_GetInt("Debug", "bulletBenchmarkFrames", DEFAULT_BULLET_BENCHMARK_FRAMES);
+	if (frames < 1) frames = 1;
+	int volleys = BULLET_BENCHMARK_BULLETS / BULLET_BENCHMARK_RING;
+	float dt = 1.0 / 60.0;
+
+	LARGE_INTEGER frequency, start, end;
+	QueryPerformanceFrequency(&frequency);
+
+	std::list<ListBullet> bullets;
+	for (int volley = 0; volley < volleys; volley++) {
+		for (int i = 0; i < BULLET_BENCHMARK_RING; i++) {
+			float angle = volley * 0.05 + (2.0*PI / float(BULLET_BENCHMARK_RING)) * float(i);
+			ListBullet bullet;
+			bullet.x = smh->player->x;
+			bullet.y = smh->player->y;
+			bullet.dx = BULLET_BENCHMARK_SPEED * cos(angle);
+			bullet.dy = BULLET_BENCHMARK_SPEED * sin(angle);
+			bullet.collisionBox = new hgeRect();
+			bullet.collisionBox->SetRadius(bullet.x, bullet.y, 10.0);
+			bullets.push_back(bullet);
+		}
+	}
+
+	QueryPerformanceCounter(&start);
+	for (int n = 0; n < frames; n++) {
+		for (std::list<ListBullet>::iterator i = bullets.begin(); i != bullets.end(); ) {
+			i->x += i->dx * dt;
+			i->y += i->dy * dt;
+			i->collisionBox->SetRadius(i->x, i->y, 10.0);
+			smh->player->collisionCircle->testBox(i->collisionBox);
+			if (Util::distance(i->x, i->y, smh->player->x, smh->player->y) > 2000.0) {
+				delete i->collisionBox;
+				i = bullets.erase(i);
+			} else {
+				i++;
+			}
+		}
+	}
+	QueryPerformanceCounter(&end);
+	double listMs = (double)(end.QuadPart - start.QuadPart) * 1000.0 / (double)frequency.QuadPart / frames;
+
+	for (std::list<ListBullet>::iterator i = bullets.begin(); i != bullets.end(); i++) {
+		delete i->collisionBox;
+	}
+	bullets.clear();
+
+	smh->patternEmitter->setTestMode(true);
+	for (int volley = 0; volley < volleys; volley++) {
+		smh->patternEmitter->fire(&benchmarkRing, this, smh->player->x, smh->player->y, volley * 0.05);
+	}
+
+	QueryPerformanceCounter(&start);
+	for (int n = 0; n < frames; n++) {
+		smh->patternEmitter->update(dt);
+	}
+	QueryPerformanceCounter(&end);
+	double emitterMs = (double)(end.QuadPart - start.QuadPart) * 1000.0 / (double)frequency.QuadPart / frames;
+
+	smh->patternEmitter->clear(this);
+	smh->patternEmitter->setTestMode(false);
+
+	smh->logger->write(LogLevels::Info, LogCategories::Profiler,
+		"Bullet pattern benchmark: %d bullets, %d frames, %.3f ms per frame in a list, %.3f ms per frame in the emitter, %.2fx",
+		volleys * BULLET_BENCHMARK_RING, frames, listMs, emitterMs, emitterMs > 0.0 ? listMs / emitterMs : 0.0);
+
+}
+
 void Console::write(std::string text, int toggled) {
 	std::string toggledString;
 	if (toggled == YES) toggledString = "Y";
@@ -216,4 +833,51 @@ void Console::write(std::string text, int toggled) {
 	else toggledString = "CUNT";
 	smh->resources->GetFont("consoleFnt")->printf(15, 150 + lineNum*25, HGETEXT_LEFT, "%s%s", text.c_str(), toggledString.c_str());
 	lineNum++;
-}
\ No newline at end of file
+}
+
+/**
+ * Times the worm trail with the most smilelets that can follow Smiley reading it
+ * while he sprints around in a square, the way SmileletManager does every frame.
+ */
+void Console::runWormBenchmark() {
+
+	int frames = smh->hge->Ini_GetInt("Debug", "wormBenchmarkFrames", DEFAULT_WORM_BENCHMARK_FRAMES);
+
+	Worm *worm = new Worm(0, 0);
+	int x = 32, y = 32;
+	int checksum = 0;
+
+	LARGE_INTEGER frequency, start, end;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&start);
+
+	for (int n = 0; n < frames; n++) {
+
+		//Run around a 9 square wide loop, cutting the corners diagonally
+		int side = (n / 64) % 4;
+		if (side == 0) x += WORM_BENCHMARK_SPEED;
+		else if (side == 1) y += WORM_BENCHMARK_SPEED;
+		else if (side == 2) x -= WORM_BENCHMARK_SPEED;
+		else y -= WORM_BENCHMARK_SPEED;
+		if (n % 64 == 63) {
+			x += (side == 0 || side == 3) ? 2 : -2;
+			y += (side == 0 || side == 1) ? 2 : -2;
+		}
+
+		worm->addWormTrail(x, y);
+		for (int i = 0; i < WORM_BENCHMARK_SMILELETS; i++) {
+			WormNode node = worm->getNode((i+1)*60);
+			checksum += node.x + node.y + node.dir;
+		}
+	}
+
+	QueryPerformanceCounter(&end);
+	double ms = (double)(end.QuadPart - start.QuadPart) * 1000.0 / (double)frequency.QuadPart;
+
+	smh->logger->write(LogLevels::Info, LogCategories::Profiler,
+		"Worm benchmark: %d smilelets, %d frames, %.5f ms per frame (checksum %d)",
+		WORM_BENCHMARK_SMILELETS, frames, frames > 0 ? ms / frames : 0.0, checksum);
+
+	delete worm;
+
+}
@@ -141,7 +141,7 @@ void CreditsScreen::drawCreditsItem(float x, float y, hgeSprite *graphic, std::s
 	}
 
 	graphic->Render(intX, intY);
-	smh->resources->GetFont("curlz")->printf(intX, intY + graphic->GetHeight()/2.0 + 20.0, HGETEXT_CENTER, name.c_str());
+	smh->textLayoutCache->print(smh->resources->GetFont("curlz"), intX, intY + graphic->GetHeight()/2.0 + 20.0, HGETEXT_CENTER, name.c_str());
 }
 
 /**
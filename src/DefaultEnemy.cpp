@@ -23,7 +23,7 @@ DefaultEnemy::~DefaultEnemy() {
 }
 
 void DefaultEnemy::draw(float dt) {
-	graphic[facing]->Render(screenX, screenY);
+	smh->spriteBatch->render(graphic[facing], screenX, screenY);
 }
 
 /** 
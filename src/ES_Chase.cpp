@@ -26,7 +26,7 @@ void ES_Chase::update(float dt) {
 
 	//If there is an unobstructed straight line to the player just
 	//run straight towards him
-	if (smh->environment->validPath(owner->x, owner->y, smh->player->x, smh->player->y, 32, owner->canPass)) {
+	if (owner->hasClearPathToPlayer(32)) {
 
 		float angle = Util::getAngleBetween(owner->x, owner->y, smh->player->x, smh->player->y) + adjustAngle;
 		owner->dx = owner->speed * cos(angle);
@@ -22,9 +22,9 @@ void ES_RangedAttack::update(float dt) {
 	if (!owner->frozen && !owner->stunned && !smh->player->isInvisible() &&
 		smh->getGameTime() - owner->rangedAttackDelay > owner->lastRangedAttack) {
 			owner->lastRangedAttack = smh->getGameTime();
-			smh->projectileManager->addProjectile(owner->x, owner->y - owner->projectileYOffset, owner->projectileSpeed, 
+			owner->fireProjectile(owner->x, owner->y - owner->projectileYOffset, owner->projectileSpeed, 
 				Util::getAngleBetween(owner->x, owner->y - owner->projectileYOffset, smh->player->x, smh->player->y), 
-				owner->projectileDamage, true,owner->projectileHoming, owner->rangedType, true);
+				owner->projectileDamage, owner->projectileHoming, owner->rangedType);
 	}
 
 	//Face the player
@@ -135,16 +135,16 @@ int ES_Wander::getNewDirection() {
 	while (!newDirFound) {
 		newDir = smh->randomInt(minDir, maxDir);
 		if (newDir == WANDER_LEFT) {
-			collision = smh->environment->collision[owner->gridX-1][owner->gridY];
+			collision = smh->environment->collision(owner->gridX-1, owner->gridY);
 		} else if (newDir == WANDER_RIGHT) {
-			collision = smh->environment->collision[owner->gridX+1][owner->gridY];
+			collision = smh->environment->collision(owner->gridX+1, owner->gridY);
 		} else if (newDir == WANDER_UP) {
-			collision = smh->environment->collision[owner->gridX][owner->gridY-1];
+			collision = smh->environment->collision(owner->gridX, owner->gridY-1);
 		} else if (newDir == WANDER_DOWN) {
-			collision = smh->environment->collision[owner->gridX][owner->gridY+1];
+			collision = smh->environment->collision(owner->gridX, owner->gridY+1);
 		} else {
-			collision = smh->environment->collision[owner->gridX][owner->gridY];
-			smh->log("ES_Wander.cpp. Enemy did not set a wander direction.");
+			collision = smh->environment->collision(owner->gridX, owner->gridY);
+			smh->logger->write(LogLevels::Warning, LogCategories::Enemies, "ES_Wander.cpp. Enemy did not set a wander direction.");
 		}
 		newDirFound = (newDir != currentAction && owner->canPass[collision]);
 		count++;
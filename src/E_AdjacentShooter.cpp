@@ -35,7 +35,7 @@ E_AdjacentShooter::~E_AdjacentShooter() {
  */
 void E_AdjacentShooter::draw(float dt) {
 	graphic[facing]->Update(dt);
-	graphic[facing]->Render(screenX, screenY);
+	smh->spriteBatch->render(graphic[facing], screenX, screenY);
 
 	if (smh->isDebugOn()) {
 		smh->drawCollisionBox(collisionBox, Colors::RED);
@@ -55,22 +55,18 @@ void E_AdjacentShooter::update(float dt) {
 		//if smiley is in same x grid
 		if (gridX == smh->player->gridX) {
 			if (smh->player->y < y) { //player is above enemy; shoot up
-				smh->projectileManager->addProjectile(x, y, projectileSpeed, 3*3.14159/2, projectileDamage,
-					true,projectileHoming, rangedType, true);
+				fireProjectile(x, y, projectileSpeed, 3*3.14159/2, projectileDamage, projectileHoming, rangedType);
 				lastRangedAttack = smh->getGameTime();
 			} else { //player is below enemy; shoot down
-				smh->projectileManager->addProjectile(x, y, projectileSpeed, 3.14159/2, projectileDamage,
-					true,projectileHoming, rangedType, true);	
+				fireProjectile(x, y, projectileSpeed, 3.14159/2, projectileDamage, projectileHoming, rangedType);	
 				lastRangedAttack = smh->getGameTime();
 			}
 		} else if (gridY == smh->player->gridY) {
 			if (smh->player->x < x) { //player is to the left
-				smh->projectileManager->addProjectile(x, y, projectileSpeed, 3.14159, projectileDamage,
-					true,projectileHoming, rangedType, true);
+				fireProjectile(x, y, projectileSpeed, 3.14159, projectileDamage, projectileHoming, rangedType);
 				lastRangedAttack = smh->getGameTime();
 			} else { //player is to the right
-				smh->projectileManager->addProjectile(x, y, projectileSpeed, 0, projectileDamage,
-					true,projectileHoming, rangedType, true);	
+				fireProjectile(x, y, projectileSpeed, 0, projectileDamage, projectileHoming, rangedType);	
 				lastRangedAttack = smh->getGameTime();
 			}
 		}
@@ -81,7 +77,7 @@ void E_AdjacentShooter::update(float dt) {
 		
 	//Collision with player
 	if (smh->player->collisionCircle->testBox(collisionBox)) {
-		smh->player->dealDamageAndKnockback(damage, true, 115, x, y);
+		damagePlayer(damage, 115, x, y);
 		std::string debugText;
 		debugText = "E_AdjacentShooter.cpp Smiley hit by enemy type " + Util::intToString(id) +
 			" at grid (" + Util::intToString(gridX) + "," + Util::intToString(gridY) +
@@ -26,10 +26,10 @@ E_BatletDist::E_BatletDist(int id, int gridX, int gridY, int groupID) {
 
 	//Don't let the player walk on the batlet cave!
 	dealsCollisionDamage = false;
-	smh->environment->collision[gridX][gridY] = UNWALKABLE;
-	smh->environment->collision[gridX][gridY-1] = UNWALKABLE;
-	smh->environment->collision[gridX+1][gridY] = UNWALKABLE;
-	smh->environment->collision[gridX+1][gridY-1] = UNWALKABLE;
+	smh->environment->collision(gridX, gridY) = UNWALKABLE;
+	smh->environment->collision(gridX, gridY-1) = UNWALKABLE;
+	smh->environment->collision(gridX+1, gridY) = UNWALKABLE;
+	smh->environment->collision(gridX+1, gridY-1) = UNWALKABLE;
 
 	immuneToStun = true;
 	activated = false;
@@ -157,7 +157,7 @@ void E_BatletDist::updateBatlets(float dt) {
 
 		//Check for collision with Smiley
 		if (smh->player->collisionCircle->testBox(i->collisionBox)) {
-			smh->player->dealDamage(BATLET_DAMAGE, true);
+			damagePlayer(BATLET_DAMAGE);
 			smh->setDebugText("Smiley hit by batlet E_BatletDist.cpp");
 			collision = true;
 		}
@@ -171,7 +171,7 @@ void E_BatletDist::updateBatlets(float dt) {
 		
 		if (collision) {
 			particles->SpawnPS(&smh->resources->GetParticleSystem("bloodSplat")->info, i->x, i->y);
-			smh->soundManager->playSound("snd_splat");
+			playSound("snd_splat");
 			delete i->collisionBox;
 			delete i->animation;
 			i = theBatlets.erase(i);
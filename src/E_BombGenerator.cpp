@@ -39,7 +39,7 @@ E_BombGenerator::E_BombGenerator(int id, int x, int y, int groupID) {
 	bombSize = 0.1;
 
 	dealsCollisionDamage = false;
-	smh->environment->collision[gridX][gridY] = UNWALKABLE;
+	smh->environment->collision(gridX, gridY) = UNWALKABLE;
 
 }
 
@@ -58,10 +58,10 @@ void E_BombGenerator::draw(float dt) {
 
 	//Render the bomb
 	if (bombState == BOMB_GENERATOR_BOMB_APPEAR) {
-		graphic[facing]->RenderEx(smh->getScreenX(bomb.x),smh->getScreenY(bomb.y),0,bombSize,bombSize);			
+		smh->spriteBatch->renderEx(graphic[facing], smh->getScreenX(bomb.x),smh->getScreenY(bomb.y),0,bombSize,bombSize);			
 	} else if (bombState >= BOMB_GENERATOR_CLOSE_DOOR && bombState <= BOMB_GENERATOR_BOMB_WALKING) {
 		smh->resources->GetSprite("bombRedCircle")->Render(smh->getScreenX(bomb.x),smh->getScreenY(bomb.y));
-		graphic[facing]->Render(smh->getScreenX(bomb.x),smh->getScreenY(bomb.y));			
+		smh->spriteBatch->render(graphic[facing], smh->getScreenX(bomb.x),smh->getScreenY(bomb.y));			
 		moveFuseParticle();
 		smh->resources->GetParticleSystem("bombFuse")->Update(dt);
 		smh->resources->GetParticleSystem("bombFuse")->Render();
@@ -100,8 +100,8 @@ void E_BombGenerator::moveFuseParticle() {
 void E_BombGenerator::update(float dt) {
 
 	if (bombState == BOMB_GENERATOR_WAITING) {
-		if (smh->environment->collision[int(smh->player->x/64)][int(smh->player->y/64)] == BOMB_PAD_UP || smh->environment->collision[int(smh->player->x/64)][int(smh->player->y/64)] == BOMB_PAD_DOWN) {
-			if (smh->environment->ids[int(smh->player->x/64)][int(smh->player->y)/64] == smh->environment->ids[int(x/64)][int(y/64)]) {
+		if (smh->environment->collision(int(smh->player->x/64), int(smh->player->y/64)) == BOMB_PAD_UP || smh->environment->collision(int(smh->player->x/64), int(smh->player->y/64)) == BOMB_PAD_DOWN) {
+			if (smh->environment->ids(int(smh->player->x/64), int(smh->player->y)/64) == smh->environment->ids(int(x/64), int(y/64))) {
 
 				bombSpawnAnimation->Play();
 				bombState=BOMB_GENERATOR_OPEN_DOOR;
@@ -142,7 +142,7 @@ void E_BombGenerator::update(float dt) {
 		
 		//Modifier makes it so the Bomb walks faster when Smiley is on a silly pad
 		float modifier = 1.0;
-		if (smh->environment->collision[smh->player->gridX][smh->player->gridY] == WALK_BOMB_SPEED_PAD) modifier = 2.0;
+		if (smh->environment->collision(smh->player->gridX, smh->player->gridY) == WALK_BOMB_SPEED_PAD) modifier = 2.0;
 		
 		switch(facing) {
 			case UP:
@@ -214,7 +214,7 @@ void E_BombGenerator::checkNextTileAndTurn() {
 	};
 
 	if (!smh->environment->isInBounds(xTileNext,yTileNext) ||
-		!canPass[smh->environment->collision[xTileNext][yTileNext]] || 
+		!canPass[smh->environment->collision(xTileNext, yTileNext)] || 
 		smh->environment->hasSillyPad(xTileNext, yTileNext)) {
 		//turn left!
 
@@ -36,7 +36,7 @@ E_Botonoid::~E_Botonoid() {
  */
 void E_Botonoid::draw(float dt) {
 	graphic[facing]->Update(dt);
-	graphic[facing]->Render(screenX, screenY);
+	smh->spriteBatch->render(graphic[facing], screenX, screenY);
 	
 	if (smh->isDebugOn()) {
 		smh->drawCollisionBox(collisionBox, Colors::RED);
@@ -54,8 +54,7 @@ void E_Botonoid::update(float dt) {
 			if (smh->randomFloat(0,1.00) <= dt && !frozen) {
 				//fire a projectile
 				if (hasRangedAttack) {
-					smh->projectileManager->addProjectile(x, y, projectileSpeed, smh->randomFloat(0,2*3.14159), projectileDamage,
-						true,projectileHoming, rangedType, true);
+					fireProjectile(x, y, projectileSpeed, smh->randomFloat(0,2*3.14159), projectileDamage, projectileHoming, rangedType);
 					lastRangedAttack = smh->getGameTime();
 				}
 			}
@@ -65,7 +64,7 @@ void E_Botonoid::update(float dt) {
 		
 	//Collision with player
 	if (smh->player->collisionCircle->testBox(collisionBox)) {
-		smh->player->dealDamageAndKnockback(damage, true, 115, x, y);
+		damagePlayer(damage, 115, x, y);
 		std::string debugText;
 		debugText = "E_Botonoid.cpp Smiley hit by enemy type " + Util::intToString(id) +
 			" at grid (" + Util::intToString(gridX) + "," + Util::intToString(gridY) +
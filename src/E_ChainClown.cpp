@@ -38,7 +38,7 @@ void E_ChainClown::draw(float dt)
 	float angle=0.0;
 	if (facing==0 || facing == 3) angle=3*PI/2;
 
-	graphic[facing]->Render(screenX,screenY);
+	smh->spriteBatch->render(graphic[facing], screenX,screenY);
 
 	//Draw dots of the chain
 	double xChain,yChain;
@@ -84,7 +84,7 @@ void E_ChainClown::update(float dt)
 	yClown += yClownVel*dt;
 
 	if (Util::distance(xClown, yClown, smh->player->x, smh->player->y) <= CLOWN_RADIUS + smh->player->collisionCircle->radius) {
-		smh->player->dealDamageAndKnockback(damage,true,100,xClown,yClown);
+		damagePlayer(damage,100,xClown,yClown);
 		xClownVel=-xClownVel;
 		yClownVel=-yClownVel;
 		smh->setDebugText("Smiley hit by evil clown's clown head, E_ChainClown.cpp");
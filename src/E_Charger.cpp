@@ -46,7 +46,7 @@ E_Charger::~E_Charger() {
  * Draws the charging enemy. Called every frame automatically by the framework.
  */
 void E_Charger::draw(float dt) {
-	graphic[facing]->Render(screenX, screenY);
+	smh->spriteBatch->render(graphic[facing], screenX, screenY);
 }
 
 /**
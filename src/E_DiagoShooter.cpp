@@ -51,7 +51,7 @@ E_DiagoShooter::~E_DiagoShooter() {
  */
 void E_DiagoShooter::draw(float dt) {
 	graphic[facing]->Update(dt);
-	graphic[facing]->Render(screenX, screenY);
+	smh->spriteBatch->render(graphic[facing], screenX, screenY);
 
 	if (smh->isDebugOn()) {
 		smh->drawCollisionBox(collisionBox, Colors::RED);
@@ -110,8 +110,7 @@ void E_DiagoShooter::update(float dt) {
 			
 			setFacingPlayer();
 			
-			smh->projectileManager->addProjectile(x, y, projectileSpeed, shootAngle, projectileDamage,
-					true,projectileHoming, rangedType, true);
+			fireProjectile(x, y, projectileSpeed, shootAngle, projectileDamage, projectileHoming, rangedType);
 
 			lastRangedAttack = smh->getGameTime();
 		}
@@ -236,14 +235,14 @@ void E_DiagoShooter::findFourDestinations() {
 		shootAngle = DOWN_RIGHT_ANGLE;
         xOffset = i - gridI*64; yOffset = j - gridJ*64;		
 
-		if (!foundUpLeft && smh->environment->isInBounds(gridI,gridJ) && canPass[smh->environment->collision[gridI][gridJ]] && canShootPlayer(i,j,shootAngle)) {
+		if (!foundUpLeft && smh->environment->isInBounds(gridI,gridJ) && canPass[smh->environment->collision(gridI, gridJ)] && canShootPlayer(i,j,shootAngle)) {
 			foundUpLeft = true;
 
 			//It is possible that this point is non-ideal in that the cone cannot fit here (b/c it's hanging over the edge onto a collision square).
 			//These next few lines try to fix that by setting found=false
-			if (xOffset <= radius && smh->environment->isInBounds(gridI-1,gridJ) && !canPass[smh->environment->collision[gridI-1][gridJ]]) foundUpLeft = false;
-			if (yOffset <= radius && smh->environment->isInBounds(gridI,gridJ-1) && !canPass[smh->environment->collision[gridI][gridJ-1]]) foundUpLeft = false;
-			if (xOffset <= radius && yOffset <= radius && smh->environment->isInBounds(gridI-1,gridJ-1) && !canPass[smh->environment->collision[gridI-1][gridJ-1]]) foundUpLeft = false;
+			if (xOffset <= radius && smh->environment->isInBounds(gridI-1,gridJ) && !canPass[smh->environment->collision(gridI-1, gridJ)]) foundUpLeft = false;
+			if (yOffset <= radius && smh->environment->isInBounds(gridI,gridJ-1) && !canPass[smh->environment->collision(gridI, gridJ-1)]) foundUpLeft = false;
+			if (xOffset <= radius && yOffset <= radius && smh->environment->isInBounds(gridI-1,gridJ-1) && !canPass[smh->environment->collision(gridI-1, gridJ-1)]) foundUpLeft = false;
 
 			//Multiple cones tend to go one on top of another. So if this spot is intersecting a cone, choose a new spot
 			hgeRect collisionRect; collisionRect.x1 = i - radius/2; collisionRect.x2 = i + radius/2; collisionRect.y1 = j - radius/2; collisionRect.y2 = j + radius/2;
@@ -263,14 +262,14 @@ void E_DiagoShooter::findFourDestinations() {
 		shootAngle = DOWN_LEFT_ANGLE;
 		xOffset = i - gridI*64; yOffset = j - gridJ*64;
 
-		if (!foundUpRight && smh->environment->isInBounds(gridI,gridJ) && canPass[smh->environment->collision[gridI][gridJ]] && canShootPlayer(i,j,shootAngle)) {
+		if (!foundUpRight && smh->environment->isInBounds(gridI,gridJ) && canPass[smh->environment->collision(gridI, gridJ)] && canShootPlayer(i,j,shootAngle)) {
 			foundUpRight = true;
 			
 			//It is possible that this point is non-ideal in that the cone cannot fit here (b/c it's hanging over the edge onto a collision square).
 			//These next few lines try to fix that by setting found=false
-			if (xOffset >= 64-radius && smh->environment->isInBounds(gridI+1,gridJ) && !canPass[smh->environment->collision[gridI+1][gridJ]]) foundUpRight = false;
-			if (yOffset <= radius && smh->environment->isInBounds(gridI,gridJ-1) && !canPass[smh->environment->collision[gridI][gridJ-1]]) foundUpRight = false;
-			if (xOffset >= 64-radius && yOffset <= radius && smh->environment->isInBounds(gridI+1,gridJ-1) && !canPass[smh->environment->collision[gridI+1][gridJ-1]]) foundUpRight = false;
+			if (xOffset >= 64-radius && smh->environment->isInBounds(gridI+1,gridJ) && !canPass[smh->environment->collision(gridI+1, gridJ)]) foundUpRight = false;
+			if (yOffset <= radius && smh->environment->isInBounds(gridI,gridJ-1) && !canPass[smh->environment->collision(gridI, gridJ-1)]) foundUpRight = false;
+			if (xOffset >= 64-radius && yOffset <= radius && smh->environment->isInBounds(gridI+1,gridJ-1) && !canPass[smh->environment->collision(gridI+1, gridJ-1)]) foundUpRight = false;
 
 			//Multiple cones tend to go one on top of another. So if this spot is intersecting a cone, choose a new spot
 			hgeRect collisionRect; collisionRect.x1 = i - radius/2; collisionRect.x2 = i + radius/2; collisionRect.y1 = j - radius/2; collisionRect.y2 = j + radius/2;
@@ -290,14 +289,14 @@ void E_DiagoShooter::findFourDestinations() {
 		shootAngle = UP_RIGHT_ANGLE;
 		xOffset = i - gridI*64; yOffset = j - gridJ*64;
 
-		if (!foundDownLeft && smh->environment->isInBounds(gridI,gridJ) && canPass[smh->environment->collision[gridI][gridJ]] && canShootPlayer(i,j,shootAngle)) {
+		if (!foundDownLeft && smh->environment->isInBounds(gridI,gridJ) && canPass[smh->environment->collision(gridI, gridJ)] && canShootPlayer(i,j,shootAngle)) {
 			foundDownLeft = true;
 			
 			//It is possible that this point is non-ideal in that the cone cannot fit here (b/c it's hanging over the edge onto a collision square).
 			//These next few lines try to fix that by setting found=false
-			if (xOffset <= radius && smh->environment->isInBounds(gridI-1,gridJ) && !canPass[smh->environment->collision[gridI-1][gridJ]]) foundDownLeft = false;
-			if (yOffset >= 64-radius && smh->environment->isInBounds(gridI,gridJ+1) && !canPass[smh->environment->collision[gridI][gridJ+1]]) foundDownLeft = false;
-			if (xOffset <= radius && yOffset >= 64-radius && smh->environment->isInBounds(gridI-1,gridJ+1) && !canPass[smh->environment->collision[gridI-1][gridJ+1]]) foundDownLeft = false;
+			if (xOffset <= radius && smh->environment->isInBounds(gridI-1,gridJ) && !canPass[smh->environment->collision(gridI-1, gridJ)]) foundDownLeft = false;
+			if (yOffset >= 64-radius && smh->environment->isInBounds(gridI,gridJ+1) && !canPass[smh->environment->collision(gridI, gridJ+1)]) foundDownLeft = false;
+			if (xOffset <= radius && yOffset >= 64-radius && smh->environment->isInBounds(gridI-1,gridJ+1) && !canPass[smh->environment->collision(gridI-1, gridJ+1)]) foundDownLeft = false;
 
 			//Multiple cones tend to go one on top of another. So if this spot is intersecting a cone, choose a new spot
 			hgeRect collisionRect; collisionRect.x1 = i - radius/2; collisionRect.x2 = i + radius/2; collisionRect.y1 = j - radius/2; collisionRect.y2 = j + radius/2;
@@ -317,14 +316,14 @@ void E_DiagoShooter::findFourDestinations() {
 		shootAngle = UP_LEFT_ANGLE;
 		xOffset = i - gridI*64; yOffset = j - gridJ*64;
 
-		if (!foundDownRight && smh->environment->isInBounds(gridI,gridJ) && canPass[smh->environment->collision[gridI][gridJ]] && canShootPlayer(i,j,shootAngle)) {
+		if (!foundDownRight && smh->environment->isInBounds(gridI,gridJ) && canPass[smh->environment->collision(gridI, gridJ)] && canShootPlayer(i,j,shootAngle)) {
 			foundDownRight = true;
 
 			//It is possible that this point is non-ideal in that the cone cannot fit here (b/c it's hanging over the edge onto a collision square).
 			//These next few lines try to fix that by setting found=false
-			if (xOffset >= 64-radius && smh->environment->isInBounds(gridI+1,gridJ) && !canPass[smh->environment->collision[gridI+1][gridJ]]) foundDownRight = false;
-			if (yOffset >= 64-radius && smh->environment->isInBounds(gridI,gridJ+1) && !canPass[smh->environment->collision[gridI][gridJ+1]]) foundDownRight = false;
-			if (xOffset >= 64-radius && yOffset >= 64-radius && smh->environment->isInBounds(gridI+1,gridJ+1) && !canPass[smh->environment->collision[gridI+1][gridJ+1]]) foundDownRight = false;
+			if (xOffset >= 64-radius && smh->environment->isInBounds(gridI+1,gridJ) && !canPass[smh->environment->collision(gridI+1, gridJ)]) foundDownRight = false;
+			if (yOffset >= 64-radius && smh->environment->isInBounds(gridI,gridJ+1) && !canPass[smh->environment->collision(gridI, gridJ+1)]) foundDownRight = false;
+			if (xOffset >= 64-radius && yOffset >= 64-radius && smh->environment->isInBounds(gridI+1,gridJ+1) && !canPass[smh->environment->collision(gridI+1, gridJ+1)]) foundDownRight = false;
 
 			//Multiple cones tend to go one on top of another. So if this spot is intersecting a cone, choose a new spot
 			hgeRect collisionRect; collisionRect.x1 = i - radius/2; collisionRect.x2 = i + radius/2; collisionRect.y1 = j - radius/2; collisionRect.y2 = j + radius/2;
@@ -437,7 +436,7 @@ void E_DiagoShooter::createAStarGrid(int i, int j) {
 
 	//left
 	if (i > 0 && smh->environment->isInBounds(mapI-1,mapJ)) {
-		if (canPass[smh->environment->collision[mapI-1][mapJ]] && !smh->environment->hasSillyPad(mapI-1,mapJ)) {
+		if (canPass[smh->environment->collision(mapI-1, mapJ)] && !smh->environment->hasSillyPad(mapI-1,mapJ)) {
 			if (curNum+1 < AStarGrid[i-1][j]) {
 				AStarGrid[i-1][j] = curNum + 1;
 				createAStarGrid(i-1,j);
@@ -447,7 +446,7 @@ void E_DiagoShooter::createAStarGrid(int i, int j) {
 
 	//right
 	if (i < AStarGridSize-1 && smh->environment->isInBounds(mapI+1,mapJ)) {
-		if (canPass[smh->environment->collision[mapI+1][mapJ]] && !smh->environment->hasSillyPad(mapI+1,mapJ)) {
+		if (canPass[smh->environment->collision(mapI+1, mapJ)] && !smh->environment->hasSillyPad(mapI+1,mapJ)) {
 			if (curNum+1 < AStarGrid[i+1][j]) {
 				AStarGrid[i+1][j] = curNum + 1;
 				createAStarGrid(i+1,j);
@@ -457,7 +456,7 @@ void E_DiagoShooter::createAStarGrid(int i, int j) {
 
 	//up
 	if (j > 0 && smh->environment->isInBounds(mapI,mapJ-1)) {
-		if (canPass[smh->environment->collision[mapI][mapJ-1]] && !smh->environment->hasSillyPad(mapI,mapJ-1)) {
+		if (canPass[smh->environment->collision(mapI, mapJ-1)] && !smh->environment->hasSillyPad(mapI,mapJ-1)) {
 			if (curNum+1 < AStarGrid[i][j-1]) {
 				AStarGrid[i][j-1] = curNum + 1;
 				createAStarGrid(i,j-1);
@@ -467,7 +466,7 @@ void E_DiagoShooter::createAStarGrid(int i, int j) {
 
 	//down
 	if (j < AStarGridSize && smh->environment->isInBounds(mapI,mapJ+1)) {
-		if (canPass[smh->environment->collision[mapI][mapJ+1]] && !smh->environment->hasSillyPad(mapI,mapJ+1)) {
+		if (canPass[smh->environment->collision(mapI, mapJ+1)] && !smh->environment->hasSillyPad(mapI,mapJ+1)) {
 			if (curNum+1 < AStarGrid[i][j+1]) {
 				AStarGrid[i][j+1] = curNum + 1;
 				createAStarGrid(i,j+1);
@@ -27,7 +27,7 @@ E_EvilEye::E_EvilEye(int id, int x, int y, int groupID) {
 
 	//Set this square's collision to UNWALKABLE_PROJECTILE so that the eye's 
 	//shots don't immediately die
-	smh->environment->collision[x][y] = UNWALKABLE_PROJECTILE;
+	smh->environment->collision(x, y) = UNWALKABLE_PROJECTILE;
 
 	facing = DOWN;
 	eyeState = EYE_CLOSED;
@@ -63,9 +63,8 @@ void E_EvilEye::update(float dt) {
 	if (eyeState == EYE_OPEN) {
 		if (!smh->player->isInvisible() && smh->timePassedSince(lastAttackTime) > ATTACK_DELAY) {
 			lastAttackTime = smh->getGameTime();
-			smh->projectileManager->addProjectile(x, y, ATTACK_VELOCITY, 
-				Util::getAngleBetween(x, y, smh->player->x, smh->player->y), ATTACK_DAMAGE, 
-				true, projectileHoming,PROJECTILE_1, true);
+			fireProjectile(x, y, ATTACK_VELOCITY, 
+				Util::getAngleBetween(x, y, smh->player->x, smh->player->y), ATTACK_DAMAGE, projectileHoming,PROJECTILE_1);
 		}
 	}
 
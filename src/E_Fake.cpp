@@ -28,7 +28,7 @@ E_Fake::~E_Fake() {
 }
 
 void E_Fake::draw(float dt) {
-	graphic[facing]->Render(screenX, screenY);
+	smh->spriteBatch->render(graphic[facing], screenX, screenY);
 }
 
 /** 
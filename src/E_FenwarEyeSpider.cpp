@@ -50,7 +50,7 @@ E_FenwarEyeSpider::E_FenwarEyeSpider(int id, int x, int y, int groupID) {
 
 	figureOutPosition(); //where are we in the "tic-tac-toe board" of Hoverpads?
 
-	canPass[PIT] = true;
+	canPass.set(PIT, true);
 }
 
 /**
@@ -107,7 +107,7 @@ void E_FenwarEyeSpider::update(float dt) {
 
 	move(dt);
 
-	if (!hopping && smh->environment->collision[gridX][gridY] == PIT) { //fall to doom
+	if (!hopping && smh->environment->collision(gridX, gridY) == PIT) { //fall to doom
 		falling = true;
 		beganFalling = smh->getGameTime();
 		fallingRot=0.0;
@@ -120,7 +120,7 @@ void E_FenwarEyeSpider::update(float dt) {
 void E_FenwarEyeSpider::draw(float dt) {
 	int i;
 
-	if (smh->environment->collision[gridX][gridY] != PIT) smh->resources->GetSprite("playerShadow")->Render(screenX, screenY + 32.0);
+	if (smh->environment->collision(gridX, gridY) != PIT) smh->resources->GetSprite("playerShadow")->Render(screenX, screenY + 32.0);
 
 	if (falling) {
 			graphic[0]->RenderEx(screenX,screenY,fallingRot,fallingScale,fallingScale);
@@ -137,7 +137,7 @@ void E_FenwarEyeSpider::draw(float dt) {
 		}
 
 		//Render the graphic
-		graphic[facing]->Render(screenX, screenY - hopYOffset);
+		smh->spriteBatch->render(graphic[facing], screenX, screenY - hopYOffset);
 	} //not falling
 }
 
@@ -160,7 +160,7 @@ void E_Flailer::updateFlail(float dt) {
 	//Check flail collision - it only hurts the player when it is swinging!
 	if (flailing) {
 		if (Util::distance(flailX, flailY, smh->player->x, smh->player->y) <= FLAIL_RADIUS + smh->player->collisionCircle->radius) {	
-			smh->player->dealDamageAndKnockback(damage,true,100,flailX,flailY);
+			damagePlayer(damage,100,flailX,flailY);
 			std::string debugText;
 			debugText = "Smiley hit by flail belonging to enemy type " + Util::intToString(id);
 			smh->setDebugText(debugText);
@@ -223,7 +223,7 @@ void E_Flailer::endFlail() {
 void E_Flailer::draw(float dt) {
 
 	//Draw enemy
-	graphic[facing]->Render(screenX, screenY);
+	smh->spriteBatch->render(graphic[facing], screenX, screenY);
 
 	//Draw flail chain
 	for (int i = 0; i < NUM_CHAIN_LINKS; i++) {
@@ -320,7 +320,7 @@ void E_Flailer::doFlailEllipse()
 		
 		if ((abs(x - smh->player->x) <= 64*8) &&
 			(abs(y - smh->player->y) <= 64*6))
-		smh->soundManager->playSound("snd_flailSwoosh");
+		playSound("snd_flailSwoosh");
 	}
 	
 }
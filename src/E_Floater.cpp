@@ -78,7 +78,7 @@ void E_Floater::update(float dt) {
 		
 	//Collision with player
 	if (smh->player->collisionCircle->testBox(collisionBox)) {
-		smh->player->dealDamageAndKnockback(damage, true, 115, x, y);
+		damagePlayer(damage, 115, x, y);
 		std::string debugText;
 		debugText = "E_Floater.cpp Smiley hit by enemy type " + Util::intToString(id) +
 			" at grid (" + Util::intToString(gridX) + "," + Util::intToString(gridY) +
@@ -107,7 +107,7 @@ void E_Floater::update(float dt) {
 void E_Floater::draw(float dt) {
 	
 	graphic[facing]->Update(dt);
-	graphic[facing]->Render(screenX, screenY - shadowOffset);
+	smh->spriteBatch->render(graphic[facing], screenX, screenY - shadowOffset);
 	smh->resources->GetSprite("playerShadow")->Render(screenX, screenY);
 
 	if (smh->isDebugOn()) {
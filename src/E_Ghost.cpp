@@ -42,7 +42,7 @@ void E_Ghost::update(float dt) {
 		
 	//Collision with player - this is implemented
 	if (smh->player->collisionCircle->testBox(collisionBox)) {
-		smh->player->dealDamageAndKnockback(damage, true, 115, x, y);
+		damagePlayer(damage, 115, x, y);
 		std::string debugText;
 		debugText = "E_Ghost.cpp Smiley hit by enemy type " + Util::intToString(id) +
 			" at grid (" + Util::intToString(gridX) + "," + Util::intToString(gridY) +
@@ -65,7 +65,7 @@ void E_Ghost::draw(float dt) {
 
 	graphic[facing]->Update(dt);
 	graphic[facing]->SetColor(ARGB(alpha,255,255,255));
-	graphic[facing]->Render(screenX, screenY - shadowOffset);
+	smh->spriteBatch->render(graphic[facing], screenX, screenY - shadowOffset);
 
 	smh->resources->GetSprite("playerShadow")->SetColor(ARGB((alpha/255.0) * 75.0, 255,255,255));
 	smh->resources->GetSprite("playerShadow")->Render(screenX, screenY);
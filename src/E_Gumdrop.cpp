@@ -46,7 +46,7 @@ E_Gumdrop::~E_Gumdrop() {
 void E_Gumdrop::draw(float dt) {
 
 	if (burrowState == GUMDROP_UNBURROWED) {
-		graphic[facing]->Render(screenX, screenY);
+		smh->spriteBatch->render(graphic[facing], screenX, screenY);
 	} else {
 		burrowAnimation->Render(screenX, screenY);
 	}
@@ -72,9 +72,8 @@ void E_Gumdrop::update(float dt) {
 			//Shoot at smiley
 			if (!smh->player->isInvisible() && smh->timePassedSince(lastAttackTime) > rangedAttackDelay) {
 				lastAttackTime = smh->getGameTime();
-				smh->projectileManager->addProjectile(x, y, projectileSpeed, 
-					Util::getAngleBetween(x, y, smh->player->x, smh->player->y), projectileDamage, 
-					true,projectileHoming, rangedType, true);
+				fireProjectile(x, y, projectileSpeed, 
+					Util::getAngleBetween(x, y, smh->player->x, smh->player->y), projectileDamage, projectileHoming, rangedType);
 			}
 
 		} else {
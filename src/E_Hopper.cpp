@@ -47,7 +47,7 @@ void E_Hopper::update(float dt)
 		
 		if (Util::distance(x, y, smh->player->x, smh->player->y) < 500)
 		{
-			smh->soundManager->playSound("snd_Hopping");
+			playSound("snd_Hopping");
 		}
 
 		if (chases) 
@@ -128,7 +128,7 @@ void E_Hopper::draw(float dt)
 		}
 
 		//Render the graphic
-		graphic[facing]->Render(screenX, screenY - hopYOffset);
+		smh->spriteBatch->render(graphic[facing], screenX, screenY - hopYOffset);
 	}
 }
 
@@ -158,7 +158,7 @@ void E_Hopper::drawAfterSmiley(float dt) {
 		}
 
 		//Render the graphic
-		graphic[facing]->Render(screenX, screenY - hopYOffset);
+		smh->spriteBatch->render(graphic[facing], screenX, screenY - hopYOffset);
 	}
 }
 
@@ -27,7 +27,7 @@ E_Ranged::~E_Ranged() {
 }
 
 void E_Ranged::draw(float dt) {
-	graphic[facing]->Render(screenX, screenY);
+	smh->spriteBatch->render(graphic[facing], screenX, screenY);
 }
 
 /** 
@@ -45,9 +45,9 @@ void E_Ranged::update(float dt) {
 			//Fire ranged weapon
 			if (!frozen && !stunned && !smh->player->isInvisible()) {		
 				shotYet = true;
-				smh->projectileManager->addProjectile(x, y, projectileSpeed, 
+				fireProjectile(x, y, projectileSpeed, 
 					Util::getAngleBetween(x, y, smh->player->x, smh->player->y), 
-					projectileDamage, true,projectileHoming, rangedType, true);
+					projectileDamage, projectileHoming, rangedType);
 			}
 		}
 
@@ -85,7 +85,7 @@ void E_SadShooter::update(float dt) {
 		sadBlockers[i].y = y + sadBlockers[i].distance*sin(sadBlockers[i].angle);
 
 		if (Util::distance(sadBlockers[i].x,sadBlockers[i].y,smh->player->x,smh->player->y) <= BLOCKER_RADIUS + smh->player->collisionCircle->radius) {
-			smh->player->dealDamageAndKnockback(damage,true,100,sadBlockers[i].x,sadBlockers[i].y);	
+			damagePlayer(damage,100,sadBlockers[i].x,sadBlockers[i].y);	
 			smh->setDebugText("Smiley hit by a Sad Blocker");
 		}
 
@@ -57,7 +57,7 @@ E_Spawner::~E_Spawner() {
 void E_Spawner::draw(float dt) {
 	
 	graphic[facing]->Update(dt);
-	graphic[facing]->Render(screenX, screenY - shadowOffset);
+	smh->spriteBatch->render(graphic[facing], screenX, screenY - shadowOffset);
 	smh->resources->GetSprite("playerShadow")->Render(screenX, screenY);
 
 	if (smh->isDebugOn()) {
@@ -115,7 +115,7 @@ void E_Spawner::update(float dt) {
 		
 	//Collision with player
 	if (smh->player->collisionCircle->testBox(collisionBox)) {
-		smh->player->dealDamageAndKnockback(damage, true, 115, x, y);
+		damagePlayer(damage, 115, x, y);
 		std::string debugText;
 		debugText = "E_Spawner.cpp Smiley hit by enemy type " + Util::intToString(id) +
 			" at grid (" + Util::intToString(gridX) + "," + Util::intToString(gridY) +
@@ -167,7 +167,7 @@ void E_Spawner::spawnEnemy() {
 	debugText = "E_Spawner.cpp spawns enemy.";
 	smh->setDebugText(debugText);
 
-	smh->hge->System_Log("Group ID program E_Spawner.cpp %d", groupID);
+	LOG_DEBUG(LogCategories::Enemies, "Group ID program E_Spawner.cpp %d", groupID);
 }
 
 
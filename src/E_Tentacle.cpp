@@ -102,7 +102,7 @@ void E_Tentacle::update(float dt) {
 
 		//Collision with smiley
 		if (Util::distance(tentacleNodes[i].position.x,tentacleNodes[i].position.y,smh->player->x,smh->player->y) <= radius + smh->player->collisionCircle->radius) {
-			smh->player->dealDamageAndKnockback(damage,true,100,tentacleNodes[i].position.x,tentacleNodes[i].position.y);			
+			damagePlayer(damage,100,tentacleNodes[i].position.x,tentacleNodes[i].position.y);			
 			smh->setDebugText("Smiley hit by a tentacle");
 		}		
 
@@ -111,7 +111,7 @@ void E_Tentacle::update(float dt) {
 	//Growl, if variable > 10 (ensuring it's a large and not a small tentacle
 	if (smh->timePassedSince(timeOfLastGrowl) >= TIME_BETWEEN_GROWLS && variable1 >= 10 && distanceFromPlayer() <= GROWL_DISTANCE) {
 		timeOfLastGrowl = smh->getGameTime();
-		smh->soundManager->playSound("snd_fireWorm");
+		playSound("snd_fireWorm");
 	}
 }
 
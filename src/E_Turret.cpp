@@ -15,7 +15,7 @@ E_Turret::E_Turret(int id, int x, int y, int groupID) {
 	//Doesn't use framework states
 	currentState = NULL;
 
-	smh->environment->collision[x][y] = UNWALKABLE_PROJECTILE;
+	smh->environment->collision(x, y) = UNWALKABLE_PROJECTILE;
 
 	direction = variable2;
 	timeOfLastShot=smh->getGameTime();
@@ -76,7 +76,7 @@ void E_Turret::update(float dt) {
 				xOffset=0;
 				yOffset=0;
 		}
-		smh->projectileManager->addProjectile(xTurret+xOffset,yTurret+yOffset,projectileSpeed,angle,projectileDamage,true,projectileHoming,rangedType,true);
+		fireProjectile(xTurret+xOffset,yTurret+yOffset,projectileSpeed,angle,projectileDamage,projectileHoming,rangedType);
 	}
 
 }
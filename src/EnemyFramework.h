@@ -3,7 +3,9 @@
 
 #include <string>
 #include <list>
+#include <vector>
 #include "hgevector.h"
+#include "AreaArena.h"
 
 class hgeParticleManager;
 class Tongue;
@@ -74,6 +76,80 @@ class hgeRect;
 #define ENEMY_SPAWNSTATE_FALLING 0
 #define ENEMY_SPAWNSTATE_GROWING 1
 
+//Enemies are only thought about on the worker pool when there are at least this many
+#define MIN_PARALLEL_THINKERS 4
+
+//----------------------------------------------------------------
+//----------------------------------------------------------------
+//------------------ THINK PHASE ---------------------------------
+//----------------------------------------------------------------
+//----------------------------------------------------------------
+// Before the enemies are updated, the expensive questions they ask
+// every frame are answered for all of them at once on the worker
+// pool: the A* path to Smiley, whether there is a clear line to him
+// and whether the fire breath is touching them. The answers are
+// recorded as commands in a buffer for each worker, then applied to
+// the enemies in enemy order on the main thread. An enemy only uses
+// an answer if it asks exactly the same question during its update,
+// otherwise it works it out again, so an update does the same thing
+// whether the answers were worked out ahead of time or not.
+//----------------------------------------------------------------
+class EnemyCommands
+{
+public:
+	static const int Path = 0;			//A* towards Smiley from gridX, gridY
+	static const int Shot = 1;			//canShootPlayer() from x, y
+	static const int ClearPath = 2;		//Clear line to Smiley from x, y
+	static const int FireBreath = 3;	//Fire breath touching the collision box
+};
+
+#define NUM_ENEMY_COMMANDS 4
+
+struct EnemyCommand {
+	int enemy;							//Position in the enemy list
+	int type;
+	bool result;
+	float key[5];						//What the question was asked with
+};
+
+//Where Smiley was at the start of the frame
+struct EnemySnapshot {
+	float playerX, playerY;
+	int playerGridX, playerGridY;
+};
+
+//----------------------------------------------------------------
+//----------------------------------------------------------------
+//------------------ ENEMY EFFECTS -------------------------------
+//----------------------------------------------------------------
+//----------------------------------------------------------------
+// What enemies do to the rest of the game while they are updated:
+// firing projectiles, playing sounds, hurting Smiley and dropping
+// loot. Instead of being done straight away these are recorded as
+// effects and applied in enemy order once every enemy has had its
+// turn, so no enemy sees another's effects part way through a frame.
+//----------------------------------------------------------------
+class EnemyEffects
+{
+public:
+	static const int Projectile = 0;
+	static const int Sound = 1;
+	static const int Damage = 2;		//Hurts Smiley, knocking him away from x, y
+	static const int Loot = 3;
+};
+
+struct EnemyEffect {
+	int enemy;							//Position in the enemy list
+	int type;
+	float x, y;
+	float speed, angle;					//Projectile only
+	float damage;
+	float knockbackDist;				//Damage only
+	int id;								//Projectile or loot type
+	bool homing;
+	const char *sound;					//Always a string literal
+};
+
 //----------------------------------------------------------------
 //----------------------------------------------------------------
 //------------------ BASE CLASSES --------------------------------
@@ -83,7 +159,7 @@ class hgeRect;
 /**
  * Abstract base class for all enemy states.
  */
-class EnemyState {
+class EnemyState : public AreaObject {
 
 public:
 
@@ -103,7 +179,7 @@ public:
 /** 
  * Abstract base enemy class that all enemies extend.
  */
-class BaseEnemy {
+class BaseEnemy : public AreaObject {
 
 public:
 
@@ -154,6 +230,15 @@ public:
 	void setFacing();
 	void startFlashing();
 	void setState(EnemyState *newState);
+	bool hasClearPathToPlayer(int pathRadius);
+	void think(const EnemySnapshot &world, int index, std::vector<EnemyCommand> &commands);
+	void applyCommand(const EnemyCommand &command);
+	void setEffectBuffer(std::vector<EnemyEffect> *buffer, int index);
+	void fireProjectile(float fromX, float fromY, float speed, float angle, float projectileDamage, bool homing, int projectileId);
+	void playSound(const char *sound);
+	void damagePlayer(float amount);
+	void damagePlayer(float amount, float knockbackDist, float fromX, float fromY);
+	void dropLoot(int lootType);
 	bool isSpawning;
 
 	//Current state
@@ -170,7 +255,7 @@ public:
 
 	int groupID;
 	bool markMap[256][256];
-	bool canPass[256];
+	CollisionMask canPass;
 	int weaponRange;	
 	float screenX,screenY,speed;
 	int startX, startY;					//Starting location of the enemy
@@ -215,6 +300,24 @@ public:
 	//Graphics
 	hgeAnimation *graphic[4];
 
+private:
+
+	void recordCommand(std::vector<EnemyCommand> &commands, int index, int type, bool result, float a, float b, float c, float d, float e);
+	bool usesThought(int type, float a, float b, float c, float d, float e);
+
+	//Answers from the think phase, only good for the frame they were worked out in
+	EnemyCommand thoughts[NUM_ENEMY_COMMANDS];
+	bool hasThought[NUM_ENEMY_COMMANDS];
+
+	//What the enemy asked last frame, so it can be worked out ahead of time this frame
+	bool askedPath;
+	int askedClearPathRadius;
+
+	//Where effects are recorded during the enemy manager's update, NULL the rest of the time
+	void recordEffect(EnemyEffect &effect);
+	std::vector<EnemyEffect> *effects;
+	int effectIndex;
+
 };
 
 //----------------------------------------------------------------
@@ -266,10 +369,27 @@ public:
 
 	void playHitSoundEffect();
 
+	void think(int numWorkers);
+	const std::vector<EnemyCommand> &getCommands();
+	void setNumWorkers(int numWorkers);
+	void applyEffect(const EnemyEffect &effect);
+	const std::vector<EnemyEffect> &getEffects();
+
 private:
 
 	void killEnemy(std::list<EnemyStruct>::iterator i);
+	static void thinkJob(void *context, int job, int worker);
 	
+	//Think phase
+	EnemySnapshot snapshot;
+	std::vector<BaseEnemy*> thinkers;
+	std::vector<EnemyCommand> commandBuffers[MAX_POOL_WORKERS];
+	std::vector<EnemyCommand> commands;
+	int numWorkers;						//0 to pick from the number of enemies
+
+	//Effects from the update, in the order they are applied
+	std::vector<EnemyEffect> effects;
+
 
 };
 
@@ -279,12 +399,19 @@ private:
 //----------------------------------------------------------------
 //----------------------------------------------------------------
 
+struct EnemyGroupTile {
+	int gridX, gridY;
+};
+
 struct EnemyGroup {
 	int numEnemies;
 	bool active;
 	bool triggeredYet;
 	bool fadingIn, fadingOut;
+	bool updating;
 	float blockAlpha;
+	std::list<EnemyGroupTile> blocks;			//ENEMYGROUP_BLOCK squares for this group
+	std::list<EnemyGroupTile> popupEnemies;		//ENEMYGROUP_ENEMY_POPUP squares for this group
 };
 
 class EnemyGroupManager {
@@ -302,9 +429,17 @@ public:
 	void disableBlocks(int whichGroup);
 	void triggerGroup(int whichGroup);
 	bool isGroupDead(int whichGroup);
+	void indexTiles();
 
 	EnemyGroup groups[MAX_GROUPS];
 
+private:
+
+	void startUpdating(int whichGroup);
+
+	int updatingGroups[MAX_GROUPS];		//Groups that are fading or waiting to start fading
+	int numUpdatingGroups;
+
 };
 
 //----------------------------------------------------------------
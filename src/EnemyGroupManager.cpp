@@ -25,7 +25,35 @@ void EnemyGroupManager::resetGroups() {
 		groups[i].active = false;
 		groups[i].fadingIn = false;
 		groups[i].fadingOut = false;
+		groups[i].updating = false;
 		groups[i].blockAlpha = 0.0;
+		groups[i].blocks.clear();
+		groups[i].popupEnemies.clear();
+	}
+	numUpdatingGroups = 0;
+}
+
+/**
+ * Finds the block and popup enemy squares of each group in the current area so
+ * that triggering and clearing groups doesn't need to search the whole area.
+ * Called by loadArea.
+ */
+void EnemyGroupManager::indexTiles() {
+	for (int i = 0; i < smh->environment->areaWidth; i++) {
+		for (int j = 0; j < smh->environment->areaHeight; j++) {
+			int whichGroup = smh->environment->variable(i, j);
+			if (whichGroup < 0 || whichGroup >= MAX_GROUPS) continue;
+
+			EnemyGroupTile tile;
+			tile.gridX = i;
+			tile.gridY = j;
+
+			if (smh->environment->ids(i, j) == ENEMYGROUP_BLOCK) {
+				groups[whichGroup].blocks.push_back(tile);
+			} else if (smh->environment->ids(i, j) == ENEMYGROUP_ENEMY_POPUP && smh->environment->enemyLayer(i, j) != -1) {
+				groups[whichGroup].popupEnemies.push_back(tile);
+			}
+		}
 	}
 }
 
@@ -39,7 +67,7 @@ void EnemyGroupManager::addEnemy(int whichGroup)
 	groups[whichGroup].active = true;
 	groups[whichGroup].numEnemies++;
 
-	smh->hge->System_Log("Added to enemy group: %d", whichGroup);
+	LOG_DEBUG(LogCategories::Enemies, "Added to enemy group: %d", whichGroup);
 }
 
 /**
@@ -57,6 +85,7 @@ void EnemyGroupManager::notifyOfDeath(int whichGroup) {
 	if (groups[whichGroup].numEnemies <= 0) {
 		groups[whichGroup].fadingOut = true;
 		groups[whichGroup].fadingIn = false; //Prevents the block from both fading in and fading out at the same time, which would result in a permanent translucent block
+		startUpdating(whichGroup);
 	}
 
 }
@@ -67,7 +96,10 @@ void EnemyGroupManager::notifyOfDeath(int whichGroup) {
  */
 void EnemyGroupManager::update(float dt) {
 	
-	for (int i = 0; i < MAX_GROUPS; i++) {
+	//Only groups that are fading or might need to start fading are looked at
+	for (int n = 0; n < numUpdatingGroups; n++) {
+
+		int i = updatingGroups[n];
 
 		//Update fading in blocks
 		if (groups[i].fadingIn) {
@@ -97,12 +129,20 @@ void EnemyGroupManager::update(float dt) {
 			groups[i].fadingOut = true;;
 		}
 
+		//Stop updating the group until notifyOfDeath starts it fading out
+		if (!groups[i].fadingIn && !groups[i].fadingOut) {
+			groups[i].updating = false;
+			updatingGroups[n] = updatingGroups[numUpdatingGroups - 1];
+			numUpdatingGroups--;
+			n--;
+		}
+
 	}
 
 
 	//If the player steps on a trigger
-	if (smh->environment->ids[smh->player->gridX][smh->player->gridY] == ENEMYGROUP_TRIGGER) {
-		triggerGroup(smh->environment->variable[smh->player->gridX][smh->player->gridY]);
+	if (smh->environment->ids(smh->player->gridX, smh->player->gridY) == ENEMYGROUP_TRIGGER) {
+		triggerGroup(smh->environment->variable(smh->player->gridX, smh->player->gridY));
 	}
 
 }
@@ -117,25 +157,24 @@ void EnemyGroupManager::triggerGroup(int whichGroup) {
 
 		groups[whichGroup].triggeredYet = true;
 
-		smh->log("Triggering group");
+		LOG_DEBUG(LogCategories::Enemies, "Triggering group");
 		//Spawn enemies
-		for (int i = 0; i < smh->environment->areaWidth; i++) {
-			for (int j = 0; j < smh->environment->areaHeight; j++) {
-				if (smh->environment->enemyLayer[i][j] != -1 &&
-					smh->environment->ids[i][j] == ENEMYGROUP_ENEMY_POPUP &&
-					smh->environment->variable[i][j] == whichGroup) {
-						smh->log("---Adding enemy---");
-						smh->enemyManager->addEnemy(smh->environment->enemyLayer[i][j], i, j, 0.25, 0.25, whichGroup, false);
-						addEnemy(smh->environment->variable[i][j]);
-						smh->environment->addParticle("treeletSpawn", i*64+32, j*64+32);
-					}
-			}
+		std::list<EnemyGroupTile>::iterator tile;
+		for (tile = groups[whichGroup].popupEnemies.begin(); tile != groups[whichGroup].popupEnemies.end(); tile++) {
+			int i = tile->gridX;
+			int j = tile->gridY;
+			LOG_DEBUG(LogCategories::Enemies, "---Adding enemy---");
+			smh->enemyManager->addEnemy(smh->environment->enemyLayer(i, j), i, j, 0.25, 0.25, whichGroup, false);
+			addEnemy(whichGroup);
+			smh->environment->addParticle("treeletSpawn", i*64+32, j*64+32);
 		}
 		
 		//Spawn enemy blocks if the player hasn't already killed all the enemies
 		if (groups[whichGroup].numEnemies > 0) {
 			enableBlocks(whichGroup);
 		}
+
+		startUpdating(whichGroup);
 	}
 
 }
@@ -146,20 +185,14 @@ void EnemyGroupManager::triggerGroup(int whichGroup) {
 void EnemyGroupManager::enableBlocks(int whichGroup) {
 
 	groups[whichGroup].fadingIn = true;
-
-	for (int i = 0; i < smh->environment->areaWidth; i++) {
-		for (int j = 0; j < smh->environment->areaHeight; j++) {
-
-			//If this square is an enemy block for the triggered group
-			if (smh->environment->ids[i][j] == ENEMYGROUP_BLOCK && 
-					smh->environment->variable[i][j] == whichGroup) {
-
-				//Set stuff in the environment to make an enemy block
-				smh->environment->item[i][j] = ENEMYGROUP_BLOCKGRAPHIC;
-				smh->environment->collision[i][j] = UNWALKABLE;
-				smh->environment->addParticle("enemyBlockCloud", i*64.0+32.0, j*64.0+32.0);
-			}
-		}
+	startUpdating(whichGroup);
+
+	std::list<EnemyGroupTile>::iterator tile;
+	for (tile = groups[whichGroup].blocks.begin(); tile != groups[whichGroup].blocks.end(); tile++) {
+		//Set stuff in the environment to make an enemy block
+		smh->environment->item(tile->gridX, tile->gridY) = ENEMYGROUP_BLOCKGRAPHIC;
+		smh->environment->collision(tile->gridX, tile->gridY) = UNWALKABLE;
+		smh->environment->addParticle("enemyBlockCloud", tile->gridX*64.0+32.0, tile->gridY*64.0+32.0);
 	}
 }
 
@@ -167,14 +200,20 @@ void EnemyGroupManager::enableBlocks(int whichGroup) {
  * Disables all blocks for an enemy group.
  */
 void EnemyGroupManager::disableBlocks(int whichGroup) {
-	for (int i = 0; i < smh->environment->areaWidth; i++) {
-		for (int j = 0; j < smh->environment->areaHeight; j++) {
-			if (smh->environment->ids[i][j] == ENEMYGROUP_BLOCK && 
-					smh->environment->variable[i][j] == whichGroup) {
-				smh->environment->item[i][j] = 0;
-				smh->environment->collision[i][j] = WALKABLE;
-			}
-		}
+	std::list<EnemyGroupTile>::iterator tile;
+	for (tile = groups[whichGroup].blocks.begin(); tile != groups[whichGroup].blocks.end(); tile++) {
+		smh->environment->item(tile->gridX, tile->gridY) = 0;
+		smh->environment->collision(tile->gridX, tile->gridY) = WALKABLE;
+	}
+}
+
+/**
+ * Adds a group to the list of groups that update() looks at.
+ */
+void EnemyGroupManager::startUpdating(int whichGroup) {
+	if (!groups[whichGroup].updating) {
+		groups[whichGroup].updating = true;
+		updatingGroups[numUpdatingGroups++] = whichGroup;
 	}
 }
 
@@ -12,6 +12,8 @@
 
 #include "ExplosionManager.h"
 
+#include <algorithm>
+
 extern SMH *smh;
 
 /**
@@ -20,6 +22,7 @@ extern SMH *smh;
 EnemyManager::EnemyManager() { 
 	deathParticles = new hgeParticleManager();
 	toDrawImmunities=false;
+	numWorkers = 0;
 }
 
 /**
@@ -33,6 +36,14 @@ bool SortEnemiesPredicate(const EnemyStruct &lhs, const EnemyStruct &rhs) {
   return lhs.enemy->y < rhs.enemy->y;
 }
 
+bool SortCommandsPredicate(const EnemyCommand &lhs, const EnemyCommand &rhs) {
+	return lhs.enemy < rhs.enemy;
+}
+
+bool SortEffectsPredicate(const EnemyEffect &lhs, const EnemyEffect &rhs) {
+	return lhs.enemy < rhs.enemy;
+}
+
 
 /**
  * Add an enemy to the list
@@ -45,7 +56,7 @@ void EnemyManager::addEnemy(int id, int gridX, int gridY, float spawnHealthChanc
 	newEnemy.spawnManaChance = spawnManaChance;
 
 	//EVILK
-	smh->hge->System_Log("Spawned enemy of type %d at location %d, %d", id,gridX,gridY);
+	LOG_DEBUG(LogCategories::Enemies, "Spawned enemy of type %d at location %d, %d", id,gridX,gridY);
 
 	switch (smh->gameData->getEnemyInfo(id).enemyType) {
 		
@@ -219,25 +230,131 @@ void EnemyManager::drawAfterSmiley(float dt) {
  */
 void EnemyManager::update(float dt) {
 
+	int workers = numWorkers;
+	if (workers < 1) {
+		workers = enemyList.size() < MIN_PARALLEL_THINKERS ? 1 : smh->workerPool->getDefaultWorkers();
+	}
+
+	think(workers);
+
+	//Update the enemies, including touching Smiley. Anything they do to the rest
+	//of the game is recorded and done at the end, once they have all been updated.
+	effects.clear();
+	int index = 0;
 	std::list<EnemyStruct>::iterator i;
 	for (i = enemyList.begin(); i != enemyList.end(); i++) {
-
-		//Call the base update method for the enemy.
+		i->enemy->setEffectBuffer(&effects, index++);
 		i->enemy->baseUpdate(dt);
+	}
 
-		//If the enemy is dead
+	//Get rid of the enemies that died
+	i = enemyList.begin();
+	while (i != enemyList.end()) {
 		if (i->enemy->health <= 0.0f) {
 			killEnemy(i);
 			delete i->enemy;
 			i = enemyList.erase(i);
+		} else {
+			i++;
 		}
 	}
 
+	for (i = enemyList.begin(); i != enemyList.end(); i++) {
+		i->enemy->setEffectBuffer(NULL, 0);
+	}
+
+	//Each enemy's effects stay in the order it made them
+	std::stable_sort(effects.begin(), effects.end(), SortEffectsPredicate);
+	for (int n = 0; n < (int)effects.size(); n++) {
+		applyEffect(effects[n]);
+	}
+
 	//Sort enemies so that the rearmost overlapping enemies will be drawn last!!!
 	enemyList.sort(SortEnemiesPredicate);
 
 }
 
+/**
+ * Does one thing an enemy did to the rest of the game.
+ */
+void EnemyManager::applyEffect(const EnemyEffect &effect) {
+	if (effect.type == EnemyEffects::Projectile) {
+		smh->projectileManager->addProjectile(effect.x, effect.y, effect.speed, effect.angle, effect.damage, true, effect.homing, effect.id, true);
+	} else if (effect.type == EnemyEffects::Sound) {
+		smh->soundManager->playSound(effect.sound);
+	} else if (effect.type == EnemyEffects::Damage) {
+		smh->player->dealDamageAndKnockback(effect.damage, true, effect.knockbackDist, effect.x, effect.y);
+	} else if (effect.type == EnemyEffects::Loot) {
+		smh->lootManager->addLoot(effect.id, effect.x, effect.y, -1);
+	}
+}
+
+/**
+ * Returns the effects applied by the last update, in the order they were
+ * applied.
+ */
+const std::vector<EnemyEffect> &EnemyManager::getEffects() {
+	return effects;
+}
+
+/**
+ * Sets how many workers the enemy update uses. 0 goes back to picking from the
+ * number of enemies.
+ */
+void EnemyManager::setNumWorkers(int _numWorkers) {
+	numWorkers = _numWorkers;
+}
+
+/**
+ * Think phase. Every enemy works out the answers to what it's going to ask
+ * during its update, spread over numWorkers workers, then the commands they
+ * recorded are applied in enemy order. The order the workers get to the
+ * enemies doesn't change anything, so the enemies end up the same however many
+ * workers there are.
+ */
+void EnemyManager::think(int numWorkers) {
+
+	thinkers.clear();
+	for (std::list<EnemyStruct>::iterator i = enemyList.begin(); i != enemyList.end(); i++) {
+		thinkers.push_back(i->enemy);
+	}
+
+	snapshot.playerX = smh->player->x;
+	snapshot.playerY = smh->player->y;
+	snapshot.playerGridX = smh->player->gridX;
+	snapshot.playerGridY = smh->player->gridY;
+
+	for (int i = 0; i < MAX_POOL_WORKERS; i++) {
+		commandBuffers[i].clear();
+	}
+
+	smh->workerPool->run(thinkJob, this, (int)thinkers.size(), numWorkers);
+
+	commands.clear();
+	for (int i = 0; i < MAX_POOL_WORKERS; i++) {
+		commands.insert(commands.end(), commandBuffers[i].begin(), commandBuffers[i].end());
+	}
+	std::stable_sort(commands.begin(), commands.end(), SortCommandsPredicate);
+
+	for (int i = 0; i < (int)commands.size(); i++) {
+		thinkers[commands[i].enemy]->applyCommand(commands[i]);
+	}
+
+}
+
+void EnemyManager::thinkJob(void *context, int job, int worker) {
+	EnemyManager *manager = (EnemyManager*)context;
+	manager->thinkers[job]->think(manager->snapshot, job, manager->commandBuffers[worker]);
+}
+
+/**
+ * Returns the commands recorded by the last think phase, in the order they
+ * were applied.
+ */
+const std::vector<EnemyCommand> &EnemyManager::getCommands() {
+	return commands;
+}
+
 void EnemyManager::spawnDeathParticle(float x, float y)
 {
 	deathParticles->SpawnPS(&smh->resources->GetParticleSystem("deathCloud")->info, x, y);
@@ -254,12 +371,12 @@ void EnemyManager::killEnemy(std::list<EnemyStruct>::iterator i)
 
 	if (i->enemy->frozen) 
 	{
-		smh->soundManager->playSound("snd_iceDie");
+		i->enemy->playSound("snd_iceDie");
 	} 
 	else 
 	{
 		spawnDeathParticle(i->enemy->x, i->enemy->y);
-		smh->soundManager->playSound("snd_enemyDeath");
+		i->enemy->playSound("snd_enemyDeath");
 	}
 
 	if (smh->gameData->getEnemyInfo(i->enemy->id).enemyType == ENEMY_BOTONOID) {
@@ -271,11 +388,11 @@ void EnemyManager::killEnemy(std::list<EnemyStruct>::iterator i)
 	randomLoot = smh->randomInt(0,10000);
 	if (randomLoot < 10000.0 * i->spawnHealthChance) 
 	{
-		smh->lootManager->addLoot(LOOT_HEALTH, i->enemy->x, i->enemy->y, -1);
+		i->enemy->dropLoot(LOOT_HEALTH);
 	} 
 	else if (randomLoot < 10000.0 * i->spawnHealthChance + 10000.0*i->spawnManaChance) 
 	{
-		smh->lootManager->addLoot(LOOT_MANA, i->enemy->x, i->enemy->y, -1);
+		i->enemy->dropLoot(LOOT_MANA);
 	}
 
 	smh->saveManager->numEnemiesKilled++;
@@ -501,8 +618,8 @@ void EnemyManager::reset()
 		} 
 		catch (System::Exception *ex)
 		{
-			smh->hge->System_Log("Exception caught deleting enemy type %d", enemyType);
-			smh->hge->System_Log("%s", ex->ToString());
+			smh->logger->write(LogLevels::Error, LogCategories::Enemies, "Exception caught deleting enemy type %d", enemyType);
+			smh->logger->write(LogLevels::Error, LogCategories::Enemies, "%s", ex->ToString());
 		}
 
 	}
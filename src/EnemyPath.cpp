@@ -0,0 +1,151 @@
+/**
+ * EnemyPath.cpp
+ *
+ * Works out the paths enemies take. Kept out of BaseEnemy.cpp because it only
+ * reads the tile layers, so it can be built and timed headless.
+ */
+#include "SmileyEngine.h"
+#include "EnemyFramework.h"
+#include "environment.h"
+
+extern SMH *smh;
+
+/**
+ * Fills mapPath with how many squares each square within updateRadius of the
+ * enemy is from (destinationX, destinationY).
+ */
+void BaseEnemy::doAStar(int destinationX, int destinationY, int updateRadius) 
+{
+	boolean found;
+	int lowValue;
+
+	//Only update map path if the enemies are within 10 tiles of destination
+	if (abs(gridX - destinationX) + abs(gridY - destinationY) > updateRadius) {
+		return;
+	}
+
+	//For performance reasons only update mapPath in a *updateRadius* (default = 10) tile radius
+	int startX = (gridX <= updateRadius) ? 0 : gridX - updateRadius;
+	int startY = (gridY <= updateRadius) ? 0 : gridY - updateRadius;
+	int endX = (gridX >= smh->environment->areaWidth - updateRadius) ? smh->environment->areaWidth : gridX + updateRadius;
+	int endY = (gridY >= smh->environment->areaHeight - updateRadius) ? smh->environment->areaHeight : gridY + updateRadius;
+
+	//Initialize mapPath array
+	for (int i = startX; i < endX; i++) 
+	{
+		for (int j = startY; j < endY; j++) 
+		{
+			//If the player is at (i,j), the distance from (i,j) is 0
+			if (i == destinationX && j == destinationY) 
+			{
+				mapPath[i][j] = 0;
+			//If (i,j) is inaccessible, set distance to 999
+			} 
+			else if (!canPass[smh->environment->collision(i, j)] || smh->environment->hasSillyPad(i, j)) 
+			{
+				mapPath[i][j] = 999;
+			//Otherwise put a -1
+			} 
+			else 
+			{
+				mapPath[i][j] = -1;
+			}
+		}
+	}
+
+	//Loop until no new positions are calculated
+	do 
+	{
+		found = false;		//no position has been calculated yet
+		
+		//First check for tiles which can be mapped. Set these to markMap == true.
+		for (int i = startX; i < endX; i++) 
+		{
+			for (int j = startY; j < endY; j++) 
+			{
+				markMap[i][j] = false;
+				//If (i,j) hasn't been calculated yet
+				if (mapPath[i][j] == -1) 
+				{
+					//Scan neighbors
+					for (int ni = i-1; ni <= i+1; ni++) 
+					{
+						for (int nj = j-1; nj <= j+1; nj++) 
+						{
+							//Verify neighbor is on map and (ni,nj) != (i,j)
+							if (ni >= 0 && nj >= 0 && ni < smh->environment->areaWidth && nj <= smh->environment->areaHeight && !(ni == i && nj == j)) 
+							{
+								//Verify square hasn't been calculated yet and is accessible to this enemy
+								if (mapPath[ni][nj] >= 0 && mapPath[ni][nj] != 999) 
+								{
+									markMap[i][j] = true;	//this cell can be calculated
+									found = true;			//a calculatable cell has been found
+								}
+							}
+						}
+					}
+				}
+			}
+		}
+
+		//Next scan all marked squares and calculate the distance.
+		for (int i = startX; i < endX; i++) 
+		{
+			for (int j = startY; j < endY; j++) 
+			{
+				if (markMap[i][j]) 
+				{
+					lowValue = 999;
+					//Loop through neighbors
+					for (int ni = i-1; ni <= i+1; ni++) 
+					{
+						for (int nj = j-1; nj <= j+1; nj++) 
+						{
+							//Verify the neighbor is on the map
+							if (ni >= 0 && nj >= 0 && ni < smh->environment->areaWidth && nj < smh->environment->areaHeight && !(ni == i && nj == j)) 
+							{
+								//Verify this square hasn't been calculated already
+								if (mapPath[ni][nj] >= 0) 
+								{	
+									//If diagonal, make sure you can actually get there
+									bool diagonalOK=verifyDiagonal(i,j,ni,nj);
+									
+									//Assign the value to lowvalue if it is lower
+									if (mapPath[ni][nj] < lowValue && diagonalOK) 
+									{
+										lowValue = mapPath[ni][nj];
+									}
+								}
+							}
+						}
+					}
+
+					//Assign the lowest neighbor value +1 to the square
+					mapPath[i][j] = lowValue+1;
+				}
+			}
+		}
+	} while (found);
+}
+
+/**
+ * "Verify the diagonal"
+ * This functional is used by the A* algorithm to make sure that the algorithm doesn't try to make enemies
+   run "between" 2 diagonal objects. If they did try to run through, they'd be stuck!
+ */
+bool BaseEnemy::verifyDiagonal(int curX, int curY, int neighborX, int neighborY) 
+{
+	int diffX = neighborX - curX;
+	int diffY = neighborY - curY;
+
+	if (diffX == 0 || diffY == 0) return true; //Isn't diagonal, so don't worry about it.
+
+	if (diffX != 0)  //is moving left or right, so check immediately left or right and return false if it's blocked
+		if (!canPass[smh->environment->collision(neighborX, curY)] || mapPath[neighborX][curY] == 999) return false;
+
+	if (diffY != 0) //is moving up or down, so check immediately up or down and return false if it's blocked
+		if (!canPass[smh->environment->collision(curX, neighborY)] || mapPath[curX][neighborY] == 999) return false;
+
+	//Passed both conditions above, so return true
+	return true;
+}
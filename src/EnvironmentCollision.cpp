@@ -0,0 +1,165 @@
+/** 
+ * EnvironmentCollision.cpp
+ * 
+ * The collision queries that only read the tile layers. Kept out of
+ * environment.cpp so they can be built and timed headless.
+ */
+#include "SmileyEngine.h"
+#include "environment.h"
+#include "player.h"
+#include "collisioncircle.h"
+#include "hgerect.h"
+
+#include <math.h>
+
+extern SMH *smh;
+
+/**
+ * Returns what type of collision there is at point (x,y)
+ */
+int Environment::collisionAt(float x, float y) {
+	
+	//Determine grid coords of the object
+	int gridX = x / (float)64.0;
+	int gridY = y / (float)64.0;
+
+	//Handle out of bounds input
+	if (!isInBounds(gridX,gridY)) {
+		return UNWALKABLE;
+	}
+
+	//Return the collision type
+	return collision(gridX, gridY);
+
+}
+
+/**
+ * Returns whether or not there is an unobstructed straight line from 
+ * pixel position (x1, y1) to (x2, y2).
+ *
+ *	x1, y1		point at the start of the path
+ *	x2, y2		point at the end of the path
+ *	radius		radius of the object taking the path
+ *
+ */
+bool Environment::validPath(int x1, int y1, int x2, int y2, int radius, const CollisionMask &canPass) {
+	//First get the velocities of the path
+	float angle = Util::getAngleBetween(x1,y1,x2,y2);
+
+	//Call validPath using this angle
+	return validPath(angle, x1, y1, x2, y2, radius, canPass, false);
+}
+
+bool Environment::validPath(float angle,int x1, int y1, int x2, int y2, int radius, const CollisionMask &canPass, bool needsToHitPlayer) {
+	float dx = 10.0*cos(angle);
+	float dy = 10.0*sin(angle);
+
+	//Now trace the path using dx and dy and see if you run into any SHIT
+	float xTravelled = 0;
+	float yTravelled = 0;
+	float curX = x1;
+	float curY = y1;
+	
+	CollisionCircle circle;
+
+	//This can throw an exception if the enemy is perfectly on top of the player
+	try {
+		while (abs(xTravelled) < abs(x2 - x1) && abs(yTravelled) < abs(y2 - y1)) {
+			//Top left of the object
+			if (!canPass[collisionAt(curX-radius, curY-radius)] || hasSillyPad(int(curX-radius)/64,int(curY-radius)/64)) return false;
+			//Top right of the object
+			if (!canPass[collisionAt(curX+radius, curY-radius)] || hasSillyPad(int(curX+radius)/64,int(curY-radius)/64)) return false;
+			//Bottom left of the object
+			if (!canPass[collisionAt(curX-radius, curY+radius)] || hasSillyPad(int(curX-radius)/64,int(curY+radius)/64)) return false;
+			//Bottom right of the object
+			if (!canPass[collisionAt(curX+radius, curY+radius)] || hasSillyPad(int(curX+radius)/64,int(curY+radius)/64)) return false;
+			curX += dx;
+			curY += dy;
+			xTravelled += dx;
+			yTravelled += dy;
+
+			if (needsToHitPlayer) {
+				circle.x = curX;
+				circle.y = curY;
+				circle.radius = radius;
+				
+				if (smh->player->collisionCircle->testCircle(&circle)) return true;
+			}
+		}
+	} catch(int type) {
+		return true;
+	}
+
+	if (!needsToHitPlayer)
+		//You didnt hit any SHIT so return true
+		return true;
+
+	//Since needsToHitPlayer is true, we only return true if we hit the player
+	circle.x = curX;
+	circle.y = curY;
+	circle.radius = radius;
+	
+	if (smh->player->collisionCircle->testCircle(&circle)) return true;
+
+	return false;
+
+}
+
+/**
+ * Returns whether or not box collides with any silly pads or terrain 
+ * as specified by canPass.
+ */
+bool Environment::testCollision(hgeRect *box, const CollisionMask &canPass) {
+	return testCollision(box, canPass, false);
+}
+
+/**
+ * Returns whether or not box collides with terrain as specified by canPass.
+ * 
+ * @param ignoreSillyPads	If true, hitting silly pads won't be counted as collision
+ */
+bool Environment::testCollision(hgeRect *box, const CollisionMask &canPass, bool ignoreSillyPads) {
+
+	//Determine the location of the collision box
+	int gridX = (box->x1 + (box->x2 - box->x1)/2) / 64;
+	int gridY = (box->y1 + (box->y2 - box->y1)/2) / 64;
+
+	//Check all neighbor squares
+	for (int i = gridX - 2; i <= gridX + 2; i++) {
+		for (int j = gridY - 2; j <= gridY + 2; j++) {
+			//Ignore squares off the map
+			if (isInBounds(i,j) && (!canPass[collision(i, j)] || 
+					(!ignoreSillyPads && hasSillyPad(i,j)))) {
+				
+				//Test collision
+				setTerrainCollisionBox(collisionBox, (!ignoreSillyPads && hasSillyPad(i,j)) 
+						? UNWALKABLE : collision(i, j), i, j);
+
+				if (box->Intersect(collisionBox)) {
+					return true;
+				}
+			}
+		}
+	}
+
+	//No collision occured, so return false
+	return false;
+
+}
+
+/**
+ * Set a collision box for the speicifed collision type decalared in smiley.
+ * This allows different things to have different shaped collision boxes.
+ */
+void Environment::setTerrainCollisionBox(hgeRect *box, int whatFor, int gridX, int gridY) {
+	if (whatFor == FOUNTAIN) {
+		//Fountain
+		box->Set((gridX-1)*64,gridY*64 + 35,(gridX+2)*64,(gridY+1)*64 + 10);
+	} else {
+		box->SetRadius(gridX*64+32,gridY*64+31,31);
+	}
+}
+
+bool Environment::isInBounds(int gridX, int gridY) {
+	return (gridX >= 0 && gridY >= 0 && gridX < areaWidth && gridY < areaHeight);
+}
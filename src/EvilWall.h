@@ -1,6 +1,8 @@
 #ifndef _EVIL_WALL_H_
 #define _EVIL_WALL_H_
 
+#include "AreaArena.h"
+
 class hgeRect;
 
 
@@ -13,7 +15,7 @@ class hgeRect;
 #define EVIL_WALL_APPEAR_TIME 1.0
 #define EVIL_WALL_DAMAGE 0.0
 
-class EvilWall {
+class EvilWall : public AreaObject {
 public:
 
 	EvilWall();
@@ -63,10 +63,10 @@ void EvilWallManager::deactivateEvilWalls() {
 
 void EvilWallManager::update(float dt) {
 	//Activate or deactivate evil walls
-	if (smh->environment->collision[smh->player->gridX][smh->player->gridY] == EVIL_WALL_TRIGGER) {
-		activateEvilWall(smh->environment->ids[smh->player->gridX][smh->player->gridY]);
+	if (smh->environment->collision(smh->player->gridX, smh->player->gridY) == EVIL_WALL_TRIGGER) {
+		activateEvilWall(smh->environment->ids(smh->player->gridX, smh->player->gridY));
 	}
-	if (smh->environment->collision[smh->player->gridX][smh->player->gridY] == EVIL_WALL_DEACTIVATOR) {
+	if (smh->environment->collision(smh->player->gridX, smh->player->gridY) == EVIL_WALL_DEACTIVATOR) {
 		deactivateEvilWalls();
 	}
 
@@ -35,7 +35,7 @@ void ExplosionManager::addSlimeExplosion(float x, float y, float size, float dam
  */
 void ExplosionManager::draw(float dt) {
 	for (std::list<Explosion>::iterator i = explosionList.begin(); i != explosionList.end(); i++) {
-		i->particle->Render();
+		smh->particlePool->render(i->particle);
 
 		if (smh->isDebugOn()) {
 			i->collisionCircle->draw();
@@ -44,16 +44,24 @@ void ExplosionManager::draw(float dt) {
 }
 
 void ExplosionManager::reset() {
-	for (std::list<Explosion>::iterator i = explosionList.begin(); i != explosionList.end(); i++) {
+	std::list<Explosion>::iterator i = explosionList.begin();
+	while (i != explosionList.end()) {
+		smh->particlePool->release(i->particle);
+		delete i->collisionCircle;
 		i = explosionList.erase(i);
 	}
 }
 
+int ExplosionManager::getNumExplosions() {
+	return explosionList.size();
+}
+
 /**
  * Updates all managed explosions.
  */
 void ExplosionManager::update(float dt) {
-	for (std::list<Explosion>::iterator i = explosionList.begin(); i != explosionList.end(); i++) {
+	std::list<Explosion>::iterator i = explosionList.begin();
+	while (i != explosionList.end()) {
 		i->particle->MoveTo(smh->getScreenX(i->x), smh->getScreenY(i->y), true);
 		i->particle->Update(dt);
 		i->timeAlive += dt;
@@ -78,7 +86,11 @@ void ExplosionManager::update(float dt) {
 		smh->enemyManager->killEnemiesInCircleAndCauseExplosion(i->collisionCircle,86);
 		
 		if (i->timeAlive > i->duration) {
+			smh->particlePool->release(i->particle);
+			delete i->collisionCircle;
 			i = explosionList.erase(i);
+		} else {
+			i++;
 		}
 	}
 }
@@ -127,9 +139,9 @@ void ExplosionManager::createExplosion(float x, float y, float size, float damag
 	explosion.isSlime = slime;
 
 	if (slime) {
-		explosion.particle = new hgeParticleSystem(&smh->resources->GetParticleSystem("slimeParticle")->info);
+		explosion.particle = smh->particlePool->acquire("slimeParticle", ParticlePriorities::High);
 	} else {
-		explosion.particle = new hgeParticleSystem(&smh->resources->GetParticleSystem("explosion")->info);
+		explosion.particle = smh->particlePool->acquire("explosion", ParticlePriorities::High);
 	}
 	explosion.particle->FireAt(x, y);
 
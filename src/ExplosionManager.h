@@ -29,6 +29,7 @@ public:
 	void addExplosion(float x, float y, float size, float damage, float knockback);
 	void addSlimeExplosion(float x, float y, float size, float damage, float knockback);
 	void reset();
+	int getNumExplosions();
 
 private:
 
@@ -5,6 +5,7 @@
 #include "Environment.h"
 #include "SpecialTileManager.h"
 #include "ProjectileManager.h"
+#include "PatternEmitter.h"
 #include "CollisionCircle.h"
 #include "Player.h"
 #include "MainMenu.h"
@@ -23,6 +24,36 @@
 #define FENWAR_WIDTH 62
 #define FENWAR_HEIGHT 73
 
+//Fenwar's yellow dots split into rings of 5, then 4, then 3
+static const BulletPattern FENWAR_BULLET_LAST_SPLIT = {
+	PatternShapes::Ring, 3, 0.0, 2.0*PI, 0.0, 0.0,
+	FenwarAttributes::BULLET_SPEED, 0.0, 0.0, 0.0,
+	10.0, FenwarAttributes::BULLET_DAMAGE, 0, 2000.0, 0.0, 0.0,
+	0.0, 0.0, NULL,
+	"fenwarBullet", NULL, NULL, NULL, NULL
+};
+static const BulletPattern FENWAR_BULLET_SECOND_SPLIT = {
+	PatternShapes::Ring, 4, 0.0, 2.0*PI, 0.0, 0.0,
+	FenwarAttributes::BULLET_SPEED, 0.0, 0.0, 0.0,
+	10.0, FenwarAttributes::BULLET_DAMAGE, 0, 2000.0, 0.0, 0.0,
+	1.0, 1.5, &FENWAR_BULLET_LAST_SPLIT,
+	"fenwarBullet", NULL, NULL, "snd_FenwarYellowDotSplit", NULL
+};
+static const BulletPattern FENWAR_BULLET_FIRST_SPLIT = {
+	PatternShapes::Ring, 5, 0.0, 2.0*PI, 0.0, 0.0,
+	FenwarAttributes::BULLET_SPEED, 0.0, 0.0, 0.0,
+	10.0, FenwarAttributes::BULLET_DAMAGE, 0, 2000.0, 0.0, 0.0,
+	1.0, 1.5, &FENWAR_BULLET_SECOND_SPLIT,
+	"fenwarBullet", NULL, NULL, "snd_FenwarYellowDotSplit", NULL
+};
+static const BulletPattern FENWAR_BULLET = {
+	PatternShapes::Spread, 1, 0.0, 0.0, 0.0, 0.0,
+	FenwarAttributes::BULLET_SPEED, 0.0, 0.0, 0.0,
+	10.0, FenwarAttributes::BULLET_DAMAGE, 0, 2000.0, 0.0, 0.0,
+	1.0, 1.5, &FENWAR_BULLET_FIRST_SPLIT,
+	"fenwarBullet", NULL, NULL, "snd_FenwarYellowDotSplit", NULL
+};
+
 #define FENWAR_DEATH_STAGE_X 98
 #define FENWAR_DEATH_STAGE_Y 33
 
@@ -56,7 +87,6 @@ FenwarBoss::FenwarBoss(int _gridX, int _gridY, int _groupID)
 	hasBegunFadeToWhite=false;
 
 	orbManager = new FenwarOrbs(this);
-	bulletManager = new FenwarBullets(this);
 	bombManager = new FenwarBombs(this);
 
 	smh->resources->GetAnimation("fenwar")->Play();
@@ -74,7 +104,7 @@ FenwarBoss::~FenwarBoss()
 	smh->screenEffectsManager->stopEffect();
 
 	delete orbManager;
-	delete bulletManager;
+	smh->patternEmitter->clear(this);
 	delete bombManager;
 	delete collisionBox;
 
@@ -106,7 +136,7 @@ void FenwarBoss::draw(float dt)
 	smh->resources->GetAnimation("fenwarFace")->Render(smh->getScreenX(x), smh->getScreenY(y - floatingYOffset));
 
 	orbManager->drawAfterFenwar(dt);
-	bulletManager->draw(dt);
+	smh->patternEmitter->draw(this);
 	bombManager->draw(dt);
 
 	//Stun effect
@@ -171,7 +201,6 @@ bool FenwarBoss::update(float dt)
 	if (flashing && smh->timePassedSince(timeStartedFlashing) > FLASHING_DURATION) flashing = false;
 
 	orbManager->update(dt);
-	bulletManager->update(dt);
 	bombManager->update(dt);
 	doCollision(dt);
 
@@ -299,7 +328,7 @@ void FenwarBoss::doBattleState(float dt)
 		int r = smh->randomInt(0, 100000);
 		if (r < 50000)
 		{
-			bulletManager->shootBullet(Util::getAngleBetween(x, y, smh->player->x, smh->player->y));
+			smh->patternEmitter->fire(&FENWAR_BULLET, this, x, y, Util::getAngleBetween(x, y, smh->player->x, smh->player->y));
 		}
 		else 
 		{
@@ -503,7 +532,7 @@ void FenwarBoss::dealDamage(float damage, bool makesFlash)
 			flashing = false;
 			smh->screenEffectsManager->stopEffect();
 			orbManager->killOrbs();
-			bulletManager->killBullets();
+			smh->patternEmitter->clear(this);
 			enterState(FenwarStates::RETURN_TO_ARENA);
 			smh->windowManager->openDialogueTextBox(-1, FENWAR_NEAR_DEFEAT_TEXT);
 			hasBegunFadeToWhite=false;
@@ -596,7 +625,7 @@ void FenwarBoss::chooseRandomPlatformUponWhichToDropASpider()
 
 void FenwarBoss::terraformArena() 
 {
-	int platformTerrain = smh->environment->terrain[startGridX][startGridY];
+	int platformTerrain = smh->environment->terrain(startGridX, startGridY);
 	
 	//Terraform a big area around fenwar
 	for (int i = startGridX - 40; i <= startGridX + 40; i++) 
@@ -640,9 +669,9 @@ void FenwarBoss::terraformArena()
 			} 
 			else 
 			{
-				smh->environment->collision[i][j] = PIT;
-				smh->environment->terrain[i][j] = platformTerrain;
-				smh->environment->item[i][j] = 0;
+				smh->environment->collision(i, j) = PIT;
+				smh->environment->terrain(i, j) = platformTerrain;
+				smh->environment->item(i, j) = 0;
 			}
 		}
 	}
@@ -4,7 +4,6 @@
 #include "boss.h"
 
 class FenwarOrbs;
-class FenwarBullets;
 class FenwarBombs;
 class hgeDistortionMesh;
 class hgeRect;
@@ -87,7 +86,6 @@ private:
 	void chooseRandomPlatformUponWhichToDropASpider();
 	
 	FenwarOrbs *orbManager;
-	FenwarBullets *bulletManager;
 	FenwarBombs *bombManager;
 	hgeRect *collisionBox;
 	bool startedIntroDialogue;
@@ -143,7 +141,7 @@ public:
 	static const int ATTACKING = 4;
 };
 
-class FenwarOrbs 
+class FenwarOrbs : public AreaObject 
 {
 public:
 
@@ -179,39 +177,6 @@ private:
 
 };
 
-///////////// FENWAR BULLETS ////////////////
-
-struct FenwarBullet
-{
-	float x, y;
-	float dx, dy;
-	float n;
-	float timeOfLastSplit;
-	float nextSplitTime;
-	hgeRect *collisionBox;
-};
-
-class FenwarBullets
-{
-public:
-
-	FenwarBullets(FenwarBoss *fenwar);
-	~FenwarBullets();
-
-	void update(float dt);
-	void draw(float dt);
-	void shootBullet(float angle);
-	void killBullets();
-
-private:
-
-	void spawnBullet(float x, float y, float angle, int n);
-
-	FenwarBoss *fenwar;
-	std::list<FenwarBullet> bulletList;
-
-};
-
 ///////////// FENWAR BOMBS ////////////////
 
 struct FenwarBomb
@@ -222,7 +187,7 @@ struct FenwarBomb
 	float dx, dy;
 };
 
-class FenwarBombs
+class FenwarBombs : public AreaObject
 {
 public:
 
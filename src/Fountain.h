@@ -1,7 +1,9 @@
 #ifndef _FOUNTAIN_H_
 #define _FOUNTAIN_H_
 
-class Fountain {
+#include "AreaArena.h"
+
+class Fountain : public AreaObject {
 
 public:
 	Fountain(int gridX, int gridY);
@@ -0,0 +1,230 @@
+#include "SmileyEngine.h"
+#include "player.h"
+#include "EnemyFramework.h"
+#include "ProjectileManager.h"
+#include "ExplosionManager.h"
+
+extern SMH *smh;
+
+#define DEFAULT_HITCH_BUDGET 33.3
+#define HISTOGRAM_BUCKET_SIZE 0.5
+
+static const char *sectionNames[NUM_FRAME_SECTIONS] = {
+	"Input", "Menu", "Windows", "AreaChanger", "Player", "Environment",
+	"Bosses", "Enemies", "Projectiles", "OtherUpdate", "Draw"
+};
+
+FrameProfiler::FrameProfiler() {
+
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+	ticksPerSecond = frequency.QuadPart;
+
+	hitchBudget = smh->hge->Ini_GetFloat("Debug", "hitchBudgetMs", DEFAULT_HITCH_BUDGET);
+
+	for (int i = 0; i < FRAME_HISTOGRAM_BUCKETS; i++) {
+		histogram[i] = 0;
+	}
+	for (int i = 0; i < NUM_FRAME_SECTIONS; i++) {
+		sectionStart[i] = 0;
+		sectionTicks[i] = 0;
+	}
+
+	frameStarted = false;
+	inTransition = false;
+	maxTransitionFrameTime = 0.0;
+	numFrames = 0;
+	numHitches = 0;
+	maxFrameTime = 0.0;
+	totalFrameTime = 0.0;
+
+}
+
+FrameProfiler::~FrameProfiler() {
+	hitchReports.clear();
+}
+
+/**
+ * Called at the very start of each frame. The time since the previous call is
+ * the length of the previous frame, which is recorded along with the subsystem
+ * timings that were gathered during it.
+ */
+void FrameProfiler::beginFrame() {
+
+	LARGE_INTEGER now;
+	QueryPerformanceCounter(&now);
+
+	if (frameStarted) {
+		recordFrame(toMilliseconds(now.QuadPart - frameStart));
+	}
+
+	frameStart = now.QuadPart;
+	frameStarted = true;
+	for (int i = 0; i < NUM_FRAME_SECTIONS; i++) {
+		sectionTicks[i] = 0;
+	}
+
+}
+
+void FrameProfiler::beginSection(int section) {
+	LARGE_INTEGER now;
+	QueryPerformanceCounter(&now);
+	sectionStart[section] = now.QuadPart;
+}
+
+void FrameProfiler::endSection(int section) {
+	LARGE_INTEGER now;
+	QueryPerformanceCounter(&now);
+	sectionTicks[section] += now.QuadPart - sectionStart[section];
+}
+
+/**
+ * Adds a frame to the histogram and captures a hitch report if the frame
+ * went over budget.
+ */
+void FrameProfiler::recordFrame(float frameMs) {
+
+	int bucket = (int)(frameMs / HISTOGRAM_BUCKET_SIZE);
+	if (bucket >= FRAME_HISTOGRAM_BUCKETS) bucket = FRAME_HISTOGRAM_BUCKETS - 1;
+	histogram[bucket]++;
+
+	numFrames++;
+	totalFrameTime += frameMs;
+	if (frameMs > maxFrameTime) maxFrameTime = frameMs;
+	if (inTransition && frameMs > maxTransitionFrameTime) maxTransitionFrameTime = frameMs;
+
+	if (frameMs > hitchBudget) {
+		numHitches++;
+		captureHitch(frameMs);
+	}
+
+}
+
+/**
+ * Formats the subsystem breakdown and world state for a slow frame and keeps
+ * it in memory until the log is written.
+ */
+void FrameProfiler::captureHitch(float frameMs) {
+
+	if (hitchReports.size() >= MAX_HITCH_REPORTS) return;
+
+	char line[512];
+	std::string report;
+
+	sprintf(line, "HITCH #%d: %.2f ms (budget %.2f ms) at game time %.2f",
+		numHitches, frameMs, hitchBudget, smh->getGameTime());
+	report += line;
+
+	if (smh->getGameState() == GAME) {
+		sprintf(line, "\n  Area: %s, Player grid: (%d,%d)",
+			smh->gameData->getAreaName(smh->saveManager->currentArea), smh->player->gridX, smh->player->gridY);
+		report += line;
+		sprintf(line, "\n  Enemies: %d, Projectiles: %d, Particles: %d (%d systems), Explosions: %d",
+			smh->enemyManager->enemyList.size(), smh->projectileManager->theProjectiles.size(),
+			smh->particlePool->getNumLiveParticles(), smh->particlePool->getNumLiveSystems(),
+			smh->explosionManager->getNumExplosions());
+		report += line;
+	} else {
+		report += "\n  In menu";
+	}
+
+	float accountedFor = 0.0;
+	for (int i = 0; i < NUM_FRAME_SECTIONS; i++) {
+		float sectionMs = toMilliseconds(sectionTicks[i]);
+		accountedFor += sectionMs;
+		if (sectionTicks[i] > 0) {
+			sprintf(line, "\n  %-12s %8.2f ms", sectionNames[i], sectionMs);
+			report += line;
+		}
+	}
+	sprintf(line, "\n  %-12s %8.2f ms", "Unaccounted", max(0.0f, frameMs - accountedFor));
+	report += line;
+
+	hitchReports.push_back(report);
+
+}
+
+/**
+ * Starts tracking the longest frame of a transition such as an area change.
+ */
+void FrameProfiler::beginTransition() {
+	inTransition = true;
+	maxTransitionFrameTime = 0.0;
+}
+
+/**
+ * Logs the longest frame since beginTransition() was called.
+ */
+void FrameProfiler::endTransition(const char *description) {
+	if (!inTransition) return;
+	inTransition = false;
+	smh->logger->write(LogLevels::Info, LogCategories::Profiler, "Longest frame during %s: %.2f ms", 
+		description, maxTransitionFrameTime);
+}
+
+/**
+ * Returns the frame time in milliseconds below which the given percentage (0-100)
+ * of frames fall.
+ */
+float FrameProfiler::getPercentile(float percentile) {
+
+	if (numFrames == 0) return 0.0;
+
+	int target = (int)(percentile / 100.0 * (float)numFrames);
+	int count = 0;
+	for (int i = 0; i < FRAME_HISTOGRAM_BUCKETS; i++) {
+		count += histogram[i];
+		if (count > target) {
+			return min(maxFrameTime, (float)(i+1) * HISTOGRAM_BUCKET_SIZE);
+		}
+	}
+
+	return maxFrameTime;
+}
+
+float FrameProfiler::getMaxFrameTime() {
+	return maxFrameTime;
+}
+
+int FrameProfiler::getNumHitches() {
+	return numHitches;
+}
+
+/**
+ * Writes all captured hitches and the session frame time summary to the log.
+ */
+void FrameProfiler::logSummary() {
+
+	//Reports are written a line at a time and flushed as we go so that a long
+	//session's worth of hitches doesn't overflow the log queue.
+	for (std::list<std::string>::iterator i = hitchReports.begin(); i != hitchReports.end(); i++) {
+		std::string::size_type lineStart = 0;
+		while (lineStart < i->size()) {
+			std::string::size_type lineEnd = i->find('\n', lineStart);
+			if (lineEnd == std::string::npos) lineEnd = i->size();
+			smh->logger->write(LogLevels::Warning, LogCategories::Profiler, "%s", i->substr(lineStart, lineEnd - lineStart).c_str());
+			lineStart = lineEnd + 1;
+		}
+		smh->logger->flush();
+	}
+	if (numHitches > (int)hitchReports.size()) {
+		smh->logger->write(LogLevels::Warning, LogCategories::Profiler, "%d more hitches were not captured", numHitches - hitchReports.size());
+	}
+	hitchReports.clear();
+
+	smh->logger->write(LogLevels::Info, LogCategories::Profiler, "---------Frame Time Summary----------");
+	smh->logger->write(LogLevels::Info, LogCategories::Profiler, "Frames: %d, Average: %.2f ms", numFrames, numFrames > 0 ? totalFrameTime / numFrames : 0.0);
+	smh->logger->write(LogLevels::Info, LogCategories::Profiler, "p50: %.2f ms, p95: %.2f ms, p99: %.2f ms, max: %.2f ms",
+		getPercentile(50.0), getPercentile(95.0), getPercentile(99.0), maxFrameTime);
+	smh->logger->write(LogLevels::Info, LogCategories::Profiler, "Hitches over %.2f ms: %d", hitchBudget, numHitches);
+	smh->logger->write(LogLevels::Info, LogCategories::Profiler, "-------------------------------------");
+
+	//The summary can be written more than once (after a fatal error and again at exit) so
+	//start counting hitches again along with the reports.
+	numHitches = 0;
+
+}
+
+float FrameProfiler::toMilliseconds(LONGLONG ticks) {
+	return (float)((double)ticks * 1000.0 / (double)ticksPerSecond);
+}
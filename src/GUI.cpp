@@ -189,23 +189,23 @@ void GUI::draw()
 		drawY = (i <= 10) ? 15 : 60;
 		if (smh->player->getHealth() >= i) 
 		{
-			smh->resources->GetSprite("fullHealth")->Render(drawX, drawY);
+			smh->spriteBatch->render(smh->resources->GetSprite("fullHealth"), drawX, drawY);
 		} 
 		else if (smh->player->getHealth() < i && smh->player->getHealth() >= i-.25) 
 		{
-			smh->resources->GetSprite("threeQuartersHealth")->Render(drawX, drawY);
+			smh->spriteBatch->render(smh->resources->GetSprite("threeQuartersHealth"), drawX, drawY);
 		}
 		else if (smh->player->getHealth() < i-.25 && smh->player->getHealth() >= i -.5) 
 		{
-			smh->resources->GetSprite("halfHealth")->Render(drawX, drawY);
+			smh->spriteBatch->render(smh->resources->GetSprite("halfHealth"), drawX, drawY);
 		}
 		else if (smh->player->getHealth() < i-.5 && smh->player->getHealth() >= i - .75) 
 		{
-			smh->resources->GetSprite("quarterHealth")->Render(drawX, drawY);
+			smh->spriteBatch->render(smh->resources->GetSprite("quarterHealth"), drawX, drawY);
 		}
 		else 
 		{
-			smh->resources->GetSprite("emptyHealth")->Render(drawX, drawY);
+			smh->spriteBatch->render(smh->resources->GetSprite("emptyHealth"), drawX, drawY);
 		}
 	}
 
@@ -214,19 +214,19 @@ void GUI::draw()
 	drawY = smh->player->getMaxHealth() < 11 ? 55 : 100;
 	float manaBarSizeMultiplier = (1.0 + .15 * smh->saveManager->numUpgrades[1]) * 0.96; //adjust the size multiplier so max mana bar is the same width as max hearts
 	
-	smh->resources->GetSprite("manabarBackgroundCenter")->SetTextureRect(675, 282, 115*manaBarSizeMultiplier-4, 22, true);
-	smh->resources->GetSprite("manabarBackgroundCenter")->Render(drawX+4, drawY);
-	smh->resources->GetSprite("manaBar")->SetTextureRect(661, 304, 115*(smh->player->getMana()/smh->player->getMaxMana())*manaBarSizeMultiplier, 15, true);
-	smh->resources->GetSprite("manaBar")->Render(drawX+4,drawY+3);
+	smh->resources->setTextureRect("manabarBackgroundCenter", 675, 282, 115*manaBarSizeMultiplier-4, 22);
+	smh->spriteBatch->render(smh->resources->GetSprite("manabarBackgroundCenter"), drawX+4, drawY);
+	smh->resources->setTextureRect("manaBar", 661, 304, 115*(smh->player->getMana()/smh->player->getMaxMana())*manaBarSizeMultiplier, 15);
+	smh->spriteBatch->render(smh->resources->GetSprite("manaBar"), drawX+4,drawY+3);
 
-	smh->resources->GetSprite("manabarBackgroundLeftTip")->Render(drawX, drawY);
-	smh->resources->GetSprite("manabarBackgroundRightTip")->Render(drawX + 115 * manaBarSizeMultiplier - 2, drawY);
+	smh->spriteBatch->render(smh->resources->GetSprite("manabarBackgroundLeftTip"), drawX, drawY);
+	smh->spriteBatch->render(smh->resources->GetSprite("manabarBackgroundRightTip"), drawX + 115 * manaBarSizeMultiplier - 2, drawY);
 
 
 	Ability curAbility;
 
 	//Draw abilities
-	smh->resources->GetSprite("abilityBackground")->Render(5.0, 5.0);
+	smh->spriteBatch->render(smh->resources->GetSprite("abilityBackground"), 5.0, 5.0);
 	for (int i = 0; i < 3; i++) 
 	{
 		double y = 45.0;
@@ -235,7 +235,7 @@ void GUI::draw()
 		if (activeAbilities[i] != NO_ABILITY) 
 		{
 			smh->resources->GetAnimation("abilities")->SetFrame(activeAbilities[i]);
-			smh->resources->GetAnimation("abilities")->Render(x, y);
+			smh->spriteBatch->render(smh->resources->GetAnimation("abilities"), x, y);
 
 			//Draw the cooldown timer
 			curAbility = smh->gameData->getAbilityInfo(activeAbilities[i]);
@@ -243,9 +243,9 @@ void GUI::draw()
 			{
 				float percentage = smh->timePassedSince(curAbility.timeLastUsed) / curAbility.coolDown;
 				int height = 80-int(percentage*80.0);
-				smh->resources->GetSprite("abilityCooldownCircle")->SetTextureRect(735,574+80-height,80,height,true);
+				smh->resources->setTextureRect("abilityCooldownCircle", 735, 574+80-height, 80, height);
 				float xCircle = int(i)*80.0 + 5.0;
-				smh->resources->GetSprite("abilityCooldownCircle")->Render(xCircle,5+80-height);		
+				smh->spriteBatch->render(smh->resources->GetSprite("abilityCooldownCircle"), xCircle,5+80-height);		
 			}		
 		}
 	}
@@ -261,7 +261,7 @@ void GUI::draw()
 
 			//Draw key icon
 			smh->resources->GetAnimation("keyIcons")->SetFrame(i);
-			smh->resources->GetAnimation("keyIcons")->Render(keyXOffset + 60.0*i, keyYOffset);
+			smh->spriteBatch->render(smh->resources->GetAnimation("keyIcons"), keyXOffset + 60.0*i, keyYOffset);
 			
 			//Draw num keys
 			smh->resources->GetFont("numberFnt")->printf(keyXOffset + 60.0*i + 45.0, keyYOffset + 5.0, 
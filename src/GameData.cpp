@@ -3,23 +3,41 @@
  * 
  * Encapsulates all game data.
  */
-#include "SmileyEngine.h"
+#include "SmileyPrimitives.h"
 #include "ProjectileManager.h"
-#include "Player.h"
-#include "hgestrings.h"
 #include <string>
 
-extern SMH *smh;
-
+/**
+ * Nothing is read here. The files are parsed by parseEnemyTable() and
+ * parseGameText() and the enemy table is filled in by loadEnemyData(), which
+ * SMH::init runs as startup tasks on the worker pool. The ability table is
+ * filled in by refreshAbilityData(), which is in AbilityData.cpp because the
+ * descriptions quote Smiley's damage.
+ */
 GameData::GameData() {
-	loadEnemyData();
-	refreshAbilityData();
-	gameText = new hgeStringTable("Data/GameText.dat");
+	memset(enemyInfo, 0, sizeof(enemyInfo));
+	memset(abilities, 0, sizeof(abilities));
 	initializeGemCounts();
 }
 
-GameData::~GameData() {
+GameData::~GameData() { }
+
+/**
+ * Reads Data/Enemies.dat. Safe to call from a worker thread. Returns whether
+ * the file was read.
+ */
+bool GameData::parseEnemyTable()
+{
+	return enemyStringTable.load("Data/Enemies.dat");
+}
 
+/**
+ * Reads Data/GameText.dat. Safe to call from a worker thread. Returns whether
+ * the file was read.
+ */
+bool GameData::parseGameText()
+{
+	return gameText.load("Data/GameText.dat");
 }
 
 EnemyInfo GameData::getEnemyInfo(int enemyID) 
@@ -43,7 +61,28 @@ std::list<EnemyName> GameData::getEnemyNames() {
 
 const char *GameData::getGameText(const char *text) 
 {
-	return gameText->GetString(text);
+	return gameText.getString(text);
+}
+
+/**
+ * Returns a handle for a game text string that can be used to get it again
+ * without looking it up by name. Asking for the same name twice returns the
+ * same handle.
+ */
+int GameData::getGameTextHandle(const char *text)
+{
+	std::map<std::string, int>::iterator i = gameTextHandles.find(text);
+	if (i != gameTextHandles.end()) return i->second;
+
+	int handle = (int)internedGameText.size();
+	internedGameText.push_back(gameText.getString(text));
+	gameTextHandles[text] = handle;
+	return handle;
+}
+
+const char *GameData::getGameText(int handle)
+{
+	return internedGameText[handle];
 }
 
 const char *GameData::getAreaName(int area) 
@@ -85,7 +124,7 @@ int GameData::getNumTotalGemsInArea(int area, int gemType)
 
 int GameData::getNumEnemies()
 {
-	return atoi(enemyStringTable->GetString("numEnemies"));
+	return atoi(enemyStringTable.getString("numEnemies"));
 }
 
 float GameData::getDifficultyModifier(int difficulty) 
@@ -107,111 +146,6 @@ float GameData::getDifficultyModifier(int difficulty)
 	return 1.0;
 }
 
-void GameData::refreshAbilityData() 
-{
-	//Clinton's Cane
-	strcpy(abilities[CANE].name, "Cane Of Clinton");
-	strcpy(abilities[CANE].description, 
-		"Use to communicate telepathically with Bill Clinton. \n\nMana Cost: 10");
-	abilities[CANE].type = ACTIVATED;
-	abilities[CANE].manaCost = 10;
-	abilities[CANE].coolDown = 0;
-
-	//Jesus' Sandals
-    strcpy(abilities[WATER_BOOTS].name, "Jesus' Sandals");
-	strcpy(abilities[WATER_BOOTS].description, 
-		"While equipped you gain the power of Jesus Christ. (That means you can walk on water)");
-	abilities[WATER_BOOTS].type = HOLD;
-	abilities[WATER_BOOTS].manaCost = 0;
-	abilities[WATER_BOOTS].coolDown = 0;
-
-	//Boots of 14
-	strcpy(abilities[SPRINT_BOOTS].name, "Speed Boots");
-	strcpy(abilities[SPRINT_BOOTS].description, "When used, you run 75% faster.");
-	abilities[SPRINT_BOOTS].type = HOLD;
-	abilities[SPRINT_BOOTS].manaCost = 0;
-	abilities[SPRINT_BOOTS].coolDown = 10.0;
-	abilities[SPRINT_BOOTS].timeLastUsed = 0;
-
-	//Fire Breath
-	strcpy(abilities[FIRE_BREATH].name, "Fire Breath");
-	strcpy(abilities[FIRE_BREATH].description, 
-		"Allows you to breath deadly fire breath.\n\nMana Cost: 15/second\n");
-	strcat(abilities[FIRE_BREATH].description, "Damage: ");
-	strcat(abilities[FIRE_BREATH].description, Util::intToString(smh->player->getFireBreathDamage() * 100).c_str());
-	strcat(abilities[FIRE_BREATH].description, " per second.");
-	abilities[FIRE_BREATH].type = HOLD;
-	abilities[FIRE_BREATH].manaCost = 15;
-	abilities[FIRE_BREATH].coolDown = 0;
-
-	//Ice Breath
-	strcpy(abilities[ICE_BREATH].name, "Ice Breath");
-	strcpy(abilities[ICE_BREATH].description, 
-		"Unleashes an icy blast that can freeze enemies.\n\n\nMana Cost: 10");
-	abilities[ICE_BREATH].type = ACTIVATED;
-	abilities[ICE_BREATH].manaCost = 20;
-	abilities[ICE_BREATH].coolDown = 1.5;
-	abilities[ICE_BREATH].timeLastUsed = 0;
-
-	//Reflection Shield
-	strcpy(abilities[REFLECTION_SHIELD].name, "Reflection Shield");
-	strcpy(abilities[REFLECTION_SHIELD].description, 
-		"Activate to deflect certain projectiles.\n\n\nMana Cost: 35/second");
-	abilities[REFLECTION_SHIELD].type = HOLD;
-	abilities[REFLECTION_SHIELD].manaCost = 15;
-	abilities[REFLECTION_SHIELD].coolDown = 0;
-
-	//Hover
-	strcpy(abilities[HOVER].name, "Hover");
-	strcpy(abilities[HOVER].description, 
-		"Grants you the power to use hover pads.");
-	abilities[HOVER].type = HOLD;
-	abilities[HOVER].manaCost = 0;
-	abilities[HOVER].coolDown = 0;
-
-	//Lightning Orbs
-	strcpy(abilities[LIGHTNING_ORB].name, "Lightning Orbs");
-	strcpy(abilities[LIGHTNING_ORB].description, 
-		"Shoots orbs of lightning. \n\n\nMana Cost: 5\n");
-	strcat(abilities[LIGHTNING_ORB].description, "Damage: ");
-	strcat(abilities[LIGHTNING_ORB].description, Util::intToString(smh->player->getLightningOrbDamage() * 100).c_str());
-	abilities[LIGHTNING_ORB].type = ACTIVATED;
-	abilities[LIGHTNING_ORB].manaCost = 5;
-	abilities[LIGHTNING_ORB].coolDown = 0.10;
-	abilities[LIGHTNING_ORB].timeLastUsed = 0;
-
-	//Shrink
-	strcpy(abilities[SHRINK].name, "Shrink");
-	strcpy(abilities[SHRINK].description, "When activated Smiley will shrink in size and be able to fit into smaller spaces.");
-	abilities[SHRINK].type = ACTIVATED;
-	abilities[SHRINK].manaCost = 0;
-	abilities[SHRINK].coolDown = 0;
-
-	//Silly Pad
-	strcpy(abilities[SILLY_PAD].name, "Silly Pad");
-	strcpy(abilities[SILLY_PAD].description, 
-		"Places a Silly Pad. They are so silly that enemies can't even cross them!\n\nMana Cost: 5");
-	abilities[SILLY_PAD].type = ACTIVATED;
-	abilities[SILLY_PAD].manaCost = 5;
-	abilities[SILLY_PAD].coolDown = 0;
-
-	//King Tut's Mask
-	strcpy(abilities[TUTS_MASK].name, "Tut's Mask");
-	strcpy(abilities[TUTS_MASK].description, 
-		"Grants the wearer the power of invisibility.\n\n\nMana Cost: 5/second");
-	abilities[TUTS_MASK].type = HOLD;
-	abilities[TUTS_MASK].manaCost = 5;
-	abilities[TUTS_MASK].coolDown = 0;
-	
-	//Frisbee
-	strcpy(abilities[FRISBEE].name, "Frisbee!?!?! K");
-	strcpy(abilities[FRISBEE].description, "Throws a frisbee that can stun enemies.");
-	abilities[FRISBEE].type = HOLD;
-	abilities[FRISBEE].manaCost = 0;
-	abilities[FRISBEE].coolDown = 0;
-	abilities[FRISBEE].timeLastUsed = 0;
-}
-
 /**
  * Sets the time an ability was last used
  */
@@ -219,19 +153,16 @@ void GameData::setTimeLastUsedAbility(int abilityID, float time) {
 	abilities[abilityID].timeLastUsed = time;
 }
 
-////////// Private functions //////////////////
-
 /**
- * Loads enemy data from file "Enemy.dat"
+ * Fills in the enemy info from Enemies.dat once parseEnemyTable() has read it.
  */
 void GameData::loadEnemyData() 
 {
-	char num[2];
+	char num[4];
 	char param[68];
 	std::string varName;
 
-	enemyStringTable = new hgeStringTable("Data/Enemies.dat");
-	int numEnemies = atoi(enemyStringTable->GetString("numEnemies"));
+	int numEnemies = atoi(enemyStringTable.getString("numEnemies"));
 
 	for (int i = 0; i < numEnemies; i++) 
 	{
@@ -240,136 +171,136 @@ void GameData::loadEnemyData()
 		//Enemy name
 		varName = Util::intToString(i);
 		varName += "Name";
-		if (enemyStringTable->GetString(varName.c_str()) != 0) 
+		if (enemyStringTable.getString(varName.c_str()) != 0) 
 		{
-			addEnemyName(i, enemyStringTable->GetString(varName.c_str()));
+			addEnemyName(i, enemyStringTable.getString(varName.c_str()));
 		}
 
 		//Has one graphic?
 		varName = Util::intToString(i);
 		varName += "OneGraphic";
-		if (enemyStringTable->GetString(varName.c_str()) == 0) enemyInfo[i].hasOneGraphic = false;
-		else enemyInfo[i].hasOneGraphic = (strcmp(enemyStringTable->GetString(varName.c_str()), "T") == 0);
+		if (enemyStringTable.getString(varName.c_str()) == 0) enemyInfo[i].hasOneGraphic = false;
+		else enemyInfo[i].hasOneGraphic = (strcmp(enemyStringTable.getString(varName.c_str()), "T") == 0);
 		
 		//Graphics column
 		varName = Util::intToString(i);
 		varName += "GCol";
-		enemyInfo[i].gCol = atoi(enemyStringTable->GetString(varName.c_str()));
+		enemyInfo[i].gCol = atoi(enemyStringTable.getString(varName.c_str()));
 
 		//Graphics row
 		varName = Util::intToString(i);
 		varName += "GRow";
-		enemyInfo[i].gRow = atoi(enemyStringTable->GetString(varName.c_str()));
+		enemyInfo[i].gRow = atoi(enemyStringTable.getString(varName.c_str()));
 
 		//Number animation frames (default 1)
 		varName = Util::intToString(i);
 		varName += "NumFrames";
-		if (enemyStringTable->GetString(varName.c_str()) == 0) enemyInfo[i].numFrames = 1;
-		else enemyInfo[i].numFrames = atoi(enemyStringTable->GetString(varName.c_str()));
+		if (enemyStringTable.getString(varName.c_str()) == 0) enemyInfo[i].numFrames = 1;
+		else enemyInfo[i].numFrames = atoi(enemyStringTable.getString(varName.c_str()));
 
 		//Enemy Type
 		varName = Util::intToString(i);
 		varName += "EnemyType";
-		enemyInfo[i].enemyType = atoi(enemyStringTable->GetString(varName.c_str()));
+		enemyInfo[i].enemyType = atoi(enemyStringTable.getString(varName.c_str()));
 		
 		//WanderType
 		varName = Util::intToString(i);
 		varName += "WanderType";
-		enemyInfo[i].wanderType = atoi(enemyStringTable->GetString(varName.c_str()));
+		enemyInfo[i].wanderType = atoi(enemyStringTable.getString(varName.c_str()));
 		
 		//HP
 		varName = Util::intToString(i);
 		varName += "HP";
-		enemyInfo[i].hp = atoi(enemyStringTable->GetString(varName.c_str()));
+		enemyInfo[i].hp = atoi(enemyStringTable.getString(varName.c_str()));
 		
 		//Damage
 		varName = Util::intToString(i);
 		varName += "Damage";
-		enemyInfo[i].damage = atoi(enemyStringTable->GetString(varName.c_str()));
+		enemyInfo[i].damage = atoi(enemyStringTable.getString(varName.c_str()));
 		
 		//Speed
 		varName = Util::intToString(i);
 		varName += "Speed";
-		enemyInfo[i].speed = atoi(enemyStringTable->GetString(varName.c_str()));
+		enemyInfo[i].speed = atoi(enemyStringTable.getString(varName.c_str()));
 		
 		//Radius
 		varName = Util::intToString(i);
 		varName += "Radius";
-		enemyInfo[i].radius = atoi(enemyStringTable->GetString(varName.c_str()));
+		enemyInfo[i].radius = atoi(enemyStringTable.getString(varName.c_str()));
 		
 		//Can walk on Land
 		varName = Util::intToString(i);
 		varName += "Land";
-		if (enemyStringTable->GetString(varName.c_str()) == 0) enemyInfo[i].land = false;
-		else enemyInfo[i].land = (strcmp(enemyStringTable->GetString(varName.c_str()), "T") == 0);
+		if (enemyStringTable.getString(varName.c_str()) == 0) enemyInfo[i].land = false;
+		else enemyInfo[i].land = (strcmp(enemyStringTable.getString(varName.c_str()), "T") == 0);
 		
 		//Can walk on Lava
 		varName = Util::intToString(i);
 		varName += "Lava";
-		if (enemyStringTable->GetString(varName.c_str()) == 0) enemyInfo[i].lava = false;
-		else enemyInfo[i].lava = (strcmp(enemyStringTable->GetString(varName.c_str()), "T") == 0);
+		if (enemyStringTable.getString(varName.c_str()) == 0) enemyInfo[i].lava = false;
+		else enemyInfo[i].lava = (strcmp(enemyStringTable.getString(varName.c_str()), "T") == 0);
 
 		//Can walk on Mushrooms
 		varName = Util::intToString(i);
 		varName += "Mushrooms";
-		if (enemyStringTable->GetString(varName.c_str()) == 0) enemyInfo[i].mushrooms = false;
-		else enemyInfo[i].mushrooms = (strcmp(enemyStringTable->GetString(varName.c_str()), "T") == 0);
+		if (enemyStringTable.getString(varName.c_str()) == 0) enemyInfo[i].mushrooms = false;
+		else enemyInfo[i].mushrooms = (strcmp(enemyStringTable.getString(varName.c_str()), "T") == 0);
 		
 		//Can walk on Shallow Water
 		varName = Util::intToString(i);
 		varName += "SWater";
-		if (enemyStringTable->GetString(varName.c_str()) == 0) enemyInfo[i].shallowWater = false;
-		else enemyInfo[i].shallowWater = (strcmp(enemyStringTable->GetString(varName.c_str()), "T") == 0);
+		if (enemyStringTable.getString(varName.c_str()) == 0) enemyInfo[i].shallowWater = false;
+		else enemyInfo[i].shallowWater = (strcmp(enemyStringTable.getString(varName.c_str()), "T") == 0);
 		
 		//Can walk on Deep Water
 		varName = Util::intToString(i);
 		varName += "DWater";
-		if (enemyStringTable->GetString(varName.c_str()) == 0) enemyInfo[i].deepWater = false;
-		else enemyInfo[i].deepWater = (strcmp(enemyStringTable->GetString(varName.c_str()), "T") == 0);
+		if (enemyStringTable.getString(varName.c_str()) == 0) enemyInfo[i].deepWater = false;
+		else enemyInfo[i].deepWater = (strcmp(enemyStringTable.getString(varName.c_str()), "T") == 0);
 		
 		//Can walk on Slime
 		varName = Util::intToString(i);
 		varName += "Slime";
-		if (enemyStringTable->GetString(varName.c_str()) == 0) enemyInfo[i].slime = false;
-		else enemyInfo[i].slime = (strcmp(enemyStringTable->GetString(varName.c_str()), "T") == 0);
+		if (enemyStringTable.getString(varName.c_str()) == 0) enemyInfo[i].slime = false;
+		else enemyInfo[i].slime = (strcmp(enemyStringTable.getString(varName.c_str()), "T") == 0);
 	
 		//Immune to smiley's tongue
 		varName = Util::intToString(i);
 		varName += "ImmuneTongue";
-		if (enemyStringTable->GetString(varName.c_str()) == 0) enemyInfo[i].immuneToTongue = false;
-		else enemyInfo[i].immuneToTongue = (strcmp(enemyStringTable->GetString(varName.c_str()), "T") == 0);
+		if (enemyStringTable.getString(varName.c_str()) == 0) enemyInfo[i].immuneToTongue = false;
+		else enemyInfo[i].immuneToTongue = (strcmp(enemyStringTable.getString(varName.c_str()), "T") == 0);
 
 		//Immune to fire
 		varName = Util::intToString(i);
 		varName += "ImmuneFire";
-		if (enemyStringTable->GetString(varName.c_str()) == 0) enemyInfo[i].immuneToFire = false;
-		else enemyInfo[i].immuneToFire = (strcmp(enemyStringTable->GetString(varName.c_str()), "T") == 0);
+		if (enemyStringTable.getString(varName.c_str()) == 0) enemyInfo[i].immuneToFire = false;
+		else enemyInfo[i].immuneToFire = (strcmp(enemyStringTable.getString(varName.c_str()), "T") == 0);
 
 		//Immune to lightning
 		varName = Util::intToString(i);
 		varName += "ImmuneLightning";
-		if (enemyStringTable->GetString(varName.c_str()) == 0) enemyInfo[i].immuneToLightning = false;
-		else enemyInfo[i].immuneToLightning = (strcmp(enemyStringTable->GetString(varName.c_str()), "T") == 0);
+		if (enemyStringTable.getString(varName.c_str()) == 0) enemyInfo[i].immuneToLightning = false;
+		else enemyInfo[i].immuneToLightning = (strcmp(enemyStringTable.getString(varName.c_str()), "T") == 0);
 		
 		//Immune to stun
 		varName = Util::intToString(i);
 		varName += "ImmuneStun";
-		if (enemyStringTable->GetString(varName.c_str()) == 0) enemyInfo[i].immuneToStun = false;
-		else enemyInfo[i].immuneToStun = (strcmp(enemyStringTable->GetString(varName.c_str()), "T") == 0);
+		if (enemyStringTable.getString(varName.c_str()) == 0) enemyInfo[i].immuneToStun = false;
+		else enemyInfo[i].immuneToStun = (strcmp(enemyStringTable.getString(varName.c_str()), "T") == 0);
 			
 		//Immune to freeze
 		varName = Util::intToString(i);
 		varName += "ImmuneFreeze";
-		if (enemyStringTable->GetString(varName.c_str()) == 0) enemyInfo[i].immuneToFreeze = false;
-		else enemyInfo[i].immuneToFreeze = (strcmp(enemyStringTable->GetString(varName.c_str()), "T") == 0);
+		if (enemyStringTable.getString(varName.c_str()) == 0) enemyInfo[i].immuneToFreeze = false;
+		else enemyInfo[i].immuneToFreeze = (strcmp(enemyStringTable.getString(varName.c_str()), "T") == 0);
 
 		//Invincible
 		varName = Util::intToString(i);
 		varName += "Invincible";
-		if (enemyStringTable->GetString(varName.c_str()) == 0) enemyInfo[i].invincible = false;
+		if (enemyStringTable.getString(varName.c_str()) == 0) enemyInfo[i].invincible = false;
 		else 
 		{
-			enemyInfo[i].invincible = (strcmp(enemyStringTable->GetString(varName.c_str()), "T") == 0);
+			enemyInfo[i].invincible = (strcmp(enemyStringTable.getString(varName.c_str()), "T") == 0);
 			if (enemyInfo[i].invincible) 
 			{
 				enemyInfo[i].immuneToFire = enemyInfo[i].immuneToFreeze = enemyInfo[i].immuneToLightning = enemyInfo[i].immuneToStun = enemyInfo[i].immuneToTongue = true;
@@ -379,32 +310,32 @@ void GameData::loadEnemyData()
 		//Variable 1
 		varName = Util::intToString(i);
 		varName += "Variable1";
-		if (enemyStringTable->GetString(varName.c_str()) == 0) enemyInfo[i].variable1 = 0;
-		else enemyInfo[i].variable1 = atoi(enemyStringTable->GetString(varName.c_str()));
+		if (enemyStringTable.getString(varName.c_str()) == 0) enemyInfo[i].variable1 = 0;
+		else enemyInfo[i].variable1 = atoi(enemyStringTable.getString(varName.c_str()));
 
 		//Variable 2
 		varName = Util::intToString(i);
 		varName += "Variable2";
-		if (enemyStringTable->GetString(varName.c_str()) == 0) enemyInfo[i].variable2 = 0;
-		else enemyInfo[i].variable2 = atoi(enemyStringTable->GetString(varName.c_str()));
+		if (enemyStringTable.getString(varName.c_str()) == 0) enemyInfo[i].variable2 = 0;
+		else enemyInfo[i].variable2 = atoi(enemyStringTable.getString(varName.c_str()));
 
 		//Variable 3
 		varName = Util::intToString(i);
 		varName += "Variable3";
-		if (enemyStringTable->GetString(varName.c_str()) == 0) enemyInfo[i].variable3 = 0;
-		else enemyInfo[i].variable3 = atoi(enemyStringTable->GetString(varName.c_str()));
+		if (enemyStringTable.getString(varName.c_str()) == 0) enemyInfo[i].variable3 = 0;
+		else enemyInfo[i].variable3 = atoi(enemyStringTable.getString(varName.c_str()));
 					
 		//Has a ranged attack
 		varName = Util::intToString(i);
 		varName += "HasRanged";
-		if (enemyStringTable->GetString(varName.c_str()) == 0) enemyInfo[i].hasRangedAttack = false;
-		else enemyInfo[i].hasRangedAttack = (strcmp(enemyStringTable->GetString(varName.c_str()), "T") == 0);
+		if (enemyStringTable.getString(varName.c_str()) == 0) enemyInfo[i].hasRangedAttack = false;
+		else enemyInfo[i].hasRangedAttack = (strcmp(enemyStringTable.getString(varName.c_str()), "T") == 0);
 			
 		//Will chase smiley
 		varName = Util::intToString(i);
 		varName += "Chases";
-		if (enemyStringTable->GetString(varName.c_str()) == 0) enemyInfo[i].chases = false;
-		else enemyInfo[i].chases = (strcmp(enemyStringTable->GetString(varName.c_str()), "T") == 0);
+		if (enemyStringTable.getString(varName.c_str()) == 0) enemyInfo[i].chases = false;
+		else enemyInfo[i].chases = (strcmp(enemyStringTable.getString(varName.c_str()), "T") == 0);
 		
 		//Load ranged info for ranged enemies
 		if (enemyInfo[i].hasRangedAttack) 
@@ -412,35 +343,37 @@ void GameData::loadEnemyData()
 			//Ranged Attack Type
 			varName = Util::intToString(i);
 			varName += "PType";
-			if (enemyStringTable->GetString(varName.c_str()) == 0) enemyInfo[i].rangedType = PROJECTILE_1;
-			else enemyInfo[i].rangedType = atoi(enemyStringTable->GetString(varName.c_str()));
+			if (enemyStringTable.getString(varName.c_str()) == 0) enemyInfo[i].rangedType = PROJECTILE_1;
+			else enemyInfo[i].rangedType = atoi(enemyStringTable.getString(varName.c_str()));
 			//Ranged Attack Range
 			strcpy(param, num);
 			strcat(param, "Range");
-			enemyInfo[i].range = atoi(enemyStringTable->GetString(param));
+			enemyInfo[i].range = atoi(enemyStringTable.getString(param));
 			//Ranged Attack Delay
 			strcpy(param, num);
 			strcat(param, "Delay");
-			enemyInfo[i].delay = atoi(enemyStringTable->GetString(param));
+			enemyInfo[i].delay = atoi(enemyStringTable.getString(param));
 			//Projectile Speed
 			strcpy(param, num);
 			strcat(param, "PSpeed");
-			enemyInfo[i].projectileSpeed = atoi(enemyStringTable->GetString(param));
+			enemyInfo[i].projectileSpeed = atoi(enemyStringTable.getString(param));
 			//Projectile Damage
 			strcpy(param, num);
 			strcat(param, "PDamage");
-			enemyInfo[i].projectileDamage = (float)atoi(enemyStringTable->GetString(param)) / 100.0;
+			enemyInfo[i].projectileDamage = (float)atoi(enemyStringTable.getString(param)) / 100.0;
 
 			//Does the ranged attack home?
 			varName = Util::intToString(i);
 			varName += "PHoming";
-			if (enemyStringTable->GetString(varName.c_str()) == 0) enemyInfo[i].projectileHoming = false;
-			else enemyInfo[i].projectileHoming = (strcmp(enemyStringTable->GetString(varName.c_str()), "T") == 0);
+			if (enemyStringTable.getString(varName.c_str()) == 0) enemyInfo[i].projectileHoming = false;
+			else enemyInfo[i].projectileHoming = (strcmp(enemyStringTable.getString(varName.c_str()), "T") == 0);
 			
 		}
 	}
 }
 
+////////// Private functions //////////////////
+
 void GameData::initializeGemCounts() 
 {
 	totalGemCounts[FOUNTAIN_AREA][0] = 9;
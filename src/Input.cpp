@@ -28,7 +28,8 @@ SmileyInput::SmileyInput()
 	
 	//Initialize input states
 	for (int i = 0; i < NUM_INPUTS; i++)
-		inputs[i].pressed = inputs[i].prevPressed = false;
+		inputs[i].pressed = inputs[i].prevPressed = scriptedPressed[i] = false;
+	scripted = false;
 	for (int i = 0; i < 128; i++)
 		gamePadButtonPressed[i] = false;
 	for (int i = 0; i < 4; i++)
@@ -73,6 +74,13 @@ void SmileyInput::UpdateInput() {
 		inputs[i].prevPressed = inputs[i].pressed;
 	}
 
+	//Scripted inputs replace the keyboard and gamepad entirely
+	if (scripted) {
+		for (int i = 0; i < NUM_INPUTS; i++) {
+			inputs[i].pressed = scriptedPressed[i];
+		}
+		return;
+	}
 
 	HRESULT     hr;
 	CHAR        strText[128]; // Device state text
@@ -351,6 +359,26 @@ void SmileyInput::setMousePosition(float x, float y) {
 	smh->hge->Input_SetMousePos(x, y);
 }
 
+//-----------------------------------------------------------------------------
+// Name: setScripted()
+// Desc: While scripted, inputs come from setScriptedInput() instead of the
+//       keyboard and gamepad.
+//-----------------------------------------------------------------------------
+void SmileyInput::setScripted(bool _scripted) {
+	scripted = _scripted;
+	for (int i = 0; i < NUM_INPUTS; i++) {
+		scriptedPressed[i] = false;
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Name: setScriptedInput()
+// Desc: Sets whether a scripted input will be down on the next update.
+//-----------------------------------------------------------------------------
+void SmileyInput::setScriptedInput(int input, bool pressed) {
+	scriptedPressed[input] = pressed;
+}
+
 //-----------------------------------------------------------------------------
 // Name: saveInputs()
 // Desc: Saves the input values to Smiley.ini
@@ -44,6 +44,8 @@ bool LoadingScreen::update(float dt, float mouseX, float mouseY)
 		} else {
 			smh->saveManager->load(fileNumber);
 		}
+		//Parse the area in the background while the load screen is up
+		smh->areaLoader->prefetch(smh->saveManager->currentArea);
 		startedLoadYet = true;
 	}
 
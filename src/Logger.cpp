@@ -0,0 +1,248 @@
+#include "SmileyEngine.h"
+#include <stdio.h>
+#include <stdarg.h>
+
+extern SMH *smh;
+
+#define LOG_FLUSH_INTERVAL 100		//milliseconds between background flushes
+#define LOG_SHUTDOWN_TIMEOUT 2000
+
+static const char *levelNames[4] = { "DEBUG", "INFO", "WARNING", "ERROR" };
+
+static const char *categoryNames[NUM_LOG_CATEGORIES] = {
+	"General", "Engine", "Environment", "Enemies", "Bosses", "Player", "Save", "Resources", "Profiler"
+};
+
+/**
+ * Opens the log file for appending and starts the flusher thread.
+ */
+Logger::Logger(const char *fileName) {
+
+	queue = new LogMessage[LOG_QUEUE_SIZE];
+	for (int i = 0; i < LOG_QUEUE_SIZE; i++) {
+		queue[i].ready = 0;
+	}
+	for (int i = 0; i < LOG_RATE_TABLE_SIZE; i++) {
+		rateLimits[i].hash = 0;
+		rateLimits[i].windowStart = 0;
+		rateLimits[i].count = 0;
+		rateLimits[i].sample[0] = '\0';
+	}
+
+	writeIndex = readIndex = 0;
+	numDropped = 0;
+	logFile = fileName ? fopen(fileName, "a") : NULL;
+	InitializeCriticalSection(&fileLock);
+
+	running = true;
+	wakeEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+	flusherThread = CreateThread(NULL, 0, flusherThreadProc, this, 0, NULL);
+	if (flusherThread == NULL) {
+		//Without a flusher every message is drained synchronously by write()
+		running = false;
+	}
+
+}
+
+Logger::~Logger() {
+	shutdown();
+	DeleteCriticalSection(&fileLock);
+	delete[] queue;
+}
+
+/**
+ * Logs a printf style message at the given level and category.
+ */
+void Logger::write(int level, int category, const char *format, ...) {
+	va_list args;
+	va_start(args, format);
+	log(level, category, format, args);
+	va_end(args);
+}
+
+/**
+ * Logs a debug message. Call this through the LOG_DEBUG macro so that it is
+ * compiled out of release builds.
+ */
+void Logger::debug(int category, const char *format, ...) {
+	va_list args;
+	va_start(args, format);
+	log(LogLevels::Debug, category, format, args);
+	va_end(args);
+}
+
+/**
+ * Synchronously writes everything that is queued. This is safe to call from the
+ * fatal error handlers while the flusher thread is still running.
+ */
+void Logger::flush() {
+	drain();
+}
+
+/**
+ * Stops the flusher thread, writes out anything left in the queue and closes
+ * the log file.
+ */
+void Logger::shutdown() {
+
+	if (flusherThread) {
+		running = false;
+		SetEvent(wakeEvent);
+		WaitForSingleObject(flusherThread, LOG_SHUTDOWN_TIMEOUT);
+		CloseHandle(flusherThread);
+		CloseHandle(wakeEvent);
+		flusherThread = NULL;
+		wakeEvent = NULL;
+	}
+
+	drain();
+
+	EnterCriticalSection(&fileLock);
+	if (logFile) {
+		fclose(logFile);
+		logFile = NULL;
+	}
+	LeaveCriticalSection(&fileLock);
+
+}
+
+DWORD WINAPI Logger::flusherThreadProc(LPVOID param) {
+	Logger *logger = (Logger*)param;
+	while (logger->running) {
+		WaitForSingleObject(logger->wakeEvent, LOG_FLUSH_INTERVAL);
+		logger->drain();
+	}
+	return 0;
+}
+
+void Logger::log(int level, int category, const char *format, va_list args) {
+
+	char text[LOG_MESSAGE_LENGTH];
+	_vsnprintf(text, LOG_MESSAGE_LENGTH - 1, format, args);
+	text[LOG_MESSAGE_LENGTH - 1] = '\0';
+
+	if (isRateLimited(text)) return;
+
+	enqueue(level, category, text);
+
+	if (!running) {
+		drain();
+	} else if (level >= LogLevels::Warning) {
+		//Don't make warnings and errors wait for the next periodic flush
+		SetEvent(wakeEvent);
+	}
+
+}
+
+/**
+ * Claims the next free slot in the queue and copies the message into it. Any
+ * number of threads may do this at once. If the queue is full the message is
+ * dropped and counted rather than blocking the caller.
+ */
+void Logger::enqueue(int level, int category, const char *text) {
+
+	LONG slot;
+	for (;;) {
+		slot = writeIndex;
+		if (slot - readIndex >= LOG_QUEUE_SIZE) {
+			InterlockedIncrement(&numDropped);
+			return;
+		}
+		if (InterlockedCompareExchange(&writeIndex, slot + 1, slot) == slot) break;
+	}
+
+	LogMessage *message = &queue[slot & (LOG_QUEUE_SIZE - 1)];
+	message->level = level;
+	message->category = category;
+	strncpy(message->text, text, LOG_MESSAGE_LENGTH - 1);
+	message->text[LOG_MESSAGE_LENGTH - 1] = '\0';
+
+	//Publish the message to the flusher
+	InterlockedExchange(&message->ready, 1);
+
+}
+
+/**
+ * Returns whether an identical message has already been logged LOG_RATE_LIMIT times
+ * this second. When a limited message's window rolls over, the number of copies that
+ * were suppressed is logged. Counting is best effort when several threads log the
+ * same message at once.
+ */
+bool Logger::isRateLimited(const char *text) {
+
+	//FNV-1a hash of the message
+	DWORD hash = 2166136261;
+	for (const char *c = text; *c; c++) {
+		hash = (hash ^ (unsigned char)*c) * 16777619;
+	}
+
+	LogRateLimit *rateLimit = &rateLimits[hash & (LOG_RATE_TABLE_SIZE - 1)];
+	DWORD now = GetTickCount();
+
+	if (rateLimit->hash != hash || now - rateLimit->windowStart > 1000) {
+		if (rateLimit->hash == hash && rateLimit->count > LOG_RATE_LIMIT) {
+			char suppressed[LOG_MESSAGE_LENGTH];
+			_snprintf(suppressed, LOG_MESSAGE_LENGTH - 1, "(suppressed %d copies of \"%s\")",
+				rateLimit->count - LOG_RATE_LIMIT, rateLimit->sample);
+			suppressed[LOG_MESSAGE_LENGTH - 1] = '\0';
+			enqueue(LogLevels::Warning, LogCategories::General, suppressed);
+		}
+		rateLimit->hash = hash;
+		rateLimit->windowStart = now;
+		rateLimit->count = 0;
+		strncpy(rateLimit->sample, text, sizeof(rateLimit->sample) - 1);
+		rateLimit->sample[sizeof(rateLimit->sample) - 1] = '\0';
+	}
+
+	return InterlockedIncrement(&rateLimit->count) > LOG_RATE_LIMIT;
+}
+
+/**
+ * Writes every published message to the log file in order. Only one thread can
+ * drain at a time, so the fatal error handlers can flush without racing the
+ * flusher thread.
+ */
+void Logger::drain() {
+
+	EnterCriticalSection(&fileLock);
+
+	bool wroteSomething = false;
+	while (readIndex != writeIndex) {
+		LogMessage *message = &queue[readIndex & (LOG_QUEUE_SIZE - 1)];
+
+		//The slot was claimed but its producer hasn't finished copying yet
+		if (!message->ready) break;
+
+		writeMessage(message->level, message->category, message->text);
+		wroteSomething = true;
+
+		InterlockedExchange(&message->ready, 0);
+		InterlockedIncrement(&readIndex);
+	}
+
+	if (numDropped > 0) {
+		char text[64];
+		sprintf(text, "Log queue overflowed, dropped %d messages", InterlockedExchange(&numDropped, 0));
+		writeMessage(LogLevels::Warning, LogCategories::General, text);
+		wroteSomething = true;
+	}
+
+	if (wroteSomething && logFile) fflush(logFile);
+
+	LeaveCriticalSection(&fileLock);
+
+}
+
+void Logger::writeMessage(int level, int category, const char *text) {
+
+	if (!logFile) return;
+
+	if (level == LogLevels::Info && category == LogCategories::General) {
+		fprintf(logFile, "%s\n", text);
+	} else if (level == LogLevels::Info) {
+		fprintf(logFile, "[%s] %s\n", categoryNames[category], text);
+	} else {
+		fprintf(logFile, "[%s][%s] %s\n", levelNames[level], categoryNames[category], text);
+	}
+
+}
@@ -66,7 +66,7 @@ extern SMH *smh;
 #define CRUSHER_REMAIN_TIME 1.0
 
 LovecraftBoss::LovecraftBoss(int _gridX, int _gridY, int _groupID) {
-	smh->log("lovecraft init");
+	LOG_DEBUG(LogCategories::Bosses, "lovecraft init");
 	x = _gridX * 64 + 64;
 	y = _gridY * 64 + 32;
 	groupID = _groupID;
@@ -101,6 +101,20 @@ LovecraftBoss::LovecraftBoss(int _gridX, int _gridY, int _groupID) {
 	bodyDistortionMesh->SetTexture(smh->resources->GetTexture("LovecraftTx"));
 	bodyDistortionMesh->SetTextureRect(1,1,190,190);
 
+	//The last two columns of the body and the last row of each tentacle don't move
+	bodyWave = new MeshWave(BODY_MESH_GRANULARITY, BODY_MESH_GRANULARITY, 3.0, 3.0);
+	for (int i = 0; i < BODY_MESH_GRANULARITY; i++) {
+		for(int j = 0; j < BODY_MESH_GRANULARITY-2; j++) {
+			bodyWave->setNode(j, i, (i+j)/3, 1.2, (i+j)/3, 1.2);
+		}
+	}
+	tentacleWave = new MeshWave(TENTACLE_MESH_X_GRANULARITY, TENTACLE_MESH_Y_GRANULARITY, 3.0, 3.0);
+	for (int x = 0; x < TENTACLE_MESH_X_GRANULARITY; x++) {
+		for(int y = 0; y < TENTACLE_MESH_Y_GRANULARITY-1; y++) {
+			tentacleWave->setNode(x, y, TENTACLE_MESH_Y_GRANULARITY-y, 2.5*y, (x+y)/2, 2.0);
+		}
+	}
+
 	//Close all the eyes
 	smh->resources->GetAnimation(LIGHTNING_EYE)->SetFrame(4);
 	smh->resources->GetAnimation(FIRE_EYE)->SetFrame(4);
@@ -121,8 +135,10 @@ LovecraftBoss::~LovecraftBoss() {
 	
 	//Turn off any screen coloring
 	smh->setScreenColor(0, 0.0);
-	smh->hge->System_Log("125 setScreenColor 0,0");
+	LOG_DEBUG(LogCategories::Bosses, "125 setScreenColor 0,0");
 	delete bodyDistortionMesh;
+	delete bodyWave;
+	delete tentacleWave;
 	delete eyeCollisionBox;
 	delete bodyCollisionBox;
 	
@@ -174,17 +190,8 @@ void LovecraftBoss::drawAfterSmiley(float dt) {
 void LovecraftBoss::drawBody(float dt) {
 	
 	//Update body distortion mesh
-	for (int i = 0; i < BODY_MESH_GRANULARITY; i++) {
-		for(int j = 0; j < BODY_MESH_GRANULARITY-2; j++) {
-			bodyDistortionMesh->SetDisplacement(
-				j, //column
-				i, //row
-				cosf(smh->getRealTime()*3+(i+j)/3)*1.2, //dx
-				sinf(smh->getRealTime()*3+(i+j)/3)*1.2, //dy
-				HGEDISP_NODE
-			);
-		}
-	}
+	bodyWave->update(smh->getRealTime());
+	bodyWave->apply(bodyDistortionMesh);
 
 	float flashAlpha = flashing ? smh->getFlashingAlpha(0.15) : 255.0;
 	for (int i = 0; i < BODY_MESH_GRANULARITY; i++) {
@@ -202,16 +209,8 @@ void LovecraftBoss::drawTentacles(float dt) {
 
 		//Update distortion mesh when the tentacles are fully extended
 		float t = smh->timePassedSince(i->timeCreated) + i->randomTimeOffset;
-		for (int x = 0; x < TENTACLE_MESH_X_GRANULARITY; x++) {
-			for(int y = 0; y < TENTACLE_MESH_Y_GRANULARITY-1; y++) {
-				i->mesh->SetDisplacement(
-					x, //column
-					y, //row
-					cosf(t*3.0+(TENTACLE_MESH_Y_GRANULARITY-y))*2.5*y, //dx
-					sinf(t*3.0+(x+y)/2)*2, //dy					
-					HGEDISP_NODE); //reference
-			}
-		}
+		tentacleWave->update(t);
+		tentacleWave->apply(i->mesh);
 
 		float flashAlpha = flashing ? smh->getFlashingAlpha(0.15) : 255.0;
 		for (int x = 0; x < TENTACLE_MESH_X_GRANULARITY; x++) {
@@ -689,13 +688,13 @@ void LovecraftBoss::doEyeAttackState(float dt) {
 //~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~
 
 void LovecraftBoss::enterState(int newState) {
-	//smh->hge->System_Log("Lovecraft enter state %d", newState);
+	//LOG_DEBUG(LogCategories::Bosses, "Lovecraft enter state %d", newState);
 	
 	
 	if (state == LS_EYE_ATTACK) {
 		//Turn off any screen coloring when leaving the eye attack state.
 		smh->setScreenColor(0, 0.0);
-		smh->hge->System_Log("697 setScreenColor 0,0");
+		LOG_DEBUG(LogCategories::Bosses, "697 setScreenColor 0,0");
 	}
 	
 	timeInState = 0.0;
@@ -114,6 +114,8 @@ private:
 	std::list<BigFireBall> fireballList;
 	std::list<Crusher> crusherList;
 	hgeDistortionMesh *bodyDistortionMesh;
+	MeshWave *bodyWave;
+	MeshWave *tentacleWave;
 	hgeRect *eyeCollisionBox;
 	hgeRect *bodyCollisionBox;
 	Point tentaclePoints[5];
@@ -0,0 +1,137 @@
+#include "SmileyEngine.h"
+
+#define LZ4_MIN_MATCH 4
+#define LZ4_LAST_LITERALS 5			//The block has to end with at least this many literals
+#define LZ4_MATCH_LIMIT 12			//and the last match has to start at least this far from the end
+#define LZ4_MAX_OFFSET 65535
+
+static DWORD read32(const BYTE *p) {
+	DWORD value;
+	memcpy(&value, p, sizeof(DWORD));
+	return value;
+}
+
+/**
+ * Writes the bytes that follow a 15 in a token to make up a longer length.
+ */
+static void writeLength(std::vector<BYTE> &out, int length) {
+	length -= 15;
+	while (length >= 255) {
+		out.push_back(255);
+		length -= 255;
+	}
+	out.push_back((BYTE)length);
+}
+
+static void writeSequence(std::vector<BYTE> &out, const BYTE *literals, int numLiterals, int offset, int matchLength) {
+
+	//The last sequence has literals but no match
+	int matchCode = matchLength > 0 ? matchLength - LZ4_MIN_MATCH : 0;
+	out.push_back((BYTE)(((numLiterals < 15 ? numLiterals : 15) << 4) | (matchCode < 15 ? matchCode : 15)));
+	if (numLiterals >= 15) writeLength(out, numLiterals);
+	out.insert(out.end(), literals, literals + numLiterals);
+
+	if (matchLength == 0) return;
+
+	out.push_back((BYTE)(offset & 0xFF));
+	out.push_back((BYTE)(offset >> 8));
+	if (matchCode >= 15) writeLength(out, matchCode);
+}
+
+/**
+ * Compresses into an LZ4 block. Each 4 byte sequence is looked up in a table of
+ * where it was last seen, and the first match found is used.
+ */
+void Lz4::compress(const BYTE *source, int sourceSize, std::vector<BYTE> &compressed) {
+
+	compressed.clear();
+	compressed.reserve(sourceSize + sourceSize / 255 + 16);
+
+	std::vector<int> lastSeen(1 << LZ4_HASH_BITS, -1);
+	int anchor = 0;
+	int pos = 0;
+
+	while (pos < sourceSize - LZ4_MATCH_LIMIT) {
+
+		DWORD sequence = read32(source + pos);
+		int hash = (int)((sequence * 2654435761U) >> (32 - LZ4_HASH_BITS));
+		int candidate = lastSeen[hash];
+		lastSeen[hash] = pos;
+
+		if (candidate < 0 || pos - candidate > LZ4_MAX_OFFSET || read32(source + candidate) != sequence) {
+			pos++;
+			continue;
+		}
+
+		int length = LZ4_MIN_MATCH;
+		while (pos + length < sourceSize - LZ4_LAST_LITERALS && source[candidate + length] == source[pos + length]) {
+			length++;
+		}
+
+		writeSequence(compressed, source + anchor, pos - anchor, pos - candidate, length);
+		pos += length;
+		anchor = pos;
+	}
+
+	writeSequence(compressed, source + anchor, sourceSize - anchor, 0, 0);
+}
+
+/**
+ * Decompresses an LZ4 block. Returns the decompressed size, or -1 if the block
+ * is corrupt or doesn't fit.
+ */
+int Lz4::decompress(const BYTE *source, int sourceSize, BYTE *destination, int destinationSize) {
+
+	const BYTE *in = source;
+	const BYTE *inEnd = source + sourceSize;
+	BYTE *out = destination;
+	BYTE *outEnd = destination + destinationSize;
+
+	while (in < inEnd) {
+
+		int token = *in++;
+
+		int numLiterals = token >> 4;
+		if (numLiterals == 15) {
+			int b;
+			do {
+				if (in >= inEnd) return -1;
+				b = *in++;
+				numLiterals += b;
+			} while (b == 255);
+		}
+		if (numLiterals > inEnd - in || numLiterals > outEnd - out) return -1;
+		memcpy(out, in, numLiterals);
+		in += numLiterals;
+		out += numLiterals;
+
+		//The last sequence is only literals
+		if (in >= inEnd) break;
+
+		if (inEnd - in < 2) return -1;
+		int offset = in[0] | (in[1] << 8);
+		in += 2;
+		if (offset == 0 || offset > out - destination) return -1;
+
+		int length = token & 15;
+		if (length == 15) {
+			int b;
+			do {
+				if (in >= inEnd) return -1;
+				b = *in++;
+				length += b;
+			} while (b == 255);
+		}
+		length += LZ4_MIN_MATCH;
+		if (length > outEnd - out) return -1;
+
+		//Byte by byte because the match can overlap what is being written
+		const BYTE *match = out - offset;
+		for (int i = 0; i < length; i++) {
+			out[i] = match[i];
+		}
+		out += length;
+	}
+
+	return (int)(out - destination);
+}
@@ -24,7 +24,7 @@ MeleeEnemy::~MeleeEnemy() {
 }
 
 void MeleeEnemy::draw(float dt) {
-	graphic[facing]->Render(screenX, screenY);
+	smh->spriteBatch->render(graphic[facing], screenX, screenY);
 }
 
 /** 
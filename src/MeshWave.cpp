@@ -0,0 +1,90 @@
+#include "SmileyEngine.h"
+#include "hgedistort.h"
+#include "math.h"
+
+extern SMH *smh;
+
+MeshWave::MeshWave(int columns, int rows, float dxSpeed, float dySpeed) {
+	this->columns = columns;
+	this->rows = rows;
+	this->dxSpeed = dxSpeed;
+	this->dySpeed = dySpeed;
+	lastTime = -1.0;
+
+	int numNodes = columns * rows;
+	animated = new bool[numNodes];
+	dxCos = new float[numNodes];
+	dxSin = new float[numNodes];
+	dyCos = new float[numNodes];
+	dySin = new float[numNodes];
+	dx = new float[numNodes];
+	dy = new float[numNodes];
+
+	for (int i = 0; i < numNodes; i++) {
+		animated[i] = false;
+		dxCos[i] = dxSin[i] = dyCos[i] = dySin[i] = 0.0;
+		dx[i] = dy[i] = 0.0;
+	}
+}
+
+MeshWave::~MeshWave() {
+	delete[] animated;
+	delete[] dxCos;
+	delete[] dxSin;
+	delete[] dyCos;
+	delete[] dySin;
+	delete[] dx;
+	delete[] dy;
+}
+
+/**
+ * Sets the phase and amplitude of a node's waves.
+ */
+void MeshWave::setNode(int column, int row, float dxPhase, float dxAmplitude, float dyPhase, float dyAmplitude) {
+	int node = row * columns + column;
+	animated[node] = true;
+	dxCos[node] = dxAmplitude * cosf(dxPhase);
+	dxSin[node] = dxAmplitude * sinf(dxPhase);
+	dyCos[node] = dyAmplitude * cosf(dyPhase);
+	dySin[node] = dyAmplitude * sinf(dyPhase);
+	lastTime = -1.0;
+}
+
+/**
+ * Works out every node's displacement at the given time. Does nothing if the
+ * wave was already updated to that time, so meshes sharing a wave can all
+ * call this.
+ */
+void MeshWave::update(float time) {
+
+	if (time == lastTime) return;
+	lastTime = time;
+
+	//cos(a + b) = cos(a)cos(b) - sin(a)sin(b)
+	//sin(a + b) = sin(a)cos(b) + cos(a)sin(b)
+	float cosX = cosf(dxSpeed * time);
+	float sinX = sinf(dxSpeed * time);
+	float cosY = cosf(dySpeed * time);
+	float sinY = sinf(dySpeed * time);
+
+	int numNodes = columns * rows;
+	for (int i = 0; i < numNodes; i++) {
+		dx[i] = cosX * dxCos[i] - sinX * dxSin[i];
+		dy[i] = sinY * dyCos[i] + cosY * dySin[i];
+	}
+
+}
+
+/**
+ * Moves the animated nodes of a mesh to the wave's current displacements.
+ */
+void MeshWave::apply(hgeDistortionMesh *mesh) {
+	for (int row = 0; row < rows; row++) {
+		for (int column = 0; column < columns; column++) {
+			int node = row * columns + column;
+			if (animated[node]) {
+				mesh->SetDisplacement(column, row, dx[node], dy[node], HGEDISP_NODE);
+			}
+		}
+	}
+}
@@ -0,0 +1,251 @@
+#include "SmileyEngine.h"
+#include "player.h"
+#include "environment.h"
+#include "EnemyFramework.h"
+#include "hgerect.h"
+#include <algorithm>
+
+extern SMH *smh;
+
+#define MICRO_BENCHMARK_SEED 1234
+#define MICRO_BENCHMARK_POINTS 1024			//Power of 2 so cases can wrap with a mask
+#define MICRO_BENCHMARK_PATH_SQUARES 5		//How far apart the ends of a valid path are
+#define ASTAR_RADIUS 10
+
+static const char *caseNames[NUM_MICRO_BENCHMARK_CASES] = {
+	"Environment::testCollision", "Environment::validPath", "Environment::collisionAt", "BaseEnemy::doAStar" };
+
+//Operations timed per sample, picked so that each sample takes around a millisecond
+static const int caseOperations[NUM_MICRO_BENCHMARK_CASES] = {
+	10000, 1000, 100000, 50 };
+
+//Random points on the area, in pixels
+static int pointX[MICRO_BENCHMARK_POINTS], pointY[MICRO_BENCHMARK_POINTS];
+static int pathX[MICRO_BENCHMARK_POINTS], pathY[MICRO_BENCHMARK_POINTS];
+static hgeRect boxes[MICRO_BENCHMARK_POINTS];
+static CollisionMask canPass;
+
+MicroBenchmark::MicroBenchmark() {
+	requested = false;
+	enemy = NULL;
+}
+
+/**
+ * Asks for the benchmark to be run instead of opening the title screen.
+ */
+void MicroBenchmark::request() {
+	requested = true;
+}
+
+bool MicroBenchmark::isRequested() {
+	return requested;
+}
+
+/**
+ * Runs every case and writes the results. Called at the end of SMH::init
+ * once everything the cases use has been loaded.
+ */
+void MicroBenchmark::run() {
+
+	warmup = smh->hge->Ini_GetInt("Debug", "microBenchmarkWarmup", DEFAULT_MICRO_BENCHMARK_WARMUP);
+	samples = smh->hge->Ini_GetInt("Debug", "microBenchmarkSamples", DEFAULT_MICRO_BENCHMARK_SAMPLES);
+	area = smh->hge->Ini_GetInt("Debug", "microBenchmarkArea", DEFAULT_MICRO_BENCHMARK_AREA);
+	if (warmup < 0) warmup = 0;
+	if (samples < 1) samples = 1;
+	if (samples > MAX_MICRO_BENCHMARK_SAMPLES) samples = MAX_MICRO_BENCHMARK_SAMPLES;
+	if (area < 0 || area >= NUM_AREAS) area = DEFAULT_MICRO_BENCHMARK_AREA;
+
+	QueryPerformanceFrequency(&frequency);
+
+	setUp();
+	for (int i = 0; i < NUM_MICRO_BENCHMARK_CASES; i++) {
+		measure(i);
+	}
+	tearDown();
+
+	writeResults();
+
+}
+
+/**
+ * Loads the area and makes up the inputs for every case. Everything random
+ * comes from a fixed seed so that runs can be compared.
+ */
+void MicroBenchmark::setUp() {
+
+	smh->saveManager->resetCurrentData();
+	smh->hge->Random_Seed(MICRO_BENCHMARK_SEED);
+	smh->environment->loadArea(area, area, false);
+
+	for (int i = 0; i < 256; i++) {
+		canPass.set(i, smh->player->canPass(i));
+	}
+
+	int width = smh->environment->areaWidth * 64;
+	int height = smh->environment->areaHeight * 64;
+	int pathLength = MICRO_BENCHMARK_PATH_SQUARES * 64;
+	for (int i = 0; i < MICRO_BENCHMARK_POINTS; i++) {
+		pointX[i] = smh->hge->Random_Int(0, width - 1);
+		pointY[i] = smh->hge->Random_Int(0, height - 1);
+		pathX[i] = min(width - 1, max(0, pointX[i] + smh->hge->Random_Int(-pathLength, pathLength)));
+		pathY[i] = min(height - 1, max(0, pointY[i] + smh->hge->Random_Int(-pathLength, pathLength)));
+		boxes[i].SetRadius(pathX[i], pathY[i], smh->hge->Random_Int(10, 32));
+	}
+
+	//A* is timed on the first enemy in the area, if there is one
+	enemy = smh->enemyManager->enemyList.empty() ? NULL : smh->enemyManager->enemyList.front().enemy;
+
+}
+
+void MicroBenchmark::tearDown() {
+	enemy = NULL;
+}
+
+/**
+ * Does one sample's worth of a case. Returns something that depends on
+ * every operation so none of them can be optimized away.
+ */
+int MicroBenchmark::runCase(int benchmarkCase, int operations) {
+
+	int checksum = 0;
+	int mask = MICRO_BENCHMARK_POINTS - 1;
+
+	switch (benchmarkCase) {
+
+		case MicroBenchmarkCases::TestCollision:
+			for (int i = 0; i < operations; i++) {
+				if (smh->environment->testCollision(&boxes[i & mask], canPass)) checksum++;
+			}
+			break;
+
+		case MicroBenchmarkCases::ValidPath:
+			for (int i = 0; i < operations; i++) {
+				if (smh->environment->validPath(pointX[i & mask], pointY[i & mask], pathX[i & mask], pathY[i & mask], 24, canPass)) checksum++;
+			}
+			break;
+
+		case MicroBenchmarkCases::CollisionAt:
+			for (int i = 0; i < operations; i++) {
+				checksum += smh->environment->collisionAt(pointX[i & mask], pointY[i & mask]);
+			}
+			break;
+
+		case MicroBenchmarkCases::AStar:
+			for (int i = 0; i < operations; i++) {
+				//Destinations within the radius around the enemy so the whole search is done every time
+				int destinationX = enemy->gridX + (i % 9) - 4;
+				int destinationY = enemy->gridY + ((i / 9) % 9) - 4;
+				enemy->doAStar(destinationX, destinationY, ASTAR_RADIUS);
+				checksum += enemy->mapPath[enemy->gridX][enemy->gridY];
+			}
+			break;
+
+	}
+
+	return checksum;
+
+}
+
+/**
+ * Warms a case up and then times it sample by sample.
+ */
+void MicroBenchmark::measure(int benchmarkCase) {
+
+	MicroBenchmarkResult *result = &results[benchmarkCase];
+	result->skipped = (benchmarkCase == MicroBenchmarkCases::AStar && !enemy);
+	result->samples = 0;
+	result->minNs = result->medianNs = result->meanNs = result->stdDevNs = result->maxNs = 0.0;
+	result->checksum = 0;
+
+	if (result->skipped) {
+		smh->logger->write(LogLevels::Warning, LogCategories::Profiler, "Micro benchmark: %s skipped, there are no enemies in %s",
+			caseNames[benchmarkCase], smh->gameData->getAreaName(area));
+		return;
+	}
+
+	int operations = caseOperations[benchmarkCase];
+	for (int i = 0; i < warmup; i++) {
+		result->checksum += runCase(benchmarkCase, operations);
+	}
+
+	std::vector<double> times;
+	LARGE_INTEGER start, end;
+	for (int i = 0; i < samples; i++) {
+		QueryPerformanceCounter(&start);
+		result->checksum += runCase(benchmarkCase, operations);
+		QueryPerformanceCounter(&end);
+		times.push_back((double)(end.QuadPart - start.QuadPart) * 1000000000.0 / (double)frequency.QuadPart / operations);
+	}
+
+	std::sort(times.begin(), times.end());
+	double total = 0.0;
+	for (int i = 0; i < samples; i++) {
+		total += times[i];
+	}
+	double variance = 0.0;
+	for (int i = 0; i < samples; i++) {
+		variance += (times[i] - total / samples) * (times[i] - total / samples);
+	}
+
+	result->samples = samples;
+	result->minNs = times[0];
+	result->maxNs = times[samples - 1];
+	result->meanNs = total / samples;
+	result->medianNs = (samples % 2) ? times[samples / 2] : (times[samples / 2 - 1] + times[samples / 2]) / 2.0;
+	result->stdDevNs = samples > 1 ? sqrt(variance / (samples - 1)) : 0.0;
+
+	smh->logger->write(LogLevels::Info, LogCategories::Profiler,
+		"Micro benchmark: %s, %d x %d operations, median %.2f ns, mean %.2f ns, std dev %.2f ns, min %.2f ns, max %.2f ns",
+		caseNames[benchmarkCase], samples, operations, result->medianNs, result->meanNs, result->stdDevNs, result->minNs, result->maxNs);
+
+}
+
+void MicroBenchmark::writeResults() {
+
+	FILE *file = fopen(MICRO_BENCHMARK_CSV_FILE, "w");
+	if (file) {
+		fprintf(file, "name,operations,samples,minNs,medianNs,meanNs,stdDevNs,maxNs,checksum\n");
+		for (int i = 0; i < NUM_MICRO_BENCHMARK_CASES; i++) {
+			if (results[i].skipped) continue;
+			fprintf(file, "%s,%d,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%d\n", caseNames[i], caseOperations[i], results[i].samples,
+				results[i].minNs, results[i].medianNs, results[i].meanNs, results[i].stdDevNs, results[i].maxNs, results[i].checksum);
+		}
+		fclose(file);
+	} else {
+		smh->logger->write(LogLevels::Error, LogCategories::Profiler, "Micro benchmark: couldn't write %s", MICRO_BENCHMARK_CSV_FILE);
+	}
+
+	file = fopen(MICRO_BENCHMARK_JSON_FILE, "w");
+	if (!file) {
+		smh->logger->write(LogLevels::Error, LogCategories::Profiler, "Micro benchmark: couldn't write %s", MICRO_BENCHMARK_JSON_FILE);
+		return;
+	}
+
+	fprintf(file, "{\n");
+	fprintf(file, "  \"warmup\": %d,\n", warmup);
+	fprintf(file, "  \"samples\": %d,\n", samples);
+	fprintf(file, "  \"area\": %d,\n", area);
+	fprintf(file, "  \"benchmarks\": [\n");
+
+	bool first = true;
+	for (int i = 0; i < NUM_MICRO_BENCHMARK_CASES; i++) {
+		if (results[i].skipped) continue;
+		MicroBenchmarkResult *result = &results[i];
+		fprintf(file, "%s    {\n", first ? "" : ",\n");
+		fprintf(file, "      \"name\": \"%s\",\n", caseNames[i]);
+		fprintf(file, "      \"operations\": %d,\n", caseOperations[i]);
+		fprintf(file, "      \"minNs\": %.3f,\n", result->minNs);
+		fprintf(file, "      \"medianNs\": %.3f,\n", result->medianNs);
+		fprintf(file, "      \"meanNs\": %.3f,\n", result->meanNs);
+		fprintf(file, "      \"stdDevNs\": %.3f,\n", result->stdDevNs);
+		fprintf(file, "      \"maxNs\": %.3f,\n", result->maxNs);
+		fprintf(file, "      \"checksum\": %d\n", result->checksum);
+		fprintf(file, "    }");
+		first = false;
+	}
+
+	fprintf(file, "\n  ]\n");
+	fprintf(file, "}\n");
+	fclose(file);
+
+}
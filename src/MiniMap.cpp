@@ -0,0 +1,326 @@
+#include "SmileyEngine.h"
+#include "MiniMap.h"
+#include "environment.h"
+#include "player.h"
+#include "hgesprite.h"
+
+#include <stdio.h>
+
+extern SMH *smh;
+
+#define UNEXPLORED_COLOR ARGB(255,0,0,0)
+#define FOG_COLOR ARGB(255,0,0,0)
+#define NO_FOG_COLOR ARGB(0,0,0,0)
+
+MiniMap::MiniMap() {
+
+	tilesTexture = smh->hge->Texture_Create(MINIMAP_SIZE, MINIMAP_SIZE);
+	fogTexture = smh->hge->Texture_Create(MINIMAP_SIZE, MINIMAP_SIZE);
+	tilesSprite = new hgeSprite(tilesTexture, 0, 0, MINIMAP_SIZE, MINIMAP_SIZE);
+	fogSprite = new hgeSprite(fogTexture, 0, 0, MINIMAP_SIZE, MINIMAP_SIZE);
+
+	colorsLoaded = false;
+	width = height = 0;
+	dirtyMinX = dirtyMinY = MINIMAP_SIZE;
+	dirtyMaxX = dirtyMaxY = -1;
+
+	canPass.setAll(false);
+
+}
+
+MiniMap::~MiniMap() {
+	delete tilesSprite;
+	delete fogSprite;
+	smh->hge->Texture_Free(tilesTexture);
+	smh->hge->Texture_Free(fogTexture);
+}
+
+/**
+ * Draws every square of the area that was just loaded.
+ */
+void MiniMap::bake() {
+
+	if (!colorsLoaded) loadColors();
+
+	//Clear whatever was left over from the last area as well
+	int oldWidth = width;
+	int oldHeight = height;
+	width = smh->environment->areaWidth;
+	height = smh->environment->areaHeight;
+
+	updateCanPass();
+
+	for (int j = 0; j < max(height, oldHeight); j++) {
+		for (int i = 0; i < max(width, oldWidth); i++) {
+			if (i < width && j < height) {
+				bakeTile(i, j);
+			} else {
+				texels[j][i] = UNEXPLORED_COLOR;
+				overlays[j][i] = 0;
+			}
+		}
+	}
+
+	dirtyMinX = dirtyMinY = 0;
+	dirtyMaxX = max(width, oldWidth) - 1;
+	dirtyMaxY = max(height, oldHeight) - 1;
+	upload();
+
+}
+
+/**
+ * Called when a square is explored for the first time.
+ */
+void MiniMap::reveal(int gridX, int gridY) {
+	if (gridX < 0 || gridX >= width || gridY < 0 || gridY >= height) return;
+	bakeTile(gridX, gridY);
+	markDirty(gridX, gridY);
+}
+
+/**
+ * Brings the map up to date before it is shown. Squares whose collision or item
+ * has changed since they were baked, for example doors that were opened or walls
+ * that were bombed, are redrawn. If Smiley got an ability that changes what he
+ * can walk on the whole area is redrawn.
+ */
+void MiniMap::sync() {
+
+	bool everything = updateCanPass();
+
+	for (int j = 0; j < height; j++) {
+		for (int i = 0; i < width; i++) {
+			if (everything || bakedCollision[j][i] != smh->environment->collision(i, j) ||
+					bakedItem[j][i] != smh->environment->item(i, j)) {
+				bakeTile(i, j);
+				markDirty(i, j);
+			}
+		}
+	}
+
+	upload();
+
+}
+
+/**
+ * Draws the area's squares with the top left corner of the area at (x, y).
+ * Unexplored squares are black.
+ */
+void MiniMap::drawTiles(float x, float y, float squareSize) {
+	upload();
+	//Each texel is a whole square so don't blur them together
+	smh->hge->System_SetState(HGE_TEXTUREFILTER, false);
+	tilesSprite->SetTextureRect(0, 0, width, height);
+	tilesSprite->RenderStretch(x, y, x + width * squareSize, y + height * squareSize);
+	smh->hge->System_SetState(HGE_TEXTUREFILTER, true);
+}
+
+/**
+ * Draws the fog of war over the edges of the explored squares.
+ */
+void MiniMap::drawFog(float x, float y, float squareSize) {
+	fogSprite->SetTextureRect(0, 0, width, height);
+	fogSprite->RenderStretch(x, y, x + width * squareSize, y + height * squareSize);
+}
+
+/**
+ * Returns whether an explored square has the given overlay to draw on top of it.
+ */
+bool MiniMap::hasOverlay(int gridX, int gridY, int overlay) {
+	if (gridX < 0 || gridX >= width || gridY < 0 || gridY >= height) return false;
+	return (overlays[gridY][gridX] & overlay) != 0;
+}
+
+/**
+ * Writes the baked area to an uncompressed TGA file so that it can be looked at
+ * or compared without drawing the map window.
+ */
+bool MiniMap::saveImage(const char *fileName) {
+
+	FILE *file = fopen(fileName, "wb");
+	if (!file) {
+		smh->logger->write(LogLevels::Warning, LogCategories::Environment, "Couldn't write minimap to %s", fileName);
+		return false;
+	}
+
+	unsigned char header[18] = {0};
+	header[2] = 2;						//Uncompressed true color
+	header[12] = width & 0xFF;
+	header[13] = (width >> 8) & 0xFF;
+	header[14] = height & 0xFF;
+	header[15] = (height >> 8) & 0xFF;
+	header[16] = 32;					//Bits per pixel
+	header[17] = 0x28;					//8 alpha bits, top left origin
+	fwrite(header, 1, sizeof(header), file);
+
+	//ARGB DWORDs are already in TGA's BGRA byte order
+	for (int j = 0; j < height; j++) {
+		fwrite(texels[j], sizeof(DWORD), width, file);
+	}
+
+	fclose(file);
+	smh->logger->write(LogLevels::Info, LogCategories::Environment, "Wrote %dx%d minimap to %s", width, height, fileName);
+	return true;
+
+}
+
+/**
+ * Takes the colors of the squares from the sprites the map used to draw them with.
+ */
+void MiniMap::loadColors() {
+	lavaColor = getSpriteColor("miniMapRedSquare");
+	pitColor = getSpriteColor("miniMapBlackSquare");
+	waterColor = getSpriteColor("miniMapBlueSquare");
+	walkableColor = getSpriteColor("miniMapNoCollision");
+	collisionColor = getSpriteColor("miniMapCollision");
+	colorsLoaded = true;
+}
+
+/**
+ * Returns the color of the texel in the middle of a sprite.
+ */
+DWORD MiniMap::getSpriteColor(const char *sprite) {
+
+	hgeSprite *s = smh->resources->GetSprite(sprite);
+	float x, y, w, h;
+	s->GetTextureRect(&x, &y, &w, &h);
+
+	DWORD *texture = smh->hge->Texture_Lock(s->GetTexture(), true, (int)(x + w/2), (int)(y + h/2), 1, 1);
+	if (!texture) {
+		smh->logger->write(LogLevels::Warning, LogCategories::Resources, "Couldn't read color of %s for the minimap", sprite);
+		return ARGB(255,128,128,128);
+	}
+	DWORD color = texture[0] | 0xFF000000;
+	smh->hge->Texture_Unlock(s->GetTexture());
+
+	return color;
+}
+
+/**
+ * Works out a square's color and overlays the same way the map window used to
+ * when it drew every square itself.
+ */
+void MiniMap::bakeTile(int i, int j) {
+
+	int c = smh->environment->collision(i, j);
+	bakedCollision[j][i] = c;
+	bakedItem[j][i] = smh->environment->item(i, j);
+
+	if (!smh->saveManager->isExplored(i, j)) {
+		texels[j][i] = UNEXPLORED_COLOR;
+		overlays[j][i] = 0;
+		return;
+	}
+
+	bool isHiddenWarp = Util::isWarp(c) && smh->environment->variable(i, j) == 990;
+	bool drawNoCollision =
+		(c >= 0 && c < 256 && canPass[c]) || isHiddenWarp || Util::isCylinderUp(c) || Util::isCylinderSwitchLeft(c) ||
+		Util::isCylinderSwitchRight(c) || c==SIGN || c==FAKE_COLLISION;
+
+	if (TileTraits::has(c, TileTraits::Lava)) {
+		texels[j][i] = lavaColor;
+	} else if (TileTraits::has(c, TileTraits::Pit)) {
+		texels[j][i] = pitColor;
+	} else if (smh->environment->isDeepWaterAt(i, j)) {
+		texels[j][i] = waterColor;
+	} else if (drawNoCollision && !isHiddenWarp && c != FAKE_COLLISION) {
+		texels[j][i] = walkableColor;
+	} else {
+		texels[j][i] = collisionColor;
+	}
+
+	overlays[j][i] = 0;
+	if (shouldDrawSpecialCollision(c) || (Util::isWarp(c) && smh->environment->variable(i, j) != 990)) {
+		overlays[j][i] |= MiniMapOverlays::SpecialCollision;
+	}
+	if (shouldDrawItem(smh->environment->item(i, j))) {
+		overlays[j][i] |= MiniMapOverlays::Item;
+	}
+
+}
+
+void MiniMap::markDirty(int gridX, int gridY) {
+	if (gridX < dirtyMinX) dirtyMinX = gridX;
+	if (gridX > dirtyMaxX) dirtyMaxX = gridX;
+	if (gridY < dirtyMinY) dirtyMinY = gridY;
+	if (gridY > dirtyMaxY) dirtyMaxY = gridY;
+}
+
+/**
+ * Copies the squares that changed since the last upload into the textures.
+ */
+void MiniMap::upload() {
+
+	if (dirtyMaxX < dirtyMinX || dirtyMaxY < dirtyMinY) return;
+
+	int w = dirtyMaxX - dirtyMinX + 1;
+	int h = dirtyMaxY - dirtyMinY + 1;
+
+	DWORD *tiles = smh->hge->Texture_Lock(tilesTexture, false, dirtyMinX, dirtyMinY, w, h);
+	DWORD *fog = smh->hge->Texture_Lock(fogTexture, false, dirtyMinX, dirtyMinY, w, h);
+	int tilesPitch = smh->hge->Texture_GetWidth(tilesTexture);
+	int fogPitch = smh->hge->Texture_GetWidth(fogTexture);
+
+	if (tiles && fog) {
+		for (int j = 0; j < h; j++) {
+			for (int i = 0; i < w; i++) {
+				int gridX = dirtyMinX + i;
+				int gridY = dirtyMinY + j;
+				tiles[j * tilesPitch + i] = texels[gridY][gridX];
+				//Squares outside the area are left clear so the edges of the area don't fade
+				fog[j * fogPitch + i] = (gridX < width && gridY < height && !smh->saveManager->isExplored(gridX, gridY)) ? FOG_COLOR : NO_FOG_COLOR;
+			}
+		}
+	} else {
+		smh->logger->write(LogLevels::Warning, LogCategories::Environment, "Couldn't lock the minimap textures");
+	}
+
+	if (tiles) smh->hge->Texture_Unlock(tilesTexture);
+	if (fog) smh->hge->Texture_Unlock(fogTexture);
+
+	dirtyMinX = dirtyMinY = MINIMAP_SIZE;
+	dirtyMaxX = dirtyMaxY = -1;
+
+}
+
+/**
+ * Refreshes the table of what Smiley can walk on. Returns whether it changed.
+ */
+bool MiniMap::updateCanPass() {
+	bool changed = false;
+	for (int i = 0; i < 256; i++) {
+		bool pass = smh->player->canPass(i, false);
+		if (pass != canPass[i]) {
+			canPass.set(i, pass);
+			changed = true;
+		}
+	}
+	return changed;
+}
+
+bool MiniMap::shouldDrawItem(int item) {
+	switch (item) {
+		case ENEMYGROUP_BLOCKGRAPHIC:
+		case RED_KEY:
+		case YELLOW_KEY:
+		case GREEN_KEY:
+		case BLUE_KEY:
+		case SMALL_GEM:
+		case MEDIUM_GEM:
+		case LARGE_GEM:
+		case HEALTH_ITEM:
+		case MANA_ITEM:
+			return true;
+		default:
+			return false;
+	}
+}
+
+bool MiniMap::shouldDrawSpecialCollision(int c) {
+	return
+		Util::isArrowPad(c) || Util::isCylinderDown(c) || Util::isCylinderSwitchLeft(c) || Util::isCylinderSwitchRight(c) ||
+		Util::isCylinderUp(c) || c == SAVE_SHRINE || c == ICE || c == YELLOW_KEYHOLE ||
+		c == RED_KEYHOLE || c == GREEN_KEYHOLE || c == BLUE_KEYHOLE || c == SPRING_PAD || c == SPIN_ARROW_SWITCH ||
+		c == MIRROR_UP_LEFT || c == MIRROR_UP_RIGHT || c == MIRROR_DOWN_RIGHT || c == MIRROR_DOWN_LEFT || c == DIZZY_MUSHROOM_1 ||
+		c == DIZZY_MUSHROOM_2 || c == HOVER_PAD || c == BOMBABLE_WALL || c == SHRINK_TUNNEL_SWITCH || c == SHRINK_TUNNEL_HORIZONTAL ||
+		c == SHRINK_TUNNEL_VERTICAL || c == SUPER_SPRING || c == SMILELET_FLOWER_SAD || c == SIGN || c == FIRE_DESTROY;
+}
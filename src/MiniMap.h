@@ -0,0 +1,74 @@
+#ifndef MINIMAP_H
+#define MINIMAP_H
+
+#include "hge.h"
+
+class hgeSprite;
+
+#define MINIMAP_SIZE 256
+
+/**
+ * Things drawn on top of a square of the area map that can't be shown with
+ * a single texel.
+ */
+class MiniMapOverlays
+{
+public:
+	static const int SpecialCollision = 1;
+	static const int Item = 2;
+};
+
+/**
+ * Picture of the current area for the map window with one texel per square.
+ * It is baked when the area is loaded and after that only squares that are
+ * explored or change are redrawn. Fog of war is a second texture that is
+ * drawn filtered over the top so that it fades out at the edges.
+ */
+class MiniMap {
+
+public:
+	MiniMap();
+	~MiniMap();
+
+	//methods
+	void bake();
+	void reveal(int gridX, int gridY);
+	void sync();
+	void drawTiles(float x, float y, float squareSize);
+	void drawFog(float x, float y, float squareSize);
+	bool hasOverlay(int gridX, int gridY, int overlay);
+	bool saveImage(const char *fileName);
+
+private:
+
+	void loadColors();
+	void bakeTile(int gridX, int gridY);
+	void markDirty(int gridX, int gridY);
+	void upload();
+	bool updateCanPass();
+	DWORD getSpriteColor(const char *sprite);
+	bool shouldDrawItem(int item);
+	bool shouldDrawSpecialCollision(int c);
+
+	HTEXTURE tilesTexture;
+	HTEXTURE fogTexture;
+	hgeSprite *tilesSprite;
+	hgeSprite *fogSprite;
+
+	//Copy of what is in the textures, and what each square was baked from so
+	//that changes can be found when the map is opened
+	DWORD texels[MINIMAP_SIZE][MINIMAP_SIZE];
+	unsigned char overlays[MINIMAP_SIZE][MINIMAP_SIZE];
+	short bakedCollision[MINIMAP_SIZE][MINIMAP_SIZE];
+	short bakedItem[MINIMAP_SIZE][MINIMAP_SIZE];
+	CollisionMask canPass;
+
+	int width, height;
+	int dirtyMinX, dirtyMinY, dirtyMaxX, dirtyMaxY;
+
+	bool colorsLoaded;
+	DWORD lavaColor, pitColor, waterColor, walkableColor, collisionColor;
+
+};
+
+#endif
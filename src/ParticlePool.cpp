@@ -0,0 +1,171 @@
+#include "SmileyEngine.h"
+#include "hgeparticle.h"
+
+extern SMH *smh;
+
+ParticlePool::ParticlePool() {
+	budget = smh->hge->Ini_GetInt("Debug", "particleBudget", DEFAULT_PARTICLE_BUDGET);
+	numLiveSystems = numLiveParticles = numCulled = numReclaimed = 0;
+}
+
+ParticlePool::~ParticlePool() {
+	for (int i = 0; i < (int)systems.size(); i++) {
+		delete systems[i].particle;
+	}
+	systems.clear();
+}
+
+/**
+ * Returns a particle system made from the named resource. A system made from the
+ * same resource that was released earlier is reused if there is one. Give the
+ * system back with release() instead of deleting it.
+ */
+hgeParticleSystem *ParticlePool::acquire(const char *name, int priority) {
+
+	hgeParticleSystem *source = smh->resources->GetParticleSystem(name);
+
+	PooledParticleSystem *pooled = NULL;
+	for (int i = 0; i < (int)systems.size(); i++) {
+		if (!systems[i].inUse && systems[i].source == source) {
+			pooled = &systems[i];
+			pooled->particle->info = source->info;
+			pooled->particle->Transpose(0.0, 0.0);
+			break;
+		}
+	}
+
+	if (!pooled) {
+		PooledParticleSystem newSystem;
+		newSystem.particle = new hgeParticleSystem(&source->info);
+		newSystem.source = source;
+		systems.push_back(newSystem);
+		pooled = &systems.back();
+	}
+
+	pooled->inUse = true;
+	pooled->priority = priority;
+	pooled->baseEmission = source->info.nEmission;
+	numLiveSystems++;
+
+	return pooled->particle;
+}
+
+/**
+ * Stops a particle system and puts it back in the pool.
+ */
+void ParticlePool::release(hgeParticleSystem *particle) {
+
+	if (!particle) return;
+
+	for (int i = 0; i < (int)systems.size(); i++) {
+		if (systems[i].particle == particle) {
+			if (systems[i].inUse) {
+				particle->Stop(true);
+				systems[i].inUse = false;
+				numLiveSystems--;
+			}
+			return;
+		}
+	}
+
+	smh->logger->write(LogLevels::Warning, LogCategories::Resources, "Released a particle system that didn't come from the pool");
+	delete particle;
+}
+
+/**
+ * Renders a particle system unless its emitter is far enough off the screen
+ * that none of its particles could be seen.
+ */
+void ParticlePool::render(hgeParticleSystem *particle) {
+	float x, y;
+	particle->GetPosition(&x, &y);
+	if (x < -PARTICLE_CULL_MARGIN || x > 1024.0 + PARTICLE_CULL_MARGIN || y < -PARTICLE_CULL_MARGIN || y > 768.0 + PARTICLE_CULL_MARGIN) {
+		numCulled++;
+		return;
+	}
+	particle->Render();
+}
+
+/**
+ * Called once a frame to count the live particles and scale down the emission
+ * of low and normal priority systems while there are more than the budget.
+ */
+void ParticlePool::update() {
+
+	numLiveParticles = 0;
+	numCulled = 0;
+	for (int i = 0; i < (int)systems.size(); i++) {
+		if (systems[i].inUse) {
+			numLiveParticles += systems[i].particle->GetParticlesAlive();
+		}
+	}
+
+	float scale = 1.0;
+	if (numLiveParticles > budget) {
+		scale = (float)budget / (float)numLiveParticles;
+	}
+
+	for (int i = 0; i < (int)systems.size(); i++) {
+		if (!systems[i].inUse) continue;
+		if (systems[i].priority == ParticlePriorities::Low) {
+			systems[i].particle->info.nEmission = (int)(systems[i].baseEmission * scale);
+		} else if (systems[i].priority == ParticlePriorities::Normal) {
+			systems[i].particle->info.nEmission = (int)(systems[i].baseEmission * (1.0 + scale) / 2.0);
+		}
+	}
+
+}
+
+/**
+ * Called when the area is reset. Every manager gives its systems back before
+ * this, so any that are still in use were leaked. They are stopped and put back
+ * in the pool so the next area starts with nothing live.
+ */
+void ParticlePool::reset() {
+
+	numReclaimed = 0;
+	for (int i = 0; i < (int)systems.size(); i++) {
+		if (systems[i].inUse) {
+			systems[i].particle->Stop(true);
+			systems[i].inUse = false;
+			numReclaimed++;
+		}
+	}
+
+	if (numReclaimed > 0) {
+		smh->logger->write(LogLevels::Warning, LogCategories::Resources, "Reclaimed %d particle systems that weren't released before the area was reset", numReclaimed);
+	}
+
+	numLiveSystems = numLiveParticles = 0;
+}
+
+int ParticlePool::getNumLiveSystems() {
+	return numLiveSystems;
+}
+
+int ParticlePool::getNumLiveParticles() {
+	return numLiveParticles;
+}
+
+/**
+ * Returns the number of systems that have been created, including the ones
+ * waiting in the pool.
+ */
+int ParticlePool::getNumPooledSystems() {
+	return (int)systems.size();
+}
+
+/**
+ * Returns the number of systems that weren't drawn since the last update
+ * because they were off the screen.
+ */
+int ParticlePool::getNumCulled() {
+	return numCulled;
+}
+
+/**
+ * Returns the number of systems that were still in use at the last reset.
+ */
+int ParticlePool::getNumReclaimed() {
+	return numReclaimed;
+}
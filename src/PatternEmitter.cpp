@@ -0,0 +1,345 @@
+#include "SmileyEngine.h"
+#include "PatternEmitter.h"
+#include "environment.h"
+#include "player.h"
+#include "hgeresource.h"
+#include "CollisionCircle.h"
+#include "ExplosionManager.h"
+
+extern SMH *smh;
+
+PatternEmitter::PatternEmitter() {
+	testMode = false;
+}
+
+PatternEmitter::~PatternEmitter() {
+	reset();
+}
+
+/**
+ * Fires a volley of pattern bullets from (x, y). Aimed patterns are fired at the
+ * angle to Smiley, the rest at whatever angle the boss picks.
+ */
+void PatternEmitter::fire(const BulletPattern *pattern, const void *owner, float x, float y, float angle) {
+
+	float baseAngle = angle;
+	if (pattern->randomAngle > 0.0) baseAngle += smh->randomFloat(0.0, pattern->randomAngle);
+
+	if (pattern->shape == PatternShapes::Spiral) {
+		SpiralState *spiral = NULL;
+		for (int i = 0; i < (int)spirals.size(); i++) {
+			if (spirals[i].pattern == pattern && spirals[i].owner == owner) spiral = &spirals[i];
+		}
+		if (!spiral) {
+			SpiralState newSpiral;
+			newSpiral.pattern = pattern;
+			newSpiral.owner = owner;
+			newSpiral.angle = 0.0;
+			spirals.push_back(newSpiral);
+			spiral = &spirals.back();
+		}
+		baseAngle += spiral->angle;
+		spiral->angle += pattern->spin;
+		if (spiral->angle > 2.0*PI) spiral->angle -= 2.0*PI;
+	}
+
+	for (int i = 0; i < pattern->count; i++) {
+		float bulletAngle;
+		if (pattern->shape == PatternShapes::Ring || pattern->shape == PatternShapes::Spiral) {
+			bulletAngle = baseAngle + (2.0*PI / float(pattern->count)) * float(i);
+		} else {
+			bulletAngle = baseAngle + (float(i) - float(pattern->count - 1) / 2.0) * pattern->spacing;
+		}
+		if (pattern->scatter > 0.0) bulletAngle += smh->randomFloat(0.0, pattern->scatter);
+		addBullet(pattern, owner, x, y, bulletAngle);
+	}
+
+	if (pattern->fireSound && !testMode) smh->soundManager->playSound(pattern->fireSound);
+
+}
+
+/**
+ * Moves every bullet and tests them all against Smiley, then deals with
+ * whatever happened to them. The first two are straight passes over the arrays
+ * with nothing in them that depends on another bullet, the last one only does
+ * real work for the few bullets that hit something.
+ */
+void PatternEmitter::update(float dt) {
+
+	int numBullets = (int)x.size();
+	if (numBullets == 0) return;
+
+	steer(dt);
+
+	float *bulletX = &x[0];
+	float *bulletY = &y[0];
+	float *bulletDX = &dx[0];
+	float *bulletDY = &dy[0];
+	float *bulletRadius = &radius[0];
+	float *bulletAge = &age[0];
+	int *bulletHits = &hits[0];
+
+	for (int i = 0; i < numBullets; i++) {
+		bulletX[i] += bulletDX[i] * dt;
+		bulletY[i] += bulletDY[i] * dt;
+		bulletAge[i] += dt;
+	}
+
+	//Distance from Smiley to the nearest point of each collision box
+	float smileyX = (float)smh->player->collisionCircle->x;
+	float smileyY = (float)smh->player->collisionCircle->y;
+	float smileyRadiusSquared = (float)(smh->player->collisionCircle->radius * smh->player->collisionCircle->radius);
+	for (int i = 0; i < numBullets; i++) {
+		float nearestX = smileyX < bulletX[i] - bulletRadius[i] ? bulletX[i] - bulletRadius[i] : smileyX;
+		nearestX = nearestX > bulletX[i] + bulletRadius[i] ? bulletX[i] + bulletRadius[i] : nearestX;
+		float nearestY = smileyY < bulletY[i] - bulletRadius[i] ? bulletY[i] - bulletRadius[i] : smileyY;
+		nearestY = nearestY > bulletY[i] + bulletRadius[i] ? bulletY[i] + bulletRadius[i] : nearestY;
+		float distX = nearestX - smileyX;
+		float distY = nearestY - smileyY;
+		bulletHits[i] = distX*distX + distY*distY < smileyRadiusSquared;
+	}
+
+	//Backwards so that removing a bullet only moves one that has already been handled
+	for (int i = numBullets - 1; i >= 0; i--) {
+
+		const BulletPattern *pattern = patterns[i];
+		bool remove = false;
+		bool explode = false;
+
+		if (hits[i] && !testMode) {
+			smh->player->dealDamage(pattern->damage, true);
+			if (pattern->flags & BulletFlags::DiesOnHit) {
+				remove = true;
+				explode = true;
+			}
+		}
+
+		if (!remove && (pattern->flags & BulletFlags::HitsWalls)) {
+			int gridX = Util::getGridX(x[i]);
+			int gridY = Util::getGridY(y[i]);
+			if (smh->environment->collisionAt(x[i], y[i]) == UNWALKABLE) {
+				remove = true;
+				explode = true;
+			} else if (smh->environment->hasSillyPad(gridX, gridY)) {
+				smh->environment->destroySillyPad(gridX, gridY);
+				remove = true;
+				explode = true;
+			}
+		}
+
+		if (!remove && pattern->maxDistance > 0.0 &&
+				Util::distance(x[i], y[i], smh->player->x, smh->player->y) > pattern->maxDistance) {
+			remove = true;
+		}
+
+		if (!remove && pattern->splitInto && age[i] >= splitTime[i]) {
+			fire(pattern->splitInto, owners[i], x[i], y[i], 0.0);
+			if (pattern->splitSound && !testMode) smh->soundManager->playSound(pattern->splitSound);
+			remove = true;
+		}
+
+		if (explode && (pattern->flags & BulletFlags::Explodes)) {
+			smh->explosionManager->addExplosion(x[i], y[i], pattern->explosionSize, pattern->explosionDamage, 0.0);
+			if (pattern->explosionSound) smh->soundManager->playSound(pattern->explosionSound);
+		}
+
+		if (remove) {
+			removeBullet(i);
+		} else if (particles[i]) {
+			particles[i]->MoveTo(smh->getScreenX(x[i]), smh->getScreenY(y[i]), true);
+			particles[i]->Update(dt);
+		}
+
+	}
+
+}
+
+/**
+ * Draws every bullet the owner has fired.
+ */
+void PatternEmitter::draw(const void *owner) {
+	for (int i = 0; i < (int)x.size(); i++) {
+		if (owners[i] == owner) drawBullet(i);
+	}
+}
+
+/**
+ * Draws the owner's bullets that are above y, for bosses whose bullets should
+ * go behind them.
+ */
+void PatternEmitter::drawBehind(const void *owner, float _y) {
+	for (int i = 0; i < (int)x.size(); i++) {
+		if (owners[i] == owner && y[i] <= _y) drawBullet(i);
+	}
+}
+
+/**
+ * Draws the owner's bullets that are below y.
+ */
+void PatternEmitter::drawInFront(const void *owner, float _y) {
+	for (int i = 0; i < (int)x.size(); i++) {
+		if (owners[i] == owner && y[i] > _y) drawBullet(i);
+	}
+}
+
+/**
+ * Removes every bullet the owner has fired and forgets its spirals.
+ */
+void PatternEmitter::clear(const void *owner) {
+	for (int i = (int)x.size() - 1; i >= 0; i--) {
+		if (owners[i] == owner) removeBullet(i);
+	}
+	for (int i = (int)spirals.size() - 1; i >= 0; i--) {
+		if (spirals[i].owner == owner) spirals.erase(spirals.begin() + i);
+	}
+}
+
+void PatternEmitter::reset() {
+	for (int i = 0; i < (int)particles.size(); i++) {
+		if (particles[i]) smh->particlePool->release(particles[i]);
+	}
+	x.clear(); y.clear(); dx.clear(); dy.clear();
+	radius.clear();
+	age.clear();
+	splitTime.clear();
+	hits.clear();
+	patterns.clear();
+	owners.clear();
+	particles.clear();
+	spirals.clear();
+}
+
+int PatternEmitter::getNumBullets() {
+	return (int)x.size();
+}
+
+int PatternEmitter::getNumBullets(const void *owner) {
+	int numBullets = 0;
+	for (int i = 0; i < (int)x.size(); i++) {
+		if (owners[i] == owner) numBullets++;
+	}
+	return numBullets;
+}
+
+/**
+ * In test mode bullets are still tested against Smiley but hits are ignored
+ * and nothing makes a sound, so benchmarks can fire at him.
+ */
+void PatternEmitter::setTestMode(bool _testMode) {
+	testMode = _testMode;
+}
+
+//~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~
+// Helper Methods
+//~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~
+
+void PatternEmitter::addBullet(const BulletPattern *pattern, const void *owner, float _x, float _y, float angle) {
+
+	x.push_back(_x);
+	y.push_back(_y);
+	dx.push_back(pattern->speed * cos(angle));
+	dy.push_back(pattern->speed * sin(angle));
+	radius.push_back(pattern->radius);
+	age.push_back(0.0);
+	splitTime.push_back(pattern->splitInto ? smh->randomFloat(pattern->minSplitTime, pattern->maxSplitTime) : 0.0);
+	hits.push_back(0);
+	patterns.push_back(pattern);
+	owners.push_back(owner);
+
+	hgeParticleSystem *particle = NULL;
+	if (pattern->particle) {
+		particle = smh->particlePool->acquire(pattern->particle, ParticlePriorities::High);
+		particle->FireAt(smh->getScreenX(_x), smh->getScreenY(_y));
+	}
+	particles.push_back(particle);
+
+}
+
+/**
+ * Turns homing bullets toward Smiley and weaves wave bullets from side to side.
+ * Both keep the bullet's speed, so the main pass can treat them like any other.
+ */
+void PatternEmitter::steer(float dt) {
+
+	for (int i = 0; i < (int)x.size(); i++) {
+
+		const BulletPattern *pattern = patterns[i];
+
+		if (pattern->turnRate > 0.0) {
+			//Which side of the bullet's path Smiley is on
+			float cross = dx[i] * (smh->player->y - y[i]) - dy[i] * (smh->player->x - x[i]);
+			float turn = cross > 0.0 ? pattern->turnRate * dt : -pattern->turnRate * dt;
+			float newDX = dx[i] * cos(turn) - dy[i] * sin(turn);
+			dy[i] = dx[i] * sin(turn) + dy[i] * cos(turn);
+			dx[i] = newDX;
+		}
+
+		if (pattern->shape == PatternShapes::Wave && pattern->speed > 0.0) {
+			float offset = pattern->waveSize * (sin(pattern->waveSpeed * (age[i] + dt)) - sin(pattern->waveSpeed * age[i]));
+			x[i] -= dy[i] / pattern->speed * offset;
+			y[i] += dx[i] / pattern->speed * offset;
+		}
+
+	}
+
+}
+
+void PatternEmitter::drawBullet(int bullet) {
+
+	const BulletPattern *pattern = patterns[bullet];
+
+	if (particles[bullet]) smh->particlePool->render(particles[bullet]);
+
+	if (pattern->sprite) {
+		hgeSprite *sprite = smh->resources->GetSprite(pattern->sprite);
+		float warningTime = splitTime[bullet] * (1.0 - SPLIT_WARNING);
+		if (pattern->splitInto && age[bullet] > warningTime) {
+			float green = 255.0 * (1.0 - (age[bullet] - warningTime) / (splitTime[bullet] - warningTime));
+			if (green < 0.0) green = 0.0;
+			if (green > 255.0) green = 255.0;
+			sprite->SetColor(ARGB(255.0, 255.0, green, 255.0));
+			smh->spriteBatch->render(sprite, smh->getScreenX(x[bullet]), smh->getScreenY(y[bullet]));
+			sprite->SetColor(ARGB(255.0, 255.0, 255.0, 255.0));
+		} else {
+			smh->spriteBatch->render(sprite, smh->getScreenX(x[bullet]), smh->getScreenY(y[bullet]));
+		}
+	}
+
+	if (smh->isDebugOn()) {
+		hgeRect collisionBox;
+		collisionBox.SetRadius(x[bullet], y[bullet], radius[bullet]);
+		smh->drawCollisionBox(&collisionBox, Colors::RED);
+	}
+
+}
+
+/**
+ * Removes a bullet by moving the last one into its place.
+ */
+void PatternEmitter::removeBullet(int bullet) {
+
+	if (particles[bullet]) smh->particlePool->release(particles[bullet]);
+
+	int last = (int)x.size() - 1;
+	x[bullet] = x[last];
+	y[bullet] = y[last];
+	dx[bullet] = dx[last];
+	dy[bullet] = dy[last];
+	radius[bullet] = radius[last];
+	age[bullet] = age[last];
+	splitTime[bullet] = splitTime[last];
+	hits[bullet] = hits[last];
+	patterns[bullet] = patterns[last];
+	owners[bullet] = owners[last];
+	particles[bullet] = particles[last];
+
+	x.pop_back(); y.pop_back(); dx.pop_back(); dy.pop_back();
+	radius.pop_back();
+	age.pop_back();
+	splitTime.pop_back();
+	hits.pop_back();
+	patterns.pop_back();
+	owners.pop_back();
+	particles.pop_back();
+
+}
@@ -0,0 +1,125 @@
+#ifndef _PATTERNEMITTER_H_
+#define _PATTERNEMITTER_H_
+
+#include <vector>
+
+class hgeParticleSystem;
+
+#define SPLIT_WARNING 0.2		//Split bullets turn green for the last fifth of their life
+
+/**
+ * How a volley is laid out around the angle it is fired at.
+ */
+class PatternShapes {
+public:
+	static const int Ring = 0;			//count bullets evenly spaced all the way around
+	static const int Spread = 1;		//count bullets spacing apart, centered on the angle
+	static const int Spiral = 2;		//A ring that turns spin further every volley
+	static const int Wave = 3;			//A spread whose bullets weave from side to side
+};
+
+class BulletFlags {
+public:
+	static const int DiesOnHit = 1;		//Removed after hitting Smiley instead of passing through him
+	static const int HitsWalls = 2;		//Removed by unwalkable squares, breaks silly pads
+	static const int Explodes = 4;		//Explodes when removed by Smiley or a wall
+};
+
+/**
+ * Everything about a boss attack that isn't where and when it's fired. Bosses
+ * keep these as static tables so that tuning an attack is changing data.
+ */
+struct BulletPattern {
+
+	//Layout
+	int shape;
+	int count;
+	float spacing;				//Angle between neighbouring bullets in a spread or wave
+	float randomAngle;			//The whole volley is turned by up to this much
+	float scatter;				//Each bullet is turned by up to this much
+	float spin;					//How far a spiral turns between volleys
+
+	//Movement
+	float speed;
+	float turnRate;				//Radians per second bullets turn toward Smiley, 0 for none
+	float waveSize;				//How far wave bullets weave to each side
+	float waveSpeed;			//Radians per second
+
+	//Collision
+	float radius;				//Half the width of the collision box
+	float damage;
+	int flags;					//BulletFlags
+	float maxDistance;			//Bullets further than this from Smiley are removed, 0 for never
+	float explosionSize;
+	float explosionDamage;
+
+	//Splitting
+	float minSplitTime;
+	float maxSplitTime;
+	const BulletPattern *splitInto;	//Volley fired where a bullet splits, NULL for none
+
+	//Graphics and sounds, NULL for none
+	const char *sprite;
+	const char *particle;
+	const char *fireSound;		//Played once per volley
+	const char *splitSound;
+	const char *explosionSound;
+
+};
+
+/**
+ * Where a spiral is up to, per pattern and owner.
+ */
+struct SpiralState {
+	const BulletPattern *pattern;
+	const void *owner;
+	float angle;
+};
+
+/**
+ * Keeps every pattern bullet in the game in one set of parallel arrays so that
+ * moving them and testing them against Smiley are each one tight loop, no
+ * matter how many bosses are firing. Bullets belong to whoever fired them so
+ * that each boss can draw and clear its own.
+ */
+class PatternEmitter {
+
+public:
+	PatternEmitter();
+	~PatternEmitter();
+
+	//methods
+	void fire(const BulletPattern *pattern, const void *owner, float x, float y, float angle);
+	void update(float dt);
+	void draw(const void *owner);
+	void drawBehind(const void *owner, float y);
+	void drawInFront(const void *owner, float y);
+	void clear(const void *owner);
+	void reset();
+	int getNumBullets();
+	int getNumBullets(const void *owner);
+	void setTestMode(bool testMode);
+
+private:
+
+	void addBullet(const BulletPattern *pattern, const void *owner, float x, float y, float angle);
+	void steer(float dt);
+	void drawBullet(int bullet);
+	void removeBullet(int bullet);
+
+	//Bullets, one element each
+	std::vector<float> x, y, dx, dy;
+	std::vector<float> radius;
+	std::vector<float> age;
+	std::vector<float> splitTime;
+	std::vector<int> hits;
+	std::vector<const BulletPattern*> patterns;
+	std::vector<const void*> owners;
+	std::vector<hgeParticleSystem*> particles;
+
+	std::vector<SpiralState> spirals;
+	bool testMode;
+
+};
+
+#endif
@@ -20,20 +20,7 @@ ProjectileManager::ProjectileManager()
 	initProjectiles();
 
 	//Set up which collision types projectiles can go through
-	for (int i = 0; i < 256; i++) canPass[i] = !Util::isCylinderUp(i);
-	canPass[UNWALKABLE] = false;
-	canPass[SIGN] = false;
-	canPass[FOUNTAIN] = false;
-	canPass[SAVE_SHRINE] = false;
-	canPass[RED_KEYHOLE] = false;
-	canPass[YELLOW_KEYHOLE] = false;
-	canPass[GREEN_KEYHOLE] = false;
-	canPass[BLUE_KEYHOLE] = false;
-	canPass[EVIL_DOOR] = false;
-	canPass[BOMBABLE_WALL] = false;
-	canPass[FIRE_DESTROY] = false;
-	canPass[BOMBABLE_WALL] = false;
-	canPass[FLAME] = false;
+	for (int i = 0; i < 256; i++) canPass.set(i, !TileTraits::has(i, TileTraits::ProjectileBlocking));
 }
 
 ProjectileManager::~ProjectileManager() 
@@ -109,28 +96,29 @@ void ProjectileManager::addProjectile(float x, float y, float speed, float angle
 		newProjectile.facing = smh->player->facing;
 	}
 
+	newProjectile.particle = NULL;
 	if (id == PROJECTILE_FIREBALL) {
-		newProjectile.particle = new hgeParticleSystem(&smh->resources->GetParticleSystem("fireBall")->info);
+		newProjectile.particle = smh->particlePool->acquire("fireBall", ParticlePriorities::High);
 		newProjectile.particle->Fire();
 	}
 
 	if (id == PROJECTILE_TUT_LIGHTNING) {
-		newProjectile.particle = new hgeParticleSystem(&smh->resources->GetParticleSystem("tutLightning")->info);
+		newProjectile.particle = smh->particlePool->acquire("tutLightning", ParticlePriorities::High);
 		newProjectile.particle->Fire();
 	}
 
 	if (id == PROJECTILE_BARV_COMET) {
-		newProjectile.particle = new hgeParticleSystem(&smh->resources->GetParticleSystem("bigWhiteBarv")->info);
+		newProjectile.particle = smh->particlePool->acquire("bigWhiteBarv", ParticlePriorities::High);
 		newProjectile.particle->Fire();
 	}
 
 	if (id == PROJECTILE_BARV_YELLOW) {
-		newProjectile.particle = new hgeParticleSystem(&smh->resources->GetParticleSystem("smallYellowBarv")->info);
+		newProjectile.particle = smh->particlePool->acquire("smallYellowBarv", ParticlePriorities::High);
 		newProjectile.particle->Fire();
 	}
 
 	if (id == PROJECTILE_SKULL) {
-		newProjectile.particle = new hgeParticleSystem(&smh->resources->GetParticleSystem("skullProjectileParticle")->info);
+		newProjectile.particle = smh->particlePool->acquire("skullProjectileParticle", ParticlePriorities::High);
 		newProjectile.particle->Fire();
 	}
 
@@ -145,8 +133,8 @@ void ProjectileManager::addProjectile(float x, float y, float speed, float angle
 void ProjectileManager::update(float dt) {
 	//Loop through the projectiles
 	bool deleteProjectile;
-	std::list<Projectile>::iterator i;
-	for (i = theProjectiles.begin(); i != theProjectiles.end(); i++) {
+	std::list<Projectile>::iterator i = theProjectiles.begin();
+	while (i != theProjectiles.end()) {
 		
 		deleteProjectile = false;
 
@@ -444,7 +432,10 @@ void ProjectileManager::update(float dt) {
 			}
 			delete i->collisionBox;
 			delete i->terrainCollisionBox;
+			smh->particlePool->release(i->particle);
 			i = theProjectiles.erase(i);
+		} else {
+			i++;
 		}
 
 	}
@@ -468,7 +459,7 @@ void ProjectileManager::draw(float dt) {
 		} else if (i->id == PROJECTILE_FIREBALL) {
 			i->particle->Update(dt);
 			i->particle->MoveTo(smh->getScreenX(i->x), smh->getScreenY(i->y), true);
-			i->particle->Render();
+			smh->particlePool->render(i->particle);
 
 		//Laser - sprite is rotated 90 degrees (this is gay, change the graphic so theres not a special case)
 		} else if (i->id == PROJECTILE_LASER) {
@@ -478,21 +469,21 @@ void ProjectileManager::draw(float dt) {
 		} else if (i->id == PROJECTILE_TUT_LIGHTNING) {
 			i->particle->Update(dt);
 			i->particle->MoveTo(smh->getScreenX(i->x), smh->getScreenY(i->y), true);
-			i->particle->Render();
+			smh->particlePool->render(i->particle);
 			projectileTypes[i->id].sprite->RenderEx(smh->getScreenX(i->x), smh->getScreenY(i->y), i->angle, 1.0f, 1.0f);			
 		
 		// Barvinoid comet
 		} else if (i->id == PROJECTILE_BARV_COMET) {
 			i->particle->Update(dt);
 			i->particle->MoveTo(smh->getScreenX(i->x), smh->getScreenY(i->y), true);
-			i->particle->Render();
+			smh->particlePool->render(i->particle);
 			projectileTypes[i->id].sprite->RenderEx(smh->getScreenX(i->x), smh->getScreenY(i->y), i->angle, 1.0f, 1.0f);
 
 		// Barvinoid yellow sphere
 		} else if (i->id == PROJECTILE_BARV_YELLOW) {
 			i->particle->Update(dt);
 			i->particle->MoveTo(smh->getScreenX(i->x), smh->getScreenY(i->y), true);
-			i->particle->Render();
+			smh->particlePool->render(i->particle);
 			projectileTypes[i->id].sprite->RenderEx(smh->getScreenX(i->x), smh->getScreenY(i->y), i->angle, 1.0f, 1.0f);
 		
 		//Figure 8 (width based on distance from its origin so it gets wider & skinnier as it travels)
@@ -505,7 +496,7 @@ void ProjectileManager::draw(float dt) {
 		}else if (i->id == PROJECTILE_SKULL) {
 			i->particle->Update(dt);
 			i->particle->MoveTo(smh->getScreenX(i->x), smh->getScreenY(i->y), true);
-			i->particle->Render();
+			smh->particlePool->render(i->particle);
 			projectileTypes[i->id].sprite->Render(smh->getScreenX(i->x), smh->getScreenY(i->y));
 
 		//Acorn (rotates)
@@ -536,11 +527,13 @@ void ProjectileManager::draw(float dt) {
  */
 void ProjectileManager::reset() {
 	//Loop through the projectiles
-	std::list<Projectile>::iterator i;
-	for (i = theProjectiles.begin(); i != theProjectiles.end(); i++) {
+	std::list<Projectile>::iterator i = theProjectiles.begin();
+	while (i != theProjectiles.end()) {
+		delete i->collisionBox;
+		delete i->terrainCollisionBox;
+		smh->particlePool->release(i->particle);
 		i = theProjectiles.erase(i);
 	}
-	theProjectiles.clear();
 }
 
 
@@ -567,11 +560,16 @@ void ProjectileManager::reflectProjectile(std::list<Projectile>::iterator projec
 
 int ProjectileManager::killProjectiles(int type) {
 	int num = 0;
-	for (std::list<Projectile>::iterator i = theProjectiles.begin(); i != theProjectiles.end(); i++) {
+	std::list<Projectile>::iterator i = theProjectiles.begin();
+	while (i != theProjectiles.end()) {
 		if (i->id == type) {
 			delete i->collisionBox;
+			delete i->terrainCollisionBox;
+			smh->particlePool->release(i->particle);
 			i = theProjectiles.erase(i);
 			num++;
+		} else {
+			i++;
 		}
 	}
 	return num;
@@ -590,14 +588,17 @@ int ProjectileManager::killProjectilesInBox(hgeRect *collisionBox, int type) {
 
 int ProjectileManager::killProjectilesInBox(hgeRect *collisionBox, int type, bool killHostile, bool killNonHostile) {
 	int numCollisions = 0;
-	std::list<Projectile>::iterator i;
-	for (i = theProjectiles.begin(); i != theProjectiles.end(); i++) {
-		if ((i->hostile && killHostile) || (!i->hostile && killNonHostile)) {
-			if ((i->id == type || type == PROJECTILE_ALL) && collisionBox->Intersect(i->collisionBox)) {
-				delete i->collisionBox;
-				i = theProjectiles.erase(i);
-				numCollisions++;
-			}
+	std::list<Projectile>::iterator i = theProjectiles.begin();
+	while (i != theProjectiles.end()) {
+		if (((i->hostile && killHostile) || (!i->hostile && killNonHostile)) &&
+				(i->id == type || type == PROJECTILE_ALL) && collisionBox->Intersect(i->collisionBox)) {
+			delete i->collisionBox;
+			delete i->terrainCollisionBox;
+			smh->particlePool->release(i->particle);
+			i = theProjectiles.erase(i);
+			numCollisions++;
+		} else {
+			i++;
 		}
 	}
 	return numCollisions;
@@ -616,12 +617,16 @@ int ProjectileManager::killProjectilesInBox(hgeRect *collisionBox, int type, boo
  */
 int ProjectileManager::killProjectilesInCircle(float x, float y, float radius, int type) {
 	int numCollisions = 0;
-	std::list<Projectile>::iterator i;
-	for (i = theProjectiles.begin(); i != theProjectiles.end(); i++) {
+	std::list<Projectile>::iterator i = theProjectiles.begin();
+	while (i != theProjectiles.end()) {
 		if (i->id == type && Util::distance(i->x, i->y, x, y) < radius) {
 			delete i->collisionBox;
+			delete i->terrainCollisionBox;
+			smh->particlePool->release(i->particle);
 			i = theProjectiles.erase(i);
 			numCollisions++;
+		} else {
+			i++;
 		}
 	}
 	return numCollisions;
@@ -109,7 +109,7 @@ public:
 
 	ProjectileType projectileTypes[NUM_PROJECTILES];
 	std::list<Projectile> theProjectiles;
-	bool canPass[256];
+	CollisionMask canPass;
 
 private:
 
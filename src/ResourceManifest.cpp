@@ -0,0 +1,460 @@
+#include "SmileyEngine.h"
+
+extern SMH *smh;
+
+#define TGA_HEADER_SIZE 18
+
+/**
+ * Maps the compiled manifest. If it is missing or older than the resource
+ * script, the script is compiled now and the manifest is rewritten so that the
+ * next startup can map it.
+ */
+ResourceManifest::ResourceManifest(const char *manifestFile, const char *scriptFile) {
+
+	file = INVALID_HANDLE_VALUE;
+	mapping = NULL;
+	data = NULL;
+	header = NULL;
+	handles = NULL;
+
+	if (!mapFile(manifestFile, scriptFile)) {
+
+		smh->logger->write(LogLevels::Warning, LogCategories::Resources, "%s is missing or out of date, compiling %s", manifestFile, scriptFile);
+
+		ResourceManifestCompiler compiler;
+		bool succeeded = compiler.compile(scriptFile);
+		for (int i = 0; i < (int)compiler.getErrors().size(); i++) {
+			smh->logger->write(LogLevels::Warning, LogCategories::Resources, "%s", compiler.getErrors()[i].c_str());
+		}
+		if (!succeeded) {
+			throw new System::Exception(new System::String("Error: couldn't compile the resource script."));
+		}
+
+		compiler.save(manifestFile);
+		compiled = compiler.getManifest();
+		use(&compiled[0], (DWORD)compiled.size());
+
+	}
+
+	handles = new DWORD[header->numRecords];
+	memset(handles, 0, header->numRecords * sizeof(DWORD));
+	atlasPageTextures.assign(header->numAtlasPages, 0);
+	useAtlas = smh->hge->Ini_GetInt("Debug", "textureAtlas", 1) != 0;
+
+	smh->logger->write(LogLevels::Info, LogCategories::Resources, "Resource manifest has %d resources in %d groups", header->numRecords, header->numGroups);
+
+}
+
+ResourceManifest::~ResourceManifest() {
+	Purge(0);
+	delete[] handles;
+	closeFile();
+}
+
+/**
+ * Opens the manifest as a read only memory mapped file. Returns false if it
+ * doesn't exist, isn't a manifest this version can read, or was compiled from
+ * a different resource script.
+ */
+bool ResourceManifest::mapFile(const char *manifestFile, const char *scriptFile) {
+
+	file = CreateFile(manifestFile, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE) return false;
+
+	DWORD size = GetFileSize(file, NULL);
+	mapping = CreateFileMapping(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapping) data = (const BYTE*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+	if (!data || !use(data, size) || !isUpToDate(header, scriptFile)) {
+		closeFile();
+		return false;
+	}
+
+	return true;
+}
+
+void ResourceManifest::closeFile() {
+	if (data) UnmapViewOfFile(data);
+	if (mapping) CloseHandle(mapping);
+	if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+	data = NULL;
+	mapping = NULL;
+	file = INVALID_HANDLE_VALUE;
+}
+
+/**
+ * Points the tables at a manifest in memory. Returns false if it isn't one.
+ */
+bool ResourceManifest::use(const BYTE *manifest, DWORD size) {
+
+	if (size < sizeof(ManifestHeader)) return false;
+
+	const ManifestHeader *h = (const ManifestHeader*)manifest;
+	if (h->magic != RESOURCE_MANIFEST_MAGIC || h->version != RESOURCE_MANIFEST_VERSION) return false;
+	if (h->recordsOffset > size || h->seedsOffset > size || h->slotsOffset > size || h->groupsOffset > size ||
+		h->membersOffset > size || h->atlasPagesOffset > size || h->stringsOffset > size) return false;
+
+	header = h;
+	records = (const ManifestRecord*)(manifest + header->recordsOffset);
+	seeds = (const DWORD*)(manifest + header->seedsOffset);
+	slots = (const int*)(manifest + header->slotsOffset);
+	groups = (const ManifestGroup*)(manifest + header->groupsOffset);
+	members = (const int*)(manifest + header->membersOffset);
+	atlasPages = (const ManifestAtlasPage*)(manifest + header->atlasPagesOffset);
+	strings = (const char*)(manifest + header->stringsOffset);
+
+	return true;
+}
+
+/**
+ * Returns whether the manifest was compiled from the resource script as it is
+ * now. If the script isn't there the manifest is all there is, so it's used.
+ */
+bool ResourceManifest::isUpToDate(const ManifestHeader *header, const char *scriptFile) {
+	WIN32_FILE_ATTRIBUTE_DATA attributes;
+	if (!GetFileAttributesEx(scriptFile, GetFileExInfoStandard, &attributes)) return true;
+	return attributes.nFileSizeLow == header->scriptSize && CompareFileTime(&attributes.ftLastWriteTime, &header->scriptTime) == 0;
+}
+
+/**
+ * FNV-1a with the seed mixed into the starting value. The manifest compiler
+ * picks a seed for each bucket so that no two names land in the same slot.
+ */
+DWORD ResourceManifest::hashName(const char *name, DWORD seed) {
+	DWORD hash = 2166136261 ^ (seed * 16777619);
+	for (const char *c = name; *c; c++) {
+		hash ^= (unsigned char)*c;
+		hash *= 16777619;
+	}
+	return hash;
+}
+
+/**
+ * Returns the record with the given name, or -1 if there isn't one.
+ */
+int ResourceManifest::find(const char *name) {
+	if (header->numRecords == 0) return -1;
+	DWORD bucket = hashName(name, 0) % header->numBuckets;
+	int record = slots[hashName(name, seeds[bucket]) % header->numSlots];
+	if (record < 0 || strcmp(strings + records[record].name, name) != 0) return -1;
+	return record;
+}
+
+/**
+ * Returns the records in a resource group, textures first.
+ */
+const int *ResourceManifest::getGroupMembers(int group, int *numMembers) {
+	for (int i = 0; i < header->numGroups; i++) {
+		if (groups[i].group == group) {
+			*numMembers = groups[i].numMembers;
+			return members + groups[i].firstMember;
+		}
+	}
+	*numMembers = 0;
+	return NULL;
+}
+
+const ManifestRecord *ResourceManifest::getRecord(int record) {
+	return &records[record];
+}
+
+const char *ResourceManifest::getName(int record) {
+	return strings + records[record].name;
+}
+
+int ResourceManifest::getNumRecords() {
+	return header->numRecords;
+}
+
+/**
+ * Returns the resource if it has been created, otherwise 0.
+ */
+DWORD ResourceManifest::getHandle(int record) {
+	return handles[record];
+}
+
+/**
+ * Creates a resource, and the texture or sprite it is made from, if it hasn't
+ * been created yet. Returns 0 if it couldn't be loaded.
+ */
+DWORD ResourceManifest::load(int record) {
+
+	if (handles[record]) return handles[record];
+
+	const ManifestRecord *r = &records[record];
+	const char *filename = strings + r->filename;
+
+	if (r->type == ResourceTypes::Texture) {
+		handles[record] = (DWORD)smh->hge->Texture_Load(filename, 0, r->mipmap != 0);
+	} else if (r->type == ResourceTypes::Sound) {
+		DWORD size;
+		const BYTE *sound = smh->assetPacks->load(filename, &size);
+		if (sound) handles[record] = (DWORD)smh->hge->Effect_Load((const char*)sound, size);
+	} else if (r->type == ResourceTypes::Music) {
+		DWORD size;
+		const BYTE *song = smh->assetPacks->load(filename, &size);
+		HMUSIC music = song ? smh->hge->Music_Load((const char*)song, size) : 0;
+		if (music) smh->hge->Music_SetAmplification(music, r->amplify);
+		handles[record] = (DWORD)music;
+	} else if (r->type == ResourceTypes::Font) {
+		hgeFont *font = new hgeFont(filename, r->mipmap != 0);
+		font->SetColor(r->color);
+		font->SetTracking(r->tracking);
+		handles[record] = (DWORD)font;
+	} else if (r->type == ResourceTypes::Sprite) {
+		float x = r->x, y = r->y;
+		HTEXTURE texture = r->dependency >= 0 ? getRegion(r->dependency, &x, &y) : 0;
+		hgeSprite *sprite = new hgeSprite(texture, x, y, r->width, r->height);
+		sprite->SetColor(r->color);
+		sprite->SetHotSpot(r->hotX, r->hotY);
+		sprite->SetBlendMode(r->blendMode);
+		handles[record] = (DWORD)sprite;
+	} else if (r->type == ResourceTypes::Animation) {
+		float x = r->x, y = r->y;
+		HTEXTURE texture = r->dependency >= 0 ? getRegion(r->dependency, &x, &y) : 0;
+		hgeAnimation *animation = new hgeAnimation(texture, r->frames, r->fps, x, y, r->width, r->height);
+		animation->SetColor(r->color);
+		animation->SetHotSpot(r->hotX, r->hotY);
+		animation->SetBlendMode(r->blendMode);
+		animation->SetMode(r->mode);
+		handles[record] = (DWORD)animation;
+	} else if (r->type == ResourceTypes::Particle) {
+		//A .psi file is just the particle system info with a sprite pointer to fill in
+		DWORD size;
+		const BYTE *psi = smh->assetPacks->load(filename, &size);
+		if (psi && size >= sizeof(hgeParticleSystemInfo)) {
+			hgeParticleSystemInfo info;
+			memcpy(&info, psi, sizeof(hgeParticleSystemInfo));
+			info.sprite = r->dependency >= 0 ? (hgeSprite*)load(r->dependency) : NULL;
+			handles[record] = (DWORD)new hgeParticleSystem(&info);
+		}
+	}
+
+	return handles[record];
+}
+
+/**
+ * Returns the texture to make a sprite from and moves the texture rect to where
+ * the texture is on its atlas page, if it's on one.
+ */
+HTEXTURE ResourceManifest::getRegion(int texture, float *x, float *y) {
+	const ManifestRecord *r = &records[texture];
+	if (useAtlas && r->atlasPage >= 0) {
+		HTEXTURE page = loadAtlasPage(r->atlasPage);
+		if (page) {
+			*x += r->atlasX;
+			*y += r->atlasY;
+			return page;
+		}
+	}
+	return (HTEXTURE)load(texture);
+}
+
+/**
+ * Puts an atlas page together from its textures. The page is written out as an
+ * uncompressed TGA in memory so that HGE loads it like any other texture file,
+ * because hgeAnimation needs to know the size of the image its texture was
+ * loaded from, which HGE only keeps for loaded textures.
+ */
+HTEXTURE ResourceManifest::loadAtlasPage(int page) {
+
+	if (atlasPageTextures[page]) return atlasPageTextures[page];
+
+	int width = atlasPages[page].width;
+	int height = atlasPages[page].height;
+	std::vector<BYTE> image(TGA_HEADER_SIZE + width * height * 4, 0);
+	image[2] = 2;								//Uncompressed true color
+	image[12] = width & 0xFF;
+	image[13] = width >> 8;
+	image[14] = height & 0xFF;
+	image[15] = height >> 8;
+	image[16] = 32;
+	image[17] = 0x28;							//8 bits of alpha, first row at the top
+
+	int numTextures = 0;
+	for (int i = 0; i < header->numRecords; i++) {
+
+		const ManifestRecord *r = &records[i];
+		if (r->type != ResourceTypes::Texture || r->atlasPage != page) continue;
+
+		HTEXTURE source = smh->hge->Texture_Load(strings + r->filename);
+		if (!source) continue;
+
+		int sourceWidth = smh->hge->Texture_GetWidth(source, true);
+		int sourceHeight = smh->hge->Texture_GetHeight(source, true);
+		if (sourceWidth != (int)r->width || sourceHeight != (int)r->height) {
+			smh->logger->write(LogLevels::Warning, LogCategories::Resources, "%s is %dx%d but was %dx%d when the atlas was packed, run with -compileresources",
+				strings + r->filename, sourceWidth, sourceHeight, (int)r->width, (int)r->height);
+		}
+
+		//A8R8G8B8 texels are stored in the same byte order as a 32 bit TGA
+		int pitch = smh->hge->Texture_GetWidth(source);
+		int copyWidth = sourceWidth < (int)r->width ? sourceWidth : (int)r->width;
+		int copyHeight = sourceHeight < (int)r->height ? sourceHeight : (int)r->height;
+		DWORD *texels = smh->hge->Texture_Lock(source, true);
+		if (texels) {
+			for (int y = 0; y < copyHeight; y++) {
+				BYTE *row = &image[TGA_HEADER_SIZE + (((int)r->atlasY + y) * width + (int)r->atlasX) * 4];
+				memcpy(row, texels + y * pitch, copyWidth * 4);
+			}
+			smh->hge->Texture_Unlock(source);
+			numTextures++;
+		}
+		smh->hge->Texture_Free(source);
+	}
+
+	atlasPageTextures[page] = smh->hge->Texture_Load((const char*)&image[0], (DWORD)image.size());
+	smh->logger->write(LogLevels::Info, LogCategories::Resources, "Built atlas page %d, %dx%d from %d textures", page, width, height, numTextures);
+	return atlasPageTextures[page];
+}
+
+/**
+ * Returns the texture to draw part of a texture resource from. If the texture
+ * is on an atlas page, that's returned and x and y are moved by where it is on
+ * the page, so sprites made in code end up on the page too.
+ */
+HTEXTURE ResourceManifest::getTextureRegion(const char *name, float *x, float *y) {
+	int record = find(name);
+	if (record < 0 || records[record].type != ResourceTypes::Texture) return GetTexture(name);
+	return getRegion(record, x, y);
+}
+
+/**
+ * Sets the part of its texture a sprite shows, in the texture's own coordinates
+ * even if the sprite is drawn from an atlas page.
+ */
+void ResourceManifest::setTextureRect(const char *sprite, float x, float y, float width, float height) {
+	hgeSprite *s = GetSprite(sprite);
+	if (!s) return;
+	int texture = records[find(sprite)].dependency;
+	if (texture >= 0 && records[texture].atlasPage >= 0 && s->GetTexture() == atlasPageTextures[records[texture].atlasPage]) {
+		x += records[texture].atlasX;
+		y += records[texture].atlasY;
+	}
+	s->SetTextureRect(x, y, width, height, true);
+}
+
+int ResourceManifest::getNumAtlasPages() {
+	return header->numAtlasPages;
+}
+
+/**
+ * Frees a resource. It will be created again the next time it is asked for.
+ */
+void ResourceManifest::unload(int record) {
+
+	DWORD handle = handles[record];
+	if (!handle) return;
+
+	int type = records[record].type;
+	if (type == ResourceTypes::Texture) smh->hge->Texture_Free((HTEXTURE)handle);
+	else if (type == ResourceTypes::Sound) smh->hge->Effect_Free((HEFFECT)handle);
+	else if (type == ResourceTypes::Music) smh->hge->Music_Free((HMUSIC)handle);
+	else if (type == ResourceTypes::Font) delete (hgeFont*)handle;
+	else if (type == ResourceTypes::Sprite) delete (hgeSprite*)handle;
+	else if (type == ResourceTypes::Animation) delete (hgeAnimation*)handle;
+	else if (type == ResourceTypes::Particle) delete (hgeParticleSystem*)handle;
+
+	handles[record] = 0;
+}
+
+/**
+ * Creates every resource in a group, or every resource if the group is 0.
+ * Returns false if any of them couldn't be loaded.
+ */
+bool ResourceManifest::Precache(int group) {
+
+	bool loaded = true;
+
+	if (group == 0) {
+		for (int i = 0; i < header->numRecords; i++) {
+			if (!load(i)) loaded = false;
+		}
+	} else {
+		int numMembers;
+		const int *groupMembers = getGroupMembers(group, &numMembers);
+		for (int i = 0; i < numMembers; i++) {
+			if (!load(groupMembers[i])) loaded = false;
+		}
+	}
+
+	return loaded;
+}
+
+/**
+ * Frees every resource in a group, or everything if the group is 0.
+ */
+void ResourceManifest::Purge(int group) {
+
+	//Free sprites and animations before the textures they were made from
+	if (group == 0) {
+		for (int i = header->numRecords - 1; i >= 0; i--) {
+			if (records[i].type != ResourceTypes::Texture) unload(i);
+		}
+		for (int i = 0; i < header->numRecords; i++) {
+			unload(i);
+		}
+		for (std::map<std::string, HTEXTURE>::iterator i = looseTextures.begin(); i != looseTextures.end(); i++) {
+			smh->hge->Texture_Free(i->second);
+		}
+		looseTextures.clear();
+		for (int i = 0; i < (int)atlasPageTextures.size(); i++) {
+			if (atlasPageTextures[i]) smh->hge->Texture_Free(atlasPageTextures[i]);
+			atlasPageTextures[i] = 0;
+		}
+	} else {
+		int numMembers;
+		const int *groupMembers = getGroupMembers(group, &numMembers);
+		for (int i = numMembers - 1; i >= 0; i--) {
+			unload(groupMembers[i]);
+		}
+	}
+
+}
+
+DWORD ResourceManifest::get(const char *name, int type) {
+	int record = find(name);
+	if (record < 0 || records[record].type != type) return 0;
+	return load(record);
+}
+
+/**
+ * Like HGE's resource manager, a name that isn't a texture resource is loaded
+ * as a texture file.
+ */
+HTEXTURE ResourceManifest::GetTexture(const char *name) {
+
+	HTEXTURE texture = (HTEXTURE)get(name, ResourceTypes::Texture);
+	if (texture) return texture;
+
+	std::map<std::string, HTEXTURE>::iterator i = looseTextures.find(name);
+	if (i != looseTextures.end()) return i->second;
+
+	texture = smh->hge->Texture_Load(name);
+	if (texture) looseTextures[name] = texture;
+	return texture;
+}
+
+HEFFECT ResourceManifest::GetEffect(const char *name) {
+	return (HEFFECT)get(name, ResourceTypes::Sound);
+}
+
+HMUSIC ResourceManifest::GetMusic(const char *name) {
+	return (HMUSIC)get(name, ResourceTypes::Music);
+}
+
+hgeSprite *ResourceManifest::GetSprite(const char *name) {
+	return (hgeSprite*)get(name, ResourceTypes::Sprite);
+}
+
+hgeAnimation *ResourceManifest::GetAnimation(const char *name) {
+	return (hgeAnimation*)get(name, ResourceTypes::Animation);
+}
+
+hgeFont *ResourceManifest::GetFont(const char *name) {
+	return (hgeFont*)get(name, ResourceTypes::Font);
+}
+
+hgeParticleSystem *ResourceManifest::GetParticleSystem(const char *name) {
+	return (hgeParticleSystem*)get(name, ResourceTypes::Particle);
+}
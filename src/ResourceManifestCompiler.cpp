@@ -0,0 +1,582 @@
+#include "SmileyEngine.h"
+#include <stdio.h>
+#include <stdarg.h>
+#include <algorithm>
+
+#define MAX_BUCKET_SEED 100000
+
+static const char *typeNames[NUM_RESOURCE_TYPES] = {
+	"Texture", "Sound", "Music", "Font", "Sprite", "Animation", "Particle"
+};
+
+//The resource manager methods the game calls, and the type of resource each one returns
+static const char *getterNames[NUM_RESOURCE_TYPES] = {
+	"GetTexture", "GetEffect", "GetMusic", "GetFont", "GetSprite", "GetAnimation", "GetParticleSystem"
+};
+
+static std::string trim(const std::string &text) {
+	std::string::size_type start = text.find_first_not_of(" \t\r\n");
+	if (start == std::string::npos) return "";
+	return text.substr(start, text.find_last_not_of(" \t\r\n") - start + 1);
+}
+
+static std::string unquote(const std::string &text) {
+	if (text.size() >= 2 && text[0] == '"' && text[text.size() - 1] == '"') return text.substr(1, text.size() - 2);
+	return text;
+}
+
+static bool compareNames(const ScriptResource &a, const ScriptResource &b) {
+	return a.name < b.name;
+}
+
+static void append(std::vector<BYTE> &data, const void *bytes, int size) {
+	data.insert(data.end(), (const BYTE*)bytes, (const BYTE*)bytes + size);
+}
+
+ResourceManifestCompiler::ResourceManifestCompiler() { }
+
+/**
+ * Parses the resource script and builds the manifest in memory. Problems that
+ * don't stop the manifest from being built, like duplicate names, are added to
+ * the errors. Returns false if there is no manifest.
+ */
+bool ResourceManifestCompiler::compile(const char *scriptFile) {
+
+	resources.clear();
+	indices.clear();
+	errors.clear();
+	manifest.clear();
+
+	if (!parse(scriptFile)) return false;
+	resolveDependencies();
+	sortByName();
+
+	std::vector<DWORD> seeds;
+	std::vector<int> slots;
+	if (!buildHashTable(seeds, slots)) return false;
+
+	std::vector<ManifestAtlasPage> pages;
+	packAtlases(pages);
+
+	build(scriptFile, seeds, slots, pages);
+	return true;
+}
+
+/**
+ * Reads each "Type name {" block of the script. Like ResourceScript itself,
+ * each header, parameter and closing brace has to be on its own line.
+ */
+bool ResourceManifestCompiler::parse(const char *scriptFile) {
+
+	std::ifstream script(scriptFile);
+	if (!script) {
+		error("Couldn't open %s", scriptFile);
+		return false;
+	}
+
+	std::string line;
+	int lineNum = 0;
+	int current = -1;
+
+	while (std::getline(script, line)) {
+
+		lineNum++;
+		std::string text = trim(line);
+		if (text.empty() || text[0] == ';') continue;
+
+		if (text == "}") {
+			current = -1;
+			continue;
+		}
+
+		if (current >= 0) {
+			std::string::size_type equals = text.find('=');
+			if (equals == std::string::npos) {
+				error("%s(%d): Expected a parameter, found \"%s\"", scriptFile, lineNum, text.c_str());
+			} else {
+				setValue(&resources[current], trim(text.substr(0, equals)), unquote(trim(text.substr(equals + 1))));
+			}
+			continue;
+		}
+
+		//Header: Type name [: base] {
+		std::string header = trim(text.substr(0, text.find('{')));
+		std::string::size_type space = header.find(' ');
+		std::string typeName = header.substr(0, space);
+		std::string name = space == std::string::npos ? "" : trim(header.substr(space));
+		std::string base = "";
+		std::string::size_type colon = name.find(':');
+		if (colon != std::string::npos) {
+			base = trim(name.substr(colon + 1));
+			name = trim(name.substr(0, colon));
+		}
+
+		int type = -1;
+		for (int i = 0; i < NUM_RESOURCE_TYPES; i++) {
+			if (typeName == typeNames[i]) type = i;
+		}
+		if (type < 0 || name.empty() || text.find('{') == std::string::npos) {
+			error("%s(%d): Expected a resource, found \"%s\"", scriptFile, lineNum, text.c_str());
+			continue;
+		}
+
+		ScriptResource resource;
+		memset(&resource.record, 0, sizeof(ManifestRecord));
+		resource.record.type = type;
+		resource.record.dependency = -1;
+		resource.record.atlasPage = -1;
+		resource.record.blendMode = BLEND_DEFAULT;
+		resource.record.color = 0xFFFFFFFF;
+		resource.record.mode = HGEANIM_FWD | HGEANIM_LOOP;
+		resource.record.amplify = 50;
+		resource.line = lineNum;
+
+		if (!base.empty()) {
+			int baseIndex = find(base);
+			if (baseIndex < 0 || resources[baseIndex].record.type != type) {
+				error("%s(%d): %s %s is based on %s, which isn't a %s", scriptFile, lineNum, typeName.c_str(), name.c_str(), base.c_str(), typeName.c_str());
+			} else {
+				resource = resources[baseIndex];
+				resource.line = lineNum;
+			}
+		}
+		resource.name = name;
+
+		int existing = find(name);
+		if (existing >= 0) {
+			//The first one wins, the same as it did when HGE looked names up
+			error("%s(%d): Duplicate resource name %s, first defined on line %d", scriptFile, lineNum, name.c_str(), resources[existing].line);
+			resources.push_back(resource);
+			current = (int)resources.size() - 1;
+			resources[current].name = "";
+			continue;
+		}
+
+		resources.push_back(resource);
+		current = (int)resources.size() - 1;
+		indices[name] = current;
+
+	}
+
+	//Throw away the duplicates now that their parameters have been read
+	std::vector<ScriptResource> named;
+	for (int i = 0; i < (int)resources.size(); i++) {
+		if (!resources[i].name.empty()) named.push_back(resources[i]);
+	}
+	resources = named;
+	sortByName();
+
+	return true;
+}
+
+void ResourceManifestCompiler::setValue(ScriptResource *resource, const std::string &key, const std::string &value) {
+
+	ManifestRecord *r = &resource->record;
+
+	if (key == "filename") {
+		resource->filename = value;
+	} else if (key == "texture" || key == "sprite") {
+		resource->dependency = value;
+	} else if (key == "resgroup") {
+		r->group = atoi(value.c_str());
+	} else if (key == "rect") {
+		sscanf(value.c_str(), "%f,%f,%f,%f", &r->x, &r->y, &r->width, &r->height);
+	} else if (key == "hotspot") {
+		sscanf(value.c_str(), "%f,%f", &r->hotX, &r->hotY);
+	} else if (key == "frames") {
+		r->frames = atoi(value.c_str());
+	} else if (key == "fps") {
+		r->fps = (float)atof(value.c_str());
+	} else if (key == "tracking") {
+		r->tracking = (float)atof(value.c_str());
+	} else if (key == "amplify") {
+		r->amplify = atoi(value.c_str());
+	} else if (key == "mipmap") {
+		r->mipmap = value == "true" ? 1 : 0;
+	} else if (key == "atlas") {
+		r->atlas = atoi(value.c_str());
+	} else if (key == "color") {
+		r->color = strtoul(value.c_str() + (value[0] == '#' ? 1 : 0), NULL, 16);
+	} else if (key == "blendmode" || key == "mode") {
+		//Comma separated flags that each set or clear a bit
+		std::string flags = value + ",";
+		std::string::size_type start = 0, comma;
+		while ((comma = flags.find(',', start)) != std::string::npos) {
+			std::string flag = trim(flags.substr(start, comma - start));
+			start = comma + 1;
+			if (flag == "COLORMUL") r->blendMode &= ~BLEND_COLORADD;
+			else if (flag == "COLORADD") r->blendMode |= BLEND_COLORADD;
+			else if (flag == "ALPHABLEND") r->blendMode |= BLEND_ALPHABLEND;
+			else if (flag == "ALPHAADD") r->blendMode &= ~BLEND_ALPHABLEND;
+			else if (flag == "ZWRITE") r->blendMode |= BLEND_ZWRITE;
+			else if (flag == "NOZWRITE") r->blendMode &= ~BLEND_ZWRITE;
+			else if (flag == "FORWARD") r->mode &= ~HGEANIM_REV;
+			else if (flag == "REVERSE") r->mode |= HGEANIM_REV;
+			else if (flag == "PINGPONG") r->mode |= HGEANIM_PINGPONG;
+			else if (flag == "NOPINGPONG") r->mode &= ~HGEANIM_PINGPONG;
+			else if (flag == "LOOP") r->mode |= HGEANIM_LOOP;
+			else if (flag == "NOLOOP") r->mode &= ~HGEANIM_LOOP;
+			else error("%s: Unknown %s flag %s", resource->name.c_str(), key.c_str(), flag.c_str());
+		}
+	} else {
+		error("%s: Unknown parameter %s", resource->name.c_str(), key.c_str());
+	}
+
+}
+
+/**
+ * Checks that every texture and sprite that is used exists. A sprite's texture
+ * can also be a file name, in which case a texture resource is made for it in
+ * the sprite's group.
+ */
+void ResourceManifestCompiler::resolveDependencies() {
+
+	int numResources = (int)resources.size();
+
+	for (int i = 0; i < numResources; i++) {
+
+		int type = resources[i].record.type;
+		std::string dependency = resources[i].dependency;
+		if (type != ResourceTypes::Sprite && type != ResourceTypes::Animation && type != ResourceTypes::Particle) continue;
+
+		if (dependency.empty()) {
+			error("%s(%d): %s %s doesn't have a %s", RESOURCE_SCRIPT_FILE, resources[i].line, typeNames[type],
+				resources[i].name.c_str(), type == ResourceTypes::Particle ? "sprite" : "texture");
+			continue;
+		}
+
+		int found = find(dependency);
+		int neededType = type == ResourceTypes::Particle ? ResourceTypes::Sprite : ResourceTypes::Texture;
+		if (found >= 0 && resources[found].record.type == neededType) continue;
+
+		if (found < 0 && neededType == ResourceTypes::Texture) {
+			ScriptResource texture;
+			memset(&texture.record, 0, sizeof(ManifestRecord));
+			texture.record.type = ResourceTypes::Texture;
+			texture.record.group = resources[i].record.group;
+			texture.record.dependency = -1;
+			texture.record.atlasPage = -1;
+			texture.name = dependency;
+			texture.filename = dependency;
+			texture.line = resources[i].line;
+			resources.push_back(texture);
+			indices[dependency] = (int)resources.size() - 1;
+			continue;
+		}
+
+		error("%s(%d): %s %s uses %s, which isn't a %s", RESOURCE_SCRIPT_FILE, resources[i].line, typeNames[type],
+			resources[i].name.c_str(), dependency.c_str(), typeNames[neededType]);
+		resources[i].dependency = "";
+
+	}
+
+}
+
+void ResourceManifestCompiler::sortByName() {
+	std::sort(resources.begin(), resources.end(), compareNames);
+	indices.clear();
+	for (int i = 0; i < (int)resources.size(); i++) {
+		indices[resources[i].name] = i;
+	}
+}
+
+/**
+ * Builds a perfect hash of the names with the hash and displace method. Names
+ * are split into buckets, then starting with the fullest bucket a seed is found
+ * that puts each of the bucket's names in a slot of its own.
+ */
+bool ResourceManifestCompiler::buildHashTable(std::vector<DWORD> &seeds, std::vector<int> &slots) {
+
+	int numRecords = (int)resources.size();
+	int numBuckets = numRecords / 2 + 1;
+	int numSlots = numRecords + numRecords / 4 + 1;
+
+	std::vector< std::vector<int> > buckets(numBuckets);
+	for (int i = 0; i < numRecords; i++) {
+		buckets[ResourceManifest::hashName(resources[i].name.c_str(), 0) % numBuckets].push_back(i);
+	}
+
+	std::vector< std::pair<int, int> > order;
+	for (int i = 0; i < numBuckets; i++) {
+		order.push_back(std::make_pair(-(int)buckets[i].size(), i));
+	}
+	std::sort(order.begin(), order.end());
+
+	seeds.assign(numBuckets, 0);
+	slots.assign(numSlots, -1);
+
+	for (int i = 0; i < numBuckets; i++) {
+
+		std::vector<int> &bucket = buckets[order[i].second];
+		if (bucket.empty()) break;
+
+		DWORD seed;
+		std::vector<int> bucketSlots(bucket.size());
+		for (seed = 1; seed <= MAX_BUCKET_SEED; seed++) {
+			bool fits = true;
+			for (int j = 0; j < (int)bucket.size() && fits; j++) {
+				bucketSlots[j] = ResourceManifest::hashName(resources[bucket[j]].name.c_str(), seed) % numSlots;
+				if (slots[bucketSlots[j]] >= 0) fits = false;
+				for (int k = 0; k < j && fits; k++) {
+					if (bucketSlots[k] == bucketSlots[j]) fits = false;
+				}
+			}
+			if (fits) break;
+		}
+
+		if (seed > MAX_BUCKET_SEED) {
+			error("Couldn't build a perfect hash of the resource names");
+			return false;
+		}
+
+		seeds[order[i].second] = seed;
+		for (int j = 0; j < (int)bucket.size(); j++) {
+			slots[bucketSlots[j]] = bucket[j];
+		}
+
+	}
+
+	return true;
+}
+
+/**
+ * Reads the size of each texture that goes in an atlas from its file and packs
+ * them onto pages. A texture's size is kept in its record so that the game can
+ * tell if the file has changed since.
+ */
+void ResourceManifestCompiler::packAtlases(std::vector<ManifestAtlasPage> &pages) {
+
+	TextureAtlasPacker packer(MAX_ATLAS_PAGE_SIZE);
+
+	for (int i = 0; i < (int)resources.size(); i++) {
+
+		ScriptResource *texture = &resources[i];
+		if (texture->record.type != ResourceTypes::Texture || texture->record.atlas == 0) continue;
+
+		if (texture->record.group != 0) {
+			error("%s(%d): Texture %s is in an atlas but only loaded with group %d", RESOURCE_SCRIPT_FILE, texture->line,
+				texture->name.c_str(), texture->record.group);
+			continue;
+		}
+		if (texture->record.mipmap) {
+			error("%s(%d): Texture %s is in an atlas but atlas pages don't have mipmaps", RESOURCE_SCRIPT_FILE, texture->line, texture->name.c_str());
+			continue;
+		}
+
+		int width, height;
+		if (!TextureAtlasPacker::readImageSize(texture->filename.c_str(), &width, &height)) {
+			error("%s(%d): Couldn't read the size of %s, only PNG files can go in an atlas", RESOURCE_SCRIPT_FILE, texture->line,
+				texture->filename.c_str());
+			continue;
+		}
+
+		//hgeAnimation starts the next row at the edge of the texture
+		bool fullWidth = false;
+		for (int j = 0; j < (int)resources.size(); j++) {
+			const ManifestRecord *animation = &resources[j].record;
+			if (animation->type == ResourceTypes::Animation && resources[j].dependency == texture->name &&
+				animation->x + animation->frames * animation->width > width) fullWidth = true;
+		}
+
+		texture->record.width = (float)width;
+		texture->record.height = (float)height;
+		packer.add(i, texture->record.atlas, width, height, fullWidth);
+	}
+
+	packer.pack();
+
+	for (int i = 0; i < (int)packer.getTextures().size(); i++) {
+		const AtlasTexture *placed = &packer.getTextures()[i];
+		ScriptResource *texture = &resources[placed->texture];
+		if (placed->page < 0) {
+			error("%s(%d): Texture %s doesn't fit on atlas %d's pages", RESOURCE_SCRIPT_FILE, texture->line, texture->name.c_str(), placed->atlas);
+			continue;
+		}
+		texture->record.atlasPage = placed->page;
+		texture->record.atlasX = (float)placed->x;
+		texture->record.atlasY = (float)placed->y;
+	}
+
+	pages = packer.getPages();
+}
+
+/**
+ * Lays out the manifest: header, records, hash table, groups, group members,
+ * atlas pages and then the strings.
+ */
+void ResourceManifestCompiler::build(const char *scriptFile, const std::vector<DWORD> &seeds, const std::vector<int> &slots, const std::vector<ManifestAtlasPage> &pages) {
+
+	int numRecords = (int)resources.size();
+
+	//Strings, starting with an empty one for resources without a file name
+	std::vector<BYTE> strings(1, 0);
+	std::vector<ManifestRecord> records;
+	for (int i = 0; i < numRecords; i++) {
+		ManifestRecord record = resources[i].record;
+		record.name = (DWORD)strings.size();
+		append(strings, resources[i].name.c_str(), (int)resources[i].name.size() + 1);
+		record.filename = 0;
+		if (!resources[i].filename.empty()) {
+			record.filename = (DWORD)strings.size();
+			append(strings, resources[i].filename.c_str(), (int)resources[i].filename.size() + 1);
+		}
+		record.dependency = resources[i].dependency.empty() ? -1 : find(resources[i].dependency);
+		records.push_back(record);
+	}
+
+	//Groups, with each group's records in load order
+	std::map<int, std::vector<int> > groupMembers;
+	for (int type = 0; type < NUM_RESOURCE_TYPES; type++) {
+		for (int i = 0; i < numRecords; i++) {
+			if (records[i].type == type) groupMembers[records[i].group].push_back(i);
+		}
+	}
+	std::vector<ManifestGroup> groups;
+	std::vector<int> members;
+	for (std::map<int, std::vector<int> >::iterator i = groupMembers.begin(); i != groupMembers.end(); i++) {
+		ManifestGroup group;
+		group.group = i->first;
+		group.firstMember = (int)members.size();
+		group.numMembers = (int)i->second.size();
+		members.insert(members.end(), i->second.begin(), i->second.end());
+		groups.push_back(group);
+	}
+
+	ManifestHeader header;
+	memset(&header, 0, sizeof(ManifestHeader));
+	header.magic = RESOURCE_MANIFEST_MAGIC;
+	header.version = RESOURCE_MANIFEST_VERSION;
+	WIN32_FILE_ATTRIBUTE_DATA attributes;
+	if (GetFileAttributesEx(scriptFile, GetFileExInfoStandard, &attributes)) {
+		header.scriptSize = attributes.nFileSizeLow;
+		header.scriptTime = attributes.ftLastWriteTime;
+	}
+	header.numRecords = numRecords;
+	header.numBuckets = (int)seeds.size();
+	header.numSlots = (int)slots.size();
+	header.numGroups = (int)groups.size();
+	header.numAtlasPages = (int)pages.size();
+	header.recordsOffset = sizeof(ManifestHeader);
+	header.seedsOffset = header.recordsOffset + numRecords * sizeof(ManifestRecord);
+	header.slotsOffset = header.seedsOffset + header.numBuckets * sizeof(DWORD);
+	header.groupsOffset = header.slotsOffset + header.numSlots * sizeof(int);
+	header.membersOffset = header.groupsOffset + header.numGroups * sizeof(ManifestGroup);
+	header.atlasPagesOffset = header.membersOffset + (DWORD)members.size() * sizeof(int);
+	header.stringsOffset = header.atlasPagesOffset + header.numAtlasPages * sizeof(ManifestAtlasPage);
+
+	append(manifest, &header, sizeof(ManifestHeader));
+	if (numRecords > 0) append(manifest, &records[0], numRecords * sizeof(ManifestRecord));
+	if (!seeds.empty()) append(manifest, &seeds[0], (int)seeds.size() * sizeof(DWORD));
+	if (!slots.empty()) append(manifest, &slots[0], (int)slots.size() * sizeof(int));
+	if (!groups.empty()) append(manifest, &groups[0], (int)groups.size() * sizeof(ManifestGroup));
+	if (!members.empty()) append(manifest, &members[0], (int)members.size() * sizeof(int));
+	if (!pages.empty()) append(manifest, &pages[0], (int)pages.size() * sizeof(ManifestAtlasPage));
+	append(manifest, &strings[0], (int)strings.size());
+
+}
+
+bool ResourceManifestCompiler::save(const char *manifestFile) {
+
+	std::ofstream file(manifestFile, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (file) file.write((const char*)&manifest[0], (std::streamsize)manifest.size());
+
+	if (!file) {
+		error("Couldn't write %s", manifestFile);
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Looks through the .cpp and .h files in a directory for resource names passed
+ * as string literals to smh->resources, and reports any that aren't in the
+ * script or are a different type of resource. Returns how many were checked.
+ */
+int ResourceManifestCompiler::validateCode(const char *sourceDir) {
+
+	int numChecked = 0;
+	const char *patterns[2] = { "\\*.cpp", "\\*.h" };
+
+	for (int i = 0; i < 2; i++) {
+		WIN32_FIND_DATA findData;
+		HANDLE search = FindFirstFile((std::string(sourceDir) + patterns[i]).c_str(), &findData);
+		if (search == INVALID_HANDLE_VALUE) continue;
+		do {
+			numChecked += validateFile(std::string(sourceDir) + "\\" + findData.cFileName);
+		} while (FindNextFile(search, &findData));
+		FindClose(search);
+	}
+
+	return numChecked;
+}
+
+int ResourceManifestCompiler::validateFile(const std::string &fileName) {
+
+	std::ifstream source(fileName.c_str());
+	std::string line;
+	int lineNum = 0;
+	int numChecked = 0;
+
+	while (std::getline(source, line)) {
+
+		lineNum++;
+		std::string::size_type pos = 0;
+
+		while ((pos = line.find("resources->Get", pos)) != std::string::npos) {
+
+			pos += 11;
+			std::string::size_type paren = line.find('(', pos);
+			if (paren == std::string::npos || paren + 1 >= line.size() || line[paren + 1] != '"') continue;
+			std::string::size_type quote = line.find('"', paren + 2);
+			if (quote == std::string::npos) continue;
+
+			std::string getter = line.substr(pos, paren - pos);
+			std::string name = line.substr(paren + 2, quote - paren - 2);
+
+			int type = -1;
+			for (int i = 0; i < NUM_RESOURCE_TYPES; i++) {
+				if (getter == getterNames[i]) type = i;
+			}
+			if (type < 0) continue;
+
+			numChecked++;
+			int found = find(name);
+			if (found < 0) {
+				error("%s(%d): %s(\"%s\") isn't in the resource script", fileName.c_str(), lineNum, getter.c_str(), name.c_str());
+			} else if (resources[found].record.type != type) {
+				error("%s(%d): %s(\"%s\") but %s is of type %s", fileName.c_str(), lineNum, getter.c_str(), name.c_str(),
+					name.c_str(), typeNames[resources[found].record.type]);
+			}
+
+		}
+	}
+
+	return numChecked;
+}
+
+int ResourceManifestCompiler::find(const std::string &name) {
+	std::map<std::string, int>::iterator i = indices.find(name);
+	return i == indices.end() ? -1 : i->second;
+}
+
+void ResourceManifestCompiler::error(const char *format, ...) {
+	char text[512];
+	va_list args;
+	va_start(args, format);
+	_vsnprintf(text, sizeof(text) - 1, format, args);
+	va_end(args);
+	text[sizeof(text) - 1] = '\0';
+	errors.push_back(text);
+}
+
+const std::vector<BYTE> &ResourceManifestCompiler::getManifest() {
+	return manifest;
+}
+
+const std::vector<std::string> &ResourceManifestCompiler::getErrors() {
+	return errors;
+}
+
+int ResourceManifestCompiler::getNumResources() {
+	return (int)resources.size();
+}
@@ -0,0 +1,133 @@
+#include "SmileyEngine.h"
+
+extern SMH *smh;
+
+ResourceStreamer::ResourceStreamer() {
+	budget = (float)smh->hge->Ini_GetInt("Debug", "resourceStreamingBudget", DEFAULT_STREAMING_BUDGET);
+	cursor = 0;
+	started = false;
+}
+
+ResourceStreamer::~ResourceStreamer() { }
+
+/**
+ * Starts loading a resource group in the background. Does nothing if it is
+ * already loaded or waiting to be.
+ */
+void ResourceStreamer::request(int group) {
+
+	if (isStreaming(group) || isResident(group)) return;
+
+	queue.push_back(group);
+	smh->logger->write(LogLevels::Info, LogCategories::Resources, "Streaming resource group %d", group);
+
+}
+
+/**
+ * Stops loading a group. Resources that were already loaded stay loaded until
+ * the group is purged.
+ */
+void ResourceStreamer::cancel(int group) {
+	if (!queue.empty() && queue.front() == group) started = false;
+	queue.remove(group);
+}
+
+/**
+ * Called once a frame to load resources from the front of the queue until the
+ * frame's budget is used up.
+ */
+void ResourceStreamer::update() {
+
+	if (queue.empty()) return;
+
+	LARGE_INTEGER frequency, start, now;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&start);
+
+	do {
+
+		if (!started) {
+			cursor = 0;
+			started = true;
+			groupStartTime = start;
+		}
+
+		if (!loadNext()) {
+			QueryPerformanceCounter(&now);
+			smh->logger->write(LogLevels::Info, LogCategories::Resources, "Resource group %d resident after %.1f ms",
+				queue.front(), (double)(now.QuadPart - groupStartTime.QuadPart) * 1000.0 / (double)frequency.QuadPart);
+			queue.pop_front();
+			started = false;
+			if (queue.empty()) return;
+		}
+
+		QueryPerformanceCounter(&now);
+
+	} while ((double)(now.QuadPart - start.QuadPart) * 1000.0 / (double)frequency.QuadPart < budget);
+
+}
+
+/**
+ * Loads the next resource in the group at the front of the queue that isn't
+ * loaded yet. The manifest lists textures before the sprites and animations
+ * that use them. Returns false when the whole group is loaded.
+ */
+bool ResourceStreamer::loadNext() {
+
+	int numMembers;
+	const int *members = smh->resources->getGroupMembers(queue.front(), &numMembers);
+
+	while (cursor < numMembers) {
+		int record = members[cursor++];
+		if (!smh->resources->getHandle(record)) {
+			smh->resources->load(record);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * Returns whether every resource in a group is loaded.
+ */
+bool ResourceStreamer::isResident(int group) {
+	ResourceResidency residency = getResidency(group);
+	return residency.numLoaded == residency.numResources;
+}
+
+/**
+ * Returns whether a group is waiting to be loaded or being loaded.
+ */
+bool ResourceStreamer::isStreaming(int group) {
+	for (std::list<int>::iterator i = queue.begin(); i != queue.end(); i++) {
+		if (*i == group) return true;
+	}
+	return false;
+}
+
+/**
+ * Counts how many of a group's resources are loaded and how much memory its
+ * loaded textures take up.
+ */
+ResourceResidency ResourceStreamer::getResidency(int group) {
+
+	ResourceResidency residency;
+	residency.numResources = residency.numLoaded = residency.textureBytes = 0;
+
+	int numMembers;
+	const int *members = smh->resources->getGroupMembers(group, &numMembers);
+
+	for (int i = 0; i < numMembers; i++) {
+		residency.numResources++;
+		DWORD handle = smh->resources->getHandle(members[i]);
+		if (!handle) continue;
+		residency.numLoaded++;
+		if (smh->resources->getRecord(members[i])->type == ResourceTypes::Texture) {
+			HTEXTURE texture = (HTEXTURE)handle;
+			residency.textureBytes += smh->hge->Texture_GetWidth(texture) * smh->hge->Texture_GetHeight(texture) * 4;
+		}
+	}
+
+	return residency;
+}
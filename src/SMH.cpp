@@ -10,13 +10,20 @@
 #include "LootManager.h"
 #include "FenwarManager.h"
 #include "ProjectileManager.h"
+#include "PatternEmitter.h"
 #include "Boss.h"
 #include "ExplosionManager.h"
+#include "SpecialTileManager.h"
+#include "collisioncircle.h"
 
 SMH::SMH(HGE *_hge) 
 {
 	hge = _hge;
+	logger = new Logger(hge->System_GetState(HGE_LOGFILE));
 	initializedYet = false;
+	gameManagersCreated = false;
+	startupTasks = NULL;
+	startupTimeline = NULL;
 	debugMode = false;
 	debugText = "";
 	screenAlpha = 0.0;
@@ -29,12 +36,37 @@ SMH::SMH(HGE *_hge)
 	screenColor=Colors::BLACK;
 	screenAlpha=0.0;
 
+	//Created here so the command line can request it before init
+	bossBenchmark = new BossBenchmark();
+	microBenchmark = new MicroBenchmark();
+	selfTest = new SelfTest();
+
 }
 
 SMH::~SMH() { }
 
+//Startup tasks, see SMH::init
+static void parseEnemyTableTask(void *gameData, int param) {
+	((GameData*)gameData)->parseEnemyTable();
+}
+
+static void loadEnemyDataTask(void *gameData, int param) {
+	((GameData*)gameData)->loadEnemyData();
+}
+
+static void parseGameTextTask(void *gameData, int param) {
+	((GameData*)gameData)->parseGameText();
+}
+
+static void predecodeSoundsTask(void *assetPacks, int slice) {
+	((AssetPacks*)assetPacks)->predecode(slice, STARTUP_DECODE_SLICES);
+}
+
 /**
- * Creates the game objects. Note that order is important!
+ * Creates what the title screen needs and opens it. Everything else is made by
+ * createGameManagers() once the title screen has been drawn, except when a
+ * benchmark or the self test goes straight into the game. Note that order is
+ * important!
  */
 void SMH::init() 
 {
@@ -44,50 +76,165 @@ void SMH::init()
 		log("---Initializing Smiley's Maze Hunt---");
 		log("-------------------------------------");
 
-		log("Creating ResourceManager");
-		resources = new hgeResourceManager("Data/ResourceScript");
-		hge->Resource_AttachPack("Data/Sounds.zip");
+		startupTimeline = new StartupTimeline();
+
+		startupTimeline->beginStage("Resource manifest");
+		log("Building TileTraits");
+		TileTraits::init();
+
+		log("Creating AssetPacks");
+		assetPacks = new AssetPacks();
+		assetPacks->attach("Data/Sounds.pak", "Data/Sounds.zip");
+		assetPacks->attach("Data/GameData.pak", "Data/GameData.zip");
+		//hgeFont can only read its files through HGE
 		hge->Resource_AttachPack("Data/Fonts.zip");
-		hge->Resource_AttachPack("Data/GameData.zip");
+
+		log("Creating ResourceManifest");
+		resources = new ResourceManifest(RESOURCE_MANIFEST_FILE, RESOURCE_SCRIPT_FILE);
+		startupTimeline->endStage();
+
+		startupTimeline->beginStage("Engine services");
+		log("Creating FrameProfiler");
+		frameProfiler = new FrameProfiler();
+
+		log("Creating AreaArena");
+		areaArena = new AreaArena();
+
+		log("Creating TextLayoutCache");
+		textLayoutCache = new TextLayoutCache();
+
+		log("Creating ParticlePool");
+		particlePool = new ParticlePool();
+
+		log("Creating SpriteBatch");
+		spriteBatch = new SpriteBatch();
+
+		log("Creating WorkerPool");
+		workerPool = new WorkerPool();
+
+		log("Creating ResourceStreamer");
+		resourceStreamer = new ResourceStreamer();
 
 		log("Creating Console");
 		console = new Console();
 
 		log("Creating PopupMessageManager");
 		popupMessageManager = new PopupMessageManager();
+		startupTimeline->endStage();
+
+		//The data tables are parsed and the sounds decoded on the worker threads
+		//while the main thread gets on with everything that needs HGE
+		startupTimeline->beginStage("Startup tasks");
+		log("Creating GameData");
+		gameData = new GameData();
+
+		log("Starting startup tasks");
+		startupTasks = new StartupTasks();
+		int parseEnemies = startupTasks->add("Parse Enemies.dat", parseEnemyTableTask, gameData, 0);
+		enemyDataTask = startupTasks->add("Enemy data", loadEnemyDataTask, gameData, 0);
+		startupTasks->addDependency(enemyDataTask, parseEnemies);
+		gameTextTask = startupTasks->add("Parse GameText.dat", parseGameTextTask, gameData, 0);
+		if (assetPacks->beginPredecode("Data/Sounds.pak") > 0) {
+			for (int i = 0; i < STARTUP_DECODE_SLICES; i++) {
+				startupTasks->add("Decode Sounds.pak " + Util::intToString(i + 1), predecodeSoundsTask, assetPacks, i);
+			}
+		}
+		startupTasks->start();
+		startupTimeline->endStage();
 
+		startupTimeline->beginStage("Save data and input");
 		log("Creating SaveManager");
 		saveManager = new SaveManager();
 
+		log("Creating Input");
+		input = new SmileyInput();
+		startupTimeline->endStage();
+
+		startupTimeline->beginStage("Sound and menus");
+		log("Creating SoundManager");
+		soundManager = new SoundManager();
+
+		log("Creating ScreenEffectManager");
+		screenEffectsManager = new ScreenEffectsManager();
+
+		log("Creating MainMenu");
+		menu = new MainMenu();
+		startupTimeline->endStage();
+
+		//The title screen doesn't need every sound loaded, so they stream in behind it
+		log("Streaming sounds");
+		resourceStreamer->request(ResourceGroups::Sounds);
+
+		//Open the menu after everything is initialized so that the music doesn't start playing
+		//until the screen starts drawing. The benchmarks and self test go straight into the game instead.
+		if (selfTest->isRequested() || microBenchmark->isRequested() || bossBenchmark->isRequested()) {
+			createGameManagers();
+			if (selfTest->isRequested()) {
+				selfTest->run();
+			} else if (microBenchmark->isRequested()) {
+				microBenchmark->run();
+			} else {
+				bossBenchmark->start();
+			}
+		} else {
+			startupTimeline->beginStage("Title screen");
+			menu->open(MenuScreens::TITLE_SCREEN, true);
+			startupTimeline->endStage();
+
+			//Ended by updateGame once the first frame has been drawn
+			startupTimeline->beginStage("First frame");
+		}
+	}
+	catch(System::Exception *ex) 
+	{
+		logger->write(LogLevels::Error, LogCategories::Engine, "----FATAL ERROR IN RENDER FUNC-----");
+		logger->write(LogLevels::Error, LogCategories::Engine, "%s", ex->ToString());
+		logger->flush();
+		
+		MessageBox(NULL, "A fatal error has occured while intializing Smiley's Maze Hunt.\nYou may check the log for more information.", "Error", MB_OK | MB_ICONERROR | MB_SYSTEMMODAL);
+		exit(1);
+	}
+}
+
+/**
+ * Creates the game objects the title screen doesn't use, waiting for the data
+ * tables first, and writes the startup timeline. Note that order is important!
+ */
+void SMH::createGameManagers()
+{
+	try
+	{
+		startupTimeline->beginStage("Game data");
+		startupTasks->waitFor(enemyDataTask);
+		startupTasks->waitFor(gameTextTask);
+		startupTimeline->endStage();
+
+		startupTimeline->beginStage("Player");
 		log("Creating Player");
 		player = new Player();
 
 		log("Creating Enemy Manager");
 		enemyManager = new EnemyManager();
 
-		log("Creating Input");
-		input = new SmileyInput();
-
-		log("Creating GameData");
-		gameData = new GameData();
+		//The ability descriptions quote the player's damage
+		gameData->refreshAbilityData();
 
 		log("Creating NPCManager");
 		npcManager = new NPCManager();
 
-		log("Creating SoundManager");
-		soundManager = new SoundManager();
-
-		log("Creating MainMenu");
-		menu = new MainMenu();
-
 		log("Creating WindowManager");
 		windowManager = new WindowManager();
+		startupTimeline->endStage();
 
+		startupTimeline->beginStage("Game managers");
 		log("Creating EnemyGroupManager");
 		enemyGroupManager = new EnemyGroupManager();
 
 		log("Creating AreaChanger");
 		areaChanger = new AreaChanger();
+
+		log("Creating AreaLoader");
+		areaLoader = new AreaLoader();
 			
 		log("Creating LootManager");
 		lootManager = new LootManager();
@@ -95,44 +242,60 @@ void SMH::init()
 		log("Creating ProjectileManager");
 		projectileManager = new ProjectileManager();		
 
+		log("Creating PatternEmitter");
+		patternEmitter = new PatternEmitter();
+
 		log("Creating BossManager");
 		bossManager = new BossManager();
 
 		log("Creating FenwarManager");
 		fenwarManager = new FenwarManager();
 
-		log("Creating ScreenEffectManager");
-		screenEffectsManager = new ScreenEffectsManager();
-
 		log("Creating ExplosionManager");
 		explosionManager = new ExplosionManager();
 
 		log("Creating DeathEffectManager");
 		deathEffectManager = new DeathEffectManager();
+		startupTimeline->endStage();
 
 		//Create Environment last
+		startupTimeline->beginStage("Environment");
 		log("Creating Environment");
 		environment = new Environment();
+		startupTimeline->endStage();
 
-		log("Precaching Resources");
-		resources->Precache(ResourceGroups::Sounds);
-
-		//Open the menu after everything is initialized so that the music doesn't start playing
-		//until the screen starts drawing.
-		menu->open(MenuScreens::TITLE_SCREEN, true);
+		startupTimeline->write();
+		delete startupTimeline;
+		startupTimeline = NULL;
+		gameManagersCreated = true;
 
 		log("-------Initialization Complete-------");
 	}
 	catch(System::Exception *ex) 
 	{
-		hge->System_Log("----FATAL ERROR IN RENDER FUNC-----");
-		hge->System_Log("%s", ex->ToString());
+		logger->write(LogLevels::Error, LogCategories::Engine, "----FATAL ERROR IN RENDER FUNC-----");
+		logger->write(LogLevels::Error, LogCategories::Engine, "%s", ex->ToString());
+		logger->flush();
 		
 		MessageBox(NULL, "A fatal error has occured while intializing Smiley's Maze Hunt.\nYou may check the log for more information.", "Error", MB_OK | MB_ICONERROR | MB_SYSTEMMODAL);
 		exit(1);
 	}
 }
 
+/**
+ * Called once a frame. Once the game managers have been created and the
+ * startup tasks are all done, logs when each one ran.
+ */
+void SMH::updateStartupTasks()
+{
+	if (!gameManagersCreated || !startupTasks || !startupTasks->isFinished()) return;
+
+	startupTasks->finish();
+	startupTasks->write();
+	delete startupTasks;
+	startupTasks = NULL;
+}
+
 /**
  * This is called each frame to update the game. Returns true if the
  * game is finished and the program should exit.
@@ -144,16 +307,39 @@ bool SMH::updateGame()
 		drawLoadScreen();
 		init();
 		initializedYet = true;
+
+		//The micro benchmark and self test are done as soon as init is
+		if (microBenchmark->isRequested() || selfTest->isRequested()) return true;
+	}
+	else if (!gameManagersCreated)
+	{
+		//Whatever the title screen doesn't use is created once it has been drawn
+		startupTimeline->endStage();
+		createGameManagers();
 	}
 
+	frameProfiler->beginFrame();
+
 	try
 	{
 		float dt = min(0.1, hge->Timer_GetDelta());
 
+		//The boss benchmark plays every frame at the same dt so runs can be compared
+		if (bossBenchmark->isRunning()) {
+			if (bossBenchmark->beginFrame()) return true;
+			dt = BOSS_BENCHMARK_DT;
+		}
+
 		timeInState += dt;
 		frameCounter++;
+		frameProfiler->beginSection(FrameSections::Input);
 		input->UpdateInput();
+		frameProfiler->endSection(FrameSections::Input);
 		
+		//Load anything waiting to be streamed in, whatever state the game is in
+		resourceStreamer->update();
+		updateStartupTasks();
+
 		//Input for taking screenshots
 		if (hge->Input_KeyDown(HGEK_F9)) {
 			hge->System_Snapshot();
@@ -161,7 +347,10 @@ bool SMH::updateGame()
 		
 		if (gameState == MENU) {
 
-			if (menu->update(dt)) return true;
+			frameProfiler->beginSection(FrameSections::Menu);
+			bool exitGame = menu->update(dt);
+			frameProfiler->endSection(FrameSections::Menu);
+			if (exitGame) return true;
 
 		} else if (gameState == GAME) {
 
@@ -181,14 +370,21 @@ bool SMH::updateGame()
 				menuClosedThisFrame = true;
 			}
 
+			frameProfiler->beginSection(FrameSections::Windows);
 			windowManager->update(dt);
+			frameProfiler->endSection(FrameSections::Windows);
+			frameProfiler->beginSection(FrameSections::AreaChanger);
 			areaChanger->update(dt);
+			frameProfiler->endSection(FrameSections::AreaChanger);
+			frameProfiler->beginSection(FrameSections::OtherUpdate);
 			enemyGroupManager->update(dt);
 			fenwarManager->update(dt);
 			environment->updateAdviceMan(dt);
 			player->updateGUI(dt);
 			deathEffectManager->update(dt);
 			popupMessageManager->update(dt);
+			particlePool->update();
+			frameProfiler->endSection(FrameSections::OtherUpdate);
 
 			if (!windowManager->isOpenWindow() && !areaChanger->isChangingArea() && !fenwarManager->isEncounterActive() && 
 				!environment->isAdviceManActive() && !deathEffectManager->isActive())
@@ -199,15 +395,32 @@ bool SMH::updateGame()
 					windowManager->openGameMenu();
 				}
 
+				frameProfiler->beginSection(FrameSections::Player);
 				player->update(dt);
+				frameProfiler->endSection(FrameSections::Player);
+				frameProfiler->beginSection(FrameSections::OtherUpdate);
 				explosionManager->update(dt);
+				frameProfiler->endSection(FrameSections::OtherUpdate);
+				frameProfiler->beginSection(FrameSections::Environment);
 				environment->update(dt);
+				frameProfiler->endSection(FrameSections::Environment);
+				frameProfiler->beginSection(FrameSections::Bosses);
 				bossManager->update(dt);
+				frameProfiler->endSection(FrameSections::Bosses);
+				frameProfiler->beginSection(FrameSections::Enemies);
 				enemyManager->update(dt);
+				frameProfiler->endSection(FrameSections::Enemies);
+				frameProfiler->beginSection(FrameSections::OtherUpdate);
 				lootManager->update(dt);
+				frameProfiler->endSection(FrameSections::OtherUpdate);
+				frameProfiler->beginSection(FrameSections::Projectiles);
 				projectileManager->update(dt);
+				patternEmitter->update(dt);
+				frameProfiler->endSection(FrameSections::Projectiles);
+				frameProfiler->beginSection(FrameSections::OtherUpdate);
 				npcManager->update(dt);
 				screenEffectsManager->update(dt);
+				frameProfiler->endSection(FrameSections::OtherUpdate);
 			}
 
             smh->resources->GetAnimation("fenwar")->Update(dt);
@@ -221,8 +434,10 @@ bool SMH::updateGame()
 	}
 	catch(System::Exception *ex) 
 	{
-		hge->System_Log("----FATAL ERROR IN UPDATE FUNC-----");
-		hge->System_Log("%s", ex->ToString());
+		logger->write(LogLevels::Error, LogCategories::Engine, "----FATAL ERROR IN UPDATE FUNC-----");
+		logger->write(LogLevels::Error, LogCategories::Engine, "%s", ex->ToString());
+		frameProfiler->logSummary();
+		logger->flush();
 		int result = MessageBox(NULL, "An error has occured. You may check the log for more information. Do you wish to attempt to continue?", "Error", MB_YESNO | MB_ICONERROR | MB_SYSTEMMODAL);
 
 		if (result == IDNO)
@@ -242,9 +457,13 @@ void SMH::drawGame()
 	if (!initializedYet)
 		return;
 
+	frameProfiler->beginSection(FrameSections::Draw);
+
 	try
 	{
-		float dt = hge->Timer_GetDelta();
+		//Particles and animations are moved on while they are drawn, so the boss
+		//benchmark has to draw with the same fixed dt it updates with
+		float dt = bossBenchmark->isRunning() ? BOSS_BENCHMARK_DT : hge->Timer_GetDelta();
 
 		screenEffectsManager->applyEffect();
 		hge->Gfx_BeginScene();
@@ -252,9 +471,13 @@ void SMH::drawGame()
 		if (getGameState() == MENU) {
 			menu->draw(dt);
 		} else {
+			spriteBatch->beginSection(BatchSections::Environment);
 			environment->draw(dt);
+			spriteBatch->endSection();
 			lootManager->draw(dt);
+			spriteBatch->beginSection(BatchSections::Enemies);
 			enemyManager->draw(dt);
+			spriteBatch->endSection();
 			npcManager->draw(dt);
 			bossManager->drawBeforeSmiley(dt);
 			if (!deathEffectManager->isActive()) player->draw(dt);
@@ -268,7 +491,9 @@ void SMH::drawGame()
 			environment->drawSwitchTimers(dt);
 			if (screenAlpha > 0.0) drawScreenColor(screenColor, screenAlpha);
 			areaChanger->draw(dt);
+			spriteBatch->beginSection(BatchSections::GUI);
 			player->drawGUI(dt);
+			spriteBatch->endSection();
 			popupMessageManager->draw(dt);
 			windowManager->draw(dt);
 			deathEffectManager->draw(dt);
@@ -280,6 +505,14 @@ void SMH::drawGame()
 			resources->GetFont("consoleFnt")->printf(1000,5,HGETEXT_RIGHT,"(%d,%d)  FPS: %d", 
 				player->gridX, player->gridY, hge->Timer_GetFPS());
 
+			//Flames, mushrooms and ice blocks that were updated out of the ones in the area
+			if (getGameState() == GAME) {
+				resources->GetFont("consoleFnt")->printf(1000,30,HGETEXT_RIGHT,"Special tiles: %d/%d active", 
+					environment->specialTileManager->getNumActiveTiles(), environment->specialTileManager->getNumTiles());
+				resources->GetFont("consoleFnt")->printf(1000,55,HGETEXT_RIGHT,"Particles: %d systems, %d particles (%d pooled, %d culled)", 
+					particlePool->getNumLiveSystems(), particlePool->getNumLiveParticles(), particlePool->getNumPooledSystems(), particlePool->getNumCulled());
+			}
+
 			//Debug text
 			resources->GetFont("consoleFnt")->printf(10,700,HGETEXT_LEFT,debugText.c_str());
 		}
@@ -288,8 +521,10 @@ void SMH::drawGame()
 	}
 	catch(System::Exception *ex) 
 	{
-		hge->System_Log("----FATAL ERROR IN RENDER FUNC-----");
-		hge->System_Log("%s", ex->ToString());
+		logger->write(LogLevels::Error, LogCategories::Engine, "----FATAL ERROR IN RENDER FUNC-----");
+		logger->write(LogLevels::Error, LogCategories::Engine, "%s", ex->ToString());
+		frameProfiler->logSummary();
+		logger->flush();
 		int result = MessageBox(NULL, "An error has occured. You may check the log for more information. Do you wish to attempt to continue?", "Error", MB_YESNO | MB_ICONERROR | MB_SYSTEMMODAL);
 
 		if (result == IDNO)
@@ -297,6 +532,22 @@ void SMH::drawGame()
 			exit(1);
 		}
 	}
+
+	frameProfiler->endSection(FrameSections::Draw);
+
+	if (bossBenchmark->isRunning()) bossBenchmark->endFrame();
+}
+
+/**
+ * Called once when HGE returns from its main loop and the program is about to exit.
+ */
+void SMH::shutdown()
+{
+	if (initializedYet) {
+		frameProfiler->logSummary();
+	}
+
+	logger->shutdown();
 }
 
 void SMH::drawLoadScreen()
@@ -407,6 +658,32 @@ void SMH::drawCollisionBox(hgeRect *box, int color) {
 
 }
 
+/**
+ * Draws a collision circle in red. This is here rather than in collisioncircle.cpp
+ * so that the collision tests don't need SMH.
+ */
+void CollisionCircle::draw() {
+	float EachAngle;
+	float a;
+	float x1;
+	float x2;
+	float y1;
+	float y2;
+ 
+	EachAngle = 2.0 * M_PI / 15.0f;
+ 
+	x2 = (float)radius;
+	y2 = 0.0;
+ 
+	for(a=0.0; a<= (2.0*PI + EachAngle); a+=EachAngle) {
+		x1 = x2;
+		y1 = y2;
+		x2 = (float)radius * cos(a);
+		y2 = (float)radius * sin(a);
+		smh->hge->Gfx_RenderLine(smh->getScreenX(x1+(float)x), smh->getScreenY(y1+(float)y), smh->getScreenX(x2+(float)x), smh->getScreenY(y2+(float)y), ARGB(255,255,0,0));
+	}
+}
+
 /**
  * Draws a sprite at a global position.
  */
@@ -418,7 +695,7 @@ void SMH::drawGlobalSprite(const char* sprite, float x, float y) {
  * Draws a sprite at an absolute position on the screen.
  */
 void SMH::drawSprite(const char* sprite, float x, float y) {
-	resources->GetSprite(sprite)->Render(x, y);
+	spriteBatch->render(resources->GetSprite(sprite), x, y);
 }
 
 /**
@@ -426,7 +703,7 @@ void SMH::drawSprite(const char* sprite, float x, float y) {
  */
 void SMH::drawSprite(const char* sprite, float x, float y, float width, float height) {
 	//resources->GetSprite(sprite)->Render(x,y);
-	resources->GetSprite(sprite)->RenderStretch(x, y, x + width, y + height);
+	spriteBatch->renderStretch(resources->GetSprite(sprite), x, y, x + width, y + height);
 }
 
 /**
@@ -444,10 +721,19 @@ int SMH::getScreenY(int y) {
 }
 
 /**
- * Writes a message to the game log.
+ * Returns whether any part of the given rectangle, in global coordinates, is on the screen
+ */
+bool SMH::isOnScreen(float x, float y, float width, float height) {
+	float screenX = getScreenX(x);
+	float screenY = getScreenY(y);
+	return screenX + width >= 0.0 && screenX <= 1024.0 && screenY + height >= 0.0 && screenY <= 768.0;
+}
+
+/**
+ * Writes a message to the game log. The write happens on the logger's flusher thread.
  */
 void SMH::log(const char* text) {
-	hge->System_Log(text);
+	logger->write(LogLevels::Info, LogCategories::General, "%s", text);
 }
 
 /**
@@ -3,6 +3,7 @@
 #include "SmileyEngine.h"
 #include "Player.h"
 #include "Environment.h"
+#include "MiniMap.h"
 #include "boss.h"
 
 extern SMH *smh;
@@ -42,17 +43,100 @@ bool SaveManager::isTileChanged(int gridX, int gridY) {
  * Returns whether or not (gridX, gridY) is explored in the current area
  */
 bool SaveManager::isExplored(int gridX, int gridY) {
-	return explored[currentArea][gridX][gridY];
+	return getExploredBit(currentArea, gridX, gridY);
 }
 
 /**
- * Marks the screen that smiley can see as explored
+ * Marks the screen that smiley can see as explored. Nothing can change until
+ * Smiley moves to a new square so this only does any work when he does. The
+ * squares that were explored for the first time are kept until the next call.
  */ 
 void SaveManager::explore(int gridX, int gridY) {
-	for (int curGridY = gridY - 6; curGridY <= gridY + 6; curGridY++) {
-		for (int curGridX = gridX - 8; curGridX <= gridX + 8; curGridX++) {
-			if (smh->environment->isInBounds(curGridX,curGridY)) {
-				explored[currentArea][curGridX][curGridY] = true;
+
+	numNewlyExplored = 0;
+
+	if (currentArea == lastExploreArea && gridX == lastExploreX && gridY == lastExploreY) return;
+	lastExploreArea = currentArea;
+	lastExploreX = gridX;
+	lastExploreY = gridY;
+
+	int minX = max(0, gridX - EXPLORE_RANGE_X);
+	int maxX = min(smh->environment->areaWidth - 1, gridX + EXPLORE_RANGE_X);
+	int minY = max(0, gridY - EXPLORE_RANGE_Y);
+	int maxY = min(smh->environment->areaHeight - 1, gridY + EXPLORE_RANGE_Y);
+	if (minX > maxX || minY > maxY) return;
+
+	for (int curGridX = minX; curGridX <= maxX; curGridX++) {
+		DWORD *column = explored[currentArea][curGridX];
+
+		//The range of squares in a column spans at most 2 words
+		for (int word = minY / 32; word <= maxY / 32; word++) {
+			int firstBit = max(minY, word * 32) - word * 32;
+			int lastBit = min(maxY, word * 32 + 31) - word * 32;
+			DWORD mask = (lastBit == 31 ? 0xFFFFFFFF : ((DWORD)1 << (lastBit + 1)) - 1) & ~(((DWORD)1 << firstBit) - 1);
+
+			DWORD newBits = mask & ~column[word];
+			if (newBits == 0) continue;
+			column[word] |= newBits;
+
+			for (int bit = firstBit; bit <= lastBit; bit++) {
+				if (newBits & ((DWORD)1 << bit)) {
+					newlyExplored[numNewlyExplored].gridX = curGridX;
+					newlyExplored[numNewlyExplored].gridY = word * 32 + bit;
+					numNewlyExplored++;
+				}
+			}
+		}
+	}
+
+	numExplored[currentArea] += numNewlyExplored;
+	for (int i = 0; i < numNewlyExplored; i++) {
+		smh->environment->miniMap->reveal(newlyExplored[i].gridX, newlyExplored[i].gridY);
+	}
+
+}
+
+/**
+ * Returns how many squares were explored for the first time by the last call to explore().
+ */
+int SaveManager::getNumNewlyExplored() {
+	return numNewlyExplored;
+}
+
+ExploredTile SaveManager::getNewlyExplored(int index) {
+	return newlyExplored[index];
+}
+
+/**
+ * Returns how many squares have been explored in an area.
+ */
+int SaveManager::getNumExplored(int area) {
+	return numExplored[area];
+}
+
+bool SaveManager::getExploredBit(int area, int gridX, int gridY) {
+	return (explored[area][gridX][gridY >> 5] & ((DWORD)1 << (gridY & 31))) != 0;
+}
+
+void SaveManager::setExploredBit(int area, int gridX, int gridY, bool value) {
+	if (value) {
+		explored[area][gridX][gridY >> 5] |= ((DWORD)1 << (gridY & 31));
+	} else {
+		explored[area][gridX][gridY >> 5] &= ~((DWORD)1 << (gridY & 31));
+	}
+}
+
+/**
+ * Recounts the explored squares in each area after the exploration data is loaded.
+ */
+void SaveManager::countExplored() {
+	for (int i = 0; i < NUM_AREAS; i++) {
+		numExplored[i] = 0;
+		for (int j = 0; j < 256; j++) {
+			for (int k = 0; k < EXPLORED_WORDS; k++) {
+				for (DWORD bits = explored[i][j][k]; bits; bits &= bits - 1) {
+					numExplored[i]++;
+				}
 			}
 		}
 	}
@@ -82,11 +166,14 @@ void SaveManager::resetCurrentData() {
 
 	for (int i = 0; i < NUM_AREAS; i++) {
 		for (int j = 0; j < 256; j++) {
-			for (int k = 0; k < 256; k++) {
-				explored[i][j][k] = false;
+			for (int k = 0; k < EXPLORED_WORDS; k++) {
+				explored[i][j][k] = 0;
 			}
 		}
+		numExplored[i] = 0;
 	}
+	lastExploreArea = lastExploreX = lastExploreY = -1;
+	numNewlyExplored = 0;
 
 	for (int i = 0; i < NUM_AREAS; i++) {
 		hasVisitedArea[i] = false;
@@ -116,7 +203,7 @@ void SaveManager::resetCurrentData() {
  */
 void SaveManager::load(int fileNumber) {
 
-	smh->hge->System_Log("Loading save file %d", fileNumber);
+	smh->logger->write(LogLevels::Info, LogCategories::Save, "Loading save file %d", fileNumber);
 	changeManager->reset();
 	currentSave = fileNumber;
 
@@ -190,14 +277,17 @@ void SaveManager::load(int fileNumber) {
 
 	difficulty = input->readByte();
 
-	//Exploration data
+	//Exploration data. Still stored a bit at a time in the same order as when it was a bool array.
 	for (int i = 0; i < NUM_AREAS; i++) {
 		for (int j = 0; j < 256; j++) {
 			for (int k = 0; k < 256; k++) {
-				explored[i][j][k] = input->readBit();
+				setExploredBit(i, j, k, input->readBit());
 			}
 		}
 	}
+	countExplored();
+	lastExploreArea = lastExploreX = lastExploreY = -1;
+	numNewlyExplored = 0;
 
 	input->close();
 	delete input;
@@ -211,7 +301,7 @@ void SaveManager::load(int fileNumber) {
  */
 void SaveManager::save() {
 
-	smh->hge->System_Log("Saving file %d", currentSave);	
+	smh->logger->write(LogLevels::Info, LogCategories::Save, "Saving file %d", currentSave);	
 
 	//Heal the player to a minimum of 3 health when they save
 	smh->player->setHealth(max(3.0, smh->player->getHealth()));
@@ -295,7 +385,7 @@ void SaveManager::save() {
 	for (int i = 0; i < NUM_AREAS; i++) {
 		for (int j = 0; j < 256; j++) {
 			for (int k = 0; k < 256; k++) {
-				output->writeBit(explored[i][j][k]);
+				output->writeBit(getExploredBit(i, j, k));
 			}
 		}
 	}
@@ -319,7 +409,7 @@ void SaveManager::save() {
  */
 void SaveManager::startNewGame(int fileNumber) {
 
-	smh->hge->System_Log("Creating new save in file %d", fileNumber);
+	smh->logger->write(LogLevels::Info, LogCategories::Save, "Creating new save in file %d", fileNumber);
 
 	files[fileNumber].empty = false;
 	files[fileNumber].timePlayed = 0;
@@ -341,7 +431,7 @@ void SaveManager::startNewGame(int fileNumber) {
  */
 void SaveManager::deleteFile(int file) {
 
-	smh->hge->System_Log("Deleting file %d", file);
+	smh->logger->write(LogLevels::Info, LogCategories::Save, "Deleting file %d", file);
 
 	files[file].empty = true;
 	files[file].timePlayed = 0;
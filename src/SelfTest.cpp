@@ -0,0 +1,1166 @@
+#include "SmileyEngine.h"
+#include "player.h"
+#include "environment.h"
+#include "EnemyFramework.h"
+#include "ProjectileManager.h"
+#include "ExplosionManager.h"
+#include "SpecialTileManager.h"
+#include "lootmanager.h"
+#include "hgefont.h"
+#include "hgesprite.h"
+#include "hgeresource.h"
+#include <stdarg.h>
+#include <algorithm>
+
+extern SMH *smh;
+
+#define SELF_TEST_DT (1.0f / 60.0f)
+#define MAX_LOGGED_FAILURES 20			//Per test, so one broken test doesn't flood the log
+#define SELF_TEST_SEED 1234
+#define SELF_TEST_SAVE_SLOT 3				//Backed up and put back by the tests that save
+#define EXPLORATION_TEST_STEPS 300			//Per area
+#define GLYPH_TOLERANCE 0.01
+#define PARTICLE_TEST_COUNT 5				//Of each kind, next to each other so a skipped erase would show
+#define MASK_TEST_PATTERNS 100
+#define MOVEMENT_TEST_FRAMES 600			//Per area
+#define MOVEMENT_TEST_SPEED 300.0
+#define REPLAY_TEST_FRAMES 240				//Per area
+#define REPLAY_TEST_RUNS 4
+
+SelfTest::SelfTest() {
+	requested = false;
+	currentTest = "";
+	numChecks = numFailures = numTestFailures = 0;
+}
+
+/**
+ * Asks for the self test to be run instead of opening the title screen.
+ */
+void SelfTest::request() {
+	requested = true;
+}
+
+bool SelfTest::isRequested() {
+	return requested;
+}
+
+int SelfTest::getNumFailures() {
+	return numFailures;
+}
+
+/**
+ * Runs every test. Called at the end of SMH::init once the game data has been
+ * loaded.
+ */
+void SelfTest::run() {
+
+	testEnemyGroups();
+	testExploration();
+	testTextLayout();
+	testParticleReset();
+	testTileTraits();
+	testPlayerMovement();
+	testEnemyReplay();
+
+	smh->logger->write(numFailures > 0 ? LogLevels::Error : LogLevels::Info, LogCategories::Engine,
+		"Self test: %d checks, %d failed", numChecks, numFailures);
+
+}
+
+/**
+ * Counts a check and logs it if it failed.
+ */
+void SelfTest::check(bool passed, const char *format, ...) {
+
+	numChecks++;
+	if (passed) return;
+
+	numFailures++;
+	numTestFailures++;
+	if (numTestFailures > MAX_LOGGED_FAILURES) return;
+
+	char text[512];
+	va_list args;
+	va_start(args, format);
+	_vsnprintf(text, sizeof(text) - 1, format, args);
+	va_end(args);
+	text[sizeof(text) - 1] = '\0';
+
+	smh->logger->write(LogLevels::Error, LogCategories::Engine, "Self test: %s FAILED: %s", currentTest, text);
+
+}
+
+//////////// Enemy Groups ////////////////
+
+/**
+ * The parts of an enemy group that the old EnemyGroupManager kept.
+ */
+struct ReferenceGroup {
+	int numEnemies;
+	bool active, triggeredYet, fadingIn, fadingOut;
+	float blockAlpha;
+};
+
+static ReferenceGroup referenceGroups[MAX_GROUPS];
+static std::vector<int> referenceItems, referenceCollision;
+
+static int &referenceItem(int gridX, int gridY) {
+	return referenceItems[gridX * 256 + gridY];
+}
+
+static int &referenceCollisionAt(int gridX, int gridY) {
+	return referenceCollision[gridX * 256 + gridY];
+}
+
+/**
+ * The old disableBlocks, which searched the whole area for the group's blocks.
+ */
+static void referenceDisableBlocks(int whichGroup) {
+	for (int i = 0; i < smh->environment->areaWidth; i++) {
+		for (int j = 0; j < smh->environment->areaHeight; j++) {
+			if (smh->environment->ids(i, j) == ENEMYGROUP_BLOCK && smh->environment->variable(i, j) == whichGroup) {
+				referenceItem(i, j) = 0;
+				referenceCollisionAt(i, j) = WALKABLE;
+			}
+		}
+	}
+}
+
+/**
+ * The old triggerGroup and enableBlocks, which searched the whole area for the
+ * group's popup enemies and blocks.
+ */
+static void referenceTriggerGroup(int whichGroup) {
+	ReferenceGroup *group = &referenceGroups[whichGroup];
+	if (group->triggeredYet) return;
+	group->triggeredYet = true;
+
+	for (int i = 0; i < smh->environment->areaWidth; i++) {
+		for (int j = 0; j < smh->environment->areaHeight; j++) {
+			if (smh->environment->enemyLayer(i, j) != -1 && smh->environment->ids(i, j) == ENEMYGROUP_ENEMY_POPUP &&
+					smh->environment->variable(i, j) == whichGroup) {
+				group->active = true;
+				group->numEnemies++;
+			}
+		}
+	}
+
+	if (group->numEnemies > 0) {
+		group->fadingIn = true;
+		for (int i = 0; i < smh->environment->areaWidth; i++) {
+			for (int j = 0; j < smh->environment->areaHeight; j++) {
+				if (smh->environment->ids(i, j) == ENEMYGROUP_BLOCK && smh->environment->variable(i, j) == whichGroup) {
+					referenceItem(i, j) = ENEMYGROUP_BLOCKGRAPHIC;
+					referenceCollisionAt(i, j) = UNWALKABLE;
+				}
+			}
+		}
+	}
+}
+
+static void referenceNotifyOfDeath(int whichGroup) {
+	ReferenceGroup *group = &referenceGroups[whichGroup];
+	if (!group->active) return;
+	group->numEnemies--;
+	if (group->numEnemies <= 0) {
+		group->fadingOut = true;
+		group->fadingIn = false;
+	}
+}
+
+/**
+ * The old update, which looked at every group every frame.
+ */
+static void referenceUpdate(float dt) {
+	for (int i = 0; i < MAX_GROUPS; i++) {
+		ReferenceGroup *group = &referenceGroups[i];
+		if (group->fadingIn) {
+			group->blockAlpha += 255.0*dt;
+			if (group->blockAlpha > 255.0) {
+				group->blockAlpha = 255.0;
+				group->fadingIn = false;
+			}
+		}
+		if (group->fadingOut) {
+			group->blockAlpha -= 255.0*dt;
+			if (group->blockAlpha < 0.0) {
+				group->blockAlpha = 0.0;
+				group->fadingOut = false;
+				group->active = false;
+				referenceDisableBlocks(i);
+			}
+		}
+		if (group->active && group->triggeredYet && !group->fadingOut && group->numEnemies == 0) {
+			group->fadingIn = false;
+			group->fadingOut = true;
+		}
+	}
+}
+
+/**
+ * Loads the castle and checks that the indexed enemy groups find the same squares
+ * as the old whole area searches, then triggers and clears every group with both
+ * versions side by side and compares them frame by frame.
+ */
+void SelfTest::testEnemyGroups() {
+
+	currentTest = "Enemy groups";
+	numTestFailures = 0;
+
+	smh->saveManager->resetCurrentData();
+	smh->environment->loadArea(CASTLE_OF_EVIL, CASTLE_OF_EVIL, false);
+
+	//Keep Smiley off the trigger squares so that update() only does what the test asks
+	smh->player->moveTo(0, 0);
+
+	EnemyGroupManager *manager = smh->enemyGroupManager;
+	int width = smh->environment->areaWidth;
+	int height = smh->environment->areaHeight;
+
+	//The index must list the same squares in the order the old searches visited them
+	for (int group = 0; group < MAX_GROUPS; group++) {
+		std::list<EnemyGroupTile>::iterator block = manager->groups[group].blocks.begin();
+		std::list<EnemyGroupTile>::iterator popup = manager->groups[group].popupEnemies.begin();
+		for (int i = 0; i < width; i++) {
+			for (int j = 0; j < height; j++) {
+				if (smh->environment->variable(i, j) != group) continue;
+				if (smh->environment->ids(i, j) == ENEMYGROUP_BLOCK) {
+					bool found = block != manager->groups[group].blocks.end() && block->gridX == i && block->gridY == j;
+					check(found, "group %d block at (%d,%d) isn't indexed in order", group, i, j);
+					if (found) block++;
+				} else if (smh->environment->ids(i, j) == ENEMYGROUP_ENEMY_POPUP && smh->environment->enemyLayer(i, j) != -1) {
+					bool found = popup != manager->groups[group].popupEnemies.end() && popup->gridX == i && popup->gridY == j;
+					check(found, "group %d popup enemy at (%d,%d) isn't indexed in order", group, i, j);
+					if (found) popup++;
+				}
+			}
+		}
+		check(block == manager->groups[group].blocks.end(), "group %d has extra blocks indexed", group);
+		check(popup == manager->groups[group].popupEnemies.end(), "group %d has extra popup enemies indexed", group);
+	}
+
+	//Start the reference from the area as it was loaded
+	referenceItems.assign(256 * 256, 0);
+	referenceCollision.assign(256 * 256, 0);
+	for (int i = 0; i < width; i++) {
+		for (int j = 0; j < height; j++) {
+			referenceItem(i, j) = smh->environment->item(i, j);
+			referenceCollisionAt(i, j) = smh->environment->collision(i, j);
+		}
+	}
+	for (int group = 0; group < MAX_GROUPS; group++) {
+		ReferenceGroup *reference = &referenceGroups[group];
+		reference->numEnemies = manager->groups[group].numEnemies;
+		reference->active = manager->groups[group].active;
+		reference->triggeredYet = manager->groups[group].triggeredYet;
+		reference->fadingIn = manager->groups[group].fadingIn;
+		reference->fadingOut = manager->groups[group].fadingOut;
+		reference->blockAlpha = manager->groups[group].blockAlpha;
+	}
+
+	int numTriggered = 0;
+	for (int group = 0; group < MAX_GROUPS; group++) {
+
+		if (manager->groups[group].blocks.empty() && manager->groups[group].popupEnemies.empty()) continue;
+		numTriggered++;
+
+		manager->triggerGroup(group);
+		referenceTriggerGroup(group);
+
+		//Kill the group part way through fading in, then let the blocks fade out
+		int numEnemies = manager->groups[group].numEnemies;
+		for (int frame = 0; frame < 180; frame++) {
+			if (frame == 20) {
+				for (int n = 0; n < numEnemies; n++) {
+					manager->notifyOfDeath(group);
+					referenceNotifyOfDeath(group);
+				}
+			}
+			manager->update(SELF_TEST_DT);
+			referenceUpdate(SELF_TEST_DT);
+
+			for (int g = 0; g < MAX_GROUPS; g++) {
+				EnemyGroup *actual = &manager->groups[g];
+				ReferenceGroup *reference = &referenceGroups[g];
+				check(actual->numEnemies == reference->numEnemies && actual->active == reference->active &&
+					actual->triggeredYet == reference->triggeredYet && actual->fadingIn == reference->fadingIn &&
+					actual->fadingOut == reference->fadingOut && actual->blockAlpha == reference->blockAlpha,
+					"group %d differs on frame %d after triggering group %d", g, frame, group);
+			}
+		}
+
+		for (int i = 0; i < width; i++) {
+			for (int j = 0; j < height; j++) {
+				check(smh->environment->item(i, j) == referenceItem(i, j) && smh->environment->collision(i, j) == referenceCollisionAt(i, j),
+					"square (%d,%d) differs after group %d was cleared", i, j, group);
+			}
+		}
+	}
+
+	smh->logger->write(LogLevels::Info, LogCategories::Engine, "Self test: %s, %d groups triggered and cleared, %d failures",
+		currentTest, numTriggered, numTestFailures);
+
+}
+
+//////////// Exploration ////////////////
+
+static bool referenceExplored[NUM_AREAS][256][256];
+static int referenceNumExplored[NUM_AREAS];
+
+static bool compareTiles(const ExploredTile &a, const ExploredTile &b) {
+	return a.gridX < b.gridX || (a.gridX == b.gridX && a.gridY < b.gridY);
+}
+
+/**
+ * The old explore, which kept a bool per square and checked each one.
+ */
+static void referenceExplore(int area, int gridX, int gridY, std::vector<ExploredTile> &newlyExplored) {
+	newlyExplored.clear();
+	for (int curGridY = gridY - 6; curGridY <= gridY + 6; curGridY++) {
+		for (int curGridX = gridX - 8; curGridX <= gridX + 8; curGridX++) {
+			if (smh->environment->isInBounds(curGridX, curGridY) && !referenceExplored[area][curGridX][curGridY]) {
+				referenceExplored[area][curGridX][curGridY] = true;
+				referenceNumExplored[area]++;
+				ExploredTile tile;
+				tile.gridX = curGridX;
+				tile.gridY = curGridY;
+				newlyExplored.push_back(tile);
+			}
+		}
+	}
+}
+
+/**
+ * Copies a file out of the way so a test can overwrite it, or restores it
+ * afterwards. A file that didn't exist before is deleted again.
+ */
+static void backUpFile(const char *fileName) {
+	std::string backup = std::string(fileName) + ".selftest";
+	DeleteFile(backup.c_str());
+	CopyFile(fileName, backup.c_str(), FALSE);
+}
+
+static void restoreFile(const char *fileName) {
+	std::string backup = std::string(fileName) + ".selftest";
+	if (CopyFile(backup.c_str(), fileName, FALSE)) {
+		DeleteFile(backup.c_str());
+	} else {
+		DeleteFile(fileName);
+	}
+}
+
+/**
+ * Walks Smiley around every area, exploring with the packed bits and with the
+ * old bool array side by side, then saves and loads the result to make sure
+ * it comes back the same.
+ */
+void SelfTest::testExploration() {
+
+	currentTest = "Exploration";
+	numTestFailures = 0;
+
+	SaveManager *saveManager = smh->saveManager;
+	saveManager->resetCurrentData();
+	memset(referenceExplored, 0, sizeof(referenceExplored));
+	memset(referenceNumExplored, 0, sizeof(referenceNumExplored));
+	smh->hge->Random_Seed(SELF_TEST_SEED);
+
+	std::vector<ExploredTile> expected, actual;
+
+	for (int area = 0; area < NUM_AREAS; area++) {
+
+		smh->environment->loadArea(area, area, false);
+		int width = smh->environment->areaWidth;
+		int height = smh->environment->areaHeight;
+
+		//Mostly walk a square at a time, with some jumps, standing still and
+		//squares off the edge of the area
+		int gridX = width / 2, gridY = height / 2;
+		for (int step = 0; step < EXPLORATION_TEST_STEPS; step++) {
+			int move = smh->hge->Random_Int(0, 9);
+			if (move == 0) {
+				gridX = smh->hge->Random_Int(-10, width + 10);
+				gridY = smh->hge->Random_Int(-10, height + 10);
+			} else if (move > 1) {
+				gridX += smh->hge->Random_Int(-1, 1);
+				gridY += smh->hge->Random_Int(-1, 1);
+			}
+
+			referenceExplore(area, gridX, gridY, expected);
+			saveManager->explore(gridX, gridY);
+
+			actual.clear();
+			for (int i = 0; i < saveManager->getNumNewlyExplored(); i++) {
+				actual.push_back(saveManager->getNewlyExplored(i));
+			}
+			std::sort(expected.begin(), expected.end(), compareTiles);
+			std::sort(actual.begin(), actual.end(), compareTiles);
+
+			bool same = expected.size() == actual.size();
+			for (int i = 0; same && i < (int)expected.size(); i++) {
+				same = expected[i].gridX == actual[i].gridX && expected[i].gridY == actual[i].gridY;
+			}
+			check(same, "area %d step %d at (%d,%d): %d squares newly explored, expected %d",
+				area, step, gridX, gridY, actual.size(), expected.size());
+			check(saveManager->getNumExplored(area) == referenceNumExplored[area], "area %d step %d: %d squares explored, expected %d",
+				area, step, saveManager->getNumExplored(area), referenceNumExplored[area]);
+		}
+
+		for (int i = 0; i < 256; i++) {
+			for (int j = 0; j < 256; j++) {
+				check(saveManager->isExplored(i, j) == referenceExplored[area][i][j], "area %d square (%d,%d) differs", area, i, j);
+			}
+		}
+	}
+
+	//Round trip through a save file. The slot and the file summaries are put back afterwards.
+	backUpFile("Data/Save/save4.sav");
+	backUpFile("Data/Save/info.dat");
+
+	saveManager->currentSave = SELF_TEST_SAVE_SLOT;
+	saveManager->save();
+	saveManager->resetCurrentData();
+	saveManager->load(SELF_TEST_SAVE_SLOT);
+
+	for (int area = 0; area < NUM_AREAS; area++) {
+		saveManager->currentArea = area;
+		check(saveManager->getNumExplored(area) == referenceNumExplored[area], "area %d: %d squares explored after loading, expected %d",
+			area, saveManager->getNumExplored(area), referenceNumExplored[area]);
+		for (int i = 0; i < 256; i++) {
+			for (int j = 0; j < 256; j++) {
+				check(saveManager->isExplored(i, j) == referenceExplored[area][i][j], "area %d square (%d,%d) differs after loading", area, i, j);
+			}
+		}
+	}
+
+	restoreFile("Data/Save/save4.sav");
+	restoreFile("Data/Save/info.dat");
+	saveManager->loadFileInfo();
+	saveManager->resetCurrentData();
+
+	smh->logger->write(LogLevels::Info, LogCategories::Engine, "Self test: %s, %d areas walked, %d failures",
+		currentTest, NUM_AREAS, numTestFailures);
+
+}
+
+//////////// Text Layout ////////////////
+
+struct ReferenceGlyph {
+	float x1, y1;
+	hgeSprite *letter;
+};
+
+/**
+ * Where the old per-frame hgeFont::printfb put each letter of some text in a box
+ * at (0,0): its word wrapping followed by hgeFont::Render.
+ */
+static void referencePrintfb(hgeFont *font, float w, float h, int align, const char *text, std::vector<ReferenceGlyph> &glyphs) {
+
+	char buffer[1024];
+	strncpy(buffer, text, sizeof(buffer) - 1);
+	buffer[sizeof(buffer) - 1] = '\0';
+
+	char chr, *pbuf, *prevword, *linestart;
+	int i, lines = 0;
+
+	linestart = buffer;
+	pbuf = buffer;
+	prevword = 0;
+	for (;;) {
+		i = 0;
+		while (pbuf[i] && pbuf[i] != ' ' && pbuf[i] != '\n') i++;
+		chr = pbuf[i];
+		pbuf[i] = 0;
+		float ww = font->GetStringWidth(linestart);
+		pbuf[i] = chr;
+		if (ww > w) {
+			if (pbuf == linestart) {
+				pbuf[i] = '\n';
+				linestart = &pbuf[i+1];
+			} else {
+				*prevword = '\n';
+				linestart = prevword + 1;
+			}
+			lines++;
+		}
+		if (pbuf[i] == '\n') {
+			prevword = &pbuf[i];
+			linestart = &pbuf[i+1];
+			pbuf = &pbuf[i+1];
+			lines++;
+			continue;
+		}
+		if (!pbuf[i]) {
+			lines++;
+			break;
+		}
+		prevword = &pbuf[i];
+		pbuf = &pbuf[i+1];
+	}
+
+	float x = 0.0, y = 0.0;
+	float hh = font->GetHeight() * font->GetSpacing() * font->GetScale() * lines;
+	if ((align & HGETEXT_HORZMASK) == HGETEXT_RIGHT) x += w;
+	if ((align & HGETEXT_HORZMASK) == HGETEXT_CENTER) x += int(w/2);
+	if ((align & HGETEXT_VERTMASK) == HGETEXT_BOTTOM) y += h - hh;
+	if ((align & HGETEXT_VERTMASK) == HGETEXT_MIDDLE) y += int((h - hh)/2);
+
+	align &= HGETEXT_HORZMASK;
+	float hscale = font->GetScale() * font->GetProportion();
+	float vscale = font->GetScale();
+	const char *string = buffer;
+	float fx = x;
+	if (align == HGETEXT_RIGHT) fx -= font->GetStringWidth(string, false);
+	if (align == HGETEXT_CENTER) fx -= int(font->GetStringWidth(string, false)/2.0f);
+
+	glyphs.clear();
+	while (*string) {
+		if (*string == '\n') {
+			y += int(font->GetHeight() * font->GetScale() * font->GetSpacing());
+			fx = x;
+			if (align == HGETEXT_RIGHT) fx -= font->GetStringWidth(string+1, false);
+			if (align == HGETEXT_CENTER) fx -= int(font->GetStringWidth(string+1, false)/2.0f);
+		} else {
+			char c = *string;
+			if (!font->GetSprite(c)) c = '?';
+			hgeSprite *letter = font->GetSprite(c);
+			if (letter) {
+				fx += font->GetPreWidth(c) * hscale;
+				float hotX, hotY;
+				letter->GetHotSpot(&hotX, &hotY);
+				ReferenceGlyph glyph;
+				glyph.x1 = fx - hotX * hscale;
+				glyph.y1 = y - hotY * vscale;
+				glyph.letter = letter;
+				glyphs.push_back(glyph);
+				fx += (letter->GetWidth() + font->GetPostWidth(c) + font->GetTracking()) * hscale;
+			}
+		}
+		string++;
+	}
+
+}
+
+/**
+ * Lays out every string in GameText.dat in each text box font and alignment and
+ * checks the cached glyphs are where the old per-frame printfb put them, before
+ * and after the cache has been cycled through. Also checks that each page of
+ * dialogue looked up by handle is the same text as looking it up by name.
+ */
+void SelfTest::testTextLayout() {
+
+	currentTest = "Text layout";
+	numTestFailures = 0;
+
+	//GameData can't list its keys so they are read from the file
+	std::vector<std::string> keys;
+	FILE *file = fopen("Data/GameText.dat", "r");
+	check(file != NULL, "couldn't open Data/GameText.dat");
+	if (file) {
+		char line[2048];
+		while (fgets(line, sizeof(line), file)) {
+			char *equals = strstr(line, " = \"");
+			if (!equals || line[0] == ';' || line[0] == '[') continue;
+			keys.push_back(std::string(line, equals - line));
+		}
+		fclose(file);
+	}
+
+	static const char *fonts[2] = { "textBoxDialogFnt", "textBoxFnt" };
+	static const int aligns[3] = { HGETEXT_LEFT, HGETEXT_CENTER | HGETEXT_MIDDLE, HGETEXT_RIGHT | HGETEXT_BOTTOM };
+
+	//Twice over so the second pass has to lay out strings again after they were pushed out of the cache
+	std::vector<ReferenceGlyph> expected;
+	int numLayouts = 0;
+	for (int pass = 0; pass < 2; pass++) {
+		for (int k = 0; k < (int)keys.size(); k++) {
+			const char *text = smh->gameData->getGameText(keys[k].c_str());
+			if (!text) continue;
+			for (int f = 0; f < 2; f++) {
+				hgeFont *font = smh->resources->GetFont(fonts[f]);
+				for (int a = 0; a < 3; a++) {
+					referencePrintfb(font, 360, 205, aligns[a], text, expected);
+					TextLayout *layout = smh->textLayoutCache->getLayout(font, 360, 205, aligns[a], text);
+					numLayouts++;
+
+					bool same = layout->glyphs.size() == expected.size();
+					for (int i = 0; same && i < (int)expected.size(); i++) {
+						same = fabs(layout->glyphs[i].x1 - expected[i].x1) < GLYPH_TOLERANCE &&
+							fabs(layout->glyphs[i].y1 - expected[i].y1) < GLYPH_TOLERANCE &&
+							layout->texture == expected[i].letter->GetTexture();
+					}
+					check(same, "%s in %s aligned %d: %d glyphs, expected %d or they are in different places",
+						keys[k].c_str(), fonts[f], aligns[a], layout->glyphs.size(), expected.size());
+				}
+			}
+		}
+	}
+
+	//Dialogue is looked up by handle now. Every page a text box will open must be the same text.
+	int numPages = 0;
+	for (int k = 0; k < (int)keys.size(); k++) {
+		std::string::size_type suffix = keys[k].rfind("Pages");
+		if (suffix == std::string::npos || suffix + 5 != keys[k].size()) continue;
+		std::string prefix = keys[k].substr(0, suffix);
+		int pages = atoi(smh->gameData->getGameText(keys[k].c_str()));
+		for (int page = 1; page <= pages; page++) {
+			std::string pageKey = prefix + "-" + Util::intToString(page);
+			const char *byName = smh->gameData->getGameText(pageKey.c_str());
+			const char *byHandle = smh->gameData->getGameText(smh->gameData->getGameTextHandle(pageKey.c_str()));
+			check(byName != NULL, "%s is missing", pageKey.c_str());
+			check(byName == byHandle, "%s is different looked up by handle", pageKey.c_str());
+			numPages++;
+		}
+	}
+
+	smh->logger->write(LogLevels::Info, LogCategories::Engine, "Self test: %s, %d layouts, %d pages, %d failures",
+		currentTest, numLayouts, numPages, numTestFailures);
+
+}
+
+//////////// Particle Reset ////////////////
+
+/**
+ * Every manager that takes systems from the particle pool has to give all of
+ * them back when they are killed or the area is reset.
+ */
+void SelfTest::testParticleReset() {
+
+	currentTest = "Particle reset";
+	numTestFailures = 0;
+
+	smh->saveManager->resetCurrentData();
+	smh->environment->loadArea(CASTLE_OF_EVIL, CASTLE_OF_EVIL, false);
+	smh->player->moveTo(0, 0);
+
+	ParticlePool *pool = smh->particlePool;
+	check(pool->getNumReclaimed() == 0, "%d systems were still in use when the previous area was reset", pool->getNumReclaimed());
+	int numLive = pool->getNumLiveSystems();
+
+	//Killing projectiles by type and by circle must release every one of them
+	for (int n = 0; n < PARTICLE_TEST_COUNT; n++) {
+		smh->projectileManager->addProjectile(640.0, 640.0, 0.0, 0.0, 0.0, true, false, PROJECTILE_FIREBALL, false);
+		smh->projectileManager->addProjectile(640.0, 640.0, 0.0, 0.0, 0.0, true, false, PROJECTILE_TUT_LIGHTNING, false);
+	}
+	check(pool->getNumLiveSystems() == numLive + 2 * PARTICLE_TEST_COUNT, "%d live systems after adding projectiles, expected %d",
+		pool->getNumLiveSystems(), numLive + 2 * PARTICLE_TEST_COUNT);
+
+	int numKilled = smh->projectileManager->killProjectiles(PROJECTILE_FIREBALL);
+	check(numKilled == PARTICLE_TEST_COUNT, "killProjectiles killed %d of %d fireballs", numKilled, PARTICLE_TEST_COUNT);
+	numKilled = smh->projectileManager->killProjectilesInCircle(640.0, 640.0, 64.0, PROJECTILE_TUT_LIGHTNING);
+	check(numKilled == PARTICLE_TEST_COUNT, "killProjectilesInCircle killed %d of %d projectiles", numKilled, PARTICLE_TEST_COUNT);
+	check(smh->projectileManager->theProjectiles.empty(), "%d projectiles left after killing them all", (int)smh->projectileManager->theProjectiles.size());
+	check(pool->getNumLiveSystems() == numLive, "%d live systems after killing projectiles, expected %d", pool->getNumLiveSystems(), numLive);
+
+	//Environment particles on the same square are all removed together
+	for (int n = 0; n < PARTICLE_TEST_COUNT; n++) {
+		smh->environment->addParticle("flame", 640.0, 640.0);
+	}
+	smh->environment->removeParticle(10, 10);
+	check(pool->getNumLiveSystems() == numLive, "%d live systems after removing particles, expected %d", pool->getNumLiveSystems(), numLive);
+
+	//Leave one of everything alive for the reset to clean up
+	for (int n = 0; n < PARTICLE_TEST_COUNT; n++) {
+		smh->projectileManager->addProjectile(640.0, 640.0, 0.0, 0.0, 0.0, true, false, PROJECTILE_FIREBALL, false);
+		smh->explosionManager->addExplosion(640.0, 640.0, 0.5, 0.0, 0.0);
+		smh->environment->addParticle("flame", 640.0, 640.0);
+		smh->environment->specialTileManager->addFlame(n, 0);
+	}
+
+	smh->environment->reset();
+
+	check(pool->getNumReclaimed() == 0, "%d systems were still in use when the area was reset", pool->getNumReclaimed());
+	check(pool->getNumLiveSystems() == 0, "%d live systems after the area was reset", pool->getNumLiveSystems());
+	check(smh->projectileManager->theProjectiles.empty(), "%d projectiles left after the area was reset", (int)smh->projectileManager->theProjectiles.size());
+	check(smh->explosionManager->getNumExplosions() == 0, "%d explosions left after the area was reset", smh->explosionManager->getNumExplosions());
+
+	smh->logger->write(LogLevels::Info, LogCategories::Engine, "Self test: %s, %d systems pooled, %d failures",
+		currentTest, pool->getNumPooledSystems(), numTestFailures);
+
+}
+
+//////////// Tile Traits ////////////////
+
+//The comparison chains the trait table replaced
+
+static bool referenceIsCylinderSwitchLeft(int id) {
+	return (id == WHITE_SWITCH_LEFT || id == YELLOW_SWITCH_LEFT || id == GREEN_SWITCH_LEFT ||
+		id == BLUE_SWITCH_LEFT || id == BROWN_SWITCH_LEFT || id == SILVER_SWITCH_LEFT);
+}
+
+static bool referenceIsCylinderSwitchRight(int id) {
+	return (id == WHITE_SWITCH_RIGHT || id == YELLOW_SWITCH_RIGHT || id == GREEN_SWITCH_RIGHT ||
+			id == BLUE_SWITCH_RIGHT || id == BROWN_SWITCH_RIGHT || id == SILVER_SWITCH_RIGHT);
+}
+
+static bool referenceIsCylinderDown(int id) {
+	return (id == WHITE_CYLINDER_DOWN || id == YELLOW_CYLINDER_DOWN || id == GREEN_CYLINDER_DOWN ||
+			id == BLUE_CYLINDER_DOWN || id == BROWN_CYLINDER_DOWN || id == SILVER_CYLINDER_DOWN);
+}
+
+static bool referenceIsCylinderUp(int id) {
+	return (id == WHITE_CYLINDER_UP || id == YELLOW_CYLINDER_UP || id == GREEN_CYLINDER_UP ||
+			id == BLUE_CYLINDER_UP|| id == BROWN_CYLINDER_UP || id == SILVER_CYLINDER_UP);
+}
+
+static bool referenceIsArrowPad(int id) {
+	return (id == UP_ARROW || id == RIGHT_ARROW || id == DOWN_ARROW || id == LEFT_ARROW);
+}
+
+static bool referenceIsTileForGayFix(int id) {
+	return (referenceIsArrowPad(id) || id == SPRING_PAD || id == ICE || id == SUPER_SPRING || id == PIT);
+}
+
+static bool referenceIsWarp(int id) {
+	return (id == BLUE_WARP || id == RED_WARP || id == GREEN_WARP || id == YELLOW_WARP);
+}
+
+static bool referenceIsPit(int id) {
+	return id == PIT || id == FAKE_PIT || id == NO_WALK_PIT;
+}
+
+static bool referenceIsLava(int id) {
+	return id == WALK_LAVA || id == NO_WALK_LAVA;
+}
+
+static bool referenceIsDeepWater(int id) {
+	return (id == DEEP_WATER || id == GREEN_WATER);
+}
+
+static bool referenceShouldDrawCollision(int collision) {
+	return collision != WALKABLE && 
+		   collision != UNWALKABLE && 
+		   collision != ENEMY_NO_WALK && 
+		   collision != PLAYER_START && 
+		   collision != DIZZY_MUSHROOM_1 && 
+		   collision != DIZZY_MUSHROOM_2 &&
+		   collision != PLAYER_END && 
+		   collision != PIT && 
+		   collision != UNWALKABLE_PROJECTILE && 
+		   collision != FAKE_PIT &&
+		   collision != FLAME && 
+		   collision != NO_WALK_PIT &&
+		   collision != FIRE_DESTROY && 
+		   collision != FAKE_COLLISION && 
+		   collision != FOUNTAIN && 
+		   !referenceIsWarp(collision);
+}
+
+/**
+ * Whether the old draw chain had its own case for the tile instead of falling
+ * through to the plain walk layer frame.
+ */
+static bool referenceIsAnimated(int id) {
+	return id == SHALLOW_WATER || id == DEEP_WATER || id == NO_WALK_WATER || id == WALK_LAVA || id == NO_WALK_LAVA ||
+		id == GREEN_WATER || id == SHALLOW_GREEN_WATER || id == SPRING_PAD || id == SUPER_SPRING ||
+		referenceIsCylinderSwitchLeft(id) || referenceIsCylinderSwitchRight(id) ||
+		id == SPIN_ARROW_SWITCH || id == MIRROR_SWITCH || id == SHRINK_TUNNEL_SWITCH ||
+		referenceIsCylinderDown(id) || referenceIsCylinderUp(id) ||
+		id == SAVE_SHRINE || id == EVIL_WALL_POSITION || id == EVIL_WALL_RESTART;
+}
+
+static bool referenceIsReturnSpot(int id) {
+	return (id == WALKABLE || id == SHALLOW_WATER || id == WALK_LAVA ||
+			id == RED_WARP || id == BLUE_WARP || id == YELLOW_WARP || id == GREEN_WARP ||
+			id == SHALLOW_GREEN_WATER || id == BOMB_PAD_UP || id == BOMB_PAD_DOWN ||
+			id == HOVER_PAD || id == SUPER_SPRING || id == SMILELET ||
+			id == SMILELET_FLOWER_HAPPY || id == FAKE_COLLISION || id == PLAYER_START ||
+			(id >= WHITE_CYLINDER_DOWN && id <= SILVER_CYLINDER_DOWN) ||
+			(id >= EVIL_WALL_POSITION && id <= EVIL_WALL_RESTART));
+}
+
+static void referenceProjectileCanPass(bool canPass[256]) {
+	for (int i = 0; i < 256; i++) canPass[i] = !referenceIsCylinderUp(i);
+	canPass[UNWALKABLE] = false;
+	canPass[SIGN] = false;
+	canPass[FOUNTAIN] = false;
+	canPass[SAVE_SHRINE] = false;
+	canPass[RED_KEYHOLE] = false;
+	canPass[YELLOW_KEYHOLE] = false;
+	canPass[GREEN_KEYHOLE] = false;
+	canPass[BLUE_KEYHOLE] = false;
+	canPass[EVIL_DOOR] = false;
+	canPass[BOMBABLE_WALL] = false;
+	canPass[FIRE_DESTROY] = false;
+	canPass[FLAME] = false;
+}
+
+/**
+ * Asks the trait table and the collision masks about every collision id and
+ * compares the answers with the old comparison chains and bool arrays.
+ */
+void SelfTest::testTileTraits() {
+
+	currentTest = "Tile traits";
+	numTestFailures = 0;
+
+	for (int id = 0; id < 256; id++) {
+		check(Util::isCylinderSwitchLeft(id) == referenceIsCylinderSwitchLeft(id), "isCylinderSwitchLeft(%d)", id);
+		check(Util::isCylinderSwitchRight(id) == referenceIsCylinderSwitchRight(id), "isCylinderSwitchRight(%d)", id);
+		check(Util::isCylinderDown(id) == referenceIsCylinderDown(id), "isCylinderDown(%d)", id);
+		check(Util::isCylinderUp(id) == referenceIsCylinderUp(id), "isCylinderUp(%d)", id);
+		check(Util::isArrowPad(id) == referenceIsArrowPad(id), "isArrowPad(%d)", id);
+		check(Util::isTileForGayFix(id) == referenceIsTileForGayFix(id), "isTileForGayFix(%d)", id);
+		check(Util::isWarp(id) == referenceIsWarp(id), "isWarp(%d)", id);
+		check(TileTraits::has(id, TileTraits::Pit) == referenceIsPit(id), "Pit trait of %d", id);
+		check(TileTraits::has(id, TileTraits::Lava) == referenceIsLava(id), "Lava trait of %d", id);
+		check(TileTraits::has(id, TileTraits::DeepWater) == referenceIsDeepWater(id), "DeepWater trait of %d", id);
+		check(smh->environment->shouldEnvironmentDrawCollision(id) == referenceShouldDrawCollision(id), "shouldEnvironmentDrawCollision(%d)", id);
+		check(TileTraits::has(id, TileTraits::ReturnSpot) == referenceIsReturnSpot(id), "ReturnSpot trait of %d", id);
+
+		//Environment::draw only skips the animated chain for tiles the chain had no case for
+		if (referenceShouldDrawCollision(id) && !referenceIsPit(id)) {
+			check(TileTraits::has(id, TileTraits::Animated) == referenceIsAnimated(id), "Animated trait of %d", id);
+		}
+	}
+
+	//Ids outside the table have no traits, like the chains
+	check(!TileTraits::has(-1, TileTraits::Pit | TileTraits::DrawsCollision), "id -1 has traits");
+	check(!TileTraits::has(256, TileTraits::Pit | TileTraits::DrawsCollision), "id 256 has traits");
+
+	bool referenceCanPass[256];
+	referenceProjectileCanPass(referenceCanPass);
+	for (int id = 0; id < 256; id++) {
+		check(smh->projectileManager->canPass[id] == referenceCanPass[id], "projectile canPass[%d]", id);
+	}
+
+	//Masks must hold exactly what a bool array would after the same sets
+	smh->hge->Random_Seed(SELF_TEST_SEED);
+	for (int pattern = 0; pattern < MASK_TEST_PATTERNS; pattern++) {
+		CollisionMask mask;
+		bool start = pattern % 2 == 1;
+		mask.setAll(start);
+		for (int id = 0; id < 256; id++) referenceCanPass[id] = start;
+		for (int n = 0; n < 64; n++) {
+			int id = smh->hge->Random_Int(0, 255);
+			bool pass = smh->hge->Random_Int(0, 1) == 1;
+			mask.set(id, pass);
+			referenceCanPass[id] = pass;
+		}
+		for (int id = 0; id < 256; id++) {
+			check(mask[id] == referenceCanPass[id], "pattern %d mask[%d]", pattern, id);
+		}
+	}
+
+	smh->logger->write(LogLevels::Info, LogCategories::Engine, "Self test: %s, 256 ids and %d mask patterns, %d failures",
+		currentTest, MASK_TEST_PATTERNS, numTestFailures);
+
+}
+
+//////////// Player Movement ////////////////
+
+struct ReferenceKeys {
+	bool onlyUpPressed, onlyDownPressed, onlyLeftPressed, onlyRightPressed;
+};
+
+/**
+ * Environment::playerCollision as it was before the movement snapshot, with the
+ * keys passed in instead of polled.
+ */
+static bool referencePlayerCollision(hgeRect *collisionBox, const ReferenceKeys &keys, int x, int y, float dt) {
+
+	Environment *environment = smh->environment;
+	Player *player = smh->player;
+
+	int gridX = x / 64;
+	int gridY = y / 64;
+
+	bool onIce = environment->collision(player->gridX, player->gridY) == ICE;
+
+	for (int i = gridX - 2; i <= gridX + 2; i++) {
+		for (int j = gridY - 2; j <= gridY + 2; j++) {
+
+			bool canPass;
+			if (environment->collision(i, j) == SHRINK_TUNNEL_HORIZONTAL) {
+				canPass = player->isShrunk() && j == player->gridY;
+			} else if (environment->collision(i, j) == SHRINK_TUNNEL_VERTICAL) {
+				canPass = player->isShrunk() && i == player->gridX;
+			} else {
+				canPass = player->canPass(environment->collision(i, j));
+			}
+
+			if (!environment->isInBounds(i,j) || canPass) continue;
+
+			environment->setTerrainCollisionBox(collisionBox, environment->collision(i, j), i, j);
+
+			if (x > collisionBox->x1 && x < collisionBox->x2) {
+				if (abs(collisionBox->y2 - y) < player->radius) return true;
+				if (abs(collisionBox->y1 - y) < player->radius) return true;
+			}
+			if (y > collisionBox->y1 && y < collisionBox->y2) {
+				if (abs(collisionBox->x2 - x) < player->radius) return true;
+				if (abs(collisionBox->x1 - x) < player->radius) return true;
+			}
+			if (Util::distance(collisionBox->x1+(collisionBox->x2 - collisionBox->x1)/2.0, collisionBox->y1 + (collisionBox->y2 - collisionBox->y1)/2.0, x, y) < player->radius) return true;
+
+			float angle;
+
+			if (Util::distance(collisionBox->x1, collisionBox->y1, x, y) < player->radius) {
+				if (player->isOnIce()) return true;
+				angle = Util::getAngleBetween(collisionBox->x1, collisionBox->y1, player->x, player->y);
+				if (keys.onlyDownPressed && player->facing == DOWN && x < collisionBox->x1 && player->canPass(environment->collision(i-1, j)) && !environment->hasSillyPad(i-1,j) && !onIce) {
+					angle -= 4.0 * PI * dt;
+				} else if (keys.onlyRightPressed && player->facing == RIGHT && y < collisionBox->y1 && player->canPass(environment->collision(i, j-1)) && !environment->hasSillyPad(i,j-1) && !onIce) {
+					angle += 4.0 * PI * dt;
+				} else return true;
+				player->x = collisionBox->x1 + (player->radius+1) * cos(angle);
+				player->y = collisionBox->y1 + (player->radius+1) * sin(angle);
+				return true;
+			}
+
+			if (Util::distance(collisionBox->x2, collisionBox->y1, x, y) < player->radius) {
+				if (player->isOnIce()) return true;
+				angle = Util::getAngleBetween(collisionBox->x2, collisionBox->y1, player->x, player->y);
+				if (keys.onlyDownPressed && player->facing == DOWN && x > collisionBox->x2 && player->canPass(environment->collision(i+1, j)) && !environment->hasSillyPad(i+1,j) && !onIce) {
+					angle += 4.0 * PI * dt;
+				} else if (keys.onlyLeftPressed && player->facing == LEFT && y < collisionBox->y1 && player->canPass(environment->collision(i, j-1)) && !environment->hasSillyPad(i,j-1) && !onIce) {
+					angle -= 4.0 * PI * dt;
+				} else return true;
+				player->x = collisionBox->x2 + (player->radius+1) * cos(angle);
+				player->y = collisionBox->y1 + (player->radius+1) * sin(angle);
+				return true;
+			}
+
+			if (Util::distance(collisionBox->x2, collisionBox->y2, x, y) < player->radius) {
+				if (player->isOnIce()) return true;
+				angle = Util::getAngleBetween(collisionBox->x2, collisionBox->y2, player->x, player->y);
+				if (keys.onlyUpPressed && player->facing == UP && x > collisionBox->x2 && player->canPass(environment->collision(i+1, j)) && !environment->hasSillyPad(i+1,j) && !onIce) {
+					angle -= 4.0 * PI * dt;
+				} else if (keys.onlyLeftPressed && player->facing == LEFT && y > collisionBox->y2 && player->canPass(environment->collision(i, j+1)) && !environment->hasSillyPad(i,j+1) && !onIce) {
+					angle += 4.0 * PI * dt;
+				} else return true;
+				player->x = collisionBox->x2 + (player->radius+1) * cos(angle);
+				player->y = collisionBox->y2 + (player->radius+1) * sin(angle);
+				return true;
+			}
+
+			if (Util::distance(collisionBox->x1, collisionBox->y2, x, y) < player->radius) {
+				if (player->isOnIce()) return true;
+				angle = Util::getAngleBetween(collisionBox->x1, collisionBox->y2, player->x, player->y);
+				if (keys.onlyUpPressed && player->facing == UP && x < collisionBox->x1 && player->canPass(environment->collision(i-1, j)) && !environment->hasSillyPad(i-1,j) && !onIce) {
+					angle += 4.0 * PI * dt;
+				} else if (keys.onlyRightPressed && player->facing == RIGHT && y > collisionBox->y2 && player->canPass(environment->collision(i, j+1)) && !environment->hasSillyPad(i, j+1) && !onIce) {
+					angle -= 4.0 * PI * dt;
+				} else return true;
+				player->x = collisionBox->x1 + (player->radius+1) * cos(angle);
+				player->y = collisionBox->y2 + (player->radius+1) * sin(angle);
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+/**
+ * Walks Smiley around every area with random keys held, resolving each move with
+ * the snapshot and with the old per-call search from the same position. Both have
+ * to agree on whether he was blocked and on where corner rounding put him, and the
+ * walk carries on from where the snapshot left him.
+ */
+void SelfTest::testPlayerMovement() {
+
+	currentTest = "Player movement";
+	numTestFailures = 0;
+
+	Player *player = smh->player;
+	Environment *environment = smh->environment;
+	hgeRect *collisionBox = new hgeRect();
+	smh->saveManager->resetCurrentData();
+	smh->hge->Random_Seed(SELF_TEST_SEED);
+
+	int numMoves = 0;
+	for (int area = 0; area < NUM_AREAS; area++) {
+
+		environment->loadArea(area, area, false);
+		int width = environment->areaWidth;
+		int height = environment->areaHeight;
+
+		bool up = false, down = false, left = false, right = false;
+		for (int frame = 0; frame < MOVEMENT_TEST_FRAMES; frame++) {
+
+			//Jump somewhere new now and then, and change the keys every so often
+			if (frame % 120 == 0) {
+				player->moveTo(smh->hge->Random_Int(0, width - 1), smh->hge->Random_Int(0, height - 1));
+			}
+			if (frame % 15 == 0) {
+				int keys = smh->hge->Random_Int(0, 15);
+				up = (keys & 1) != 0;
+				down = (keys & 2) != 0;
+				left = (keys & 4) != 0;
+				right = (keys & 8) != 0;
+				if (right) player->facing = RIGHT;
+				else if (left) player->facing = LEFT;
+				else if (down) player->facing = DOWN;
+				else if (up) player->facing = UP;
+			}
+			player->gridX = Util::getGridX(player->x);
+			player->gridY = Util::getGridY(player->y);
+
+			ReferenceKeys keys;
+			keys.onlyDownPressed = down && !up && !left && !right;
+			keys.onlyUpPressed = !down && up && !left && !right;
+			keys.onlyLeftPressed = !down && !up && left && !right;
+			keys.onlyRightPressed = !down && !up && !left && right;
+
+			float xDist = ((right ? 1.0 : 0.0) - (left ? 1.0 : 0.0)) * MOVEMENT_TEST_SPEED * SELF_TEST_DT;
+			float yDist = ((down ? 1.0 : 0.0) - (up ? 1.0 : 0.0)) * MOVEMENT_TEST_SPEED * SELF_TEST_DT;
+
+			environment->beginPlayerMovement(up, down, left, right);
+
+			//Same two tests Player::doMove makes
+			for (int axis = 0; axis < 2; axis++) {
+				float dist = axis == 0 ? xDist : yDist;
+				if (dist == 0.0) continue;
+
+				float startX = player->x, startY = player->y;
+				int testX = axis == 0 ? (int)(startX + dist) : (int)startX;
+				int testY = axis == 0 ? (int)startY : (int)(startY + dist);
+
+				bool expected = referencePlayerCollision(collisionBox, keys, testX, testY, SELF_TEST_DT);
+				float expectedX = player->x, expectedY = player->y;
+
+				player->x = startX;
+				player->y = startY;
+				bool actual = environment->playerCollision(testX, testY, SELF_TEST_DT);
+
+				check(actual == expected && player->x == expectedX && player->y == expectedY,
+					"area %d frame %d testing (%d,%d): blocked %d at (%f,%f), expected %d at (%f,%f)",
+					area, frame, testX, testY, actual, player->x, player->y, expected, expectedX, expectedY);
+				numMoves++;
+
+				if (!actual) {
+					if (axis == 0) player->x += dist;
+					else player->y += dist;
+				}
+			}
+		}
+	}
+
+	delete collisionBox;
+
+	smh->logger->write(LogLevels::Info, LogCategories::Engine, "Self test: %s, %d moves replayed, %d failures",
+		currentTest, numMoves, numTestFailures);
+
+}
+
+//////////// Enemy Replay ////////////////
+
+static void hashBytes(DWORD *hash, const void *data, int size) {
+	const BYTE *bytes = (const BYTE*)data;
+	for (int i = 0; i < size; i++) {
+		*hash = (*hash ^ bytes[i]) * 16777619;
+	}
+}
+
+/**
+ * Hashes everything the enemy update changes: the enemies, the projectiles and
+ * loot they made, Smiley's health and the effects that were applied.
+ */
+static void hashEnemyState(DWORD *hash) {
+
+	for (std::list<EnemyStruct>::iterator i = smh->enemyManager->enemyList.begin(); i != smh->enemyManager->enemyList.end(); i++) {
+		BaseEnemy *enemy = i->enemy;
+		hashBytes(hash, &enemy->id, sizeof(int));
+		hashBytes(hash, &enemy->x, sizeof(float));
+		hashBytes(hash, &enemy->y, sizeof(float));
+		hashBytes(hash, &enemy->dx, sizeof(float));
+		hashBytes(hash, &enemy->dy, sizeof(float));
+		hashBytes(hash, &enemy->health, sizeof(float));
+		hashBytes(hash, &enemy->facing, sizeof(int));
+	}
+
+	for (std::list<Projectile>::iterator i = smh->projectileManager->theProjectiles.begin(); i != smh->projectileManager->theProjectiles.end(); i++) {
+		hashBytes(hash, &i->id, sizeof(int));
+		hashBytes(hash, &i->x, sizeof(float));
+		hashBytes(hash, &i->y, sizeof(float));
+	}
+
+	int numLoot = (int)smh->lootManager->theLoot.size();
+	hashBytes(hash, &numLoot, sizeof(int));
+
+	float health = smh->player->getHealth();
+	hashBytes(hash, &health, sizeof(float));
+
+	const std::vector<EnemyEffect> &effects = smh->enemyManager->getEffects();
+	for (int i = 0; i < (int)effects.size(); i++) {
+		hashBytes(hash, &effects[i].enemy, sizeof(int));
+		hashBytes(hash, &effects[i].type, sizeof(int));
+		hashBytes(hash, &effects[i].x, sizeof(float));
+		hashBytes(hash, &effects[i].y, sizeof(float));
+		hashBytes(hash, &effects[i].damage, sizeof(float));
+	}
+
+}
+
+/**
+ * Plays the same frames of every area with the enemy update on 1, 2, 4 and 8
+ * workers. The state after every frame has to hash the same as with one
+ * worker. How long the enemy updates took is logged for each.
+ */
+void SelfTest::testEnemyReplay() {
+
+	static const int workerCounts[REPLAY_TEST_RUNS] = { 1, 2, 4, 8 };
+
+	currentTest = "Enemy replay";
+	numTestFailures = 0;
+
+	LARGE_INTEGER frequency, start, end;
+	QueryPerformanceFrequency(&frequency);
+
+	float startingHealth = smh->player->getHealth();
+	DWORD serialHashes[NUM_AREAS];
+	double serialMs = 0.0;
+	int numFrames = 0;
+
+	for (int run = 0; run < REPLAY_TEST_RUNS; run++) {
+
+		smh->enemyManager->setNumWorkers(workerCounts[run]);
+		LONGLONG ticks = 0;
+		numFrames = 0;
+
+		for (int area = 0; area < NUM_AREAS; area++) {
+
+			smh->saveManager->resetCurrentData();
+			smh->setGameTime(0.0);
+			smh->hge->Random_Seed(SELF_TEST_SEED);
+			smh->player->reset();
+			smh->player->setHealth(startingHealth);
+			smh->environment->loadArea(area, area, false);
+
+			DWORD hash = 2166136261;
+			for (int frame = 0; frame < REPLAY_TEST_FRAMES; frame++) {
+				smh->setGameTime(smh->getGameTime() + SELF_TEST_DT);
+
+				QueryPerformanceCounter(&start);
+				smh->enemyManager->update(SELF_TEST_DT);
+				QueryPerformanceCounter(&end);
+				ticks += end.QuadPart - start.QuadPart;
+				numFrames++;
+
+				smh->projectileManager->update(SELF_TEST_DT);
+				hashEnemyState(&hash);
+			}
+
+			if (run == 0) {
+				serialHashes[area] = hash;
+			} else {
+				check(hash == serialHashes[area], "area %d on %d workers hashed to %08x, %08x on 1 worker",
+					area, workerCounts[run], hash, serialHashes[area]);
+			}
+		}
+
+		double ms = (double)ticks * 1000.0 / (double)frequency.QuadPart / numFrames;
+		if (run == 0) serialMs = ms;
+		smh->logger->write(LogLevels::Info, LogCategories::Profiler, "Self test: %s, %d workers, %.3f ms per enemy update, %.2fx",
+			currentTest, workerCounts[run], ms, ms > 0.0 ? serialMs / ms : 0.0);
+	}
+
+	smh->enemyManager->setNumWorkers(0);
+	smh->player->reset();
+	smh->player->setHealth(startingHealth);
+
+	smh->logger->write(LogLevels::Info, LogCategories::Engine, "Self test: %s, %d frames on each of %d worker counts, %d failures",
+		currentTest, numFrames, REPLAY_TEST_RUNS, numTestFailures);
+
+}
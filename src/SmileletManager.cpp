@@ -312,7 +312,7 @@ void SmileletManager::switchToCircleFlower() {
 	timeEnteredState = smh->getGameTime();
 
 	//Make flower happy, so Smiley can pass
-	smh->environment->collision[flowerGridX][flowerGridY] = SMILELET_FLOWER_HAPPY;
+	smh->environment->collision(flowerGridX, flowerGridY) = SMILELET_FLOWER_HAPPY;
 	smh->saveManager->change(flowerGridX, flowerGridY);
 }
 
@@ -1,7 +1,9 @@
 #ifndef SMH_H_
 #define SMH_H_
 
+#ifdef _MANAGED
 #using <mscorlib.dll>
+#endif
 
 #define STRICT
 #define DIRECTINPUT_VERSION 0x0800
@@ -15,11 +17,14 @@
 #include <dinput.h>
 #include "resource.h"
 #include <list>
+#include <vector>
+#include <map>
+#include "SmileyPrimitives.h"
 #include "environment.h"
+#include "AreaArena.h"
 
 class hgeStringTable;
 class HGE;
-class hgeResourceManager;
 class hgeAnimation;
 class hgeFont;
 class Player;
@@ -32,11 +37,13 @@ class EnemyManager;
 class LootManager;
 class FenwarManager;
 class ProjectileManager;
+class PatternEmitter;
 class BossManager;
 class ExplosionManager;
 
 //Classes defined here
 class AreaChanger;
+class AreaLoader;
 class GameData;
 class SMH;
 class SmileyInput;
@@ -48,226 +55,22 @@ class ScreenEffectsManager;
 class DeathEffectManager;
 class Console;
 class PopupMessageManager;
-
-//Constants
-#define PI 3.14159265357989232684
-
-//NPCS
-#define MONOCLE_MAN_NPC_ID 13
-#define MONOCLE_MAN_TEXT_ID 902
-#define SPEIRDYKE_TEXT_ID 5
-#define BILL_CLINTON_TEXT_ID 8
-#define BILL_CLINTON_TEXT_ID2 19
-
-//Difficulty
-#define VERY_EASY 0
-#define EASY 1
-#define MEDIUM 2
-#define HARD 3
-#define VERY_HARD 4
-
-//Gameplay values
-#define NUM_NPCS 99
-#define PLAYER_WIDTH 61
-#define PLAYER_HEIGHT 72
-
-//Resource Groups
-class ResourceGroups
-{
-public:
-	static const int Menu = 10;
-	static const int Credits = 11;
-	static const int Cinematic= 12;
-	static const int WorldMap = 13;
-	static const int Sounds = 14;
-	static const int Phyrebawz = 100;
-	static const int PortlyPenguin = 101;
-	static const int Garmborn = 102;
-	static const int Cornwallis = 103;
-	static const int Mushboom = 104;
-	static const int Calypso = 105;
-	static const int Bartli = 106;
-	static const int KingTut = 107;
-	static const int Lovecraft = 108;
-	static const int Barvinoid = 109;
-	static const int Fenwar = 110;
-};
-
-#define NUM_BOSSES 12
-
-//Special editor IDs
-#define DRAW_AFTER_SMILEY 990
-
-//Abilities
-#define NUM_ABILITIES 12
-#define NO_ABILITY 12
-#define CANE 0
-#define FIRE_BREATH 1
-#define FRISBEE 2
-#define SPRINT_BOOTS 3
-#define LIGHTNING_ORB 4
-#define REFLECTION_SHIELD 5
-#define SILLY_PAD 6
-#define WATER_BOOTS 7
-#define ICE_BREATH 8
-#define SHRINK 9
-#define TUTS_MASK 10
-#define HOVER 11
-
-//Ability types
-#define PASSIVE 0
-#define ACTIVATED 1
-#define HOLD 2
-
-//Level ids
-#define NUM_AREAS 11
-#define FOUNTAIN_AREA 0
-#define OLDE_TOWNE 1
-#define TUTS_TOMB 2
-#define FOREST_OF_FUNGORIA 3
-#define SESSARIA_SNOWPLAINS 4
-#define WORLD_OF_DESPAIR 5
-#define SERPENTINE_PATH 6
-#define CASTLE_OF_EVIL 7
-#define SMOLDER_HOLLOW 8
-#define CONSERVATORY 9
-#define DEBUG_AREA 10
-
-//State
-#define MENU 10
-#define GAME 20
-
-//Directions
-#define NUM_DIRECTIONS 8
-#define DOWN 0
-#define LEFT 1
-#define RIGHT 2
-#define UP 3
-#define UP_LEFT 4
-#define UP_RIGHT 5
-#define DOWN_LEFT 6
-#define DOWN_RIGHT 7
-
-//Item Layer
-#define NUM_ITEMS 9
-#define NONE 0
-#define RED_KEY 1
-#define YELLOW_KEY 2
-#define GREEN_KEY 3
-#define BLUE_KEY 4
-#define SMALL_GEM 5
-#define MEDIUM_GEM 6
-#define LARGE_GEM 7
-#define HEALTH_ITEM 9
-#define MANA_ITEM 8
-
-//Collision Layer
-#define NUM_COLLISION 36
-#define WALKABLE 0
-#define UNWALKABLE 1
-#define RED_KEYHOLE 2
-#define YELLOW_KEYHOLE 3
-#define GREEN_KEYHOLE 4
-#define BLUE_KEYHOLE 5
-#define EVIL_DOOR 6
-#define SHALLOW_WATER 7
-#define DEEP_WATER 8
-#define UP_ARROW 9
-#define RIGHT_ARROW 10
-#define DOWN_ARROW 11
-#define LEFT_ARROW 12
-#define SLIME 13
-#define SPRING_PAD 14
-#define FIRE_DESTROY 15
-#define WALK_LAVA 16
-#define NO_WALK_LAVA 17
-#define UNWALKABLE_PROJECTILE 18
-#define RED_WARP 19
-#define BLUE_WARP 20
-#define YELLOW_WARP 21
-#define GREEN_WARP 22
-#define SPIN_ARROW_SWITCH 23
-#define PIT 24
-#define FOUNTAIN 25
-#define SAVE_SHRINE 26
-#define SIGN 27
-#define ICE 28
-#define MIRROR_UP_LEFT 29
-#define MIRROR_UP_RIGHT 30
-#define MIRROR_DOWN_RIGHT 31
-#define MIRROR_DOWN_LEFT 32
-#define MIRROR_SWITCH 33
-#define ENEMY_NO_WALK 34
-#define GREEN_WATER 35
-#define DIZZY_MUSHROOM_1 36
-#define DIZZY_MUSHROOM_2 37
-#define BOMB_PAD_UP 38
-#define BOMB_PAD_DOWN 39
-#define BOMBABLE_WALL 40
-#define HOVER_PAD 41
-#define WHITE_CYLINDER_DOWN 42
-#define YELLOW_CYLINDER_DOWN 43
-#define GREEN_CYLINDER_DOWN 44
-#define BLUE_CYLINDER_DOWN 45
-#define BROWN_CYLINDER_DOWN 46
-#define SILVER_CYLINDER_DOWN 47
-#define SHRINK_TUNNEL_SWITCH 48
-#define SHRINK_TUNNEL_HORIZONTAL 49
-#define SHRINK_TUNNEL_VERTICAL 50
-#define SHALLOW_GREEN_WATER 51
-#define EVIL_WALL_POSITION 52
-#define EVIL_WALL_TRIGGER 53
-#define EVIL_WALL_DEACTIVATOR 54
-#define EVIL_WALL_RESTART 55
-#define FLAME 56
-#define SUPER_SPRING 57
-#define WHITE_CYLINDER_UP 58
-#define YELLOW_CYLINDER_UP 59
-#define GREEN_CYLINDER_UP 60
-#define BLUE_CYLINDER_UP 61
-#define BROWN_CYLINDER_UP 62
-#define SILVER_CYLINDER_UP 63
-#define SMILELET 64
-#define SMILELET_FLOWER_SAD 65
-#define SMILELET_FLOWER_HAPPY 66
-#define NO_WALK_PIT 67
-#define FAKE_PIT 68
-#define NO_WALK_WATER 69
-#define FAKE_COLLISION 70
-#define WALK_BOMB_SPEED_PAD 71
-//...
-#define WHITE_SWITCH_LEFT 74
-#define YELLOW_SWITCH_LEFT 75
-#define GREEN_SWITCH_LEFT 76
-#define BLUE_SWITCH_LEFT 77
-#define BROWN_SWITCH_LEFT 78
-#define SILVER_SWITCH_LEFT 79
-//...
-#define WHITE_SWITCH_RIGHT 90
-#define YELLOW_SWITCH_RIGHT 91
-#define GREEN_SWITCH_RIGHT 92
-#define BLUE_SWITCH_RIGHT 93
-#define BROWN_SWITCH_RIGHT 94
-#define SILVER_SWITCH_RIGHT 95
-//...
-#define PLAYER_START 224
-#define PLAYER_END 225
-
-//Colors
-class Colors
-{
-public:
-	static const int Colors::RED = 0;
-	static const int YELLOW = 1;
-	static const int GREEN = 2;
-	static const int BLUE = 3;
-	static const int BLACK = 4;
-	static const int WHITE = 5;
-};
-
-struct Point {
-	int x, y;
-};
+class FrameProfiler;
+class Logger;
+class MeshWave;
+class TextLayoutCache;
+class ParticlePool;
+class ResourceStreamer;
+class StartupTasks;
+class StartupTimeline;
+class ResourceManifest;
+class AssetPacks;
+class SpriteBatch;
+class WorkerPool;
+class BossBenchmark;
+class MicroBenchmark;
+class SelfTest;
+class hgeParticleSystem;
 
 //----------------------------------------------------------------
 //------------------SMH-------------------------------------------
@@ -308,6 +111,7 @@ public:
 	void drawSprite(const char* sprite, float x, float y, float width, float height);
 	int getScreenX(int x);
 	int getScreenY(int y);
+	bool isOnScreen(float x, float y, float width, float height);
 	void log(const char* text);
 	int randomInt(int min, int max);
 	float randomFloat(float min, float max);
@@ -321,6 +125,8 @@ public:
 	//Game objects
 	Console *console;
 	AreaChanger *areaChanger;
+	AreaArena *areaArena;
+	AreaLoader *areaLoader;
 	BossManager *bossManager;
 	EnemyGroupManager *enemyGroupManager;
 	EnemyManager *enemyManager;
@@ -334,7 +140,9 @@ public:
 	NPCManager *npcManager;
 	Player *player;
 	ProjectileManager *projectileManager;
-	hgeResourceManager *resources;
+	PatternEmitter *patternEmitter;
+	ResourceManifest *resources;
+	AssetPacks *assetPacks;
 	SaveManager *saveManager;
 	SoundManager *soundManager;
 	WindowManager *windowManager;
@@ -342,11 +150,26 @@ public:
 	ExplosionManager *explosionManager;
 	DeathEffectManager *deathEffectManager;
 	PopupMessageManager *popupMessageManager;
+	FrameProfiler *frameProfiler;
+	TextLayoutCache *textLayoutCache;
+	ParticlePool *particlePool;
+	SpriteBatch *spriteBatch;
+	WorkerPool *workerPool;
+	BossBenchmark *bossBenchmark;
+	MicroBenchmark *microBenchmark;
+	SelfTest *selfTest;
+	ResourceStreamer *resourceStreamer;
+	StartupTasks *startupTasks;
+	Logger *logger;
+
+	void shutdown();
 
 private:
 
 	void doDebugInput(float dt);
 	void drawLoadScreen();
+	void createGameManagers();
+	void updateStartupTasks();
 
 	float gameTime;
 	float timeInState;
@@ -355,8 +178,13 @@ private:
 	bool debugMode;
 	
 	bool initializedYet;
+	bool gameManagersCreated;
 	std::string debugText;
 
+	//Only used until the game managers have been created
+	StartupTimeline *startupTimeline;
+	int enemyDataTask, gameTextTask;
+
 	//Screen color fade stuff
 	void updateScreenColor(float dt);
     int screenColor;
@@ -432,6 +260,8 @@ public:
 	float getMouseY();
 	bool isMouseInWindow();
 	void setMousePosition(float x, float y);
+	void setScripted(bool scripted);
+	void setScriptedInput(int input, bool pressed);
 
 	//Variables
 	InputStruct inputs[NUM_INPUTS];
@@ -439,85 +269,11 @@ public:
 	bool useGamePad;
 	bool acquiredJoystick;
 	bool joystickState[4];
+	bool scripted;
+	bool scriptedPressed[NUM_INPUTS];
 
 };
 
-//----------------------------------------------------------------
-//------------------DATA------------------------------------------
-//----------------------------------------------------------------
-// Provides a centralized location for retrieving all game data.
-//----------------------------------------------------------------
-
-#define MAX_ENEMIES 200
-
-/**
- * Stores info for each enemy id
- */ 
-struct EnemyInfo {
-
-	//For all enemies
-	int gRow, gCol;
-	int enemyType, wanderType, hp, speed, radius, damage, rangedType;
-	bool land, shallowWater, deepWater, slime, lava, mushrooms;
-	bool immuneToFire, immuneToTongue, immuneToLightning, immuneToStun, immuneToFreeze, invincible;
-	int variable1, variable2, variable3;
-	int numFrames;
-	bool hasOneGraphic;
-	bool chases, hasRangedAttack;
-	int range, delay, projectileSpeed;
-	float projectileDamage;
-	float projectileHoming;
-	
-};
-
-struct EnemyName {
-	int id;
-	std::string name;
-};
-
-struct Ability {
-	char name[32];
-	char description[128];
-	int manaCost;
-	int type;
-	float timeLastUsed;
-	float coolDown;
-};
-
-class GameData {
-
-public:
-
-	GameData();
-	~GameData();
-
-	EnemyInfo getEnemyInfo(int enemyID);
-	Ability getAbilityInfo(int abilityID);
-	void setTimeLastUsedAbility(int abilityID, float time);
-	std::list<EnemyName> getEnemyNames();
-	int getNumTotalGemsInArea(int area, int gemType);
-	const char *getGameText(const char *text);
-	const char *getAreaName(int area);
-	float getDifficultyModifier(int difficulty);
-	int getNumEnemies();
-	void refreshAbilityData();
-
-private:
-
-	void loadEnemyData();
-	void addEnemyName(int id, std::string name);
-	void initializeGemCounts();
-
-	hgeStringTable *enemyStringTable;
-	EnemyInfo enemyInfo[MAX_ENEMIES];
-	Ability abilities[16];
-	std::list<EnemyName> enemyNameList;
-	hgeStringTable *gameText;
-	int totalGemCounts[NUM_AREAS][3];
-
-};
-
-
 //----------------------------------------------------------------
 //------------------SAVE MANAGER----------------------------------
 //----------------------------------------------------------------
@@ -539,6 +295,15 @@ public:
 	static const int LargeGemValue = 5;
 };
 
+#define EXPLORED_WORDS 8					//32 bit words per column of exploration bits
+#define EXPLORE_RANGE_X 8					//Squares explored to either side of Smiley
+#define EXPLORE_RANGE_Y 6					//Squares explored above and below Smiley
+#define MAX_NEWLY_EXPLORED ((2*EXPLORE_RANGE_X+1) * (2*EXPLORE_RANGE_Y+1))
+
+struct ExploredTile {
+	int gridX, gridY;
+};
+
 class SaveManager {
 
 public:
@@ -565,6 +330,9 @@ public:
 	bool isBossKilled(int boss);
 	void explore(int gridX, int gridY);
 	bool isExplored(int gridX, int gridY);
+	int getNumNewlyExplored();
+	ExploredTile getNewlyExplored(int index);
+	int getNumExplored(int area);
 	int getTotalGemCount();
 	int getCurrentHint();
 
@@ -593,53 +361,23 @@ public:
 private:
 
 	int calculateCompletionPercentage();
+	bool getExploredBit(int area, int gridX, int gridY);
+	void setExploredBit(int area, int gridX, int gridY, bool value);
+	void countExplored();
 
 	ChangeManager *changeManager;
 
 	SaveFile files[4];
-	bool explored[NUM_AREAS][256][256];
+	DWORD explored[NUM_AREAS][256][EXPLORED_WORDS];	//One bit per square, each column of squares packed into words
+	int numExplored[NUM_AREAS];
+	int lastExploreArea, lastExploreX, lastExploreY;
+	ExploredTile newlyExplored[MAX_NEWLY_EXPLORED];
+	int numNewlyExplored;
 	bool killedBoss[12];
 
 };
 
 
-//----------------------------------------------------------------
-//------------------BIT STREAM------------------------------------
-//----------------------------------------------------------------
-// This class allows you to easily read/write bits and bytes to
-// a file to make up for the mind boggling shortcomings of C++.
-//----------------------------------------------------------------
-#define FILE_READ 0
-#define FILE_WRITE 1
-
-class BitStream {
-
-public:
-	BitStream();
-	~BitStream();
-
-	void open(std::string fileName, int mode);
-	void writeByte(int byte);
-	bool writeBit(bool bit);
-	void writeBits(int data, int numBits);
-	int readByte();
-	bool readBit();
-	int readBits(int numBits);
-	void close();
-	int getNumBitsRead();
-	int getNumBitsWritten();
-	static void test();
-
-private:
-	bool isOpen;
-	int mode, numRead, numWritten;
-	std::ifstream inFile;
-	std::ofstream outFile;
-	std::string outString;
-	unsigned char byte;
-	int counter;
-};
-
 //----------------------------------------------------------------
 //------------------SOUND MANAGER---------------------------------
 //----------------------------------------------------------------
@@ -736,35 +474,415 @@ private:
 };
 
 //----------------------------------------------------------------
-//------------------ CHANGE MANAGER ------------------------------
+//------------------AREA LOADER-----------------------------------
 //----------------------------------------------------------------
-// Used to manage all changes to the game world. Internally, it is
-// a linked list of objects representing a single square in one area
-// that has been changed from its original state. This only supports
-// boolean states at each square.
+// Parses area map files into AreaData. Parsing doesn't touch any
+// game state so it can run on a worker thread: the AreaChanger
+// prefetches the destination area as soon as a transition starts,
+// and areas are speculatively prefetched when Smiley gets near a
+// level exit. Environment::loadArea then only has to swap the
+// parsed data into the game.
 //----------------------------------------------------------------
-struct Change {
-	int x;
-	int y;
+#define NUM_AREA_LAYERS 6
+
+class AreaLayers
+{
+public:
+	static const int Ids = 0;
+	static const int Variable = 1;
+	static const int Terrain = 2;
+	static const int Collision = 3;
+	static const int Item = 4;
+	static const int Enemy = 5;
+};
+
+/**
+ * A non-empty tile of the enemy layer. These are collected while parsing so
+ * that loadArea doesn't have to scan the whole layer for things to spawn.
+ */
+struct AreaSpawn {
+	int gridX, gridY;
+	int enemy;
+};
+
+struct AreaData {
 	int area;
+	int width, height;
+	int *tiles;						//NUM_AREA_LAYERS layers of width*height tiles, row major
+	std::list<AreaSpawn> spawns;	//In the order the original row by row scan found them
+
+	int get(int layer, int gridX, int gridY) {
+		return tiles[(layer * height + gridY) * width + gridX];
+	}
 };
 
-class ChangeManager {
+class AreaLoader {
 
 public:
 
-	ChangeManager();
-	~ChangeManager();
+	AreaLoader();
+	~AreaLoader();
 
-	void change(int area, int x, int y);
-	bool isChanged(int area, int x, int y);
-	void reset();
-	void writeToStream(BitStream *stream);
+	void prefetch(int area);
+	void prefetchExitsNear(int gridX, int gridY);
+	AreaData *takeAreaData(int area);
+	bool wasLastAreaPrefetched();
+	static void deleteAreaData(AreaData *areaData);
+
+	static AreaData *parseArea(int area);
+	static const char *getAreaFileName(int area);
 
 private:
-	std::list<Change> theChanges;
-	void addChange(int area, int x, int y);
-	bool removeChange(int area, int x, int y);
+
+	static DWORD WINAPI workerThreadProc(LPVOID param);
+	void finishWorker();
+
+	HANDLE workerThread;
+	int workerArea;
+	AreaData *workerResult;
+	bool enabled;
+	bool lastAreaPrefetched;
+
+};
+
+//----------------------------------------------------------------
+//------------------ WORKER POOL ---------------------------------
+//----------------------------------------------------------------
+// Runs a batch of jobs on worker threads, with the calling thread
+// working too. Each worker is handed a run of the jobs and takes them
+// from the back; once its own run is used up it steals from the front
+// of another's. run() returns when every job is done. Jobs are run
+// while the main thread waits, so they can read game state freely,
+// but they must only write to their own job's data and must never
+// call into HGE, which isn't thread safe. start() hands a batch to
+// the worker threads alone and returns straight away; those jobs run
+// alongside the main thread, so they may only touch data that nothing
+// else uses until finish() has returned.
+//----------------------------------------------------------------
+#define MAX_POOL_WORKERS 8				//Including the calling thread
+
+typedef void (*PoolJob)(void *context, int job, int worker);
+
+struct PoolQueue {
+	CRITICAL_SECTION lock;
+	int first, last;					//The jobs still to be done are first to last - 1
+};
+
+class WorkerPool;
+
+struct PoolThread {
+	WorkerPool *pool;
+	int worker;
+	HANDLE thread;
+	HANDLE startEvent;
+};
+
+class WorkerPool {
+
+public:
+
+	WorkerPool();
+	~WorkerPool();
+
+	void run(PoolJob job, void *context, int numJobs, int numWorkers);
+	void start(PoolJob job, void *context, int numJobs, int numWorkers);
+	void finish();
+	int getDefaultWorkers();
+	int getNumThreads();
+	int getNumStolen();
+
+private:
+
+	static DWORD WINAPI workerThreadProc(LPVOID param);
+	void work(int worker);
+	bool takeJob(int worker, int *job);
+
+	PoolThread threads[MAX_POOL_WORKERS];	//Slot 0 is the calling thread
+	PoolQueue queues[MAX_POOL_WORKERS];
+	int numThreads;
+	int defaultWorkers;
+	HANDLE doneEvent;
+	volatile bool quitting;
+	bool started;						//A batch from start() hasn't been finished
+
+	//Set up by run() before the workers are started
+	PoolJob job;
+	void *context;
+	int numWorkers;
+	volatile LONG numBusy;
+	volatile LONG numStolen;
+
+};
+
+//----------------------------------------------------------------
+//------------------ BOSS BENCHMARK ------------------------------
+//----------------------------------------------------------------
+// Started with -bossbenchmark instead of the title screen. Fights
+// every boss in turn for a fixed number of frames at a fixed frame
+// time, with a bot playing Smiley: it walks up to the boss, weaves
+// between waypoints around it and keeps using its tongue and
+// abilities. Frames are still drawn, since a lot of particles and
+// animations only move on while they are drawn, and each frame's
+// cost covers both. What each fight cost, including how many times
+// it called new, is written to BossBenchmark.json, and with -compare
+// <file> it is checked against an earlier run. The game exits when
+// it is done.
+//----------------------------------------------------------------
+#define BOSS_BENCHMARK_FILE "BossBenchmark.json"
+#define BOSS_BENCHMARK_DT (1.0f / 60.0f)
+#define DEFAULT_BOSS_BENCHMARK_FRAMES 1800
+#define DEFAULT_BOSS_BENCHMARK_THRESHOLD 10		//Percent worse than the baseline that counts as a regression
+
+struct BossBenchmarkResult {
+	int boss;
+	bool found;
+	int area, gridX, gridY;
+	int frames;
+	double totalMs, maxMs;
+	int peakProjectiles;
+	int peakPatternBullets;
+	int peakParticleSystems;
+	int peakParticles;
+	int peakEnemies;
+	int allocations;
+};
+
+class BossBenchmark {
+
+public:
+
+	BossBenchmark();
+
+	void request(const char *baselineFile);
+	bool isRequested();
+	bool isRunning();
+	void start();
+	bool beginFrame();
+	void endFrame();
+	int getNumRegressions();
+
+private:
+
+	void findArenas();
+	void startNextFight();
+	void finishFight();
+	void driveBot();
+	void writeResults();
+	void compareWithBaseline();
+
+	bool requested;
+	bool running;
+	std::string baselineFile;
+	int framesPerFight;
+	int threshold;
+	int currentFight;
+	int frame;
+	int waypoint;
+	float timeAtWaypoint;
+	int numRegressions;
+	BossBenchmarkResult results[NUM_BOSSES];
+	LARGE_INTEGER frequency, frameStart;
+	LONG allocationsAtStart;
+
+};
+
+//----------------------------------------------------------------
+//------------------ MICRO BENCHMARK -----------------------------
+//----------------------------------------------------------------
+// Started with -microbenchmark instead of the title screen. Times the
+// low level pieces that need a loaded area one at a time - terrain
+// collision, paths and collision lookups on a real area, and enemy
+// A*. Each one gets some warm up runs and then a number of timed
+// samples, and the spread of the samples is written to
+// MicroBenchmark.csv and MicroBenchmark.json. The game exits when it
+// is done. Headless/ times the same cases against a stubbed
+// Environment, along with everything in SmileyPrimitives.h.
+//----------------------------------------------------------------
+#define MICRO_BENCHMARK_CSV_FILE "MicroBenchmark.csv"
+#define MICRO_BENCHMARK_JSON_FILE "MicroBenchmark.json"
+#define DEFAULT_MICRO_BENCHMARK_WARMUP 3
+#define DEFAULT_MICRO_BENCHMARK_SAMPLES 25
+#define MAX_MICRO_BENCHMARK_SAMPLES 1000
+#define DEFAULT_MICRO_BENCHMARK_AREA OLDE_TOWNE
+
+class MicroBenchmarkCases
+{
+public:
+	static const int TestCollision = 0;
+	static const int ValidPath = 1;
+	static const int CollisionAt = 2;
+	static const int AStar = 3;
+};
+
+#define NUM_MICRO_BENCHMARK_CASES 4
+
+struct MicroBenchmarkResult {
+	bool skipped;
+	int samples;
+	double minNs, medianNs, meanNs, stdDevNs, maxNs;	//Per operation
+	int checksum;									//Keeps the work from being optimized away
+};
+
+class MicroBenchmark {
+
+public:
+
+	MicroBenchmark();
+
+	void request();
+	bool isRequested();
+	void run();
+
+private:
+
+	void setUp();
+	void tearDown();
+	int runCase(int benchmarkCase, int operations);
+	void measure(int benchmarkCase);
+	void writeResults();
+
+	bool requested;
+	int warmup;
+	int samples;
+	int area;
+	BaseEnemy *enemy;
+	MicroBenchmarkResult results[NUM_MICRO_BENCHMARK_CASES];
+	LARGE_INTEGER frequency;
+
+};
+
+//----------------------------------------------------------------
+//------------------ SELF TEST -----------------------------------
+//----------------------------------------------------------------
+// Started with -selftest instead of the title screen. Checks that
+// the faster versions of engine systems give the same results as
+// the straightforward code they replaced, by running both on the
+// real game data. Failures are written to the log and the game
+// exits with 1 if there were any.
+//----------------------------------------------------------------
+class SelfTest {
+
+public:
+
+	SelfTest();
+
+	void request();
+	bool isRequested();
+	void run();
+	int getNumFailures();
+
+private:
+
+	void check(bool passed, const char *format, ...);
+	void testEnemyGroups();
+	void testExploration();
+	void testTextLayout();
+	void testParticleReset();
+	void testTileTraits();
+	void testPlayerMovement();
+	void testEnemyReplay();
+
+	bool requested;
+	const char *currentTest;
+	int numChecks;
+	int numFailures;
+	int numTestFailures;
+
+};
+
+//----------------------------------------------------------------
+//------------------ STARTUP TIMELINE ----------------------------
+//----------------------------------------------------------------
+// Times each stage of SMH::init and writes them to the log so that
+// cold start time can be tracked.
+//----------------------------------------------------------------
+struct StartupStage {
+	const char *name;
+	double ms;
+};
+
+class StartupTimeline {
+
+public:
+
+	StartupTimeline();
+
+	void beginStage(const char *name);
+	void endStage();
+	void write();
+
+private:
+
+	std::vector<StartupStage> stages;
+	LARGE_INTEGER frequency, startTime, stageStartTime;
+
+};
+
+//----------------------------------------------------------------
+//------------------ STARTUP TASKS -------------------------------
+//----------------------------------------------------------------
+// The parts of SMH::init that don't need HGE, like parsing the data
+// tables and decoding the packed sounds, as a graph of tasks with
+// explicit dependencies. start() hands them to the worker pool and
+// the main thread carries on creating everything else, calling
+// waitFor() just before it needs a task's result. A task nobody has
+// picked up by then is run on the main thread. Set Debug/startupTasks
+// to 0 to run them all on the main thread for comparison.
+//----------------------------------------------------------------
+#define MAX_STARTUP_TASKS 32
+#define MAX_TASK_DEPENDENCIES 4
+#define STARTUP_DECODE_SLICES 4			//Tasks that Sounds.pak is decoded in
+
+typedef void (*StartupTaskFunction)(void *context, int param);
+
+class StartupTaskStates
+{
+public:
+	static const int Waiting = 0;
+	static const int Running = 1;
+	static const int Done = 2;
+};
+
+struct StartupTask {
+	std::string name;
+	StartupTaskFunction function;
+	void *context;
+	int param;
+	int dependencies[MAX_TASK_DEPENDENCIES];
+	int numDependencies;
+	int state;
+	int worker;						//0 is the main thread
+	HANDLE doneEvent;
+	LARGE_INTEGER startTime, endTime;
+};
+
+class StartupTasks {
+
+public:
+
+	StartupTasks();
+	~StartupTasks();
+
+	int add(std::string name, StartupTaskFunction function, void *context, int param);
+	void addDependency(int task, int dependency);
+	void start();
+	void waitFor(int task);
+	void finish();
+	bool isFinished();
+	void write();
+
+private:
+
+	static void runnerJob(void *context, int job, int worker);
+	int takeReadyTask(bool *noneWaiting);
+	void runTask(int task, int worker);
+
+	StartupTask tasks[MAX_STARTUP_TASKS];
+	int numTasks;
+	bool started;
+	CRITICAL_SECTION lock;
+	LARGE_INTEGER frequency, startTime;
+
 };
 
 //----------------------------------------------------------------
@@ -857,6 +975,16 @@ public:
 private:
 
 	void write (std::string text, int toggled);
+	void drawResourceGroups();
+	void runWarpBenchmark(const int *areas, int numAreas);
+	void runSillyPadBenchmark();
+	void runMeshWaveBenchmark();
+	void runWormBenchmark();
+	void runResourceBenchmark();
+	void runAssetPackBenchmark();
+	void runSpriteBatchBenchmark();
+	void runEnemyThinkBenchmark();
+	void runBulletPatternBenchmark();
 
 	bool active;
 	bool debugMovePressed;
@@ -899,245 +1027,851 @@ private:
 };
 
 //----------------------------------------------------------------
-//------------------ UTIL ----------------------------------------
+//---------------------------- LOGGER ----------------------------
 //----------------------------------------------------------------
-// This class is for static utility functions outside the scope of the
-// Smiley world, such as string conversions and shit.
+// Buffered logger. Messages are formatted on the calling thread
+// into a lock-free queue and written to the log file in batches by
+// a background flusher thread, so logging never blocks gameplay on
+// file I/O. Identical messages that repeat too often are rate
+// limited, and debug messages logged through LOG_DEBUG are compiled out of
+// release builds.
 //----------------------------------------------------------------
-class Util {
+class LogLevels
+{
+public:
+	static const int Debug = 0;
+	static const int Info = 1;
+	static const int Warning = 2;
+	static const int Error = 3;
+};
 
+class LogCategories
+{
 public:
+	static const int General = 0;
+	static const int Engine = 1;
+	static const int Environment = 2;
+	static const int Enemies = 3;
+	static const int Bosses = 4;
+	static const int Player = 5;
+	static const int Save = 6;
+	static const int Resources = 7;
+	static const int Profiler = 8;
+};
 
-	static int roundUp(float num) {
-		if (num > (int)num) return (int)num + 1;
-		else return (int)num;
-	}
+#define NUM_LOG_CATEGORIES 9
+#define LOG_QUEUE_SIZE 1024			//must be a power of 2
+#define LOG_MESSAGE_LENGTH 256
+#define LOG_RATE_TABLE_SIZE 64
+#define LOG_RATE_LIMIT 20			//max identical messages per second
+
+#ifdef _DEBUG
+#define SMH_DEBUG_LOGGING 1
+#else
+#define SMH_DEBUG_LOGGING 0
+#endif
+
+//Usage: LOG_DEBUG(LogCategories::Enemies, "Spawned enemy %d", id); The whole
+//call, including evaluating its arguments, disappears when SMH_DEBUG_LOGGING is 0.
+#define LOG_DEBUG if (!SMH_DEBUG_LOGGING) {} else smh->logger->debug
+
+struct LogMessage {
+	volatile LONG ready;
+	int level;
+	int category;
+	char text[LOG_MESSAGE_LENGTH];
+};
 
-	/**
-	 * Returns the distance between 2 points
-	 */
-	static int distance(int x1, int y1, int x2, int y2) {
-		if (x1 == x2) return abs(y1 - y2);
-		if (y1 == y2) return abs(x1 - x2);
-		return sqrt(float((x2 - x1)*(x2 - x1) + (y2 - y1)*(y2 - y1)));
-	}
+struct LogRateLimit {
+	DWORD hash;
+	DWORD windowStart;
+	volatile LONG count;
+	char sample[64];
+};
 
-	/**
-	* Sets time to a string in the format HH:MM:SS for the specified number of seconds
-	*/ 
-	static std::string getTimeString(int time) {
-
-		std::string timeString;
-
-		char hours[3];
-		char minutes[2];
-		char seconds[2];
-		char temp[2];
-
-		//Get number of hours, minutes, seconds
-		itoa((time - (time % 3600)) / 3600, hours, 10);
-		time -= 3600*atoi(hours);
-		itoa((time - (time % 60)) / 60, minutes, 10);
-		time -= 60*atoi(minutes);
-		itoa(time, seconds, 10);
-
-		if (strlen(minutes) == 1) {
-			strcpy(temp, minutes);
-			strcpy(minutes,"0");
-			strcat(minutes, temp);
-		}
-
-		if (strlen(seconds) == 1) {
-			strcpy(temp, seconds);
-			strcpy(seconds,"0");
-			strcat(seconds, temp);
-		}
-
-		//Build the time string
-		timeString = hours;
-		timeString += ":";
-		timeString += minutes;
-		timeString += ":";
-		timeString += seconds;
-		
-		return timeString;
-	}
+class Logger {
 
-	/**
-	 * Returns the specified integer as a string because the designers of C were too 
-	 * distracted by their beards to write a language that doESNT SUCK ASS FUCK SHIT
-	 */
-	static std::string intToString(int n) {
-		std::string numberString = "";
-		char number[10];
-		itoa(n, number, 10);
-		numberString += number;
-		return numberString;
-	}
+public:
 
-	/**
-	 * Returns the int as a string, with the given number of digits
-	 */
-	static std::string intToString(int number, int digits) {
-		std::string returnString;
-		returnString = intToString(number);
-		while (returnString.size() < digits) {
-			returnString.insert(0,"0");			
-		}
-		return returnString;
-	}
+	Logger(const char *fileName);
+	~Logger();
 
-	/**
-	 * Returns whether or not id is the id of an on cylinder switch
-	 */
-	static bool isCylinderSwitchLeft(int id) {
-		return (id == WHITE_SWITCH_LEFT || id == YELLOW_SWITCH_LEFT || id == GREEN_SWITCH_LEFT ||
-			id == BLUE_SWITCH_LEFT || id == BROWN_SWITCH_LEFT || id == SILVER_SWITCH_LEFT);
-	}
+	void write(int level, int category, const char *format, ...);
+	void debug(int category, const char *format, ...);
+	void flush();
+	void shutdown();
 
-	/**
-	 * Returns whether or not id is the id of an off cylinder switch
-	 */
-	static bool isCylinderSwitchRight(int id) {
-		return (id == WHITE_SWITCH_RIGHT || id == YELLOW_SWITCH_RIGHT || id == GREEN_SWITCH_RIGHT ||
-				id == BLUE_SWITCH_RIGHT || id == BROWN_SWITCH_RIGHT || id == SILVER_SWITCH_RIGHT);
-	}
+private:
 
-	/**
-	 * Returns whether or not id is the id of a down cylinder
-	 */
-	static bool isCylinderDown(int id) {
-		return (id == WHITE_CYLINDER_DOWN || id == YELLOW_CYLINDER_DOWN || id == GREEN_CYLINDER_DOWN ||
-				id == BLUE_CYLINDER_DOWN || id == BROWN_CYLINDER_DOWN || id == SILVER_CYLINDER_DOWN);
-	}
+	static DWORD WINAPI flusherThreadProc(LPVOID param);
+	void log(int level, int category, const char *format, va_list args);
+	void enqueue(int level, int category, const char *text);
+	bool isRateLimited(const char *text);
+	void drain();
+	void writeMessage(int level, int category, const char *text);
+
+	LogMessage *queue;
+	volatile LONG writeIndex;
+	volatile LONG readIndex;
+	volatile LONG numDropped;
+	volatile bool running;
+	HANDLE flusherThread;
+	HANDLE wakeEvent;
+	CRITICAL_SECTION fileLock;
+	FILE *logFile;
+	LogRateLimit rateLimits[LOG_RATE_TABLE_SIZE];
 
-	/**
-	 * Returns whether or not id is the id of an up cylinder
-	 */
-	static bool isCylinderUp(int id) {
-		return (id == WHITE_CYLINDER_UP || id == YELLOW_CYLINDER_UP || id == GREEN_CYLINDER_UP ||
-				id == BLUE_CYLINDER_UP|| id == BROWN_CYLINDER_UP || id == SILVER_CYLINDER_UP);
-	}
+};
 
-	/**
-	 * Returns whether or not id is the id of an arrow pad
-     */ 
-	static bool isArrowPad(int id) {
-		return (id == UP_ARROW || id == RIGHT_ARROW || id == DOWN_ARROW || id == LEFT_ARROW);
-	}
+//----------------------------------------------------------------
+//------------------------ FRAME PROFILER ------------------------
+//----------------------------------------------------------------
+// Keeps a histogram of frame times for the whole session and times
+// each subsystem within a frame. Any frame longer than the hitch
+// budget (Debug/hitchBudgetMs in Smiley.ini) has its subsystem
+// breakdown and the state of the world captured in memory. Captured
+// hitches and the session summary are written to the log at exit so
+// that profiling never does file I/O during gameplay.
+//----------------------------------------------------------------
+class FrameSections
+{
+public:
+	static const int Input = 0;
+	static const int Menu = 1;
+	static const int Windows = 2;
+	static const int AreaChanger = 3;
+	static const int Player = 4;
+	static const int Environment = 5;
+	static const int Bosses = 6;
+	static const int Enemies = 7;
+	static const int Projectiles = 8;
+	static const int OtherUpdate = 9;
+	static const int Draw = 10;
+};
 
-	/**
-	 * Returns whether or not id is one that should use the gay fix
-	 */
-	static bool isTileForGayFix(int id) {
-		return (isArrowPad(id) || id == SPRING_PAD || id == ICE || id == SUPER_SPRING || id == PIT);
-	}
+#define NUM_FRAME_SECTIONS 11
+#define FRAME_HISTOGRAM_BUCKETS 500		//0.5 ms per bucket, the last one catches everything slower
+#define MAX_HITCH_REPORTS 100
 
-	/**
-	 * Returns the grid x coordinate that x appears in
-	 */
-	static int getGridX(int x) {
-		return (x - x%64) / 64;
-	} 
-
-	/**
-	 * Returns the grid y coordinate that y appears in
-	 */
-	static int getGridY(int y) {
-		return (y - y%64) / 64;
-	}
+class FrameProfiler {
 
-	/**
-	 * Returns the angle between (x1,y1) and (x2,y2)
-	 */
-	static float getAngleBetween(int x1, int y1, int x2, int y2) {
+public:
 
-		float angle;
+	FrameProfiler();
+	~FrameProfiler();
 
-		if (x1 == x2) {
-			if (y1 > y2) {
-				angle = 3.0*PI/2.0;
-			} else {
-				angle=PI/2.0;
-			}
-		} else {
-			angle = atan(float(y2-y1)/float(x2-x1));
-			if (x1 - x2 > 0) angle += PI;
-		}
+	void beginFrame();
+	void beginSection(int section);
+	void endSection(int section);
+	void logSummary();
+	void beginTransition();
+	void endTransition(const char *description);
+	float getPercentile(float percentile);
+	float getMaxFrameTime();
+	int getNumHitches();
 
-		return angle;
+private:
 
-	}
+	void recordFrame(float frameMs);
+	void captureHitch(float frameMs);
+	float toMilliseconds(LONGLONG ticks);
 
-	/**
-	 * Normalizes an angle to be between 0 and 2 pi
-	 */
-	static float normalizeAngle(float angle) {
-		while (angle < 0) angle += 2*PI;
-		while (angle > 2*PI) angle -= 2*PI;
-		return angle;
-	}
+	LONGLONG ticksPerSecond;
+	LONGLONG frameStart;
+	LONGLONG sectionStart[NUM_FRAME_SECTIONS];
+	LONGLONG sectionTicks[NUM_FRAME_SECTIONS];
+	bool frameStarted;
 
-	/**
-	 * Returns whether or not a normalized angle is between two normalized angles
-	 */
-	static bool isAngleBetween(float testAngle, float minAngle, float maxAngle) {
-		if (minAngle < maxAngle) { //easy case -- the angles do not span over 0
-			return (testAngle >= minAngle && testAngle <= maxAngle);	
-		} else if (minAngle == maxAngle) { //the only way it can be between is if it's equal
-			return (testAngle == maxAngle);
-		} else if (minAngle > maxAngle) { //in this case, 0 is between the min and the max. So if test angle is < max or > min then it's between
-			return (testAngle > minAngle || testAngle < maxAngle);
-		}
-
-		return false;
-	}
+	float hitchBudget;
+	int histogram[FRAME_HISTOGRAM_BUCKETS];
+	int numFrames;
+	int numHitches;
+	float maxFrameTime;
+	double totalFrameTime;
+	std::list<std::string> hitchReports;
 
-	/**
-	 * Returns which way (CW or CCW) to rotate
-	 */
-	static int rotateLeftOrRightForMinimumRotation(float from, float to) {
-		float angleDifference = from-to;
-		while (angleDifference < 0) angleDifference += 2*PI;
-		while (angleDifference > 2*PI) angleDifference -= 2*PI;
-		if (angleDifference > PI) return 1;
-		return -1;
-	}
+	bool inTransition;
+	float maxTransitionFrameTime;
 
-	/**
-	 * Returns whether or not a collision layer id is a warp.
-	 */
-	static bool isWarp(int id) {
-		return (id == BLUE_WARP || id == RED_WARP || id == GREEN_WARP || id == YELLOW_WARP);
-	}
+};
 
-	/**
-	 * Returns the parent area of the given area. Only the 5 parent areas have keys, so this method
-	 * is used to determine which of these 5 areas to save the key to!! The number returned is the
-	 * [area] index of SaveManager.numKeys[area][key color] for the parent area.
-	 */
-	static int getKeyIndex(int area) 
-	{
-		switch (area) 
-		{
-			case OLDE_TOWNE:
-				return 0;
-				break;
-			case FOREST_OF_FUNGORIA:
-				return 1;
-				break;
-			case SESSARIA_SNOWPLAINS:
-				return 2;
-				break;
-			case WORLD_OF_DESPAIR:
-				return 3;
-				break;
-			case CASTLE_OF_EVIL:
-				return 4;
-				break;
-		}
-		return -1;
-	}
+//----------------------------------------------------------------
+//------------------------ MESH WAVE -----------------------------
+//----------------------------------------------------------------
+// Animates distortion mesh nodes with waves of the form
+//   dx = a * cos(dxSpeed * time + phase)
+//   dy = b * sin(dySpeed * time + phase)
+// The phase of each node is baked into a table so each update only
+// needs one cos and sin per axis. One wave can be applied to any number
+// of meshes of the same size.
+//----------------------------------------------------------------
+class MeshWave {
+
+public:
+
+	MeshWave(int columns, int rows, float dxSpeed, float dySpeed);
+	~MeshWave();
+
+	void setNode(int column, int row, float dxPhase, float dxAmplitude, float dyPhase, float dyAmplitude);
+	void update(float time);
+	void apply(hgeDistortionMesh *mesh);
+
+private:
+
+	int columns, rows;
+	float dxSpeed, dySpeed;
+	float lastTime;
+	bool *animated;			//Nodes that setNode was called for. The rest are left alone.
+	float *dxCos, *dxSin;	//Amplitude * cos/sin of each node's phase
+	float *dyCos, *dySin;
+	float *dx, *dy;
+
+};
+
+//----------------------------------------------------------------
+//---------------------- TEXT LAYOUT CACHE -----------------------
+//----------------------------------------------------------------
+// Remembers how strings were laid out by a font so that text which
+// is drawn every frame, like dialogue, isn't word wrapped and
+// measured again each time. Each layout is kept as a list of glyph
+// quads relative to the top left of its box which are sent straight
+// to HGE, so a whole string goes out as one batch.
+//----------------------------------------------------------------
+#define TEXT_LAYOUT_CACHE_SIZE 128
+#define TEXT_LAYOUT_NO_WRAP -1.0
+
+struct TextGlyph {
+	float x1, y1, x2, y2;
+	float u1, v1, u2, v2;
+};
+
+struct TextLayout {
+	hgeFont *font;
+	std::string text;
+	float width, height;		//Size of the box, or TEXT_LAYOUT_NO_WRAP
+	int align;
+	float scale, proportion, tracking, spacing;
+	DWORD hash;
+	HTEXTURE texture;
+	std::string wrappedText;	//The text with a newline at each line break
+	std::vector<TextGlyph> glyphs;
+	int lastUsed;
+};
+
+class TextLayoutCache {
+
+public:
+
+	TextLayoutCache();
+	~TextLayoutCache();
+
+	void printfb(hgeFont *font, float x, float y, float w, float h, int align, const char *text);
+	void print(hgeFont *font, float x, float y, int align, const char *text);
+	TextLayout *getLayout(hgeFont *font, float w, float h, int align, const char *text);
+
+private:
+
+	int wrap(TextLayout *layout);
+	void buildGlyphs(TextLayout *layout, int numLines);
+	void render(TextLayout *layout, float x, float y);
+
+	TextLayout layouts[TEXT_LAYOUT_CACHE_SIZE];
+	int numLayouts;
+	int useCounter;
+
+};
+
+//----------------------------------------------------------------
+//------------------------ PARTICLE POOL -------------------------
+//----------------------------------------------------------------
+// Hands out particle systems copied from the resource templates and
+// takes them back when they are finished with, so systems are reused
+// instead of being created and deleted for every fireball and
+// explosion. Once a frame it counts the live particles. When there are
+// more than the budget, lower priority systems emit fewer particles.
+//----------------------------------------------------------------
+#define DEFAULT_PARTICLE_BUDGET 3000
+#define PARTICLE_CULL_MARGIN 128.0
+
+class ParticlePriorities
+{
+public:
+	static const int Low = 0;			//Ambient effects that nobody will miss
+	static const int Normal = 1;
+	static const int High = 2;			//Never scaled down, for effects that show gameplay
+};
+
+struct PooledParticleSystem {
+	hgeParticleSystem *particle;
+	hgeParticleSystem *source;			//The resource template it was copied from
+	int priority;
+	int baseEmission;
+	bool inUse;
+};
+
+class ParticlePool {
+
+public:
+
+	ParticlePool();
+	~ParticlePool();
+
+	hgeParticleSystem *acquire(const char *name, int priority);
+	void release(hgeParticleSystem *particle);
+	void render(hgeParticleSystem *particle);
+	void update();
+	void reset();
+
+	int getNumLiveSystems();
+	int getNumLiveParticles();
+	int getNumPooledSystems();
+	int getNumCulled();
+	int getNumReclaimed();
+
+private:
+
+	std::vector<PooledParticleSystem> systems;
+	int budget;
+	int numLiveSystems;
+	int numLiveParticles;
+	int numCulled;
+	int numReclaimed;
+
+};
+
+//----------------------------------------------------------------
+//------------------ RESOURCE STREAMER ---------------------------
+//----------------------------------------------------------------
+// Loads every resource in a resource group a few at a time over
+// the following frames, so that a boss's textures are already
+// decoded and uploaded by the time the fight starts instead of
+// being loaded on the frame they are first drawn. HGE's resource
+// manager and the Direct3D device can only be used from the main
+// thread, so the loading is spread out over frames rather than
+// done on another thread.
+//----------------------------------------------------------------
+#define DEFAULT_STREAMING_BUDGET 2		//Milliseconds per frame
+
+struct ResourceResidency {
+	int numResources;
+	int numLoaded;
+	int textureBytes;
+};
+
+class ResourceStreamer {
+
+public:
+
+	ResourceStreamer();
+	~ResourceStreamer();
+
+	void request(int group);
+	void cancel(int group);
+	void update();
+
+	bool isResident(int group);
+	bool isStreaming(int group);
+	ResourceResidency getResidency(int group);
+
+private:
+
+	bool loadNext();
+
+	std::list<int> queue;
+	int cursor;
+	bool started;
+	float budget;
+	LARGE_INTEGER groupStartTime;
+
+};
+
+//----------------------------------------------------------------
+//------------------ RESOURCE MANIFEST ---------------------------
+//----------------------------------------------------------------
+// Data/ResourceScript compiled into a binary file that is mapped
+// straight into memory at startup instead of being parsed. Names
+// are found with a perfect hash, each group's resources are listed
+// with textures first, and nothing is created until it is asked
+// for. Has the same Get/Precache/Purge methods as HGE's resource
+// manager so the rest of the game didn't have to change. Compile
+// it by running the game with -compileresources. Textures the script
+// puts in an atlas are copied onto shared atlas pages the first time
+// a sprite needs them, and their sprites are made from the page.
+//----------------------------------------------------------------
+#define RESOURCE_MANIFEST_FILE "Data/ResourceManifest"
+#define RESOURCE_SCRIPT_FILE "Data/ResourceScript"
+#define RESOURCE_MANIFEST_MAGIC 0x464D5253		//"SRMF"
+#define RESOURCE_MANIFEST_VERSION 2
+
+//In the order they are loaded so that textures exist before the sprites that use them
+class ResourceTypes
+{
+public:
+	static const int Texture = 0;
+	static const int Sound = 1;
+	static const int Music = 2;
+	static const int Font = 3;
+	static const int Sprite = 4;
+	static const int Animation = 5;
+	static const int Particle = 6;
+};
+
+#define NUM_RESOURCE_TYPES 7
+
+struct ManifestHeader {
+	DWORD magic;
+	DWORD version;
+	DWORD scriptSize;			//Used to tell when the script has changed since it was compiled
+	FILETIME scriptTime;
+	int numRecords;
+	int numBuckets;
+	int numSlots;
+	int numGroups;
+	int numAtlasPages;
+	DWORD recordsOffset;
+	DWORD seedsOffset;
+	DWORD slotsOffset;
+	DWORD groupsOffset;
+	DWORD membersOffset;
+	DWORD atlasPagesOffset;
+	DWORD stringsOffset;
+};
+
+struct ManifestRecord {
+	int type;
+	int group;
+	DWORD name;					//Offsets into the string table
+	DWORD filename;
+	int dependency;				//Texture of a sprite or animation, sprite of a particle system, otherwise -1
+	float x, y, width, height;
+	float hotX, hotY;
+	int blendMode;
+	DWORD color;
+	int frames;
+	float fps;
+	int mode;
+	float tracking;
+	int amplify;
+	int mipmap;
+	int atlas;					//Atlas the script puts a texture in, 0 for none
+	int atlasPage;				//Page the texture was packed onto, -1 if it isn't on one
+	float atlasX, atlasY;
+};
+
+struct ManifestAtlasPage {
+	int atlas;
+	int width;
+	int height;
+};
+
+struct ManifestGroup {
+	int group;
+	int firstMember;
+	int numMembers;
+};
+
+class ResourceManifest {
+
+public:
+
+	ResourceManifest(const char *manifestFile, const char *scriptFile);
+	~ResourceManifest();
+
+	//Same as hgeResourceManager
+	bool Precache(int group = 0);
+	void Purge(int group = 0);
+	HTEXTURE GetTexture(const char *name);
+	HEFFECT GetEffect(const char *name);
+	HMUSIC GetMusic(const char *name);
+	hgeSprite *GetSprite(const char *name);
+	hgeAnimation *GetAnimation(const char *name);
+	hgeFont *GetFont(const char *name);
+	hgeParticleSystem *GetParticleSystem(const char *name);
+
+	int find(const char *name);
+	const int *getGroupMembers(int group, int *numMembers);
+	const ManifestRecord *getRecord(int record);
+	const char *getName(int record);
+	int getNumRecords();
+	DWORD getHandle(int record);
+	DWORD load(int record);
+	void unload(int record);
+	HTEXTURE getTextureRegion(const char *name, float *x, float *y);
+	void setTextureRect(const char *sprite, float x, float y, float width, float height);
+	int getNumAtlasPages();
+
+	static DWORD hashName(const char *name, DWORD seed);
+	static bool isUpToDate(const ManifestHeader *header, const char *scriptFile);
+
+private:
+
+	bool mapFile(const char *manifestFile, const char *scriptFile);
+	void closeFile();
+	bool use(const BYTE *manifest, DWORD size);
+	DWORD get(const char *name, int type);
+	HTEXTURE getRegion(int texture, float *x, float *y);
+	HTEXTURE loadAtlasPage(int page);
+
+	HANDLE file;
+	HANDLE mapping;
+	const BYTE *data;
+	std::vector<BYTE> compiled;		//Used instead of a mapping when the manifest had to be compiled at startup
+
+	const ManifestHeader *header;
+	const ManifestRecord *records;
+	const DWORD *seeds;
+	const int *slots;
+	const ManifestGroup *groups;
+	const int *members;
+	const ManifestAtlasPage *atlasPages;
+	const char *strings;
+	DWORD *handles;
+	std::vector<HTEXTURE> atlasPageTextures;
+	bool useAtlas;
+
+	std::map<std::string, HTEXTURE> looseTextures;
+
+};
+
+//----------------------------------------------------------------
+//------------------ RESOURCE MANIFEST COMPILER ------------------
+//----------------------------------------------------------------
+// Parses Data/ResourceScript and writes out the binary manifest.
+// Also reports duplicate names, references to resources that don't
+// exist, and names passed to smh->resources in the source code that
+// aren't in the script. Doesn't use HGE so it can run without a
+// window.
+//----------------------------------------------------------------
+struct ScriptResource {
+	ManifestRecord record;
+	std::string name;
+	std::string filename;
+	std::string dependency;
+	int line;
+};
+
+class ResourceManifestCompiler {
+
+public:
+
+	ResourceManifestCompiler();
+
+	bool compile(const char *scriptFile);
+	bool save(const char *manifestFile);
+	int validateCode(const char *sourceDir);
+
+	const std::vector<BYTE> &getManifest();
+	const std::vector<std::string> &getErrors();
+	int getNumResources();
+
+private:
+
+	bool parse(const char *scriptFile);
+	void setValue(ScriptResource *resource, const std::string &key, const std::string &value);
+	void resolveDependencies();
+	void sortByName();
+	bool buildHashTable(std::vector<DWORD> &seeds, std::vector<int> &slots);
+	void packAtlases(std::vector<ManifestAtlasPage> &pages);
+	void build(const char *scriptFile, const std::vector<DWORD> &seeds, const std::vector<int> &slots, const std::vector<ManifestAtlasPage> &pages);
+	int validateFile(const std::string &fileName);
+	int find(const std::string &name);
+	void error(const char *format, ...);
+
+	std::vector<ScriptResource> resources;
+	std::map<std::string, int> indices;
+	std::vector<std::string> errors;
+	std::vector<BYTE> manifest;
+
+};
+
+//----------------------------------------------------------------
+//------------------ TEXTURE ATLAS PACKER ------------------------
+//----------------------------------------------------------------
+// Works out where each texture marked with atlas=N in the resource
+// script goes on that atlas's pages. Textures are packed in shelves,
+// tallest first. hgeAnimation wraps frames onto the next row at the
+// edge of the texture, so a texture with an animation that wraps
+// has to be exactly as wide as its page.
+//----------------------------------------------------------------
+#define MAX_ATLAS_PAGE_SIZE 2048
+
+struct AtlasTexture {
+	int texture;
+	int atlas;
+	int width, height;
+	bool fullWidth;
+	int page;						//-1 if it didn't fit on a page
+	int x, y;
+};
+
+class TextureAtlasPacker {
+
+public:
+
+	TextureAtlasPacker(int maxPageSize);
+
+	void add(int texture, int atlas, int width, int height, bool fullWidth);
+	void pack();
+
+	const std::vector<AtlasTexture> &getTextures();
+	const std::vector<ManifestAtlasPage> &getPages();
+
+	static bool readImageSize(const char *fileName, int *width, int *height);
+
+private:
+
+	void packAtlas(const std::vector<int> &order);
+
+	std::vector<AtlasTexture> textures;
+	std::vector<ManifestAtlasPage> pages;
+	int maxPageSize;
+
+};
+
+//----------------------------------------------------------------
+//------------------ LZ4 -----------------------------------------
+//----------------------------------------------------------------
+// LZ4 block format compression. Compression is a simple greedy
+// match finder that is only run by the asset packer; decompression
+// is what the game does when it reads a compressed asset.
+//----------------------------------------------------------------
+#define LZ4_HASH_BITS 12
+
+class Lz4 {
+
+public:
+
+	static void compress(const BYTE *source, int sourceSize, std::vector<BYTE> &compressed);
+	static int decompress(const BYTE *source, int sourceSize, BYTE *destination, int destinationSize);
+
+};
+
+//----------------------------------------------------------------
+//------------------ ASSET PACKS ---------------------------------
+//----------------------------------------------------------------
+// Reads files out of the .pak files built by AssetPacker. Packs are
+// memory mapped and found through a hashed table of contents, and
+// uncompressed assets are returned straight out of the mapping. LZ4
+// compressed assets are decompressed into a small cache. Anything
+// not in a pack is read through HGE, from its zips or the disk.
+// A pack that is about to be read from end to end can be decoded
+// ahead of time on worker threads by predecode(); load() then hands
+// out those buffers instead of decoding them again.
+//----------------------------------------------------------------
+#define ASSET_PACK_MAGIC 0x4B415053			//"SPAK"
+#define ASSET_PACK_VERSION 1
+#define ASSET_PACK_ALIGNMENT 4096			//Entries start on a page
+#define ASSET_CACHE_SIZE (2 * 1024 * 1024)
+
+class PackCompression
+{
+public:
+	static const int None = 0;
+	static const int Lz4 = 1;
+};
+
+struct PackHeader {
+	DWORD magic;
+	DWORD version;
+	int numEntries;
+	int numSlots;					//Power of 2, probed linearly
+	DWORD entriesOffset;
+	DWORD slotsOffset;
+	DWORD namesOffset;
+};
+
+struct PackEntry {
+	DWORD name;						//Offset into the names
+	DWORD hash;
+	DWORD offset;
+	DWORD storedSize;
+	DWORD size;
+	int compression;
+};
+
+struct MappedPack {
+	std::string fileName;
+	HANDLE file;
+	HANDLE mapping;
+	const BYTE *data;
+	const PackHeader *header;
+	const PackEntry *entries;
+	const int *slots;
+	const char *names;
+};
+
+struct CachedAsset {
+	std::string name;
+	BYTE *data;
+	DWORD size;
+};
+
+class PredecodeStates
+{
+public:
+	static const int Waiting = 0;
+	static const int Decoding = 1;
+	static const int Done = 2;
+	static const int Taken = 3;			//By load(), or never needed decoding
+};
+
+struct PredecodedAsset {
+	BYTE *data;
+	volatile LONG state;
+};
+
+class AssetPacks {
+
+public:
+
+	AssetPacks();
+	~AssetPacks();
+
+	bool attach(const char *packFile, const char *zipFile);
+	const BYTE *load(const char *name, DWORD *size);
+	void clearCache();
+
+	int beginPredecode(const char *packFile);
+	void predecode(int slice, int numSlices);
+
+	int getNumAssets();
+	const char *getAssetName(int asset);
+
+	static std::string normalizeName(const char *name);
+	static const PackEntry *find(const MappedPack &pack, const std::string &name);
+
+private:
+
+	BYTE *cache(const std::string &name, DWORD size);
+	BYTE *cache(const std::string &name, BYTE *data, DWORD size);
+	BYTE *takePredecoded(int pack, const PackEntry *entry);
+	void clearPredecoded();
+
+	std::vector<MappedPack> packs;
+	std::list<CachedAsset> cached;
+	DWORD cachedBytes;
+
+	//One per entry of the pack being predecoded
+	int predecodePack;
+	PredecodedAsset *predecoded;
+
+};
+
+//----------------------------------------------------------------
+//------------------ ASSET PACKER --------------------------------
+//----------------------------------------------------------------
+// Builds a .pak from one of the zips in Data. The zip's directory
+// is read to get the file names and HGE reads the files out of it.
+// Files that LZ4 makes at least an eighth smaller are compressed,
+// the rest are stored so they can be used straight from the
+// mapping. Run the game with -buildpacks to rebuild every pack.
+//----------------------------------------------------------------
+struct PackedAsset {
+	std::string name;
+	std::vector<BYTE> data;
+	DWORD size;
+	int compression;
+};
+
+class AssetPacker {
+
+public:
+
+	AssetPacker(HGE *hge);
+
+	bool addZip(const char *zipFile);
+	void add(const std::string &name, const BYTE *data, DWORD size);
+	bool save(const char *packFile);
+
+	const std::vector<std::string> &getErrors();
+	int getNumAssets();
+	int getNumCompressed();
+	DWORD getSize();
+	DWORD getStoredSize();
+
+private:
+
+	bool readZipDirectory(const char *zipFile, std::vector<std::string> &names);
+	void error(const char *format, ...);
+
+	HGE *hge;
+	std::vector<PackedAsset> assets;
+	std::vector<std::string> errors;
+
+};
+
+//----------------------------------------------------------------
+//------------------ SPRITE BATCH --------------------------------
+//----------------------------------------------------------------
+// HGE sends quads to the card in batches but has to start a new
+// batch whenever the texture or blend mode changes. Sprites drawn
+// between beginSorted() and endSorted() are held back and sent
+// sorted by layer, texture and blend mode, which is only right for
+// things like tiles that don't overlap within a layer. Everything
+// else is sent straight away. The texture switches and batches of
+// each section of the frame are counted both in the order they were
+// drawn and in the order they were sent. In headless mode nothing is
+// sent, so the counts can be taken without drawing anything.
+//----------------------------------------------------------------
+class BatchSections
+{
+public:
+	static const int Environment = 0;
+	static const int Enemies = 1;
+	static const int GUI = 2;
+};
+
+#define NUM_BATCH_SECTIONS 3
+
+struct BatchedQuad {
+	hgeQuad quad;
+	int layer;
+	int order;
+};
+
+struct BatchStats {
+	int quads;
+	int drawnBatches;			//If each quad had been sent when it was drawn
+	int drawnSwitches;
+	int batches;				//As they were actually sent
+	int switches;
+};
+
+class SpriteBatch {
+
+public:
+
+	SpriteBatch();
+	~SpriteBatch();
+
+	void beginSection(int section);
+	void endSection();
+	void beginSorted();
+	void endSorted();
+
+	void render(hgeSprite *sprite, float x, float y, int layer = 0);
+	void renderEx(hgeSprite *sprite, float x, float y, float rot, float hscale = 1.0f, float vscale = 0.0f, int layer = 0);
+	void renderStretch(hgeSprite *sprite, float x1, float y1, float x2, float y2, int layer = 0);
+
+	void setHeadless(bool headless);
+	void resetStats();
+	const BatchStats &getStats(int section);
+
+private:
+
+	void setQuad(hgeSprite *sprite, hgeQuad *quad);
+	void add(const hgeQuad &quad, int layer);
+	void submit(const hgeQuad &quad);
+	void count(const hgeQuad &quad, HTEXTURE *lastTexture, int *lastBlend, int *batches, int *switches);
+
+	std::vector<BatchedQuad> held;
+	BatchStats stats[NUM_BATCH_SECTIONS];
+	int section;
+	bool sorting;
+	bool headless;
+
+	HTEXTURE drawnTexture, sentTexture;
+	int drawnBlend, sentBlend;
 
 };
 
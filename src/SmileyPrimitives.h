@@ -0,0 +1,735 @@
+#ifndef SMILEY_PRIMITIVES_H_
+#define SMILEY_PRIMITIVES_H_
+
+/**
+ * The game's constants and the pieces of the engine that don't need SMH or
+ * HGE: tile traits, collision masks, Util, bit streams, the change manager and
+ * the game data tables and the string tables they are read from. SmileyEngine.h
+ * includes all of this. Headless/ builds
+ * these on their own, against a stub of the few Win32 and HGE pieces they use.
+ */
+
+#ifdef _MANAGED
+#using <mscorlib.dll>
+#endif
+
+#include <windows.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <fstream>
+#include <list>
+#include <vector>
+#include <map>
+
+//Constants
+#define PI 3.14159265357989232684
+
+//NPCS
+#define MONOCLE_MAN_NPC_ID 13
+#define MONOCLE_MAN_TEXT_ID 902
+#define SPEIRDYKE_TEXT_ID 5
+#define BILL_CLINTON_TEXT_ID 8
+#define BILL_CLINTON_TEXT_ID2 19
+
+//Difficulty
+#define VERY_EASY 0
+#define EASY 1
+#define MEDIUM 2
+#define HARD 3
+#define VERY_HARD 4
+
+//Gameplay values
+#define NUM_NPCS 99
+#define PLAYER_WIDTH 61
+#define PLAYER_HEIGHT 72
+
+//Resource Groups
+class ResourceGroups
+{
+public:
+	static const int Menu = 10;
+	static const int Credits = 11;
+	static const int Cinematic= 12;
+	static const int WorldMap = 13;
+	static const int Sounds = 14;
+	static const int Phyrebawz = 100;
+	static const int PortlyPenguin = 101;
+	static const int Garmborn = 102;
+	static const int Cornwallis = 103;
+	static const int Mushboom = 104;
+	static const int Calypso = 105;
+	static const int Bartli = 106;
+	static const int KingTut = 107;
+	static const int Lovecraft = 108;
+	static const int Barvinoid = 109;
+	static const int Fenwar = 110;
+};
+
+#define NUM_BOSSES 12
+
+//Special editor IDs
+#define DRAW_AFTER_SMILEY 990
+
+//Abilities
+#define NUM_ABILITIES 12
+#define NO_ABILITY 12
+#define CANE 0
+#define FIRE_BREATH 1
+#define FRISBEE 2
+#define SPRINT_BOOTS 3
+#define LIGHTNING_ORB 4
+#define REFLECTION_SHIELD 5
+#define SILLY_PAD 6
+#define WATER_BOOTS 7
+#define ICE_BREATH 8
+#define SHRINK 9
+#define TUTS_MASK 10
+#define HOVER 11
+
+//Ability types
+#define PASSIVE 0
+#define ACTIVATED 1
+#define HOLD 2
+
+//Level ids
+#define NUM_AREAS 11
+#define FOUNTAIN_AREA 0
+#define OLDE_TOWNE 1
+#define TUTS_TOMB 2
+#define FOREST_OF_FUNGORIA 3
+#define SESSARIA_SNOWPLAINS 4
+#define WORLD_OF_DESPAIR 5
+#define SERPENTINE_PATH 6
+#define CASTLE_OF_EVIL 7
+#define SMOLDER_HOLLOW 8
+#define CONSERVATORY 9
+#define DEBUG_AREA 10
+
+//State
+#define MENU 10
+#define GAME 20
+
+//Directions
+#define NUM_DIRECTIONS 8
+#define DOWN 0
+#define LEFT 1
+#define RIGHT 2
+#define UP 3
+#define UP_LEFT 4
+#define UP_RIGHT 5
+#define DOWN_LEFT 6
+#define DOWN_RIGHT 7
+
+//Item Layer
+#define NUM_ITEMS 9
+#define NONE 0
+#define RED_KEY 1
+#define YELLOW_KEY 2
+#define GREEN_KEY 3
+#define BLUE_KEY 4
+#define SMALL_GEM 5
+#define MEDIUM_GEM 6
+#define LARGE_GEM 7
+#define HEALTH_ITEM 9
+#define MANA_ITEM 8
+
+//Collision Layer
+#define NUM_COLLISION 36
+#define WALKABLE 0
+#define UNWALKABLE 1
+#define RED_KEYHOLE 2
+#define YELLOW_KEYHOLE 3
+#define GREEN_KEYHOLE 4
+#define BLUE_KEYHOLE 5
+#define EVIL_DOOR 6
+#define SHALLOW_WATER 7
+#define DEEP_WATER 8
+#define UP_ARROW 9
+#define RIGHT_ARROW 10
+#define DOWN_ARROW 11
+#define LEFT_ARROW 12
+#define SLIME 13
+#define SPRING_PAD 14
+#define FIRE_DESTROY 15
+#define WALK_LAVA 16
+#define NO_WALK_LAVA 17
+#define UNWALKABLE_PROJECTILE 18
+#define RED_WARP 19
+#define BLUE_WARP 20
+#define YELLOW_WARP 21
+#define GREEN_WARP 22
+#define SPIN_ARROW_SWITCH 23
+#define PIT 24
+#define FOUNTAIN 25
+#define SAVE_SHRINE 26
+#define SIGN 27
+#define ICE 28
+#define MIRROR_UP_LEFT 29
+#define MIRROR_UP_RIGHT 30
+#define MIRROR_DOWN_RIGHT 31
+#define MIRROR_DOWN_LEFT 32
+#define MIRROR_SWITCH 33
+#define ENEMY_NO_WALK 34
+#define GREEN_WATER 35
+#define DIZZY_MUSHROOM_1 36
+#define DIZZY_MUSHROOM_2 37
+#define BOMB_PAD_UP 38
+#define BOMB_PAD_DOWN 39
+#define BOMBABLE_WALL 40
+#define HOVER_PAD 41
+#define WHITE_CYLINDER_DOWN 42
+#define YELLOW_CYLINDER_DOWN 43
+#define GREEN_CYLINDER_DOWN 44
+#define BLUE_CYLINDER_DOWN 45
+#define BROWN_CYLINDER_DOWN 46
+#define SILVER_CYLINDER_DOWN 47
+#define SHRINK_TUNNEL_SWITCH 48
+#define SHRINK_TUNNEL_HORIZONTAL 49
+#define SHRINK_TUNNEL_VERTICAL 50
+#define SHALLOW_GREEN_WATER 51
+#define EVIL_WALL_POSITION 52
+#define EVIL_WALL_TRIGGER 53
+#define EVIL_WALL_DEACTIVATOR 54
+#define EVIL_WALL_RESTART 55
+#define FLAME 56
+#define SUPER_SPRING 57
+#define WHITE_CYLINDER_UP 58
+#define YELLOW_CYLINDER_UP 59
+#define GREEN_CYLINDER_UP 60
+#define BLUE_CYLINDER_UP 61
+#define BROWN_CYLINDER_UP 62
+#define SILVER_CYLINDER_UP 63
+#define SMILELET 64
+#define SMILELET_FLOWER_SAD 65
+#define SMILELET_FLOWER_HAPPY 66
+#define NO_WALK_PIT 67
+#define FAKE_PIT 68
+#define NO_WALK_WATER 69
+#define FAKE_COLLISION 70
+#define WALK_BOMB_SPEED_PAD 71
+//...
+#define WHITE_SWITCH_LEFT 74
+#define YELLOW_SWITCH_LEFT 75
+#define GREEN_SWITCH_LEFT 76
+#define BLUE_SWITCH_LEFT 77
+#define BROWN_SWITCH_LEFT 78
+#define SILVER_SWITCH_LEFT 79
+//...
+#define WHITE_SWITCH_RIGHT 90
+#define YELLOW_SWITCH_RIGHT 91
+#define GREEN_SWITCH_RIGHT 92
+#define BLUE_SWITCH_RIGHT 93
+#define BROWN_SWITCH_RIGHT 94
+#define SILVER_SWITCH_RIGHT 95
+//...
+#define PLAYER_START 224
+#define PLAYER_END 225
+
+//Colors
+class Colors
+{
+public:
+	static const int RED = 0;
+	static const int YELLOW = 1;
+	static const int GREEN = 2;
+	static const int BLUE = 3;
+	static const int BLACK = 4;
+	static const int WHITE = 5;
+};
+
+struct Point {
+	int x, y;
+};
+
+//----------------------------------------------------------------
+//------------------ STRING TABLE --------------------------------
+//----------------------------------------------------------------
+// Reads the same name="value" files as hgeStringTable, but with
+// plain file I/O instead of HGE's resource system so that it can be
+// loaded on a worker thread while the game starts up.
+//----------------------------------------------------------------
+#define STRING_TABLE_HEADER "[HGESTRINGTABLE]"
+
+class StringTable {
+
+public:
+
+	StringTable();
+
+	bool load(const char *fileName);
+	const char *getString(const char *name);
+	int getNumStrings();
+
+private:
+
+	std::map<std::string, std::string> strings;
+
+};
+
+//----------------------------------------------------------------
+//------------------DATA------------------------------------------
+//----------------------------------------------------------------
+// Provides a centralized location for retrieving all game data.
+//----------------------------------------------------------------
+
+#define MAX_ENEMIES 200
+
+/**
+ * Stores info for each enemy id
+ */ 
+struct EnemyInfo {
+
+	//For all enemies
+	int gRow, gCol;
+	int enemyType, wanderType, hp, speed, radius, damage, rangedType;
+	bool land, shallowWater, deepWater, slime, lava, mushrooms;
+	bool immuneToFire, immuneToTongue, immuneToLightning, immuneToStun, immuneToFreeze, invincible;
+	int variable1, variable2, variable3;
+	int numFrames;
+	bool hasOneGraphic;
+	bool chases, hasRangedAttack;
+	int range, delay, projectileSpeed;
+	float projectileDamage;
+	float projectileHoming;
+	
+};
+
+struct EnemyName {
+	int id;
+	std::string name;
+};
+
+struct Ability {
+	char name[32];
+	char description[128];
+	int manaCost;
+	int type;
+	float timeLastUsed;
+	float coolDown;
+};
+
+class GameData {
+
+public:
+
+	GameData();
+	~GameData();
+
+	EnemyInfo getEnemyInfo(int enemyID);
+	Ability getAbilityInfo(int abilityID);
+	void setTimeLastUsedAbility(int abilityID, float time);
+	std::list<EnemyName> getEnemyNames();
+	int getNumTotalGemsInArea(int area, int gemType);
+	const char *getGameText(const char *text);
+	int getGameTextHandle(const char *text);
+	const char *getGameText(int handle);
+	const char *getAreaName(int area);
+	float getDifficultyModifier(int difficulty);
+	int getNumEnemies();
+	void refreshAbilityData();
+
+	//Done as startup tasks, see SMH::init
+	bool parseEnemyTable();
+	bool parseGameText();
+	void loadEnemyData();
+
+private:
+
+	void addEnemyName(int id, std::string name);
+	void initializeGemCounts();
+
+	StringTable enemyStringTable;
+	EnemyInfo enemyInfo[MAX_ENEMIES];
+	Ability abilities[16];
+	std::list<EnemyName> enemyNameList;
+	StringTable gameText;
+	std::map<std::string, int> gameTextHandles;
+	std::vector<const char*> internedGameText;	//Looked up once per handle
+	int totalGemCounts[NUM_AREAS][3];
+
+};
+
+
+//----------------------------------------------------------------
+//------------------BIT STREAM------------------------------------
+//----------------------------------------------------------------
+// This class allows you to easily read/write bits and bytes to
+// a file to make up for the mind boggling shortcomings of C++.
+//----------------------------------------------------------------
+#define FILE_READ 0
+#define FILE_WRITE 1
+
+//Deleting an open stream throws. Newer compilers make destructors noexcept
+//unless told otherwise, which would turn that into terminate().
+#if __cplusplus >= 201103L
+#define BIT_STREAM_DESTRUCTOR_THROWS noexcept(false)
+#else
+#define BIT_STREAM_DESTRUCTOR_THROWS
+#endif
+
+class BitStream {
+
+public:
+	BitStream();
+	~BitStream() BIT_STREAM_DESTRUCTOR_THROWS;
+
+	void open(std::string fileName, int mode);
+	void writeByte(int byte);
+	bool writeBit(bool bit);
+	void writeBits(int data, int numBits);
+	int readByte();
+	bool readBit();
+	int readBits(int numBits);
+	void close();
+	int getNumBitsRead();
+	int getNumBitsWritten();
+
+private:
+	bool isOpen;
+	int mode, numRead, numWritten;
+	std::ifstream inFile;
+	std::ofstream outFile;
+	std::string outString;
+	unsigned char byte;
+	int counter;
+};
+
+//----------------------------------------------------------------
+//------------------ CHANGE MANAGER ------------------------------
+//----------------------------------------------------------------
+// Used to manage all changes to the game world. Internally, it is
+// a linked list of objects representing a single square in one area
+// that has been changed from its original state. This only supports
+// boolean states at each square.
+//----------------------------------------------------------------
+struct Change {
+	int x;
+	int y;
+	int area;
+};
+
+class ChangeManager {
+
+public:
+
+	ChangeManager();
+	~ChangeManager();
+
+	void change(int area, int x, int y);
+	bool isChanged(int area, int x, int y);
+	void reset();
+	void writeToStream(BitStream *stream);
+
+private:
+	std::list<Change> theChanges;
+	void addChange(int area, int x, int y);
+	bool removeChange(int area, int x, int y);
+};
+
+//----------------------------------------------------------------
+//------------------ TILE TRAITS ---------------------------------
+//----------------------------------------------------------------
+// Table of what every collision id is, built once at startup so that
+// asking whether a tile is a pit or a cylinder is a single lookup
+// instead of a chain of comparisons.
+//----------------------------------------------------------------
+class TileTraits
+{
+public:
+	static const int Pit = 1;					//Any kind of pit, including fake ones
+	static const int Lava = 2;
+	static const int DeepWater = 4;
+	static const int SwitchLeft = 8;
+	static const int SwitchRight = 16;
+	static const int CylinderDown = 32;
+	static const int CylinderUp = 64;
+	static const int ArrowPad = 128;
+	static const int Warp = 256;
+	static const int GayFix = 512;
+	static const int Animated = 1024;			//Drawn by Environment::drawAnimatedCollision
+	static const int DrawsCollision = 2048;		//The environment draws a sprite for it
+	static const int ProjectileBlocking = 4096;
+	static const int ReturnSpot = 8192;			//Safe to put Smiley back on after drowning or falling
+
+	static void init();
+
+	static bool has(int id, int traits) {
+		return (id & ~255) == 0 && (table[id] & traits) != 0;
+	}
+
+private:
+	static void add(int traits, const int *ids, int numIds);
+	static int table[256];
+};
+
+/**
+ * One bit for each collision id saying whether something can move onto that
+ * kind of tile, so checking a tile is a single AND.
+ */
+class CollisionMask {
+
+public:
+
+	CollisionMask() {
+		setAll(false);
+	}
+
+	void setAll(bool pass) {
+		for (int i = 0; i < 8; i++) bits[i] = pass ? 0xFFFFFFFF : 0;
+	}
+
+	void set(int id, bool pass) {
+		if (pass) bits[(id >> 5) & 7] |= 1 << (id & 31);
+		else bits[(id >> 5) & 7] &= ~(1 << (id & 31));
+	}
+
+	bool operator[](int id) const {
+		return (bits[(id >> 5) & 7] & (1 << (id & 31))) != 0;
+	}
+
+private:
+	DWORD bits[8];
+};
+
+//----------------------------------------------------------------
+//------------------ UTIL ----------------------------------------
+//----------------------------------------------------------------
+// This class is for static utility functions outside the scope of the
+// Smiley world, such as string conversions and shit.
+//----------------------------------------------------------------
+class Util {
+
+public:
+
+	static int roundUp(float num) {
+		if (num > (int)num) return (int)num + 1;
+		else return (int)num;
+	}
+
+	/**
+	 * Returns the distance between 2 points
+	 */
+	static int distance(int x1, int y1, int x2, int y2) {
+		if (x1 == x2) return abs(y1 - y2);
+		if (y1 == y2) return abs(x1 - x2);
+		return sqrt(float((x2 - x1)*(x2 - x1) + (y2 - y1)*(y2 - y1)));
+	}
+
+	/**
+	* Sets time to a string in the format HH:MM:SS for the specified number of seconds
+	*/ 
+	static std::string getTimeString(int time) {
+
+		std::string timeString;
+
+		char hours[3];
+		char minutes[3];
+		char seconds[3];
+		char temp[3];
+
+		//Get number of hours, minutes, seconds
+		itoa((time - (time % 3600)) / 3600, hours, 10);
+		time -= 3600*atoi(hours);
+		itoa((time - (time % 60)) / 60, minutes, 10);
+		time -= 60*atoi(minutes);
+		itoa(time, seconds, 10);
+
+		if (strlen(minutes) == 1) {
+			strcpy(temp, minutes);
+			strcpy(minutes,"0");
+			strcat(minutes, temp);
+		}
+
+		if (strlen(seconds) == 1) {
+			strcpy(temp, seconds);
+			strcpy(seconds,"0");
+			strcat(seconds, temp);
+		}
+
+		//Build the time string
+		timeString = hours;
+		timeString += ":";
+		timeString += minutes;
+		timeString += ":";
+		timeString += seconds;
+		
+		return timeString;
+	}
+
+	/**
+	 * Returns the specified integer as a string because the designers of C were too 
+	 * distracted by their beards to write a language that doESNT SUCK ASS FUCK SHIT
+	 */
+	static std::string intToString(int n) {
+		std::string numberString = "";
+		char number[10];
+		itoa(n, number, 10);
+		numberString += number;
+		return numberString;
+	}
+
+	/**
+	 * Returns the int as a string, with the given number of digits
+	 */
+	static std::string intToString(int number, int digits) {
+		std::string returnString;
+		returnString = intToString(number);
+		while (returnString.size() < digits) {
+			returnString.insert(0,"0");			
+		}
+		return returnString;
+	}
+
+	/**
+	 * Returns whether or not id is the id of an on cylinder switch
+	 */
+	static bool isCylinderSwitchLeft(int id) {
+		return TileTraits::has(id, TileTraits::SwitchLeft);
+	}
+
+	/**
+	 * Returns whether or not id is the id of an off cylinder switch
+	 */
+	static bool isCylinderSwitchRight(int id) {
+		return TileTraits::has(id, TileTraits::SwitchRight);
+	}
+
+	/**
+	 * Returns whether or not id is the id of a down cylinder
+	 */
+	static bool isCylinderDown(int id) {
+		return TileTraits::has(id, TileTraits::CylinderDown);
+	}
+
+	/**
+	 * Returns whether or not id is the id of an up cylinder
+	 */
+	static bool isCylinderUp(int id) {
+		return TileTraits::has(id, TileTraits::CylinderUp);
+	}
+
+	/**
+	 * Returns whether or not id is the id of an arrow pad
+     */ 
+	static bool isArrowPad(int id) {
+		return TileTraits::has(id, TileTraits::ArrowPad);
+	}
+
+	/**
+	 * Returns whether or not id is one that should use the gay fix
+	 */
+	static bool isTileForGayFix(int id) {
+		return TileTraits::has(id, TileTraits::GayFix);
+	}
+
+	/**
+	 * Returns the grid x coordinate that x appears in
+	 */
+	static int getGridX(int x) {
+		return (x - x%64) / 64;
+	} 
+
+	/**
+	 * Returns the grid y coordinate that y appears in
+	 */
+	static int getGridY(int y) {
+		return (y - y%64) / 64;
+	}
+
+	/**
+	 * Returns the angle between (x1,y1) and (x2,y2)
+	 */
+	static float getAngleBetween(int x1, int y1, int x2, int y2) {
+
+		float angle;
+
+		if (x1 == x2) {
+			if (y1 > y2) {
+				angle = 3.0*PI/2.0;
+			} else {
+				angle=PI/2.0;
+			}
+		} else {
+			angle = atan(float(y2-y1)/float(x2-x1));
+			if (x1 - x2 > 0) angle += PI;
+		}
+
+		return angle;
+
+	}
+
+	/**
+	 * Normalizes an angle to be between 0 and 2 pi
+	 */
+	static float normalizeAngle(float angle) {
+		while (angle < 0) angle += 2*PI;
+		while (angle > 2*PI) angle -= 2*PI;
+		return angle;
+	}
+
+	/**
+	 * Returns whether or not a normalized angle is between two normalized angles
+	 */
+	static bool isAngleBetween(float testAngle, float minAngle, float maxAngle) {
+		if (minAngle < maxAngle) { //easy case -- the angles do not span over 0
+			return (testAngle >= minAngle && testAngle <= maxAngle);	
+		} else if (minAngle == maxAngle) { //the only way it can be between is if it's equal
+			return (testAngle == maxAngle);
+		} else if (minAngle > maxAngle) { //in this case, 0 is between the min and the max. So if test angle is < max or > min then it's between
+			return (testAngle > minAngle || testAngle < maxAngle);
+		}
+
+		return false;
+	}
+
+	/**
+	 * Returns which way (CW or CCW) to rotate
+	 */
+	static int rotateLeftOrRightForMinimumRotation(float from, float to) {
+		float angleDifference = from-to;
+		while (angleDifference < 0) angleDifference += 2*PI;
+		while (angleDifference > 2*PI) angleDifference -= 2*PI;
+		if (angleDifference > PI) return 1;
+		return -1;
+	}
+
+	/**
+	 * Returns whether or not a collision layer id is a warp.
+	 */
+	static bool isWarp(int id) {
+		return TileTraits::has(id, TileTraits::Warp);
+	}
+
+	/**
+	 * Returns the parent area of the given area. Only the 5 parent areas have keys, so this method
+	 * is used to determine which of these 5 areas to save the key to!! The number returned is the
+	 * [area] index of SaveManager.numKeys[area][key color] for the parent area.
+	 */
+	static int getKeyIndex(int area) 
+	{
+		switch (area) 
+		{
+			case OLDE_TOWNE:
+				return 0;
+				break;
+			case FOREST_OF_FUNGORIA:
+				return 1;
+				break;
+			case SESSARIA_SNOWPLAINS:
+				return 2;
+				break;
+			case WORLD_OF_DESPAIR:
+				return 3;
+				break;
+			case CASTLE_OF_EVIL:
+				return 4;
+				break;
+		}
+		return -1;
+	}
+
+};
+
+#endif
\ No newline at end of file
@@ -508,9 +508,9 @@ void SnowBoss::updateIceBlocks(float dt) {
 
 			//sets the collision in theEnvironment based on the ice blocks
 			if (iceBlocks[i].life > 0) {
-				smh->environment->collision[iceBlocks[i].xGrid][iceBlocks[i].yGrid]=UNWALKABLE_PROJECTILE;
+				smh->environment->collision(iceBlocks[i].xGrid, iceBlocks[i].yGrid)=UNWALKABLE_PROJECTILE;
 			} else {
-				smh->environment->collision[iceBlocks[i].xGrid][iceBlocks[i].yGrid]=WALKABLE;
+				smh->environment->collision(iceBlocks[i].xGrid, iceBlocks[i].yGrid)=WALKABLE;
 			}
 		}
 	}
@@ -525,7 +525,7 @@ void SnowBoss::finish() {
 	for (int i=0; i<24; i++) {
 			iceBlocks[i].alpha = 255;
 			if (iceBlocks[i].life <= 0.0) {
-				smh->environment->collision[iceBlocks[i].xGrid][iceBlocks[i].yGrid] = WALKABLE;
+				smh->environment->collision(iceBlocks[i].xGrid, iceBlocks[i].yGrid) = WALKABLE;
 			} else {
 				smh->environment->addSnowBlock(iceBlocks[i].xGrid,iceBlocks[i].yGrid);
 			}
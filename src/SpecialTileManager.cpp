@@ -21,10 +21,16 @@
 
 #define SILLY_PAD_TIME 40		//Number of seconds silly pads stay active
 
+#define FLAME_PAUSE_THRESHOLD 0.25
+#define FLAME_FAST_FORWARD_TIME 1.0
+#define FLAME_FAST_FORWARD_STEP 0.05
+
 extern SMH *smh;
 
 SpecialTileManager::SpecialTileManager() {
 	collisionBox = new hgeRect();
+	numTiles = numActiveTiles = 0;
+	memset(tileFlags, 0, sizeof(tileFlags));
 }
 
 SpecialTileManager::~SpecialTileManager() {
@@ -42,6 +48,9 @@ void SpecialTileManager::reset() {
 	resetIceBlocks();
 	resetTimedTiles();
 	resetWarps();
+
+	//Nothing special is left in the area so no square keeps a flag into the next one
+	memset(tileFlags, 0, sizeof(tileFlags));
 }
 
 /**
@@ -60,6 +69,7 @@ void SpecialTileManager::draw(float dt) {
  * Updates all special tiles
  */
 void SpecialTileManager::update(float dt) {
+	numActiveTiles = 0;
 	updateTimedTiles(dt);
 	updateMushrooms(dt);
 	updateSillyPads(dt);
@@ -79,41 +89,62 @@ void SpecialTileManager::addIceBlock(int gridX, int gridY) {
 	newIceBlock.hasBeenMelted = false;
 
 	//Add it to the list
-	iceBlockList.push_back(newIceBlock);
+	getRegion(gridX, gridY)->iceBlocks.push_back(newIceBlock);
+	setTileFlag(gridX, gridY, SpecialTileFlags::IceBlock);
+	numTiles++;
 
 }
 
 /**
- * Updates all the ice blocks that have been created.
+ * Updates the ice blocks near the screen.
  */
 void SpecialTileManager::updateIceBlocks(float dt) {
-	std::list<IceBlock>::iterator i;
-	for(i = iceBlockList.begin(); i != iceBlockList.end(); i++) {
-		collisionBox->SetRadius(i->gridX*64.0+32.0, i->gridY*64.0+32.0,30.0);
-		if (!i->hasBeenMelted && smh->player->fireBreathParticle->testCollision(collisionBox)) {
-			i->hasBeenMelted = true;
-			i->timeMelted = smh->getGameTime();
-		}
-		if (i->hasBeenMelted && smh->timePassedSince(i->timeMelted) > 0.5) {
-			smh->environment->collision[i->gridX][i->gridY] = WALKABLE;
-			i = iceBlockList.erase(i);
+	int minRegionX, maxRegionX, minRegionY, maxRegionY;
+	getActiveRegions(minRegionX, maxRegionX, minRegionY, maxRegionY);
+	for (int regionX = minRegionX; regionX <= maxRegionX; regionX++) {
+		for (int regionY = minRegionY; regionY <= maxRegionY; regionY++) {
+			std::list<IceBlock> &iceBlockList = regions[regionX][regionY].iceBlocks;
+			numActiveTiles += iceBlockList.size();
+			std::list<IceBlock>::iterator i = iceBlockList.begin();
+			while (i != iceBlockList.end()) {
+				collisionBox->SetRadius(i->gridX*64.0+32.0, i->gridY*64.0+32.0,30.0);
+				if (!i->hasBeenMelted && smh->player->fireBreathParticle->testCollision(collisionBox)) {
+					i->hasBeenMelted = true;
+					i->timeMelted = smh->getGameTime();
+				}
+				if (i->hasBeenMelted && smh->timePassedSince(i->timeMelted) > 0.5) {
+					smh->environment->collision(i->gridX, i->gridY) = WALKABLE;
+					clearTileFlag(i->gridX, i->gridY, SpecialTileFlags::IceBlock);
+					i = iceBlockList.erase(i);
+					numTiles--;
+				} else {
+					i++;
+				}
+			}
 		}
 	}
 }
 
 /**
- * Draws all the ice blocks that have been created.
+ * Draws the ice blocks near the screen.
  */
 void SpecialTileManager::drawIceBlocks(float dt) {
-	std::list<IceBlock>::iterator i;
-	for(i = iceBlockList.begin(); i != iceBlockList.end(); i++) {
-		float scale = !i->hasBeenMelted ? 1.0 : 1.0 - min(1.0, smh->timePassedSince(i->timeMelted) * 2.0);
-		//Scale the size of the ice block based on its "health"
-		smh->resources->GetAnimation("walkLayer")->SetFrame(FIRE_DESTROY);
-		smh->resources->GetAnimation("walkLayer")->SetHotSpot(32.0,32.0);
-		smh->resources->GetAnimation("walkLayer")->RenderEx(smh->getScreenX(i->gridX*64.0+32.0), 
-			smh->getScreenY(i->gridY*64.0+32.0), 0.0, scale, scale);
-		smh->resources->GetAnimation("walkLayer")->SetHotSpot(0.0,0.0);
+	int minRegionX, maxRegionX, minRegionY, maxRegionY;
+	getActiveRegions(minRegionX, maxRegionX, minRegionY, maxRegionY);
+	for (int regionX = minRegionX; regionX <= maxRegionX; regionX++) {
+		for (int regionY = minRegionY; regionY <= maxRegionY; regionY++) {
+			std::list<IceBlock> &iceBlockList = regions[regionX][regionY].iceBlocks;
+			std::list<IceBlock>::iterator i;
+			for(i = iceBlockList.begin(); i != iceBlockList.end(); i++) {
+				float scale = !i->hasBeenMelted ? 1.0 : 1.0 - min(1.0, smh->timePassedSince(i->timeMelted) * 2.0);
+				//Scale the size of the ice block based on its "health"
+				smh->resources->GetAnimation("walkLayer")->SetFrame(FIRE_DESTROY);
+				smh->resources->GetAnimation("walkLayer")->SetHotSpot(32.0,32.0);
+				smh->resources->GetAnimation("walkLayer")->RenderEx(smh->getScreenX(i->gridX*64.0+32.0), 
+					smh->getScreenY(i->gridY*64.0+32.0), 0.0, scale, scale);
+				smh->resources->GetAnimation("walkLayer")->SetHotSpot(0.0,0.0);
+			}
+		}
 	}
 }
 
@@ -121,11 +152,17 @@ void SpecialTileManager::drawIceBlocks(float dt) {
  * Deletes all the ice blocks that have been created.
  */
 void SpecialTileManager::resetIceBlocks() {
-	std::list<IceBlock>::iterator i;
-	for(i = iceBlockList.begin(); i != iceBlockList.end(); i++) {
-		i = iceBlockList.erase(i);
+	for (int regionX = 0; regionX < SPECIAL_TILE_REGIONS_X; regionX++) {
+		for (int regionY = 0; regionY < SPECIAL_TILE_REGIONS_Y; regionY++) {
+			std::list<IceBlock> &iceBlockList = regions[regionX][regionY].iceBlocks;
+			numTiles -= iceBlockList.size();
+			std::list<IceBlock>::iterator i = iceBlockList.begin();
+			while (i != iceBlockList.end()) {
+				clearTileFlag(i->gridX, i->gridY, SpecialTileFlags::IceBlock);
+				i = iceBlockList.erase(i);
+			}
+		}
 	}
-	iceBlockList.clear();
 }
 
 //////////// Timed Tile Functions ///////////////////
@@ -136,8 +173,8 @@ void SpecialTileManager::resetIceBlocks() {
  */
 void SpecialTileManager::addTimedTile(int gridX, int gridY, int newCollision) 
 {	
-	addTimedTile(gridX, gridY, smh->environment->terrain[gridX][gridY], newCollision, 
-		smh->environment->item[gridX][gridY], 1.0);
+	addTimedTile(gridX, gridY, smh->environment->terrain(gridX, gridY), newCollision, 
+		smh->environment->item(gridX, gridY), 1.0);
 }
 
 /**
@@ -158,21 +195,22 @@ void SpecialTileManager::addTimedTile(int gridX, int gridY, int newTerrain, int
 	tile.alpha = 0.0;
 
 	tile.newTerrain = newTerrain;
-	tile.oldTerrain = smh->environment->terrain[gridX][gridY];
+	tile.oldTerrain = smh->environment->terrain(gridX, gridY);
 	tile.newCollision = newCollision;
-	tile.oldCollision = smh->environment->collision[gridX][gridY];
+	tile.oldCollision = smh->environment->collision(gridX, gridY);
 	tile.newItemLayer = newItemLayer;
-	tile.oldItemLayer = smh->environment->item[gridX][gridY];
+	tile.oldItemLayer = smh->environment->item(gridX, gridY);
 
 	timedTileList.push_back(tile);
+	setTileFlag(gridX, gridY, SpecialTileFlags::TimedTile);
 
 	//Set the new tile stuff now, we will fade out the old stuff in the draw method
-	smh->environment->terrain[gridX][gridY] = newTerrain;
-	smh->environment->item[gridX][gridY] = newItemLayer;
+	smh->environment->terrain(gridX, gridY) = newTerrain;
+	smh->environment->item(gridX, gridY) = newItemLayer;
 	if (newCollision == PIT) 
-		smh->environment->collision[gridX][gridY] = FAKE_PIT;
+		smh->environment->collision(gridX, gridY) = FAKE_PIT;
 	else
-		smh->environment->collision[gridX][gridY] = newCollision;
+		smh->environment->collision(gridX, gridY) = newCollision;
 
 }
 
@@ -189,8 +227,8 @@ void SpecialTileManager::removeTimedTile(int gridX, int gridY)
  */
 void SpecialTileManager::updateTimedTiles(float dt) 
 {
-	std::list<TimedTile>::iterator i;
-	for(i = timedTileList.begin(); i != timedTileList.end(); i++) 
+	std::list<TimedTile>::iterator i = timedTileList.begin();
+	while (i != timedTileList.end()) 
 	{
 		if (smh->timePassedSince(i->timeCreated) <= i->duration) 
 		{
@@ -200,7 +238,7 @@ void SpecialTileManager::updateTimedTiles(float dt)
 				i->alpha += (255.0 / i->fadeTime) * dt;
 				
 				if (i->newCollision == PIT && i->alpha > 165.0) 
-					smh->environment->collision[i->gridX][i->gridY] = PIT;
+					smh->environment->collision(i->gridX, i->gridY) = PIT;
 				
 				if (i->alpha > 255.0) 
 				{
@@ -213,17 +251,20 @@ void SpecialTileManager::updateTimedTiles(float dt)
 			//Fading out
 			if (i->alpha == 255.0) 
 			{
-				//smh->environment->collision[i->gridX][i->gridY] = i->oldCollision;
-				//smh->environment->item[i->gridX][i->gridY] = i->oldItemLayer;
-				//smh->environment->terrain[i->gridX][i->gridY] = i->oldTerrain;
+				//smh->environment->collision(i->gridX, i->gridY) = i->oldCollision;
+				//smh->environment->item(i->gridX, i->gridY) = i->oldItemLayer;
+				//smh->environment->terrain(i->gridX, i->gridY) = i->oldTerrain;
 			}
 			i->alpha -= (255.0 / i->fadeTime) * dt;
 			if (i->alpha < 0.0) 
 			{
 				i->alpha = 0.0;
+				clearTileFlag(i->gridX, i->gridY, SpecialTileFlags::TimedTile);
 				i = timedTileList.erase(i);
+				continue;
 			}
 		}
+		i++;
 	}
 }
 
@@ -266,22 +307,18 @@ void SpecialTileManager::drawTimedTiles(float dt)
  * Delete all timed tiles.
  */ 
 void SpecialTileManager::resetTimedTiles() {
-	std::list<TimedTile>::iterator i;
-	for(i = timedTileList.begin(); i != timedTileList.end(); i++) {
+	std::list<TimedTile>::iterator i = timedTileList.begin();
+	while (i != timedTileList.end()) {
+		clearTileFlag(i->gridX, i->gridY, SpecialTileFlags::TimedTile);
 		i = timedTileList.erase(i);
 	}
-	timedTileList.clear();
 }
 
 /**
  * Returns whether or not there is a timed tile at the specified location.
  */
 bool SpecialTileManager::isTimedTileAt(int gridX, int gridY) {
-	std::list<TimedTile>::iterator i;
-	for(i = timedTileList.begin(); i != timedTileList.end(); i++) {
-		if (i->gridX == gridX && i->gridY == gridY) return true;
-	}
-	return false;
+	return hasTileFlag(gridX, gridY, SpecialTileFlags::TimedTile);
 }
 
 //////////// Silly Pad Functions ///////////////
@@ -299,6 +336,7 @@ void SpecialTileManager::addSillyPad(int gridX, int gridY) {
 
 	//Add it to the list
 	sillyPadList.push_back(newSillyPad);
+	setTileFlag(gridX, gridY, SpecialTileFlags::SillyPad);
 
 }
 
@@ -323,8 +361,8 @@ void SpecialTileManager::drawSillyPads(float dt) {
  * Updates all silly pads that have been created.
  */
 void SpecialTileManager::updateSillyPads(float dt) {
-	std::list<SillyPad>::iterator i;
-	for(i = sillyPadList.begin(); i != sillyPadList.end(); i++) {
+	std::list<SillyPad>::iterator i = sillyPadList.begin();
+	while (i != sillyPadList.end()) {
 	
 		collisionBox->SetRadius(i->gridX*64.0+32.0, i->gridY*64.0+32.0, 32.0);
 
@@ -335,7 +373,12 @@ void SpecialTileManager::updateSillyPads(float dt) {
 				smh->player->iceBreathParticle->testCollision(collisionBox) ||
 				smh->player->fireBreathParticle->testCollision(collisionBox) ||
 				smh->player->getTongue()->testCollision(collisionBox)) {
+			int gridX = i->gridX;
+			int gridY = i->gridY;
 			i = sillyPadList.erase(i);
+			refreshSillyPadFlag(gridX, gridY);
+		} else {
+			i++;
 		}
 	}
 }
@@ -344,13 +387,7 @@ void SpecialTileManager::updateSillyPads(float dt) {
  * Returns whether or not there is a silly pad at the specified grid location.
  */
 bool SpecialTileManager::isSillyPadAt(int gridX, int gridY) {
-	std::list<SillyPad>::iterator i;
-	for(i = sillyPadList.begin(); i != sillyPadList.end(); i++) {
-		if (i->gridX == gridX && i->gridY == gridY) {
-			return true;
-		}
-	}
-	return false;
+	return hasTileFlag(gridX, gridY, SpecialTileFlags::SillyPad);
 }
 
 /**
@@ -358,10 +395,12 @@ bool SpecialTileManager::isSillyPadAt(int gridX, int gridY) {
  * or not a silly pad was destroyed
  */
 bool SpecialTileManager::destroySillyPad(int gridX, int gridY) {
+	if (!isSillyPadAt(gridX, gridY)) return false;
 	std::list<SillyPad>::iterator i;
 	for(i = sillyPadList.begin(); i != sillyPadList.end(); i++) {
 		if (i->gridX == gridX && i->gridY == gridY) {
 			i = sillyPadList.erase(i);
+			refreshSillyPadFlag(gridX, gridY);
 			return true;
 		}
 	}
@@ -372,11 +411,11 @@ bool SpecialTileManager::destroySillyPad(int gridX, int gridY) {
  * Deletes all silly pads that have been created.
  */
 void SpecialTileManager::resetSillyPads() {
-	std::list<SillyPad>::iterator i;
-	for(i = sillyPadList.begin(); i != sillyPadList.end(); i++) {
+	std::list<SillyPad>::iterator i = sillyPadList.begin();
+	while (i != sillyPadList.end()) {
+		clearTileFlag(i->gridX, i->gridY, SpecialTileFlags::SillyPad);
 		i = sillyPadList.erase(i);
 	}
-	sillyPadList.clear();
 }
 
 //////////// Flame Functions ////////////////
@@ -388,61 +427,96 @@ void SpecialTileManager::addFlame(int gridX, int gridY) {
 	newFlame.x = gridX * 64.0 + 32.0;
 	newFlame.y = gridY * 64.0 + 32.0;
 	newFlame.timeFlamePutOut = -10.0;
-	newFlame.particle = new hgeParticleSystem(&smh->resources->GetParticleSystem("flame")->info);
+	newFlame.particle = smh->particlePool->acquire("flame", ParticlePriorities::Normal);
 	newFlame.particle->FireAt(smh->getScreenX(newFlame.x), smh->getScreenY(newFlame.y));
 	newFlame.collisionBox = new hgeRect(1,1,1,1);
+	newFlame.lastUpdateTime = smh->getGameTime();
 
 	//Add it to the list
-	flameList.push_back(newFlame);
+	getRegion(gridX, gridY)->flames.push_back(newFlame);
+	setTileFlag(gridX, gridY, SpecialTileFlags::Flame);
+	numTiles++;
 
 }
 
 /**
- * Draws all flames that have been created.
+ * Draws the flames near the screen.
  */
 void SpecialTileManager::drawFlames(float dt) {
-	std::list<Flame>::iterator i;
-	for(i = flameList.begin(); i != flameList.end(); i++) {
-		i->particle->MoveTo(smh->getScreenX(i->x), smh->getScreenY(i->y), true);
-		i->particle->Render();
+	int minRegionX, maxRegionX, minRegionY, maxRegionY;
+	getActiveRegions(minRegionX, maxRegionX, minRegionY, maxRegionY);
+	for (int regionX = minRegionX; regionX <= maxRegionX; regionX++) {
+		for (int regionY = minRegionY; regionY <= maxRegionY; regionY++) {
+			std::list<Flame> &flameList = regions[regionX][regionY].flames;
+			std::list<Flame>::iterator i;
+			for(i = flameList.begin(); i != flameList.end(); i++) {
+				i->particle->MoveTo(smh->getScreenX(i->x), smh->getScreenY(i->y), true);
+				smh->particlePool->render(i->particle);
+			}
+		}
 	}
 }
 
 /**
- * Updates all flames that have been created.
+ * Updates the flames near the screen. Flames further away are paused until
+ * they come back into range.
  */
 void SpecialTileManager::updateFlames(float dt) 
 {
-	std::list<Flame>::iterator i;
-	for(i = flameList.begin(); i != flameList.end(); i++) 
-	{
-		//Damage and knock the player back if they run into the fire
-		i->collisionBox->SetRadius(i->x, i->y, 20.0);
-		if (smh->player->collisionCircle->testBox(i->collisionBox)) 
-		{
-			smh->player->dealDamageAndKnockback(1.0, true, true, 100.0, i->x, i->y); 
-			smh->setDebugText("Smiley hit by Flame tile");
-		}
+	int minRegionX, maxRegionX, minRegionY, maxRegionY;
+	getActiveRegions(minRegionX, maxRegionX, minRegionY, maxRegionY);
+	for (int regionX = minRegionX; regionX <= maxRegionX; regionX++) {
+		for (int regionY = minRegionY; regionY <= maxRegionY; regionY++) {
+			std::list<Flame> &flameList = regions[regionX][regionY].flames;
+			numActiveTiles += flameList.size();
+			std::list<Flame>::iterator i = flameList.begin();
+			while (i != flameList.end()) 
+			{
+				//If the flame was paused, run its particle system forward so that it
+				//doesn't look like it just started burning
+				float pausedTime = smh->timePassedSince(i->lastUpdateTime) - dt;
+				if (pausedTime > FLAME_PAUSE_THRESHOLD) 
+				{
+					i->particle->MoveTo(smh->getScreenX(i->x), smh->getScreenY(i->y), true);
+					for (float t = 0.0; t < min(pausedTime, FLAME_FAST_FORWARD_TIME); t += FLAME_FAST_FORWARD_STEP) 
+					{
+						i->particle->Update(FLAME_FAST_FORWARD_STEP);
+					}
+				}
+				i->lastUpdateTime = smh->getGameTime();
 
-		//Flames are put out by ice breath. The flame isn't deleted yet so that
-		//the flame particle can animate to completion
-		if (i->timeFlamePutOut < 0.0 && smh->player->iceBreathParticle->testCollision(i->collisionBox)) 
-		{
-			i->timeFlamePutOut = smh->getGameTime();
-			i->particle->Stop();
-		}
+				//Damage and knock the player back if they run into the fire
+				i->collisionBox->SetRadius(i->x, i->y, 20.0);
+				if (smh->player->collisionCircle->testBox(i->collisionBox)) 
+				{
+					smh->player->dealDamageAndKnockback(1.0, true, true, 100.0, i->x, i->y); 
+					smh->setDebugText("Smiley hit by Flame tile");
+				}
 
-		//If the flame has been put out and is done animating, delete it
-		if (i->timeFlamePutOut > 0.0 && smh->timePassedSince(i->timeFlamePutOut) > 0.4) 
-		{
-			smh->environment->collision[Util::getGridX(i->x)][Util::getGridY(i->y)] = WALKABLE;
-			delete i->collisionBox;
-			delete i->particle;
-			i = flameList.erase(i);
-		}
-		else 
-		{
-			i->particle->Update(dt);
+				//Flames are put out by ice breath. The flame isn't deleted yet so that
+				//the flame particle can animate to completion
+				if (i->timeFlamePutOut < 0.0 && smh->player->iceBreathParticle->testCollision(i->collisionBox)) 
+				{
+					i->timeFlamePutOut = smh->getGameTime();
+					i->particle->Stop();
+				}
+
+				//If the flame has been put out and is done animating, delete it
+				if (i->timeFlamePutOut > 0.0 && smh->timePassedSince(i->timeFlamePutOut) > 0.4) 
+				{
+					smh->environment->collision(Util::getGridX(i->x), Util::getGridY(i->y)) = WALKABLE;
+					clearTileFlag(Util::getGridX(i->x), Util::getGridY(i->y), SpecialTileFlags::Flame);
+					delete i->collisionBox;
+					smh->particlePool->release(i->particle);
+					i = flameList.erase(i);
+					numTiles--;
+				}
+				else 
+				{
+					i->particle->Update(dt);
+					i++;
+				}
+			}
 		}
 	}
 }
@@ -451,13 +525,19 @@ void SpecialTileManager::updateFlames(float dt)
  * Deletes all flames that have been created.
  */
 void SpecialTileManager::resetFlames() {
-	std::list<Flame>::iterator i;
-	for(i = flameList.begin(); i != flameList.end(); i++) {
-		delete i->particle;
-		delete i->collisionBox;
-		i = flameList.erase(i);
+	for (int regionX = 0; regionX < SPECIAL_TILE_REGIONS_X; regionX++) {
+		for (int regionY = 0; regionY < SPECIAL_TILE_REGIONS_Y; regionY++) {
+			std::list<Flame> &flameList = regions[regionX][regionY].flames;
+			numTiles -= flameList.size();
+			std::list<Flame>::iterator i = flameList.begin();
+			while (i != flameList.end()) {
+				clearTileFlag(Util::getGridX(i->x), Util::getGridY(i->y), SpecialTileFlags::Flame);
+				smh->particlePool->release(i->particle);
+				delete i->collisionBox;
+				i = flameList.erase(i);
+			}
+		}
 	}
-	flameList.clear();
 }
 
 
@@ -480,59 +560,77 @@ void SpecialTileManager::addMushroom(int _gridX, int _gridY, int _graphicsIndex)
 
     newMushroom.graphicsIndex = _graphicsIndex;
 
-	theMushrooms.push_back(newMushroom);
+	getRegion(_gridX, _gridY)->mushrooms.push_back(newMushroom);
+	setTileFlag(_gridX, _gridY, SpecialTileFlags::Mushroom);
+	numTiles++;
 }
 
 void SpecialTileManager::drawMushrooms (float dt) {
-	std::list<Mushroom>::iterator i;
-	for(i = theMushrooms.begin(); i != theMushrooms.end(); i++) {
-		switch (i->state) {
-			case MUSHROOM_STATE_IDLING:
-				smh->resources->GetAnimation("walkLayer")->SetFrame(i->graphicsIndex);
-				smh->resources->GetAnimation("walkLayer")->Render(smh->getScreenX(i->x),smh->getScreenY(i->y));
-				if (smh->isDebugOn()) i->mushroomCollisionCircle->draw();
-				break;
-			case MUSHROOM_STATE_EXPLODING:
-				break;
-			case MUSHROOM_STATE_GROWING:
-				//temporarily change the hot spot of the graphic so it grows from the center
-				smh->resources->GetAnimation("walkLayer")->SetFrame(i->graphicsIndex);
-				smh->resources->GetAnimation("walkLayer")->SetHotSpot(32.0,32.0);
+	int minRegionX, maxRegionX, minRegionY, maxRegionY;
+	getActiveRegions(minRegionX, maxRegionX, minRegionY, maxRegionY);
+	for (int regionX = minRegionX; regionX <= maxRegionX; regionX++) {
+		for (int regionY = minRegionY; regionY <= maxRegionY; regionY++) {
+			std::list<Mushroom> &theMushrooms = regions[regionX][regionY].mushrooms;
+			std::list<Mushroom>::iterator i;
+			for(i = theMushrooms.begin(); i != theMushrooms.end(); i++) {
+				switch (i->state) {
+					case MUSHROOM_STATE_IDLING:
+						smh->resources->GetAnimation("walkLayer")->SetFrame(i->graphicsIndex);
+						smh->resources->GetAnimation("walkLayer")->Render(smh->getScreenX(i->x),smh->getScreenY(i->y));
+						if (smh->isDebugOn()) i->mushroomCollisionCircle->draw();
+						break;
+					case MUSHROOM_STATE_EXPLODING:
+						break;
+					case MUSHROOM_STATE_GROWING:
+						//temporarily change the hot spot of the graphic so it grows from the center
+						smh->resources->GetAnimation("walkLayer")->SetFrame(i->graphicsIndex);
+						smh->resources->GetAnimation("walkLayer")->SetHotSpot(32.0,32.0);
 				
-				//Calculate size to draw it, then draw it
-				float percentage = smh->timePassedSince(i->beginGrowTime) / MUSHROOM_GROW_TIME;
-				percentage = min(percentage, 1.0); //Cap the size at 1 to prevent it from "overgrowing"
-				smh->resources->GetAnimation("walkLayer")->RenderEx((int)smh->getScreenX(i->x+32),(int)smh->getScreenY(i->y+32),0.0,percentage,percentage);
-
-				//change hot spot back
-                smh->resources->GetAnimation("walkLayer")->SetHotSpot(0.0,0.0);
-				break;
-		};
+						//Calculate size to draw it, then draw it
+						float percentage = smh->timePassedSince(i->beginGrowTime) / MUSHROOM_GROW_TIME;
+						percentage = min(percentage, 1.0); //Cap the size at 1 to prevent it from "overgrowing"
+						smh->resources->GetAnimation("walkLayer")->RenderEx((int)smh->getScreenX(i->x+32),(int)smh->getScreenY(i->y+32),0.0,percentage,percentage);
+
+						//change hot spot back
+		                smh->resources->GetAnimation("walkLayer")->SetHotSpot(0.0,0.0);
+						break;
+				};
+			}
+		}
 	}
 }
 
 void SpecialTileManager::updateMushrooms(float dt) {
 
-	std::list<Mushroom>::iterator i;
-	for(i = theMushrooms.begin(); i != theMushrooms.end(); i++) {
-		switch (i->state) {
-			case MUSHROOM_STATE_IDLING:
-				if (i->mushroomCollisionCircle->testCircle(smh->player->collisionCircle) && !smh->player->isFlashing()) {
-					i->state = MUSHROOM_STATE_EXPLODING;
-					i->beginExplodeTime = smh->getGameTime();
-					smh->explosionManager->addExplosion(i->x+32.0, i->y+32.0, 0.75, MUSHROOM_EXPLOSION_DAMAGE, MUSHROOM_EXPLOSION_KNOCKBACK);
-                }
-				break;
-			case MUSHROOM_STATE_EXPLODING:
-				if (smh->timePassedSince(i->beginExplodeTime) > MUSHROOM_EXPLODE_TIME) {
-					i->beginGrowTime = smh->getGameTime();
-					i->state = MUSHROOM_STATE_GROWING;					
-				}
-				break;
-			case MUSHROOM_STATE_GROWING:
-				if (smh->timePassedSince(i->beginGrowTime) > MUSHROOM_GROW_TIME) {
-					i->state = MUSHROOM_STATE_IDLING;
+	int minRegionX, maxRegionX, minRegionY, maxRegionY;
+	getActiveRegions(minRegionX, maxRegionX, minRegionY, maxRegionY);
+	for (int regionX = minRegionX; regionX <= maxRegionX; regionX++) {
+		for (int regionY = minRegionY; regionY <= maxRegionY; regionY++) {
+			std::list<Mushroom> &theMushrooms = regions[regionX][regionY].mushrooms;
+			numActiveTiles += theMushrooms.size();
+			std::list<Mushroom>::iterator i;
+			for(i = theMushrooms.begin(); i != theMushrooms.end(); i++) {
+				switch (i->state) {
+					case MUSHROOM_STATE_IDLING:
+						if (i->mushroomCollisionCircle->testCircle(smh->player->collisionCircle) && !smh->player->isFlashing()) {
+							i->state = MUSHROOM_STATE_EXPLODING;
+							i->beginExplodeTime = smh->getGameTime();
+							smh->explosionManager->addExplosion(i->x+32.0, i->y+32.0, 0.75, MUSHROOM_EXPLOSION_DAMAGE, MUSHROOM_EXPLOSION_KNOCKBACK);
+		                }
+						break;
+					case MUSHROOM_STATE_EXPLODING:
+						if (smh->timePassedSince(i->beginExplodeTime) > MUSHROOM_EXPLODE_TIME) {
+							//Go by when it should have started growing since it may have been paused
+							i->beginGrowTime = i->beginExplodeTime + MUSHROOM_EXPLODE_TIME;
+							i->state = MUSHROOM_STATE_GROWING;					
+						}
+						break;
+					case MUSHROOM_STATE_GROWING:
+						if (smh->timePassedSince(i->beginGrowTime) > MUSHROOM_GROW_TIME) {
+							i->state = MUSHROOM_STATE_IDLING;
+						}
 				}
+			}
 		}
 	}
 }
@@ -541,12 +639,18 @@ void SpecialTileManager::updateMushrooms(float dt) {
  * Deletes all mushrooms that have been created.
  */
 void SpecialTileManager::resetMushrooms() {
-	std::list<Mushroom>::iterator i;
-	for(i = theMushrooms.begin(); i != theMushrooms.end(); i++) {
-		delete i->mushroomCollisionCircle;
-		i = theMushrooms.erase(i);
+	for (int regionX = 0; regionX < SPECIAL_TILE_REGIONS_X; regionX++) {
+		for (int regionY = 0; regionY < SPECIAL_TILE_REGIONS_Y; regionY++) {
+			std::list<Mushroom> &theMushrooms = regions[regionX][regionY].mushrooms;
+			numTiles -= theMushrooms.size();
+			std::list<Mushroom>::iterator i = theMushrooms.begin();
+			while (i != theMushrooms.end()) {
+				clearTileFlag(i->gridX, i->gridY, SpecialTileFlags::Mushroom);
+				delete i->mushroomCollisionCircle;
+				i = theMushrooms.erase(i);
+			}
+		}
 	}
-	theMushrooms.clear();
 }
 
 //////////// Warp Functions //////////////
@@ -589,6 +693,87 @@ void SpecialTileManager::resetWarps()
 	warpList.clear();
 }
 
+//////////// Region Functions //////////////
+
+/**
+ * Returns the region that a square's flames, mushrooms and ice blocks are kept in.
+ */
+SpecialTileRegion *SpecialTileManager::getRegion(int gridX, int gridY) {
+	int regionX = max(0, min(SPECIAL_TILE_REGIONS_X - 1, gridX / SPECIAL_TILE_REGION_WIDTH));
+	int regionY = max(0, min(SPECIAL_TILE_REGIONS_Y - 1, gridY / SPECIAL_TILE_REGION_HEIGHT));
+	return &regions[regionX][regionY];
+}
+
+/**
+ * Gets the range of regions that overlap the screen plus a margin. Only these
+ * are updated and drawn.
+ */
+void SpecialTileManager::getActiveRegions(int &minRegionX, int &maxRegionX, int &minRegionY, int &maxRegionY) {
+	int minX = max(0, smh->environment->xGridOffset - SPECIAL_TILE_REGION_MARGIN);
+	int maxX = max(0, smh->environment->xGridOffset + smh->environment->screenWidth + SPECIAL_TILE_REGION_MARGIN);
+	int minY = max(0, smh->environment->yGridOffset - SPECIAL_TILE_REGION_MARGIN);
+	int maxY = max(0, smh->environment->yGridOffset + smh->environment->screenHeight + SPECIAL_TILE_REGION_MARGIN);
 
+	minRegionX = min(SPECIAL_TILE_REGIONS_X - 1, minX / SPECIAL_TILE_REGION_WIDTH);
+	maxRegionX = min(SPECIAL_TILE_REGIONS_X - 1, maxX / SPECIAL_TILE_REGION_WIDTH);
+	minRegionY = min(SPECIAL_TILE_REGIONS_Y - 1, minY / SPECIAL_TILE_REGION_HEIGHT);
+	maxRegionY = min(SPECIAL_TILE_REGIONS_Y - 1, maxY / SPECIAL_TILE_REGION_HEIGHT);
+}
 
+/**
+ * Returns the number of flames, mushrooms and ice blocks updated last frame.
+ */
+int SpecialTileManager::getNumActiveTiles() {
+	return numActiveTiles;
+}
 
+/**
+ * Returns the number of flames, mushrooms and ice blocks in the area.
+ */
+int SpecialTileManager::getNumTiles() {
+	return numTiles;
+}
+
+//////////// Tile Flag Functions //////////////
+
+bool SpecialTileManager::isIceBlockAt(int gridX, int gridY) {
+	return hasTileFlag(gridX, gridY, SpecialTileFlags::IceBlock);
+}
+
+bool SpecialTileManager::isFlameAt(int gridX, int gridY) {
+	return hasTileFlag(gridX, gridY, SpecialTileFlags::Flame);
+}
+
+bool SpecialTileManager::isMushroomAt(int gridX, int gridY) {
+	return hasTileFlag(gridX, gridY, SpecialTileFlags::Mushroom);
+}
+
+bool SpecialTileManager::hasTileFlag(int gridX, int gridY, int flag) {
+	if (gridX < 0 || gridX >= 256 || gridY < 0 || gridY >= 256) return false;
+	return (tileFlags[gridX][gridY] & flag) != 0;
+}
+
+void SpecialTileManager::setTileFlag(int gridX, int gridY, int flag) {
+	if (gridX < 0 || gridX >= 256 || gridY < 0 || gridY >= 256) return;
+	tileFlags[gridX][gridY] |= flag;
+}
+
+void SpecialTileManager::clearTileFlag(int gridX, int gridY, int flag) {
+	if (gridX < 0 || gridX >= 256 || gridY < 0 || gridY >= 256) return;
+	tileFlags[gridX][gridY] &= ~flag;
+}
+
+/**
+ * Silly pads can be stacked on the same square, so when one is removed the
+ * flag is only cleared if there isn't another one there.
+ */
+void SpecialTileManager::refreshSillyPadFlag(int gridX, int gridY) {
+	clearTileFlag(gridX, gridY, SpecialTileFlags::SillyPad);
+	std::list<SillyPad>::iterator i;
+	for(i = sillyPadList.begin(); i != sillyPadList.end(); i++) {
+		if (i->gridX == gridX && i->gridY == gridY) {
+			setTileFlag(gridX, gridY, SpecialTileFlags::SillyPad);
+			return;
+		}
+	}
+}
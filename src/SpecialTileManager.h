@@ -8,6 +8,19 @@ class hgeParticleManager;
 class hgeParticleSystem;
 class hgeRect;
 
+/**
+ * Bits kept for each square saying which special tiles are on it.
+ */
+class SpecialTileFlags
+{
+public:
+	static const int SillyPad = 1;
+	static const int TimedTile = 2;
+	static const int IceBlock = 4;
+	static const int Flame = 8;
+	static const int Mushroom = 16;
+};
+
 struct Mushroom {
 	int state;
 	
@@ -26,6 +39,7 @@ struct Flame {
 	hgeParticleSystem *particle;
 	hgeRect *collisionBox;
 	float timeFlamePutOut;
+	float lastUpdateTime;
 };
 
 struct SillyPad {
@@ -53,6 +67,21 @@ struct Warp {
 	float angle;
 };
 
+#define SPECIAL_TILE_REGION_WIDTH 16		//About a screen's worth of squares
+#define SPECIAL_TILE_REGION_HEIGHT 12
+#define SPECIAL_TILE_REGIONS_X 16
+#define SPECIAL_TILE_REGIONS_Y 22
+#define SPECIAL_TILE_REGION_MARGIN 2		//Squares past the edge of the screen that are still updated
+
+/**
+ * The flames, mushrooms and ice blocks in one screen sized block of the area.
+ */
+struct SpecialTileRegion {
+	std::list<Flame> flames;
+	std::list<Mushroom> mushrooms;
+	std::list<IceBlock> iceBlocks;
+};
+
 class SpecialTileManager {
 
 public:
@@ -95,21 +124,40 @@ public:
 	void drawIceBlocks(float dt);
 	void resetIceBlocks();
 
+	bool isIceBlockAt(int gridX, int gridY);
+	bool isFlameAt(int gridX, int gridY);
+	bool isMushroomAt(int gridX, int gridY);
+
+	int getNumActiveTiles();
+	int getNumTiles();
+
 	void addWarp(int gridX, int gridY, int warpTile);
 	void updateWarps(float dt);
 	void drawWarps(float dt);
 	void resetWarps();
 
 	//Variables		
-	std::list<Flame> flameList;
 	std::list<SillyPad> sillyPadList;
-	std::list<Mushroom> theMushrooms;
-	std::list<IceBlock> iceBlockList;
 	std::list<TimedTile> timedTileList;
 	std::list<Warp> warpList;
 
 	hgeRect *collisionBox;	//general purpose collision box
 
+private:
+
+	SpecialTileRegion *getRegion(int gridX, int gridY);
+	void getActiveRegions(int &minRegionX, int &maxRegionX, int &minRegionY, int &maxRegionY);
+
+	bool hasTileFlag(int gridX, int gridY, int flag);
+	void setTileFlag(int gridX, int gridY, int flag);
+	void clearTileFlag(int gridX, int gridY, int flag);
+	void refreshSillyPadFlag(int gridX, int gridY);
+
+	SpecialTileRegion regions[SPECIAL_TILE_REGIONS_X][SPECIAL_TILE_REGIONS_Y];
+	int numTiles;
+	int numActiveTiles;
+	unsigned char tileFlags[256][256];	//SpecialTileFlags for each square so lookups don't have to search the lists
+
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,194 @@
+#include "SmileyEngine.h"
+#include <algorithm>
+#include <math.h>
+
+extern SMH *smh;
+
+#define NO_BLEND -1
+
+/**
+ * hgeSprite keeps the quad it renders to itself. Naming it through a subclass
+ * gives a member pointer that can read it out of any sprite, including the
+ * frame an hgeAnimation has moved its texture coordinates to.
+ */
+class SpriteQuad : public hgeSprite {
+public:
+	static hgeQuad hgeSprite::*member() { return &SpriteQuad::quad; }
+};
+
+//Sorted by layer, then texture and blend mode, keeping the order they were drawn in otherwise
+static bool compareQuads(const BatchedQuad &a, const BatchedQuad &b) {
+	if (a.layer != b.layer) return a.layer < b.layer;
+	if (a.quad.tex != b.quad.tex) return a.quad.tex < b.quad.tex;
+	if (a.quad.blend != b.quad.blend) return a.quad.blend < b.quad.blend;
+	return a.order < b.order;
+}
+
+SpriteBatch::SpriteBatch() {
+	section = -1;
+	sorting = false;
+	headless = false;
+	drawnTexture = sentTexture = 0;
+	drawnBlend = sentBlend = NO_BLEND;
+	resetStats();
+}
+
+SpriteBatch::~SpriteBatch() { }
+
+/**
+ * Counts what is drawn until endSection() towards a section of the frame.
+ */
+void SpriteBatch::beginSection(int _section) {
+	section = _section;
+	drawnTexture = sentTexture = 0;
+	drawnBlend = sentBlend = NO_BLEND;
+}
+
+void SpriteBatch::endSection() {
+	if (sorting) endSorted();
+	section = -1;
+}
+
+/**
+ * Holds back everything drawn until endSorted() so that it can be sent sorted.
+ * Only for things that don't overlap anything else in the same layer.
+ */
+void SpriteBatch::beginSorted() {
+	sorting = true;
+}
+
+void SpriteBatch::endSorted() {
+
+	sorting = false;
+	std::sort(held.begin(), held.end(), compareQuads);
+
+	for (int i = 0; i < (int)held.size(); i++) {
+		submit(held[i].quad);
+	}
+	held.clear();
+}
+
+void SpriteBatch::render(hgeSprite *sprite, float x, float y, int layer) {
+
+	hgeQuad quad;
+	setQuad(sprite, &quad);
+
+	float hotX, hotY;
+	sprite->GetHotSpot(&hotX, &hotY);
+	float x1 = x - hotX;
+	float y1 = y - hotY;
+	float x2 = x1 + sprite->GetWidth();
+	float y2 = y1 + sprite->GetHeight();
+
+	quad.v[0].x = x1; quad.v[0].y = y1;
+	quad.v[1].x = x2; quad.v[1].y = y1;
+	quad.v[2].x = x2; quad.v[2].y = y2;
+	quad.v[3].x = x1; quad.v[3].y = y2;
+
+	add(quad, layer);
+}
+
+/**
+ * Same as hgeSprite::RenderEx.
+ */
+void SpriteBatch::renderEx(hgeSprite *sprite, float x, float y, float rot, float hscale, float vscale, int layer) {
+
+	hgeQuad quad;
+	setQuad(sprite, &quad);
+
+	if (vscale == 0.0f) vscale = hscale;
+
+	float hotX, hotY;
+	sprite->GetHotSpot(&hotX, &hotY);
+	float x1 = -hotX * hscale;
+	float y1 = -hotY * vscale;
+	float x2 = (sprite->GetWidth() - hotX) * hscale;
+	float y2 = (sprite->GetHeight() - hotY) * vscale;
+
+	if (rot != 0.0f) {
+		float cost = cosf(rot);
+		float sint = sinf(rot);
+		quad.v[0].x = x1*cost - y1*sint + x; quad.v[0].y = x1*sint + y1*cost + y;
+		quad.v[1].x = x2*cost - y1*sint + x; quad.v[1].y = x2*sint + y1*cost + y;
+		quad.v[2].x = x2*cost - y2*sint + x; quad.v[2].y = x2*sint + y2*cost + y;
+		quad.v[3].x = x1*cost - y2*sint + x; quad.v[3].y = x1*sint + y2*cost + y;
+	} else {
+		quad.v[0].x = x1 + x; quad.v[0].y = y1 + y;
+		quad.v[1].x = x2 + x; quad.v[1].y = y1 + y;
+		quad.v[2].x = x2 + x; quad.v[2].y = y2 + y;
+		quad.v[3].x = x1 + x; quad.v[3].y = y2 + y;
+	}
+
+	add(quad, layer);
+}
+
+void SpriteBatch::renderStretch(hgeSprite *sprite, float x1, float y1, float x2, float y2, int layer) {
+
+	hgeQuad quad;
+	setQuad(sprite, &quad);
+
+	quad.v[0].x = x1; quad.v[0].y = y1;
+	quad.v[1].x = x2; quad.v[1].y = y1;
+	quad.v[2].x = x2; quad.v[2].y = y2;
+	quad.v[3].x = x1; quad.v[3].y = y2;
+
+	add(quad, layer);
+}
+
+/**
+ * Copies the sprite's texture, texture coordinates, colors, z and blend mode.
+ */
+void SpriteBatch::setQuad(hgeSprite *sprite, hgeQuad *quad) {
+	*quad = sprite->*SpriteQuad::member();
+}
+
+void SpriteBatch::add(const hgeQuad &quad, int layer) {
+
+	if (section >= 0) {
+		stats[section].quads++;
+		count(quad, &drawnTexture, &drawnBlend, &stats[section].drawnBatches, &stats[section].drawnSwitches);
+	}
+
+	if (sorting) {
+		BatchedQuad batched;
+		batched.quad = quad;
+		batched.layer = layer;
+		batched.order = (int)held.size();
+		held.push_back(batched);
+	} else {
+		submit(quad);
+	}
+}
+
+void SpriteBatch::submit(const hgeQuad &quad) {
+	if (section >= 0) {
+		count(quad, &sentTexture, &sentBlend, &stats[section].batches, &stats[section].switches);
+	}
+	if (!headless) smh->hge->Gfx_RenderQuad(&quad);
+}
+
+/**
+ * A new batch starts whenever the texture or blend mode is different from the
+ * last quad's.
+ */
+void SpriteBatch::count(const hgeQuad &quad, HTEXTURE *lastTexture, int *lastBlend, int *batches, int *switches) {
+	if (quad.tex != *lastTexture || *lastBlend == NO_BLEND) (*switches)++;
+	if (quad.tex != *lastTexture || quad.blend != *lastBlend) (*batches)++;
+	*lastTexture = quad.tex;
+	*lastBlend = quad.blend;
+}
+
+/**
+ * While headless nothing is sent to HGE, only counted.
+ */
+void SpriteBatch::setHeadless(bool _headless) {
+	headless = _headless;
+}
+
+void SpriteBatch::resetStats() {
+	memset(stats, 0, sizeof(stats));
+}
+
+const BatchStats &SpriteBatch::getStats(int section) {
+	return stats[section];
+}
@@ -0,0 +1,189 @@
+#include "SmileyEngine.h"
+
+extern SMH *smh;
+
+StartupTasks::StartupTasks() {
+	InitializeCriticalSection(&lock);
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&startTime);
+	numTasks = 0;
+	started = false;
+}
+
+StartupTasks::~StartupTasks() {
+	finish();
+	for (int i = 0; i < numTasks; i++) {
+		CloseHandle(tasks[i].doneEvent);
+	}
+	DeleteCriticalSection(&lock);
+}
+
+/**
+ * Adds a task that calls function(context, param). Tasks can only be added
+ * before start(). Returns the task's number for addDependency() and waitFor().
+ */
+int StartupTasks::add(std::string name, StartupTaskFunction function, void *context, int param) {
+
+	if (numTasks >= MAX_STARTUP_TASKS) {
+		throw new System::Exception(new System::String("StartupTasks::add(): too many startup tasks"));
+	}
+
+	StartupTask *task = &tasks[numTasks];
+	task->name = name;
+	task->function = function;
+	task->context = context;
+	task->param = param;
+	task->numDependencies = 0;
+	task->state = StartupTaskStates::Waiting;
+	task->worker = 0;
+	task->doneEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+
+	return numTasks++;
+}
+
+/**
+ * Makes task wait until dependency is done before it starts.
+ */
+void StartupTasks::addDependency(int task, int dependency) {
+	if (tasks[task].numDependencies >= MAX_TASK_DEPENDENCIES) {
+		throw new System::Exception(new System::String("StartupTasks::addDependency(): too many dependencies"));
+	}
+	tasks[task].dependencies[tasks[task].numDependencies++] = dependency;
+}
+
+/**
+ * Starts running the tasks on the worker threads. Each worker keeps taking
+ * whichever task is ready next until none are left waiting.
+ */
+void StartupTasks::start() {
+
+	QueryPerformanceCounter(&startTime);
+	if (!smh->hge->Ini_GetInt("Debug", "startupTasks", 1)) return;
+
+	int numRunners = min(numTasks, smh->workerPool->getDefaultWorkers());
+	smh->workerPool->start(runnerJob, this, numRunners, numRunners);
+	started = true;
+
+}
+
+/**
+ * Returns once a task is done, running it and anything it depends on here if
+ * no worker has started on them yet.
+ */
+void StartupTasks::waitFor(int task) {
+
+	for (int i = 0; i < tasks[task].numDependencies; i++) {
+		waitFor(tasks[task].dependencies[i]);
+	}
+
+	EnterCriticalSection(&lock);
+	bool runHere = tasks[task].state == StartupTaskStates::Waiting;
+	if (runHere) tasks[task].state = StartupTaskStates::Running;
+	LeaveCriticalSection(&lock);
+
+	if (runHere) {
+		runTask(task, 0);
+	} else {
+		WaitForSingleObject(tasks[task].doneEvent, INFINITE);
+	}
+
+}
+
+/**
+ * Waits for every task and for the workers to go back to the pool.
+ */
+void StartupTasks::finish() {
+	for (int i = 0; i < numTasks; i++) {
+		waitFor(i);
+	}
+	if (started) {
+		smh->workerPool->finish();
+		started = false;
+	}
+}
+
+/**
+ * Returns whether every task is done.
+ */
+bool StartupTasks::isFinished() {
+	EnterCriticalSection(&lock);
+	bool finished = true;
+	for (int i = 0; i < numTasks; i++) {
+		if (tasks[i].state != StartupTaskStates::Done) finished = false;
+	}
+	LeaveCriticalSection(&lock);
+	return finished;
+}
+
+/**
+ * Writes when each task started and finished, counted from start(), and which
+ * worker ran it.
+ */
+void StartupTasks::write() {
+	smh->logger->write(LogLevels::Info, LogCategories::Engine, "Startup tasks:");
+	for (int i = 0; i < numTasks; i++) {
+		smh->logger->write(LogLevels::Info, LogCategories::Engine, "  %-24s %8.1f to %8.1f ms  %s %d", tasks[i].name.c_str(),
+			(double)(tasks[i].startTime.QuadPart - startTime.QuadPart) * 1000.0 / (double)frequency.QuadPart,
+			(double)(tasks[i].endTime.QuadPart - startTime.QuadPart) * 1000.0 / (double)frequency.QuadPart,
+			tasks[i].worker == 0 ? "main thread" : "worker", tasks[i].worker);
+	}
+}
+
+void StartupTasks::runnerJob(void *context, int job, int worker) {
+
+	StartupTasks *startupTasks = (StartupTasks*)context;
+
+	for (;;) {
+		bool noneWaiting;
+		int task = startupTasks->takeReadyTask(&noneWaiting);
+		if (task >= 0) {
+			startupTasks->runTask(task, worker);
+		} else if (noneWaiting) {
+			break;
+		} else {
+			//Everything left is waiting on a task that is still running
+			Sleep(1);
+		}
+	}
+
+}
+
+/**
+ * Marks the first waiting task whose dependencies are all done as running and
+ * returns it, or -1 if there isn't one.
+ */
+int StartupTasks::takeReadyTask(bool *noneWaiting) {
+
+	EnterCriticalSection(&lock);
+	*noneWaiting = true;
+	for (int i = 0; i < numTasks; i++) {
+		if (tasks[i].state != StartupTaskStates::Waiting) continue;
+		*noneWaiting = false;
+		bool ready = true;
+		for (int j = 0; j < tasks[i].numDependencies; j++) {
+			if (tasks[tasks[i].dependencies[j]].state != StartupTaskStates::Done) ready = false;
+		}
+		if (ready) {
+			tasks[i].state = StartupTaskStates::Running;
+			LeaveCriticalSection(&lock);
+			return i;
+		}
+	}
+	LeaveCriticalSection(&lock);
+
+	return -1;
+}
+
+void StartupTasks::runTask(int task, int worker) {
+
+	QueryPerformanceCounter(&tasks[task].startTime);
+	tasks[task].function(tasks[task].context, tasks[task].param);
+	QueryPerformanceCounter(&tasks[task].endTime);
+	tasks[task].worker = worker;
+
+	EnterCriticalSection(&lock);
+	tasks[task].state = StartupTaskStates::Done;
+	LeaveCriticalSection(&lock);
+	SetEvent(tasks[task].doneEvent);
+
+}
@@ -0,0 +1,40 @@
+#include "SmileyEngine.h"
+
+extern SMH *smh;
+
+StartupTimeline::StartupTimeline() {
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&startTime);
+	stageStartTime = startTime;
+}
+
+void StartupTimeline::beginStage(const char *name) {
+	StartupStage stage;
+	stage.name = name;
+	stage.ms = 0.0;
+	stages.push_back(stage);
+	QueryPerformanceCounter(&stageStartTime);
+}
+
+void StartupTimeline::endStage() {
+	LARGE_INTEGER now;
+	QueryPerformanceCounter(&now);
+	stages.back().ms = (double)(now.QuadPart - stageStartTime.QuadPart) * 1000.0 / (double)frequency.QuadPart;
+}
+
+/**
+ * Writes how long each stage took and the total to the log.
+ */
+void StartupTimeline::write() {
+
+	LARGE_INTEGER now;
+	QueryPerformanceCounter(&now);
+
+	smh->logger->write(LogLevels::Info, LogCategories::Engine, "Startup timeline:");
+	for (std::vector<StartupStage>::iterator i = stages.begin(); i != stages.end(); i++) {
+		smh->logger->write(LogLevels::Info, LogCategories::Engine, "  %-24s %8.1f ms", i->name, i->ms);
+	}
+	smh->logger->write(LogLevels::Info, LogCategories::Engine, "  %-24s %8.1f ms", "Total",
+		(double)(now.QuadPart - startTime.QuadPart) * 1000.0 / (double)frequency.QuadPart);
+
+}
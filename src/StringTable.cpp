@@ -0,0 +1,91 @@
+#include "SmileyPrimitives.h"
+#include <stdio.h>
+#include <ctype.h>
+
+StringTable::StringTable() { }
+
+/**
+ * Reads a string table the same way HGE does: name="value" pairs with ;
+ * comments, \n and \" escapes, and line breaks inside a value turned into
+ * single spaces. Later names hide earlier ones. Doesn't touch SMH or HGE, so
+ * it is safe to call from a worker thread. Returns whether the file was read.
+ */
+bool StringTable::load(const char *fileName) {
+
+	strings.clear();
+
+	FILE *file = fopen(fileName, "rb");
+	if (!file) return false;
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	std::vector<char> text(size + 1);
+	size = (long)fread(&text[0], 1, size, file);
+	text[size] = 0;
+	fclose(file);
+
+	if (strncmp(&text[0], STRING_TABLE_HEADER, strlen(STRING_TABLE_HEADER)) != 0) return false;
+
+	const char *p = &text[0] + strlen(STRING_TABLE_HEADER);
+	std::string name, value;
+
+	for (;;) {
+
+		while (isspace(*p)) p++;
+		if (!*p) break;
+
+		if (*p == ';') {
+			while (*p && *p != '\n') p++;
+			continue;
+		}
+
+		name.clear();
+		while (*p && *p != '=' && !isspace(*p)) {
+			name += *p++;
+		}
+
+		while (isspace(*p)) p++;
+		if (*p != '=') break;
+		p++;
+		while (isspace(*p)) p++;
+		if (*p != '"') break;
+		p++;
+
+		value.clear();
+		while (*p && *p != '"') {
+			if (*p == '\n' || *p == '\r') {
+				while (isspace(*p)) p++;
+				while (!value.empty() && isspace(value[value.size() - 1])) value.erase(value.size() - 1);
+				value += ' ';
+			} else if (*p == '\\') {
+				p++;
+				if (!*p) break;
+				value += (*p == 'n') ? '\n' : *p;
+				p++;
+			} else {
+				value += *p++;
+			}
+		}
+
+		strings[name] = value;
+
+		if (!*p) break;
+		p++;
+	}
+
+	return true;
+
+}
+
+/**
+ * Returns the value for name, or 0 if there isn't one.
+ */
+const char *StringTable::getString(const char *name) {
+	std::map<std::string, std::string>::iterator i = strings.find(name);
+	if (i == strings.end()) return 0;
+	return i->second.c_str();
+}
+
+int StringTable::getNumStrings() {
+	return (int)strings.size();
+}
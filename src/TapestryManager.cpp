@@ -12,7 +12,9 @@ extern SMH *smh;
  * Constructor
  */
 TapestryManager::TapestryManager() {
-
+	for (int i = 0; i <= MAX_TAPESTRY_GRANULARITY; i++) {
+		waves[i] = NULL;
+	}
 }
 
 TapestryManager::~TapestryManager() {
@@ -36,6 +38,8 @@ void TapestryManager::addTapestry(int gridX, int gridY, int id) {
 			newTapestry.distortion->SetTexture(smh->resources->GetTexture("general"));
 			newTapestry.distortion->SetTextureRect(449,129,190,254);
 			newTapestry.granularity = 8;
+			newTapestry.width = 190.0;
+			newTapestry.height = 254.0;
 			break;
 
 		default:
@@ -44,6 +48,8 @@ void TapestryManager::addTapestry(int gridX, int gridY, int id) {
 			newTapestry.distortion->SetTexture(smh->resources->GetTexture("itemLayer1"));
 			newTapestry.distortion->SetTextureRect((id-16)*64 + 1,65,62,62);
 			newTapestry.granularity = 4;
+			newTapestry.width = 62.0;
+			newTapestry.height = 62.0;
 	}
 	
 	newTapestry.distortion->SetBlendMode(BLEND_COLORADD | BLEND_ALPHABLEND | BLEND_ZWRITE);
@@ -53,32 +59,46 @@ void TapestryManager::addTapestry(int gridX, int gridY, int id) {
 }
 
 /**
- * Draws all managed tapestries.
+ * Draws all managed tapestries that are on the screen.
  */
 void TapestryManager::draw(float dt) {
 	std::list<Tapestry>::iterator i;
 	for (i = tapestryList.begin(); i != tapestryList.end(); i++) {
-		i->distortion->Render(smh->getScreenX(i->x), smh->getScreenY(i->y));
+		if (smh->isOnScreen(i->x, i->y, i->width, i->height)) {
+			i->distortion->Render(smh->getScreenX(i->x), smh->getScreenY(i->y));
+		}
 	}
 }
 
 /**
- * Updates all managed tapestries.
+ * Updates all managed tapestries that are on the screen. Every tapestry of the
+ * same granularity waves the same way, so each wave is only worked out once.
  */
 void TapestryManager::update(float dt) {
 	std::list<Tapestry>::iterator i;
 	for (i = tapestryList.begin(); i != tapestryList.end(); i++) {
-		for (int x = 0; x < i->granularity; x++) {
-			for(int y = 1; y < i->granularity; y++) {
-				i->distortion->SetDisplacement(
-					x, //column
-					y, //row
-					cosf(smh->getGameTime()*2.0+y*4.0/i->granularity)*0.5*y, //dx
-					sinf(smh->getGameTime()*3.0+(x+y)/2)*2, //dy					
-					HGEDISP_NODE); //reference
+		if (smh->isOnScreen(i->x, i->y, i->width, i->height)) {
+			MeshWave *wave = getWave(i->granularity);
+			wave->update(smh->getGameTime());
+			wave->apply(i->distortion);
+		}
+	}
+}
+
+/**
+ * Returns the wave for tapestries of the given granularity, creating it the
+ * first time. The top row stays still so the tapestry looks like it's hanging.
+ */
+MeshWave *TapestryManager::getWave(int granularity) {
+	if (!waves[granularity]) {
+		waves[granularity] = new MeshWave(granularity, granularity, 2.0, 3.0);
+		for (int x = 0; x < granularity; x++) {
+			for(int y = 1; y < granularity; y++) {
+				waves[granularity]->setNode(x, y, y*4.0/granularity, 0.5*y, (x+y)/2, 2.0);
 			}
 		}
 	}
+	return waves[granularity];
 }
 
 /**
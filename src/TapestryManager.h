@@ -6,11 +6,15 @@
 
 class hgeRect;
 class hgeDistortionMesh;
+class MeshWave;
+
+#define MAX_TAPESTRY_GRANULARITY 8
 
 struct Tapestry {
 	hgeDistortionMesh *distortion;
 	int granularity;
 	float x, y;
+	float width, height;
 };
 
 class TapestryManager {
@@ -28,6 +32,12 @@ public:
 	//Variables
 	std::list<Tapestry> tapestryList;
 
+private:
+
+	MeshWave *getWave(int granularity);
+
+	MeshWave *waves[MAX_TAPESTRY_GRANULARITY + 1];	//Shared by all tapestries of each granularity
+
 };
 
 #endif
\ No newline at end of file
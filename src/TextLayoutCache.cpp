@@ -0,0 +1,252 @@
+#include "SmileyEngine.h"
+#include "hgefont.h"
+
+extern SMH *smh;
+
+#define TEXT_BUFFER_SIZE 1024		//Same as hgeFont's buffer so long strings are cut off in the same place
+
+TextLayoutCache::TextLayoutCache() {
+	numLayouts = 0;
+	useCounter = 0;
+}
+
+TextLayoutCache::~TextLayoutCache() { }
+
+/**
+ * Draws text word wrapped to fit in a box, the same as hgeFont::printfb(x, y, w, h, align, "%s", text).
+ */
+void TextLayoutCache::printfb(hgeFont *font, float x, float y, float w, float h, int align, const char *text) {
+	if (font->GetRotation() != 0.0) {
+		font->printfb(x, y, w, h, align, "%s", text);
+		return;
+	}
+	render(getLayout(font, w, h, align, text), x, y);
+}
+
+/**
+ * Draws text without wrapping it, the same as hgeFont::printf(x, y, align, "%s", text).
+ */
+void TextLayoutCache::print(hgeFont *font, float x, float y, int align, const char *text) {
+	if (font->GetRotation() != 0.0) {
+		font->printf(x, y, align, "%s", text);
+		return;
+	}
+	render(getLayout(font, TEXT_LAYOUT_NO_WRAP, TEXT_LAYOUT_NO_WRAP, align, text), x, y);
+}
+
+/**
+ * Returns the layout of some text, laying it out if it isn't in the cache. When the
+ * cache is full the layout that was used least recently is replaced.
+ */
+TextLayout *TextLayoutCache::getLayout(hgeFont *font, float w, float h, int align, const char *text) {
+
+	//FNV-1a hash of the text
+	DWORD hash = 2166136261;
+	for (const char *c = text; *c; c++) {
+		hash = (hash ^ (unsigned char)*c) * 16777619;
+	}
+
+	useCounter++;
+
+	for (int i = 0; i < numLayouts; i++) {
+		TextLayout *layout = &layouts[i];
+		if (layout->hash == hash && layout->font == font && layout->width == w && layout->height == h &&
+				layout->align == align && layout->scale == font->GetScale() && layout->proportion == font->GetProportion() &&
+				layout->tracking == font->GetTracking() && layout->spacing == font->GetSpacing() && layout->text == text) {
+			layout->lastUsed = useCounter;
+			return layout;
+		}
+	}
+
+	TextLayout *layout;
+	if (numLayouts < TEXT_LAYOUT_CACHE_SIZE) {
+		layout = &layouts[numLayouts++];
+	} else {
+		layout = &layouts[0];
+		for (int i = 1; i < numLayouts; i++) {
+			if (layouts[i].lastUsed < layout->lastUsed) layout = &layouts[i];
+		}
+	}
+
+	layout->font = font;
+	layout->text = text;
+	layout->width = w;
+	layout->height = h;
+	layout->align = align;
+	layout->scale = font->GetScale();
+	layout->proportion = font->GetProportion();
+	layout->tracking = font->GetTracking();
+	layout->spacing = font->GetSpacing();
+	layout->hash = hash;
+	layout->lastUsed = useCounter;
+
+	int numLines = wrap(layout);
+	buildGlyphs(layout, numLines);
+
+	return layout;
+}
+
+/**
+ * Breaks the text into lines that fit the layout's box. This is hgeFont::printfb's
+ * word wrapping so that the lines break in exactly the same places. Returns the
+ * number of lines.
+ */
+int TextLayoutCache::wrap(TextLayout *layout) {
+
+	char buffer[TEXT_BUFFER_SIZE];
+	strncpy(buffer, layout->text.c_str(), TEXT_BUFFER_SIZE - 1);
+	buffer[TEXT_BUFFER_SIZE - 1] = '\0';
+
+	if (layout->width == TEXT_LAYOUT_NO_WRAP) {
+		layout->wrappedText = buffer;
+		return 1;
+	}
+
+	char chr, *pbuf, *prevword, *linestart;
+	int i, lines = 0;
+	float ww;
+
+	linestart = buffer;
+	pbuf = buffer;
+	prevword = 0;
+
+	for (;;) {
+		i = 0;
+		while (pbuf[i] && pbuf[i] != ' ' && pbuf[i] != '\n') i++;
+
+		chr = pbuf[i];
+		pbuf[i] = 0;
+		ww = layout->font->GetStringWidth(linestart);
+		pbuf[i] = chr;
+
+		if (ww > layout->width) {
+			if (pbuf == linestart) {
+				pbuf[i] = '\n';
+				linestart = &pbuf[i+1];
+			} else {
+				*prevword = '\n';
+				linestart = prevword + 1;
+			}
+			lines++;
+		}
+
+		if (pbuf[i] == '\n') {
+			prevword = &pbuf[i];
+			linestart = &pbuf[i+1];
+			pbuf = &pbuf[i+1];
+			lines++;
+			continue;
+		}
+
+		if (!pbuf[i]) {
+			lines++;
+			break;
+		}
+
+		prevword = &pbuf[i];
+		pbuf = &pbuf[i+1];
+	}
+
+	layout->wrappedText = buffer;
+	return lines;
+}
+
+/**
+ * Works out the quad of every glyph the same way hgeFont::Render does, relative
+ * to the top left corner of the box.
+ */
+void TextLayoutCache::buildGlyphs(TextLayout *layout, int numLines) {
+
+	hgeFont *font = layout->font;
+	float hscale = layout->scale * layout->proportion;
+	float vscale = layout->scale;
+	int horizontalAlign = layout->align & HGETEXT_HORZMASK;
+
+	//Position of the text within the box
+	float tx = 0.0, ty = 0.0;
+	if (layout->width != TEXT_LAYOUT_NO_WRAP) {
+		float hh = font->GetHeight() * layout->spacing * layout->scale * numLines;
+		if (horizontalAlign == HGETEXT_RIGHT) tx += layout->width;
+		else if (horizontalAlign == HGETEXT_CENTER) tx += int(layout->width / 2);
+		if ((layout->align & HGETEXT_VERTMASK) == HGETEXT_BOTTOM) ty += layout->height - hh;
+		else if ((layout->align & HGETEXT_VERTMASK) == HGETEXT_MIDDLE) ty += int((layout->height - hh) / 2);
+	}
+
+	layout->glyphs.clear();
+	layout->texture = 0;
+
+	const char *string = layout->wrappedText.c_str();
+	float fx = tx;
+	float y = ty;
+	if (horizontalAlign == HGETEXT_RIGHT) fx -= font->GetStringWidth(string, false);
+	if (horizontalAlign == HGETEXT_CENTER) fx -= int(font->GetStringWidth(string, false) / 2.0f);
+
+	while (*string) {
+		if (*string == '\n') {
+			y += int(font->GetHeight() * layout->scale * layout->spacing);
+			fx = tx;
+			if (horizontalAlign == HGETEXT_RIGHT) fx -= font->GetStringWidth(string+1, false);
+			if (horizontalAlign == HGETEXT_CENTER) fx -= int(font->GetStringWidth(string+1, false) / 2.0f);
+		} else {
+			char c = *string;
+			hgeSprite *letter = font->GetSprite(c);
+			if (!letter) {
+				c = '?';
+				letter = font->GetSprite(c);
+			}
+			if (letter) {
+				fx += font->GetPreWidth(c) * hscale;
+
+				float sx, sy, sw, sh, hotX, hotY;
+				letter->GetTextureRect(&sx, &sy, &sw, &sh);
+				letter->GetHotSpot(&hotX, &hotY);
+				layout->texture = letter->GetTexture();
+				float texWidth = (float)smh->hge->Texture_GetWidth(layout->texture);
+				float texHeight = (float)smh->hge->Texture_GetHeight(layout->texture);
+
+				TextGlyph glyph;
+				glyph.x1 = fx - hotX * hscale;
+				glyph.y1 = y - hotY * vscale;
+				glyph.x2 = fx + (letter->GetWidth() - hotX) * hscale;
+				glyph.y2 = y + (letter->GetHeight() - hotY) * vscale;
+				glyph.u1 = sx / texWidth;
+				glyph.v1 = sy / texHeight;
+				glyph.u2 = (sx + sw) / texWidth;
+				glyph.v2 = (sy + sh) / texHeight;
+				layout->glyphs.push_back(glyph);
+
+				fx += (letter->GetWidth() + font->GetPostWidth(c) + layout->tracking) * hscale;
+			}
+		}
+		string++;
+	}
+
+}
+
+/**
+ * Sends a layout's glyphs to HGE with the font's current color, z and blend mode.
+ * They all share the font's texture so HGE draws them in one batch.
+ */
+void TextLayoutCache::render(TextLayout *layout, float x, float y) {
+
+	hgeQuad quad;
+	quad.tex = layout->texture;
+	quad.blend = layout->font->GetBlendMode();
+	for (int i = 0; i < 4; i++) {
+		quad.v[i].col = layout->font->GetColor();
+		quad.v[i].z = layout->font->GetZ();
+	}
+
+	for (std::vector<TextGlyph>::iterator i = layout->glyphs.begin(); i != layout->glyphs.end(); i++) {
+		quad.v[0].x = x + i->x1; quad.v[0].y = y + i->y1;
+		quad.v[1].x = x + i->x2; quad.v[1].y = y + i->y1;
+		quad.v[2].x = x + i->x2; quad.v[2].y = y + i->y2;
+		quad.v[3].x = x + i->x1; quad.v[3].y = y + i->y2;
+		quad.v[0].tx = i->u1; quad.v[0].ty = i->v1;
+		quad.v[1].tx = i->u2; quad.v[1].ty = i->v1;
+		quad.v[2].tx = i->u2; quad.v[2].ty = i->v2;
+		quad.v[3].tx = i->u1; quad.v[3].ty = i->v2;
+		smh->hge->Gfx_RenderQuad(&quad);
+	}
+
+}
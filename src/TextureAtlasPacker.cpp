@@ -0,0 +1,146 @@
+#include "SmileyEngine.h"
+#include <algorithm>
+
+#define PNG_HEADER_SIZE 24
+
+static int nextPowerOfTwo(int n) {
+	int power = 1;
+	while (power < n) power *= 2;
+	return power;
+}
+
+//Tallest first, then widest, within each atlas
+struct CompareTextures {
+	const std::vector<AtlasTexture> *textures;
+	bool operator()(int a, int b) const {
+		const AtlasTexture &ta = (*textures)[a];
+		const AtlasTexture &tb = (*textures)[b];
+		if (ta.atlas != tb.atlas) return ta.atlas < tb.atlas;
+		if (ta.height != tb.height) return ta.height > tb.height;
+		if (ta.width != tb.width) return ta.width > tb.width;
+		return a < b;
+	}
+};
+
+TextureAtlasPacker::TextureAtlasPacker(int _maxPageSize) {
+	maxPageSize = _maxPageSize;
+}
+
+void TextureAtlasPacker::add(int texture, int atlas, int width, int height, bool fullWidth) {
+	AtlasTexture t;
+	t.texture = texture;
+	t.atlas = atlas;
+	t.width = width;
+	t.height = height;
+	t.fullWidth = fullWidth;
+	t.page = -1;
+	t.x = t.y = 0;
+	textures.push_back(t);
+}
+
+/**
+ * Packs each atlas's textures onto its own pages.
+ */
+void TextureAtlasPacker::pack() {
+
+	std::vector<int> order;
+	for (int i = 0; i < (int)textures.size(); i++) {
+		order.push_back(i);
+	}
+	CompareTextures compare;
+	compare.textures = &textures;
+	std::sort(order.begin(), order.end(), compare);
+
+	pages.clear();
+	int start = 0;
+	while (start < (int)order.size()) {
+		int end = start;
+		while (end < (int)order.size() && textures[order[end]].atlas == textures[order[start]].atlas) end++;
+		packAtlas(std::vector<int>(order.begin() + start, order.begin() + end));
+		start = end;
+	}
+}
+
+/**
+ * Fills shelves left to right and pages top to bottom. If any of the textures
+ * have to be as wide as the page then the pages are that wide, otherwise they
+ * are shrunk to the smallest power of two that holds what went on them.
+ */
+void TextureAtlasPacker::packAtlas(const std::vector<int> &order) {
+
+	int pageWidth = maxPageSize;
+	bool fixedWidth = false;
+	for (int i = 0; i < (int)order.size() && !fixedWidth; i++) {
+		if (textures[order[i]].fullWidth) {
+			pageWidth = textures[order[i]].width;
+			fixedWidth = true;
+		}
+	}
+
+	int page = -1;
+	int shelfX = 0, shelfY = 0, shelfHeight = 0;
+	int usedWidth = 0, usedHeight = 0;
+
+	for (int i = 0; i < (int)order.size(); i++) {
+
+		AtlasTexture *t = &textures[order[i]];
+		if (t->width > pageWidth || t->height > maxPageSize || (t->fullWidth && t->width != pageWidth)) continue;
+
+		//Start a new shelf, and a new page if the shelf doesn't fit on this one
+		if (page < 0 || shelfX + t->width > pageWidth || t->fullWidth) {
+			shelfY += shelfHeight;
+			shelfX = 0;
+			shelfHeight = t->height;
+			if (page < 0 || shelfY + t->height > maxPageSize) {
+				if (page >= 0) {
+					pages[page].width = fixedWidth ? pageWidth : nextPowerOfTwo(usedWidth);
+					pages[page].height = nextPowerOfTwo(usedHeight);
+				}
+				ManifestAtlasPage newPage;
+				newPage.atlas = t->atlas;
+				newPage.width = newPage.height = 0;
+				pages.push_back(newPage);
+				page = (int)pages.size() - 1;
+				shelfY = 0;
+				usedWidth = usedHeight = 0;
+			}
+		}
+
+		t->page = page;
+		t->x = shelfX;
+		t->y = shelfY;
+		shelfX += t->fullWidth ? pageWidth : t->width;
+		if (shelfX > usedWidth) usedWidth = shelfX;
+		if (shelfY + t->height > usedHeight) usedHeight = shelfY + t->height;
+	}
+
+	if (page >= 0) {
+		pages[page].width = fixedWidth ? pageWidth : nextPowerOfTwo(usedWidth);
+		pages[page].height = nextPowerOfTwo(usedHeight);
+	}
+}
+
+const std::vector<AtlasTexture> &TextureAtlasPacker::getTextures() {
+	return textures;
+}
+
+const std::vector<ManifestAtlasPage> &TextureAtlasPacker::getPages() {
+	return pages;
+}
+
+/**
+ * Reads the width and height out of a PNG file's header.
+ */
+bool TextureAtlasPacker::readImageSize(const char *fileName, int *width, int *height) {
+
+	std::ifstream image(fileName, std::ios::in | std::ios::binary);
+	BYTE header[PNG_HEADER_SIZE];
+	if (!image.read((char*)header, PNG_HEADER_SIZE)) return false;
+
+	static const BYTE signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	if (memcmp(header, signature, 8) != 0 || memcmp(header + 12, "IHDR", 4) != 0) return false;
+
+	*width = (header[16] << 24) | (header[17] << 16) | (header[18] << 8) | header[19];
+	*height = (header[20] << 24) | (header[21] << 16) | (header[22] << 8) | header[23];
+	return true;
+}
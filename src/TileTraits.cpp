@@ -0,0 +1,72 @@
+#include "SmileyPrimitives.h"
+
+int TileTraits::table[256];
+
+static const int pits[] = { PIT, FAKE_PIT, NO_WALK_PIT };
+static const int lava[] = { WALK_LAVA, NO_WALK_LAVA };
+static const int deepWater[] = { DEEP_WATER, GREEN_WATER };
+static const int switchesLeft[] = { WHITE_SWITCH_LEFT, YELLOW_SWITCH_LEFT, GREEN_SWITCH_LEFT,
+	BLUE_SWITCH_LEFT, BROWN_SWITCH_LEFT, SILVER_SWITCH_LEFT };
+static const int switchesRight[] = { WHITE_SWITCH_RIGHT, YELLOW_SWITCH_RIGHT, GREEN_SWITCH_RIGHT,
+	BLUE_SWITCH_RIGHT, BROWN_SWITCH_RIGHT, SILVER_SWITCH_RIGHT };
+static const int cylindersDown[] = { WHITE_CYLINDER_DOWN, YELLOW_CYLINDER_DOWN, GREEN_CYLINDER_DOWN,
+	BLUE_CYLINDER_DOWN, BROWN_CYLINDER_DOWN, SILVER_CYLINDER_DOWN };
+static const int cylindersUp[] = { WHITE_CYLINDER_UP, YELLOW_CYLINDER_UP, GREEN_CYLINDER_UP,
+	BLUE_CYLINDER_UP, BROWN_CYLINDER_UP, SILVER_CYLINDER_UP };
+static const int arrowPads[] = { UP_ARROW, RIGHT_ARROW, DOWN_ARROW, LEFT_ARROW };
+static const int warps[] = { BLUE_WARP, RED_WARP, GREEN_WARP, YELLOW_WARP };
+static const int gayFix[] = { UP_ARROW, RIGHT_ARROW, DOWN_ARROW, LEFT_ARROW, SPRING_PAD, ICE, SUPER_SPRING, PIT };
+
+//Tiles with their own case in Environment::drawAnimatedCollision
+static const int animated[] = { SHALLOW_WATER, DEEP_WATER, NO_WALK_WATER, GREEN_WATER, SHALLOW_GREEN_WATER,
+	WALK_LAVA, NO_WALK_LAVA, SPRING_PAD, SUPER_SPRING, SPIN_ARROW_SWITCH, MIRROR_SWITCH, SHRINK_TUNNEL_SWITCH,
+	SAVE_SHRINE, EVIL_WALL_POSITION, EVIL_WALL_RESTART };
+
+//Tiles the environment doesn't draw anything for
+static const int notDrawn[] = { WALKABLE, UNWALKABLE, ENEMY_NO_WALK, PLAYER_START, DIZZY_MUSHROOM_1,
+	DIZZY_MUSHROOM_2, PLAYER_END, PIT, UNWALKABLE_PROJECTILE, FAKE_PIT, FLAME, NO_WALK_PIT, FIRE_DESTROY,
+	FAKE_COLLISION, FOUNTAIN, RED_WARP, BLUE_WARP, YELLOW_WARP, GREEN_WARP };
+
+static const int projectileBlocking[] = { UNWALKABLE, SIGN, FOUNTAIN, SAVE_SHRINE, RED_KEYHOLE, YELLOW_KEYHOLE,
+	GREEN_KEYHOLE, BLUE_KEYHOLE, EVIL_DOOR, BOMBABLE_WALL, FIRE_DESTROY, FLAME };
+
+static const int returnSpots[] = { WALKABLE, SHALLOW_WATER, WALK_LAVA, RED_WARP, BLUE_WARP, YELLOW_WARP, GREEN_WARP,
+	SHALLOW_GREEN_WATER, BOMB_PAD_UP, BOMB_PAD_DOWN, HOVER_PAD, SUPER_SPRING, SMILELET, SMILELET_FLOWER_HAPPY,
+	FAKE_COLLISION, PLAYER_START, EVIL_WALL_POSITION, EVIL_WALL_TRIGGER, EVIL_WALL_DEACTIVATOR, EVIL_WALL_RESTART };
+
+#define NUM_IDS(ids) (int)(sizeof(ids) / sizeof(ids[0]))
+
+/**
+ * Fills in the table. Called once by SMH::init before anything asks about tiles.
+ */
+void TileTraits::init() {
+
+	for (int i = 0; i < 256; i++) {
+		table[i] = DrawsCollision;
+	}
+
+	add(Pit, pits, NUM_IDS(pits));
+	add(Lava, lava, NUM_IDS(lava));
+	add(DeepWater, deepWater, NUM_IDS(deepWater));
+	add(SwitchLeft | Animated, switchesLeft, NUM_IDS(switchesLeft));
+	add(SwitchRight | Animated, switchesRight, NUM_IDS(switchesRight));
+	add(CylinderDown | Animated | ReturnSpot, cylindersDown, NUM_IDS(cylindersDown));
+	add(CylinderUp | Animated | ProjectileBlocking, cylindersUp, NUM_IDS(cylindersUp));
+	add(ArrowPad, arrowPads, NUM_IDS(arrowPads));
+	add(Warp, warps, NUM_IDS(warps));
+	add(GayFix, gayFix, NUM_IDS(gayFix));
+	add(Animated, animated, NUM_IDS(animated));
+	add(ProjectileBlocking, projectileBlocking, NUM_IDS(projectileBlocking));
+	add(ReturnSpot, returnSpots, NUM_IDS(returnSpots));
+
+	for (int i = 0; i < NUM_IDS(notDrawn); i++) {
+		table[notDrawn[i]] &= ~DrawsCollision;
+	}
+
+}
+
+void TileTraits::add(int traits, const int *ids, int numIds) {
+	for (int i = 0; i < numIds; i++) {
+		table[ids[i]] |= traits;
+	}
+}
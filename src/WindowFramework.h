@@ -118,6 +118,8 @@ public:
 	int advice;
 	bool increaseAlpha;
 	std::string paramString;
+	int nameText;					//Game text handles so text isn't looked up by name every frame
+	std::vector<int> pageText;
 	hgeDistortionMesh *distortion;
 	float fadeAlpha;
 	bool fadingOut;
@@ -126,6 +128,8 @@ public:
 private:
 
 	bool doClose();
+	void loadPageText(const char *prefix);
+	const char *getPageText();
 	std::string getAbilityText(int ability);
 	std::string getAdviceText(int advice, int page);
 
@@ -290,10 +294,7 @@ public:
 
 private:
 
-	void drawFogAt(int gridX, int gridY, int drawX, int drawY);
-	void drawSquare(int gridX, int gridY, int drawX, int drawY);
-	bool shouldDrawItem(int item);
-	bool shouldDrawSpecialCollision(int c);
+	void drawOverlays(int gridX, int gridY, int drawX, int drawY);
 	
 	int windowWidth, windowHeight;	//Pixel size of the map
 	int windowX, windowY;			//x and y position of the map window
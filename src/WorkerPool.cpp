@@ -0,0 +1,214 @@
+#include "SmileyEngine.h"
+
+extern SMH *smh;
+
+/**
+ * Starts a thread for every worker slot but the first, which is whoever calls
+ * run(). They sleep until there is something to do.
+ */
+WorkerPool::WorkerPool() {
+
+	quitting = false;
+	started = false;
+	numStolen = 0;
+	numBusy = 0;
+	numWorkers = 0;
+	numThreads = 0;
+	doneEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+
+	for (int i = 0; i < MAX_POOL_WORKERS; i++) {
+		InitializeCriticalSection(&queues[i].lock);
+		queues[i].first = queues[i].last = 0;
+		threads[i].pool = this;
+		threads[i].worker = i;
+		threads[i].thread = NULL;
+		threads[i].startEvent = NULL;
+	}
+
+	for (int i = 1; i < MAX_POOL_WORKERS; i++) {
+		threads[i].startEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+		threads[i].thread = CreateThread(NULL, 0, workerThreadProc, &threads[i], 0, NULL);
+		if (!threads[i].thread) {
+			CloseHandle(threads[i].startEvent);
+			threads[i].startEvent = NULL;
+			break;
+		}
+		numThreads++;
+	}
+
+	SYSTEM_INFO systemInfo;
+	GetSystemInfo(&systemInfo);
+	defaultWorkers = smh->hge->Ini_GetInt("Debug", "poolWorkers", (int)systemInfo.dwNumberOfProcessors);
+	if (defaultWorkers < 1) defaultWorkers = 1;
+	if (defaultWorkers > numThreads + 1) defaultWorkers = numThreads + 1;
+
+}
+
+WorkerPool::~WorkerPool() {
+	finish();
+	quitting = true;
+	for (int i = 1; i <= numThreads; i++) {
+		SetEvent(threads[i].startEvent);
+		WaitForSingleObject(threads[i].thread, INFINITE);
+		CloseHandle(threads[i].thread);
+		CloseHandle(threads[i].startEvent);
+	}
+	for (int i = 0; i < MAX_POOL_WORKERS; i++) {
+		DeleteCriticalSection(&queues[i].lock);
+	}
+	CloseHandle(doneEvent);
+}
+
+/**
+ * Calls job(context, n, worker) for n = 0 to numJobs - 1, spread over numWorkers
+ * workers including the calling thread, and waits for all of them. worker is
+ * which of them ran the job, so jobs can keep per worker results without locking.
+ * With one worker the jobs are simply run in order on the calling thread.
+ */
+void WorkerPool::run(PoolJob _job, void *_context, int numJobs, int _numWorkers) {
+
+	finish();
+
+	if (_numWorkers > numThreads + 1) _numWorkers = numThreads + 1;
+	if (_numWorkers > numJobs) _numWorkers = numJobs;
+	if (_numWorkers <= 1) {
+		for (int i = 0; i < numJobs; i++) {
+			_job(_context, i, 0);
+		}
+		return;
+	}
+
+	job = _job;
+	context = _context;
+	numWorkers = _numWorkers;
+
+	//Neighbouring jobs go to the same worker
+	for (int i = 0; i < numWorkers; i++) {
+		queues[i].first = numJobs * i / numWorkers;
+		queues[i].last = numJobs * (i + 1) / numWorkers;
+	}
+
+	numBusy = numWorkers - 1;
+	for (int i = 1; i < numWorkers; i++) {
+		SetEvent(threads[i].startEvent);
+	}
+
+	work(0);
+	WaitForSingleObject(doneEvent, INFINITE);
+
+}
+
+/**
+ * Like run(), but the jobs are only given to the worker threads, numbered 1 to
+ * numWorkers, and it returns without waiting for them. Call finish() before
+ * using what they make. With no worker threads the jobs are run before it returns.
+ */
+void WorkerPool::start(PoolJob _job, void *_context, int numJobs, int _numWorkers) {
+
+	finish();
+
+	if (_numWorkers > numThreads) _numWorkers = numThreads;
+	if (_numWorkers > numJobs) _numWorkers = numJobs;
+	if (_numWorkers < 1) {
+		for (int i = 0; i < numJobs; i++) {
+			_job(_context, i, 0);
+		}
+		return;
+	}
+
+	job = _job;
+	context = _context;
+	numWorkers = _numWorkers + 1;
+
+	//The calling thread's queue is left empty
+	queues[0].first = queues[0].last = 0;
+	for (int i = 1; i < numWorkers; i++) {
+		queues[i].first = numJobs * (i - 1) / _numWorkers;
+		queues[i].last = numJobs * i / _numWorkers;
+	}
+
+	started = true;
+	numBusy = _numWorkers;
+	for (int i = 1; i < numWorkers; i++) {
+		SetEvent(threads[i].startEvent);
+	}
+
+}
+
+/**
+ * Waits for the batch from start(), if there is one.
+ */
+void WorkerPool::finish() {
+	if (!started) return;
+	WaitForSingleObject(doneEvent, INFINITE);
+	started = false;
+}
+
+DWORD WINAPI WorkerPool::workerThreadProc(LPVOID param) {
+
+	PoolThread *thread = (PoolThread*)param;
+	WorkerPool *pool = thread->pool;
+
+	for (;;) {
+		WaitForSingleObject(thread->startEvent, INFINITE);
+		if (pool->quitting) break;
+		pool->work(thread->worker);
+		if (InterlockedDecrement(&pool->numBusy) == 0) SetEvent(pool->doneEvent);
+	}
+
+	return 0;
+}
+
+/**
+ * Runs jobs until there are none left anywhere. Nothing is added to the queues
+ * during a run, so once every queue is empty the worker is done.
+ */
+void WorkerPool::work(int worker) {
+	int nextJob;
+	while (takeJob(worker, &nextJob)) {
+		job(context, nextJob, worker);
+	}
+}
+
+bool WorkerPool::takeJob(int worker, int *nextJob) {
+
+	PoolQueue *queue = &queues[worker];
+	EnterCriticalSection(&queue->lock);
+	bool found = queue->first < queue->last;
+	if (found) *nextJob = --queue->last;
+	LeaveCriticalSection(&queue->lock);
+	if (found) return true;
+
+	for (int i = 1; i < numWorkers; i++) {
+		queue = &queues[(worker + i) % numWorkers];
+		EnterCriticalSection(&queue->lock);
+		found = queue->first < queue->last;
+		if (found) *nextJob = queue->first++;
+		LeaveCriticalSection(&queue->lock);
+		if (found) {
+			InterlockedIncrement(&numStolen);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * How many workers to use when there's no reason to pick, one per processor
+ * unless Debug/poolWorkers says otherwise.
+ */
+int WorkerPool::getDefaultWorkers() {
+	return defaultWorkers;
+}
+
+int WorkerPool::getNumThreads() {
+	return numThreads;
+}
+
+/**
+ * Returns how many jobs have been stolen from another worker's queue so far.
+ */
+int WorkerPool::getNumStolen() {
+	return numStolen;
+}
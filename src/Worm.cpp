@@ -6,19 +6,14 @@ using namespace std;
 
 extern SMH *smh;
 
-#define WORM_LENGTH 500
-
 // Constructor ///////////////////
 
 Worm::Worm (int gridX,int gridY) {
+	head = 0;
 	for (int i=0; i < WORM_LENGTH; i++) {
-		WormNode *newNode;
-		newNode = new WormNode;
-		newNode->x = gridX*64+32;
-		newNode->y = gridY*64+32;
-		newNode->dir = DOWN;
-		theWorms.push_back(*newNode);
-		delete newNode;
+		nodes[i].x = gridX*64+32;
+		nodes[i].y = gridY*64+32;
+		nodes[i].dir = DOWN;
 	}
 }
 
@@ -31,79 +26,60 @@ Worm::~Worm() {
 // Public /////////////////////
 
 void Worm::update() {
-	std::list<WormNode>::iterator i;
-
-	i = theWorms.begin();
-
-	if ((int)smh->player->x != i->x || (int)smh->player->y != i->y) {
-		addWormTrail();
+	if ((int)smh->player->x != nodes[head].x || (int)smh->player->y != nodes[head].y) {
+		addWormTrail((int)smh->player->x, (int)smh->player->y);
 	}
-
 }
 
 void Worm::draw() {
-	std::list<WormNode>::iterator i;
-	for (i = theWorms.begin(); i != theWorms.end(); i++) {
-		smh->resources->GetSprite("clownChainDot")->Render(smh->getScreenX(i->x),smh->getScreenY(i->y));
+	for (int i = 0; i < WORM_LENGTH; i++) {
+		smh->resources->GetSprite("clownChainDot")->Render(smh->getScreenX(nodes[i].x),smh->getScreenY(nodes[i].y));
 	}
 }
 
+/**
+ * Returns the node that many pixels back along the trail. Asking for a node
+ * past the end of the trail returns the oldest node.
+ */
 WormNode Worm::getNode(int nodeNumber) {
-	WormNode returnNode;	
-	std::list<WormNode>::iterator i;
-
-	int n=0;
-
-	for (i = theWorms.begin(); i != theWorms.end(); i++) {
-		returnNode.x = i->x;
-		returnNode.y = i->y;
-		returnNode.dir = i->dir;
-
-		if (n==nodeNumber) return returnNode;
-		n++;
-	}
-
-	return returnNode;
+	if (nodeNumber < 0 || nodeNumber >= WORM_LENGTH) nodeNumber = WORM_LENGTH - 1;
+	return nodes[(head + nodeNumber) % WORM_LENGTH];
 }
 
 void Worm::reset() {
-	std::list<WormNode>::iterator i;
-	
-	for (i = theWorms.begin(); i != theWorms.end(); i++) {
-		i->x = smh->player->x;
-		i->y = smh->player->y;
-		i->dir = DOWN;
-       }
+	for (int i = 0; i < WORM_LENGTH; i++) {
+		nodes[i].x = smh->player->x;
+		nodes[i].y = smh->player->y;
+		nodes[i].dir = DOWN;
+	}
 }
 
-// Private ///////////////////////////////
-
 /***********
  * addWormTrail: In a given frame, Smiley may move a few pixels.
  * Because the worm is based on pixels, not time, there has to be a way to "fill in" those gaps.
- * This function fills in the gap between the current WormNode and Smiley's current position.
+ * This function fills in the gap between the current WormNode and (toX, toY). The trail steps
+ * diagonally until it lines up with the target and then goes straight, so the position of
+ * every step is known up front and only the steps that will still be in the worm are added.
  */
-
-void Worm::addWormTrail() {
-	int curX,curY;
-	bool exitWhile=false;
-	std::list<WormNode>::iterator firstNode;
-
-	firstNode = theWorms.begin();
-
-	curX = firstNode->x;
-	curY = firstNode->y;
-
-	bool left=false, right=false, up=false, down=false;
-	
-    while (!exitWhile) {
-		
-		left = right = up = down = false;
-
-		if (curX > (int)smh->player->x) {curX--; left=true;}
-		if (curX < (int)smh->player->x) {curX++; right=true;}
-		if (curY > (int)smh->player->y) {curY--; up=true;}
-		if (curY < (int)smh->player->y) {curY++; down=true;}
+void Worm::addWormTrail(int toX, int toY) {
+
+	int startX = nodes[head].x;
+	int startY = nodes[head].y;
+	int distX = abs(toX - startX);
+	int distY = abs(toY - startY);
+	int signX = (toX > startX) ? 1 : -1;
+	int signY = (toY > startY) ? 1 : -1;
+	int numSteps = max(distX, distY);
+
+	int firstStep = max(1, numSteps - WORM_LENGTH + 1);
+	for (int step = firstStep; step <= numSteps; step++) {
+
+		bool movingX = step <= distX;
+		bool movingY = step <= distY;
+		bool left = movingX && signX < 0;
+		bool right = movingX && signX > 0;
+		bool up = movingY && signY < 0;
+		bool down = movingY && signY > 0;
 
 		int direction = 0;
 		
@@ -125,27 +101,18 @@ void Worm::addWormTrail() {
 			direction = DOWN;
 		}		
 		
-		addWormNode(curX,curY,direction);
-		
-		if (curX==(int)smh->player->x && curY==(int)smh->player->y) {
-			exitWhile=true;
-		}
-
+		addWormNode(startX + signX * min(step, distX), startY + signY * min(step, distY), direction);
 	}
 }
 
-void Worm::addWormNode(int x,int y,int direction) {
-	WormNode newNode;
-	
-	newNode.x = x;
-	newNode.y = y;
-	newNode.dir = direction;
-
-	//We need to add this node to the beginning, and delete the last node
-
-	//Delete last node
-	theWorms.pop_back();
+// Private ///////////////////////////////
 
-	//Add first node
-	theWorms.push_front(newNode);	
-}
\ No newline at end of file
+/**
+ * Adds a node to the front of the worm, overwriting the oldest node.
+ */
+void Worm::addWormNode(int x,int y,int direction) {
+	head = (head + WORM_LENGTH - 1) % WORM_LENGTH;
+	nodes[head].x = x;
+	nodes[head].y = y;
+	nodes[head].dir = direction;
+}
@@ -25,7 +25,7 @@ extern SMH *smh;
 /**
  * This is the abstract class defining bosses. All bosses are subclasses of this dickens.
  */
-class Boss {
+class Boss : public AreaObject {
 
 public:
 
@@ -51,6 +51,7 @@ public:
 
 struct BossStruct {
 	Boss *boss;
+	int resourceGroup;
 };
 
 /**
@@ -69,6 +70,7 @@ public:
 	void update(float dt);
 	void spawnBoss(int boss, int groupID, int gridX, int gridY);
 	void reset();
+	static int getResourceGroup(int bossID);
 
 	int numBosses;
 	std::list<BossStruct> bossList;
@@ -1,9 +1,7 @@
-#include "SmileyEngine.h"
+#include "SmileyPrimitives.h"
 #include "collisioncircle.h"
 #include "hgerect.h"
 
-extern SMH *smh;
-
 CollisionCircle::CollisionCircle() { }
 
 CollisionCircle::~CollisionCircle() { }
@@ -69,28 +67,3 @@ bool CollisionCircle::testCircle(CollisionCircle *circle) {
 bool CollisionCircle::testPoint(int pointX, int pointY) {
 	return (abs(Util::distance(x, y, pointX, pointY)) < radius);
 }
-
-/**
- * draw the circle
- */
-void CollisionCircle::draw() {
-	float EachAngle;
-	float a;
-	float x1;
-	float x2;
-	float y1;
-	float y2;
- 
-	EachAngle = 2.0 * M_PI / 15.0f;
- 
-	x2 = (float)radius;
-	y2 = 0.0;
- 
-	for(a=0.0; a<= (2.0*PI + EachAngle); a+=EachAngle) {
-		x1 = x2;
-		y1 = y2;
-		x2 = (float)radius * cos(a);
-		y2 = (float)radius * sin(a);
-		smh->hge->Gfx_RenderLine(smh->getScreenX(x1+(float)x), smh->getScreenY(y1+(float)y), smh->getScreenX(x2+(float)x), smh->getScreenY(y2+(float)y), ARGB(255,255,0,0));
-	}
-}
\ No newline at end of file
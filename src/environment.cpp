@@ -2,6 +2,7 @@
 #include "environment.h"
 #include "lootmanager.h"
 #include "ProjectileManager.h"
+#include "PatternEmitter.h"
 #include "player.h"
 #include "collisioncircle.h"
 #include "npcmanager.h"
@@ -11,6 +12,7 @@
 #include "EvilWallManager.h"
 #include "WeaponParticle.h"
 #include "TapestryManager.h"
+#include "MiniMap.h"
 #include "EnemyFramework.h"
 #include "SmileletManager.h"
 #include "Fountain.h"
@@ -23,62 +25,74 @@
 #include <sstream>
 #include <iostream>
 #include <fstream>
+#include <algorithm>
 
 extern SMH *smh;
 
 #define SWITCH_DELAY 0.15
 #define TONGUE_SWITCH_DELAY 0.40
 
+//Sprite batch layers for the tiles, which are drawn sorted by texture within each layer
+#define TERRAIN_LAYER 0
+#define COLLISION_LAYER 1
+#define ITEM_LAYER 2
+
 /**
  * Constructor
  */
 Environment::Environment() {
 	
-	//Load item layer
+	//Load item layer, from wherever the textures are on the tile atlas
+	float atlasX = 0.0, atlasY = 0.0;
+	HTEXTURE texture = smh->resources->getTextureRegion("itemLayer1", &atlasX, &atlasY);
 	for (int i = 0; i < 16; i++) {
 		for (int j = 0; j < 16; j++) {
-			itemLayer[j*16 + i] = new hgeSprite(smh->resources->GetTexture("itemLayer1"),i*64,j*64,64,64);
+			itemLayer[j*16 + i] = new hgeSprite(texture,atlasX+i*64,atlasY+j*64,64,64);
 		}
 	}
+	atlasX = atlasY = 0.0;
+	texture = smh->resources->getTextureRegion("itemLayer2", &atlasX, &atlasY);
 	for (int i = 0; i < 16; i++) {
 		for (int j = 0; j < 16; j++) {
-			itemLayer[256+j*16+i] = new hgeSprite(smh->resources->GetTexture("itemLayer2"),i*64,j*64,64,64);
+			itemLayer[256+j*16+i] = new hgeSprite(texture,atlasX+i*64,atlasY+j*64,64,64);
 		}
 	}	
 
 	//Load animations
 	int numFrames = 5;
 	int fps = (int)((float)numFrames / SWITCH_DELAY);
+	atlasX = atlasY = 0.0;
+	texture = smh->resources->getTextureRegion("animations", &atlasX, &atlasY);
 
-	silverCylinder = new hgeAnimation(smh->resources->GetTexture("animations"),numFrames,fps,0,3*64,64,64);
+	silverCylinder = new hgeAnimation(texture,numFrames,fps,atlasX,atlasY+3*64,64,64);
 	silverCylinder->SetMode(HGEANIM_REV);
 	silverCylinder->Play();
-	brownCylinder = new hgeAnimation(smh->resources->GetTexture("animations"),numFrames,fps,0,4*64,64,64);
+	brownCylinder = new hgeAnimation(texture,numFrames,fps,atlasX,atlasY+4*64,64,64);
 	brownCylinder->SetMode(HGEANIM_REV);
 	brownCylinder->Play();
-	blueCylinder = new hgeAnimation(smh->resources->GetTexture("animations"),numFrames,fps,0,5*64,64,64);
+	blueCylinder = new hgeAnimation(texture,numFrames,fps,atlasX,atlasY+5*64,64,64);
 	blueCylinder->SetMode(HGEANIM_REV);
 	blueCylinder->Play();
-	greenCylinder = new hgeAnimation(smh->resources->GetTexture("animations"),numFrames,fps,0,6*64,64,64);
+	greenCylinder = new hgeAnimation(texture,numFrames,fps,atlasX,atlasY+6*64,64,64);
 	greenCylinder->SetMode(HGEANIM_REV);
 	greenCylinder->Play();
-	yellowCylinder = new hgeAnimation(smh->resources->GetTexture("animations"),numFrames,fps,0,7*64,64,64);
+	yellowCylinder = new hgeAnimation(texture,numFrames,fps,atlasX,atlasY+7*64,64,64);
 	yellowCylinder->SetMode(HGEANIM_REV);
 	yellowCylinder->Play();
-	whiteCylinder = new hgeAnimation(smh->resources->GetTexture("animations"),numFrames,fps,0,8*64,64,64);
+	whiteCylinder = new hgeAnimation(texture,numFrames,fps,atlasX,atlasY+8*64,64,64);
 	whiteCylinder->SetMode(HGEANIM_REV);
 	whiteCylinder->Play();
-	silverCylinderRev = new hgeAnimation(smh->resources->GetTexture("animations"),numFrames,fps,0,3*64,64,64);
+	silverCylinderRev = new hgeAnimation(texture,numFrames,fps,atlasX,atlasY+3*64,64,64);
 	silverCylinderRev->SetMode(HGEANIM_FWD);
-	brownCylinderRev = new hgeAnimation(smh->resources->GetTexture("animations"),numFrames,fps,0,4*64,64,64);
+	brownCylinderRev = new hgeAnimation(texture,numFrames,fps,atlasX,atlasY+4*64,64,64);
 	brownCylinderRev->SetMode(HGEANIM_FWD);
-	blueCylinderRev = new hgeAnimation(smh->resources->GetTexture("animations"),numFrames,fps,0,5*64,64,64);
+	blueCylinderRev = new hgeAnimation(texture,numFrames,fps,atlasX,atlasY+5*64,64,64);
 	blueCylinderRev->SetMode(HGEANIM_FWD);
-	greenCylinderRev = new hgeAnimation(smh->resources->GetTexture("animations"),numFrames,fps,0,6*64,64,64);
+	greenCylinderRev = new hgeAnimation(texture,numFrames,fps,atlasX,atlasY+6*64,64,64);
 	greenCylinderRev->SetMode(HGEANIM_FWD);
-	yellowCylinderRev = new hgeAnimation(smh->resources->GetTexture("animations"),numFrames,fps,0,7*64,64,64);
+	yellowCylinderRev = new hgeAnimation(texture,numFrames,fps,atlasX,atlasY+7*64,64,64);
 	yellowCylinderRev->SetMode(HGEANIM_FWD);
-	whiteCylinderRev = new hgeAnimation(smh->resources->GetTexture("animations"),numFrames,fps,0,8*64,64,64);
+	whiteCylinderRev = new hgeAnimation(texture,numFrames,fps,atlasX,atlasY+8*64,64,64);
 	whiteCylinderRev->SetMode(HGEANIM_FWD);
 
 	smh->resources->GetAnimation("silverSwitch")->SetSpeed(fps);
@@ -102,10 +116,16 @@ Environment::Environment() {
 	tapestryManager = new TapestryManager();
 	smh->log("Creating Environment.SmileletManager");
 	smileletManager = new SmileletManager();
+	smh->log("Creating Environment.MiniMap");
+	miniMap = new MiniMap();
 
 	collisionBox = new hgeRect();
+	ZeroMemory(&playerMovement, sizeof(playerMovement));
 	collisionCircle = new CollisionCircle();
 
+	areaWidth = areaHeight = 0;
+	clearTileData(256, 256);
+
 }
 
 Environment::~Environment() { }
@@ -118,6 +138,7 @@ void Environment::reset() {
 	smh->bossManager->reset();
 	smh->enemyManager->reset();
 	smh->projectileManager->reset();
+	smh->patternEmitter->reset();
 	smh->lootManager->reset();
 	smh->npcManager->reset();
 	smh->enemyGroupManager->resetGroups();
@@ -139,25 +160,35 @@ void Environment::reset() {
 		adviceMan = NULL;
 	}
 
-	//Clear old level data
-	for (int i = 0; i < 256; i++) {
-		for (int j = 0; j < 256; j++) {
-			terrain[i][j] = 0;
-			collision[i][j] = 0;
-			ids[i][j] = -1;
-			item[i][j] = 0;
-			activated[i][j] = -100.0;
-			variable[i][j] = 0;
-			enemyLayer[i][j] = -1;
-		}
-	}
+	//Clear old level data. Nothing outside of the old area was written to so only
+	//that part needs to be cleared.
+	clearTileData(areaWidth, areaHeight);
 
-	for (std::list<Timer>::iterator i = timerList.begin(); i != timerList.end(); i++) {
-		i = timerList.erase(i);
-	}
+	timerList.clear();
 
 	smh->explosionManager->reset();
+	smh->particlePool->reset();
 
+	//Everything from the old area has been deleted so its memory can all be released at once
+	smh->areaArena->reset();
+
+}
+
+/**
+ * Resets the top left width x height tiles of every layer.
+ */
+void Environment::clearTileData(int width, int height) {
+	width = min(max(width, 0), 256);
+	height = min(max(height, 0), 256);
+	for (int i = 0; i < width; i++) {
+		std::fill(tileData.ids[i], tileData.ids[i] + height, -1);
+		std::fill(tileData.variable[i], tileData.variable[i] + height, 0);
+		std::fill(tileData.terrain[i], tileData.terrain[i] + height, 0);
+		std::fill(tileData.collision[i], tileData.collision[i] + height, 0);
+		std::fill(tileData.item[i], tileData.item[i] + height, 0);
+		std::fill(tileData.enemyLayer[i], tileData.enemyLayer[i] + height, -1);
+		std::fill(tileData.activated[i], tileData.activated[i] + height, -100.0f);
+	}
 }
 
 /**
@@ -169,8 +200,9 @@ void Environment::reset() {
  */
 void Environment::loadArea(int id, int from, bool playMusic) {
 
-	std::ifstream areaFile;
-	char threeBuffer[3];
+	//Parse the area file, or pick up the copy the AreaLoader prefetched
+	//in the background.
+	AreaData *areaData = smh->areaLoader->takeAreaData(id);
 
 	smh->saveManager->hasVisitedArea[id] = true;
 	smh->saveManager->currentArea = id;
@@ -178,232 +210,143 @@ void Environment::loadArea(int id, int from, bool playMusic) {
 	//Delete all objects from the previous area.
 	reset();
 
-	//Open the area file
-	if (areaFile.is_open()) areaFile.close();
-	if (id == FOUNTAIN_AREA) {
-		areaFile.open("Data/Maps/fountain.smh");
-	} else if (id == OLDE_TOWNE) {
-		areaFile.open("Data/Maps/oldetowne.smh");
-	} else if (id == SMOLDER_HOLLOW) {
-		areaFile.open("Data/Maps/smhollow.smh");
-	} else if (id == FOREST_OF_FUNGORIA) {
-		areaFile.open("Data/Maps/forest.smh");
-	} else if (id == SESSARIA_SNOWPLAINS) {
-		areaFile.open("Data/Maps/snow.smh");
-	} else if (id == TUTS_TOMB) {
-		areaFile.open("Data/Maps/tutstomb.smh");
-	} else if (id == WORLD_OF_DESPAIR) {
-		areaFile.open("Data/Maps/despair.smh");
-	} else if (id == SERPENTINE_PATH) {
-		areaFile.open("Data/Maps/path.smh");
-	} else if (id == CASTLE_OF_EVIL) {
-		areaFile.open("Data/Maps/castle.smh");
-	} else if (id == CONSERVATORY) {
-		areaFile.open("Data/Maps/conserve.smh");
-	} else if (id == DEBUG_AREA) {
-		areaFile.open("Data/Maps/debug.smh");
-	}
-
-	//id range - ignore it
-	areaFile.read(threeBuffer,2);
-
-	//Read area width
-	areaFile.read(threeBuffer,3);
-	areaWidth = atoi(threeBuffer);
-	areaFile.read(threeBuffer,1);	//read space
-	//Read area height
-	areaFile.read(threeBuffer,3);
-	areaHeight = atoi(threeBuffer);
-	areaFile.read(threeBuffer,1);	//read newline
+	areaWidth = areaData->width;
+	areaHeight = areaData->height;
 
 	//Set up screen size (64 is normal size)
 	screenWidth = 1024.0 / 64.0;
 	screenHeight = 768.0 / 64.0;
 
-
-	//Load ID Layer
-	for (int row = 0; row < areaHeight; row++) {
-		for (int col = 0; col < areaWidth; col++) {
-			areaFile.read(threeBuffer,3);
-			ids[col][row] = atoi(threeBuffer);
-		}
-		//Read the newline
-		areaFile.read(threeBuffer,1);
-	}
-	areaFile.read(threeBuffer,3);	//width
-	areaFile.read(threeBuffer,1);	//space
-	areaFile.read(threeBuffer,3);	//height
-	areaFile.read(threeBuffer,1);	//newline
-
-
-	//Load Variable Layer
-	for (int row = 0; row < areaHeight; row++) {
-		for (int col = 0; col < areaWidth; col++) {
-			areaFile.read(threeBuffer,3);
-			variable[col][row] = atoi(threeBuffer);
-		}
-		//Read the newline
-		areaFile.read(threeBuffer,1);
-	}
-	areaFile.read(threeBuffer,3);	//width
-	areaFile.read(threeBuffer,1);	//space
-	areaFile.read(threeBuffer,3);	//height
-	areaFile.read(threeBuffer,1);	//newline
-
-
-	//Load terrain data for the area
+	//Load ID, Variable and Terrain Layers
 	for (int row = 0; row < areaHeight; row++) {
 		for (int col = 0; col < areaWidth; col++) {
-			areaFile.read(threeBuffer,3);
-			terrain[col][row] = atoi(threeBuffer);
+			ids(col, row) = areaData->get(AreaLayers::Ids, col, row);
+			variable(col, row) = areaData->get(AreaLayers::Variable, col, row);
+			terrain(col, row) = areaData->get(AreaLayers::Terrain, col, row);
 		}
-		//Read the newline
-		areaFile.read(threeBuffer,1);
 	}
-	areaFile.read(threeBuffer,3);	//width
-	areaFile.read(threeBuffer,1);	//space
-	areaFile.read(threeBuffer,3);	//height
-	areaFile.read(threeBuffer,1);	//newline
-
 
 	//Load collision detection data
 	for (int row = 0; row < areaHeight; row++) {
 		for (int col = 0; col < areaWidth; col++) {
-			areaFile.read(threeBuffer,3);
-			collision[col][row] = atoi(threeBuffer);
+			collision(col, row) = areaData->get(AreaLayers::Collision, col, row);
 
 			//Big ass fountain location
-			if (collision[col][row] == FOUNTAIN) {
+			if (collision(col, row) == FOUNTAIN) {
 				fountain = new Fountain(col, row);
 			}
 			
 			//Warp (don't add hidden warps! (id 990))
-			if (Util::isWarp(collision[col][row]) && variable[col][row] != 990) {
-				specialTileManager->addWarp(col, row, collision[col][row]);
+			if (Util::isWarp(collision(col, row)) && variable(col, row) != 990) {
+				specialTileManager->addWarp(col, row, collision(col, row));
 			}
 
 			//Flames
-			if (collision[col][row] == FLAME) {
+			if (collision(col, row) == FLAME) {
 				specialTileManager->addFlame(col, row);
 			}
 			
 			//Ice blocks
-			if (collision[col][row] == FIRE_DESTROY) {
+			if (collision(col, row) == FIRE_DESTROY) {
 				specialTileManager->addIceBlock(col, row);
 			}
 
 			//Mushrooms
-			if (collision[col][row] == DIZZY_MUSHROOM_1 || collision[col][row] == DIZZY_MUSHROOM_2) {
-				specialTileManager->addMushroom(col,row,collision[col][row]);
+			if (collision(col, row) == DIZZY_MUSHROOM_1 || collision(col, row) == DIZZY_MUSHROOM_2) {
+				specialTileManager->addMushroom(col,row,collision(col, row));
 			}
 
 			//SmileletManager
-			if (collision[col][row] == SMILELET) {
-				smileletManager->addSmilelet(col,row,ids[col][row]);
-				collision[col][row] = WALKABLE;
+			if (collision(col, row) == SMILELET) {
+				smileletManager->addSmilelet(col,row,ids(col, row));
+				collision(col, row) = WALKABLE;
 			}
 			
 			//Evil wall stuff
-			if (collision[col][row] >= EVIL_WALL_POSITION && collision[col][row] <= EVIL_WALL_RESTART) {
-				evilWallManager->addEvilWall(ids[col][row]);
-				evilWallManager->setState(ids[col][row],0);
+			if (collision(col, row) >= EVIL_WALL_POSITION && collision(col, row) <= EVIL_WALL_RESTART) {
+				evilWallManager->addEvilWall(ids(col, row));
+				evilWallManager->setState(ids(col, row),0);
 			}
-			if (collision[col][row] == EVIL_WALL_POSITION) {					
-				evilWallManager->setBeginWallPosition(ids[col][row],col,row);
-				evilWallManager->setSpeed(ids[col][row],variable[col][row]);
-			} else if (collision[col][row] == EVIL_WALL_TRIGGER) {
-				evilWallManager->setDir(ids[col][row],variable[col][row]);
-			} else if (collision[col][row] == EVIL_WALL_RESTART) {
-				evilWallManager->setSmileyRestartPosition(ids[col][row],col,row);
+			if (collision(col, row) == EVIL_WALL_POSITION) {					
+				evilWallManager->setBeginWallPosition(ids(col, row),col,row);
+				evilWallManager->setSpeed(ids(col, row),variable(col, row));
+			} else if (collision(col, row) == EVIL_WALL_TRIGGER) {
+				evilWallManager->setDir(ids(col, row),variable(col, row));
+			} else if (collision(col, row) == EVIL_WALL_RESTART) {
+				evilWallManager->setSmileyRestartPosition(ids(col, row),col,row);
 			}
 
 		}
-		//Read the newline
-		areaFile.read(threeBuffer,1);
 	}
-	areaFile.read(threeBuffer,3);	//width
-	areaFile.read(threeBuffer,1);	//space
-	areaFile.read(threeBuffer,3);	//height
-	areaFile.read(threeBuffer,1);	//newline
 
 	//Load item data
 	for (int row = 0; row < areaHeight; row++) {
 		for (int col = 0; col < areaWidth; col++) {
-			areaFile.read(threeBuffer,3);
-			int newItem = atoi(threeBuffer);
+			int newItem = areaData->get(AreaLayers::Item, col, row);
 			
 			//If health item or mana item, ignore the change manager so that they don't go away
 			if (newItem == HEALTH_ITEM || newItem == MANA_ITEM) {
-				item[col][row] = newItem;
+				item(col, row) = newItem;
 			} else {
 
 				if (!smh->saveManager->isTileChanged(col, row)) {
 					if (newItem >= 16 && newItem < 32) {
 						tapestryManager->addTapestry(col, row, newItem);
 					} else {
-						item[col][row] = newItem;
+						item(col, row) = newItem;
 					}
 				}
 			}
 		}
-		//Read the newline
-		areaFile.read(threeBuffer,1);
 	}
-	areaFile.read(threeBuffer,3);	//width
-	areaFile.read(threeBuffer,1);	//space
-	areaFile.read(threeBuffer,3);	//height
-	areaFile.read(threeBuffer,1);	//newline
-
 
 	//Load enemy/NPC/Boss data
-	int enemy;
 	for (int row = 0; row < areaHeight; row++) {
 		for (int col = 0; col < areaWidth; col++) {
-			areaFile.read(threeBuffer,3);
-			enemy = atoi(threeBuffer);
-			enemyLayer[col][row] = enemy-1;
+			enemyLayer(col, row) = areaData->get(AreaLayers::Enemy, col, row) - 1;
+		}
+	}
+	for (std::list<AreaSpawn>::iterator i = areaData->spawns.begin(); i != areaData->spawns.end(); i++) {
+		int col = i->gridX;
+		int row = i->gridY;
+		int enemy = i->enemy;
 
-			//255 is a fenwar encounter
-			if (enemy == 255) {
+		//255 is a fenwar encounter
+		if (enemy == 255) {
 
-				if (!smh->saveManager->isTileChanged(col, row)) {
-					smh->fenwarManager->addFenwarEncounter(col, row, ids[col][row]);
-				}
+			if (!smh->saveManager->isTileChanged(col, row)) {
+				smh->fenwarManager->addFenwarEncounter(col, row, ids(col, row));
+			}
 
-			//240-256 are bosses
-			} else if (enemy >= 240) {
+		//240-256 are bosses
+		} else if (enemy >= 240) {
 
-				//Spawn the boss if it has never been killed
-				if (!smh->saveManager->isBossKilled(enemy)) {
-					smh->bossManager->spawnBoss(enemy, variable[col][row], col, row);
-				}
+			//Spawn the boss if it has never been killed
+			if (!smh->saveManager->isBossKilled(enemy)) {
+				smh->bossManager->spawnBoss(enemy, variable(col, row), col, row);
+			}
 
-			//1-127 are enemies
-			} else if (enemy > 0 && enemy < smh->gameData->getNumEnemies()) {
+		//1-127 are enemies
+		} else if (enemy > 0 && enemy < smh->gameData->getNumEnemies()) {
 
-				if (ids[col][row] == ENEMYGROUP_ENEMY) {
-					//If this enemy is part of a group, notify the manager
-					smh->enemyGroupManager->addEnemy(variable[col][row]);
-				}
-				if (ids[col][row] != ENEMYGROUP_ENEMY_POPUP) {
-					//Don't spawn popup enemies yet
-					smh->enemyManager->addEnemy(enemy-1,col,row, .2, .2, variable[col][row], false);
-				}
+			if (ids(col, row) == ENEMYGROUP_ENEMY) {
+				//If this enemy is part of a group, notify the manager
+				smh->enemyGroupManager->addEnemy(variable(col, row));
+			}
+			if (ids(col, row) != ENEMYGROUP_ENEMY_POPUP) {
+				//Don't spawn popup enemies yet
+				smh->enemyManager->addEnemy(enemy-1,col,row, .2, .2, variable(col, row), false);
+			}
 
-			//128 - 239 are NPCs
-			} else if (enemy >= 128 && enemy < 240) {
-				if (enemy != 128 + MONOCLE_MAN_NPC_ID || smh->saveManager->adviceManEncounterCompleted) {
-					smh->npcManager->addNPC(enemy-128,ids[col][row],col,row);
-				}
-			} 
-		}
-		//Read the newline
-		areaFile.read(threeBuffer,1);
+		//128 - 239 are NPCs
+		} else if (enemy >= 128 && enemy < 240) {
+			if (enemy != 128 + MONOCLE_MAN_NPC_ID || smh->saveManager->adviceManEncounterCompleted) {
+				smh->npcManager->addNPC(enemy-128,ids(col, row),col,row);
+			}
+		} 
 	}
-	areaFile.read(threeBuffer,3);	//width
-	areaFile.read(threeBuffer,1);	//space
-	areaFile.read(threeBuffer,3);	//height
-	areaFile.read(threeBuffer,1);	//newline
+
+	smh->areaLoader->deleteAreaData(areaData);
 
 
 	//Load changes
@@ -411,33 +354,33 @@ void Environment::loadArea(int id, int from, bool playMusic) {
 		for (int j = 0; j < areaHeight; j++) {
 			if (smh->saveManager->isTileChanged(i,j)) {
 
-				if (collision[i][j] >= RED_KEYHOLE && collision[i][j] <= BLUE_KEYHOLE) {
-					collision[i][j] = WALKABLE;
+				if (collision(i, j) >= RED_KEYHOLE && collision(i, j) <= BLUE_KEYHOLE) {
+					collision(i, j) = WALKABLE;
 				}
 
-				if (collision[i][j] == SMILELET_FLOWER_SAD) {
-					collision[i][j] = SMILELET_FLOWER_HAPPY;
+				if (collision(i, j) == SMILELET_FLOWER_SAD) {
+					collision(i, j) = SMILELET_FLOWER_HAPPY;
 				}
 
-				if (collision[i][j] == SMILELET) {
-					collision[i][j] = NONE;
+				if (collision(i, j) == SMILELET) {
+					collision(i, j) = NONE;
 				}
 
-				if (collision[i][j] == BOMBABLE_WALL) {
-					collision[i][j] = WALKABLE;
+				if (collision(i, j) == BOMBABLE_WALL) {
+					collision(i, j) = WALKABLE;
 				}
 
 				//Flip shrink tunnel switches
-				if (collision[i][j] == SHRINK_TUNNEL_SWITCH) {
-					int id = ids[i][j];
+				if (collision(i, j) == SHRINK_TUNNEL_SWITCH) {
+					int id = ids(i, j);
 					//Scan the area for cylinders linked to this switch
 					for (int k = 0; k < areaWidth; k++) {
 						for (int l = 0; l < areaHeight; l++) {
-							if (ids[k][l] == id) {
-								if (collision[k][l] == SHRINK_TUNNEL_HORIZONTAL)
-									collision[k][l] = SHRINK_TUNNEL_VERTICAL;
-								else if (collision[k][l] == SHRINK_TUNNEL_VERTICAL)
-									collision[k][l] = SHRINK_TUNNEL_HORIZONTAL;
+							if (ids(k, l) == id) {
+								if (collision(k, l) == SHRINK_TUNNEL_HORIZONTAL)
+									collision(k, l) = SHRINK_TUNNEL_VERTICAL;
+								else if (collision(k, l) == SHRINK_TUNNEL_VERTICAL)
+									collision(k, l) = SHRINK_TUNNEL_HORIZONTAL;
 							}
 						}
 					}
@@ -445,19 +388,19 @@ void Environment::loadArea(int id, int from, bool playMusic) {
 				
 
 				//Flip switches that have been marked as changed
-				if (Util::isCylinderSwitchLeft(collision[i][j]) || Util::isCylinderSwitchRight(collision[i][j])) {
-					int id = ids[i][j];
+				if (Util::isCylinderSwitchLeft(collision(i, j)) || Util::isCylinderSwitchRight(collision(i, j))) {
+					int id = ids(i, j);
 					//Scan the area for cylinders linked to this switch
 					for (int k = 0; k < areaWidth; k++) {
 						for (int l = 0; l < areaHeight; l++) {
 							//If this id matches the switch we flipped
-							if (ids[k][l] == id) {
+							if (ids(k, l) == id) {
 								//Switch up cylinders down
-								if (Util::isCylinderUp(collision[k][l])) {
-									collision[k][l] -= 16;
+								if (Util::isCylinderUp(collision(k, l))) {
+									collision(k, l) -= 16;
 								//Switch down cylinders up
-								} else if (Util::isCylinderDown(collision[k][l])) {
-									collision[k][l] += 16;
+								} else if (Util::isCylinderDown(collision(k, l))) {
+									collision(k, l) += 16;
 								}
 							}
 						}
@@ -468,6 +411,12 @@ void Environment::loadArea(int id, int from, bool playMusic) {
 	}
 	
 
+	//Find each enemy group's blocks now that the area is loaded
+	smh->enemyGroupManager->indexTiles();
+
+	//Draw the area for the map window
+	miniMap->bake();
+
 	//Place the player. If after the first pass there was no zone entrance for where the player came from,
 	//scan the area again and put the player in the first start square.
 	int playerX = -1;
@@ -476,7 +425,7 @@ void Environment::loadArea(int id, int from, bool playMusic) {
 		if (playerX == -1 && playerY == -1) {
 			for (int row = 0; row < areaHeight; row++) {
 				for (int col = 0; col < areaWidth; col++) {
-					if (collision[col][row] == PLAYER_START && (ids[col][row] == from || i == 1)) {
+					if (collision(col, row) == PLAYER_START && (ids(col, row) == from || i == 1)) {
 						playerX = col;
 						playerY = row;
 					}
@@ -509,7 +458,9 @@ void Environment::draw(float dt) {
 
 	drawPits(dt);
 
-	//Loop through each tile to draw shit
+	//Loop through each tile to draw shit. Tiles don't overlap so each layer can be drawn
+	//in whatever order keeps the texture switches down.
+	smh->spriteBatch->beginSorted();
 	for (int j = -1; j <= screenHeight + 1; j++) {
 		for (int i = -1; i <= screenWidth + 1; i++) {
 			
@@ -518,149 +469,69 @@ void Environment::draw(float dt) {
 
 			if (isInBounds(i+xGridOffset, j+yGridOffset)) {	
 
-				int theTerrain = terrain[i+xGridOffset][j+yGridOffset];
-				int theCollision = collision[i+xGridOffset][j+yGridOffset];
-				int theItem = item[i+xGridOffset][j+yGridOffset];
-				float timeSinceSquareActivated = smh->timePassedSince(activated[i+xGridOffset][j+yGridOffset]);
+				int theTerrain = terrain(i+xGridOffset, j+yGridOffset);
+				int theCollision = collision(i+xGridOffset, j+yGridOffset);
+				int theItem = item(i+xGridOffset, j+yGridOffset);
 
 				//Terrain
-				if (theCollision != PIT && theCollision != FAKE_PIT && theCollision != NO_WALK_PIT) {
+				if (!TileTraits::has(theCollision, TileTraits::Pit)) {
 					if (theTerrain > 0 && theTerrain < 256) {
 						smh->resources->GetAnimation("mainLayer")->SetFrame(theTerrain);
-						smh->resources->GetAnimation("mainLayer")->Render(drawX,drawY);
+						smh->spriteBatch->render(smh->resources->GetAnimation("mainLayer"), drawX, drawY, TERRAIN_LAYER);
 					} else {
-						smh->resources->GetSprite("blackSquare")->Render(drawX, drawY);
+						smh->spriteBatch->render(smh->resources->GetSprite("blackSquare"), drawX, drawY, TERRAIN_LAYER);
 					}
 				}
 
 				//Collision
-				if (shouldEnvironmentDrawCollision(theCollision))
-				{					
-					//Water animation
-					if (theCollision == SHALLOW_WATER) {
-						smh->resources->GetAnimation("water")->SetColor(ARGB(125,255,255,255));
-						smh->resources->GetAnimation("water")->Render(drawX,drawY);
-					} else if (theCollision == DEEP_WATER || theCollision == NO_WALK_WATER) {
-						smh->resources->GetAnimation("water")->SetColor(ARGB(255,255,255,255));
-						smh->resources->GetAnimation("water")->Render(drawX,drawY);
-					} else if (theCollision == WALK_LAVA || theCollision == NO_WALK_LAVA) {
-						smh->resources->GetAnimation("lava")->Render(drawX,drawY);
-					} else if (theCollision == GREEN_WATER) {
-						smh->resources->GetAnimation("greenWater")->SetColor(ARGB(255,255,255,255));
-						smh->resources->GetAnimation("greenWater")->Render(drawX,drawY);
-					} else if (theCollision == SHALLOW_GREEN_WATER) {
-						smh->resources->GetAnimation("greenWater")->SetColor(ARGB(125,255,255,255));
-						smh->resources->GetAnimation("greenWater")->Render(drawX,drawY);
-					} else if (theCollision == SPRING_PAD && smh->getGameTime() - 0.5f < activated[i+xGridOffset][j+yGridOffset]) {
-						smh->resources->GetAnimation("spring")->Render(drawX,drawY);
-					} else if (theCollision == SUPER_SPRING && smh->getGameTime() - 0.5f < activated[i+xGridOffset][j+yGridOffset]) {
-						smh->resources->GetAnimation("superSpring")->Render(drawX, drawY);
-					
-					//Switch animations
-					} else if ((theCollision == SILVER_SWITCH_LEFT || theCollision == SILVER_SWITCH_RIGHT) && timeSinceSquareActivated < SWITCH_DELAY) {
-						smh->resources->GetAnimation("silverSwitch")->Render(drawX,drawY);
-					} else if ((theCollision == BROWN_SWITCH_LEFT || theCollision == BROWN_SWITCH_RIGHT) && timeSinceSquareActivated < SWITCH_DELAY) {
-						smh->resources->GetAnimation("brownSwitch")->Render(drawX,drawY);
-					} else if ((theCollision == BLUE_SWITCH_LEFT || theCollision == BLUE_SWITCH_RIGHT) && timeSinceSquareActivated < SWITCH_DELAY) {
-						smh->resources->GetAnimation("blueSwitch")->Render(drawX,drawY);
-					} else if ((theCollision == GREEN_SWITCH_LEFT || theCollision == GREEN_SWITCH_RIGHT) && timeSinceSquareActivated < SWITCH_DELAY) {
-						smh->resources->GetAnimation("greenSwitch")->Render(drawX,drawY);
-					} else if ((theCollision == YELLOW_SWITCH_LEFT || theCollision == YELLOW_SWITCH_RIGHT) && timeSinceSquareActivated < SWITCH_DELAY) {
-						smh->resources->GetAnimation("yellowSwitch")->Render(drawX,drawY);
-					} else if ((theCollision == WHITE_SWITCH_LEFT || theCollision == WHITE_SWITCH_RIGHT) && timeSinceSquareActivated < SWITCH_DELAY) {
-						smh->resources->GetAnimation("whiteSwitch")->Render(drawX,drawY);
-					
-					//Special switches
-					} else if (theCollision == SPIN_ARROW_SWITCH && timeSinceSquareActivated < 0.45) {
-						smh->resources->GetAnimation("bunnySwitch")->Render(drawX, drawY);
-					} else if (theCollision == MIRROR_SWITCH && timeSinceSquareActivated < 0.45) {
-						smh->resources->GetAnimation("mirrorSwitch")->Render(drawX, drawY);
-					} else if (theCollision == SHRINK_TUNNEL_SWITCH && timeSinceSquareActivated < 0.45) {
-						smh->resources->GetAnimation("shrinkTunnelSwitch")->Render(drawX, drawY);
-
-					//Cylinder animations
-					} else if ((theCollision == SILVER_CYLINDER_DOWN) && timeSinceSquareActivated < SWITCH_DELAY) {
-						silverCylinder->Render(drawX,drawY);
-					} else if ((theCollision == SILVER_CYLINDER_UP) && timeSinceSquareActivated < SWITCH_DELAY) {
-						silverCylinderRev->Render(drawX,drawY);
-					} else if ((theCollision == BROWN_CYLINDER_DOWN) && timeSinceSquareActivated < SWITCH_DELAY) {
-						brownCylinder->Render(drawX,drawY);
-					} else if ((theCollision == BROWN_CYLINDER_UP) && timeSinceSquareActivated < SWITCH_DELAY) {
-						brownCylinderRev->Render(drawX,drawY);
-					} else if ((theCollision == BLUE_CYLINDER_DOWN) && timeSinceSquareActivated < SWITCH_DELAY) {
-						blueCylinder->Render(drawX,drawY);
-					} else if ((theCollision == BLUE_CYLINDER_UP) && timeSinceSquareActivated < SWITCH_DELAY) {
-						blueCylinderRev->Render(drawX,drawY);
-					} else if ((theCollision == GREEN_CYLINDER_DOWN) && timeSinceSquareActivated < SWITCH_DELAY) {
-						greenCylinder->Render(drawX,drawY);
-					} else if ((theCollision == GREEN_CYLINDER_UP) && timeSinceSquareActivated < SWITCH_DELAY) {
-						greenCylinderRev->Render(drawX,drawY);
-					} else if ((theCollision == YELLOW_CYLINDER_DOWN) && timeSinceSquareActivated < SWITCH_DELAY) {
-						yellowCylinder->Render(drawX,drawY);
-					} else if ((theCollision == YELLOW_CYLINDER_UP) && timeSinceSquareActivated < SWITCH_DELAY) {
-						yellowCylinderRev->Render(drawX,drawY);
-					} else if ((theCollision == WHITE_CYLINDER_DOWN) && timeSinceSquareActivated < SWITCH_DELAY) {
-						whiteCylinder->Render(drawX,drawY);
-					} else if ((theCollision == WHITE_CYLINDER_UP) && timeSinceSquareActivated < SWITCH_DELAY) {
-						whiteCylinderRev->Render(drawX,drawY);
-
-					//Save thing
-					} else if (theCollision == SAVE_SHRINE) {
-						smh->resources->GetAnimation("savePoint")->Render(drawX, drawY);
-
-					//Don't draw the EVIL WALL position and restart tiles
-					} else if (theCollision == EVIL_WALL_POSITION || theCollision == EVIL_WALL_RESTART) {
-
-						//Don't draw anything
-
-					//Non-animated collision tiles
-					} else {
-
-						//Set to current tile
-						smh->resources->GetAnimation("walkLayer")->SetFrame(theCollision);
-
-						//Set color values
-						if (theCollision >= UP_ARROW && theCollision <= LEFT_ARROW) {
-							if (ids[i+xGridOffset][j+yGridOffset] == -1 || ids[i+xGridOffset][j+yGridOffset] == 990) {
-								//render normal, red arrow
-								smh->resources->GetAnimation("walkLayer")->SetColor(ARGB(255,255,0,255));							
-							} else { 
-								//it's a rotating arrow, make it green
-								smh->resources->GetAnimation("walkLayer")->SetColor(ARGB(255,0,255,255));					
-							}
-						} else if (theCollision == SHALLOW_WATER) {
-							smh->resources->GetAnimation("walkLayer")->SetColor(ARGB(125,255,255,255));
-						} else if (theCollision == SLIME) {
-							smh->resources->GetAnimation("walkLayer")->SetColor(ARGB(200,255,255,255));
+				if (TileTraits::has(theCollision, TileTraits::DrawsCollision) && 
+					(!TileTraits::has(theCollision, TileTraits::Animated) || !drawAnimatedCollision(theCollision, i+xGridOffset, j+yGridOffset)))
+				{
+					//Set to current tile
+					smh->resources->GetAnimation("walkLayer")->SetFrame(theCollision);
+
+					//Set color values
+					if (theCollision >= UP_ARROW && theCollision <= LEFT_ARROW) {
+						if (ids(i+xGridOffset, j+yGridOffset) == -1 || ids(i+xGridOffset, j+yGridOffset) == 990) {
+							//render normal, red arrow
+							smh->resources->GetAnimation("walkLayer")->SetColor(ARGB(255,255,0,255));							
+						} else { 
+							//it's a rotating arrow, make it green
+							smh->resources->GetAnimation("walkLayer")->SetColor(ARGB(255,0,255,255));					
 						}
+					} else if (theCollision == SHALLOW_WATER) {
+						smh->resources->GetAnimation("walkLayer")->SetColor(ARGB(125,255,255,255));
+					} else if (theCollision == SLIME) {
+						smh->resources->GetAnimation("walkLayer")->SetColor(ARGB(200,255,255,255));
+					}
 
-						//Draw it and set the color back to normal
-						smh->resources->GetAnimation("walkLayer")->Render(drawX,drawY);
-						smh->resources->GetAnimation("walkLayer")->SetColor(ARGB(255,255,255,255));
+					//Draw it and set the color back to normal
+					smh->spriteBatch->render(smh->resources->GetAnimation("walkLayer"), drawX, drawY, COLLISION_LAYER);
+					smh->resources->GetAnimation("walkLayer")->SetColor(ARGB(255,255,255,255));
 
-					}
 				}
 
 				//Items
-				if (theItem != NONE && ids[i+xGridOffset][j+yGridOffset] != DRAW_AFTER_SMILEY) {
+				if (theItem != NONE && ids(i+xGridOffset, j+yGridOffset) != DRAW_AFTER_SMILEY) {
 					if (theItem == ENEMYGROUP_BLOCKGRAPHIC) {
 						//If this is an enemy block, draw it with the enemy group's
 						//block alpha
 						itemLayer[theItem]->SetColor(ARGB(
-							smh->enemyGroupManager->groups[variable[i+xGridOffset][j+yGridOffset]].blockAlpha, 255, 255, 255));
-						itemLayer[theItem]->Render(drawX,drawY);
+							smh->enemyGroupManager->groups[variable(i+xGridOffset, j+yGridOffset)].blockAlpha, 255, 255, 255));
+						smh->spriteBatch->render(itemLayer[theItem], drawX, drawY, ITEM_LAYER);
 						itemLayer[theItem]->SetColor(ARGB(255,255,255,255));
 					} else {
-						itemLayer[theItem]->Render(drawX,drawY);
+						smh->spriteBatch->render(itemLayer[theItem], drawX, drawY, ITEM_LAYER);
 					}
 				}
 			
 			} else {
 				//Out of bounds
-				smh->resources->GetSprite("blackSquare")->Render(drawX, drawY);
+				smh->spriteBatch->render(smh->resources->GetSprite("blackSquare"), drawX, drawY, TERRAIN_LAYER);
 			}
 		}
 	}
+	smh->spriteBatch->endSorted();
 
 	//Draw fountain before smiley if he is below it
 	if (fountain && !fountain->isAboveSmiley()) {
@@ -671,7 +542,7 @@ void Environment::draw(float dt) {
 	for (std::list<ParticleStruct>::iterator i = particleList.begin(); i != particleList.end(); i++) {
 		i->particle->MoveTo(smh->getScreenX(i->x), smh->getScreenY(i->y), true);
 		i->particle->Update(dt);
-		i->particle->Render();
+		smh->particlePool->render(i->particle);
 	}
 
 	//Debug mode stuff
@@ -693,9 +564,9 @@ void Environment::draw(float dt) {
 					if (hasSillyPad(i,j)) {
 						collisionBox->SetRadius(i*64+32,j*64+32,24);
 					} else {
-						setTerrainCollisionBox(collisionBox, collision[i][j], i, j);
+						setTerrainCollisionBox(collisionBox, collision(i, j), i, j);
 					}
-					if (!smh->player->canPass(collision[i][j]) || hasSillyPad(i,j)) smh->drawCollisionBox(collisionBox, Colors::GREEN);
+					if (!smh->player->canPass(collision(i, j)) || hasSillyPad(i,j)) smh->drawCollisionBox(collisionBox, Colors::GREEN);
 				}
 			}
 		}
@@ -711,8 +582,101 @@ void Environment::draw(float dt) {
 
 }
 
+/**
+ * Draws the collision tiles that are animated or drawn specially. Returns false if
+ * the tile should be drawn from the walk layer like any other collision tile
+ * instead, for example a switch that isn't in the middle of flipping.
+ */
+bool Environment::drawAnimatedCollision(int theCollision, int gridX, int gridY) {
+
+	float timeSinceSquareActivated = smh->timePassedSince(activated(gridX, gridY));
+
+	//Water animation
+	if (theCollision == SHALLOW_WATER) {
+		smh->resources->GetAnimation("water")->SetColor(ARGB(125,255,255,255));
+		smh->spriteBatch->render(smh->resources->GetAnimation("water"), drawX, drawY, COLLISION_LAYER);
+	} else if (theCollision == DEEP_WATER || theCollision == NO_WALK_WATER) {
+		smh->resources->GetAnimation("water")->SetColor(ARGB(255,255,255,255));
+		smh->spriteBatch->render(smh->resources->GetAnimation("water"), drawX, drawY, COLLISION_LAYER);
+	} else if (theCollision == WALK_LAVA || theCollision == NO_WALK_LAVA) {
+		smh->spriteBatch->render(smh->resources->GetAnimation("lava"), drawX, drawY, COLLISION_LAYER);
+	} else if (theCollision == GREEN_WATER) {
+		smh->resources->GetAnimation("greenWater")->SetColor(ARGB(255,255,255,255));
+		smh->spriteBatch->render(smh->resources->GetAnimation("greenWater"), drawX, drawY, COLLISION_LAYER);
+	} else if (theCollision == SHALLOW_GREEN_WATER) {
+		smh->resources->GetAnimation("greenWater")->SetColor(ARGB(125,255,255,255));
+		smh->spriteBatch->render(smh->resources->GetAnimation("greenWater"), drawX, drawY, COLLISION_LAYER);
+	} else if (theCollision == SPRING_PAD && smh->getGameTime() - 0.5f < activated(gridX, gridY)) {
+		smh->spriteBatch->render(smh->resources->GetAnimation("spring"), drawX, drawY, COLLISION_LAYER);
+	} else if (theCollision == SUPER_SPRING && smh->getGameTime() - 0.5f < activated(gridX, gridY)) {
+		smh->spriteBatch->render(smh->resources->GetAnimation("superSpring"), drawX, drawY, COLLISION_LAYER);
+
+	//Switch animations
+	} else if ((theCollision == SILVER_SWITCH_LEFT || theCollision == SILVER_SWITCH_RIGHT) && timeSinceSquareActivated < SWITCH_DELAY) {
+		smh->spriteBatch->render(smh->resources->GetAnimation("silverSwitch"), drawX, drawY, COLLISION_LAYER);
+	} else if ((theCollision == BROWN_SWITCH_LEFT || theCollision == BROWN_SWITCH_RIGHT) && timeSinceSquareActivated < SWITCH_DELAY) {
+		smh->spriteBatch->render(smh->resources->GetAnimation("brownSwitch"), drawX, drawY, COLLISION_LAYER);
+	} else if ((theCollision == BLUE_SWITCH_LEFT || theCollision == BLUE_SWITCH_RIGHT) && timeSinceSquareActivated < SWITCH_DELAY) {
+		smh->spriteBatch->render(smh->resources->GetAnimation("blueSwitch"), drawX, drawY, COLLISION_LAYER);
+	} else if ((theCollision == GREEN_SWITCH_LEFT || theCollision == GREEN_SWITCH_RIGHT) && timeSinceSquareActivated < SWITCH_DELAY) {
+		smh->spriteBatch->render(smh->resources->GetAnimation("greenSwitch"), drawX, drawY, COLLISION_LAYER);
+	} else if ((theCollision == YELLOW_SWITCH_LEFT || theCollision == YELLOW_SWITCH_RIGHT) && timeSinceSquareActivated < SWITCH_DELAY) {
+		smh->spriteBatch->render(smh->resources->GetAnimation("yellowSwitch"), drawX, drawY, COLLISION_LAYER);
+	} else if ((theCollision == WHITE_SWITCH_LEFT || theCollision == WHITE_SWITCH_RIGHT) && timeSinceSquareActivated < SWITCH_DELAY) {
+		smh->spriteBatch->render(smh->resources->GetAnimation("whiteSwitch"), drawX, drawY, COLLISION_LAYER);
+
+	//Special switches
+	} else if (theCollision == SPIN_ARROW_SWITCH && timeSinceSquareActivated < 0.45) {
+		smh->spriteBatch->render(smh->resources->GetAnimation("bunnySwitch"), drawX, drawY, COLLISION_LAYER);
+	} else if (theCollision == MIRROR_SWITCH && timeSinceSquareActivated < 0.45) {
+		smh->spriteBatch->render(smh->resources->GetAnimation("mirrorSwitch"), drawX, drawY, COLLISION_LAYER);
+	} else if (theCollision == SHRINK_TUNNEL_SWITCH && timeSinceSquareActivated < 0.45) {
+		smh->spriteBatch->render(smh->resources->GetAnimation("shrinkTunnelSwitch"), drawX, drawY, COLLISION_LAYER);
+
+	//Cylinder animations
+	} else if ((theCollision == SILVER_CYLINDER_DOWN) && timeSinceSquareActivated < SWITCH_DELAY) {
+		smh->spriteBatch->render(silverCylinder, drawX, drawY, COLLISION_LAYER);
+	} else if ((theCollision == SILVER_CYLINDER_UP) && timeSinceSquareActivated < SWITCH_DELAY) {
+		smh->spriteBatch->render(silverCylinderRev, drawX, drawY, COLLISION_LAYER);
+	} else if ((theCollision == BROWN_CYLINDER_DOWN) && timeSinceSquareActivated < SWITCH_DELAY) {
+		smh->spriteBatch->render(brownCylinder, drawX, drawY, COLLISION_LAYER);
+	} else if ((theCollision == BROWN_CYLINDER_UP) && timeSinceSquareActivated < SWITCH_DELAY) {
+		smh->spriteBatch->render(brownCylinderRev, drawX, drawY, COLLISION_LAYER);
+	} else if ((theCollision == BLUE_CYLINDER_DOWN) && timeSinceSquareActivated < SWITCH_DELAY) {
+		smh->spriteBatch->render(blueCylinder, drawX, drawY, COLLISION_LAYER);
+	} else if ((theCollision == BLUE_CYLINDER_UP) && timeSinceSquareActivated < SWITCH_DELAY) {
+		smh->spriteBatch->render(blueCylinderRev, drawX, drawY, COLLISION_LAYER);
+	} else if ((theCollision == GREEN_CYLINDER_DOWN) && timeSinceSquareActivated < SWITCH_DELAY) {
+		smh->spriteBatch->render(greenCylinder, drawX, drawY, COLLISION_LAYER);
+	} else if ((theCollision == GREEN_CYLINDER_UP) && timeSinceSquareActivated < SWITCH_DELAY) {
+		smh->spriteBatch->render(greenCylinderRev, drawX, drawY, COLLISION_LAYER);
+	} else if ((theCollision == YELLOW_CYLINDER_DOWN) && timeSinceSquareActivated < SWITCH_DELAY) {
+		smh->spriteBatch->render(yellowCylinder, drawX, drawY, COLLISION_LAYER);
+	} else if ((theCollision == YELLOW_CYLINDER_UP) && timeSinceSquareActivated < SWITCH_DELAY) {
+		smh->spriteBatch->render(yellowCylinderRev, drawX, drawY, COLLISION_LAYER);
+	} else if ((theCollision == WHITE_CYLINDER_DOWN) && timeSinceSquareActivated < SWITCH_DELAY) {
+		smh->spriteBatch->render(whiteCylinder, drawX, drawY, COLLISION_LAYER);
+	} else if ((theCollision == WHITE_CYLINDER_UP) && timeSinceSquareActivated < SWITCH_DELAY) {
+		smh->spriteBatch->render(whiteCylinderRev, drawX, drawY, COLLISION_LAYER);
+
+	//Save thing
+	} else if (theCollision == SAVE_SHRINE) {
+		smh->spriteBatch->render(smh->resources->GetAnimation("savePoint"), drawX, drawY, COLLISION_LAYER);
+
+	//Don't draw the EVIL WALL position and restart tiles
+	} else if (theCollision == EVIL_WALL_POSITION || theCollision == EVIL_WALL_RESTART) {
+
+		//Don't draw anything
+
+	} else {
+		return false;
+	}
+
+	return true;
+}
+
 void Environment::addSnowBlock(int gridX, int gridY) {
-	collision[gridX][gridY] = FIRE_DESTROY;
+	collision(gridX, gridY) = FIRE_DESTROY;
 	specialTileManager->addIceBlock(gridX, gridY);
 
 }
@@ -737,12 +701,12 @@ void Environment::drawPits(float dt) {
 			for (int x = gridX-1; x <= gridX+1; x++) {
 				for (int y = gridY-1; y <= gridY+1; y++) {
 					if (!isInBounds(x,y)) break;
-					if (collision[x][y] == PIT || collision[x][y] == FAKE_PIT || collision[x][y] == NO_WALK_PIT) draw = true;
+					if (TileTraits::has(collision(x, y), TileTraits::Pit)) draw = true;
 				}
 			}
 
 			if (draw && isInBounds(gridX, gridY)) {
-				smh->resources->GetSprite("parallaxPit")->Render(drawX, drawY);
+				smh->spriteBatch->render(smh->resources->GetSprite("parallaxPit"), drawX, drawY);
 			}
 		}
 	}
@@ -772,18 +736,18 @@ void Environment::drawAfterSmiley(float dt) {
 				//Marked as draw after smiley or the thing above Smiley is marked as draw
 				//above Smiley and Smiley is behind it. That way you can't walk behind a tree
 				//and lick through it.
-				if (ids[gridX][gridY] == DRAW_AFTER_SMILEY || 
-						(ids[gridX][gridY-1] == DRAW_AFTER_SMILEY && 
+				if (ids(gridX, gridY) == DRAW_AFTER_SMILEY || 
+						(ids(gridX, gridY-1) == DRAW_AFTER_SMILEY && 
 						smh->player->gridX == gridX && 
 						smh->player->gridY < gridY)) {
-					itemLayer[item[gridX][gridY]]->Render(drawX,drawY);
+					itemLayer[item(gridX, gridY)]->Render(drawX,drawY);
 				}
 
 				//Shrink tunnels unless Smiley is directly underneath it and not shrunk
-				if ((collision[gridX][gridY] == SHRINK_TUNNEL_HORIZONTAL || 
-						collision[gridX][gridY] == SHRINK_TUNNEL_VERTICAL) &&
+				if ((collision(gridX, gridY) == SHRINK_TUNNEL_HORIZONTAL || 
+						collision(gridX, gridY) == SHRINK_TUNNEL_VERTICAL) &&
 						!(smh->player->gridY == gridY+1 && !smh->player->isShrunk())) {
-					smh->resources->GetAnimation("walkLayer")->SetFrame(collision[gridX][gridY]);
+					smh->resources->GetAnimation("walkLayer")->SetFrame(collision(gridX, gridY));
 					smh->resources->GetAnimation("walkLayer")->Render(drawX, drawY);
 				}
 
@@ -858,8 +822,8 @@ void Environment::update(float dt) {
 		for (int j = 0; j < areaHeight; j++) {
 
 			//Update timed switches
-			if (Util::isCylinderSwitchLeft(collision[i][j]) || Util::isCylinderSwitchRight(collision[i][j])) {
-				if (variable[i][j] != -1 && activated[i][j] + (float)variable[i][j] < smh->getGameTime() && 
+			if (Util::isCylinderSwitchLeft(collision(i, j)) || Util::isCylinderSwitchRight(collision(i, j))) {
+				if (variable(i, j) != -1 && activated(i, j) + (float)variable(i, j) < smh->getGameTime() && 
 						smh->saveManager->isTileChanged( i, j)) {
 					
 					//Make sure the player isn't on top of any of the cylinders that will pop up
@@ -904,25 +868,6 @@ void Environment::killSwitchTimer(int gridX, int gridY) {
 	}
 }
 
-/**
- * Returns what type of collision there is at point (x,y)
- */
-int Environment::collisionAt(float x, float y) {
-	
-	//Determine grid coords of the object
-	int gridX = x / (float)64.0;
-	int gridY = y / (float)64.0;
-
-	//Handle out of bounds input
-	if (!isInBounds(gridX,gridY)) {
-		return UNWALKABLE;
-	}
-
-	//Return the collision type
-	return collision[gridX][gridY];
-
-}
-
 void Environment::unlockDoor(int gridX, int gridY) {
 	bool doorOpened = false;
 
@@ -931,26 +876,27 @@ void Environment::unlockDoor(int gridX, int gridY) {
 
 	//If this square is a door and the player has the key, unlock it
 	//The -1 after each key index is because in the item layer, item 0 is blank, and item 1 is red key -- but we want the key indices to start with 0.
-	if (collision[gridX][gridY] == RED_KEYHOLE && smh->saveManager->numKeys[Util::getKeyIndex(smh->saveManager->currentArea)][RED_KEY-1] > 0) {
-		collision[gridX][gridY] = WALKABLE;
+	if (collision(gridX, gridY) == RED_KEYHOLE && smh->saveManager->numKeys[Util::getKeyIndex(smh->saveManager->currentArea)][RED_KEY-1] > 0) {
+		collision(gridX, gridY) = WALKABLE;
 		smh->saveManager->numKeys[Util::getKeyIndex(smh->saveManager->currentArea)][RED_KEY-1]--;
 		doorOpened = true;
-	} else  if (collision[gridX][gridY] == BLUE_KEYHOLE && smh->saveManager->numKeys[Util::getKeyIndex(smh->saveManager->currentArea)][BLUE_KEY-1] > 0) {
-		collision[gridX][gridY] = WALKABLE;
+	} else  if (collision(gridX, gridY) == BLUE_KEYHOLE && smh->saveManager->numKeys[Util::getKeyIndex(smh->saveManager->currentArea)][BLUE_KEY-1] > 0) {
+		collision(gridX, gridY) = WALKABLE;
 		smh->saveManager->numKeys[Util::getKeyIndex(smh->saveManager->currentArea)][BLUE_KEY-1]--;
 		doorOpened = true;
-	} else if (collision[gridX][gridY] == YELLOW_KEYHOLE && smh->saveManager->numKeys[Util::getKeyIndex(smh->saveManager->currentArea)][YELLOW_KEY-1] > 0) {
-		collision[gridX][gridY] = WALKABLE;
+	} else if (collision(gridX, gridY) == YELLOW_KEYHOLE && smh->saveManager->numKeys[Util::getKeyIndex(smh->saveManager->currentArea)][YELLOW_KEY-1] > 0) {
+		collision(gridX, gridY) = WALKABLE;
 		smh->saveManager->numKeys[Util::getKeyIndex(smh->saveManager->currentArea)][YELLOW_KEY-1]--;
 		doorOpened = true;
-	} else if (collision[gridX][gridY] == GREEN_KEYHOLE && smh->saveManager->numKeys[Util::getKeyIndex(smh->saveManager->currentArea)][GREEN_KEY-1] > 0) {
-		collision[gridX][gridY] = WALKABLE;
+	} else if (collision(gridX, gridY) == GREEN_KEYHOLE && smh->saveManager->numKeys[Util::getKeyIndex(smh->saveManager->currentArea)][GREEN_KEY-1] > 0) {
+		collision(gridX, gridY) = WALKABLE;
 		smh->saveManager->numKeys[Util::getKeyIndex(smh->saveManager->currentArea)][GREEN_KEY-1]--;
 		doorOpened = true;
 	}
 
 	//Remember that this door was opened! Also, play a sound
 	if (doorOpened) {
+		playerMovement.haveBlockedSquares = false;
 		smh->soundManager->playSound("snd_UnlockDoor");
 		smh->saveManager->change( gridX, gridY);
 	}
@@ -978,10 +924,10 @@ bool Environment::toggleSwitches(hgeRect *box, bool playSoundFarAway, bool playT
 			if (isInBounds(gridX,gridY)) {
 
 				//Set collision box for this square
-				setTerrainCollisionBox(collisionBox,collision[gridX][gridY],gridX,gridY);
+				setTerrainCollisionBox(collisionBox,collision(gridX, gridY),gridX,gridY);
 				
 				//Check collision with any switches
-				if (smh->timePassedSince(activated[gridX][gridY]) > SWITCH_DELAY && collisionBox->Intersect(box)) {
+				if (smh->timePassedSince(activated(gridX, gridY)) > SWITCH_DELAY && collisionBox->Intersect(box)) {
 					if (toggleSwitchAt(gridX, gridY, playSoundFarAway, playTimerSound)) return true;
 				}
 			}
@@ -1007,10 +953,10 @@ bool Environment::toggleSwitches(Tongue *tongue) {
 			if (isInBounds(gridX,gridY)) {
 
 				//Set collision box for this square
-				setTerrainCollisionBox(collisionBox,collision[gridX][gridY],gridX,gridY);
+				setTerrainCollisionBox(collisionBox,collision(gridX, gridY),gridX,gridY);
 				
 				//Check collision with any switches
-				if (smh->timePassedSince(activated[gridX][gridY]) > TONGUE_SWITCH_DELAY && tongue->testCollision(collisionBox)) {			
+				if (smh->timePassedSince(activated(gridX, gridY)) > TONGUE_SWITCH_DELAY && tongue->testCollision(collisionBox)) {			
 					if (toggleSwitchAt(gridX, gridY, true, true)) {
 						return true;
 					}
@@ -1032,7 +978,7 @@ bool Environment::toggleSwitches(Tongue *tongue) {
 void Environment::toggleSwitch(int id) {
 	for (int i = 0; i < areaWidth; i++) {
 		for (int j = 0; j < areaHeight; j++) {
-			if (ids[i][j] == id && (Util::isCylinderSwitchLeft(collision[i][j]) || Util::isCylinderSwitchLeft(collision[i][j]))) {
+			if (ids(i, j) == id && (Util::isCylinderSwitchLeft(collision(i, j)) || Util::isCylinderSwitchLeft(collision(i, j)))) {
 				toggleSwitchAt(i,j,true, false);
 				return;
 			}
@@ -1052,79 +998,79 @@ void Environment::toggleSwitch(int id) {
  * playSoundFarAway parameter is true then the sound will be guaranteed to play if a switch is switched.
  */
 bool Environment::toggleSwitchAt(int gridX, int gridY, bool playSoundFarAway, bool playTimerSound) {
-	int switchID = ids[gridX][gridY];
+	int switchID = ids(gridX, gridY);
 	bool hasSwitch = false;
-	bool hitToggledTimedSwitch = smh->timePassedSince(activated[gridX][gridY]) < variable[gridX][gridY] && smh->saveManager->isTileChanged(gridX, gridY);
+	bool hitToggledTimedSwitch = smh->timePassedSince(activated(gridX, gridY)) < variable(gridX, gridY) && smh->saveManager->isTileChanged(gridX, gridY);
 		
 	//Flip cylinder switch
-	if (Util::isCylinderSwitchLeft(collision[gridX][gridY]) || Util::isCylinderSwitchRight(collision[gridX][gridY])) {
+	if (Util::isCylinderSwitchLeft(collision(gridX, gridY)) || Util::isCylinderSwitchRight(collision(gridX, gridY))) {
 
 		flipCylinderSwitch(gridX, gridY);
 		hasSwitch = true;
 
 	//Rotate Shrink tunnels
-	} else if (collision[gridX][gridY] == SHRINK_TUNNEL_SWITCH) {
+	} else if (collision(gridX, gridY) == SHRINK_TUNNEL_SWITCH) {
 
 		hasSwitch = true;
-		activated[gridX][gridY] = smh->getGameTime();
+		activated(gridX, gridY) = smh->getGameTime();
 		smh->resources->GetAnimation("shrinkTunnelSwitch")->Play();
 		smh->saveManager->change(gridX,gridY);
 
 		//Loop through the grid and look for shrink tunnels with the same id as the switch
 		for (int i = 0; i < areaWidth; i++) {
 			for (int j = 0; j < areaHeight; j++) {
-				if (ids[i][j] == switchID) {
+				if (ids(i, j) == switchID) {
 					smh->soundManager->playSwitchSound(i, j, false);
 					//When found, rotate clockwise.
-					if (collision[i][j] == SHRINK_TUNNEL_HORIZONTAL) 
-						collision[i][j] = SHRINK_TUNNEL_VERTICAL;
-					else if (collision[i][j] == SHRINK_TUNNEL_VERTICAL) 
-						collision[i][j] = SHRINK_TUNNEL_HORIZONTAL;
+					if (collision(i, j) == SHRINK_TUNNEL_HORIZONTAL) 
+						collision(i, j) = SHRINK_TUNNEL_VERTICAL;
+					else if (collision(i, j) == SHRINK_TUNNEL_VERTICAL) 
+						collision(i, j) = SHRINK_TUNNEL_HORIZONTAL;
 				}
 			}
 		}
 
 	//Rotate arrows switch
-	} else if (collision[gridX][gridY] == SPIN_ARROW_SWITCH) {
+	} else if (collision(gridX, gridY) == SPIN_ARROW_SWITCH) {
 
 		hasSwitch = true;
-		activated[gridX][gridY] = smh->getGameTime();
+		activated(gridX, gridY) = smh->getGameTime();
 		smh->resources->GetAnimation("bunnySwitch")->Play();
 
 		//Loop through the grid and look for arrows with the same id as the switch
 		for (int i = 0; i < areaWidth; i++) {
 			for (int j = 0; j < areaHeight; j++) {
-				if (ids[i][j] == switchID) {
+				if (ids(i, j) == switchID) {
 					smh->soundManager->playSwitchSound(i, j, false);
 					//When found, rotate clockwise.
-					if (collision[i][j] == UP_ARROW) 
-						collision[i][j] = RIGHT_ARROW;
-					else if (collision[i][j] == RIGHT_ARROW) 
-						collision[i][j] = DOWN_ARROW;
-					else if (collision[i][j] == DOWN_ARROW) 
-						collision[i][j] = LEFT_ARROW;
-					else if (collision[i][j] == LEFT_ARROW) 
-						collision[i][j] = UP_ARROW;
+					if (collision(i, j) == UP_ARROW) 
+						collision(i, j) = RIGHT_ARROW;
+					else if (collision(i, j) == RIGHT_ARROW) 
+						collision(i, j) = DOWN_ARROW;
+					else if (collision(i, j) == DOWN_ARROW) 
+						collision(i, j) = LEFT_ARROW;
+					else if (collision(i, j) == LEFT_ARROW) 
+						collision(i, j) = UP_ARROW;
 				}
 			}
 		}
 
 	//Rotate mirrors switch
-	} else if (collision[gridX][gridY] == MIRROR_SWITCH) {
+	} else if (collision(gridX, gridY) == MIRROR_SWITCH) {
 
 		hasSwitch = true;
-		activated[gridX][gridY] = smh->getGameTime();
+		activated(gridX, gridY) = smh->getGameTime();
 		smh->resources->GetAnimation("mirrorSwitch")->Play();
 		
 		//Switch up and down cylinders
 		for (int i = 0; i < areaWidth; i++) {
 			for (int j = 0; j < areaHeight; j++) {
-				if (ids[i][j] == switchID) {
+				if (ids(i, j) == switchID) {
 					smh->soundManager->playSwitchSound(i, j, false);
-					if (collision[i][j] == MIRROR_UP_LEFT) collision[i][j] = MIRROR_UP_RIGHT;
-					else if (collision[i][j] == MIRROR_UP_RIGHT) collision[i][j] = MIRROR_DOWN_RIGHT;
-					else if (collision[i][j] == MIRROR_DOWN_RIGHT) collision[i][j] = MIRROR_DOWN_LEFT;
-					else if (collision[i][j] == MIRROR_DOWN_LEFT) collision[i][j] = MIRROR_UP_LEFT;
+					if (collision(i, j) == MIRROR_UP_LEFT) collision(i, j) = MIRROR_UP_RIGHT;
+					else if (collision(i, j) == MIRROR_UP_RIGHT) collision(i, j) = MIRROR_DOWN_RIGHT;
+					else if (collision(i, j) == MIRROR_DOWN_RIGHT) collision(i, j) = MIRROR_DOWN_LEFT;
+					else if (collision(i, j) == MIRROR_DOWN_LEFT) collision(i, j) = MIRROR_UP_LEFT;
 				}
 			}
 		}
@@ -1137,12 +1083,12 @@ bool Environment::toggleSwitchAt(int gridX, int gridY, bool playSoundFarAway, bo
 			//If a timed switch was already toggled and then we just untoggled it, we need to
 			//remove the switch's timer.
 			killSwitchTimer(gridX, gridY);
-		} else if (variable[gridX][gridY] != -1) {
+		} else if (variable(gridX, gridY) != -1) {
 			//If this is a timed switch, create a timer to display the time left over the switch
 			Timer timer;
 			timer.x = gridX * 64 + 32;
 			timer.y = gridY * 64;
-			timer.duration = variable[gridX][gridY];
+			timer.duration = variable(gridX, gridY);
 			timer.startTime = smh->getGameTime();
 			timer.lastClockTickTime = smh->getGameTime();
 			timer.playTickSound = playTimerSound;
@@ -1158,11 +1104,11 @@ bool Environment::toggleSwitchAt(int gridX, int gridY, bool playSoundFarAway, bo
  */  
 void Environment::flipCylinderSwitch(int gridX, int gridY) {
 
-	activated[gridX][gridY] = smh->getGameTime();
+	activated(gridX, gridY) = smh->getGameTime();
 
 	//Flip switch in collision layer
-	if (Util::isCylinderSwitchLeft(collision[gridX][gridY])) {
-		collision[gridX][gridY] += 16;
+	if (Util::isCylinderSwitchLeft(collision(gridX, gridY))) {
+		collision(gridX, gridY) += 16;
 		smh->resources->GetAnimation("silverSwitch")->SetMode(HGEANIM_FWD);
 		smh->resources->GetAnimation("brownSwitch")->SetMode(HGEANIM_FWD);
 		smh->resources->GetAnimation("blueSwitch")->SetMode(HGEANIM_FWD);
@@ -1170,8 +1116,8 @@ void Environment::flipCylinderSwitch(int gridX, int gridY) {
 		smh->resources->GetAnimation("yellowSwitch")->SetMode(HGEANIM_FWD);
 		smh->resources->GetAnimation("whiteSwitch")->SetMode(HGEANIM_FWD);
 		smh->saveManager->change(gridX, gridY);
-	} else if (Util::isCylinderSwitchRight(collision[gridX][gridY])) {
-		collision[gridX][gridY] -= 16;
+	} else if (Util::isCylinderSwitchRight(collision(gridX, gridY))) {
+		collision(gridX, gridY) -= 16;
 		smh->resources->GetAnimation("silverSwitch")->SetMode(HGEANIM_REV);
 		smh->resources->GetAnimation("brownSwitch")->SetMode(HGEANIM_REV);
 		smh->resources->GetAnimation("blueSwitch")->SetMode(HGEANIM_REV);
@@ -1188,11 +1134,11 @@ void Environment::flipCylinderSwitch(int gridX, int gridY) {
 	smh->resources->GetAnimation("greenSwitch")->Play();
 	smh->resources->GetAnimation("yellowSwitch")->Play();
 	smh->resources->GetAnimation("whiteSwitch")->Play();
-	activated[gridX][gridY] = smh->getGameTime();
+	activated(gridX, gridY) = smh->getGameTime();
 
 	//Switch up and down cylinders if the player isn't on top of any down cylindersw
 	if (!playerOnCylinder(gridX,gridY)) {
-		switchCylinders(ids[gridX][gridY]);
+		switchCylinders(ids(gridX, gridY));
 	}
 
 }
@@ -1207,14 +1153,14 @@ void Environment::switchCylinders(int switchID) {
 	//Switch up and down cylinders if the player isn't on top of any down cylindersw
 	for (int i = 0; i < areaWidth; i++) {
 		for (int j = 0; j < areaHeight; j++) {
-			if (ids[i][j] == switchID) {
+			if (ids(i, j) == switchID) {
 				smh->soundManager->playSwitchSound(i, j, false);
-				if (Util::isCylinderUp(collision[i][j])) {
-					collision[i][j] -= 16;
-					activated[i][j] = smh->getGameTime();
-				} else if (Util::isCylinderDown(collision[i][j])) {
-					collision[i][j] += 16;
-					activated[i][j] = smh->getGameTime();
+				if (Util::isCylinderUp(collision(i, j))) {
+					collision(i, j) -= 16;
+					activated(i, j) = smh->getGameTime();
+				} else if (Util::isCylinderDown(collision(i, j))) {
+					collision(i, j) += 16;
+					activated(i, j) = smh->getGameTime();
 				}
 				silverCylinder->Play();
 				brownCylinder->Play();
@@ -1238,15 +1184,15 @@ void Environment::switchCylinders(int switchID) {
  * Returns the item in a square (x,y) but does not remove it.
  */
 int Environment::checkItem(int x, int y) {
-	return item[x][y];
+	return item(x, y);
 }
 
 /**
  * Returns the item in square (x,y) and removes it.
  */
 int Environment::removeItem(int x, int y) {
-	int retVal = item[x][y];
-	item[x][y] = NONE;
+	int retVal = item(x, y);
+	item(x, y) = NONE;
 	smh->saveManager->change(x, y);	
 	return retVal;
 }
@@ -1255,91 +1201,89 @@ int Environment::removeItem(int x, int y) {
  * Removes a particle at (x,y)
  */
 void Environment::removeParticle(int x, int y) {
-	for (std::list<ParticleStruct>::iterator i = particleList.begin(); i != particleList.end(); i++) {
+	std::list<ParticleStruct>::iterator i = particleList.begin();
+	while (i != particleList.end()) {
 		if (i->gridX == x && i->gridY == y) {
-			i->particle->Stop();
-			delete i->particle;
+			smh->particlePool->release(i->particle);
 			i = particleList.erase(i);
+		} else {
+			i++;
 		}
 	}
 }
 
 /**
- * Returns whether or not there is an unobstructed straight line from 
- * pixel position (x1, y1) to (x2, y2).
- *
- *	x1, y1		point at the start of the path
- *	x2, y2		point at the end of the path
- *	radius		radius of the object taking the path
- *
+ * Takes this frame's snapshot of the movement keys. Call it once before resolving
+ * Smiley's movement with playerCollision().
+ */
+void Environment::beginPlayerMovement() {
+	beginPlayerMovement(smh->input->keyDown(INPUT_UP), smh->input->keyDown(INPUT_DOWN),
+		smh->input->keyDown(INPUT_LEFT), smh->input->keyDown(INPUT_RIGHT));
+}
+
+/**
+ * Starts a frame of movement with the given keys held. The self test uses this
+ * to replay movement without real input.
  */
-bool Environment::validPath(int x1, int y1, int x2, int y2, int radius, bool canPass[256]) {
-	//First get the velocities of the path
-	float angle = Util::getAngleBetween(x1,y1,x2,y2);
+void Environment::beginPlayerMovement(bool up, bool down, bool left, bool right) {
+
+	playerMovement.onlyDownPressed = down && !up && !left && !right;
+	playerMovement.onlyUpPressed = !down && up && !left && !right;
+	playerMovement.onlyLeftPressed = !down && !up && left && !right;
+	playerMovement.onlyRightPressed = !down && !up && !left && right;
+	playerMovement.onIce = collision(smh->player->gridX, smh->player->gridY) == ICE;
+	playerMovement.haveBlockedSquares = false;
 
-	//Call validPath using this angle
-	return validPath(angle, x1, y1, x2, y2, radius, canPass, false);
 }
 
-bool Environment::validPath(float angle,int x1, int y1, int x2, int y2, int radius, bool canPass[256], bool needsToHitPlayer) {
-	float dx = 10.0*cos(angle);
-	float dy = 10.0*sin(angle);
+/**
+ * Collects the squares Smiley can't walk on in the 5x5 window around a grid
+ * square, in the order playerCollision() has always tested them.
+ */
+void Environment::findBlockedSquares(int gridX, int gridY) {
 
-	//Now trace the path using dx and dy and see if you run into any SHIT
-	float xTravelled = 0;
-	float yTravelled = 0;
-	float curX = x1;
-	float curY = y1;
-	
-	CollisionCircle circle;
-
-	//This can throw an exception if the enemy is perfectly on top of the player
-	try {
-		while (abs(xTravelled) < abs(x2 - x1) && abs(yTravelled) < abs(y2 - y1)) {
-			//Top left of the object
-			if (!canPass[collisionAt(curX-radius, curY-radius)] || hasSillyPad(int(curX-radius)/64,int(curY-radius)/64)) return false;
-			//Top right of the object
-			if (!canPass[collisionAt(curX+radius, curY-radius)] || hasSillyPad(int(curX+radius)/64,int(curY-radius)/64)) return false;
-			//Bottom left of the object
-			if (!canPass[collisionAt(curX-radius, curY+radius)] || hasSillyPad(int(curX-radius)/64,int(curY+radius)/64)) return false;
-			//Bottom right of the object
-			if (!canPass[collisionAt(curX+radius, curY+radius)] || hasSillyPad(int(curX+radius)/64,int(curY+radius)/64)) return false;
-			curX += dx;
-			curY += dy;
-			xTravelled += dx;
-			yTravelled += dy;
-
-			if (needsToHitPlayer) {
-				circle.x = curX;
-				circle.y = curY;
-				circle.radius = radius;
-				
-				if (smh->player->collisionCircle->testCircle(&circle)) return true;
-			}
-		}
-	} catch(int type) {
-		return true;
-	}
+	playerMovement.gridX = gridX;
+	playerMovement.gridY = gridY;
+	playerMovement.numBlocked = 0;
+	playerMovement.haveBlockedSquares = true;
 
-	if (!needsToHitPlayer)
-		//You didnt hit any SHIT so return true
-		return true;
+	for (int i = gridX - 2; i <= gridX + 2; i++) {
+		for (int j = gridY - 2; j <= gridY + 2; j++) {
 
-	//Since needsToHitPlayer is true, we only return true if we hit the player
-	circle.x = curX;
-	circle.y = curY;
-	circle.radius = radius;
-	
-	if (smh->player->collisionCircle->testCircle(&circle)) return true;
+			//Ignore squares off the map
+			if (!isInBounds(i,j)) continue;
 
-	return false;
+			//Special logic for shrink tunnels
+			bool canPass;
+			if (collision(i, j) == SHRINK_TUNNEL_HORIZONTAL) {
+				canPass = smh->player->isShrunk() && j == smh->player->gridY;
+			} else if (collision(i, j) == SHRINK_TUNNEL_VERTICAL) {
+				canPass = smh->player->isShrunk() && i == smh->player->gridX;
+			} else {
+				canPass = smh->player->canPass(collision(i, j));
+			}
 
-}
+			if (!canPass) {
+				setTerrainCollisionBox(collisionBox, collision(i, j), i, j);
+				BlockedSquare *square = &playerMovement.blocked[playerMovement.numBlocked++];
+				square->gridX = i;
+				square->gridY = j;
+				square->x1 = collisionBox->x1;
+				square->y1 = collisionBox->y1;
+				square->x2 = collisionBox->x2;
+				square->y2 = collisionBox->y2;
+			}
+		}
+	}
 
+}
 
 /**
  * Returns whether or not player, when centered at (x,y), collides with any terrain. 
- * Also autoadjusts the player's position to navigate corners.
+ * Also autoadjusts the player's position to navigate corners. Uses the keys taken
+ * by beginPlayerMovement(). The blocked squares are collected around the square
+ * (x,y) is in, the same window the old code searched, and are kept for the next
+ * call if it tests a point in the same square.
  *
  * @arg x		x-coord of the player
  * @arg y		y-coord of the player
@@ -1351,109 +1295,97 @@ bool Environment::playerCollision(int x, int y, float dt) {
 	int gridX = x / 64;
 	int gridY = y / 64;
 
-    bool onIce = collision[smh->player->gridX][smh->player->gridY] == ICE;
+	if (!playerMovement.haveBlockedSquares || gridX != playerMovement.gridX || gridY != playerMovement.gridY) {
+		findBlockedSquares(gridX, gridY);
+	}
 
-	//Check all neighbor squares
-	for (int i = gridX - 2; i <= gridX + 2; i++) {
-		for (int j = gridY - 2; j <= gridY + 2; j++) {
+	bool onIce = playerMovement.onIce;
+	bool onlyDownPressed = playerMovement.onlyDownPressed;
+	bool onlyUpPressed = playerMovement.onlyUpPressed;
+	bool onlyLeftPressed = playerMovement.onlyLeftPressed;
+	bool onlyRightPressed = playerMovement.onlyRightPressed;
 
-			//Special logic for shrink tunnels
-			bool canPass;
-			if (collision[i][j] == SHRINK_TUNNEL_HORIZONTAL) {
-				canPass = smh->player->isShrunk() && j == smh->player->gridY;
-			} else if (collision[i][j] == SHRINK_TUNNEL_VERTICAL) {
-				canPass = smh->player->isShrunk() && i == smh->player->gridX;
-			} else {
-				canPass = smh->player->canPass(collision[i][j]);
-			}
+	//Check all blocked neighbor squares
+	for (int n = 0; n < playerMovement.numBlocked; n++) {
 
-			//Ignore squares off the map
-			if (isInBounds(i,j) && !canPass) {
-		
-				//Test collision with this square
-				setTerrainCollisionBox(collisionBox, collision[i][j], i, j);
+		BlockedSquare *box = &playerMovement.blocked[n];
+		int i = box->gridX;
+		int j = box->gridY;
 
-				//Note that this is different than normal circle/box collision!!!
-				
-				//Test top and bottom of box
-				if (x > collisionBox->x1 && x < collisionBox->x2) {
-					if (abs(collisionBox->y2 - y) < smh->player->radius) return true;
-					if (abs(collisionBox->y1 - y) < smh->player->radius) return true;
-				}
+		//Note that this is different than normal circle/box collision!!!
+		
+		//Test top and bottom of box
+		if (x > box->x1 && x < box->x2) {
+			if (abs(box->y2 - y) < smh->player->radius) return true;
+			if (abs(box->y1 - y) < smh->player->radius) return true;
+		}
 
-				//Test left and right side of box
-				if (y > collisionBox->y1 && y < collisionBox->y2) {
-					if (abs(collisionBox->x2 - x) < smh->player->radius) return true;
-					if (abs(collisionBox->x1 - x) < smh->player->radius) return true;
-				}
+		//Test left and right side of box
+		if (y > box->y1 && y < box->y2) {
+			if (abs(box->x2 - x) < smh->player->radius) return true;
+			if (abs(box->x1 - x) < smh->player->radius) return true;
+		}
 
-				//Test the center of the box
-				if (Util::distance(collisionBox->x1+(collisionBox->x2 - collisionBox->x1)/2.0, collisionBox->y1 + (collisionBox->y2 - collisionBox->y1)/2.0, x, y) < smh->player->radius) return true;
-
-				//Now do a ton of shit to make smiley round corners
-				bool onlyDownPressed = smh->input->keyDown(INPUT_DOWN) && !smh->input->keyDown(INPUT_UP) && !smh->input->keyDown(INPUT_LEFT) && !smh->input->keyDown(INPUT_RIGHT);
-				bool onlyUpPressed = !smh->input->keyDown(INPUT_DOWN) && smh->input->keyDown(INPUT_UP) && !smh->input->keyDown(INPUT_LEFT) && !smh->input->keyDown(INPUT_RIGHT);
-				bool onlyLeftPressed = !smh->input->keyDown(INPUT_DOWN) && !smh->input->keyDown(INPUT_UP) && smh->input->keyDown(INPUT_LEFT) && !smh->input->keyDown(INPUT_RIGHT);
-				bool onlyRightPressed = !smh->input->keyDown(INPUT_DOWN) && !smh->input->keyDown(INPUT_UP) && !smh->input->keyDown(INPUT_LEFT) && smh->input->keyDown(INPUT_RIGHT);
-				float angle;
-
-				//Top left corner
-				if (Util::distance(collisionBox->x1, collisionBox->y1, x, y) < smh->player->radius) {
-					if (smh->player->isOnIce()) return true;
-					angle = Util::getAngleBetween(collisionBox->x1, collisionBox->y1, smh->player->x, smh->player->y);
-					if (onlyDownPressed && smh->player->facing == DOWN && x < collisionBox->x1 && smh->player->canPass(collision[i-1][j]) && !hasSillyPad(i-1,j) && !onIce) {
-						angle -= 4.0 * PI * dt;
-					} else if (onlyRightPressed && smh->player->facing == RIGHT && y < collisionBox->y1 && smh->player->canPass(collision[i][j-1]) && !hasSillyPad(i,j-1) && !onIce) {
-						angle += 4.0 * PI * dt;
-					} else return true;
-					smh->player->x = collisionBox->x1 + (smh->player->radius+1) * cos(angle);
-					smh->player->y = collisionBox->y1 + (smh->player->radius+1) * sin(angle);
-					return true;
-				}
+		//Test the center of the box
+		if (Util::distance(box->x1+(box->x2 - box->x1)/2.0, box->y1 + (box->y2 - box->y1)/2.0, x, y) < smh->player->radius) return true;
+
+		//Now do a ton of shit to make smiley round corners
+		float angle;
+
+		//Top left corner
+		if (Util::distance(box->x1, box->y1, x, y) < smh->player->radius) {
+			if (smh->player->isOnIce()) return true;
+			angle = Util::getAngleBetween(box->x1, box->y1, smh->player->x, smh->player->y);
+			if (onlyDownPressed && smh->player->facing == DOWN && x < box->x1 && smh->player->canPass(collision(i-1, j)) && !hasSillyPad(i-1,j) && !onIce) {
+				angle -= 4.0 * PI * dt;
+			} else if (onlyRightPressed && smh->player->facing == RIGHT && y < box->y1 && smh->player->canPass(collision(i, j-1)) && !hasSillyPad(i,j-1) && !onIce) {
+				angle += 4.0 * PI * dt;
+			} else return true;
+			smh->player->x = box->x1 + (smh->player->radius+1) * cos(angle);
+			smh->player->y = box->y1 + (smh->player->radius+1) * sin(angle);
+			return true;
+		}
 
-				//Top right corner
-				if (Util::distance(collisionBox->x2, collisionBox->y1, x, y) < smh->player->radius) {
-					if (smh->player->isOnIce()) return true;
-					angle = Util::getAngleBetween(collisionBox->x2, collisionBox->y1, smh->player->x, smh->player->y);
-					if (onlyDownPressed && smh->player->facing == DOWN && x > collisionBox->x2 && smh->player->canPass(collision[i+1][j]) && !hasSillyPad(i+1,j) && !onIce) {
-						angle += 4.0 * PI * dt;
-					} else if (onlyLeftPressed && smh->player->facing == LEFT && y < collisionBox->y1 && smh->player->canPass(collision[i][j-1]) && !hasSillyPad(i,j-1) && !onIce) {
-						angle -= 4.0 * PI * dt;
-					} else return true;
-					smh->player->x = collisionBox->x2 + (smh->player->radius+1) * cos(angle);
-					smh->player->y = collisionBox->y1 + (smh->player->radius+1) * sin(angle);
-					return true;
-				}
+		//Top right corner
+		if (Util::distance(box->x2, box->y1, x, y) < smh->player->radius) {
+			if (smh->player->isOnIce()) return true;
+			angle = Util::getAngleBetween(box->x2, box->y1, smh->player->x, smh->player->y);
+			if (onlyDownPressed && smh->player->facing == DOWN && x > box->x2 && smh->player->canPass(collision(i+1, j)) && !hasSillyPad(i+1,j) && !onIce) {
+				angle += 4.0 * PI * dt;
+			} else if (onlyLeftPressed && smh->player->facing == LEFT && y < box->y1 && smh->player->canPass(collision(i, j-1)) && !hasSillyPad(i,j-1) && !onIce) {
+				angle -= 4.0 * PI * dt;
+			} else return true;
+			smh->player->x = box->x2 + (smh->player->radius+1) * cos(angle);
+			smh->player->y = box->y1 + (smh->player->radius+1) * sin(angle);
+			return true;
+		}
 
-				//Bottom right corner
-				if (Util::distance(collisionBox->x2, collisionBox->y2, x, y) < smh->player->radius) {
-					if (smh->player->isOnIce()) return true;
-					angle = Util::getAngleBetween(collisionBox->x2, collisionBox->y2, smh->player->x, smh->player->y);
-					if (onlyUpPressed && smh->player->facing == UP && x > collisionBox->x2 && smh->player->canPass(collision[i+1][j]) && !hasSillyPad(i+1,j) && !onIce) {
-						angle -= 4.0 * PI * dt;
-					} else if (onlyLeftPressed && smh->player->facing == LEFT && y > collisionBox->y2 && smh->player->canPass(collision[i][j+1]) && !hasSillyPad(i,j+1) && !onIce) {
-						angle += 4.0 * PI * dt;
-					} else return true;
-					smh->player->x = collisionBox->x2 + (smh->player->radius+1) * cos(angle);
-					smh->player->y = collisionBox->y2 + (smh->player->radius+1) * sin(angle);
-					return true;
-				}
-				
-				//Bottom left corner
-				if (Util::distance(collisionBox->x1, collisionBox->y2, x, y) < smh->player->radius) {
-					if (smh->player->isOnIce()) return true;
-					angle = Util::getAngleBetween(collisionBox->x1, collisionBox->y2, smh->player->x, smh->player->y);
-					if (onlyUpPressed && smh->player->facing == UP && x < collisionBox->x1 && smh->player->canPass(collision[i-1][j]) && !hasSillyPad(i-1,j) && !onIce) {
-						angle += 4.0 * PI * dt;
-					} else if (onlyRightPressed && smh->player->facing == RIGHT && y > collisionBox->y2 && smh->player->canPass(collision[i][j+1]) && !hasSillyPad(i, j+1) && !onIce) {
-						angle -= 4.0 * PI * dt;
-					} else return true;
-					smh->player->x = collisionBox->x1 + (smh->player->radius+1) * cos(angle);
-					smh->player->y = collisionBox->y2 + (smh->player->radius+1) * sin(angle);
-					return true;
-				}
-				
-			}
+		//Bottom right corner
+		if (Util::distance(box->x2, box->y2, x, y) < smh->player->radius) {
+			if (smh->player->isOnIce()) return true;
+			angle = Util::getAngleBetween(box->x2, box->y2, smh->player->x, smh->player->y);
+			if (onlyUpPressed && smh->player->facing == UP && x > box->x2 && smh->player->canPass(collision(i+1, j)) && !hasSillyPad(i+1,j) && !onIce) {
+				angle -= 4.0 * PI * dt;
+			} else if (onlyLeftPressed && smh->player->facing == LEFT && y > box->y2 && smh->player->canPass(collision(i, j+1)) && !hasSillyPad(i,j+1) && !onIce) {
+				angle += 4.0 * PI * dt;
+			} else return true;
+			smh->player->x = box->x2 + (smh->player->radius+1) * cos(angle);
+			smh->player->y = box->y2 + (smh->player->radius+1) * sin(angle);
+			return true;
+		}
+		
+		//Bottom left corner
+		if (Util::distance(box->x1, box->y2, x, y) < smh->player->radius) {
+			if (smh->player->isOnIce()) return true;
+			angle = Util::getAngleBetween(box->x1, box->y2, smh->player->x, smh->player->y);
+			if (onlyUpPressed && smh->player->facing == UP && x < box->x1 && smh->player->canPass(collision(i-1, j)) && !hasSillyPad(i-1,j) && !onIce) {
+				angle += 4.0 * PI * dt;
+			} else if (onlyRightPressed && smh->player->facing == RIGHT && y > box->y2 && smh->player->canPass(collision(i, j+1)) && !hasSillyPad(i, j+1) && !onIce) {
+				angle -= 4.0 * PI * dt;
+			} else return true;
+			smh->player->x = box->x1 + (smh->player->radius+1) * cos(angle);
+			smh->player->y = box->y2 + (smh->player->radius+1) * sin(angle);
+			return true;
 		}
 	}
 
@@ -1465,8 +1397,8 @@ bool Environment::playerCollision(int x, int y, float dt) {
  * Bombs any bombable walls at the given coordinates
  */
 void Environment::bombWall(int x,int y) {
-	if (isInBounds(x,y) && collision[x][y] == BOMBABLE_WALL) {
-		collision[x][y]=WALKABLE;
+	if (isInBounds(x,y) && collision(x, y) == BOMBABLE_WALL) {
+		collision(x, y)=WALKABLE;
 		smh->saveManager->change( x, y);
 	}
 }
@@ -1485,9 +1417,9 @@ bool Environment::enemyCollision(hgeRect *box, BaseEnemy *enemy, float dt) {
 	for (int i = gridX - 2; i <= gridX + 2; i++) {
 		for (int j = gridY - 2; j <= gridY + 2; j++) {
 			//Ignore squares off the map
-			if (isInBounds(i,j) && (!enemy->canPass[collision[i][j]] || hasSillyPad(i,j))) {
+			if (isInBounds(i,j) && (!enemy->canPass[collision(i, j)] || hasSillyPad(i,j))) {
 				//Test collision
-				setTerrainCollisionBox(collisionBox, hasSillyPad(i,j) ? UNWALKABLE : collision[i][j], i, j);
+				setTerrainCollisionBox(collisionBox, hasSillyPad(i,j) ? UNWALKABLE : collision(i, j), i, j);
 				if (box->Intersect(collisionBox)) {
 
 					//Help the enemy round corners
@@ -1542,10 +1474,10 @@ bool Environment::hitSigns(Tongue *tongue) {
 
 	for (int i = smh->player->gridX - 2; i <= smh->player->gridX + 2; i++) {
 		for (int j = smh->player->gridY - 2; j <= smh->player->gridY + 2; j++) {
-			if (isInBounds(i,j) && collision[i][j] == SIGN) {
+			if (isInBounds(i,j) && collision(i, j) == SIGN) {
 				collisionBox->SetRadius(i*64+32,j*64+32,24);
 				if (tongue->testCollision(collisionBox) && !smh->player->isOnArrow() && !smh->player->isOnIce()) {
-					smh->windowManager->openSignTextBox(ids[i][j]);
+					smh->windowManager->openSignTextBox(ids(i, j));
 					return true;
 				}
 			}
@@ -1564,7 +1496,7 @@ bool Environment::hitSaveShrine(Tongue *tongue)
 	{
 		for (int j = smh->player->gridY - 2; j <= smh->player->gridY + 2; j++) 
 		{
-			if (isInBounds(i,j) && collision[i][j] == SAVE_SHRINE) 
+			if (isInBounds(i,j) && collision(i, j) == SAVE_SHRINE) 
 			{
 				collisionBox->SetRadius(i*64+32,j*64+32,24);
 				if (tongue->testCollision(collisionBox)) 
@@ -1578,79 +1510,21 @@ bool Environment::hitSaveShrine(Tongue *tongue)
 	return false;
 }
 
-/**
- * Returns whether or not box collides with any silly pads or terrain 
- * as specified by canPass.
- */
-bool Environment::testCollision(hgeRect *box, bool canPass[256]) {
-	return testCollision(box, canPass, false);
-}
-
-/**
- * Returns whether or not box collides with terrain as specified by canPass.
- * 
- * @param ignoreSillyPads	If true, hitting silly pads won't be counted as collision
- */
-bool Environment::testCollision(hgeRect *box, bool canPass[256], bool ignoreSillyPads) {
-
-	//Determine the location of the collision box
-	int gridX = (box->x1 + (box->x2 - box->x1)/2) / 64;
-	int gridY = (box->y1 + (box->y2 - box->y1)/2) / 64;
-
-	//Check all neighbor squares
-	for (int i = gridX - 2; i <= gridX + 2; i++) {
-		for (int j = gridY - 2; j <= gridY + 2; j++) {
-			//Ignore squares off the map
-			if (isInBounds(i,j) && (!canPass[collision[i][j]] || 
-					(!ignoreSillyPads && hasSillyPad(i,j)))) {
-				
-				//Test collision
-				setTerrainCollisionBox(collisionBox, (!ignoreSillyPads && hasSillyPad(i,j)) 
-						? UNWALKABLE : collision[i][j], i, j);
-
-				if (box->Intersect(collisionBox)) {
-					return true;
-				}
-			}
-		}
-	}
-
-	//No collision occured, so return false
-	return false;
-
-}
-
 /**
  * Returns whether or not the environment should draw the collision sprite for the
  * given collision type.
  */
 bool Environment::shouldEnvironmentDrawCollision(int collision) 
 {
-	return collision != WALKABLE && 
-		   collision != UNWALKABLE && 
-		   collision != ENEMY_NO_WALK && 
-		   collision != PLAYER_START && 
-		   collision != DIZZY_MUSHROOM_1 && 
-		   collision != DIZZY_MUSHROOM_2 &&
-		   collision != PLAYER_END && 
-		   collision != PIT && 
-		   collision != UNWALKABLE_PROJECTILE && 
-		   collision != FAKE_PIT &&
-		   collision != FLAME && 
-		   collision != NO_WALK_PIT &&
-		   collision != FIRE_DESTROY && 
-		   collision != FAKE_COLLISION && 
-		   collision != FOUNTAIN && 
-		   !Util::isWarp(collision);
+	return TileTraits::has(collision, TileTraits::DrawsCollision);
 }
 
 void Environment::removeAllParticles() {
-	for (std::list<ParticleStruct>::iterator i = particleList.begin(); i != particleList.end(); i++) {
-		i->particle->Stop();
-		delete i->particle;
+	std::list<ParticleStruct>::iterator i = particleList.begin();
+	while (i != particleList.end()) {
+		smh->particlePool->release(i->particle);
 		i = particleList.erase(i);
 	}
-	particleList.clear();
 }
 
 void Environment::addParticle(const char* particleName, float x, float y) {
@@ -1660,12 +1534,23 @@ void Environment::addParticle(const char* particleName, float x, float y) {
 	particleStruct.y = y;
 	particleStruct.gridX = Util::getGridX(x);
 	particleStruct.gridY = Util::getGridY(y);
-	particleStruct.particle = new hgeParticleSystem(&smh->resources->GetParticleSystem(particleName)->info);
+	particleStruct.particle = smh->particlePool->acquire(particleName, ParticlePriorities::Low);
 	particleStruct.particle->FireAt(smh->getScreenX(x), smh->getScreenY(y));
 
 	particleList.push_back(particleStruct);
 }
 
+/**
+ * Returns the number of live particles in all of the environment's particle systems.
+ */
+int Environment::getNumParticles() {
+	int numParticles = 0;
+	for (std::list<ParticleStruct>::iterator i = particleList.begin(); i != particleList.end(); i++) {
+		numParticles += i->particle->GetParticlesAlive();
+	}
+	return numParticles;
+}
+
 /**
  * Returns whether or not the player is on top of any cylinders that will pop up
  * when the switch at grid position (x,y) is toggled.
@@ -1675,7 +1560,7 @@ bool Environment::playerOnCylinder(int x, int y) {
 	//Make sure the player isn't on top of any of the cylinders that will pop up
 	for (int k = smh->player->gridX-1; k <= smh->player->gridX+1; k++) {
 		for (int l = smh->player->gridY-1; l <= smh->player->gridY+1; l++) {
-			if (ids[k][l] == ids[x][y] && Util::isCylinderDown(collision[k][l])) {
+			if (ids(k, l) == ids(x, y) && Util::isCylinderDown(collision(k, l))) {
 				collisionBox->SetRadius(k*64+32,l*64+32,32);
 				//Player collides with a cylinder
 				if (smh->player->collisionCircle->testBox(collisionBox)) {
@@ -1691,7 +1576,7 @@ bool Environment::playerOnCylinder(int x, int y) {
  * Returns whether or not there is deep water of any kind at grid (x,y)
  */
 bool Environment::isDeepWaterAt(int x, int y) {
-	return (collision[x][y] == DEEP_WATER || collision[x][y] == GREEN_WATER);
+	return TileTraits::has(collision(x, y), TileTraits::DeepWater);
 }
 
 /**
@@ -1699,48 +1584,29 @@ bool Environment::isDeepWaterAt(int x, int y) {
  */
 bool Environment::isReturnSpotAt(int x, int y)
 {
-	return (collision[x][y] == WALKABLE || collision[x][y] == SHALLOW_WATER || collision[x][y] == WALK_LAVA ||
-			collision[x][y] == RED_WARP || collision[x][y] == BLUE_WARP || collision[x][y] == YELLOW_WARP || collision[x][y] == GREEN_WARP ||
-			collision[x][y] == SHALLOW_GREEN_WATER || collision[x][y] == BOMB_PAD_UP || collision[x][y] == BOMB_PAD_DOWN ||
-			collision[x][y] == HOVER_PAD || collision[x][y] == SUPER_SPRING || collision[x][y] == SMILELET ||
-			collision[x][y] == SMILELET_FLOWER_HAPPY || collision[x][y] == FAKE_COLLISION || collision[x][y] == PLAYER_START ||
-			(collision[x][y] >= WHITE_CYLINDER_DOWN && collision[x][y] <= SILVER_CYLINDER_DOWN) ||
-			(collision[x][y] >= EVIL_WALL_POSITION && collision[x][y] <= EVIL_WALL_RESTART));
+	return TileTraits::has(collision(x, y), TileTraits::ReturnSpot);
 }
 
 /**
  * Returns whether or not there is a SMILELET FLOWER at grid (x,y)
  */
 bool Environment::isSadSmileletFlowerAt(int x,int y) {
-	return (collision[x][y] == SMILELET_FLOWER_SAD);
+	return (collision(x, y) == SMILELET_FLOWER_SAD);
 }
 
 /**
  * Returns whether or not there is shallow water of any kind at grid (x,y)
  */ 
 bool Environment::isShallowWaterAt(int x, int y) {
-	return (collision[x][y] == SHALLOW_WATER || collision[x][y] == SHALLOW_GREEN_WATER);
+	return (collision(x, y) == SHALLOW_WATER || collision(x, y) == SHALLOW_GREEN_WATER);
 }
 
 bool Environment::isArrowAt(int x, int y) {
-	return (collision[x][y] >= UP_ARROW && collision[x][y] <= LEFT_ARROW);
+	return (collision(x, y) >= UP_ARROW && collision(x, y) <= LEFT_ARROW);
 }
 
 bool Environment::isIceAt(int x, int y) {
-	return (collision[x][y] == ICE);
-}
-
-/**
- * Set a collision box for the speicifed collision type decalared in smiley.
- * This allows different things to have different shaped collision boxes.
- */
-void Environment::setTerrainCollisionBox(hgeRect *box, int whatFor, int gridX, int gridY) {
-	if (whatFor == FOUNTAIN) {
-		//Fountain
-		box->Set((gridX-1)*64,gridY*64 + 35,(gridX+2)*64,(gridY+1)*64 + 10);
-	} else {
-		box->SetRadius(gridX*64+32,gridY*64+31,31);
-	}
+	return (collision(x, y) == ICE);
 }
 
 /**
@@ -1769,10 +1635,6 @@ bool Environment::isAdviceManActive() {
 	return (adviceMan && adviceMan->isActive());
 }
 
-bool Environment::isInBounds(int gridX, int gridY) {
-	return (gridX >= 0 && gridY >= 0 && gridX < areaWidth && gridY < areaHeight);
-}
-
 float Environment::getSwitchDelay() {
 	return SWITCH_DELAY;
 }
\ No newline at end of file
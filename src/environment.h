@@ -13,10 +13,12 @@ class BaseEnemy;
 class SpecialTileManager;
 class EvilWallManager;
 class TapestryManager;
+class MiniMap;
 class SmileletManager;
 class Fountain;
 class FenwarManager;
 class AdviceMan;
+class CollisionMask;
 
 struct Timer {
 	float duration, startTime;
@@ -31,6 +33,43 @@ struct ParticleStruct {
 	int gridX, gridY;
 };
 
+/**
+ * All of the tile layers for an area, kept together in one block. Each
+ * column of a layer is contiguous.
+ */
+struct TileData {
+	int ids[256][256];				//ID Layer
+	int variable[256][256];			//Variable Layer
+	int terrain[256][256];			//Main Layer
+	int collision[256][256];		//Walk Layer
+	int item[256][256];				//Item Layer
+	int enemyLayer[256][256];		//Enemy Layer
+	float activated[256][256];		//What time things were activated on each square
+};
+
+/**
+ * A square near Smiley that he can't walk on and its collision box.
+ */
+struct BlockedSquare {
+	int gridX, gridY;
+	float x1, y1, x2, y2;
+};
+
+/**
+ * What Smiley's movement is resolved against for one frame: which single
+ * direction is held, if any, and the blocked squares around him. Taken once
+ * by Environment::beginPlayerMovement so the keys aren't polled and the
+ * neighbors aren't looked up again for every test.
+ */
+struct PlayerMovement {
+	bool onlyUpPressed, onlyDownPressed, onlyLeftPressed, onlyRightPressed;
+	bool onIce;
+	bool haveBlockedSquares;		//False until the window is collected, and again after a door opens
+	int gridX, gridY;				//Center of the 5x5 window of squares
+	BlockedSquare blocked[25];
+	int numBlocked;
+};
+
 class Environment {
 
 public:
@@ -47,6 +86,8 @@ public:
 	int checkItem(int x, int y);
 	int removeItem(int x, int y);
 	int collisionAt(float x, float y);
+	void beginPlayerMovement();
+	void beginPlayerMovement(bool up, bool down, bool left, bool right);
 	bool playerCollision(int x, int y,float dt);
 	bool enemyCollision(hgeRect *box, BaseEnemy *enemy, float dt);
 	void unlockDoor(int gridX, int gridY);
@@ -56,10 +97,10 @@ public:
 	void toggleSwitch(int id);
 	bool hitSigns(Tongue *tongue);
 	bool hitSaveShrine(Tongue *tongue);
-	bool validPath(int x1, int y1, int x2, int y2, int radius, bool canPass[256]);
-	bool validPath(float angle, int x1, int y1, int x2, int y2, int radius, bool canPass[256], bool needsToHitPlayer);
-	bool testCollision(hgeRect *box, bool canPass[256], bool ignoreSillyPads);
-	bool testCollision(hgeRect *box, bool canPass[256]);
+	bool validPath(int x1, int y1, int x2, int y2, int radius, const CollisionMask &canPass);
+	bool validPath(float angle, int x1, int y1, int x2, int y2, int radius, const CollisionMask &canPass, bool needsToHitPlayer);
+	bool testCollision(hgeRect *box, const CollisionMask &canPass, bool ignoreSillyPads);
+	bool testCollision(hgeRect *box, const CollisionMask &canPass);
 	bool playerOnCylinder(int x, int y);
 	void switchCylinders(int id);
 	void flipCylinderSwitch(int gridX, int gridY);
@@ -82,6 +123,7 @@ public:
 	void removeParticle(int x,int y);
 	void removeAllParticles();
 	void addParticle(const char* particle, float x, float y);
+	int getNumParticles();
 	bool shouldEnvironmentDrawCollision(int collision);
 	void addSnowBlock(int gridX, int gridY);
 
@@ -89,15 +131,17 @@ public:
 	void updateSwitchTimers(float dt);
 	void drawSwitchTimers(float dt);
 
+	//Tile layers. Always go through these rather than tileData so that the layout can change.
+	int &ids(int gridX, int gridY) { return tileData.ids[gridX][gridY]; }
+	int &variable(int gridX, int gridY) { return tileData.variable[gridX][gridY]; }
+	int &terrain(int gridX, int gridY) { return tileData.terrain[gridX][gridY]; }
+	int &collision(int gridX, int gridY) { return tileData.collision[gridX][gridY]; }
+	int &item(int gridX, int gridY) { return tileData.item[gridX][gridY]; }
+	int &enemyLayer(int gridX, int gridY) { return tileData.enemyLayer[gridX][gridY]; }
+	float &activated(int gridX, int gridY) { return tileData.activated[gridX][gridY]; }
+
 	//variables
 	int areaWidth,areaHeight;		//Width and height of the area in squares
-	int ids[256][256];				//ID Layer	
-	int variable[256][256];			//Variable Layer
-	int terrain[256][256];			//Main Layer
-	int collision[256][256];		//Walk Layer
-	int item[256][256];				//Item Layer
-	int enemyLayer[256][256];		//Enemy Layer
-	float activated[256][256];		//What time things were activated on each square
 	int screenWidth, screenHeight;	//Number of squares that fit on the screen
 	int xGridOffset,yGridOffset;	//Number of squares the top left corner is from (0,0)
 	float xOffset,yOffset;			//Number of pixels the player is off alignment with the grid
@@ -106,15 +150,22 @@ public:
 
 	hgeSprite *itemLayer[512];
 	SpecialTileManager *specialTileManager;
+	MiniMap *miniMap;
 
 private:
 
+	void clearTileData(int width, int height);
+	bool drawAnimatedCollision(int theCollision, int gridX, int gridY);
+	void findBlockedSquares(int gridX, int gridY);
+
+	TileData tileData;
 	EvilWallManager *evilWallManager; //Evil walls which move and try to kill smiley
 	TapestryManager *tapestryManager;
 	Fountain *fountain;
 	SmileletManager *smileletManager;
 	AdviceMan *adviceMan;
 	hgeRect *collisionBox;
+	PlayerMovement playerMovement;
 	std::list<Timer> timerList;
 	std::list<ParticleStruct> particleList;
 	CollisionCircle *collisionCircle;
@@ -453,7 +453,7 @@ void FireBoss::addOrb(float _x, float _y) {
 	newOrb.x = _x;
 	newOrb.y = _y;
 	newOrb.collisionBox = new hgeRect();
-	newOrb.particle = new hgeParticleSystem("fireorb.psi", smh->resources->GetSprite("particleGraphic2"));
+	newOrb.particle = new hgeParticleSystem(&smh->resources->GetParticleSystem("fireOrb")->info);
 	newOrb.particle->Fire();
 	newOrb.timeCreated = smh->getGameTime();
 
@@ -6,6 +6,7 @@
 #include "CollisionCircle.h"
 #include "WeaponParticle.h"
 #include "ProjectileManager.h"
+#include "PatternEmitter.h"
 #include "WindowFramework.h"
 #include "EnemyFramework.h"
 #include "ExplosionManager.h"
@@ -42,6 +43,36 @@ extern SMH *smh;
 #define COLLISION_DAMAGE 0.25
 #define FLASH_DURATION 1.5
 
+//Fireball attacks
+static const BulletPattern HOMING_FIREBALLS = {
+	PatternShapes::Spread, 3, PI/4.0, 0.0, 0.0, 0.0,
+	500.0, PI/2.0, 0.0, 0.0,
+	15.0, FIREBALL_DAMAGE, BulletFlags::DiesOnHit | BulletFlags::HitsWalls | BulletFlags::Explodes, 0.0, 0.55, ORB_DAMAGE,
+	0.0, 0.0, NULL,
+	NULL, "fireOrb", "snd_FlameShoot", NULL, "snd_HitByFireball"
+};
+static const BulletPattern FIREBALL_ARC = {
+	PatternShapes::Spread, 7, PI/24.0, 0.0, 2.0*PI, 0.0,
+	450.0, 0.0, 0.0, 0.0,
+	15.0, FIREBALL_DAMAGE, BulletFlags::DiesOnHit | BulletFlags::HitsWalls | BulletFlags::Explodes, 0.0, 0.55, ORB_DAMAGE,
+	0.0, 0.0, NULL,
+	NULL, "fireOrb", "snd_FlameShoot", NULL, "snd_HitByFireball"
+};
+static const BulletPattern FIREBALL_RING = {
+	PatternShapes::Ring, 13, 0.0, 2.0*PI, 0.0, 0.0,
+	400.0, 0.0, 0.0, 0.0,
+	15.0, FIREBALL_DAMAGE, BulletFlags::DiesOnHit | BulletFlags::HitsWalls, 0.0, 0.0, 0.0,
+	0.0, 0.0, NULL,
+	NULL, "fireOrb", "snd_FlameShoot", NULL, NULL
+};
+static const BulletPattern FIREBALL_STREAM = {
+	PatternShapes::Spread, 1, 0.0, 0.0, 0.0, 0.0,
+	700.0, 0.0, 0.0, 0.0,
+	15.0, FIREBALL_DAMAGE, BulletFlags::DiesOnHit | BulletFlags::HitsWalls, 0.0, 0.0, 0.0,
+	0.0, 0.0, NULL,
+	NULL, "fireOrb", "snd_FlameShoot", NULL, NULL
+};
+
 /**
  * Constructor
  */
@@ -106,7 +137,7 @@ FireBossTwo::FireBossTwo(int gridX, int gridY, int _groupID) {
  */ 
 FireBossTwo::~FireBossTwo() {
 	resetFlameWalls();
-	resetFireBalls();
+	smh->patternEmitter->clear(this);
 	delete fireNova;
 	smh->resources->Purge(ResourceGroups::Phyrebawz);
 }
@@ -119,7 +150,7 @@ void FireBossTwo::draw(float dt) {
 
 	drawFlameLaunchers(dt);
 
-	drawFireBallsBeforePhyrebawz(dt);
+	smh->patternEmitter->drawBehind(this, y);
 	
 	//Draw the boss' main sprite
 	smh->resources->GetAnimation("Phyrebawz")->SetFrame(facing);
@@ -137,7 +168,7 @@ void FireBossTwo::draw(float dt) {
 		smh->resources->GetAnimation("PhyrebawzRightMouth")->Render(smh->getScreenX(x-(97/2)+34),smh->getScreenY(y-(158/2)+12+floatY));
 	}
 
-	drawFireBallsAfterPhyrebawz(dt);
+	smh->patternEmitter->drawInFront(this, y);
 	
 	fireNova->MoveTo(smh->getScreenX(x), smh->getScreenY(y), true);
 	fireNova->Update(dt);
@@ -189,7 +220,7 @@ bool FireBossTwo::update(float dt) {
 
 	//Activate the boss when the intro dialogue is closed
 	if (state == FIREBOSS_INACTIVE && startedIntroDialogue && !smh->windowManager->isTextBoxOpen()) {
-		smh->log("Fireboss activate boss when intro dialogue is closed");
+		LOG_DEBUG(LogCategories::Bosses, "Fireboss activate boss when intro dialogue is closed");
 		setState(FIREBOSS_FIRST_BATTLE);
 		smh->soundManager->playSound("snd_fireBossDie");
 		smh->soundManager->playMusic("bossMusic");
@@ -217,7 +248,6 @@ bool FireBossTwo::update(float dt) {
 	}
 
 	updateFlameWalls(dt);
-	updateFireBalls(dt);
 
 	//Update collisionBoxes
 	if (facing == DOWN) {
@@ -367,9 +397,7 @@ bool FireBossTwo::updateState(float dt) {
 
 			//Launch fireballs
 			if (smh->timePassedSince(lastAttackTime) > 2.0) {
-				addFireBall(x, y, Util::getAngleBetween(x, y, smh->player->x, smh->player->y) - PI / 4.0, 500.0, true, true);
-				addFireBall(x, y, Util::getAngleBetween(x, y, smh->player->x, smh->player->y), 500.0, true, true);
-				addFireBall(x, y, Util::getAngleBetween(x, y, smh->player->x, smh->player->y) + PI / 4.0, 500.0, true, true);
+				smh->patternEmitter->fire(&HOMING_FIREBALLS, this, x, y, Util::getAngleBetween(x, y, smh->player->x, smh->player->y));
 				lastAttackTime = smh->getGameTime();
 			}
 
@@ -421,15 +449,11 @@ bool FireBossTwo::updateState(float dt) {
 		} else if (smh->timePassedSince(lastAttackTime) > 3.0) {
 			if (smh->randomInt(0,100000) < 50000) {
 				//3 homing fireballs
-				addFireBall(x, y, Util::getAngleBetween(x, y, smh->player->x, smh->player->y) - PI / 4.0, 500.0, true, true);
-				addFireBall(x, y, Util::getAngleBetween(x, y, smh->player->x, smh->player->y), 500.0, true, true);
-				addFireBall(x, y, Util::getAngleBetween(x, y, smh->player->x, smh->player->y) + PI / 4.0, 500.0, true, true);
+				smh->patternEmitter->fire(&HOMING_FIREBALLS, this, x, y, Util::getAngleBetween(x, y, smh->player->x, smh->player->y));
 			} else {
 				//arc of fireballs
 				attackAngle = Util::getAngleBetween(x, y, smh->player->x, smh->player->y);
-				for (int i = -3; i <= 3; i++) {
-					addFireBall(x, y, attackAngle + float(i)*(PI/24.0) + smh->randomFloat(0.0, 2.0*PI), 450.0, false, true);
-				}
+				smh->patternEmitter->fire(&FIREBALL_ARC, this, x, y, attackAngle);
 			}
 			lastAttackTime = smh->getGameTime();
 		}
@@ -445,10 +469,7 @@ bool FireBossTwo::updateState(float dt) {
 
 		//Launch rotating rings
 		if (smh->timePassedSince(lastAttackTime) > 0.75) {
-			float randomAngle = smh->hge->Random_Float(0,2*PI);
-			for (int i = 0; i < 13; i ++) {
-				addFireBall(x, y, (2.0*PI/13.0)*float(i)+randomAngle, 400.0, false, false);
-			}
+			smh->patternEmitter->fire(&FIREBALL_RING, this, x, y, 0.0);
 			smh->soundManager->playSound("snd_FirePassBy");
 			lastAttackTime = smh->getGameTime();
 		}
@@ -467,7 +488,7 @@ bool FireBossTwo::updateState(float dt) {
 		
 		//Launch stream of fireballs
 		if (smh->timePassedSince(lastAttackTime) > 0.05) {
-			addFireBall(x, y-50.0, Util::getAngleBetween(x,y-50.0,smh->player->x,smh->player->y), 700.0, false, false);
+			smh->patternEmitter->fire(&FIREBALL_STREAM, this, x, y-50.0, Util::getAngleBetween(x,y-50.0,smh->player->x,smh->player->y));
 			lastAttackTime = smh->getGameTime();
 		}
 
@@ -557,7 +578,7 @@ void FireBossTwo::die() {
 	smh->saveManager->killBoss(FIRE_BOSS2);
 	smh->soundManager->fadeOutMusic();
 	resetFlameWalls();
-	resetFireBalls();
+	smh->patternEmitter->clear(this);
 }
 
 
@@ -609,174 +630,6 @@ void FireBossTwo::setFacingPlayer() {
 
 }
 
-///////////////////////////// FIRE BALLS /////////////////////////////////
-
-/** 
- * Add a fire orb
- */
-void FireBossTwo::addFireBall(float x, float y, float angle, float speed, bool homing, bool explodes) {
-	
-	//Create new fire orb
-	FireBall newFireBall;
-	newFireBall.x = x;
-	newFireBall.y = y;
-	newFireBall.speed = speed;
-	newFireBall.dx = speed * cos(angle);
-	newFireBall.dy = speed * sin(angle);
-	newFireBall.collisionBox = new hgeRect();
-	newFireBall.particle = new hgeParticleSystem(&smh->resources->GetParticleSystem("fireOrb")->info);
-	newFireBall.particle->Fire();
-	newFireBall.timeCreated = smh->getGameTime();
-	newFireBall.angle = angle;
-	newFireBall.homing = homing;
-	newFireBall.explodes = explodes;
-
-	//Add it to the list
-	fireBallList.push_back(newFireBall);
-
-	//Play a sound
-	smh->soundManager->playSound("snd_FlameShoot");
-}
-
-/**
- * Update the fire orbs
- */
-void FireBossTwo::updateFireBalls(float dt) {
-	
-	//Loop through the orbs
-	std::list<FireBall>::iterator i;
-	for (i = fireBallList.begin(); i != fireBallList.end(); i++) {
-
-		//Update particle
-		i->particle->MoveTo(smh->getScreenX(i->x), smh->getScreenY(i->y), true);
-		i->particle->Update(dt);
-			
-		if (i->homing) {
-			//Find angle to seek target
-			float xDist = i->x - smh->player->x;
-			float targetAngle = atan((i->y - smh->player->y) / xDist);
-			//----------Do a bunch of SHIT----------
-			while (i->angle < 0.0) i->angle += 2.0*PI;
-			while (i->angle > 2.0*PI ) i->angle -= 2.0*PI;
-			while (targetAngle < 0.0) targetAngle += 2.0*PI;
-			while (targetAngle > 2.0*PI ) targetAngle -= 2.0*PI;
-			float temp = i->angle - targetAngle;
-			while (temp < 0) temp += 2.0*PI;
-			while (temp > 2.0*PI) temp -= 2.0*PI;
-			if (xDist > 0) {
-				if (temp <= PI) {
-					i->angle += (PI / 2.0) * dt;
-				} else if (temp > PI) {
-					i->angle -= (PI / 2.0) * dt;
-				}
-			} else {
-				if (temp <= PI) {
-					i->angle -= (PI / 2.0) * dt;
-				} else if (temp > PI) {
-					i->angle += (PI / 2.0) * dt;
-				}
-			}
-			//----------------------------------------
-
-			i->x += i->speed * cos(i->angle) * dt;
-			i->y += i->speed * sin(i->angle) * dt;
-			
-		} else {
-			//Non-homing fireball movement
-			i->x += i->dx * dt;
-			i->y += i->dy * dt;
-		}
-
-		//Player collision
-		i->collisionBox->SetRadius(i->x, i->y, 15);
-		if (smh->player->collisionCircle->testBox(i->collisionBox)) {
-			smh->player->dealDamage(FIREBALL_DAMAGE, true);
-			
-			smh->setDebugText("Smiley hit by fireboss 2's fireball");
-			if (i->explodes) {
-				smh->explosionManager->addExplosion(i->x, i->y, 0.55, ORB_DAMAGE, 0.0);
-				smh->soundManager->playSound("snd_HitByFireball");
-			}
-			delete i->particle;
-			delete i->collisionBox;
-			i = fireBallList.erase(i);
-		}
-
-		//Environment collision
-        else if (smh->environment->collisionAt(i->x, i->y) == UNWALKABLE) 
-		{
-			if (i->explodes) {
-				smh->explosionManager->addExplosion(i->x, i->y, 0.55, ORB_DAMAGE, 0.0);
-				smh->soundManager->playSound("snd_HitByFireball");
-			}
-			delete i->particle;
-			delete i->collisionBox;
-			i = fireBallList.erase(i);
-		}
-
-		//Silly pad collision
-		else if (smh->environment->hasSillyPad(Util::getGridX(i->x),Util::getGridY(i->y))) {
-
-			smh->environment->destroySillyPad(Util::getGridX(i->x),Util::getGridY(i->y));
-
-
-			delete i->particle;
-			delete i->collisionBox;
-			i = fireBallList.erase(i);
-			if (i->explodes) {
-				smh->explosionManager->addExplosion(i->x, i->y, 0.55, ORB_DAMAGE, 0.0);
-				smh->soundManager->playSound("snd_HitByFireball");
-			}
-
-		}
-	}
-}
-
-
-/**
- * Draw the fire balls that should appear behind Phyrebawz.
- */
-void FireBossTwo::drawFireBallsBeforePhyrebawz(float dt) {
-	//Loop through the orbs
-	std::list<FireBall>::iterator i;
-	for (i = fireBallList.begin(); i != fireBallList.end(); i++) {
-		if (i->y <= y) {
-			i->particle->Render();
-			if (smh->isDebugOn()) {
-				smh->drawCollisionBox(i->collisionBox, Colors::RED);
-			}
-		}
-	}
-}
-
-/**
- * Draw the fire balls that should appear in front of Phyrebawz.
- */
-void FireBossTwo::drawFireBallsAfterPhyrebawz(float dt) {
-	//Loop through the orbs
-	std::list<FireBall>::iterator i;
-	for (i = fireBallList.begin(); i != fireBallList.end(); i++) {
-		if (i->y > y) {
-			i->particle->Render();
-			if (smh->isDebugOn()) {
-				smh->drawCollisionBox(i->collisionBox, Colors::RED);
-			}
-		}
-	}
-}
-
-/**
- * Kills all the fire orbs
- */
-void FireBossTwo::resetFireBalls() {
-	std::list<FireBall>::iterator i;
-	for (i = fireBallList.begin(); i != fireBallList.end(); i++) {
-		delete i->particle;
-		delete i->collisionBox;
-		i = fireBallList.erase(i);
-	}
-}
-
 /////////////////////////////// FLAME WALLS /////////////////////////////////
 
 void FireBossTwo::addFlameWall(float x, float y, int direction) {
@@ -46,12 +46,6 @@ public:
 
 	void updateFireNova(float dt);
 
-	void addFireBall(float x, float y, float angle, float speed, bool homing, bool explodes);
-	void drawFireBallsBeforePhyrebawz(float dt);
-	void drawFireBallsAfterPhyrebawz(float dt);
-	void updateFireBalls(float dt);
-	void resetFireBalls();
-	
 	void addFlameWall(float x, float y, int direction);
 	void drawFlameWalls(float dt);
 	void updateFlameWalls(float dt);
@@ -97,7 +91,6 @@ private:
 
 	FlameLauncher flameLaunchers[8];
 
-	std::list<FireBall> fireBallList;
 	std::list<FlameWall> flameWallList;
 
 };
@@ -52,12 +52,13 @@ void Inventory::draw(float dt)
 				if (cursorX == i && cursorY == j) 
 				{
 					smh->resources->GetFont("inventoryFnt")->printf(INVENTORY_X_OFFSET+170,INVENTORY_Y_OFFSET+275,HGETEXT_CENTER,"%s", smh->gameData->getAbilityInfo(j*4 + i).name);
-					smh->resources->GetFont("description")->printfb(
+					smh->textLayoutCache->printfb(
+						smh->resources->GetFont("description"),
 						INVENTORY_X_OFFSET+40,	//box x
 						INVENTORY_Y_OFFSET+340,	//box y
 						275.0, 200.0,			//width and height of box
 						HGETEXT_LEFT | HGETEXT_TOP, //Alignment
-						"%s", smh->gameData->getAbilityInfo(j*4 + i).description);
+						smh->gameData->getAbilityInfo(j*4 + i).description);
 				}
 				
 				//Draw a check if the ability is one of the ones selected to be available in the GUI
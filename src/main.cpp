@@ -12,15 +12,77 @@ bool RenderFunc() {
 	return false;
 }
 
+/**
+ * Compiles Data/ResourceScript into Data/ResourceManifest and checks the
+ * resource names used in src. Everything it finds is written to
+ * ResourceCompilerLog.txt. Returns 0 if there were no problems.
+ */
+int compileResources() {
+
+	Logger logger("ResourceCompilerLog.txt");
+	ResourceManifestCompiler compiler;
+
+	bool compiled = compiler.compile(RESOURCE_SCRIPT_FILE) && compiler.save(RESOURCE_MANIFEST_FILE);
+	int numChecked = compiled ? compiler.validateCode("src") : 0;
+
+	for (int i = 0; i < (int)compiler.getErrors().size(); i++) {
+		logger.write(LogLevels::Error, LogCategories::Resources, "%s", compiler.getErrors()[i].c_str());
+	}
+	logger.write(LogLevels::Info, LogCategories::Resources, "Compiled %d resources into %s, checked %d names in the code, %d problems",
+		compiler.getNumResources(), RESOURCE_MANIFEST_FILE, numChecked, (int)compiler.getErrors().size());
+
+	return compiled && compiler.getErrors().empty() ? 0 : 1;
+}
+
+/**
+ * Repacks the zips in Data into memory mappable asset packs, which the game
+ * uses instead of the zips when they are there. Everything it does is written
+ * to AssetPackerLog.txt. Returns 0 if there were no problems.
+ */
+int buildAssetPacks(HGE *hge) {
+
+	static const char *packs[][2] = { { "Data/Sounds.zip", "Data/Sounds.pak" },
+		{ "Data/Fonts.zip", "Data/Fonts.pak" }, { "Data/GameData.zip", "Data/GameData.pak" } };
+
+	Logger logger("AssetPackerLog.txt");
+	int numErrors = 0;
+
+	for (int i = 0; i < sizeof(packs) / sizeof(packs[0]); i++) {
+		AssetPacker packer(hge);
+		bool built = packer.addZip(packs[i][0]) && packer.save(packs[i][1]);
+		for (int j = 0; j < (int)packer.getErrors().size(); j++) {
+			logger.write(LogLevels::Error, LogCategories::Resources, "%s", packer.getErrors()[j].c_str());
+		}
+		if (built) {
+			logger.write(LogLevels::Info, LogCategories::Resources, "Packed %d assets into %s, %d compressed, %d bytes stored as %d",
+				packer.getNumAssets(), packs[i][1], packer.getNumCompressed(), packer.getSize(), packer.getStoredSize());
+		}
+		numErrors += (int)packer.getErrors().size();
+	}
+
+	return numErrors == 0 ? 0 : 1;
+}
+
 /**
  * Application entry point.
  */
-int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {	
+int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR commandLine, int) {	
+
+	if (strstr(commandLine, "-compileresources")) {
+		return compileResources();
+	}
 	
 	//Set up the HGE engine
 	HGE *hge= hgeCreate(HGE_VERSION);
 	hge->System_SetState(HGE_INIFILE, "Data/Smiley.ini");
 	hge->System_SetState(HGE_LOGFILE, "SmileyLog.txt");
+
+	if (strstr(commandLine, "-buildpacks")) {
+		int result = buildAssetPacks(hge);
+		hge->Release();
+		return result;
+	}
+
 	hge->System_SetState(HGE_FRAMEFUNC, FrameFunc);
 	hge->System_SetState(HGE_RENDERFUNC, RenderFunc);
 	hge->System_SetState(HGE_TITLE, "Smiley's Maze Hunt");
@@ -32,13 +94,42 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 	hge->System_SetState(HGE_SHOWSPLASH, false);
 	hge->System_SetState(HGE_ICON, MAKEINTRESOURCE (IDI_ICON1));
 
+	//-bossbenchmark [-compare <file>] plays every boss fight with a bot as fast as
+	//it can and exits with 1 if anything regressed against the baseline file.
+	bool bossBenchmark = strstr(commandLine, "-bossbenchmark") != NULL;
+	char baselineFile[MAX_PATH] = "";
+	if (bossBenchmark) {
+		hge->System_SetState(HGE_FPS, HGEFPS_UNLIMITED);
+		char *compare = strstr(commandLine, "-compare ");
+		if (compare) {
+			sscanf(compare + strlen("-compare "), "%259s", baselineFile);
+		}
+	}
+
+	//-microbenchmark times the engine's low level pieces on their own and exits
+	bool microBenchmark = strstr(commandLine, "-microbenchmark") != NULL;
+
+	//-selftest checks the faster engine systems against the code they replaced and
+	//exits with 1 if anything didn't match.
+	bool selfTest = strstr(commandLine, "-selftest") != NULL;
+
+	int result = 0;
 	if(hge->System_Initiate()) 
 	{
 		//Create the SMH engine
 		smh = new SMH(hge);
+		if (selfTest) {
+			smh->selfTest->request();
+		} else if (microBenchmark) {
+			smh->microBenchmark->request();
+		} else if (bossBenchmark) {
+			smh->bossBenchmark->request(baselineFile[0] ? baselineFile : NULL);
+		}
 
 		//Start HGE. When this function returns it means the program is exiting.
 		hge->System_Start();
+		if (smh->bossBenchmark->getNumRegressions() > 0 || smh->selfTest->getNumFailures() > 0) result = 1;
+		smh->shutdown();
 	} 
 	else 
 	{
@@ -48,7 +139,7 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 	// Clean up and shutdown
 	hge->System_Shutdown();
 	hge->Release();
-	return 0;
+	return result;
 }
 
 
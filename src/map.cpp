@@ -5,6 +5,7 @@
 #include "hgeresource.h"
 #include "hgeanim.h"
 #include "EnemyFramework.h"
+#include "MiniMap.h"
 
 extern SMH *smh;
 
@@ -28,6 +29,9 @@ Map::Map() {
 	if (xOffset < 0.0) xOffset = 0.0;
 	if (yOffset < 0.0) yOffset = 0.0;
 
+	//Redraw anything that changed since the map was last opened
+	smh->environment->miniMap->sync();
+
 }
 
 /**
@@ -45,10 +49,18 @@ void Map::draw(float dt)
 
 	int gridX = xOffset / squareSize;
 	int gridY = yOffset / squareSize;
+	float mapX = windowX - (int)xOffset;
+	float mapY = windowY - (int)yOffset;
 
 	smh->hge->Gfx_SetClipping(windowX, windowY, windowWidth, windowHeight);
 
+	//Anything outside of the area is black
+	smh->drawSprite("miniMapBlackSquare", windowX, windowY, windowWidth, windowHeight);
+
 	//Draw the map tiles
+	smh->environment->miniMap->drawTiles(mapX, mapY, squareSize);
+
+	//Draw the things that don't fit in one texel
 	for (int i = gridX; i < gridX + gridWidth+1; i++) 
 	{
 		for (int j = gridY; j < gridY + gridHeight+1; j++) 
@@ -59,13 +71,14 @@ void Map::draw(float dt)
 			
 			if (smh->environment->isInBounds(i,j) && smh->saveManager->isExplored(i,j)) 
 			{
-				drawSquare(i, j, drawX, drawY);
+				drawOverlays(i, j, drawX, drawY);
 			}
-			drawFogAt(i, j, drawX, drawY);
 
 		}
 	}
 
+	smh->environment->miniMap->drawFog(mapX, mapY, squareSize);
+
 	smh->hge->Gfx_SetClipping();
 
 	//Draw border
@@ -76,37 +89,17 @@ void Map::draw(float dt)
 
 }
 
-void Map::drawSquare(int i , int j, int drawX, int drawY) 
+void Map::drawOverlays(int i , int j, int drawX, int drawY) 
 {	
-	int c = smh->environment->collision[i][j];
-
-	bool isHiddenWarp = Util::isWarp(c) && smh->environment->variable[i][j] == 990;
-	bool drawNoCollision = 
-		smh->player->canPass(c, false) || isHiddenWarp || Util::isCylinderUp(c) || Util::isCylinderSwitchLeft(c) ||
-		Util::isCylinderSwitchRight(c) || c==SIGN || c==FAKE_COLLISION;
-
-	//Basic map tiles
-	if (c == WALK_LAVA || c == NO_WALK_LAVA) {
-		smh->drawSprite("miniMapRedSquare", drawX, drawY);
-	} else if (c == PIT || c == NO_WALK_PIT || c == FAKE_PIT) {
-		smh->drawSprite("miniMapBlackSquare", drawX, drawY);
-	} else if (smh->environment->isDeepWaterAt(i, j)) {
-		smh->drawSprite("miniMapBlueSquare", drawX, drawY);
-	} else if (drawNoCollision && !isHiddenWarp && c != FAKE_COLLISION) {
-		smh->drawSprite("miniMapNoCollision", drawX, drawY);
-	} else {
-		smh->drawSprite("miniMapCollision", drawX, drawY);
-	}
-
 	//Special collision graphics
-	if (shouldDrawSpecialCollision(c) || (Util::isWarp(c) && smh->environment->variable[i][j] != 990)) {
-		smh->resources->GetAnimation("walkLayer")->SetFrame(c);
+	if (smh->environment->miniMap->hasOverlay(i, j, MiniMapOverlays::SpecialCollision)) {
+		smh->resources->GetAnimation("walkLayer")->SetFrame(smh->environment->collision(i, j));
 		smh->resources->GetAnimation("walkLayer")->RenderStretch(drawX,drawY,drawX+squareSize,drawY+squareSize);
 	}
 	
 	//Items
-	if (shouldDrawItem(smh->environment->item[i][j])) {
-		smh->environment->itemLayer[smh->environment->item[i][j]]->RenderStretch(drawX,drawY,drawX+squareSize,drawY+squareSize);
+	if (smh->environment->miniMap->hasOverlay(i, j, MiniMapOverlays::Item)) {
+		smh->environment->itemLayer[smh->environment->item(i, j)]->RenderStretch(drawX,drawY,drawX+squareSize,drawY+squareSize);
 	}
 
 	//Smiley
@@ -117,32 +110,6 @@ void Map::drawSquare(int i , int j, int drawX, int drawY)
 
 }
 
-void Map::drawFogAt(int i, int j, int drawX, int drawY) {
-
-	//Fog edges
-	if (smh->environment->isInBounds(i,j) && smh->saveManager->isExplored(i,j)) {
-		if (smh->environment->isInBounds(i,j-1) && !smh->saveManager->isExplored(i,j-1))
-			smh->drawSprite("mapFogOfWarUp", drawX, drawY, squareSize, squareSize);
-		if (smh->environment->isInBounds(i,j+1) && !smh->saveManager->isExplored(i,j+1))
-			smh->drawSprite("mapFogOfWarDown", drawX, drawY, squareSize, squareSize);
-		if (smh->environment->isInBounds(i-1,j) && !smh->saveManager->isExplored(i-1,j))
-			smh->drawSprite("mapFogOfWarLeft", drawX, drawY, squareSize, squareSize);
-		if (smh->environment->isInBounds(i+1,j) && !smh->saveManager->isExplored(i+1,j))
-			smh->drawSprite("mapFogOfWarRight", drawX, drawY, squareSize, squareSize);
-		if (smh->environment->isInBounds(i,j-1) && smh->environment->isInBounds(i+1,j) && smh->saveManager->isExplored(i,j-1) && smh->saveManager->isExplored(i+1,j) && !smh->saveManager->isExplored(i+1,j-1))
-			smh->drawSprite("mapFogOfWarUpRight", drawX+squareSize/2, drawY, squareSize/2, squareSize/2);
-		if (smh->environment->isInBounds(i,j-1) && smh->environment->isInBounds(i-1,j) && smh->saveManager->isExplored(i,j-1) && smh->saveManager->isExplored(i-1,j) && !smh->saveManager->isExplored(i-1,j-1))
-			smh->drawSprite("mapFogOfWarUpLeft", drawX, drawY, squareSize/2, squareSize/2);
-		if (smh->environment->isInBounds(i,j+1) && smh->environment->isInBounds(i-1,j) && smh->saveManager->isExplored(i,j+1) && smh->saveManager->isExplored(i-1,j) && !smh->saveManager->isExplored(i-1,j+1))
-			smh->drawSprite("mapFogOfWarDownLeft", drawX, drawY+squareSize/2, squareSize/2, squareSize/2);
-		if (smh->environment->isInBounds(i,j+1) && smh->environment->isInBounds(i+1,j) && smh->saveManager->isExplored(i,j+1) && smh->saveManager->isExplored(i+1,j) && !smh->saveManager->isExplored(i+1,j+1))
-			smh->drawSprite("mapFogOfWarDownRight", drawX+squareSize/2, drawY+squareSize/2, squareSize/2, squareSize/2);
-	//Out of bounds or not explored
-	} else {
-		smh->drawSprite("miniMapBlackSquare", drawX, drawY);
-	}
-}
-
 /**
  * Update the map
  */
@@ -164,31 +131,3 @@ bool Map::update(float dt) {
 
 	return true;
 }
-
-bool Map::shouldDrawItem(int item) {
-	switch (item) {
-		case ENEMYGROUP_BLOCKGRAPHIC:
-		case RED_KEY:
-		case YELLOW_KEY:
-		case GREEN_KEY:
-		case BLUE_KEY:
-		case SMALL_GEM:
-		case MEDIUM_GEM:
-		case LARGE_GEM:
-		case HEALTH_ITEM:
-		case MANA_ITEM:
-			return true;
-		default:
-			return false;
-	}
-}
-
-bool Map::shouldDrawSpecialCollision(int c) {
-	return
-		Util::isArrowPad(c) || Util::isCylinderDown(c) || Util::isCylinderSwitchLeft(c) || Util::isCylinderSwitchRight(c) ||
-		Util::isCylinderUp(c) || c == SAVE_SHRINE || c == ICE || c == YELLOW_KEYHOLE ||
-		c == RED_KEYHOLE || c == GREEN_KEYHOLE || c == BLUE_KEYHOLE || c == SPRING_PAD || c == SPIN_ARROW_SWITCH ||
-		c == MIRROR_UP_LEFT || c == MIRROR_UP_RIGHT || c == MIRROR_DOWN_RIGHT || c == MIRROR_DOWN_LEFT || c == DIZZY_MUSHROOM_1 ||
-		c == DIZZY_MUSHROOM_2 || c == HOVER_PAD || c == BOMBABLE_WALL || c == SHRINK_TUNNEL_SWITCH || c == SHRINK_TUNNEL_HORIZONTAL ||
-		c == SHRINK_TUNNEL_VERTICAL || c == SUPER_SPRING || c == SMILELET_FLOWER_SAD || c == SIGN || c == FIRE_DESTROY;
-}
\ No newline at end of file
@@ -34,11 +34,11 @@ NPC::NPC(int _id, int _textID, int _x,int _y) {
 	}
 
 	//Set pathing shit
-	for (int i = 0; i < 256; i++) canPass[i] = false;
-	canPass[WALKABLE] = true;
-	canPass[SLIME] = true;
-	canPass[PLAYER_START] = true;
-	canPass[PLAYER_END] = true;
+	canPass.setAll(false);
+	canPass.set(WALKABLE, true);
+	canPass.set(SLIME, true);
+	canPass.set(PLAYER_START, true);
+	canPass.set(PLAYER_END, true);
 
 	//Set initial stage
 	stage = REST_STAGE;
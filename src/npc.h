@@ -1,6 +1,8 @@
 #ifndef _NPC_H_
 #define _NPC_H_
 
+#include "AreaArena.h"
+
 class hgeRect;
 class hgeSprite;
 
@@ -8,7 +10,7 @@ class hgeSprite;
 #define WALK_STAGE 0
 #define REST_STAGE 1
 
-class NPC {
+class NPC : public AreaObject {
 
 public:
 	NPC(int id, int textID, int x, int y);
@@ -21,7 +23,7 @@ public:
 	void changeStage();
 
 	//Variables
-	bool canPass[256];
+	CollisionMask canPass;
 	int id, gridX, gridY, facing;
 	int textID;
 	float dx, dy;
@@ -159,11 +159,16 @@ void Player::update(float dt) {
 	checkForIceGlitch();
 
 	//Do level exits
-	if (smh->environment->collision[gridX][gridY] == PLAYER_END) {
-		smh->areaChanger->changeArea(0, 0, smh->environment->ids[gridX][gridY]);
+	if (smh->environment->collision(gridX, gridY) == PLAYER_END) {
+		smh->areaChanger->changeArea(0, 0, smh->environment->ids(gridX, gridY));
 		return;
 	}	
 
+	//Start loading the next area in the background if Smiley is getting close to an exit
+	if (gridX != lastGridX || gridY != lastGridY) {
+		smh->areaLoader->prefetchExitsNear(gridX, gridY);
+	}
+
 	//Explore!
 	smh->saveManager->explore(gridX,gridY);
 	
@@ -189,7 +194,7 @@ void Player::update(float dt) {
 		knockback = false;
 		dx = dy = 0.0;
 		//Help slow the player down if they are on ice by using PLAYER_ACCEL for 1 frame
-		if (smh->environment->collision[gridX][gridY] == ICE) {
+		if (smh->environment->collision(gridX, gridY) == ICE) {
 			if (dx > 0.0) dx -= PLAYER_ACCEL; else if (dx < 0.0) dx += PLAYER_ACCEL;
 			if (dy > 0.0) dy -= PLAYER_ACCEL; else if (dy < 0.0) dy += PLAYER_ACCEL;
 		}
@@ -243,7 +248,7 @@ void Player::updateLocation()
 	lastGridX = gridX;
 	lastGridY = gridY;
 
-	if (smh->environment->collision[gridX][gridY] != ICE) {
+	if (smh->environment->collision(gridX, gridY) != ICE) {
 		lastNonIceGridX = gridX;
 		lastNonIceGridY = gridY;
 	}
@@ -282,7 +287,7 @@ void Player::updateJesusSound()
 		smh->soundManager->stopAbilityChannel();
 		jesusSoundPlaying = false;
 		if (smh->environment->isShallowWaterAt(gridX,gridY)) smh->soundManager->playEnvironmentEffect("snd_shallowWater",true);
-		if (smh->environment->collision[gridX][gridY] == WALK_LAVA) smh->soundManager->playEnvironmentEffect("snd_lava",true);
+		if (smh->environment->collision(gridX, gridY) == WALK_LAVA) smh->soundManager->playEnvironmentEffect("snd_lava",true);
 	}
 }
 
@@ -347,9 +352,11 @@ void Player::doMove(float dt) {
 
 	//We have to do a gay movement fix here
 	if (doGayMovementFix(xDist, yDist)) return;
+
+	smh->environment->beginPlayerMovement();
  
 	//Move left or right
-	if (xDist != 0.0 && smh->environment->collision[gridX][gridY] != SHRINK_TUNNEL_VERTICAL) {
+	if (xDist != 0.0 && smh->environment->collision(gridX, gridY) != SHRINK_TUNNEL_VERTICAL) {
 		if (!smh->environment->playerCollision(x + xDist, y, dt)) {	
 			x += xDist;
 			smh->saveManager->pixelsTravelled += abs(xDist);
@@ -372,7 +379,7 @@ void Player::doMove(float dt) {
 	}
 
 	//Move up or down
-	if (yDist != 0.0 && smh->environment->collision[gridX][gridY] != SHRINK_TUNNEL_HORIZONTAL) {
+	if (yDist != 0.0 && smh->environment->collision(gridX, gridY) != SHRINK_TUNNEL_HORIZONTAL) {
 		if (!smh->environment->playerCollision(x, y+yDist, dt)) {	
 			y += yDist;
 			smh->saveManager->pixelsTravelled += abs(yDist);
@@ -434,8 +441,8 @@ void Player::draw(float dt)
 	}
 
 	//Draw Smiley's shadow
-	if ((smh->environment->collision[gridX][gridY] != FAKE_PIT && smh->environment->collision[gridX][gridY] != PIT && 
-		smh->environment->collision[gridX][gridY] != NO_WALK_PIT) || hoveringYOffset > 0.0 || drowning || springing || 
+	if ((smh->environment->collision(gridX, gridY) != FAKE_PIT && smh->environment->collision(gridX, gridY) != PIT && 
+		smh->environment->collision(gridX, gridY) != NO_WALK_PIT) || hoveringYOffset > 0.0 || drowning || springing || 
 		(onWater && waterWalk) || (!falling && smh->environment->collisionAt(x,y+15) != WALK_LAVA)) 
 	{
 		if (drowning) smh->resources->GetSprite("playerShadow")->SetColor(ARGB(255,255,255,255));
@@ -581,7 +588,7 @@ void Player::doAbility(float dt)
 	/////////////// Hover ////////////////
 
 	bool wasHovering = isHovering;
-	isHovering = (usedAbility == HOVER && (isHovering || smh->environment->collision[gridX][gridY] == HOVER_PAD));
+	isHovering = (usedAbility == HOVER && (isHovering || smh->environment->collision(gridX, gridY) == HOVER_PAD));
 	
 	//For debug purposes H will always hover
 	if (smh->hge->Input_GetKeyState(HGEK_H)) isHovering = true;
@@ -655,11 +662,11 @@ void Player::doAbility(float dt)
 	sprinting = canUseAbility && 
 				usedAbility == SPRINT_BOOTS && 
 				//sprintDuration > dt &&
-				smh->environment->collision[gridX][gridY] != LEFT_ARROW &&
-				smh->environment->collision[gridX][gridY] != RIGHT_ARROW &&
-				smh->environment->collision[gridX][gridY] != UP_ARROW &&
-	 			smh->environment->collision[gridX][gridY] != DOWN_ARROW &&
-				smh->environment->collision[gridX][gridY] != ICE;
+				smh->environment->collision(gridX, gridY) != LEFT_ARROW &&
+				smh->environment->collision(gridX, gridY) != RIGHT_ARROW &&
+				smh->environment->collision(gridX, gridY) != UP_ARROW &&
+	 			smh->environment->collision(gridX, gridY) != DOWN_ARROW &&
+				smh->environment->collision(gridX, gridY) != ICE;
 
 	/*if (sprinting)
 	{
@@ -828,21 +835,21 @@ void Player::doAbility(float dt)
 		if (shrinkScale > 1.0f) shrinkScale = 1.0f;
 
 		//While unshrinking push Smiley away from any adjacent walls
-		if (!canPass(smh->environment->collision[gridX-1][gridY]) && int(x) % 64 < radius)
+		if (!canPass(smh->environment->collision(gridX-1, gridY)) && int(x) % 64 < radius)
 			x += radius - (int(x) % 64) + 1;
 
-		if (!canPass(smh->environment->collision[gridX+1][gridY]) && int(x) % 64 > 64 - radius)
+		if (!canPass(smh->environment->collision(gridX+1, gridY)) && int(x) % 64 > 64 - radius)
 			x -= radius - (64 - int(x) % 64) + 1;
 
-		if (!canPass(smh->environment->collision[gridX][gridY-1]) && int(y) % 64 < radius)
+		if (!canPass(smh->environment->collision(gridX, gridY-1)) && int(y) % 64 < radius)
 			y += radius - (int(y) % 64) + 1;
 
-		if (!canPass(smh->environment->collision[gridX][gridY+1]) && int(y) % 64 > 64 - radius)
+		if (!canPass(smh->environment->collision(gridX, gridY+1)) && int(y) % 64 > 64 - radius)
 			y -= radius - (64 - int(y) % 64) + 1;
 		
 		//Adjacent corners
 		//Up-Left
-		if (!canPass(smh->environment->collision[gridX-1][gridY-1])) 
+		if (!canPass(smh->environment->collision(gridX-1, gridY-1))) 
 		{
 			if (int(x) % 64 < radius && int(y) % 64 < radius) 
 			{
@@ -851,7 +858,7 @@ void Player::doAbility(float dt)
 			}
 		}
 		//Up-Right
-		if (!canPass(smh->environment->collision[gridX+1][gridY-1])) 
+		if (!canPass(smh->environment->collision(gridX+1, gridY-1))) 
 		{
 			if (int(x) % 64 > 64 - radius && int(y) % 64 < radius) 
 			{
@@ -860,7 +867,7 @@ void Player::doAbility(float dt)
 			}
 		}
 		//Down-Left
-		if (!canPass(smh->environment->collision[gridX-1][gridY+1])) 
+		if (!canPass(smh->environment->collision(gridX-1, gridY+1))) 
 		{
 			if (int(x) % 64 < radius && int(y) % 64 > 64 - radius) 
 			{
@@ -869,7 +876,7 @@ void Player::doAbility(float dt)
 			}
 		}
 		//Down-Right
-		if (!canPass(smh->environment->collision[gridX+1][gridY+1])) 
+		if (!canPass(smh->environment->collision(gridX+1, gridY+1))) 
 		{
 			if (int(x) % 64 > 64 - radius && int(y) % 64 > 64 - radius) 
 			{
@@ -886,15 +893,15 @@ void Player::doAbility(float dt)
  */
 void Player::doWarps() {
 	
-	int c = smh->environment->collision[gridX][gridY];
-	int id = smh->environment->ids[gridX][gridY];
+	int c = smh->environment->collision(gridX, gridY);
+	int id = smh->environment->ids(gridX, gridY);
 
 	//If the player is on a warp, move the player to the other warp of the same color
 	if (!springing && !iceSliding && !sliding && hoveringYOffset == 0.0f && !onWarp && (c == RED_WARP || c == GREEN_WARP || c == YELLOW_WARP || c == BLUE_WARP)) {
 		onWarp = true;
 
 		//Play the warp sound effect for non-invisible warps
-		if (smh->environment->variable[gridX][gridY] != 990) {
+		if (smh->environment->variable(gridX, gridY) != 990) {
 			smh->soundManager->playSound("snd_warp");
 		}
 
@@ -907,10 +914,10 @@ void Player::doWarps() {
 		for (int i = 0; i < smh->environment->areaWidth; i++) {
 			for (int j = 0; j < smh->environment->areaHeight; j++) {
 				//Once its found, move the player there
-				if (smh->environment->ids[i][j] == id && (i != gridX || j != gridY) && (smh->environment->collision[i][j] == RED_WARP || smh->environment->collision[i][j] == GREEN_WARP || smh->environment->collision[i][j] == YELLOW_WARP || smh->environment->collision[i][j] == BLUE_WARP)) {
+				if (smh->environment->ids(i, j) == id && (i != gridX || j != gridY) && (smh->environment->collision(i, j) == RED_WARP || smh->environment->collision(i, j) == GREEN_WARP || smh->environment->collision(i, j) == YELLOW_WARP || smh->environment->collision(i, j) == BLUE_WARP)) {
 					//If this is an invisible warp, use the load effect to move 
 					//Smiley to its destination
-					if (smh->environment->variable[gridX][gridY] == 990) {
+					if (smh->environment->variable(gridX, gridY) == 990) {
 						int destX = i;
 						int destY = j;
 						if (facing == DOWN || facing == DOWN_LEFT || facing == DOWN_RIGHT) {
@@ -941,7 +948,7 @@ void Player::doWarps() {
  */
 void Player::doSprings(float dt) {
 
-	int collision = smh->environment->collision[gridX][gridY];
+	int collision = smh->environment->collision(gridX, gridY);
 
 	//Start springing
 	if (hoveringYOffset == 0.0f && !sliding && !iceSliding && !springing && (collision == SPRING_PAD || collision == SUPER_SPRING)) {
@@ -953,7 +960,7 @@ void Player::doSprings(float dt) {
 		startedSpringing = smh->getGameTime();
 		dx = dy = 0;
 		//Start the spring animation
-		smh->environment->activated[gridX][gridY] = smh->getGameTime();
+		smh->environment->activated(gridX, gridY) = smh->getGameTime();
 		if (superSpring) {
 			smh->resources->GetAnimation("superSpring")->Play();
 		} else {
@@ -1103,7 +1110,7 @@ void Player::doFalling(float dt) {
 void Player::doArrowPads(float dt) {
 
 	//Start sliding
-	int arrowPad = smh->environment->collision[gridX][gridY];
+	int arrowPad = smh->environment->collision(gridX, gridY);
 	if (!springing && hoveringYOffset == 0.0f && !sliding && !iceSliding && (arrowPad == LEFT_ARROW || arrowPad == RIGHT_ARROW || arrowPad == UP_ARROW || arrowPad == DOWN_ARROW)) {
 		
 		//First set the start point and end points
@@ -1323,7 +1330,7 @@ bool Player::isSmileyTouchingWater() {
 
 	for (int i = gridX-1; i <= gridX+1; i++) {
 		for (int j = gridY-1; j <= gridY+1; j++) {
-			if (smh->environment->collision[i][j] == DEEP_WATER || smh->environment->collision[i][j] == GREEN_WATER) {
+			if (smh->environment->collision(i, j) == DEEP_WATER || smh->environment->collision(i, j) == GREEN_WATER) {
 				box->SetRadius(i * 64.0 + 32.0, j * 64.0 + 32.0, 32.0);
 				if (collisionCircle->testBox(box)) {
 					delete box;
@@ -1508,9 +1515,9 @@ void Player::doWater()
 			smh->setDebugText("Smiley just recovered from drowning.");
 
 			//If smiley was placed onto an up cylinder, toggle its switch
-			if (Util::isCylinderUp(smh->environment->collision[gridX][gridY])) 
+			if (Util::isCylinderUp(smh->environment->collision(gridX, gridY))) 
 			{
-				smh->environment->toggleSwitch(smh->environment->ids[gridX][gridY]);
+				smh->environment->toggleSwitch(smh->environment->ids(gridX, gridY));
 			}
 		}
 	}
@@ -1541,7 +1548,7 @@ void Player::updateVelocities(float dt)
 	}
 
 	//Determine acceleration - normal ground or slime
-	float accel = (smh->environment->collision[gridX][gridY] == SLIME && hoveringYOffset==0.0) ? SLIME_ACCEL : PLAYER_ACCEL; 
+	float accel = (smh->environment->collision(gridX, gridY) == SLIME && hoveringYOffset==0.0) ? SLIME_ACCEL : PLAYER_ACCEL; 
 
 	//Stop drifting when abs(dx) < accel
 	if (!iceSliding && !sliding && !springing) 
@@ -1602,7 +1609,7 @@ void Player::resetTongue()
  */
 void Player::setFacingDirection() 
 {	
-	if (!frozen && !drowning && !falling && !iceSliding && !knockback && !springing && smh->environment->collision[gridX][gridY] != SPRING_PAD && smh->environment->collision[gridX][gridY] != SUPER_SPRING) 
+	if (!frozen && !drowning && !falling && !iceSliding && !knockback && !springing && smh->environment->collision(gridX, gridY) != SPRING_PAD && smh->environment->collision(gridX, gridY) != SUPER_SPRING) 
 	{		
 		if (smh->input->keyDown(INPUT_LEFT)) facing = LEFT;
 		else if (smh->input->keyDown(INPUT_RIGHT)) facing = RIGHT;
@@ -1646,7 +1653,7 @@ void Player::setFacingBasedOnLastGrid() {
 		facing = UP;			
 	} else {
 		//unknown!
-		smh->log("player::setFacingBasedOnLastGrid: could not set facing");
+		smh->logger->write(LogLevels::Warning, LogCategories::Player, "player::setFacingBasedOnLastGrid: could not set facing");
 	}
 }
 
@@ -1969,7 +1976,7 @@ void Player::slime(float duration) {
  */ 
 void Player::doShrinkTunnels(float dt) {
 
-	int c = smh->environment->collision[gridX][gridY];
+	int c = smh->environment->collision(gridX, gridY);
 
 	//Enter shrink tunnel
 	if (!inShrinkTunnel && !springing && !sliding && (c == SHRINK_TUNNEL_HORIZONTAL || c == SHRINK_TUNNEL_VERTICAL)) 
@@ -2003,13 +2010,13 @@ void Player::doShrinkTunnels(float dt) {
 	//Continue moving through shrink tunnel - move towards the center of the square
 	if (inShrinkTunnel) 
 	{
-		if (smh->environment->collision[gridX][gridY] == SHRINK_TUNNEL_VERTICAL) {
+		if (smh->environment->collision(gridX, gridY) == SHRINK_TUNNEL_VERTICAL) {
 			if (x < gridX*64+31) {
 				x += 80.0f*dt;
 			} else if (x > gridX*64+33) {
 				x -= 80.0f*dt;
 			}
-		} else if (smh->environment->collision[gridX][gridY] == SHRINK_TUNNEL_HORIZONTAL) {
+		} else if (smh->environment->collision(gridX, gridY) == SHRINK_TUNNEL_HORIZONTAL) {
 			if (y < gridY*64+31) {
 				y += 80.0f*dt;
 			} else if (y > gridY*64+33) {
@@ -2070,31 +2077,31 @@ bool Player::doGayMovementFix(int xDist, int yDist) {
 	bool movedUp = nextY < gridY;
 	bool movedDown = nextY > gridY;
 
-	bool enteringGayTile = Util::isTileForGayFix(smh->environment->collision[nextX][nextY]);
+	bool enteringGayTile = Util::isTileForGayFix(smh->environment->collision(nextX, nextY));
 	int newDir = -1;
 
 	//Up right
 	if (movedUp && movedRight) {
 		//MessageBox(NULL,"Went right and up.","Ice shit",MB_OK);
-		if (enteringGayTile || (Util::isTileForGayFix(smh->environment->collision[gridX][gridY-1]) && Util::isTileForGayFix(smh->environment->collision[gridX+1][gridY]))) {
+		if (enteringGayTile || (Util::isTileForGayFix(smh->environment->collision(gridX, gridY-1)) && Util::isTileForGayFix(smh->environment->collision(gridX+1, gridY)))) {
 			newDir = RIGHT;
 		}
 	//Down right
 	} else if (movedDown && movedRight) {
 		//MessageBox(NULL,"Went right and down.","Ice shit",MB_OK);
-		if (enteringGayTile || (Util::isTileForGayFix(smh->environment->collision[gridX][gridY+1]) && Util::isTileForGayFix(smh->environment->collision[gridX+1][gridY]))) {
+		if (enteringGayTile || (Util::isTileForGayFix(smh->environment->collision(gridX, gridY+1)) && Util::isTileForGayFix(smh->environment->collision(gridX+1, gridY)))) {
 			newDir = RIGHT;
 		}
 	//Up left
 	} else if (movedUp && movedLeft) {
 		//MessageBox(NULL,"Went left and up.","Ice shit",MB_OK);
-		if (enteringGayTile || (Util::isTileForGayFix(smh->environment->collision[gridX][gridY-1]) && Util::isTileForGayFix(smh->environment->collision[gridX-1][gridY]))) {
+		if (enteringGayTile || (Util::isTileForGayFix(smh->environment->collision(gridX, gridY-1)) && Util::isTileForGayFix(smh->environment->collision(gridX-1, gridY)))) {
 			newDir = LEFT;
 		}
 	//Down left
 	} else if (movedDown && movedLeft) {
 		//MessageBox(NULL,"Went left and down.","Ice shit",MB_OK);
-		if (enteringGayTile || (Util::isTileForGayFix(smh->environment->collision[gridX][gridY+1]) && Util::isTileForGayFix(smh->environment->collision[gridX-1][gridY]))) {
+		if (enteringGayTile || (Util::isTileForGayFix(smh->environment->collision(gridX, gridY+1)) && Util::isTileForGayFix(smh->environment->collision(gridX-1, gridY)))) {
 			newDir = LEFT;
 		}
 	}
@@ -2115,7 +2122,7 @@ bool Player::doGayMovementFix(int xDist, int yDist) {
  * Checks to see if an ICE GLITCH has occurred, and fixes it if it has
  */
 void Player::checkForIceGlitch() {
-	if (smh->environment->collision[gridX][gridY] == ICE) {
+	if (smh->environment->collision(gridX, gridY) == ICE) {
 		if (facing == UP || facing == DOWN) {
 			//should not have a different X position than the last non-ice square
 			if (gridX != lastNonIceGridX) {
@@ -262,6 +262,12 @@ private:
 //----------------------------------------------------------------
 //------------------ WORM ----------------------------------------
 //----------------------------------------------------------------
+// The trail of points Smiley has walked along, one per pixel, that
+// smilelets follow him on. It is a ring buffer so that adding a node
+// overwrites the oldest one and any node can be read directly.
+//----------------------------------------------------------------
+#define WORM_LENGTH 500
+
 struct WormNode 
 {
 	int x,y;
@@ -277,14 +283,15 @@ public:
 	void draw();
 	void reset();
 	WormNode getNode(int nodeNumber);
+	void addWormTrail(int toX, int toY); //adds a trail of nodes 1 pixel apart from the first node to (toX, toY)
 
 private:
 	//Methods
-	void addWormTrail(); //adds a trail of nodes 1 pixel apart from the first node to smiley's position
 	void addWormNode(int x,int y,int direction);
 
 	//Variables
-	std::list<WormNode> theWorms;
+	WormNode nodes[WORM_LENGTH];
+	int head;		//Index of the newest node. Older nodes follow it around the ring.
 };
 
 //----------------------------------------------------------------
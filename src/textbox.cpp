@@ -68,6 +68,12 @@ void TextBox::setDialogue(int _npcID, int _textID)
 	currentPage = 1;
 	strcpy(text, "-");
 
+	paramString = "NPC";
+	paramString += Util::intToString(textID);
+	paramString += "Name";
+	nameText = smh->gameData->getGameTextHandle(paramString.c_str());
+	loadPageText("NPC");
+
 }
 
 /**
@@ -89,6 +95,7 @@ void TextBox::setHint()
 	currentPage = 1;
 	strcpy(text, "-");
 	fadeAlpha = 0.0;
+	loadPageText("Hint");
 
 	//Set distortion mesh for psychedelic background
 	distortion =new hgeDistortionMesh(PSYCHEDELIC_GRANULARITY, PSYCHEDELIC_GRANULARITY);
@@ -140,6 +147,34 @@ void TextBox::setAdvice(int _advice)
 		numPages = 1;
 }
 
+/**
+ * Gets the handle of each page of text, which are named <prefix><textID>-<page>.
+ */
+void TextBox::loadPageText(const char *prefix)
+{
+	pageText.clear();
+	for (int page = 1; page <= numPages; page++) {
+		paramString = prefix;
+		paramString += Util::intToString(textID);
+		paramString += "-";
+		paramString += Util::intToString(page);
+		pageText.push_back(smh->gameData->getGameTextHandle(paramString.c_str()));
+	}
+
+	//Text with no pages still opens one empty page so that it can be closed
+	if (numPages < 1) numPages = 1;
+}
+
+/**
+ * Returns the text of the current page, or an empty string if the page doesn't have any.
+ */
+const char *TextBox::getPageText()
+{
+	if (currentPage < 1 || currentPage > (int)pageText.size()) return "";
+	const char *text = smh->gameData->getGameText(pageText[currentPage-1]);
+	return text ? text : "";
+}
+
 /**
  * Intializes a text box for non-dialogue purposes.
  */
@@ -177,11 +212,8 @@ void TextBox::draw(float dt)
 		smh->resources->GetFont("textBoxNameFnt")->printf(x + 220, y+20, HGETEXT_CENTER, "%s", "Bill Clinton");
 
 		//Print the current page of the hint
-		paramString = "Hint";
-		paramString += Util::intToString(textID);
-		paramString += "-";
-		paramString += Util::intToString(currentPage);
-		smh->resources->GetFont("textBoxDialogFnt")->printfb(x + 20, y + 90, 360, 205, HGETEXT_LEFT, smh->gameData->getGameText(paramString.c_str()));
+		smh->textLayoutCache->printfb(smh->resources->GetFont("textBoxDialogFnt"), x + 20, y + 90, 360, 205, HGETEXT_LEFT, 
+			getPageText());
 	} 
 	else if (textBoxType == TextBoxTypes::DIALOG_TYPE) 
 	{
@@ -194,26 +226,19 @@ void TextBox::draw(float dt)
 		} else if (npcID != -1) {
 			graphic->Render(x+60-32, y+50-32);
 		}
-		paramString = "NPC";
-		paramString += Util::intToString(textID);
-		paramString += "Name";
-		smh->resources->GetFont("textBoxNameFnt")->printf(x + 220, y+20, HGETEXT_CENTER, "%s", smh->gameData->getGameText(paramString.c_str()));
+		smh->textLayoutCache->print(smh->resources->GetFont("textBoxNameFnt"), x + 220, y+20, HGETEXT_CENTER, smh->gameData->getGameText(nameText));
 
 		//Print the current page of the conversation
-		paramString = "NPC";
-		paramString += Util::intToString(textID);
-		paramString += "-";
-		paramString += Util::intToString(currentPage);
-
 		//Crappy hard-coding for Monocle Man's first speech, so that we can tell the player what button to push to go to the next screen
-		if (strcmp(paramString.c_str(),"NPC900-1") == 0) {
+		if (textID == 900 && currentPage == 1) {
 			std::string monocleString;
 			monocleString = "Hey! You there! Press attack (";
 			monocleString += smh->input->getInputDescription(INPUT_ATTACK);
 			monocleString += ") to go to the next page!";
-			smh->resources->GetFont("textBoxDialogFnt")->printfb(x + 20, y + 90, 360, 205, HGETEXT_LEFT, monocleString.c_str());
+			smh->textLayoutCache->printfb(smh->resources->GetFont("textBoxDialogFnt"), x + 20, y + 90, 360, 205, HGETEXT_LEFT, monocleString.c_str());
 		} else {
-			smh->resources->GetFont("textBoxDialogFnt")->printfb(x + 20, y + 90, 360, 205, HGETEXT_LEFT, smh->gameData->getGameText(paramString.c_str()));
+			smh->textLayoutCache->printfb(smh->resources->GetFont("textBoxDialogFnt"), x + 20, y + 90, 360, 205, HGETEXT_LEFT, 
+				getPageText());
 		}
 	} 
 	else if (textBoxType == TextBoxTypes::ABILITY_TYPE) 
@@ -222,20 +247,20 @@ void TextBox::draw(float dt)
 		smh->resources->GetAnimation("abilities")->SetFrame(ability);
 		smh->resources->GetAnimation("abilities")->Render(x+212,y+42);
 		smh->resources->GetFont("textBoxFnt")->SetColor(ARGB(255, 0, 0, 0));
-		smh->resources->GetFont("textBoxFnt")->printfb(x + 20, y + 15 + 64, 360, 200 - 64, HGETEXT_CENTER, getAbilityText(ability).c_str());
+		smh->textLayoutCache->printfb(smh->resources->GetFont("textBoxFnt"), x + 20, y + 15 + 64, 360, 200 - 64, HGETEXT_CENTER, getAbilityText(ability).c_str());
 	}
 	else if (textBoxType == TextBoxTypes::ADVICE_TYPE) 
 	{
 		smh->resources->GetSprite("textBox")->Render(x,y);
 		smh->resources->GetSprite("adviceManDown")->Render(x+212,y+52);
 		smh->resources->GetFont("textBoxFnt")->SetScale(0.75);
-		smh->resources->GetFont("textBoxFnt")->printfb(x + 20, y + 25 + 64, 360, 200 - 64, HGETEXT_CENTER, getAdviceText(advice, currentPage).c_str());
+		smh->textLayoutCache->printfb(smh->resources->GetFont("textBoxFnt"), x + 20, y + 25 + 64, 360, 200 - 64, HGETEXT_CENTER, getAdviceText(advice, currentPage).c_str());
 		smh->resources->GetFont("textBoxFnt")->SetScale(1.0);
 	} 
 	else if (textBoxType == TextBoxTypes::SIGN_TYPE) 
 	{
 		smh->resources->GetSprite("textBox")->Render(x,y);
-		smh->resources->GetFont("textBoxFnt")->printfb(x + 20, y + 20, 360, 210, HGETEXT_CENTER, "%s", text);
+		smh->textLayoutCache->printfb(smh->resources->GetFont("textBoxFnt"), x + 20, y + 20, 360, 210, HGETEXT_CENTER, text);
 	}
 
 	//Draw next page/OK icon if enough time has elapsed
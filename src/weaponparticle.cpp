@@ -17,15 +17,15 @@ extern SMH *smh;
  * type				FIRE_BREATH or ICE_BREATH
  */
 WeaponParticleSystem::WeaponParticleSystem(const char *filename, hgeSprite *sprite, int _type) {
-	void *psi;
+	const BYTE *psi;
+	DWORD size;
 
 	type = _type;
 	hge=hgeCreate(HGE_VERSION);
 
-	psi=hge->Resource_Load(filename);
-	if(!psi) return;
+	psi=smh->assetPacks->load(filename, &size);
+	if(!psi || size < sizeof(weaponParticleSystemInfo)) return;
 	memcpy(&info, psi, sizeof(weaponParticleSystemInfo));
-	hge->Resource_Free(psi);
 	info.sprite=sprite;
 
 	vecLocation.x=vecPrevLocation.x=0.0f;